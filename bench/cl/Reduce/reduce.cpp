@@ -49,6 +49,7 @@ int _tmain( int argc, _TCHAR* argv[] )
     size_t iterations = 0;
     size_t length = 0;
     size_t algo = 1;
+    int wgPerComputeUnit = 0;
     cl_device_type deviceType = CL_DEVICE_TYPE_DEFAULT;
     bool defaultDevice = true;
     bool print_clInfo = false;
@@ -83,6 +84,8 @@ int _tmain( int argc, _TCHAR* argv[] )
                                 "Index is relative with respect to -g, -c or -a flags" )
             ( "length,l",       po::value< size_t >( &length )->default_value( 8*1048576 ), "Specify the length of scan array" )
             ( "iterations,i",   po::value< size_t >( &iterations )->default_value( 100 ), "Number of samples in timing loop" )
+            ( "wgPerComputeUnit,w", po::value< int >( &wgPerComputeUnit )->default_value( 0 ),
+                                "Work-groups launched per compute unit by the OpenCL path; 0 keeps the control default" )
 			//( "algo,a",		    po::value< size_t >( &algo )->default_value( 1 ), "Algorithm used [1,2]  1:SCAN_BOLT, 2:XYZ" )//Not used in this file
             ;
 
@@ -191,6 +194,10 @@ int _tmain( int argc, _TCHAR* argv[] )
 
     // Control setup:
 	bolt::cl::control::getDefault().setWaitMode(bolt::cl::control::BusyWait);
+    if( wgPerComputeUnit > 0 )
+        bolt::cl::control::getDefault( ).setWGPerComputeUnit( wgPerComputeUnit );
+    std::cout << "Work-groups per compute unit : " << bolt::cl::control::getDefault( ).getWGPerComputeUnit( )
+        << std::endl;
 
     /******************************************************************************
     * Benchmark logic                                                             *
@@ -23,6 +23,9 @@
 #include "bolt/statisticalTimer.h"
 #include "bolt/countof.h"
 #include "bolt/cl/stablesort.h"
+#ifdef ENABLE_TBB
+#include "tbb/task_scheduler_init.h"
+#endif
 #define DATA_TYPE unsigned int
 const std::streamsize colWidth = 26;
 #define BOLT_BENCHMARK_DEBUG 1
@@ -57,6 +60,8 @@ int _tmain( int argc, _TCHAR* argv[] )
     bool runTBB = false;
     bool runBOLT = false;
     bool runSTL = false;
+    bool runScaling = false;
+    int threads = 0;
     /******************************************************************************
     * Parameter parsing                                                           *
     ******************************************************************************/
@@ -76,6 +81,9 @@ int _tmain( int argc, _TCHAR* argv[] )
             ( "tbb,T",          "Benchmark TBB MULTICORE CPU Code" )
             ( "bolt,B",         "Benchmark Bolt OpenCL Libray" )
             ( "serial,E",       "Benchmark Serial Code STL Libray" )
+            ( "scaling,s",      "Benchmark TBB MULTICORE CPU Code for 1, 2, 4, ... threads up to the core count" )
+            ( "threads,t",      po::value< int >( &threads )->default_value( 0 ),
+                                "Number of TBB worker threads; 0 lets TBB decide" )
             ( "platform,p",     po::value< cl_uint >( &userPlatform )->default_value( 0 ), 
                                 "Specify the platform under test using the index reported by -q flag" )
             ( "device,d",       po::value< cl_uint >( &userDevice )->default_value( 0 ), 
@@ -148,6 +156,10 @@ int _tmain( int argc, _TCHAR* argv[] )
         {
             runSTL = true;
         }
+        if( vm.count( "scaling" ) )
+        {
+            runScaling = true;
+        }
     }
     catch( std::exception& e )
     {
@@ -202,7 +214,7 @@ int _tmain( int argc, _TCHAR* argv[] )
 	SaxpyFunctor s(100.0);
 
 #if (BOLT_BENCHMARK_DEBUG == 1)
-    std::string library = runBOLT?"BOLT LIBRARY ":(runTBB?"TBB CODE MULTI CORE PATH":(runSTL?"SERIAL SINGLE CORE PATH":"NO PATH SELECTED"));
+    std::string library = runBOLT?"BOLT LIBRARY ":(runTBB?"TBB CODE MULTI CORE PATH":(runScaling?"TBB THREAD SCALING":(runSTL?"SERIAL SINGLE CORE PATH":"NO PATH SELECTED")));
     std::string memory  = systemMemory?"CPU/HOST MEMORY":(deviceMemory?"DEVICE MEMORY":"NO MEMORY SELECTED");
     std::cout << "Run Mode LIBRARY--[" << library << "]  MEMORY--[" << memory<< "]" << std::endl;
 #endif
@@ -241,9 +253,58 @@ int _tmain( int argc, _TCHAR* argv[] )
             std::cout << "BOLT LIBRARY PATH NO Memory selected"<< std::endl;
         }
     }
-    else if (runTBB)
+    else if (runScaling)
     {
+#ifdef ENABLE_TBB
+        //  Host memory only, so the numbers show the merge sort itself and not the device_vector mapping
+        bolt::cl::control ctl = bolt::cl::control::getDefault();
+        ctl.setForceRunMode(bolt::cl::control::MultiCoreCpu);
+        int maxThreads = tbb::task_scheduler_init::default_num_threads( );
+        double MKeys = length / ( 1024.0 * 1024.0 );
+        double singleThreadTime = 0.0;
+        std::vector< DATA_TYPE > input( length );
+
+        bolt::tout << std::left;
+        bolt::tout << std::setw( colWidth/2 ) << _T( "Threads" ) << std::setw( colWidth/2 ) << _T( "Time (s)" )
+                   << std::setw( colWidth/2 ) << _T( "MKeys/s" ) << _T( "Speedup" ) << std::endl;
+        for( int numThreads = 1; numThreads <= maxThreads; )
+        {
+            tbb::task_scheduler_init init( numThreads );
+            myTimer.Reset( );
+            myTimer.Reserve( 1, iterations );
+            size_t scalingId = myTimer.getUniqueID( _T( "scaling" ), 0 );
 
+            for( unsigned i = 0; i < iterations; ++i )
+            {
+                input = backup;
+                myTimer.Start( scalingId );
+                bolt::cl::stable_sort( ctl, input.begin(), input.end());
+                myTimer.Stop( scalingId );
+            }
+            myTimer.pruneOutliers( 1.0 );
+            double time = myTimer.getAverageTime( scalingId );
+            if( numThreads == 1 )
+                singleThreadTime = time;
+
+            bolt::tout << std::setw( colWidth/2 ) << numThreads << std::setw( colWidth/2 ) << time
+                       << std::setw( colWidth/2 ) << MKeys / time << singleThreadTime / time << std::endl;
+
+            //  Make sure the core count itself is measured when it is not a power of two
+            if( numThreads < maxThreads && numThreads * 2 > maxThreads )
+                numThreads = maxThreads;
+            else
+                numThreads *= 2;
+        }
+#else
+        std::cout << "The thread scaling benchmark needs a TBB enabled build"<< std::endl;
+#endif
+        return 0;
+    }
+    else if (runTBB)
+    {
+#ifdef ENABLE_TBB
+        tbb::task_scheduler_init init( threads > 0 ? threads : tbb::task_scheduler_init::automatic );
+#endif
         bolt::cl::control ctl = bolt::cl::control::getDefault();
         ctl.setForceRunMode(bolt::cl::control::MultiCoreCpu);
         if( systemMemory )
@@ -30,6 +30,8 @@
 #include "bolt/statisticalTimer.h"
 #include "bolt/countof.h"
 #include "bolt/cl/transform_scan.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/scan.h"
 #include "bolt/AsyncProfiler.h"
 
 AsyncProfiler aProfiler;
@@ -136,6 +138,7 @@ int _tmain( int argc, _TCHAR* argv[] )
     bool print_clInfo = false;
     bool systemMemory = false;
     bool serial = false;
+    bool compareUnfused = false;
     bolt::cl::control& ctrl = bolt::cl::control::getDefault();
 
     /******************************************************************************
@@ -154,6 +157,7 @@ int _tmain( int argc, _TCHAR* argv[] )
             ( "all,a",          "Report all OpenCL devices" )
             ( "reference-serial,r", "Run reference serial algorithm (std::scan)." )
             ( "systemMemory,s", "Allocate vectors in system memory, otherwise device memory" )
+            ( "unfused,u",      "Also time bolt::cl::transform followed by bolt::cl::inclusive_scan, to measure the gain of the fused transform_scan" )
             ( "platform,p",     po::value< cl_uint >( &userPlatform )->default_value( 0 ), "Specify the platform under test using the index reported by -q flag" )
             ( "device,d",       po::value< cl_uint >( &userDevice )->default_value( 0 ), "Specify the device under test using the index reported by the -q flag.  "
                     "Index is relative with respect to -g, -c or -a flags" )
@@ -210,6 +214,11 @@ int _tmain( int argc, _TCHAR* argv[] )
             systemMemory = true;
         }
 
+        if( vm.count( "unfused" ) )
+        {
+            compareUnfused = true;
+        }
+
         if( vm.count( "reference-serial" ) )
         {
             serial = true;
@@ -264,9 +273,10 @@ int _tmain( int argc, _TCHAR* argv[] )
     ******************************************************************************/
     bolt::statTimer& myTimer = bolt::statTimer::getInstance( );
     bolt::statTimer& stdTimer = bolt::statTimer::getInstance( );
-    myTimer.Reserve( 2, iterations );
+    myTimer.Reserve( 3, iterations );
     size_t scanId	= myTimer.getUniqueID( _T( "boltScan" ), 0 );
     size_t stdScanId	= myTimer.getUniqueID( _T( "stdScan" ), 1 );
+    size_t unfusedId	= myTimer.getUniqueID( _T( "boltUnfusedScan" ), 2 );
     int reportLength = 30;
     float reportFrequency = 1.f*iterations/reportLength;
     float nextReport = 0.f;
@@ -285,6 +295,18 @@ int _tmain( int argc, _TCHAR* argv[] )
             bolt::cl::transform_inclusive_scan( ctrl, input.begin( ), input.end( ), output.begin( ), squareInt, plusInt );
             myTimer.Stop( scanId );
         }
+
+        if( compareUnfused )
+        {
+            std::vector< int > transformed( length );
+            for( unsigned i = 0; i < iterations; ++i )
+            {
+                myTimer.Start( unfusedId );
+                bolt::cl::transform( ctrl, input.begin( ), input.end( ), transformed.begin( ), squareInt );
+                bolt::cl::inclusive_scan( ctrl, transformed.begin( ), transformed.end( ), output.begin( ), plusInt );
+                myTimer.Stop( unfusedId );
+            }
+        }
     }
     else
     {
@@ -350,6 +372,36 @@ int _tmain( int argc, _TCHAR* argv[] )
             myTimer.Stop( scanId );
         }
 
+        //  The unfused reference writes the transformed values out and reads them back for the scan
+        if( compareUnfused )
+        {
+#if USE_VECN
+            bolt::cl::device_vector< vecN > transformed( length, empty_vecN, CL_MEM_READ_WRITE, false, ctrl );
+#else
+            bolt::cl::device_vector< int > transformed( length, 0, CL_MEM_READ_WRITE, false, ctrl );
+#endif
+            for( unsigned i = 0; i < iterations; ++i )
+            {
+                myTimer.Start( unfusedId );
+#if USE_VECN
+                bolt::cl::transform( ctrl, input.begin( ), input.end( ), transformed.begin( ), vNs );
+#if EXCLUSIVE
+                bolt::cl::exclusive_scan( ctrl, transformed.begin( ), transformed.end( ), output.begin( ), empty_vecN, vNp );
+#else
+                bolt::cl::inclusive_scan( ctrl, transformed.begin( ), transformed.end( ), output.begin( ), vNp );
+#endif
+#else
+                bolt::cl::transform( ctrl, input.begin( ), input.end( ), transformed.begin( ), squareInt );
+#if EXCLUSIVE
+                bolt::cl::exclusive_scan( ctrl, transformed.begin( ), transformed.end( ), output.begin( ), 0, plusInt );
+#else
+                bolt::cl::inclusive_scan( ctrl, transformed.begin( ), transformed.end( ), output.begin( ), plusInt );
+#endif
+#endif
+                myTimer.Stop( unfusedId );
+            }
+        }
+
 #if CALC_SPEEDUP
 
 #if USE_VECN
@@ -479,6 +531,13 @@ int _tmain( int argc, _TCHAR* argv[] )
     bolt::tout << std::setw( colWidth ) << _T( "    Time (s): " ) << scanTime << std::endl;
     bolt::tout << std::setw( colWidth ) << _T( "    Speed (GB/s): " ) << scanGB / scanTime << std::endl;
 #endif
+    if( compareUnfused )
+    {
+        double unfusedTime = myTimer.getAverageTime( unfusedId );
+        bolt::tout << std::setw( colWidth ) << _T( "    Unfused Time (s): " ) << unfusedTime << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Unfused Speed (GB/s): " ) << scanGB / unfusedTime << std::endl;
+        bolt::tout << std::setw( colWidth ) << _T( "    Fusion Speedup: " ) << unfusedTime / scanTime << std::endl;
+    }
     bolt::tout << std::endl;
 
 //	bolt::tout << myTimer;
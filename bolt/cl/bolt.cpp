@@ -30,22 +30,36 @@
 
 //  Include all kernel string objects
 
+#include "bolt/binary_search_kernels.hpp"
 #include "bolt/copy_kernels.hpp"
+#include "bolt/copy_if_kernels.hpp"
 #include "bolt/count_kernels.hpp"
 #include "bolt/fill_kernels.hpp"
+#include "bolt/find_kernels.hpp"
 #include "bolt/generate_kernels.hpp"
+#include "bolt/histogram_kernels.hpp"
+#include "bolt/inner_product_kernels.hpp"
+#include "bolt/lookback_kernels.hpp"
+#include "bolt/merge_kernels.hpp"
 #include "bolt/min_element_kernels.hpp"
+#include "bolt/minmax_element_kernels.hpp"
+#include "bolt/partial_sort_kernels.hpp"
 #include "bolt/reduce_kernels.hpp"
 #include "bolt/reduce_by_key_kernels.hpp"
+#include "bolt/reduce_by_key_unsorted_kernels.hpp"
 #include "bolt/scan_kernels.hpp"
 #include "bolt/scan_by_key_kernels.hpp"
+#include "bolt/segmented_reduce_kernels.hpp"
+#include "bolt/segmented_scan_kernels.hpp"
 #include "bolt/sort_kernels.hpp"
 #include "bolt/sort_uint_kernels.hpp"
 #include "bolt/sort_by_key_kernels.hpp"
+#include "bolt/sort_by_extracted_key_kernels.hpp"
 #include "bolt/stablesort_kernels.hpp"
 #include "bolt/stablesort_by_key_kernels.hpp"
 #include "bolt/transform_kernels.hpp"
 #include "bolt/transform_reduce_kernels.hpp"
+#include "bolt/transform_reduce_range_kernels.hpp"
 #include "bolt/transform_scan_kernels.hpp"
 
 namespace bolt {
@@ -413,6 +427,37 @@ namespace bolt {
         }
     };
 
+    bool supportsGlobalAtomics( const bolt::cl::control &ctl )
+    {
+        ::cl::Device device = ctl.getDevice( );
+
+        //  32-bit global atomics are core from OpenCL 1.1 on, and an extension before that
+        std::string version = device.getInfo< CL_DEVICE_VERSION >( );
+        std::string extensions = device.getInfo< CL_DEVICE_EXTENSIONS >( );
+        return ( version.compare( 0, 10, "OpenCL 1.0" ) != 0 ) ||
+            ( extensions.find( "cl_khr_global_int32_base_atomics" ) != std::string::npos );
+    }
+
+    bool supportsSinglePassScan( const bolt::cl::control &ctl )
+    {
+        if( ( ctl.getDevice( ).getInfo< CL_DEVICE_TYPE >( ) & CL_DEVICE_TYPE_GPU ) == 0 )
+            return false;
+
+        return supportsGlobalAtomics( ctl );
+    }
+
+    cl_uint singlePassScanItemsPerWorkItem( const bolt::cl::control &ctl, size_t elementBytes, size_t workGroupSize )
+    {
+        //  Keep about 64 bytes of elements in the registers of every work-item
+        cl_uint itemsPerWorkItem = static_cast< cl_uint >( 64 / ( elementBytes ? elementBytes : 1 ) );
+        itemsPerWorkItem = std::max< cl_uint >( 1, std::min< cl_uint >( 8, itemsPerWorkItem ) );
+
+        cl_ulong localMemSize = ctl.getDevice( ).getInfo< CL_DEVICE_LOCAL_MEM_SIZE >( );
+        while( itemsPerWorkItem > 1 && itemsPerWorkItem * workGroupSize * elementBytes > localMemSize / 4 )
+            itemsPerWorkItem /= 2;
+        return itemsPerWorkItem;
+    }
+
     /**************************************************************************
      * Compile Kernel from primitive information
      *************************************************************************/
@@ -19,6 +19,9 @@
 
 #include "bolt/cl/reduce.h"
 #include "bolt/cl/transform_reduce.h"
+#include "bolt/cl/transform.h"
+#include "bolt/cl/device_scalar.h"
+#include "bolt/cl/summary_statistics.h"
 
 #include <math.h>
 #include <algorithm>
@@ -38,6 +41,20 @@ BOLT_FUNCTOR( Variance< int >,
     };
 );
 
+BOLT_FUNCTOR( VarianceFromMoments,
+    struct VarianceFromMoments
+    {
+        float m_count;
+
+        VarianceFromMoments( float count ): m_count( count ) {};
+        float operator( )( const float& sum, const float& sumOfSquares )
+        {
+            float mean = sum / m_count;
+            return sumOfSquares / m_count - mean * mean;
+        };
+    };
+);
+
 int _tmain( int argc, _TCHAR* argv[ ] )
 {
     const cl_uint vecSize = 1024;
@@ -56,6 +73,26 @@ int _tmain( int argc, _TCHAR* argv[ ] )
     cl_int boltVariance  = bolt::cl::transform_reduce( boltInput.begin( ), boltInput.end( ), Variance< cl_int >( boltMean ), 0, bolt::cl::plus< cl_int >( ) );
     cl_double boltStdDev = sqrt( static_cast< double >( boltVariance ) / vecSize );
 
+    //  The same calculation without reading the intermediate results back: the sum and the sum of squares stay in
+    //  device_scalars, and a transform over their one element ranges combines them into the variance
+    std::vector< cl_float > hostInputF( boltInput.begin( ), boltInput.end( ) );
+    bolt::cl::device_vector< cl_float > boltInputF( hostInputF.begin( ), hostInputF.end( ) );
+    bolt::cl::device_scalar< cl_float > boltSumF, boltSumOfSquaresF, boltVarianceF;
+
+    bolt::cl::reduce( boltInputF.begin( ), boltInputF.end( ), 0.0f, bolt::cl::plus< cl_float >( ), boltSumF );
+    bolt::cl::transform_reduce( boltInputF.begin( ), boltInputF.end( ), bolt::cl::square< cl_float >( ), 0.0f,
+        bolt::cl::plus< cl_float >( ), boltSumOfSquaresF );
+    bolt::cl::transform( boltSumF.begin( ), boltSumF.end( ), boltSumOfSquaresF.begin( ), boltVarianceF.begin( ),
+        VarianceFromMoments( static_cast< float >( vecSize ) ) );
+    cl_double boltDeviceStdDev = sqrt( static_cast< double >( boltVarianceF.get( ) ) );
+
+    //  The sum and the sum of squares can also come out of one pass over the data
+    bolt::cl::summary_statistics< cl_float > boltStats = bolt::cl::reduce_statistics( boltInputF.begin( ),
+        boltInputF.end( ) );
+    cl_double boltStatsMean = static_cast< double >( boltStats.sum ) / boltStats.count;
+    cl_double boltStatsStdDev = sqrt( static_cast< double >( boltStats.sum_of_squares ) / boltStats.count
+        - boltStatsMean * boltStatsMean );
+
     //  Calculate standard deviation with std algorithms (using device_vector!)
     cl_int stdSum = std::accumulate( boltInput.begin( ), boltInput.end( ), 0 );
     cl_int stdMean = stdSum / vecSize;
@@ -65,6 +102,8 @@ int _tmain( int argc, _TCHAR* argv[ ] )
     cl_double stdStdDev = sqrt( static_cast< double >( stdVariance ) / vecSize );
 
     std::cout << std::setw( 40 ) << std::right << "Bolt Standard Deviation: " << boltStdDev << std::endl;
+    std::cout << std::setw( 40 ) << std::right << "Bolt Device Resident Standard Deviation: " << boltDeviceStdDev << std::endl;
+    std::cout << std::setw( 40 ) << std::right << "Bolt Single Pass Standard Deviation: " << boltStatsStdDev << std::endl;
     std::cout << std::setw( 40 ) << std::right << "STD Standard Deviation: " << stdStdDev << std::endl;
     std::cout << "\nCOMPLETED. ...\n";
     return 0;
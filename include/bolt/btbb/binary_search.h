@@ -0,0 +1,123 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_BINARY_SEARCH_H )
+#define BOLT_BTBB_BINARY_SEARCH_H
+#pragma once
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/binary_search.h
+    \brief Looks up a batch of values in a sorted range.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup searching
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-binary_search
+        *   \ingroup searching
+        *   \{
+        *   \details Every value of [values_first, values_last) is looked up in the range [first, last), which is
+        *   sorted by \p comp, and the answer for the value i is written to result[i].  The plain versions run one
+        *   binary search per value.  The _sorted versions expect the values to be sorted by \p comp as well; they
+        *   cut the merge path of the range and the values into chunks of equal size and walk each chunk linearly.
+        */
+
+        /*! \brief \p lower_bound writes the offset of the first element of the range that is not less than each
+        * value.
+        * \return The end of the output sequence.
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator lower_bound(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp);
+
+        /*! \brief \p upper_bound writes the offset of the first element of the range that each value is less than.
+        * \return The end of the output sequence.
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator upper_bound(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp);
+
+        /*! \brief \p binary_search writes whether the range holds an element equivalent to each value.
+        * \return The end of the output sequence.
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator binary_search(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp);
+
+        /*! \brief \p lower_bound_sorted is \p lower_bound for values sorted by \p comp. */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator lower_bound_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp);
+
+        /*! \brief \p upper_bound_sorted is \p upper_bound for values sorted by \p comp. */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator upper_bound_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp);
+
+        /*! \brief \p binary_search_sorted is \p binary_search for values sorted by \p comp. */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator binary_search_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/binary_search.inl>
+
+#endif
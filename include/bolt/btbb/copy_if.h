@@ -0,0 +1,95 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_COPY_IF_H )
+#define BOLT_BTBB_COPY_IF_H
+#pragma once
+
+#include "tbb/parallel_scan.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/copy_if.h
+    \brief Copies or removes the elements of a range that satisfy a predicate.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup copying
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-copy_if
+        *   \ingroup copying
+        *   \{
+        */
+
+        /*! \brief \p copy_if copies the elements of [first, last) for which \p pred is true to \p result, keeping
+        * their relative order.
+        *
+        * \param first  The beginning of the input sequence.
+        * \param last   The end of the input sequence.
+        * \param result The beginning of the output sequence.
+        * \param pred   The unary predicate.
+        * \return The end of the output sequence.
+        */
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred);
+
+        /*! \brief \p remove_copy_if copies the elements of [first, last) for which \p pred is false to \p result,
+        * keeping their relative order.
+        *
+        * \param first  The beginning of the input sequence.
+        * \param last   The end of the input sequence.
+        * \param result The beginning of the output sequence.
+        * \param pred   The unary predicate.
+        * \return The end of the output sequence.
+        */
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator remove_copy_if(InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred);
+
+        /*! \brief \p remove_if moves the elements of [first, last) for which \p pred is false to the front of the
+        * range, keeping their relative order.
+        *
+        * \param first The beginning of the sequence.
+        * \param last  The end of the sequence.
+        * \param pred  The unary predicate.
+        * \return The end of the remaining elements.
+        */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator remove_if(ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/copy_if.inl>
+
+#endif
@@ -0,0 +1,287 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_BINARY_SEARCH_INL )
+#define BOLT_BTBB_BINARY_SEARCH_INL
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+
+//  Number of entries of the merge path of the range and the sorted values walked by one task
+#define BOLT_BTBB_SEARCH_CHUNK_SIZE (1<<14)
+
+namespace bolt {
+    namespace btbb {
+
+        namespace detail {
+
+            enum searchModes { search_lower_bound, search_upper_bound, search_binary_search };
+
+            //  True when element lies at or past the bound searched for value
+            template< typename T, typename U, typename StrictWeakOrdering >
+            bool searchPastBound( const T& element, const U& value, searchModes mode, const StrictWeakOrdering& comp )
+            {
+                return ( mode == search_upper_bound ) ? comp( value, element ) : !comp( element, value );
+            }
+
+            /*For documentation on the parallel_for body see below link
+             *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_for_func.htm
+             *Every value is searched for on its own.
+            */
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                      typename StrictWeakOrdering >
+            struct Search_tbb
+            {
+                ForwardIterator first;
+                ForwardIterator last;
+                InputIterator values;
+                OutputIterator result;
+                searchModes mode;
+                StrictWeakOrdering comp;
+
+                Search_tbb( ForwardIterator _first, ForwardIterator _last, InputIterator _values,
+                    OutputIterator _result, searchModes _mode, const StrictWeakOrdering& _comp ): first( _first ),
+                    last( _last ), values( _values ), result( _result ), mode( _mode ), comp( _comp ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r ) const
+                {
+                    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+                    for( size_t i = r.begin( ); i != r.end( ); ++i )
+                    {
+                        if( mode == search_upper_bound )
+                        {
+                            result[ i ] = static_cast< oType >( std::upper_bound( first, last, values[ i ], comp )
+                                                                - first );
+                            continue;
+                        }
+
+                        ForwardIterator bound = std::lower_bound( first, last, values[ i ], comp );
+                        if( mode == search_lower_bound )
+                            result[ i ] = static_cast< oType >( bound - first );
+                        else
+                            result[ i ] = static_cast< oType >( bound != last && !comp( values[ i ], *bound ) );
+                    }
+                }
+            };
+
+            //  Number of elements of the range among the first diagonal entries of the merge path.  An element goes
+            //  in front of a value when it lies before the bound of that value.
+            template< typename ForwardIterator, typename InputIterator, typename StrictWeakOrdering >
+            size_t searchMergePathSplit( ForwardIterator a, size_t aLength, InputIterator b, size_t bLength,
+                                         size_t diagonal, searchModes mode, const StrictWeakOrdering& comp )
+            {
+                size_t low = ( diagonal > bLength ) ? diagonal - bLength : 0;
+                size_t high = std::min( diagonal, aLength );
+                while( low < high )
+                {
+                    size_t mid = low + ( high - low ) / 2;
+                    if( !searchPastBound( a[ mid ], b[ diagonal - 1 - mid ], mode, comp ) )
+                        low = mid + 1;
+                    else
+                        high = mid;
+                }
+                return low;
+            }
+
+            //  Walks the merge path from ( aIndex, bIndex ) to ( aStop, bStop ) and writes the answer of every value
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                      typename StrictWeakOrdering >
+            void searchMergeWalk( ForwardIterator a, size_t aLength, size_t aIndex, size_t aStop,
+                                  InputIterator b, size_t bIndex, size_t bStop,
+                                  OutputIterator result, searchModes mode, const StrictWeakOrdering& comp )
+            {
+                typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+                while( bIndex < bStop )
+                {
+                    if( aIndex < aStop && !searchPastBound( a[ aIndex ], b[ bIndex ], mode, comp ) )
+                    {
+                        ++aIndex;
+                        continue;
+                    }
+
+                    if( mode == search_binary_search )
+                        result[ bIndex ] = static_cast< oType >( aIndex < aLength &&
+                                                                 !comp( b[ bIndex ], a[ aIndex ] ) );
+                    else
+                        result[ bIndex ] = static_cast< oType >( aIndex );
+                    ++bIndex;
+                }
+            }
+
+            /*Each chunk of the merge path finds where it starts and ends in the range and in the values, and walks
+             *its part of both.  When it reaches a value, the number of elements of the range passed so far is the
+             *bound of that value.
+            */
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                      typename StrictWeakOrdering >
+            struct SearchMergeChunk_tbb
+            {
+                ForwardIterator a;
+                size_t aLength;
+                InputIterator b;
+                size_t bLength;
+                OutputIterator result;
+                searchModes mode;
+                StrictWeakOrdering comp;
+
+                SearchMergeChunk_tbb( ForwardIterator _a, size_t _aLength, InputIterator _b, size_t _bLength,
+                    OutputIterator _result, searchModes _mode, const StrictWeakOrdering& _comp ): a( _a ),
+                    aLength( _aLength ), b( _b ), bLength( _bLength ), result( _result ), mode( _mode ),
+                    comp( _comp ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r ) const
+                {
+                    size_t length = aLength + bLength;
+                    for( size_t c = r.begin( ); c != r.end( ); ++c )
+                    {
+                        size_t outBegin = c * BOLT_BTBB_SEARCH_CHUNK_SIZE;
+                        size_t outEnd = std::min< size_t >( outBegin + BOLT_BTBB_SEARCH_CHUNK_SIZE, length );
+
+                        size_t aIndex = searchMergePathSplit( a, aLength, b, bLength, outBegin, mode, comp );
+                        size_t aStop = searchMergePathSplit( a, aLength, b, bLength, outEnd, mode, comp );
+                        size_t bIndex = outBegin - aIndex;
+                        size_t bStop = outEnd - aStop;
+
+                        searchMergeWalk( a, aLength, aIndex, aStop, b, bIndex, bStop, result, mode, comp );
+                    }
+                }
+            };
+
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                      typename StrictWeakOrdering >
+            OutputIterator search( ForwardIterator first, ForwardIterator last, InputIterator values_first,
+                                   InputIterator values_last, OutputIterator result, searchModes mode,
+                                   const StrictWeakOrdering& comp )
+            {
+                size_t numValues = static_cast< size_t >( std::distance( values_first, values_last ) );
+
+                tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, numValues ),
+                    Search_tbb< ForwardIterator, InputIterator, OutputIterator, StrictWeakOrdering >( first, last,
+                        values_first, result, mode, comp ) );
+                return result + numValues;
+            }
+
+            template< typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                      typename StrictWeakOrdering >
+            OutputIterator search_sorted( ForwardIterator first, ForwardIterator last, InputIterator values_first,
+                                          InputIterator values_last, OutputIterator result, searchModes mode,
+                                          const StrictWeakOrdering& comp )
+            {
+                size_t aLength = static_cast< size_t >( std::distance( first, last ) );
+                size_t bLength = static_cast< size_t >( std::distance( values_first, values_last ) );
+                size_t length = aLength + bLength;
+                if( length <= BOLT_BTBB_SEARCH_CHUNK_SIZE )
+                {
+                    searchMergeWalk( first, aLength, 0, aLength, values_first, 0, bLength, result, mode, comp );
+                    return result + bLength;
+                }
+
+                size_t numChunks = ( length + BOLT_BTBB_SEARCH_CHUNK_SIZE - 1 ) / BOLT_BTBB_SEARCH_CHUNK_SIZE;
+
+                tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, numChunks ),
+                    SearchMergeChunk_tbb< ForwardIterator, InputIterator, OutputIterator, StrictWeakOrdering >(
+                        first, aLength, values_first, bLength, result, mode, comp ) );
+                return result + bLength;
+            }
+
+        }// end of bolt::btbb::detail namespace
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator lower_bound(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp)
+        {
+            return detail::search( first, last, values_first, values_last, result, detail::search_lower_bound, comp );
+        }
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator upper_bound(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp)
+        {
+            return detail::search( first, last, values_first, values_last, result, detail::search_upper_bound, comp );
+        }
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator binary_search(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp)
+        {
+            return detail::search( first, last, values_first, values_last, result, detail::search_binary_search,
+                                   comp );
+        }
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator lower_bound_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp)
+        {
+            return detail::search_sorted( first, last, values_first, values_last, result, detail::search_lower_bound,
+                                          comp );
+        }
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator upper_bound_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp)
+        {
+            return detail::search_sorted( first, last, values_first, values_last, result, detail::search_upper_bound,
+                                          comp );
+        }
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator binary_search_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp)
+        {
+            return detail::search_sorted( first, last, values_first, values_last, result,
+                                          detail::search_binary_search, comp );
+        }
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
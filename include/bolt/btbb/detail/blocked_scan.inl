@@ -0,0 +1,329 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_BLOCKED_SCAN_INL )
+#define BOLT_BTBB_BLOCKED_SCAN_INL
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+//  A block of the two-pass scans moves about this many bytes of input and output, so that it is still in L2 when the
+//  second pass comes back to it.  Blocks never go below the minimum, so that the per-block overhead stays small.
+#define BOLT_BTBB_SCAN_BLOCK_BYTES          (1<<18)
+#define BOLT_BTBB_SCAN_MIN_BLOCK_ELEMENTS   (1<<12)
+#define BOLT_BTBB_SCAN_BLOCKS_PER_THREAD    4
+
+namespace bolt {
+    namespace btbb {
+    namespace detail {
+
+        /*The running value of a scan at a block boundary.  hasValue is false until an element has been seen, so that
+         *no identity is needed; sawHead records whether a segment starts inside the range, in which case value no
+         *longer depends on anything to the left of it.
+        */
+        template< typename T >
+        struct ScanCarry
+        {
+            T value;
+            bool hasValue;
+            bool sawHead;
+
+            ScanCarry( ): value( ), hasValue( false ), sawHead( false ) {}
+            ScanCarry( const T& _value ): value( _value ), hasValue( true ), sawHead( false ) {}
+        };
+
+        inline size_t scanBlockElements( size_t numElements, size_t bytesPerElement )
+        {
+            size_t blockElements = BOLT_BTBB_SCAN_BLOCK_BYTES / std::max< size_t >( bytesPerElement, 1 );
+            blockElements = std::max< size_t >( blockElements, BOLT_BTBB_SCAN_MIN_BLOCK_ELEMENTS );
+
+            //  Small inputs are cut finer, so that every thread still gets a few blocks
+            size_t minBlocks = BOLT_BTBB_SCAN_BLOCKS_PER_THREAD *
+                static_cast< size_t >( tbb::task_scheduler_init::default_num_threads( ) );
+            if( numElements / blockElements < minBlocks )
+                blockElements = std::max< size_t >( ( numElements + minBlocks - 1 ) / minBlocks,
+                                                    BOLT_BTBB_SCAN_MIN_BLOCK_ELEMENTS );
+            return blockElements;
+        }
+
+        /*For documentation on the parallel_for body see below link
+         *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_for_func.htm
+         *First pass: every block but the last is reduced on its own.
+        */
+        template< typename Body >
+        struct BlockedScanReduce
+        {
+            typedef typename Body::Carry Carry;
+
+            const Body& body;
+            Carry* carries;
+            size_t numElements;
+            size_t blockElements;
+
+            BlockedScanReduce( const Body& _body, Carry* _carries, size_t _numElements, size_t _blockElements ):
+                body( _body ), carries( _carries ), numElements( _numElements ), blockElements( _blockElements ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                for( size_t block = r.begin( ); block != r.end( ); ++block )
+                {
+                    size_t begin = block * blockElements;
+                    size_t end = std::min( begin + blockElements, numElements );
+                    carries[ block ] = body.reduce( begin, end );
+                }
+            }
+        };
+
+        /*Second pass: every block is scanned from its prefix, and its slot is overwritten with the running value at
+         *its end.
+        */
+        template< typename Body >
+        struct BlockedScanBlock
+        {
+            typedef typename Body::Carry Carry;
+
+            const Body& body;
+            Carry* carries;
+            size_t numElements;
+            size_t blockElements;
+
+            BlockedScanBlock( const Body& _body, Carry* _carries, size_t _numElements, size_t _blockElements ):
+                body( _body ), carries( _carries ), numElements( _numElements ), blockElements( _blockElements ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                for( size_t block = r.begin( ); block != r.end( ); ++block )
+                {
+                    size_t begin = block * blockElements;
+                    size_t end = std::min( begin + blockElements, numElements );
+                    carries[ block ] = body.scan( begin, end, carries[ block ] );
+                }
+            }
+        };
+
+        /*Reduce, scan the block sums, then rescan: the input is read twice, one L2-sized block at a time, and the
+         *output written once.  Indices are size_t all the way through, so ranges are not limited to 2^31 elements.
+         *A Body provides
+         *    Carry initial( )                                   the running value before the first element
+         *    Carry reduce( size_t begin, size_t end )           the carry of a block on its own
+         *    Carry scan( size_t begin, size_t end, Carry in )   writes the block, returns the carry at its end
+         *    Carry combine( Carry left, Carry right )
+         *and blockedScan returns the carry at the end of the range.
+        */
+        template< typename Body >
+        typename Body::Carry blockedScan( const Body& body, size_t numElements, size_t bytesPerElement )
+        {
+            typedef typename Body::Carry Carry;
+            if( numElements == 0 )
+                return body.initial( );
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+
+            size_t blockElements = scanBlockElements( numElements, bytesPerElement );
+            size_t numBlocks = ( numElements + blockElements - 1 ) / blockElements;
+            std::vector< Carry > carries( numBlocks );
+
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, numBlocks - 1 ),
+                BlockedScanReduce< Body >( body, &carries[ 0 ], numElements, blockElements ) );
+
+            //  The block sums are few; an exclusive scan of them in place gives every block its prefix
+            Carry running = body.initial( );
+            for( size_t block = 0; block < numBlocks; ++block )
+            {
+                Carry blockSum = carries[ block ];
+                carries[ block ] = running;
+                if( block + 1 < numBlocks )
+                    running = body.combine( running, blockSum );
+            }
+
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, numBlocks ),
+                BlockedScanBlock< Body >( body, &carries[ 0 ], numElements, blockElements ) );
+
+            return carries[ numBlocks - 1 ];
+        }
+
+        template< typename T, typename BinaryFunction >
+        ScanCarry< T > combineScanCarry( const ScanCarry< T >& left, const ScanCarry< T >& right,
+                                         const BinaryFunction& binary_op )
+        {
+            if( !left.hasValue || right.sawHead )
+            {
+                ScanCarry< T > result( right );
+                result.sawHead = right.sawHead || left.sawHead;
+                return result;
+            }
+            if( !right.hasValue )
+                return left;
+
+            ScanCarry< T > result( binary_op( left.value, right.value ) );
+            result.sawHead = left.sawHead;
+            return result;
+        }
+
+        /*Body of the plain, transform and carry scans.  The unary op is applied on the fly in both passes, so the
+         *transformed values are never stored.
+        */
+        template< typename InputIterator, typename OutputIterator, typename UnaryFunction, typename BinaryFunction,
+                  typename T >
+        struct ScanBlock_tbb
+        {
+            typedef ScanCarry< T > Carry;
+
+            InputIterator first;
+            OutputIterator result;
+            UnaryFunction unary_op;
+            BinaryFunction binary_op;
+            bool inclusive;
+            Carry start;
+
+            ScanBlock_tbb( InputIterator _first, OutputIterator _result, const UnaryFunction& _unary_op,
+                           const BinaryFunction& _binary_op, bool _inclusive, const Carry& _start ):
+                first( _first ), result( _result ), unary_op( _unary_op ), binary_op( _binary_op ),
+                inclusive( _inclusive ), start( _start ) {}
+
+            Carry initial( ) const
+            {
+                return start;
+            }
+
+            Carry combine( const Carry& left, const Carry& right ) const
+            {
+                return combineScanCarry( left, right, binary_op );
+            }
+
+            Carry reduce( size_t begin, size_t end ) const
+            {
+                Carry sum;
+                for( size_t i = begin; i != end; ++i )
+                {
+                    T value = unary_op( first[ i ] );
+                    sum.value = sum.hasValue ? binary_op( sum.value, value ) : value;
+                    sum.hasValue = true;
+                }
+                return sum;
+            }
+
+            Carry scan( size_t begin, size_t end, Carry running ) const
+            {
+                for( size_t i = begin; i != end; ++i )
+                {
+                    T value = unary_op( first[ i ] );
+                    if( !inclusive )
+                        result[ i ] = running.value;
+                    running.value = running.hasValue ? binary_op( running.value, value ) : value;
+                    running.hasValue = true;
+                    if( inclusive )
+                        result[ i ] = running.value;
+                }
+                return running;
+            }
+        };
+
+        /*Body of the segmented scans.  Head tells whether a segment starts at an index, from head flags or from a
+         *change of key.  An exclusive scan restarts every segment from init.
+        */
+        template< typename InputIterator, typename Head, typename OutputIterator, typename BinaryFunction,
+                  typename T >
+        struct SegmentedScanBlock_tbb
+        {
+            typedef ScanCarry< T > Carry;
+
+            InputIterator first;
+            Head head;
+            OutputIterator result;
+            BinaryFunction binary_op;
+            bool inclusive;
+            T init;
+
+            SegmentedScanBlock_tbb( InputIterator _first, const Head& _head, OutputIterator _result,
+                                    const BinaryFunction& _binary_op, bool _inclusive, const T& _init ):
+                first( _first ), head( _head ), result( _result ), binary_op( _binary_op ),
+                inclusive( _inclusive ), init( _init ) {}
+
+            Carry initial( ) const
+            {
+                return Carry( );
+            }
+
+            Carry combine( const Carry& left, const Carry& right ) const
+            {
+                return combineScanCarry( left, right, binary_op );
+            }
+
+            Carry reduce( size_t begin, size_t end ) const
+            {
+                Carry sum;
+                for( size_t i = begin; i != end; ++i )
+                {
+                    T value = first[ i ];
+                    if( head( i ) )
+                    {
+                        sum.value = inclusive ? value : binary_op( init, value );
+                        sum.sawHead = true;
+                    }
+                    else
+                        sum.value = sum.hasValue ? binary_op( sum.value, value ) : value;
+                    sum.hasValue = true;
+                }
+                return sum;
+            }
+
+            Carry scan( size_t begin, size_t end, Carry running ) const
+            {
+                for( size_t i = begin; i != end; ++i )
+                {
+                    T value = first[ i ];
+                    bool isHead = head( i );
+                    if( inclusive )
+                    {
+                        running.value = ( isHead || !running.hasValue ) ? value : binary_op( running.value, value );
+                        result[ i ] = running.value;
+                    }
+                    else
+                    {
+                        T out = isHead ? init : running.value;
+                        result[ i ] = out;
+                        running.value = binary_op( out, value );
+                    }
+                    running.hasValue = true;
+                    running.sawHead = running.sawHead || isHead;
+                }
+                return running;
+            }
+        };
+
+        //  The unary op of the plain scans
+        template< typename T >
+        struct ScanIdentity_tbb
+        {
+            T operator()( const T& value ) const
+            {
+                return value;
+            }
+        };
+
+    }// end of bolt::btbb::detail namespace
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
@@ -0,0 +1,131 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_COPY_IF_INL )
+#define BOLT_BTBB_COPY_IF_INL
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+namespace bolt {
+    namespace btbb {
+
+        /*For documentation on the parallel_scan body see below link
+         *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_scan_func.htm
+         *The state of a body is the number of kept elements it has seen, which is where the final scan writes the
+         *next kept element.  A rejected element at position i has i - count rejected elements in front of it, so
+         *with a rejected output the same pass also gives the second half of a stable partition.
+        */
+        template< typename InputIterator, typename OutputIterator, typename RejectedIterator, typename Predicate >
+        struct CopyIf_tbb
+        {
+            size_t count;
+            InputIterator first;
+            OutputIterator result;
+            RejectedIterator rejected;
+            Predicate pred;
+            bool keepSelected;
+            bool keepRejected;
+
+            CopyIf_tbb( InputIterator _first, OutputIterator _result, RejectedIterator _rejected,
+                        const Predicate& _pred, bool _keepSelected, bool _keepRejected ): count( 0 ),
+                        first( _first ), result( _result ), rejected( _rejected ), pred( _pred ),
+                        keepSelected( _keepSelected ), keepRejected( _keepRejected ) {}
+
+            CopyIf_tbb( CopyIf_tbb& b, tbb::split ): count( 0 ), first( b.first ), result( b.result ),
+                        rejected( b.rejected ), pred( b.pred ), keepSelected( b.keepSelected ),
+                        keepRejected( b.keepRejected ) {}
+
+            template< typename Tag >
+            void operator()( const tbb::blocked_range< size_t >& r, Tag )
+            {
+                for( size_t i = r.begin( ); i != r.end( ); ++i )
+                {
+                    if( ( pred( first[ i ] ) ? true : false ) == keepSelected )
+                    {
+                        if( Tag::is_final_scan( ) )
+                            result[ count ] = first[ i ];
+                        ++count;
+                    }
+                    else if( keepRejected && Tag::is_final_scan( ) )
+                        rejected[ i - count ] = first[ i ];
+                }
+            }
+
+            void reverse_join( CopyIf_tbb& a )
+            {
+                count += a.count;
+            }
+
+            void assign( CopyIf_tbb& b )
+            {
+                count = b.count;
+            }
+        };
+
+        //  Runs the compaction and returns the number of kept elements
+        template< typename InputIterator, typename OutputIterator, typename RejectedIterator, typename Predicate >
+        size_t copy_if_scan( InputIterator first, InputIterator last, OutputIterator result,
+                             RejectedIterator rejected, const Predicate& pred, bool keepSelected,
+                             bool keepRejected )
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+            if( numElements == 0 )
+                return 0;
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+            CopyIf_tbb< InputIterator, OutputIterator, RejectedIterator, Predicate >
+                body( first, result, rejected, pred, keepSelected, keepRejected );
+            tbb::parallel_scan( tbb::blocked_range< size_t >( 0, numElements ), body, tbb::auto_partitioner( ) );
+            return body.count;
+        }
+
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred)
+        {
+            return result + copy_if_scan( first, last, result, result, pred, true, false );
+        }
+
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator remove_copy_if(InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred)
+        {
+            return result + copy_if_scan( first, last, result, result, pred, false, false );
+        }
+
+        //  The chunks of the final scan run concurrently, so a chunk could overwrite elements that a chunk to its
+        //  left has not read yet; the input is copied aside first
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator remove_if(ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred)
+        {
+            typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+            std::vector< iType > input( first, last );
+            return first + copy_if_scan( input.begin( ), input.end( ), first, first, pred, false, false );
+        }
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
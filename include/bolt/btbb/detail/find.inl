@@ -0,0 +1,189 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_FIND_INL )
+#define BOLT_BTBB_FIND_INL
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+
+//  Number of elements a task tests before it checks whether an earlier match has made its range useless
+#define FIND_TBB_CHUNK 4096
+
+namespace bolt {
+    namespace btbb {
+
+        namespace detail {
+
+            //  Tests the indices of its range chunk by chunk.  found holds the smallest matching index seen so far;
+            //  a chunk past it cannot hold the first match and is skipped.  When any match will do, context is set
+            //  and the first match cancels the tasks that have not started yet.
+            template< typename Matcher >
+            struct FindFirst_tbb
+            {
+                Matcher matcher;
+                tbb::atomic< size_t >* found;
+                tbb::task_group_context* context;
+
+                FindFirst_tbb( const Matcher& _matcher, tbb::atomic< size_t >* _found,
+                    tbb::task_group_context* _context ): matcher( _matcher ), found( _found ), context( _context ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r ) const
+                {
+                    for( size_t chunk = r.begin( ); chunk < r.end( ); chunk += FIND_TBB_CHUNK )
+                    {
+                        if( chunk >= *found )
+                            return;
+
+                        size_t chunkEnd = std::min< size_t >( chunk + FIND_TBB_CHUNK, r.end( ) );
+                        for( size_t i = chunk; i < chunkEnd; ++i )
+                        {
+                            if( matcher( i ) )
+                            {
+                                size_t current = *found;
+                                while( i < current )
+                                {
+                                    size_t previous = found->compare_and_swap( i, current );
+                                    if( previous == current )
+                                        break;
+                                    current = previous;
+                                }
+                                if( context )
+                                    context->cancel_group_execution( );
+                                return;
+                            }
+                        }
+                    }
+                }
+            };
+
+            //  Returns the smallest index in [0, numElements) that matches, or numElements.  With anyMatch the
+            //  search stops at the first match found by any task, which need not be the smallest one.
+            template< typename Matcher >
+            size_t find_first_index( const Matcher& matcher, size_t numElements, bool anyMatch )
+            {
+                tbb::atomic< size_t > found;
+                found = numElements;
+                if( numElements == 0 )
+                    return numElements;
+
+                tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+                tbb::task_group_context context;
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, numElements ),
+                    FindFirst_tbb< Matcher >( matcher, &found, anyMatch ? &context : NULL ),
+                    tbb::auto_partitioner( ), context );
+                return found;
+            }
+
+            template< typename InputIterator, typename Predicate >
+            struct PredicateMatcher_tbb
+            {
+                InputIterator first;
+                Predicate predicate;
+                bool expected;
+
+                PredicateMatcher_tbb( InputIterator _first, const Predicate& _predicate, bool _expected ):
+                    first( _first ), predicate( _predicate ), expected( _expected ) {}
+
+                bool operator()( size_t i ) const
+                {
+                    return ( predicate( first[ i ] ) ? true : false ) == expected;
+                }
+            };
+
+            template< typename InputIterator, typename EqualityComparable >
+            struct ValueMatcher_tbb
+            {
+                InputIterator first;
+                const EqualityComparable* value;
+
+                ValueMatcher_tbb( InputIterator _first, const EqualityComparable& _value ):
+                    first( _first ), value( &_value ) {}
+
+                bool operator()( size_t i ) const
+                {
+                    return first[ i ] == *value;
+                }
+            };
+
+        }
+
+        template<typename InputIterator, typename EqualityComparable>
+        InputIterator find(InputIterator first,
+            InputIterator last,
+            const EqualityComparable& value)
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+            return first + detail::find_first_index(
+                detail::ValueMatcher_tbb< InputIterator, EqualityComparable >( first, value ), numElements, false );
+        }
+
+        template<typename InputIterator, typename Predicate>
+        InputIterator find_if(InputIterator first,
+            InputIterator last,
+            Predicate predicate)
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+            return first + detail::find_first_index(
+                detail::PredicateMatcher_tbb< InputIterator, Predicate >( first, predicate, true ), numElements,
+                false );
+        }
+
+        template<typename InputIterator, typename Predicate>
+        InputIterator find_if_not(InputIterator first,
+            InputIterator last,
+            Predicate predicate)
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+            return first + detail::find_first_index(
+                detail::PredicateMatcher_tbb< InputIterator, Predicate >( first, predicate, false ), numElements,
+                false );
+        }
+
+        template<typename InputIterator, typename Predicate>
+        bool any_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate)
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+            return detail::find_first_index( detail::PredicateMatcher_tbb< InputIterator, Predicate >( first,
+                predicate, true ), numElements, true ) != numElements;
+        }
+
+        template<typename InputIterator, typename Predicate>
+        bool all_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate)
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+            return detail::find_first_index( detail::PredicateMatcher_tbb< InputIterator, Predicate >( first,
+                predicate, false ), numElements, true ) == numElements;
+        }
+
+        template<typename InputIterator, typename Predicate>
+        bool none_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate)
+        {
+            return !bolt::btbb::any_of( first, last, predicate );
+        }
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
@@ -0,0 +1,92 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_HISTOGRAM_INL )
+#define BOLT_BTBB_HISTOGRAM_INL
+#pragma once
+
+#include <iterator>
+
+namespace bolt {
+    namespace btbb {
+        namespace detail {
+
+            typedef tbb::enumerable_thread_specific< std::vector< unsigned int > > HistogramThreadBins;
+
+            /*For documentation on the parallel_for body see below link
+             *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_for_func.htm
+             *Every task counts into the bins of the thread that runs it.
+            */
+            template< typename InputIterator, typename BinFunctor >
+            struct Histogram {
+                InputIterator first;
+                unsigned int numBins;
+                BinFunctor bin;
+                HistogramThreadBins& threadBins;
+
+                Histogram( const InputIterator& _first, unsigned int _numBins, const BinFunctor& _bin,
+                    HistogramThreadBins& _threadBins ) : first( _first ), numBins( _numBins ), bin( _bin ),
+                    threadBins( _threadBins ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r ) const
+                {
+                    std::vector< unsigned int >& bins = threadBins.local( );
+                    BinFunctor binOf( bin );
+                    for( size_t i = r.begin( ); i != r.end( ); ++i )
+                    {
+                        unsigned int b = binOf( first[ i ] );
+                        if( b < numBins )
+                            ++bins[ b ];
+                    }
+                }
+            };
+
+        }
+
+        template< typename InputIterator, typename OutputIterator, typename BinFunctor >
+        void histogram( InputIterator first,
+            InputIterator last,
+            OutputIterator bins_first,
+            size_t numBins,
+            BinFunctor bin )
+        {
+            std::vector< unsigned int > counts( numBins, 0 );
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+            if( numElements != 0 && numBins != 0 )
+            {
+                tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+                detail::HistogramThreadBins threadBins( std::vector< unsigned int >( numBins, 0 ) );
+
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, numElements ),
+                    detail::Histogram< InputIterator, BinFunctor >( first, static_cast< unsigned int >( numBins ),
+                    bin, threadBins ) );
+
+                for( detail::HistogramThreadBins::iterator t = threadBins.begin( ); t != threadBins.end( ); ++t )
+                {
+                    for( size_t b = 0; b < numBins; ++b )
+                        counts[ b ] += ( *t )[ b ];
+                }
+            }
+
+            for( size_t b = 0; b < numBins; ++b )
+                bins_first[ b ] = counts[ b ];
+        }
+
+    }
+}
+
+#endif // BOLT_BTBB_HISTOGRAM_INL
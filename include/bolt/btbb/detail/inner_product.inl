@@ -0,0 +1,97 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_INNER_PRODUCT_INL )
+#define BOLT_BTBB_INNER_PRODUCT_INL
+#pragma once
+
+namespace bolt {
+    namespace btbb {
+        namespace detail {
+
+            /*  Body of the imperative form of tbb::parallel_reduce.  The body made from init starts with it; the
+             *  split bodies start empty and take the first product of their block, so f1 needs no identity.
+             */
+            template< typename InputIterator1, typename InputIterator2, typename T, typename BinaryFunction1,
+                      typename BinaryFunction2 >
+            struct Inner_Product {
+                InputIterator1 first1;
+                InputIterator2 first2;
+                BinaryFunction1 f1;
+                BinaryFunction2 f2;
+                T value;
+                bool empty;
+
+                Inner_Product( const InputIterator1& _first1, const InputIterator2& _first2,
+                    const BinaryFunction1& _f1, const BinaryFunction2& _f2, const T& init )
+                    : first1( _first1 ), first2( _first2 ), f1( _f1 ), f2( _f2 ), value( init ), empty( false ) {}
+
+                Inner_Product( Inner_Product& s, tbb::split )
+                    : first1( s.first1 ), first2( s.first2 ), f1( s.f1 ), f2( s.f2 ), value( s.value ),
+                      empty( true ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r )
+                {
+                    size_t index = r.begin( );
+                    T acc = value;
+                    if( empty && index != r.end( ) )
+                    {
+                        acc = static_cast< T >( f2( first1[ index ], first2[ index ] ) );
+                        empty = false;
+                        ++index;
+                    }
+                    for( ; index != r.end( ); ++index )
+                        acc = static_cast< T >( f1( acc, f2( first1[ index ], first2[ index ] ) ) );
+                    value = acc;
+                }
+
+                //  rhs covers the block right after the one of this body
+                void join( Inner_Product& rhs )
+                {
+                    if( rhs.empty )
+                        return;
+                    value = empty ? rhs.value : static_cast< T >( f1( value, rhs.value ) );
+                    empty = false;
+                }
+            };
+
+        }
+
+        template< typename InputIterator1, typename InputIterator2, typename T, typename BinaryFunction1,
+                  typename BinaryFunction2 >
+        T inner_product( InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            T init,
+            BinaryFunction1 f1,
+            BinaryFunction2 f2 )
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
+            if( numElements == 0 )
+                return init;
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+            detail::Inner_Product< InputIterator1, InputIterator2, T, BinaryFunction1, BinaryFunction2 >
+                body( first1, first2, f1, f2, init );
+            tbb::parallel_reduce( tbb::blocked_range< size_t >( 0, numElements ), body );
+            return body.value;
+        }
+
+    }
+}
+
+#endif // BOLT_BTBB_INNER_PRODUCT_INL
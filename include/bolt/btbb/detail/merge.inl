@@ -0,0 +1,158 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_MERGE_INL )
+#define BOLT_BTBB_MERGE_INL
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+
+#include "bolt/btbb/stablesort.h"
+
+//  Number of output elements merged by one task; smaller merges are done serially
+#define BOLT_BTBB_MERGE_CHUNK_SIZE (1<<14)
+
+namespace bolt {
+    namespace btbb {
+
+        /*For documentation on the parallel_for body see below link
+         *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_for_func.htm
+         *Each chunk of the output finds where its first and last element come from with the merge path, and merges
+         *that part of both inputs.  When hasValues is false the value iterators are ignored.
+        */
+        template< typename KeyIterator1, typename KeyIterator2, typename ValueIterator1, typename ValueIterator2,
+                  typename KeyOutputIterator, typename ValueOutputIterator, typename StrictWeakOrdering >
+        struct MergeChunk
+        {
+            KeyIterator1 a;
+            size_t aLength;
+            KeyIterator2 b;
+            size_t bLength;
+            ValueIterator1 aValues;
+            ValueIterator2 bValues;
+            KeyOutputIterator keysOut;
+            ValueOutputIterator valuesOut;
+            bool hasValues;
+            StrictWeakOrdering comp;
+
+            MergeChunk( KeyIterator1 _a, size_t _aLength, KeyIterator2 _b, size_t _bLength,
+                        ValueIterator1 _aValues, ValueIterator2 _bValues,
+                        KeyOutputIterator _keysOut, ValueOutputIterator _valuesOut, bool _hasValues,
+                        StrictWeakOrdering _comp ): a( _a ), aLength( _aLength ), b( _b ), bLength( _bLength ),
+                        aValues( _aValues ), bValues( _bValues ), keysOut( _keysOut ), valuesOut( _valuesOut ),
+                        hasValues( _hasValues ), comp( _comp ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                size_t length = aLength + bLength;
+                for( size_t c = r.begin( ); c != r.end( ); ++c )
+                {
+                    size_t outBegin = c * BOLT_BTBB_MERGE_CHUNK_SIZE;
+                    size_t outEnd = std::min< size_t >( outBegin + BOLT_BTBB_MERGE_CHUNK_SIZE, length );
+
+                    size_t aIndex = mergePathSplit( a, aLength, b, bLength, outBegin, comp );
+                    size_t aStop = mergePathSplit( a, aLength, b, bLength, outEnd, comp );
+                    size_t bIndex = outBegin - aIndex;
+                    size_t bStop = outEnd - aStop;
+
+                    if( !hasValues )
+                    {
+                        std::merge( a + aIndex, a + aStop, b + bIndex, b + bStop, keysOut + outBegin, comp );
+                        continue;
+                    }
+
+                    for( size_t out = outBegin; out < outEnd; ++out )
+                    {
+                        if( bIndex < bStop && ( aIndex == aStop || comp( b[ bIndex ], a[ aIndex ] ) ) )
+                        {
+                            keysOut[ out ] = b[ bIndex ];
+                            valuesOut[ out ] = bValues[ bIndex ];
+                            ++bIndex;
+                        }
+                        else
+                        {
+                            keysOut[ out ] = a[ aIndex ];
+                            valuesOut[ out ] = aValues[ aIndex ];
+                            ++aIndex;
+                        }
+                    }
+                }
+            }
+        };
+
+        template< typename KeyIterator1, typename KeyIterator2, typename ValueIterator1, typename ValueIterator2,
+                  typename KeyOutputIterator, typename ValueOutputIterator, typename StrictWeakOrdering >
+        void mergeChunks( KeyIterator1 a, size_t aLength, KeyIterator2 b, size_t bLength,
+                          ValueIterator1 aValues, ValueIterator2 bValues,
+                          KeyOutputIterator keysOut, ValueOutputIterator valuesOut, bool hasValues,
+                          StrictWeakOrdering comp )
+        {
+            size_t length = aLength + bLength;
+            size_t numChunks = ( length + BOLT_BTBB_MERGE_CHUNK_SIZE - 1 ) / BOLT_BTBB_MERGE_CHUNK_SIZE;
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, numChunks ),
+                MergeChunk< KeyIterator1, KeyIterator2, ValueIterator1, ValueIterator2, KeyOutputIterator,
+                            ValueOutputIterator, StrictWeakOrdering >( a, aLength, b, bLength, aValues, bValues,
+                                                                       keysOut, valuesOut, hasValues, comp ) );
+        }
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator merge(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakOrdering comp)
+        {
+            size_t aLength = static_cast< size_t >( std::distance( first1, last1 ) );
+            size_t bLength = static_cast< size_t >( std::distance( first2, last2 ) );
+            if( aLength + bLength <= BOLT_BTBB_MERGE_CHUNK_SIZE )
+                return std::merge( first1, last1, first2, last2, result, comp );
+
+            mergeChunks( first1, aLength, first2, bLength, first1, first2, result, result, false, comp );
+            return result + ( aLength + bLength );
+        }
+
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2,
+                 typename StrictWeakOrdering>
+        std::pair<OutputIterator1, OutputIterator2>
+        merge_by_key(InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakOrdering comp)
+        {
+            size_t aLength = static_cast< size_t >( std::distance( keys_first1, keys_last1 ) );
+            size_t bLength = static_cast< size_t >( std::distance( keys_first2, keys_last2 ) );
+
+            mergeChunks( keys_first1, aLength, keys_first2, bLength, values_first1, values_first2,
+                         keys_result, values_result, true, comp );
+            return std::make_pair( keys_result + ( aLength + bLength ), values_result + ( aLength + bLength ) );
+        }
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
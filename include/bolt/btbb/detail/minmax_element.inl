@@ -0,0 +1,255 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_MINMAX_ELEMENT_INL )
+#define BOLT_BTBB_MINMAX_ELEMENT_INL
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+//  Number of keys whose runs one task of argmin_by_key counts and writes
+#define BOLT_BTBB_ARGMIN_BY_KEY_BLOCK_SIZE  (1<<14)
+
+namespace bolt {
+    namespace btbb {
+        namespace detail {
+
+            /*For documentation on the reduce object see below link
+             *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_reduce_func.htm
+             *A body sees its subranges from left to right, and joins the body of the subrange on its right, so
+             *keeping the earlier position on ties gives the first smallest element and keeping the later one gives
+             *the last largest.
+            */
+            template< typename RandomAccessIterator, typename StrictWeakOrdering >
+            struct MinMax_Element {
+                RandomAccessIterator first;
+                StrictWeakOrdering comp;
+                bool trackMax;
+                size_t minIndex;
+                size_t maxIndex;
+                bool empty;
+
+                MinMax_Element( const RandomAccessIterator& _first, const StrictWeakOrdering& _comp, bool _trackMax )
+                    : first( _first ), comp( _comp ), trackMax( _trackMax ), minIndex( 0 ), maxIndex( 0 ),
+                      empty( true ) {}
+
+                MinMax_Element( MinMax_Element& s, tbb::split )
+                    : first( s.first ), comp( s.comp ), trackMax( s.trackMax ), minIndex( 0 ), maxIndex( 0 ),
+                      empty( true ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r )
+                {
+                    size_t index = r.begin( );
+                    if( empty && index != r.end( ) )
+                    {
+                        minIndex = maxIndex = index++;
+                        empty = false;
+                    }
+                    for( ; index != r.end( ); ++index )
+                    {
+                        if( comp( first[ index ], first[ minIndex ] ) )
+                            minIndex = index;
+                        if( trackMax && !comp( first[ index ], first[ maxIndex ] ) )
+                            maxIndex = index;
+                    }
+                }
+
+                void join( MinMax_Element& rhs )
+                {
+                    if( rhs.empty )
+                        return;
+                    if( empty )
+                    {
+                        minIndex = rhs.minIndex;
+                        maxIndex = rhs.maxIndex;
+                        empty = false;
+                        return;
+                    }
+                    if( comp( first[ rhs.minIndex ], first[ minIndex ] ) )
+                        minIndex = rhs.minIndex;
+                    if( trackMax && !comp( first[ rhs.maxIndex ], first[ maxIndex ] ) )
+                        maxIndex = rhs.maxIndex;
+                }
+            };
+
+            //  A run belongs to the block that holds its first key
+            template< typename InputIterator1, typename BinaryPredicate >
+            inline bool argminByKeyHead( const InputIterator1& keys, size_t index, BinaryPredicate& binary_pred )
+            {
+                return ( index == 0 ) || !binary_pred( keys[ index - 1 ], keys[ index ] );
+            }
+
+            /*For documentation on the parallel_for body see below link
+             *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_for_func.htm
+             *Every block counts the runs that start in it.
+            */
+            template< typename InputIterator1, typename BinaryPredicate >
+            struct ArgminByKeyCount {
+                InputIterator1 keys;
+                size_t length;
+                BinaryPredicate binary_pred;
+                size_t* counts;
+
+                ArgminByKeyCount( const InputIterator1& _keys, size_t _length, const BinaryPredicate& _binary_pred,
+                    size_t* _counts ) : keys( _keys ), length( _length ), binary_pred( _binary_pred ),
+                    counts( _counts ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r ) const
+                {
+                    BinaryPredicate pred( binary_pred );
+                    for( size_t block = r.begin( ); block != r.end( ); ++block )
+                    {
+                        size_t begin = block * BOLT_BTBB_ARGMIN_BY_KEY_BLOCK_SIZE;
+                        size_t end = std::min< size_t >( begin + BOLT_BTBB_ARGMIN_BY_KEY_BLOCK_SIZE, length );
+                        size_t heads = 0;
+                        for( size_t i = begin; i < end; ++i )
+                            heads += argminByKeyHead( keys, i, pred ) ? 1 : 0;
+                        counts[ block ] = heads;
+                    }
+                }
+            };
+
+            /*Every block writes the runs that start in it from the offset of the exclusive scan of the counts, and
+             *reads past its end for the last of them when that run is still open.
+            */
+            template< typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                      typename OutputIterator2, typename BinaryPredicate, typename StrictWeakOrdering >
+            struct ArgminByKeyWrite {
+                InputIterator1 keys;
+                InputIterator2 values;
+                OutputIterator1 keys_output;
+                OutputIterator2 indices_output;
+                size_t length;
+                BinaryPredicate binary_pred;
+                StrictWeakOrdering comp;
+                const size_t* offsets;
+
+                ArgminByKeyWrite( const InputIterator1& _keys, const InputIterator2& _values,
+                    const OutputIterator1& _keys_output, const OutputIterator2& _indices_output, size_t _length,
+                    const BinaryPredicate& _binary_pred, const StrictWeakOrdering& _comp, const size_t* _offsets )
+                    : keys( _keys ), values( _values ), keys_output( _keys_output ),
+                      indices_output( _indices_output ), length( _length ), binary_pred( _binary_pred ),
+                      comp( _comp ), offsets( _offsets ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r ) const
+                {
+                    typedef typename std::iterator_traits< OutputIterator2 >::value_type indexType;
+                    BinaryPredicate pred( binary_pred );
+                    StrictWeakOrdering order( comp );
+                    for( size_t block = r.begin( ); block != r.end( ); ++block )
+                    {
+                        size_t begin = block * BOLT_BTBB_ARGMIN_BY_KEY_BLOCK_SIZE;
+                        size_t end = std::min< size_t >( begin + BOLT_BTBB_ARGMIN_BY_KEY_BLOCK_SIZE, length );
+                        size_t position = offsets[ block ];
+
+                        size_t i = begin;
+                        while( i < end && !argminByKeyHead( keys, i, pred ) )
+                            ++i;
+                        while( i < end )
+                        {
+                            size_t best = i;
+                            size_t next = i + 1;
+                            for( ; next < length && pred( keys[ next - 1 ], keys[ next ] ); ++next )
+                            {
+                                if( order( values[ next ], values[ best ] ) )
+                                    best = next;
+                            }
+                            keys_output[ position ] = keys[ i ];
+                            indices_output[ position ] = static_cast< indexType >( best );
+                            ++position;
+                            i = next;
+                        }
+                    }
+                }
+            };
+
+        }
+
+        template< typename ForwardIterator, typename StrictWeakOrdering >
+        ForwardIterator min_element( ForwardIterator first,
+            ForwardIterator last,
+            StrictWeakOrdering comp )
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+            if( numElements == 0 )
+                return last;
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+            detail::MinMax_Element< ForwardIterator, StrictWeakOrdering > body( first, comp, false );
+            tbb::parallel_reduce( tbb::blocked_range< size_t >( 0, numElements ), body );
+            return first + body.minIndex;
+        }
+
+        template< typename ForwardIterator, typename StrictWeakOrdering >
+        std::pair< ForwardIterator, ForwardIterator > minmax_element( ForwardIterator first,
+            ForwardIterator last,
+            StrictWeakOrdering comp )
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+            if( numElements == 0 )
+                return std::make_pair( last, last );
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+            detail::MinMax_Element< ForwardIterator, StrictWeakOrdering > body( first, comp, true );
+            tbb::parallel_reduce( tbb::blocked_range< size_t >( 0, numElements ), body );
+            return std::make_pair( first + body.minIndex, first + body.maxIndex );
+        }
+
+        template< typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                  typename OutputIterator2, typename BinaryPredicate, typename StrictWeakOrdering >
+        std::pair< OutputIterator1, OutputIterator2 > argmin_by_key( InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            BinaryPredicate binary_pred,
+            StrictWeakOrdering comp )
+        {
+            size_t numElements = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+            if( numElements == 0 )
+                return std::make_pair( keys_output, indices_output );
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+            size_t numBlocks = ( numElements + BOLT_BTBB_ARGMIN_BY_KEY_BLOCK_SIZE - 1 ) /
+                BOLT_BTBB_ARGMIN_BY_KEY_BLOCK_SIZE;
+            std::vector< size_t > offsets( numBlocks );
+
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, numBlocks ),
+                detail::ArgminByKeyCount< InputIterator1, BinaryPredicate >( keys_first, numElements, binary_pred,
+                &offsets[ 0 ] ) );
+
+            size_t numRuns = 0;
+            for( size_t block = 0; block < numBlocks; ++block )
+            {
+                size_t count = offsets[ block ];
+                offsets[ block ] = numRuns;
+                numRuns += count;
+            }
+
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, numBlocks ),
+                detail::ArgminByKeyWrite< InputIterator1, InputIterator2, OutputIterator1, OutputIterator2,
+                BinaryPredicate, StrictWeakOrdering >( keys_first, values_first, keys_output, indices_output,
+                numElements, binary_pred, comp, &offsets[ 0 ] ) );
+
+            return std::make_pair( keys_output + numRuns, indices_output + numRuns );
+        }
+
+    }
+}
+
+#endif // BOLT_BTBB_MINMAX_ELEMENT_INL
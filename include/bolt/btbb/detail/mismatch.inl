@@ -0,0 +1,72 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_MISMATCH_INL )
+#define BOLT_BTBB_MISMATCH_INL
+#pragma once
+
+namespace bolt {
+    namespace btbb {
+
+        namespace detail {
+
+            template< typename InputIterator1, typename InputIterator2, typename BinaryPredicate >
+            struct MismatchMatcher_tbb
+            {
+                InputIterator1 first1;
+                InputIterator2 first2;
+                BinaryPredicate predicate;
+
+                MismatchMatcher_tbb( InputIterator1 _first1, InputIterator2 _first2,
+                    const BinaryPredicate& _predicate ): first1( _first1 ), first2( _first2 ),
+                    predicate( _predicate ) {}
+
+                bool operator()( size_t i ) const
+                {
+                    return !predicate( first1[ i ], first2[ i ] );
+                }
+            };
+
+        }
+
+        template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+        std::pair< InputIterator1, InputIterator2 > mismatch(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            BinaryPredicate predicate)
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
+            size_t index = detail::find_first_index( detail::MismatchMatcher_tbb< InputIterator1, InputIterator2,
+                BinaryPredicate >( first1, first2, predicate ), numElements, false );
+            return std::make_pair( first1 + index, first2 + index );
+        }
+
+        template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+        bool equal(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            BinaryPredicate predicate)
+        {
+            size_t numElements = static_cast< size_t >( std::distance( first1, last1 ) );
+            return detail::find_first_index( detail::MismatchMatcher_tbb< InputIterator1, InputIterator2,
+                BinaryPredicate >( first1, first2, predicate ), numElements, true ) == numElements;
+        }
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
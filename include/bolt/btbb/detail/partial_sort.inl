@@ -0,0 +1,310 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_PARTIAL_SORT_INL )
+#define BOLT_BTBB_PARTIAL_SORT_INL
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+//  Ranges at or below this size are handed to std::nth_element
+#define BOLT_BTBB_SELECT_SERIAL_CUTOFF  (1<<16)
+//  Number of elements counted and scattered by one task of the partitioning pass
+#define BOLT_BTBB_SELECT_BLOCK_SIZE     (1<<14)
+//  Number of evenly spaced elements the pivot is taken from
+#define BOLT_BTBB_SELECT_SAMPLES        63
+
+namespace bolt {
+    namespace btbb {
+
+        /*For documentation on the parallel_for body see below link
+         *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_for_func.htm
+         *Each block of the active range counts how many of its elements order before, equal to and after the pivot.
+        */
+        template< typename RandomAccessIterator, typename T, typename StrictWeakOrdering >
+        struct SelectCount
+        {
+            RandomAccessIterator first;
+            size_t length;
+            const T& pivot;
+            StrictWeakOrdering comp;
+            size_t* lessCounts;
+            size_t* equalCounts;
+
+            SelectCount( RandomAccessIterator _first, size_t _length, const T& _pivot, StrictWeakOrdering _comp,
+                         size_t* _lessCounts, size_t* _equalCounts ): first( _first ), length( _length ),
+                         pivot( _pivot ), comp( _comp ), lessCounts( _lessCounts ), equalCounts( _equalCounts ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                for( size_t block = r.begin( ); block != r.end( ); ++block )
+                {
+                    size_t begin = block * BOLT_BTBB_SELECT_BLOCK_SIZE;
+                    size_t end = std::min< size_t >( begin + BOLT_BTBB_SELECT_BLOCK_SIZE, length );
+                    size_t less = 0, equal = 0;
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        if( comp( first[ i ], pivot ) )
+                            ++less;
+                        else if( !comp( pivot, first[ i ] ) )
+                            ++equal;
+                    }
+                    lessCounts[ block ] = less;
+                    equalCounts[ block ] = equal;
+                }
+            }
+        };
+
+        /*Each block writes its elements to the offsets computed from the exclusive scan of the block counts, so the
+         *scratch buffer ends up holding [ less | equal | greater ].
+        */
+        template< typename RandomAccessIterator, typename T, typename StrictWeakOrdering >
+        struct SelectScatter
+        {
+            RandomAccessIterator first;
+            size_t length;
+            const T& pivot;
+            StrictWeakOrdering comp;
+            const size_t* lessOffsets;
+            const size_t* equalOffsets;
+            const size_t* greaterOffsets;
+            T* scratch;
+
+            SelectScatter( RandomAccessIterator _first, size_t _length, const T& _pivot, StrictWeakOrdering _comp,
+                           const size_t* _lessOffsets, const size_t* _equalOffsets, const size_t* _greaterOffsets,
+                           T* _scratch ): first( _first ), length( _length ), pivot( _pivot ), comp( _comp ),
+                           lessOffsets( _lessOffsets ), equalOffsets( _equalOffsets ),
+                           greaterOffsets( _greaterOffsets ), scratch( _scratch ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                for( size_t block = r.begin( ); block != r.end( ); ++block )
+                {
+                    size_t begin = block * BOLT_BTBB_SELECT_BLOCK_SIZE;
+                    size_t end = std::min< size_t >( begin + BOLT_BTBB_SELECT_BLOCK_SIZE, length );
+                    size_t less = lessOffsets[ block ];
+                    size_t equal = equalOffsets[ block ];
+                    size_t greater = greaterOffsets[ block ];
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        if( comp( first[ i ], pivot ) )
+                            scratch[ less++ ] = first[ i ];
+                        else if( !comp( pivot, first[ i ] ) )
+                            scratch[ equal++ ] = first[ i ];
+                        else
+                            scratch[ greater++ ] = first[ i ];
+                    }
+                }
+            }
+        };
+
+        template< typename RandomAccessIterator, typename T >
+        struct SelectCopyBack
+        {
+            const T* scratch;
+            RandomAccessIterator first;
+
+            SelectCopyBack( const T* _scratch, RandomAccessIterator _first ): scratch( _scratch ), first( _first ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                for( size_t i = r.begin( ); i != r.end( ); ++i )
+                    first[ i ] = scratch[ i ];
+            }
+        };
+
+        //  The key/value record used by top_k_by_key to carry values along with the selected keys
+        template< typename kType, typename vType >
+        struct SelectKeyValue
+        {
+            kType key;
+            vType value;
+        };
+
+        template< typename kType, typename vType, typename StrictWeakOrdering >
+        struct SelectKeyValueComp
+        {
+            StrictWeakOrdering comp;
+            SelectKeyValueComp( const StrictWeakOrdering& _comp ): comp( _comp ) {}
+
+            bool operator( )( const SelectKeyValue< kType, vType >& lhs,
+                              const SelectKeyValue< kType, vType >& rhs ) const
+            {
+                return comp( lhs.key, rhs.key );
+            }
+        };
+
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void nth_element(RandomAccessIterator first,
+            RandomAccessIterator nth,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp)
+        {
+            typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+
+            size_t lo = 0;
+            size_t hi = static_cast< size_t >( std::distance( first, last ) );
+            size_t target = static_cast< size_t >( std::distance( first, nth ) );
+            if( target >= hi )
+                return;
+
+            tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
+
+            std::vector< T > scratch;
+            std::vector< size_t > lessCounts, equalCounts, greaterOffsets;
+            std::vector< T > samples( BOLT_BTBB_SELECT_SAMPLES );
+
+            while( hi - lo > BOLT_BTBB_SELECT_SERIAL_CUTOFF )
+            {
+                size_t length = hi - lo;
+                RandomAccessIterator rangeFirst = first + lo;
+
+                //  Median of evenly spaced samples is a cheap pivot that keeps the partitions balanced on sorted input
+                for( size_t s = 0; s < BOLT_BTBB_SELECT_SAMPLES; ++s )
+                    samples[ s ] = rangeFirst[ ( length / BOLT_BTBB_SELECT_SAMPLES ) * s ];
+                std::nth_element( samples.begin( ), samples.begin( ) + BOLT_BTBB_SELECT_SAMPLES / 2, samples.end( ),
+                                  comp );
+                const T pivot = samples[ BOLT_BTBB_SELECT_SAMPLES / 2 ];
+
+                size_t numBlocks = ( length + BOLT_BTBB_SELECT_BLOCK_SIZE - 1 ) / BOLT_BTBB_SELECT_BLOCK_SIZE;
+                lessCounts.resize( numBlocks );
+                equalCounts.resize( numBlocks );
+                greaterOffsets.resize( numBlocks );
+
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, numBlocks ),
+                    SelectCount< RandomAccessIterator, T, StrictWeakOrdering >( rangeFirst, length, pivot, comp,
+                                                                               &lessCounts[ 0 ], &equalCounts[ 0 ] ) );
+
+                //  Exclusive scan of the per-block counts; the number of blocks is small, so this stays serial
+                size_t totalLess = 0, totalEqual = 0;
+                for( size_t block = 0; block < numBlocks; ++block )
+                {
+                    totalLess += lessCounts[ block ];
+                    totalEqual += equalCounts[ block ];
+                }
+                size_t lessOffset = 0, equalOffset = totalLess, greaterOffset = totalLess + totalEqual;
+                for( size_t block = 0; block < numBlocks; ++block )
+                {
+                    size_t blockSize = std::min< size_t >( BOLT_BTBB_SELECT_BLOCK_SIZE,
+                                                           length - block * BOLT_BTBB_SELECT_BLOCK_SIZE );
+                    size_t less = lessCounts[ block ], equal = equalCounts[ block ];
+                    lessCounts[ block ] = lessOffset;
+                    equalCounts[ block ] = equalOffset;
+                    greaterOffsets[ block ] = greaterOffset;
+                    lessOffset += less;
+                    equalOffset += equal;
+                    greaterOffset += blockSize - less - equal;
+                }
+
+                scratch.resize( length );
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, numBlocks ),
+                    SelectScatter< RandomAccessIterator, T, StrictWeakOrdering >( rangeFirst, length, pivot, comp,
+                        &lessCounts[ 0 ], &equalCounts[ 0 ], &greaterOffsets[ 0 ], &scratch[ 0 ] ) );
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, length ),
+                    SelectCopyBack< RandomAccessIterator, T >( &scratch[ 0 ], rangeFirst ) );
+
+                //  Continue only on the partition that holds the requested position
+                if( target < lo + totalLess )
+                    hi = lo + totalLess;
+                else if( target < lo + totalLess + totalEqual )
+                    return;
+                else
+                    lo = lo + totalLess + totalEqual;
+            }
+
+            std::nth_element( first + lo, nth, first + hi, comp );
+        }
+
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void partial_sort(RandomAccessIterator first,
+            RandomAccessIterator middle,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp)
+        {
+            if( middle == first )
+                return;
+
+            bolt::btbb::nth_element( first, middle - 1, last, comp );
+
+            tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
+            tbb::parallel_sort( first, middle - 1, comp );
+        }
+
+        template<typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+        OutputIterator top_k(InputIterator first,
+            InputIterator last,
+            size_t k,
+            OutputIterator result,
+            StrictWeakOrdering comp)
+        {
+            typedef typename std::iterator_traits< InputIterator >::value_type T;
+
+            std::vector< T > selection( first, last );
+            k = std::min< size_t >( k, selection.size( ) );
+            if( k == 0 )
+                return result;
+
+            bolt::btbb::partial_sort( selection.begin( ), selection.begin( ) + k, selection.end( ), comp );
+            return std::copy( selection.begin( ), selection.begin( ) + k, result );
+        }
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2, typename StrictWeakOrdering>
+        std::pair<OutputIterator1, OutputIterator2>
+        top_k_by_key(InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            size_t k,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakOrdering comp)
+        {
+            typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+            typedef typename std::iterator_traits< InputIterator2 >::value_type vType;
+            typedef SelectKeyValue< kType, vType > KeyValue;
+
+            size_t numElements = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+            k = std::min< size_t >( k, numElements );
+            if( k == 0 )
+                return std::make_pair( keys_result, values_result );
+
+            //  Zip the keys and values so the selection moves both together
+            std::vector< KeyValue > selection( numElements );
+            for( size_t i = 0; i < numElements; ++i )
+            {
+                selection[ i ].key = *( keys_first + i );
+                selection[ i ].value = *( values_first + i );
+            }
+
+            bolt::btbb::partial_sort( selection.begin( ), selection.begin( ) + k, selection.end( ),
+                                      SelectKeyValueComp< kType, vType, StrictWeakOrdering >( comp ) );
+
+            for( size_t i = 0; i < k; ++i )
+            {
+                *keys_result++ = selection[ i ].key;
+                *values_result++ = selection[ i ].value;
+            }
+            return std::make_pair( keys_result, values_result );
+        }
+
+    } //btbb
+} // bolt
+
+#endif //BOLT_BTBB_PARTIAL_SORT_INL
@@ -0,0 +1,56 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_PARTITION_INL )
+#define BOLT_BTBB_PARTITION_INL
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace bolt {
+    namespace btbb {
+
+        //  The input is copied aside; one pass of the copy_if scan writes the kept elements straight back to the front
+        //  of [first, last) and the rejected ones to a scratch buffer, which is then copied behind the kept ones
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator stable_partition(ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred)
+        {
+            typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+            std::vector< iType > input( first, last );
+            std::vector< iType > rejected( input.size( ) );
+            size_t numSelected = copy_if_scan( input.begin( ), input.end( ), first, rejected.begin( ), pred, true,
+                                               true );
+            std::copy( rejected.begin( ), rejected.begin( ) + ( input.size( ) - numSelected ), first + numSelected );
+            return first + numSelected;
+        }
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator partition(ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred)
+        {
+            return bolt::btbb::stable_partition( first, last, pred );
+        }
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
@@ -23,74 +23,36 @@
 #define BOLT_BTBB_SCAN_INL
 #pragma once
 
+#include <functional>
 
+#include "bolt/btbb/detail/blocked_scan.inl"
 
 namespace bolt {
 namespace   btbb {
 
-      template <typename InputIterator, typename OutputIterator, typename BinaryFunction,typename T>
-      struct Scan_tbb{
-          T sum;
-          T start;
-          InputIterator& x;
-          OutputIterator& y;
-          BinaryFunction scan_op;
-          bool inclusive, flag;
-          public:
-          Scan_tbb() : sum(0) {}
-          Scan_tbb( InputIterator&  _x,
-                    OutputIterator& _y,
-                    const BinaryFunction &_opr,
-                    const bool &_incl ,const T &init) : x(_x), y(_y), scan_op(_opr),inclusive(_incl),start(init),flag(TRUE){}
-          T get_sum() const {return sum;}
-          template<typename Tag>
-          void operator()( const tbb::blocked_range<int>& r, Tag ) {
-             T temp = sum, temp1;
-             for(int i=r.begin(); i<r.end(); ++i ) {
-                 if(Tag::is_final_scan()){
-                     if(!inclusive){
-                        if(i==0 ) {
-                            temp1 = *(x+i);
-                            *(y+i) = start;
-                            temp = scan_op(start, temp1);
-                         }
-                         else{
-                           temp1 = *(x+i);
-                           *(y+i) = temp;
-                            temp = scan_op(temp, temp1);
-                         }
-                         continue;
-                     }
-                     else if(i == 0){
-                        temp = *(x+i);
-                     }
-                     else{
-                        temp = scan_op(temp, *(x+i));
-                     }
-                     *(y+i) = temp;
-                  }
-                  else{
-                     if(flag){
-                       temp = *(x+i);
-                       flag = FALSE;
-                     }
-                     else
-                        temp = scan_op(temp, *(x+i));
-                  }
-             }
-             sum = temp;
-          }
-          Scan_tbb( Scan_tbb& b, tbb::split):y(b.y),x(b.x),inclusive(b.inclusive),start(b.start),flag(TRUE){
-          }
-          void reverse_join( Scan_tbb& a ) {
-               sum = scan_op(a.sum, sum);
-          }
-          void assign( Scan_tbb& b ) {
-             sum = b.sum;
-          }
-       };
+    namespace detail {
 
+      template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+      OutputIterator scan( InputIterator first, InputIterator last, OutputIterator result, T& carry,
+                           const BinaryFunction& binary_op, bool inclusive, bool hasCarry )
+      {
+               typedef typename std::iterator_traits< InputIterator >::value_type iType;
+               typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+               size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+
+               ScanCarry< oType > start;
+               if( hasCarry )
+                   start = ScanCarry< oType >( static_cast< oType >( carry ) );
+               ScanBlock_tbb< InputIterator, OutputIterator, ScanIdentity_tbb< oType >, BinaryFunction, oType >
+                   body( first, result, ScanIdentity_tbb< oType >( ), binary_op, inclusive, start );
+
+               ScanCarry< oType > end = blockedScan( body, numElements, sizeof( iType ) + sizeof( oType ) );
+               if( end.hasValue )
+                   carry = end.value;
+               return result + numElements;
+      }
 
+    }
 
 
 template< typename InputIterator, typename OutputIterator >
@@ -100,15 +62,8 @@ inclusive_scan(
     InputIterator last,
     OutputIterator result)
     {
-                unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
-                unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
-               typedef typename std::iterator_traits< InputIterator >::value_type iType;
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-               Scan_tbb<InputIterator, OutputIterator, BinaryFunction, iType> tbb_scan((InputIterator &)first,(OutputIterator &)
-                                                                         result,plus< iType >( ),true,iType());
-               tbb::parallel_scan( tbb::blocked_range<int>(  0, static_cast< int >( std::distance( first, last ))), tbb_scan, tbb::auto_partitioner());
-               return result + numElements;
-
+               typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+               return bolt::btbb::inclusive_scan( first, last, result, std::plus< oType >( ) );
     }
 
 
@@ -121,13 +76,9 @@ inclusive_scan(
     OutputIterator result,
     BinaryFunction binary_op)
     {
-                unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
-               typedef typename std::iterator_traits< InputIterator >::value_type iType;
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-               Scan_tbb<InputIterator, OutputIterator, BinaryFunction, iType> tbb_scan((InputIterator &)first,(OutputIterator &)
-                                                                         result,binary_op,true,iType());
-               tbb::parallel_scan( tbb::blocked_range<int>(  0, static_cast< int >( std::distance( first, last ))), tbb_scan, tbb::auto_partitioner());
-               return result + numElements;
+               typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+               oType carry = oType( );
+               return detail::scan( first, last, result, carry, binary_op, true, false );
     }
 
 
@@ -137,13 +88,8 @@ template< typename InputIterator, typename OutputIterator >
 OutputIterator
     exclusive_scan( InputIterator first, InputIterator last, OutputIterator result )
     {
-               unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
-               typedef typename std::iterator_traits< InputIterator >::value_type iType;
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-               Scan_tbb<InputIterator, OutputIterator, BinaryFunction, iType> tbb_scan((InputIterator &)first,(OutputIterator &)
-                                                                         result,plus< iType >( ),false,iType());
-               tbb::parallel_scan( tbb::blocked_range<int>(  0, static_cast< int >( std::distance( first, last ))), tbb_scan, tbb::auto_partitioner());
-               return result + numElements;
+               typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+               return bolt::btbb::exclusive_scan( first, last, result, oType( ), std::plus< oType >( ) );
     }
 
 
@@ -152,13 +98,8 @@ template< typename InputIterator, typename OutputIterator, typename T >
 OutputIterator
     exclusive_scan( InputIterator first, InputIterator last, OutputIterator result, T init )
     {
-               unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
-               typedef typename std::iterator_traits< InputIterator >::value_type iType;
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-               Scan_tbb<InputIterator, OutputIterator, BinaryFunction, iType> tbb_scan((InputIterator &)first,(OutputIterator &)
-                                                                         result,plus< iType >( ),false,init);
-               tbb::parallel_scan( tbb::blocked_range<int>(  0, static_cast< int >( std::distance( first, last ))), tbb_scan, tbb::auto_partitioner());
-               return result + numElements;
+               typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+               return bolt::btbb::exclusive_scan( first, last, result, init, std::plus< oType >( ) );
     }
 
 
@@ -166,14 +107,25 @@ template< typename InputIterator, typename OutputIterator, typename T, typename
 OutputIterator
     exclusive_scan( InputIterator first, InputIterator last, OutputIterator result, T init, BinaryFunction binary_op)
     {
+               return detail::scan( first, last, result, init, binary_op, false, true );
+    }
 
-               unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
-               typedef typename std::iterator_traits< InputIterator >::value_type iType;
-               tbb::task_scheduler_init initialize(tbb::task_scheduler_init::automatic);
-               Scan_tbb<InputIterator, OutputIterator, BinaryFunction, iType> tbb_scan((InputIterator &)first,(OutputIterator &)
-                                                                         result,binary_op,false,init);
-               tbb::parallel_scan( tbb::blocked_range<int>(  0, static_cast< int >( std::distance( first, last ))), tbb_scan, tbb::auto_partitioner());
-               return result + numElements;
+
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator
+    inclusive_scan_with_carry( InputIterator first, InputIterator last, OutputIterator result, T& carry,
+    BinaryFunction binary_op)
+    {
+               return detail::scan( first, last, result, carry, binary_op, true, true );
+    }
+
+
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator
+    exclusive_scan_with_carry( InputIterator first, InputIterator last, OutputIterator result, T& carry,
+    BinaryFunction binary_op)
+    {
+               return detail::scan( first, last, result, carry, binary_op, false, true );
     }
 
     }
@@ -181,4 +133,4 @@ OutputIterator
 }
 
 
-#endif // BTBB_SCAN_INL
\ No newline at end of file
+#endif // BTBB_SCAN_INL
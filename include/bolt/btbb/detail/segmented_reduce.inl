@@ -0,0 +1,87 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_SEGMENTED_REDUCE_INL )
+#define BOLT_BTBB_SEGMENTED_REDUCE_INL
+#pragma once
+
+#include <iterator>
+
+namespace bolt {
+    namespace btbb {
+
+        namespace detail {
+
+            //  The segments are independent, so every task reduces whole segments in order and writes their results
+            template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename oType,
+                      typename BinaryFunction >
+            struct SegmentedReduce_tbb
+            {
+                InputIterator first;
+                OffsetIterator offsets;
+                OutputIterator result;
+                oType init;
+                BinaryFunction binary_op;
+
+                SegmentedReduce_tbb( InputIterator _first, OffsetIterator _offsets, OutputIterator _result,
+                    const oType& _init, const BinaryFunction& _binary_op ): first( _first ), offsets( _offsets ),
+                    result( _result ), init( _init ), binary_op( _binary_op ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r ) const
+                {
+                    for( size_t segment = r.begin( ); segment != r.end( ); ++segment )
+                    {
+                        oType acc = init;
+                        for( size_t i = static_cast< size_t >( offsets[ segment ] ),
+                             end = static_cast< size_t >( offsets[ segment + 1 ] ); i < end; ++i )
+                        {
+                            acc = binary_op( acc, first[ i ] );
+                        }
+                        result[ segment ] = acc;
+                    }
+                }
+            };
+
+        }
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_reduce(InputIterator first,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op)
+        {
+            typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+            size_t numOffsets = static_cast< size_t >( std::distance( offsets_first, offsets_last ) );
+            if( numOffsets < 2 )
+                return result;
+            size_t numSegments = numOffsets - 1;
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, numSegments ),
+                detail::SegmentedReduce_tbb< InputIterator, OffsetIterator, OutputIterator, oType, BinaryFunction >(
+                    first, offsets_first, result, static_cast< oType >( init ), binary_op ) );
+            return result + numSegments;
+        }
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
@@ -0,0 +1,88 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_SEGMENTED_SCAN_INL )
+#define BOLT_BTBB_SEGMENTED_SCAN_INL
+#pragma once
+
+#include <iterator>
+
+#include "bolt/btbb/detail/blocked_scan.inl"
+
+namespace bolt {
+    namespace btbb {
+
+        namespace detail {
+
+            //  A segment starts at the first element and at every element with a non-zero head flag
+            template< typename FlagIterator >
+            struct FlagHead_tbb
+            {
+                FlagIterator flags;
+
+                FlagHead_tbb( FlagIterator _flags ): flags( _flags ) {}
+
+                bool operator()( size_t i ) const
+                {
+                    return ( i == 0 ) || ( flags[ i ] != 0 );
+                }
+            };
+
+        }
+
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename BinaryFunction>
+        OutputIterator segmented_inclusive_scan(InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            BinaryFunction binary_op)
+        {
+            typedef typename std::iterator_traits< InputIterator >::value_type iType;
+            typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+
+            detail::SegmentedScanBlock_tbb< InputIterator, detail::FlagHead_tbb< FlagIterator >, OutputIterator,
+                BinaryFunction, oType > body( first, detail::FlagHead_tbb< FlagIterator >( flags ), result,
+                binary_op, true, oType( ) );
+            detail::blockedScan( body, numElements, sizeof( iType ) + sizeof( oType ) + sizeof( *flags ) );
+            return result + numElements;
+        }
+
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_exclusive_scan(InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op)
+        {
+            typedef typename std::iterator_traits< InputIterator >::value_type iType;
+            typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+            size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+
+            detail::SegmentedScanBlock_tbb< InputIterator, detail::FlagHead_tbb< FlagIterator >, OutputIterator,
+                BinaryFunction, oType > body( first, detail::FlagHead_tbb< FlagIterator >( flags ), result,
+                binary_op, false, static_cast< oType >( init ) );
+            detail::blockedScan( body, numElements, sizeof( iType ) + sizeof( oType ) + sizeof( *flags ) );
+            return result + numElements;
+        }
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#endif
@@ -0,0 +1,115 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_SORT_BY_KEY_INL )
+#define BOLT_BTBB_SORT_BY_KEY_INL
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+namespace bolt {
+    namespace btbb {
+
+        //  Record that carries a value along with its key through a sort
+        template< typename keyType, typename valueType >
+        struct SortByKeyPair
+        {
+            keyType   key;
+            valueType value;
+        };
+
+        template< typename keyType, typename valueType, typename StrictWeakOrdering >
+        struct SortByKeyPairComp
+        {
+            typedef SortByKeyPair< keyType, valueType > KeyValueType;
+            StrictWeakOrdering comp;
+
+            SortByKeyPairComp( StrictWeakOrdering _comp ): comp( _comp ) {}
+
+            bool operator()( const KeyValueType& lhs, const KeyValueType& rhs ) const
+            {
+                return comp( lhs.key, rhs.key );
+            }
+        };
+
+        /*For documentation on the parallel_for body see below link
+         *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_for_func.htm
+         *Zips the key and value ranges into the record array, or unzips them back, depending on the direction.
+        */
+        template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename KeyValueType >
+        struct SortByKeyZip
+        {
+            RandomAccessIterator1 keys;
+            RandomAccessIterator2 values;
+            KeyValueType* records;
+            bool unzip;
+
+            SortByKeyZip( RandomAccessIterator1 _keys, RandomAccessIterator2 _values, KeyValueType* _records,
+                          bool _unzip ): keys( _keys ), values( _values ), records( _records ), unzip( _unzip ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                for( size_t i = r.begin( ); i != r.end( ); ++i )
+                {
+                    if( unzip )
+                    {
+                        keys[ i ] = records[ i ].key;
+                        values[ i ] = records[ i ].value;
+                    }
+                    else
+                    {
+                        records[ i ].key = keys[ i ];
+                        records[ i ].value = values[ i ];
+                    }
+                }
+            }
+        };
+
+        template<typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering>
+        void sort_by_key(RandomAccessIterator1 keys_first,
+            RandomAccessIterator1 keys_last,
+            RandomAccessIterator2 values_first,
+            StrictWeakOrdering comp)
+        {
+            typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
+            typedef typename std::iterator_traits< RandomAccessIterator2 >::value_type valueType;
+            typedef SortByKeyPair< keyType, valueType > KeyValueType;
+
+            size_t length = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+            if( length < 2 )
+                return;
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+
+            std::vector< KeyValueType > records( length );
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, length ),
+                SortByKeyZip< RandomAccessIterator1, RandomAccessIterator2, KeyValueType >(
+                    keys_first, values_first, &records[ 0 ], false ) );
+
+            tbb::parallel_sort( records.begin( ), records.end( ),
+                SortByKeyPairComp< keyType, valueType, StrictWeakOrdering >( comp ) );
+
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, length ),
+                SortByKeyZip< RandomAccessIterator1, RandomAccessIterator2, KeyValueType >(
+                    keys_first, values_first, &records[ 0 ], true ) );
+        }
+
+    }
+}
+
+#endif
@@ -0,0 +1,204 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_STABLESORT_INL )
+#define BOLT_BTBB_STABLESORT_INL
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+//  Ranges at or below this size are handed to std::stable_sort; the block and chunk sizes have to be powers of two
+//  so that chunk boundaries line up with run boundaries
+#define BOLT_BTBB_STABLESORT_SERIAL_CUTOFF  (1<<14)
+#define BOLT_BTBB_STABLESORT_BLOCK_SIZE     (1<<12)
+#define BOLT_BTBB_STABLESORT_CHUNK_SIZE     (1<<14)
+
+namespace bolt {
+    namespace btbb {
+
+        /*For documentation on the parallel_for body see below link
+         *http://threadingbuildingblocks.org/docs/help/reference/algorithms/parallel_for_func.htm
+         *Each block is sorted on its own into a run of BOLT_BTBB_STABLESORT_BLOCK_SIZE elements.
+        */
+        template< typename RandomAccessIterator, typename StrictWeakOrdering >
+        struct StableSortBlock
+        {
+            RandomAccessIterator first;
+            size_t length;
+            StrictWeakOrdering comp;
+
+            StableSortBlock( RandomAccessIterator _first, size_t _length, StrictWeakOrdering _comp ):
+                first( _first ), length( _length ), comp( _comp ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                for( size_t block = r.begin( ); block != r.end( ); ++block )
+                {
+                    size_t begin = block * BOLT_BTBB_STABLESORT_BLOCK_SIZE;
+                    size_t end = std::min< size_t >( begin + BOLT_BTBB_STABLESORT_BLOCK_SIZE, length );
+                    std::stable_sort( first + begin, first + end, comp );
+                }
+            }
+        };
+
+        /*Merge path: the number of elements taken from run a when the first diagonal elements of the merged output
+         *have been written.  Ties go to a, which keeps the merge stable.
+        */
+        template< typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering >
+        size_t mergePathSplit( RandomAccessIterator1 a, size_t aLength, RandomAccessIterator2 b, size_t bLength,
+                               size_t diagonal, StrictWeakOrdering comp )
+        {
+            size_t low = ( diagonal > bLength ) ? diagonal - bLength : 0;
+            size_t high = std::min( diagonal, aLength );
+            while( low < high )
+            {
+                size_t mid = low + ( high - low ) / 2;
+                if( !comp( b[ diagonal - 1 - mid ], a[ mid ] ) )
+                    low = mid + 1;
+                else
+                    high = mid;
+            }
+            return low;
+        }
+
+        /*One merge pass: runs of width elements are merged pairwise from src into dst.  Each chunk of the output
+         *either lies inside one pair of runs or holds several whole pairs, and the merge path gives the part of both
+         *runs that feeds it.
+        */
+        template< typename SrcIterator, typename DstIterator, typename StrictWeakOrdering >
+        struct StableSortMerge
+        {
+            SrcIterator src;
+            DstIterator dst;
+            size_t length;
+            size_t width;
+            size_t chunk;
+            StrictWeakOrdering comp;
+
+            StableSortMerge( SrcIterator _src, DstIterator _dst, size_t _length, size_t _width, size_t _chunk,
+                             StrictWeakOrdering _comp ): src( _src ), dst( _dst ), length( _length ),
+                             width( _width ), chunk( _chunk ), comp( _comp ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                for( size_t c = r.begin( ); c != r.end( ); ++c )
+                {
+                    size_t chunkBegin = c * chunk;
+                    size_t chunkEnd = std::min( chunkBegin + chunk, length );
+                    size_t pos = chunkBegin;
+                    while( pos < chunkEnd )
+                    {
+                        size_t pairBegin = ( pos / ( 2 * width ) ) * ( 2 * width );
+                        size_t aEnd = std::min( pairBegin + width, length );
+                        size_t pairEnd = std::min( pairBegin + 2 * width, length );
+                        size_t aLength = aEnd - pairBegin;
+                        size_t bLength = pairEnd - aEnd;
+                        size_t outEnd = std::min( chunkEnd, pairEnd );
+
+                        SrcIterator a = src + pairBegin;
+                        SrcIterator b = src + aEnd;
+                        size_t aStart = mergePathSplit( a, aLength, b, bLength, pos - pairBegin, comp );
+                        size_t aStop = mergePathSplit( a, aLength, b, bLength, outEnd - pairBegin, comp );
+                        size_t bStart = pos - pairBegin - aStart;
+                        size_t bStop = outEnd - pairBegin - aStop;
+
+                        std::merge( a + aStart, a + aStop, b + bStart, b + bStop, dst + pos, comp );
+                        pos = outEnd;
+                    }
+                }
+            }
+        };
+
+        template< typename SrcIterator, typename DstIterator >
+        struct StableSortCopy
+        {
+            SrcIterator src;
+            DstIterator dst;
+
+            StableSortCopy( SrcIterator _src, DstIterator _dst ): src( _src ), dst( _dst ) {}
+
+            void operator()( const tbb::blocked_range< size_t >& r ) const
+            {
+                std::copy( src + r.begin( ), src + r.end( ), dst + r.begin( ) );
+            }
+        };
+
+        template< typename SrcIterator, typename DstIterator, typename StrictWeakOrdering >
+        void stableSortMergePass( SrcIterator src, DstIterator dst, size_t length, size_t width,
+                                  StrictWeakOrdering comp )
+        {
+            //  Both sizes are powers of two: a chunk either holds whole pairs of runs or evenly subdivides one pair
+            size_t chunk = BOLT_BTBB_STABLESORT_CHUNK_SIZE;
+            size_t numChunks = ( length + chunk - 1 ) / chunk;
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, numChunks ),
+                StableSortMerge< SrcIterator, DstIterator, StrictWeakOrdering >( src, dst, length, width, chunk,
+                                                                                  comp ) );
+        }
+
+        template<typename RandomAccessIterator>
+        void stable_sort(RandomAccessIterator first,
+            RandomAccessIterator last)
+        {
+            typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+            bolt::btbb::stable_sort( first, last, std::less< T >( ) );
+        }
+
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void stable_sort(RandomAccessIterator first,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp)
+        {
+            typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+
+            size_t length = static_cast< size_t >( std::distance( first, last ) );
+            if( length <= BOLT_BTBB_STABLESORT_SERIAL_CUTOFF )
+            {
+                std::stable_sort( first, last, comp );
+                return;
+            }
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+
+            size_t numBlocks = ( length + BOLT_BTBB_STABLESORT_BLOCK_SIZE - 1 ) / BOLT_BTBB_STABLESORT_BLOCK_SIZE;
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, numBlocks ),
+                StableSortBlock< RandomAccessIterator, StrictWeakOrdering >( first, length, comp ) );
+
+            //  Ping-pong between the input and the scratch buffer, one pass per doubling of the run width
+            std::vector< T > scratch( length );
+            bool inScratch = false;
+            for( size_t width = BOLT_BTBB_STABLESORT_BLOCK_SIZE; width < length; width *= 2 )
+            {
+                if( inScratch )
+                    stableSortMergePass( scratch.begin( ), first, length, width, comp );
+                else
+                    stableSortMergePass( first, scratch.begin( ), length, width, comp );
+                inScratch = !inScratch;
+            }
+
+            if( inScratch )
+                tbb::parallel_for( tbb::blocked_range< size_t >( 0, length, BOLT_BTBB_STABLESORT_CHUNK_SIZE ),
+                    StableSortCopy< typename std::vector< T >::iterator, RandomAccessIterator >(
+                        scratch.begin( ), first ) );
+        }
+
+    }
+}
+
+#endif
@@ -0,0 +1,60 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_STABLESORT_BY_KEY_INL )
+#define BOLT_BTBB_STABLESORT_BY_KEY_INL
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+namespace bolt {
+    namespace btbb {
+
+        template<typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering>
+        void stable_sort_by_key(RandomAccessIterator1 keys_first,
+            RandomAccessIterator1 keys_last,
+            RandomAccessIterator2 values_first,
+            StrictWeakOrdering comp)
+        {
+            typedef typename std::iterator_traits< RandomAccessIterator1 >::value_type keyType;
+            typedef typename std::iterator_traits< RandomAccessIterator2 >::value_type valueType;
+            typedef SortByKeyPair< keyType, valueType > KeyValueType;
+
+            size_t length = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+            if( length < 2 )
+                return;
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+
+            std::vector< KeyValueType > records( length );
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, length ),
+                SortByKeyZip< RandomAccessIterator1, RandomAccessIterator2, KeyValueType >(
+                    keys_first, values_first, &records[ 0 ], false ) );
+
+            bolt::btbb::stable_sort( records.begin( ), records.end( ),
+                SortByKeyPairComp< keyType, valueType, StrictWeakOrdering >( comp ) );
+
+            tbb::parallel_for( tbb::blocked_range< size_t >( 0, length ),
+                SortByKeyZip< RandomAccessIterator1, RandomAccessIterator2, KeyValueType >(
+                    keys_first, values_first, &records[ 0 ], true ) );
+        }
+
+    }
+}
+
+#endif
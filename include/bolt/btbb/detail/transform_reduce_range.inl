@@ -0,0 +1,109 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_TRANSFORM_REDUCE_RANGE_INL )
+#define BOLT_BTBB_TRANSFORM_REDUCE_RANGE_INL
+#pragma once
+
+namespace bolt {
+    namespace btbb {
+        namespace detail {
+
+            /*  Body of the imperative form of tbb::parallel_reduce over the rows of the window.  The body made from
+             *  init starts with it; the split bodies start empty and take the first element of their block, so
+             *  reduce_op needs no identity.
+             */
+            template< typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction >
+            struct Transform_Reduce_Range {
+                InputIterator first;
+                const int* origin;
+                const int* extent;
+                const int* stride;
+                UnaryFunction transform_op;
+                BinaryFunction reduce_op;
+                T value;
+                bool empty;
+
+                Transform_Reduce_Range( const InputIterator& _first, const int* _origin, const int* _extent,
+                    const int* _stride, const UnaryFunction& _transform_op, const BinaryFunction& _reduce_op,
+                    const T& init ) : first( _first ), origin( _origin ), extent( _extent ), stride( _stride ),
+                    transform_op( _transform_op ), reduce_op( _reduce_op ), value( init ), empty( false ) {}
+
+                Transform_Reduce_Range( Transform_Reduce_Range& s, tbb::split ) : first( s.first ),
+                    origin( s.origin ), extent( s.extent ), stride( s.stride ), transform_op( s.transform_op ),
+                    reduce_op( s.reduce_op ), value( s.value ), empty( true ) {}
+
+                void operator()( const tbb::blocked_range< size_t >& r )
+                {
+                    T acc = value;
+                    for( size_t row = r.begin( ); row != r.end( ); ++row )
+                    {
+                        int z = static_cast< int >( row / extent[ 1 ] );
+                        int y = static_cast< int >( row % extent[ 1 ] );
+                        InputIterator rowFirst = first + ( ( origin[ 0 ] + z ) * stride[ 0 ] +
+                            ( origin[ 1 ] + y ) * stride[ 1 ] + origin[ 2 ] * stride[ 2 ] );
+
+                        int x = 0;
+                        if( empty )
+                        {
+                            acc = static_cast< T >( transform_op( rowFirst[ 0 ] ) );
+                            empty = false;
+                            x = 1;
+                        }
+                        for( ; x < extent[ 2 ]; ++x )
+                            acc = static_cast< T >( reduce_op( acc, transform_op( rowFirst[ x * stride[ 2 ] ] ) ) );
+                    }
+                    value = acc;
+                }
+
+                //  rhs covers the rows right after the ones of this body
+                void join( Transform_Reduce_Range& rhs )
+                {
+                    if( rhs.empty )
+                        return;
+                    value = empty ? rhs.value : static_cast< T >( reduce_op( value, rhs.value ) );
+                    empty = false;
+                }
+            };
+
+        }
+
+        template< typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction >
+        T transform_reduce_range( InputIterator first,
+            const int ( &origin )[ 3 ],
+            const int ( &extent )[ 3 ],
+            const int ( &stride )[ 3 ],
+            UnaryFunction transform_op,
+            T init,
+            BinaryFunction reduce_op )
+        {
+            if( extent[ 0 ] <= 0 || extent[ 1 ] <= 0 || extent[ 2 ] <= 0 )
+                return init;
+
+            size_t numRows = static_cast< size_t >( extent[ 0 ] ) * static_cast< size_t >( extent[ 1 ] );
+
+            tbb::task_scheduler_init initialize( tbb::task_scheduler_init::automatic );
+            detail::Transform_Reduce_Range< InputIterator, UnaryFunction, T, BinaryFunction >
+                body( first, origin, extent, stride, transform_op, reduce_op, init );
+            tbb::parallel_reduce( tbb::blocked_range< size_t >( 0, numRows ), body );
+            return body.value;
+        }
+
+    }
+}
+
+#endif // BOLT_BTBB_TRANSFORM_REDUCE_RANGE_INL
@@ -0,0 +1,65 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_TRANSFORM_SCAN_INL )
+#define BOLT_BTBB_TRANSFORM_SCAN_INL
+#pragma once
+
+#include "bolt/btbb/detail/blocked_scan.inl"
+
+namespace bolt {
+namespace   btbb {
+
+template< typename InputIterator, typename OutputIterator, typename UnaryFunction, typename BinaryFunction >
+OutputIterator
+    transform_inclusive_scan( InputIterator first, InputIterator last, OutputIterator result,
+    UnaryFunction unary_op, BinaryFunction binary_op )
+    {
+               typedef typename std::iterator_traits< InputIterator >::value_type iType;
+               typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+               size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+
+               detail::ScanBlock_tbb< InputIterator, OutputIterator, UnaryFunction, BinaryFunction, oType >
+                   body( first, result, unary_op, binary_op, true, detail::ScanCarry< oType >( ) );
+               detail::blockedScan( body, numElements, sizeof( iType ) + sizeof( oType ) );
+               return result + numElements;
+    }
+
+
+template< typename InputIterator, typename OutputIterator, typename UnaryFunction, typename T,
+          typename BinaryFunction >
+OutputIterator
+    transform_exclusive_scan( InputIterator first, InputIterator last, OutputIterator result,
+    UnaryFunction unary_op, T init, BinaryFunction binary_op )
+    {
+               typedef typename std::iterator_traits< InputIterator >::value_type iType;
+               typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+               size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+
+               detail::ScanBlock_tbb< InputIterator, OutputIterator, UnaryFunction, BinaryFunction, oType >
+                   body( first, result, unary_op, binary_op, false,
+                         detail::ScanCarry< oType >( static_cast< oType >( init ) ) );
+               detail::blockedScan( body, numElements, sizeof( iType ) + sizeof( oType ) );
+               return result + numElements;
+    }
+
+    }
+
+}
+
+
+#endif // BTBB_TRANSFORM_SCAN_INL
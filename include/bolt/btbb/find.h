@@ -0,0 +1,100 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_FIND_H )
+#define BOLT_BTBB_FIND_H
+#pragma once
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/partitioner.h"
+#include "tbb/task.h"
+#include "tbb/atomic.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/find.h
+    \brief Searches and predicate tests that stop as soon as the answer is known.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup searching
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-find
+        *   \ingroup searching
+        *   \{
+        *   \details The input is scanned in chunks.  A task skips the chunks that come after a match that is
+        *   already known, and the tests that only need some match (any_of, all_of, none_of) cancel the whole
+        *   parallel loop at the first one.
+        */
+
+        /*! \brief \p find returns the first position in [first, last) whose element equals \p value, or \p last. */
+        template<typename InputIterator, typename EqualityComparable>
+        InputIterator find(InputIterator first,
+            InputIterator last,
+            const EqualityComparable& value);
+
+        /*! \brief \p find_if returns the first position in [first, last) for which \p predicate is true, or
+        * \p last.
+        */
+        template<typename InputIterator, typename Predicate>
+        InputIterator find_if(InputIterator first,
+            InputIterator last,
+            Predicate predicate);
+
+        /*! \brief \p find_if_not returns the first position in [first, last) for which \p predicate is false, or
+        * \p last.
+        */
+        template<typename InputIterator, typename Predicate>
+        InputIterator find_if_not(InputIterator first,
+            InputIterator last,
+            Predicate predicate);
+
+        /*! \brief \p any_of returns true if \p predicate is true for some element of [first, last). */
+        template<typename InputIterator, typename Predicate>
+        bool any_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate);
+
+        /*! \brief \p all_of returns true if \p predicate is true for every element of [first, last), and for an
+        * empty range.
+        */
+        template<typename InputIterator, typename Predicate>
+        bool all_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate);
+
+        /*! \brief \p none_of returns true if \p predicate is false for every element of [first, last). */
+        template<typename InputIterator, typename Predicate>
+        bool none_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/find.inl>
+
+#endif
@@ -0,0 +1,86 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#pragma once
+#if !defined( BOLT_BTBB_HISTOGRAM_H )
+#define BOLT_BTBB_HISTOGRAM_H
+
+#include <vector>
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/histogram.h
+    \brief Histogram of a range on the TBB threads.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-histogram
+        *   \ingroup reductions
+        *   \{
+        */
+
+        /*! \brief \p histogram counts how many elements of [first, last) fall in each of \p numBins bins, and writes
+         *  the counts to [bins_first, bins_first + numBins).
+         *  \details Every thread counts into its own copy of the bins, so the threads never write to the same
+         *  counter; the copies are added together once the range has been read.
+         *
+         * \param first The beginning of the input sequence.
+         * \param last The end of the input sequence.
+         * \param bins_first The beginning of the output sequence of counts.
+         * \param numBins The number of bins.
+         * \param bin A function object that returns the bin of an element as an unsigned int.  Elements whose bin
+         * is numBins or more are not counted.
+         *
+         *  \code
+         *  #include <bolt/btbb/histogram.h>
+         *
+         *  struct Decade { unsigned int operator( )( int x ) const { return x / 10; } };
+         *
+         *  int a[ 6 ] = { 3, 14, 15, 9, 26, 53 };
+         *  unsigned int counts[ 3 ];
+         *
+         *  bolt::btbb::histogram( a, a + 6, counts, 3, Decade( ) );
+         *  // counts are { 2, 2, 1 }
+         *  \endcode
+         */
+        template< typename InputIterator, typename OutputIterator, typename BinFunctor >
+        void histogram( InputIterator first,
+            InputIterator last,
+            OutputIterator bins_first,
+            size_t numBins,
+            BinFunctor bin );
+
+        /*!   \}  */
+
+    };
+};
+
+#include <bolt/btbb/detail/histogram.inl>
+
+#endif
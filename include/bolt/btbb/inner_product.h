@@ -0,0 +1,86 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#pragma once
+#if !defined( BOLT_BTBB_INNER_PRODUCT_H )
+#define BOLT_BTBB_INNER_PRODUCT_H
+
+#include "tbb/parallel_reduce.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/inner_product.h
+    \brief Inner product of two ranges on the TBB threads.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-inner_product
+        *   \ingroup reductions
+        *   \{
+        */
+
+        /*! \brief \p inner_product combines init with f2( first1[ i ], first2[ i ] ) for every i in
+         *  [0, last1 - first1), using f1.
+         *  \details Every TBB task combines the products of its block as it computes them, so the products are never
+         *  stored.  Only the task that starts the range holds init, and f1 must be associative.
+         *
+         * \param first1 The beginning of the first input sequence.
+         * \param last1 The end of the first input sequence.
+         * \param first2 The beginning of the second input sequence.
+         * \param init The initial value for the accumulator.
+         * \param f1 The binary operation used to combine the products.
+         * \param f2 The binary operation applied to the pairs of elements.
+         * \return The result of the inner product.
+         *
+         *  \code
+         *  #include <bolt/btbb/inner_product.h>
+         *
+         *  int a[ 4 ] = { 1, 2, 3, 4 };
+         *  int b[ 4 ] = { 4, 3, 2, 1 };
+         *
+         *  int dot = bolt::btbb::inner_product( a, a + 4, b, 0, std::plus< int >( ), std::multiplies< int >( ) );
+         *  // dot is 20
+         *  \endcode
+         *
+         *  \sa http://www.sgi.com/tech/stl/inner_product.html
+         */
+        template< typename InputIterator1, typename InputIterator2, typename T, typename BinaryFunction1,
+                  typename BinaryFunction2 >
+        T inner_product( InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            T init,
+            BinaryFunction1 f1,
+            BinaryFunction2 f2 );
+
+        /*!   \}  */
+
+    };
+};
+
+#include <bolt/btbb/detail/inner_product.inl>
+
+#endif
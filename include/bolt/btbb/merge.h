@@ -0,0 +1,108 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_MERGE_H )
+#define BOLT_BTBB_MERGE_H
+#pragma once
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+#include <utility>
+
+/*! \file bolt/btbb/merge.h
+    \brief Merges two sorted ranges into one sorted range.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup sorting
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-merge
+        *   \ingroup sorting
+        *   \{
+        */
+
+        /*! \brief \p merge combines the sorted ranges [first1, last1) and [first2, last2) into one sorted range
+        * beginning at \p result.  The merge is stable: of two equivalent elements, the one from the first range
+        * comes first.
+        *
+        * \details The output is cut into equal chunks, and the merge path of each chunk boundary is found with a
+        * binary search over both inputs, so every task merges the same number of elements however the inputs are
+        * skewed.
+        *
+        * \param first1 The beginning of the first input sequence.
+        * \param last1  The end of the first input sequence.
+        * \param first2 The beginning of the second input sequence.
+        * \param last2  The end of the second input sequence.
+        * \param result The beginning of the output sequence.
+        * \param comp   The comparison operation both inputs are sorted by.
+        * \return The end of the output sequence.
+        */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator merge(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakOrdering comp);
+
+        /*! \brief \p merge_by_key merges two sorted key ranges like \p merge, and moves the value of every key along
+        * with it.
+        *
+        * \param keys_first1   The beginning of the first key sequence.
+        * \param keys_last1    The end of the first key sequence.
+        * \param keys_first2   The beginning of the second key sequence.
+        * \param keys_last2    The end of the second key sequence.
+        * \param values_first1 The beginning of the values of the first key sequence.
+        * \param values_first2 The beginning of the values of the second key sequence.
+        * \param keys_result   The beginning of the key output sequence.
+        * \param values_result The beginning of the value output sequence.
+        * \param comp          The comparison operation applied to the keys.
+        * \return A std::pair holding the ends of the key and value output sequences.
+        */
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2,
+                 typename StrictWeakOrdering>
+        std::pair<OutputIterator1, OutputIterator2>
+        merge_by_key(InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakOrdering comp);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/merge.inl>
+
+#endif
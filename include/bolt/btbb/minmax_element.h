@@ -0,0 +1,112 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#pragma once
+#if !defined( BOLT_BTBB_MINMAX_ELEMENT_H )
+#define BOLT_BTBB_MINMAX_ELEMENT_H
+
+#include <utility>
+
+#include "tbb/parallel_reduce.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/minmax_element.h
+    \brief Position-returning reductions on the TBB threads.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-minmax_element
+        *   \ingroup reductions
+        *   \{
+        */
+
+        /*! \brief \p min_element returns the position of the first element of [first, last) that no other element
+         *  orders before, like std::min_element.
+         *  \param first The beginning of the input sequence.
+         *  \param last The end of the input sequence.
+         *  \param comp The strict weak ordering of the elements.
+         *  \return The position of the first smallest element, or last when the range is empty.
+         */
+        template< typename ForwardIterator, typename StrictWeakOrdering >
+        ForwardIterator min_element( ForwardIterator first,
+            ForwardIterator last,
+            StrictWeakOrdering comp );
+
+        /*! \brief \p minmax_element returns the positions of the first smallest and of the last largest element of
+         *  [first, last) in a single pass, like std::minmax_element.
+         *  \param first The beginning of the input sequence.
+         *  \param last The end of the input sequence.
+         *  \param comp The strict weak ordering of the elements.
+         *  \return The pair of positions, or ( last, last ) when the range is empty.
+         *
+         *  \code
+         *  #include <bolt/btbb/minmax_element.h>
+         *
+         *  int a[ 8 ] = { 4, 1, 7, 1, 7, 3, 2, 5 };
+         *
+         *  std::pair< int*, int* > bounds = bolt::btbb::minmax_element( a, a + 8, std::less< int >( ) );
+         *  // bounds.first is a + 1, bounds.second is a + 4
+         *  \endcode
+         */
+        template< typename ForwardIterator, typename StrictWeakOrdering >
+        std::pair< ForwardIterator, ForwardIterator > minmax_element( ForwardIterator first,
+            ForwardIterator last,
+            StrictWeakOrdering comp );
+
+        /*! \brief \p argmin_by_key writes, for every run of consecutive equal keys, the key and the position in
+         *  the run's range of the first value that no other value of the run orders before.
+         *  \details The runs are split between the blocks of the range by their first element; every block counts
+         *  its runs, and after an exclusive scan of the counts writes them, reading past its end for the run it
+         *  leaves open.
+         *  \param keys_first The beginning of the key sequence.
+         *  \param keys_last The end of the key sequence.
+         *  \param values_first The beginning of the value sequence.
+         *  \param keys_output The beginning of the output key sequence.
+         *  \param indices_output The beginning of the output position sequence.
+         *  \param binary_pred The predicate that tells whether two consecutive keys are equal.
+         *  \param comp The strict weak ordering of the values.
+         *  \return The ends of the two output sequences.
+         */
+        template< typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                  typename OutputIterator2, typename BinaryPredicate, typename StrictWeakOrdering >
+        std::pair< OutputIterator1, OutputIterator2 > argmin_by_key( InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            BinaryPredicate binary_pred,
+            StrictWeakOrdering comp );
+
+        /*!   \}  */
+
+    };
+};
+
+#include <bolt/btbb/detail/minmax_element.inl>
+
+#endif
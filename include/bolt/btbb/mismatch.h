@@ -0,0 +1,70 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_MISMATCH_H )
+#define BOLT_BTBB_MISMATCH_H
+#pragma once
+
+#include <utility>
+
+#include "bolt/btbb/find.h"
+
+/*! \file bolt/btbb/mismatch.h
+    \brief Finds the first position where two sequences differ, stopping as soon as it is known.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup searching
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-mismatch
+        *   \ingroup searching
+        *   \{
+        */
+
+        /*! \brief \p mismatch returns the first positions i of [first1, last1) and of the sequence that starts at
+        * \p first2 for which \p predicate( first1[ i ], first2[ i ] ) is false, or last1 and its counterpart.
+        */
+        template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+        std::pair< InputIterator1, InputIterator2 > mismatch(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            BinaryPredicate predicate);
+
+        /*! \brief \p equal returns true if \p predicate( first1[ i ], first2[ i ] ) is true for every i in
+        * [0, last1 - first1).  It stops at the first pair that differs.
+        */
+        template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+        bool equal(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            BinaryPredicate predicate);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/mismatch.inl>
+
+#endif
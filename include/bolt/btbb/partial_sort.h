@@ -0,0 +1,141 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_PARTIAL_SORT_H )
+#define BOLT_BTBB_PARTIAL_SORT_H
+#pragma once
+
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_sort.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/partial_sort.h
+    \brief Selection algorithms (nth_element, partial_sort, top_k) that avoid sorting the complete range.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup sorting
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-selection
+        *   \ingroup sorting
+        *   \{
+        */
+
+        /*! \brief \p nth_element rearranges [first, last) so that the element at \p nth is the one that would be there
+        * if the range were sorted; no element in [first, nth) compares greater than it and no element in
+        * (nth, last) compares less than it.
+        *
+        * \details The selection is a parallel quickselect: every round picks a sampled pivot, counts and scatters the
+        * range in blocks with \p tbb::parallel_for, and then only continues on the partition that contains \p nth.
+        * Small ranges are finished with std::nth_element.
+        *
+        * \param first The first position in the sequence.
+        * \param nth   The position of the element to select.
+        * \param last  The last position in the sequence.
+        * \param comp  The comparison operation used to order the elements.
+        * \tparam RandomAccessIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html
+        * \tparam StrictWeakOrdering Is a model of http://www.sgi.com/tech/stl/StrictWeakOrdering.html
+        *
+        * \code
+        * #include <bolt/btbb/partial_sort.h>
+        *
+        * int a[8] = {2, 9, 3, 7, 5, 6, 3, 8};
+        *
+        * bolt::btbb::nth_element( a, a+3, a+8, std::less< int >( ) );
+        * // a[3] == 5
+        *  \endcode
+        */
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void nth_element(RandomAccessIterator first,
+            RandomAccessIterator nth,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp);
+
+        /*! \brief \p partial_sort sorts the smallest <tt>middle - first</tt> elements of [first, last) into
+        * [first, middle); the order of the remaining elements is unspecified.
+        *
+        * \details The range is first split with the parallel \p nth_element, and only [first, middle) is then sorted
+        * with \p tbb::parallel_sort.
+        *
+        * \param first  The first position in the sequence.
+        * \param middle One past the last position of the sorted head.
+        * \param last   The last position in the sequence.
+        * \param comp   The comparison operation used to order the elements.
+        */
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void partial_sort(RandomAccessIterator first,
+            RandomAccessIterator middle,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp);
+
+        /*! \brief \p top_k copies the first \p k elements of [first, last), in the order defined by \p comp, into
+        * [result, result + k). The input range is not modified.
+        *
+        * \param first  The first position in the input sequence.
+        * \param last   The last position in the input sequence.
+        * \param k      The number of elements to select; clamped to the length of the input.
+        * \param result The beginning of the output sequence.
+        * \param comp   The comparison operation; greater<>() selects the k largest elements.
+        * \return The end of the output sequence.
+        */
+        template<typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+        OutputIterator top_k(InputIterator first,
+            InputIterator last,
+            size_t k,
+            OutputIterator result,
+            StrictWeakOrdering comp);
+
+        /*! \brief \p top_k_by_key copies the first \p k keys of [keys_first, keys_last), in the order defined by
+        * \p comp, into \p keys_result, and the values associated with them into \p values_result.
+        *
+        * \param keys_first    The first position in the key sequence.
+        * \param keys_last     The last position in the key sequence.
+        * \param values_first  The first position in the value sequence.
+        * \param k             The number of elements to select; clamped to the length of the input.
+        * \param keys_result   The beginning of the key output sequence.
+        * \param values_result The beginning of the value output sequence.
+        * \param comp          The comparison operation applied to the keys.
+        * \return A std::pair holding the ends of the key and value output sequences.
+        */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2, typename StrictWeakOrdering>
+        std::pair<OutputIterator1, OutputIterator2>
+        top_k_by_key(InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            size_t k,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakOrdering comp);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/partial_sort.inl>
+
+#endif
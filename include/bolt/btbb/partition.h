@@ -0,0 +1,76 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_PARTITION_H )
+#define BOLT_BTBB_PARTITION_H
+#pragma once
+
+#include "bolt/btbb/copy_if.h"
+
+/*! \file bolt/btbb/partition.h
+    \brief Reorders a range so that the elements that satisfy a predicate come first.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reordering
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-partition
+        *   \ingroup reordering
+        *   \{
+        */
+
+        /*! \brief \p stable_partition moves the elements of [first, last) for which \p pred is true in front of the
+        * others; both groups keep their relative order.
+        *
+        * \param first The beginning of the sequence.
+        * \param last  The end of the sequence.
+        * \param pred  The unary predicate.
+        * \return The iterator to the first element for which \p pred is false.
+        */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator stable_partition(ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred);
+
+        /*! \brief \p partition moves the elements of [first, last) for which \p pred is true in front of the
+        * others.  It runs the stable_partition scan.
+        *
+        * \param first The beginning of the sequence.
+        * \param last  The end of the sequence.
+        * \param pred  The unary predicate.
+        * \return The iterator to the first element for which \p pred is false.
+        */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator partition(ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/partition.inl>
+
+#endif
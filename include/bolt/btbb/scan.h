@@ -23,7 +23,7 @@
 #define BOLT_BBTBB_SCAN_H
 #pragma once
 
-#include "tbb/parallel_scan.h"
+#include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 #include "tbb/task_scheduler_init.h"
 
@@ -205,6 +205,37 @@ OutputIterator
     exclusive_scan( InputIterator first, InputIterator last, OutputIterator result, T init, BinaryFunction binary_op);
 
 
+/*! \brief \p inclusive_scan_with_carry scans one batch of a stream, starting from \p carry.  On return \p carry
+ *   holds the last value of the scan, so that the next batch continues from it.
+ *
+ * \param first The first iterator in the input range to be scanned.
+ * \param last  The last iterator in the input range to be scanned.
+ * \param result  The first iterator in the output range.
+ * \param carry The running value before the batch on entry, and after the batch on return.
+ * \param binary_op A functor object specifying the operation between two elements in the input range.
+ * \return An iterator pointing at the end of the result range.
+ */
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator
+    inclusive_scan_with_carry( InputIterator first, InputIterator last, OutputIterator result, T& carry,
+    BinaryFunction binary_op);
+
+/*! \brief \p exclusive_scan_with_carry scans one batch of a stream, exclusive of the current value, starting from
+ *   \p carry.  On return \p carry holds the running value that includes the whole batch.
+ *
+ * \param first The first iterator in the input range to be scanned.
+ * \param last  The last iterator in the input range to be scanned.
+ * \param result  The first iterator in the output range.
+ * \param carry The running value before the batch on entry, and after the batch on return.
+ * \param binary_op A functor object specifying the operation between two elements in the input range.
+ * \return An iterator pointing at the end of the result range.
+ */
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator
+    exclusive_scan_with_carry( InputIterator first, InputIterator last, OutputIterator result, T& carry,
+    BinaryFunction binary_op);
+
+
 /*!   \}  */
 }// end of bolt::btbb namespace
 }// end of bolt namespace
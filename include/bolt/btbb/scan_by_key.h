@@ -19,7 +19,7 @@
 #define BOLT_BTBB_SCAN_BY_KEY_H
 #pragma once
 
-#include "tbb/parallel_scan.h"
+#include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 #include "tbb/task_scheduler_init.h"
 
@@ -0,0 +1,72 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_SEGMENTED_REDUCE_H )
+#define BOLT_BTBB_SEGMENTED_REDUCE_H
+#pragma once
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/segmented_reduce.h
+    \brief Reduces every segment of a sequence, where the segments are given by an offset array.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-segmented_reduce
+        *   \ingroup reductions
+        *   \{
+        */
+
+        /*! \brief \p segmented_reduce writes init combined with the elements of
+        * [first + offsets_first[ i ], first + offsets_first[ i + 1 ]) to result[ i ], for every segment i.
+        *
+        * \param first         The beginning of the input sequence.
+        * \param offsets_first The beginning of the offset array; it holds one offset more than there are segments.
+        * \param offsets_last  The end of the offset array.
+        * \param result        The beginning of the output sequence, one value per segment.
+        * \param init          The value every segment starts with; empty segments are reduced to it.
+        * \param binary_op     The associative operation the segments are reduced with.
+        * \return The end of the output sequence.
+        */
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_reduce(InputIterator first,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/segmented_reduce.inl>
+
+#endif
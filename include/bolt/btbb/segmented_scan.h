@@ -0,0 +1,89 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_SEGMENTED_SCAN_H )
+#define BOLT_BTBB_SEGMENTED_SCAN_H
+#pragma once
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/segmented_scan.h
+    \brief Scans every segment of a sequence, where the segments are marked by head flags.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup PrefixSums Prefix Sums
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-segmented_scan
+        *   \ingroup PrefixSums
+        *   \{
+        */
+
+        /*! \brief \p segmented_inclusive_scan computes an inclusive scan of every segment of [first, last).  A
+        * non-zero flag marks the first element of a segment; the first element of the sequence always starts one.
+        *
+        * \param first     The beginning of the input sequence.
+        * \param last      The end of the input sequence.
+        * \param flags     The beginning of the head flag sequence.
+        * \param result    The beginning of the output sequence.
+        * \param binary_op The associative operation the segments are scanned with.
+        * \return The end of the output sequence.
+        */
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename BinaryFunction>
+        OutputIterator segmented_inclusive_scan(InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            BinaryFunction binary_op);
+
+        /*! \brief \p segmented_exclusive_scan computes an exclusive scan of every segment of [first, last); the
+        * first output of every segment is \p init.
+        *
+        * \param first     The beginning of the input sequence.
+        * \param last      The end of the input sequence.
+        * \param flags     The beginning of the head flag sequence.
+        * \param result    The beginning of the output sequence.
+        * \param init      The value every segment starts with.
+        * \param binary_op The associative operation the segments are scanned with.
+        * \return The end of the output sequence.
+        */
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_exclusive_scan(InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/segmented_scan.inl>
+
+#endif
@@ -0,0 +1,84 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_SORT_BY_KEY_H )
+#define BOLT_BTBB_SORT_BY_KEY_H
+#pragma once
+
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_sort.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/sort_by_key.h
+    \brief Parallel sort of a key range and its associated values.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup sorting
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-sort_by_key
+        *   \ingroup sorting
+        *   \{
+        */
+
+        /*! \brief \p sort_by_key sorts [keys_first, keys_last) in the order defined by \p comp and moves the values
+        * in [values_first, values_first + (keys_last - keys_first)) along with their keys. The relative order of
+        * equivalent keys is not preserved; see bolt::btbb::stable_sort_by_key.
+        *
+        * \details Keys and values are zipped into one record array in parallel. The records are sorted with
+        * tbb::parallel_sort on the key alone and then unzipped in parallel.
+        *
+        * \param keys_first   The first position in the sequence of keys.
+        * \param keys_last    The last position in the sequence of keys.
+        * \param values_first The first position in the sequence of values.
+        * \param comp         The comparison operation used to compare two keys.
+        * \tparam RandomAccessIterator1 Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html
+        * \tparam RandomAccessIterator2 Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html
+        * \tparam StrictWeakOrdering Is a model of http://www.sgi.com/tech/stl/StrictWeakOrdering.html
+        *
+        * \code
+        * #include <bolt/btbb/sort_by_key.h>
+        *
+        * int keys[8]   = {2, 9, 3, 7, 5, 6, 3, 8};
+        * int values[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+        *
+        * bolt::btbb::sort_by_key( keys, keys+8, values, std::less< int >( ) );
+        *  \endcode
+        */
+        template<typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering>
+        void sort_by_key(RandomAccessIterator1 keys_first,
+            RandomAccessIterator1 keys_last,
+            RandomAccessIterator2 values_first,
+            StrictWeakOrdering comp);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/sort_by_key.inl>
+
+#endif
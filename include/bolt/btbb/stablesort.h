@@ -0,0 +1,93 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_STABLESORT_H )
+#define BOLT_BTBB_STABLESORT_H
+#pragma once
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/stablesort.h
+    \brief Parallel stable merge sort.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup sorting
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-stable_sort
+        *   \ingroup sorting
+        *   \{
+        */
+
+        /*! \brief \p stable_sort sorts the elements in [first, last) into ascending order and keeps the relative order
+        * of equivalent elements.
+        *
+        * \details The range is cut into fixed-size blocks that are sorted in parallel with std::stable_sort. The sorted
+        * runs are then merged pairwise, one pass per doubling of the run width. Every pass splits its output into
+        * equal chunks. The merge-path search finds where each chunk starts in the two input runs, so all chunks of a
+        * pass merge independently, even when only one pair of runs is left. The passes alternate between the input
+        * and one scratch buffer of the same size.
+        *
+        * \param first The first position in the sequence to be sorted.
+        * \param last  The last position in the sequence to be sorted.
+        * \tparam RandomAccessIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html
+        *
+        * \code
+        * #include <bolt/btbb/stablesort.h>
+        *
+        * int a[8] = {2, 9, 3, 7, 5, 6, 3, 8};
+        *
+        * bolt::btbb::stable_sort( a, a+8 );
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/stable_sort.html
+        */
+        template<typename RandomAccessIterator>
+        void stable_sort(RandomAccessIterator first,
+            RandomAccessIterator last);
+
+        /*! \brief \p stable_sort sorts the elements in [first, last) in the order defined by \p comp and keeps the
+        * relative order of equivalent elements.
+        *
+        * \param first The first position in the sequence to be sorted.
+        * \param last  The last position in the sequence to be sorted.
+        * \param comp  The comparison operation used to compare two values.
+        * \tparam RandomAccessIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html
+        * \tparam StrictWeakOrdering Is a model of http://www.sgi.com/tech/stl/StrictWeakOrdering.html
+        */
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void stable_sort(RandomAccessIterator first,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/stablesort.inl>
+
+#endif
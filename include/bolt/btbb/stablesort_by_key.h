@@ -0,0 +1,73 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_STABLESORT_BY_KEY_H )
+#define BOLT_BTBB_STABLESORT_BY_KEY_H
+#pragma once
+
+#include "bolt/btbb/stablesort.h"
+#include "bolt/btbb/sort_by_key.h"
+
+/*! \file bolt/btbb/stablesort_by_key.h
+    \brief Parallel stable merge sort of a key range and its associated values.
+*/
+
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup sorting
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-stable_sort_by_key
+        *   \ingroup sorting
+        *   \{
+        */
+
+        /*! \brief \p stable_sort_by_key sorts [keys_first, keys_last) in the order defined by \p comp, moves the
+        * values in [values_first, values_first + (keys_last - keys_first)) along with their keys, and keeps the
+        * relative order of equivalent keys.
+        *
+        * \details Keys and values are zipped into one record array in parallel. The records are sorted with
+        * bolt::btbb::stable_sort on the key alone and then unzipped in parallel.
+        *
+        * \param keys_first   The first position in the sequence of keys.
+        * \param keys_last    The last position in the sequence of keys.
+        * \param values_first The first position in the sequence of values.
+        * \param comp         The comparison operation used to compare two keys.
+        * \tparam RandomAccessIterator1 Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html
+        * \tparam RandomAccessIterator2 Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html
+        * \tparam StrictWeakOrdering Is a model of http://www.sgi.com/tech/stl/StrictWeakOrdering.html
+        */
+        template<typename RandomAccessIterator1, typename RandomAccessIterator2, typename StrictWeakOrdering>
+        void stable_sort_by_key(RandomAccessIterator1 keys_first,
+            RandomAccessIterator1 keys_last,
+            RandomAccessIterator2 values_first,
+            StrictWeakOrdering comp);
+
+        /*!   \}  */
+
+    }// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/stablesort_by_key.inl>
+
+#endif
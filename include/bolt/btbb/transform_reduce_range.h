@@ -0,0 +1,76 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#pragma once
+#if !defined( BOLT_BTBB_TRANSFORM_REDUCE_RANGE_H )
+#define BOLT_BTBB_TRANSFORM_REDUCE_RANGE_H
+
+#include "tbb/parallel_reduce.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/transform_reduce_range.h
+    \brief Transform and reduction of a 3D window of a strided array on the TBB threads.
+*/
+
+namespace bolt {
+    namespace btbb {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup TBB-transform_reduce_range
+        *   \ingroup reductions
+        *   \{
+        */
+
+        /*! \brief \p transform_reduce_range combines init with transform_op( first[ offset ] ) for every point of
+         *  the window, using reduce_op.  The offset of the point ( z, y, x ) of the window is
+         *  ( origin[ 0 ] + z ) * stride[ 0 ] + ( origin[ 1 ] + y ) * stride[ 1 ] + ( origin[ 2 ] + x ) * stride[ 2 ].
+         *  \details Every TBB task reduces whole rows of the window, so the innermost loop walks a row without any
+         *  index arithmetic besides the stride.  A 2D window has an extent of 1 in dimension 0.
+         *
+         * \param first The beginning of the strided array.
+         * \param origin The first point of the window, slowest varying dimension first.
+         * \param extent The size of the window in each dimension.
+         * \param stride The distance between consecutive elements of each dimension.
+         * \param transform_op The unary operation applied to every element of the window.
+         * \param init The initial value for the accumulator.
+         * \param reduce_op The binary operation used to combine the transformed elements.
+         * \return The result of the reduction.
+         */
+        template< typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction >
+        T transform_reduce_range( InputIterator first,
+            const int ( &origin )[ 3 ],
+            const int ( &extent )[ 3 ],
+            const int ( &stride )[ 3 ],
+            UnaryFunction transform_op,
+            T init,
+            BinaryFunction reduce_op );
+
+        /*!   \}  */
+
+    };
+};
+
+#include <bolt/btbb/detail/transform_reduce_range.inl>
+
+#endif
@@ -0,0 +1,96 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_BTBB_TRANSFORM_SCAN_H )
+#define BOLT_BTBB_TRANSFORM_SCAN_H
+#pragma once
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/task_scheduler_init.h"
+
+/*! \file bolt/btbb/transform_scan.h
+    \brief Transforms every element of a range and scans the transformed values, inclusive or exclusive
+*/
+
+namespace bolt
+{
+namespace btbb
+{
+
+/*! \addtogroup algorithms
+ */
+
+/*! \addtogroup PrefixSums Prefix Sums
+ *   \ingroup algorithms
+ */
+
+/*! \addtogroup TBB-transform_scan
+ *   \ingroup PrefixSums
+ *   \{
+ *
+ */
+
+/*! \brief \p transform_inclusive_scan applies \p unary_op to every element of the input range and writes the
+ *   running \p binary_op of the transformed values, inclusive of the current value.  The transformed values are
+ *   never stored: \p unary_op is applied on the fly when the blocks are reduced and again when they are scanned.
+ *
+ * \param first The first iterator in the input range to be scanned.
+ * \param last  The last iterator in the input range to be scanned.
+ * \param result  The first iterator in the output range.
+ * \param unary_op A functor object applied to every element of the input range.
+ * \param binary_op A functor object specifying the operation between two transformed elements.
+ * \return An iterator pointing at the end of the result range.
+ *
+ * \code
+ * #include "bolt/btbb/transform_scan.h"
+ *
+ * int a[ 4 ] = { 1, 2, 3, 4 };
+ *
+ * bolt::btbb::transform_inclusive_scan( a, a+4, a, bolt::cl::negate< int >( ), bolt::cl::plus< int >( ) );
+ * // a => { -1, -3, -6, -10 }
+ *  \endcode
+ */
+template< typename InputIterator, typename OutputIterator, typename UnaryFunction, typename BinaryFunction >
+OutputIterator
+    transform_inclusive_scan( InputIterator first, InputIterator last, OutputIterator result,
+    UnaryFunction unary_op, BinaryFunction binary_op );
+
+/*! \brief \p transform_exclusive_scan applies \p unary_op to every element of the input range and writes the
+ *   running \p binary_op of the transformed values, starting from \p init and exclusive of the current value.
+ *
+ * \param first The first iterator in the input range to be scanned.
+ * \param last  The last iterator in the input range to be scanned.
+ * \param result  The first iterator in the output range.
+ * \param unary_op A functor object applied to every element of the input range.
+ * \param init  The value written to the first position of the output range.
+ * \param binary_op A functor object specifying the operation between two transformed elements.
+ * \return An iterator pointing at the end of the result range.
+ */
+template< typename InputIterator, typename OutputIterator, typename UnaryFunction, typename T,
+          typename BinaryFunction >
+OutputIterator
+    transform_exclusive_scan( InputIterator first, InputIterator last, OutputIterator result,
+    UnaryFunction unary_op, T init, BinaryFunction binary_op );
+
+/*!   \}  */
+}// end of bolt::btbb namespace
+}// end of bolt namespace
+
+#include <bolt/btbb/detail/transform_scan.inl>
+
+#endif
@@ -0,0 +1,312 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_ARGMIN_BY_KEY_H )
+#define BOLT_CL_ARGMIN_BY_KEY_H
+#pragma once
+
+#include <bolt/cl/bolt.h>
+#include <bolt/cl/functional.h>
+#include <bolt/cl/device_vector.h>
+#include <bolt/cl/pair.h>
+
+#include <string>
+
+/*! \file bolt/cl/argmin_by_key.h
+    \brief Finds, for every run of equal keys, the position of the smallest or of the largest value of the run.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-argmin_by_key
+        *   \ingroup reductions
+        *   \{
+        *   \details A segmented reduction usually returns the reduced value of every run; \p argmin_by_key and
+        *   \p argmax_by_key return where that value is instead.  On the OpenCL path every value is tagged with its
+        *   position, and the (value, position) pairs go through the same single-pass reduction as
+        *   \p reduce_by_key, with an operator that keeps the smaller position when two values are equal.  The
+        *   OpenCL path orders int, unsigned int, float and double values with operator<.
+        */
+
+static const std::string argValueCode = BOLT_HOST_DEVICE_DEFINITION(
+template< typename T >
+struct arg_value
+{
+    T value;
+    int index;
+};
+
+template< typename T >
+struct arg_value_tag
+{
+    arg_value< T > operator( )( const T& value, const int& index ) const
+    {
+        arg_value< T > result;
+        result.value = value;
+        result.index = index;
+        return result;
+    }
+};
+
+template< typename T >
+struct arg_min_op
+{
+    arg_value< T > operator( )( const arg_value< T >& lhs, const arg_value< T >& rhs ) const
+    {
+        if( rhs.value < lhs.value )
+            return rhs;
+        if( lhs.value < rhs.value )
+            return lhs;
+        return ( rhs.index < lhs.index ) ? rhs : lhs;
+    }
+};
+
+template< typename T >
+struct arg_max_op
+{
+    arg_value< T > operator( )( const arg_value< T >& lhs, const arg_value< T >& rhs ) const
+    {
+        if( lhs.value < rhs.value )
+            return rhs;
+        if( rhs.value < lhs.value )
+            return lhs;
+        return ( rhs.index < lhs.index ) ? rhs : lhs;
+    }
+};
+
+template< typename T >
+struct arg_value_index
+{
+    int operator( )( const arg_value< T >& x ) const
+    {
+        return x.index;
+    }
+};
+);
+
+        /*! \brief \p argmin_by_key writes, for every run of consecutive equal keys, the key of the run and the
+        * position of the first smallest value of the run.  The positions count from \p keys_first.
+        *
+        * \param ctl            \b Optional Control structure to control command-queue, debug, tuning, etc.
+        *                       See bolt::cl::control.
+        * \param keys_first     The first element of the key sequence.
+        * \param keys_last      The last  element of the key sequence.
+        * \param values_first   The first element of the value sequence.
+        * \param keys_output    The first element of the key output sequence.
+        * \param indices_output The first element of the position output sequence.
+        * \param binary_pred    \b Optional The predicate that tells whether two consecutive keys are equal.  By
+        *                       default it is equal_to().
+        * \param user_code      A user-specified Optional string that is preppended to the generated OpenCL kernel.
+        *
+        * \tparam InputIterator1   is a model of Input Iterator.
+        * \tparam InputIterator2   is a model of Input Iterator, whose value type is int, unsigned int, float or
+        *                          double.
+        * \tparam OutputIterator1  is a model of Output Iterator.
+        * \tparam OutputIterator2  is a model of Output Iterator, whose value type is int.
+        *
+        * \return The ends of the two output sequences.
+        *
+        * \details Example:
+        * \code
+        * #include "bolt/cl/argmin_by_key.h"
+        *
+        * int keys[ 8 ] = { 0, 0, 0, 2, 2, 5, 5, 5 };
+        * float vals[ 8 ] = { 3.f, 1.f, 1.f, 4.f, 2.f, 9.f, 7.f, 8.f };
+        * int keys_out[ 8 ];
+        * int pos_out[ 8 ];
+        *
+        * bolt::cl::argmin_by_key( keys, keys + 8, vals, keys_out, pos_out );
+        * // keys_out => { 0, 2, 5 }
+        * // pos_out  => { 1, 4, 6 }
+        *  \endcode
+        */
+        template<
+            typename InputIterator1,
+            typename InputIterator2,
+            typename OutputIterator1,
+            typename OutputIterator2,
+            typename BinaryPredicate >
+            pair< OutputIterator1, OutputIterator2 >
+            argmin_by_key(
+            control &ctl,
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            BinaryPredicate binary_pred,
+            const std::string& user_code="" );
+
+        template<
+            typename InputIterator1,
+            typename InputIterator2,
+            typename OutputIterator1,
+            typename OutputIterator2,
+            typename BinaryPredicate >
+            pair< OutputIterator1, OutputIterator2 >
+            argmin_by_key(
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            BinaryPredicate binary_pred,
+            const std::string& user_code="" );
+
+        template<
+            typename InputIterator1,
+            typename InputIterator2,
+            typename OutputIterator1,
+            typename OutputIterator2 >
+            pair< OutputIterator1, OutputIterator2 >
+            argmin_by_key(
+            control &ctl,
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            const std::string& user_code="" );
+
+        template<
+            typename InputIterator1,
+            typename InputIterator2,
+            typename OutputIterator1,
+            typename OutputIterator2 >
+            pair< OutputIterator1, OutputIterator2 >
+            argmin_by_key(
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            const std::string& user_code="" );
+
+        /*! \brief \p argmax_by_key writes, for every run of consecutive equal keys, the key of the run and the
+        * position of the first largest value of the run.  The parameters are the same as for \p argmin_by_key.
+        */
+        template<
+            typename InputIterator1,
+            typename InputIterator2,
+            typename OutputIterator1,
+            typename OutputIterator2,
+            typename BinaryPredicate >
+            pair< OutputIterator1, OutputIterator2 >
+            argmax_by_key(
+            control &ctl,
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            BinaryPredicate binary_pred,
+            const std::string& user_code="" );
+
+        template<
+            typename InputIterator1,
+            typename InputIterator2,
+            typename OutputIterator1,
+            typename OutputIterator2,
+            typename BinaryPredicate >
+            pair< OutputIterator1, OutputIterator2 >
+            argmax_by_key(
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            BinaryPredicate binary_pred,
+            const std::string& user_code="" );
+
+        template<
+            typename InputIterator1,
+            typename InputIterator2,
+            typename OutputIterator1,
+            typename OutputIterator2 >
+            pair< OutputIterator1, OutputIterator2 >
+            argmax_by_key(
+            control &ctl,
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            const std::string& user_code="" );
+
+        template<
+            typename InputIterator1,
+            typename InputIterator2,
+            typename OutputIterator1,
+            typename OutputIterator2 >
+            pair< OutputIterator1, OutputIterator2 >
+            argmax_by_key(
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            OutputIterator1 keys_output,
+            OutputIterator2 indices_output,
+            const std::string& user_code="" );
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+BOLT_CREATE_TYPENAME( bolt::cl::arg_value< cl_int > );
+BOLT_CREATE_CLCODE( bolt::cl::arg_value< cl_int >, bolt::cl::argValueCode );
+BOLT_CREATE_TYPENAME( bolt::cl::arg_value_tag< cl_int > );
+BOLT_CREATE_CLCODE( bolt::cl::arg_value_tag< cl_int >, bolt::cl::argValueCode );
+BOLT_CREATE_TYPENAME( bolt::cl::arg_min_op< cl_int > );
+BOLT_CREATE_CLCODE( bolt::cl::arg_min_op< cl_int >, bolt::cl::argValueCode );
+BOLT_CREATE_TYPENAME( bolt::cl::arg_max_op< cl_int > );
+BOLT_CREATE_CLCODE( bolt::cl::arg_max_op< cl_int >, bolt::cl::argValueCode );
+BOLT_CREATE_TYPENAME( bolt::cl::arg_value_index< cl_int > );
+BOLT_CREATE_CLCODE( bolt::cl::arg_value_index< cl_int >, bolt::cl::argValueCode );
+
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_value, cl_int, cl_uint );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_value, cl_int, cl_float );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_value, cl_int, cl_double );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_value_tag, cl_int, cl_uint );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_value_tag, cl_int, cl_float );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_value_tag, cl_int, cl_double );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_min_op, cl_int, cl_uint );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_min_op, cl_int, cl_float );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_min_op, cl_int, cl_double );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_max_op, cl_int, cl_uint );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_max_op, cl_int, cl_float );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_max_op, cl_int, cl_double );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_value_index, cl_int, cl_uint );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_value_index, cl_int, cl_float );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::arg_value_index, cl_int, cl_double );
+
+//  The tagged values live in device_vectors between the passes
+BOLT_TEMPLATE_REGISTER_NEW_ITERATOR( bolt::cl::device_vector, cl_int, bolt::cl::arg_value< cl_int > );
+BOLT_TEMPLATE_REGISTER_NEW_ITERATOR( bolt::cl::device_vector, cl_int, bolt::cl::arg_value< cl_uint > );
+BOLT_TEMPLATE_REGISTER_NEW_ITERATOR( bolt::cl::device_vector, cl_int, bolt::cl::arg_value< cl_float > );
+BOLT_TEMPLATE_REGISTER_NEW_ITERATOR( bolt::cl::device_vector, cl_int, bolt::cl::arg_value< cl_double > );
+
+#include <bolt/cl/detail/argmin_by_key.inl>
+
+#endif
@@ -0,0 +1,469 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_BINARY_SEARCH_H )
+#define BOLT_CL_BINARY_SEARCH_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+
+#include <string>
+
+/*! \file bolt/cl/binary_search.h
+    \brief Looks up a batch of values in a sorted range: lower_bound, upper_bound and binary_search.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup searching
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-binary_search
+        *   \ingroup searching
+        *   \{
+        *   \details These are the vectorized forms of the STL searches: every value of [values_first, values_last)
+        *   is looked up in the range [first, last), which is sorted by \p comp, and the answer for the value i is
+        *   written to result[i].  The bounds are written as offsets from \p first.
+        *
+        *   On the OpenCL path every work-group first loads an evenly spaced sample of the range into local memory,
+        *   one element per work-item.  A search starts in the sample, so only its last steps read global memory.
+        *
+        *   When the values are sorted by \p comp as well, the _sorted versions merge them with the range instead.
+        *   The bound of a value is the number of elements of the range that the merge places in front of it.  The
+        *   merge path is cut into tiles of equal size, like bolt::cl::merge does, and every tile is walked from
+        *   local memory.  This reads the range and the values once, however many values there are.
+        *
+        *   The MultiCoreCpu path runs one search per value, or walks chunks of the merge path for the _sorted
+        *   versions, in tasks of bolt::btbb.
+        */
+
+        /*! \brief \p lower_bound writes, for each value, the offset of the first element of the range that is not
+        * less than the value.  This is the first position where the value could be inserted without breaking the
+        * order of the range.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sorted range to search.
+        * \param last  The end of the sorted range to search.
+        * \param values_first The beginning of the values to look up.
+        * \param values_last  The end of the values to look up.
+        * \param result The beginning of the output sequence, which receives one answer per value.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html, and its value type
+        * is an integral type.
+        * \return The end of the output sequence.
+        *
+        * \details The following code example looks up four values.
+        * \code
+        * #include <bolt/cl/binary_search.h>
+        *
+        * int a[ 6 ] = { 1, 3, 3, 5, 8, 9 };
+        * int values[ 4 ] = { 3, 0, 6, 10 };
+        * int result[ 4 ];
+        *
+        * bolt::cl::lower_bound( a, a + 6, values, values + 4, result );
+        * // result => { 1, 0, 4, 6 }
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/lower_bound.html
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator lower_bound(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator lower_bound(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        /*! \brief \p lower_bound writes, for each value, the offset of the first element of the range for which
+        * comp( element, value ) is false.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sorted range to search.
+        * \param last  The end of the sorted range to search.
+        * \param values_first The beginning of the values to look up.
+        * \param values_last  The end of the values to look up.
+        * \param result The beginning of the output sequence, which receives one answer per value.
+        * \param comp  The comparison operation the range is sorted by.  It is called with an element of the range and
+        * a value in either order.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam StrictWeakOrdering Is a model of http://www.sgi.com/tech/stl/StrictWeakOrdering.html.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html, and its value type
+        * is an integral type.
+        * \return The end of the output sequence.
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator lower_bound(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator lower_bound(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief \p upper_bound writes, for each value, the offset of the first element of the range that the
+        * value is less than, or for which comp( value, element ) is true.  This is the last position where the
+        * value could be inserted without breaking the order of the range.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sorted range to search.
+        * \param last  The end of the sorted range to search.
+        * \param values_first The beginning of the values to look up.
+        * \param values_last  The end of the values to look up.
+        * \param result The beginning of the output sequence, which receives one answer per value.
+        * \param comp  The comparison operation the range is sorted by.  It is called with an element of the range and
+        * a value in either order.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html, and its value type
+        * is an integral type.
+        * \return The end of the output sequence.
+        *
+        * \code
+        * #include <bolt/cl/binary_search.h>
+        *
+        * int a[ 6 ] = { 1, 3, 3, 5, 8, 9 };
+        * int values[ 4 ] = { 3, 0, 6, 10 };
+        * int result[ 4 ];
+        *
+        * bolt::cl::upper_bound( a, a + 6, values, values + 4, result );
+        * // result => { 3, 0, 4, 6 }
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/upper_bound.html
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator upper_bound(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator upper_bound(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator upper_bound(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator upper_bound(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief \p binary_search writes, for each value, whether the range holds an element equivalent to it:
+        * 1 when it does and 0 when it does not.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sorted range to search.
+        * \param last  The end of the sorted range to search.
+        * \param values_first The beginning of the values to look up.
+        * \param values_last  The end of the values to look up.
+        * \param result The beginning of the output sequence, which receives one answer per value.
+        * \param comp  The comparison operation the range is sorted by.  It is called with an element of the range and
+        * a value in either order.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html, and its value type
+        * is an integral type.
+        * \return The end of the output sequence.
+        *
+        * \code
+        * #include <bolt/cl/binary_search.h>
+        *
+        * int a[ 6 ] = { 1, 3, 3, 5, 8, 9 };
+        * int values[ 4 ] = { 3, 0, 6, 9 };
+        * int result[ 4 ];
+        *
+        * bolt::cl::binary_search( a, a + 6, values, values + 4, result );
+        * // result => { 1, 0, 0, 1 }
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/binary_search.html
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator binary_search(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator binary_search(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator binary_search(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator binary_search(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief \p lower_bound_sorted is \p lower_bound for values that are sorted by \p comp as well.  The
+        * values are merged with the range instead of being searched for one by one.  The answers are the same as
+        * those of \p lower_bound; they are undefined when the values are not sorted.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sorted range to search.
+        * \param last  The end of the sorted range to search.
+        * \param values_first The beginning of the values to look up.
+        * \param values_last  The end of the values to look up.
+        * \param result The beginning of the output sequence, which receives one answer per value.
+        * \param comp  The comparison operation the range is sorted by.  It is called with an element of the range and
+        * a value in either order.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html, and its value type
+        * is an integral type.
+        * \return The end of the output sequence.
+        *
+        * \details The following code example finds where a sorted batch of keys starts in a sorted table.
+        * \code
+        * #include <bolt/cl/binary_search.h>
+        *
+        * bolt::cl::device_vector< int > table( tableSize );
+        * bolt::cl::device_vector< int > keys( numKeys );
+        * bolt::cl::device_vector< int > rows( numKeys );
+        * ...
+        * bolt::cl::lower_bound_sorted( table.begin( ), table.end( ), keys.begin( ), keys.end( ), rows.begin( ) );
+        *  \endcode
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator lower_bound_sorted(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator lower_bound_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator lower_bound_sorted(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator lower_bound_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief \p upper_bound_sorted is \p upper_bound for values that are sorted by \p comp as well.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sorted range to search.
+        * \param last  The end of the sorted range to search.
+        * \param values_first The beginning of the values to look up.
+        * \param values_last  The end of the values to look up.
+        * \param result The beginning of the output sequence, which receives one answer per value.
+        * \param comp  The comparison operation the range is sorted by.  It is called with an element of the range and
+        * a value in either order.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html, and its value type
+        * is an integral type.
+        * \return The end of the output sequence.
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator upper_bound_sorted(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator upper_bound_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator upper_bound_sorted(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator upper_bound_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief \p binary_search_sorted is \p binary_search for values that are sorted by \p comp as well.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sorted range to search.
+        * \param last  The end of the sorted range to search.
+        * \param values_first The beginning of the values to look up.
+        * \param values_last  The end of the values to look up.
+        * \param result The beginning of the output sequence, which receives one answer per value.
+        * \param comp  The comparison operation the range is sorted by.  It is called with an element of the range and
+        * a value in either order.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html, and its value type
+        * is an integral type.
+        * \return The end of the output sequence.
+        */
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator binary_search_sorted(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+        OutputIterator binary_search_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator binary_search_sorted(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename InputIterator, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator binary_search_sorted(ForwardIterator first,
+            ForwardIterator last,
+            InputIterator values_first,
+            InputIterator values_last,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/binary_search.inl>
+
+#endif
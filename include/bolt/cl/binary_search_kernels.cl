@@ -0,0 +1,256 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Batched searches of a sorted range.  Independent queries first narrow their search down with a sample of the
+//  range held in lds, so only the last steps of every search touch global memory.  Sorted queries are merged with
+//  the range instead: the lower bound of a query is the number of elements of the range merged in front of it.
+
+// #pragma OPENCL EXTENSION cl_amd_printf : enable
+
+#define SEARCH_LOWER_BOUND 0
+#define SEARCH_UPPER_BOUND 1
+#define SEARCH_BINARY_SEARCH 2
+
+//  True when element lies at or past the bound searched for value: the upper bound passes the elements equivalent
+//  to value, the lower bound and binary_search stop in front of them.
+template< typename iType, typename vType, typename StrictWeakOrdering >
+inline bool searchPastBound( iType element, vType value, const uint mode, global StrictWeakOrdering* lessOp )
+{
+    return ( mode == SEARCH_UPPER_BOUND ) ? ( *lessOp )( value, element ) : !( *lessOp )( element, value );
+}
+
+//  Writes the bound, or for binary_search whether the element at the lower bound is equivalent to value
+template< typename iType, typename iIterType, typename vType, typename oIterType, typename StrictWeakOrdering >
+inline void searchWriteResult(
+    iIterType input_iter,
+    const uint length,
+    vType value,
+    const uint bound,
+    oIterType result_iter,
+    const uint index,
+    const uint mode,
+    global StrictWeakOrdering* lessOp )
+{
+    if( mode == SEARCH_BINARY_SEARCH )
+    {
+        bool found = false;
+        if( bound < length )
+        {
+            iType element = input_iter[ bound ];
+            found = !( *lessOp )( value, element );
+        }
+        result_iter[ index ] = found;
+    }
+    else
+        result_iter[ index ] = bound;
+}
+
+//  Every work-group loads one evenly spaced sample of the range per work-item into lds.  A query is first placed
+//  between two consecutive samples, then searched for between their positions in global memory.
+template< typename iType, typename iIterType, typename vType, typename vIterType, typename oType,
+          typename oIterType, typename StrictWeakOrdering >
+kernel void searchTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const uint length,
+    global vType* values_ptr,
+    vIterType values_iter,
+    const uint numValues,
+    global oType* result_ptr,
+    oIterType result_iter,
+    const uint mode,
+    local iType* samples,
+    global StrictWeakOrdering* lessOp )
+{
+    input_iter.init( input_ptr );
+    values_iter.init( values_ptr );
+    result_iter.init( result_ptr );
+
+    uint localId = get_local_id( 0 );
+    uint numSamples = get_local_size( 0 );
+
+    if( length )
+        samples[ localId ] = input_iter[ (uint)( ( (ulong)localId * length ) / numSamples ) ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint index = get_global_id( 0 ); index < numValues; index += get_global_size( 0 ) )
+    {
+        vType value = values_iter[ index ];
+        uint low = 0;
+        uint high = length;
+
+        if( length )
+        {
+            //  Number of samples in front of the bound
+            uint sampleLow = 0;
+            uint sampleHigh = numSamples;
+            while( sampleLow < sampleHigh )
+            {
+                uint mid = ( sampleLow + sampleHigh ) / 2;
+                if( searchPastBound( samples[ mid ], value, mode, lessOp ) )
+                    sampleHigh = mid;
+                else
+                    sampleLow = mid + 1;
+            }
+
+            if( sampleLow > 0 )
+                low = (uint)( ( (ulong)( sampleLow - 1 ) * length ) / numSamples ) + 1;
+            if( sampleLow < numSamples )
+                high = (uint)( ( (ulong)sampleLow * length ) / numSamples );
+        }
+
+        while( low < high )
+        {
+            uint mid = low + ( high - low ) / 2;
+            iType element = input_iter[ mid ];
+            if( searchPastBound( element, value, mode, lessOp ) )
+                high = mid;
+            else
+                low = mid + 1;
+        }
+
+        searchWriteResult< iType >( input_iter, length, value, low, result_iter, index, mode, lessOp );
+    }
+}
+
+//  One work-item per tile boundary; splits[ i ] is the number of elements of the range merged in front of tile i.
+//  An element of the range goes in front of a query exactly when it lies before the bound of that query.
+template< typename iType, typename iIterType, typename vType, typename vIterType, typename StrictWeakOrdering >
+kernel void searchPartitionTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const uint length,
+    global vType* values_ptr,
+    vIterType values_iter,
+    const uint numValues,
+    const uint tileSize,
+    const uint numBoundaries,
+    global uint* splits,
+    const uint mode,
+    global StrictWeakOrdering* lessOp )
+{
+    uint boundary = get_global_id( 0 );
+    if( boundary >= numBoundaries )
+        return;
+
+    input_iter.init( input_ptr );
+    values_iter.init( values_ptr );
+
+    uint diagonal = min( boundary * tileSize, length + numValues );
+    uint low = ( diagonal > numValues ) ? diagonal - numValues : 0;
+    uint high = min( diagonal, length );
+    while( low < high )
+    {
+        uint mid = low + ( high - low ) / 2;
+        iType element = input_iter[ mid ];
+        vType value = values_iter[ diagonal - 1 - mid ];
+        if( !searchPastBound( element, value, mode, lessOp ) )
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    splits[ boundary ] = low;
+}
+
+//  Number of elements of the range among the first diagonal entries of the merged tile held in lds
+template< typename iType, typename vType, typename StrictWeakOrdering >
+uint searchMergePathSplitLocal(
+    local iType* a,
+    const uint aLength,
+    local vType* b,
+    const uint bLength,
+    const uint diagonal,
+    const uint mode,
+    global StrictWeakOrdering* lessOp )
+{
+    uint low = ( diagonal > bLength ) ? diagonal - bLength : 0;
+    uint high = min( diagonal, aLength );
+    while( low < high )
+    {
+        uint mid = low + ( high - low ) / 2;
+        if( !searchPastBound( a[ mid ], b[ diagonal - 1 - mid ], mode, lessOp ) )
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+//  Stages the part of the range and of the sorted queries that make up the tile of this work-group in lds.  Every
+//  work-item walks SEARCH_ITEMS_PER_WORKITEM entries of the merged tile; when it reaches a query, the number of
+//  elements of the range merged so far is the bound of that query.
+template< typename iType, typename iIterType, typename vType, typename vIterType, typename oType,
+          typename oIterType, typename StrictWeakOrdering >
+kernel void searchMergeTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const uint length,
+    global vType* values_ptr,
+    vIterType values_iter,
+    const uint numValues,
+    global oType* result_ptr,
+    oIterType result_iter,
+    global uint* splits,
+    const uint mode,
+    local iType* ldsInput,
+    local vType* ldsValues,
+    global StrictWeakOrdering* lessOp )
+{
+    input_iter.init( input_ptr );
+    values_iter.init( values_ptr );
+    result_iter.init( result_ptr );
+
+    uint groupId = get_group_id( 0 );
+    uint localId = get_local_id( 0 );
+    uint localSize = get_local_size( 0 );
+    uint tileSize = localSize * SEARCH_ITEMS_PER_WORKITEM;
+
+    uint tileBegin = groupId * tileSize;
+    uint tileEnd = min( tileBegin + tileSize, length + numValues );
+    uint aBegin = splits[ groupId ];
+    uint aCount = splits[ groupId + 1 ] - aBegin;
+    uint bBegin = tileBegin - aBegin;
+    uint count = tileEnd - tileBegin;
+    uint bCount = count - aCount;
+
+    for( uint i = localId; i < aCount; i += localSize )
+        ldsInput[ i ] = input_iter[ aBegin + i ];
+    for( uint i = localId; i < bCount; i += localSize )
+        ldsValues[ i ] = values_iter[ bBegin + i ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    uint outBegin = min( localId * SEARCH_ITEMS_PER_WORKITEM, count );
+    uint outEnd = min( outBegin + SEARCH_ITEMS_PER_WORKITEM, count );
+    uint aIndex = searchMergePathSplitLocal( ldsInput, aCount, ldsValues, bCount, outBegin, mode, lessOp );
+    uint bIndex = outBegin - aIndex;
+
+    for( uint out = outBegin; out < outEnd; ++out )
+    {
+        bool takeValue = ( bIndex < bCount );
+        if( takeValue && aIndex < aCount )
+            takeValue = searchPastBound( ldsInput[ aIndex ], ldsValues[ bIndex ], mode, lessOp );
+
+        if( takeValue )
+        {
+            searchWriteResult< iType >( input_iter, length, ldsValues[ bIndex ], aBegin + aIndex, result_iter,
+                                        bBegin + bIndex, mode, lessOp );
+            ++bIndex;
+        }
+        else
+            ++aIndex;
+    }
+}
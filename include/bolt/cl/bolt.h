@@ -68,26 +68,40 @@
 namespace bolt {
     namespace cl {
 
+        extern const std::string binary_search_kernels;
         extern const std::string copy_kernels;
+        extern const std::string copy_if_kernels;
         extern const std::string count_kernels;
         extern const std::string fill_kernels;
+        extern const std::string find_kernels;
         extern const std::string generate_kernels;
+        extern const std::string histogram_kernels;
+        extern const std::string inner_product_kernels;
+        extern const std::string lookback_kernels;
+        extern const std::string merge_kernels;
         extern const std::string min_element_kernels;
+        extern const std::string minmax_element_kernels;
+        extern const std::string partial_sort_kernels;
         extern const std::string reduce_kernels;
         extern const std::string reduce_by_key_kernels;
+        extern const std::string reduce_by_key_unsorted_kernels;
         extern const std::string scan_kernels;
         extern const std::string scan_by_key_kernels;
+        extern const std::string segmented_reduce_kernels;
+        extern const std::string segmented_scan_kernels;
         extern const std::string sort_kernels;
         extern const std::string stablesort_kernels;
         extern const std::string stablesort_by_key_kernels;
         extern const std::string sort_uint_kernels;
         extern const std::string sort_by_key_kernels;
+        extern const std::string sort_by_extracted_key_kernels;
         extern const std::string transform_kernels;
         extern const std::string transform_reduce_kernels;
+        extern const std::string transform_reduce_range_kernels;
         extern const std::string transform_scan_kernels;
 
         // transform_scan kernel names
-        //static std::string transform_scan_kernel_names_array[] = { "perBlockTransformScan", "intraBlockInclusiveScan", "perBlockAddition" };
+        //static std::string transform_scan_kernel_names_array[] = { "perTileTransformReduce", "intraBlockInclusiveScan", "perTileTransformScan" };
         //const std::vector<std::string> transformScanKernelNames(transform_scan_kernel_names_array, transform_scan_kernel_names_array+3);
 
         /******************************************************************
@@ -187,6 +201,30 @@ namespace bolt {
 
         void wait( const bolt::cl::control &ctl, ::cl::Event &e );
 
+        /*! \brief Reports whether the device of a control has 32-bit global atomics
+        *  \details They are core from OpenCL 1.1 on, and the cl_khr_global_int32_base_atomics extension before that.
+        *  \param ctl The control whose device is queried
+        */
+        bool supportsGlobalAtomics( const bolt::cl::control &ctl );
+
+        /*! \brief Reports whether the device of a control can run the single-pass scans
+        *  \details The single-pass scans chain their tiles with a decoupled look-back over global atomics, and a
+        *  tile spins until the tiles before it publish; this is used on GPU devices with 32-bit global atomics.
+        *  Other devices run the multi-pass scans.
+        *  \param ctl The control whose device is queried
+        */
+        bool supportsSinglePassScan( const bolt::cl::control &ctl );
+
+        /*! \brief Picks how many consecutive elements every work-item of a single-pass scan scans in registers
+        *  \details Small types get more elements per work-item, up to 8, and the count is halved until a tile fits
+        *  in a quarter of the local memory of the device, so that several work-groups stay resident.
+        *  \param ctl The control whose device is queried
+        *  \param elementBytes The bytes of local memory one element of a tile needs
+        *  \param workGroupSize The work-group size of the scan kernel
+        */
+        cl_uint singlePassScanItemsPerWorkItem( const bolt::cl::control &ctl, size_t elementBytes,
+            size_t workGroupSize );
+
         /******************************************************************
          * Program Map - so each kernel is only compiled once
          *****************************************************************/
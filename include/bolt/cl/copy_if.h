@@ -0,0 +1,167 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_COPY_IF_H )
+#define BOLT_CL_COPY_IF_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+
+#include <string>
+
+/*! \file bolt/cl/copy_if.h
+    \brief Copies or removes the elements of a range that satisfy a predicate.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup copying
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-copy_if
+        *   \ingroup copying
+        *   \{
+        *   \details The OpenCL path compacts the range in one scan-and-scatter pass: every tile evaluates the
+        *   predicate once per element, scans the counts of the kept elements, and writes them behind the count of
+        *   the preceding tiles.  On devices that support the single-pass scans, the preceding count comes from a
+        *   decoupled look-back, so the input is read once; other devices count the tiles, scan the counts with
+        *   inclusive_scan, and then scatter.  All of these algorithms are stable, and the number of kept elements is
+        *   read back to the host to form the returned iterator.
+        */
+
+        /*! \brief \p copy_if copies the elements of [first, last) for which \p pred is true to the range that starts
+        * at \p result, keeping their relative order.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the input sequence.
+        * \param last  The end of the input sequence.
+        * \param result The beginning of the output sequence; it must not overlap the input.
+        * \param pred A unary predicate, registered with BOLT_FUNCTOR.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html
+        * \tparam Predicate Is a model of http://www.sgi.com/tech/stl/Predicate.html
+        * \return The end of the output sequence.
+        *
+        * \details The following code example keeps the positive values.
+        * \code
+        * #include <bolt/cl/copy_if.h>
+        *
+        * BOLT_FUNCTOR( IsPositive,
+        * struct IsPositive
+        * {
+        *     bool operator( )( const int x ) const { return x > 0; }
+        * };
+        * );
+        *
+        * int a[ 8 ] = { 3, -1, 4, -1, 5, -9, 2, 6 };
+        * int b[ 8 ];
+        * int* end = bolt::cl::copy_if( a, a + 8, b, IsPositive( ) );
+        * // b => { 3, 4, 5, 2, 6 }, end == b + 5
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/copy_if.html
+        */
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator copy_if(InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        /*! \brief \p remove_copy_if copies the elements of [first, last) for which \p pred is false to the range
+        * that starts at \p result, keeping their relative order.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the input sequence.
+        * \param last  The end of the input sequence.
+        * \param result The beginning of the output sequence; it must not overlap the input.
+        * \param pred A unary predicate, registered with BOLT_FUNCTOR.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html
+        * \tparam Predicate Is a model of http://www.sgi.com/tech/stl/Predicate.html
+        * \return The end of the output sequence.
+        * \sa http://www.sgi.com/tech/stl/remove_copy_if.html
+        */
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator remove_copy_if(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OutputIterator, typename Predicate>
+        OutputIterator remove_copy_if(InputIterator first,
+            InputIterator last,
+            OutputIterator result,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        /*! \brief \p remove_if removes the elements of [first, last) for which \p pred is true.  The remaining
+        * elements are moved to the front of the range in their relative order; the elements past the returned
+        * iterator are left in an unspecified state.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sequence.
+        * \param last  The end of the sequence.
+        * \param pred A unary predicate, registered with BOLT_FUNCTOR.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html, and is mutable.
+        * \tparam Predicate Is a model of http://www.sgi.com/tech/stl/Predicate.html
+        * \return The end of the remaining elements.
+        *
+        * \details On devices that support the single-pass scans the range is compacted in place; otherwise the
+        * kept elements go through a temporary buffer.
+        * \sa http://www.sgi.com/tech/stl/remove_if.html
+        */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator remove_if(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator remove_if(ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/copy_if.inl>
+
+#endif
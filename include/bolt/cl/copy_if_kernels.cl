@@ -0,0 +1,199 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Stream compaction: every tile evaluates the predicate once per element, scans the selected counts in local
+//  memory, and scatters the selected elements behind the count of the preceding tiles.  On devices that can chain
+//  tiles the preceding count comes from a decoupled look-back, so the input is read once; the other devices count
+//  the tiles first and scan the counts.
+
+//  The look-back helpers come from lookback_kernels.cl, which the host prepends to this source; a tile value here is
+//  a plain count, so the counts of the preceding tiles are added
+struct copyIfCountPlus
+{
+    uint operator( )( uint earlier, uint later )
+    {
+        return earlier + later;
+    }
+};
+
+//  Counts the elements every tile keeps, for devices that scan the counts in a separate pass
+template< typename iType, typename iIterType, typename Predicate >
+kernel void copyIfCountTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const uint vecSize,
+    global Predicate* pred,
+    int keepSelected,
+    local uint* ldsCounts,
+    global uint* tileCounts )
+{
+    size_t locId = get_local_id( 0 );
+    size_t wgSize = get_local_size( 0 );
+    input_iter.init( input_ptr );
+
+    uint tileSize = ( uint )wgSize * COPY_IF_ITEMS_PER_WORKITEM;
+    uint tileStart = get_group_id( 0 ) * tileSize;
+    uint tileEnd = min( tileStart + tileSize, vecSize );
+
+    uint selected = 0;
+    for( uint index = tileStart + locId; index < tileEnd; index += wgSize )
+    {
+        iType value = input_iter[ index ];
+        if( (*pred)( value ) ? keepSelected : !keepSelected )
+            ++selected;
+    }
+
+    ldsCounts[ locId ] = selected;
+    barrier( CLK_LOCAL_MEM_FENCE );
+    for( size_t offset = wgSize / 2; offset > 0; offset /= 2 )
+    {
+        if( locId < offset )
+            ldsCounts[ locId ] += ldsCounts[ locId + offset ];
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+
+    if( locId == 0 )
+        tileCounts[ get_group_id( 0 ) ] = ldsCounts[ 0 ];
+}
+
+//  Scatters the elements a tile keeps.  The tile offset comes from the look-back when singlePass is set, and from
+//  the inclusive scan of the tile counts in tileOffsets otherwise.  With keepRejected, the other elements are
+//  written backwards from the end of rejected, the i-th one at vecSize - 1 - i.  The count of kept elements is left
+//  in selectedCount.
+template< typename iType, typename iIterType, typename oType, typename oIterType, typename Predicate >
+kernel void copyIfTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const uint vecSize,
+    global oType* output_ptr,
+    oIterType output_iter,
+    global oType* rejected,
+    global Predicate* pred,
+    int keepSelected,
+    int keepRejected,
+    local iType* ldsValues,
+    local uint* ldsCounts,
+    global uint* tileStatus,
+    global uint* tileValues,
+    global uint* tileOffsets,
+    int singlePass,
+    global uint* selectedCount )
+{
+    local uint tileIndex;
+    local uint tilePrefix;
+    size_t locId = get_local_id( 0 );
+    size_t wgSize = get_local_size( 0 );
+    input_iter.init( input_ptr );
+    output_iter.init( output_ptr );
+
+    //  Single-pass tiles are numbered in the order they start, so a tile only ever waits on tiles that are running
+    if( locId == 0 )
+        tileIndex = singlePass ? atomic_inc( tileStatus ) : get_group_id( 0 );
+    barrier( CLK_LOCAL_MEM_FENCE );
+    uint tile = tileIndex;
+    uint tileSize = ( uint )wgSize * COPY_IF_ITEMS_PER_WORKITEM;
+    uint tileStart = tile * tileSize;
+    uint tileCount = min( tileSize, vecSize - tileStart );
+
+    //  The tile is read completely before anything is written, and a tile only writes below the elements of the
+    //  tiles it has looked back on, so the single-pass kernel may compact in place
+    for( uint i = locId; i < tileCount; i += wgSize )
+        ldsValues[ i ] = input_iter[ tileStart + i ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    uint first = locId * COPY_IF_ITEMS_PER_WORKITEM;
+    uint count = ( first < tileCount ) ? min( ( uint )COPY_IF_ITEMS_PER_WORKITEM, tileCount - first ) : 0;
+    uint selectedBits = 0;
+    uint selected = 0;
+    for( uint k = 0; k < count; ++k )
+    {
+        iType value = ldsValues[ first + k ];
+        if( (*pred)( value ) ? keepSelected : !keepSelected )
+        {
+            selectedBits |= ( 1u << k );
+            ++selected;
+        }
+    }
+
+    //  Exclusive scan of the counts of the work-items
+    uint sum = selected;
+    ldsCounts[ locId ] = sum;
+    for( size_t offset = 1; offset < wgSize; offset *= 2 )
+    {
+        barrier( CLK_LOCAL_MEM_FENCE );
+        if( locId >= offset )
+            sum += ldsCounts[ locId - offset ];
+        barrier( CLK_LOCAL_MEM_FENCE );
+        ldsCounts[ locId ] = sum;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+    uint aggregate = ldsCounts[ wgSize - 1 ];
+    uint threadPrefix = sum - selected;
+
+    if( locId == 0 )
+    {
+        uint prefix = 0;
+        if( singlePass )
+        {
+            if( tile == 0 )
+                lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, aggregate );
+            else
+            {
+                lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_AGGREGATE, aggregate );
+                copyIfCountPlus combine;
+                prefix = lookBackCombine< uint >( tileStatus, tileValues, tile, combine );
+                lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, prefix + aggregate );
+            }
+        }
+        else if( tile > 0 )
+            prefix = tileOffsets[ tile - 1 ];
+
+        tilePrefix = prefix;
+        if( tileStart + tileCount == vecSize )
+            selectedCount[ 0 ] = prefix + aggregate;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  position is the number of kept elements in front of the current one, so index - position is the number of
+    //  rejected ones
+    uint position = tilePrefix + threadPrefix;
+    for( uint k = 0; k < count; ++k )
+    {
+        iType value = ldsValues[ first + k ];
+        uint index = tileStart + first + k;
+        if( selectedBits & ( 1u << k ) )
+            output_iter[ position++ ] = value;
+        else if( keepRejected )
+            rejected[ vecSize - 1 - ( index - position ) ] = value;
+    }
+}
+
+//  Moves a partition from the scratch buffer of copyIfTemplate into place; the rejected elements were written
+//  backwards, so reading them backwards restores their order
+template< typename oType, typename oIterType >
+kernel void partitionCopyBackTemplate(
+    global oType* scratch,
+    const uint vecSize,
+    const uint numSelected,
+    global oType* output_ptr,
+    oIterType output_iter )
+{
+    output_iter.init( output_ptr );
+
+    for( uint i = get_global_id( 0 ); i < vecSize; i += get_global_size( 0 ) )
+        output_iter[ i ] = ( i < numSelected ) ? scratch[ i ] : scratch[ vecSize - 1 - ( i - numSelected ) ];
+}
@@ -24,6 +24,7 @@
 
 #include "bolt/cl/bolt.h"
 #include "bolt/cl/functional.h"
+#include "bolt/cl/device_scalar.h"
 #include "bolt/cl/transform_reduce.h"
 #include "bolt/cl/iterator/iterator_traits.h"
 
@@ -114,6 +115,31 @@ namespace bolt {
             typedef typename std::iterator_traits<InputIterator>::value_type T;
             return count_if(first, last, detail::CountIfEqual<T>(value), CountIfEqual_OclCode + cl_code);
         };
+
+        /*! \brief These versions of \p count write the count to a bolt::cl::device_scalar instead of returning it;
+         *  see the device_scalar versions of \p count_if.
+         */
+        template<typename InputIterator, typename EqualityComparable>
+        void count(control& ctl, InputIterator first,
+            InputIterator last,
+            const EqualityComparable &value,
+            device_scalar< int >& result,
+            const std::string& cl_code="")
+        {
+            typedef typename std::iterator_traits<InputIterator>::value_type T;
+            count_if(ctl, first, last, detail::CountIfEqual<T>(value), result, CountIfEqual_OclCode + cl_code);
+        };
+
+        template<typename InputIterator, typename EqualityComparable>
+        void count(InputIterator first,
+            InputIterator last,
+            const EqualityComparable &value,
+            device_scalar< int >& result,
+            const std::string& cl_code="")
+        {
+            typedef typename std::iterator_traits<InputIterator>::value_type T;
+            count_if(first, last, detail::CountIfEqual<T>(value), result, CountIfEqual_OclCode + cl_code);
+        };
         
         
         /*!
@@ -205,8 +231,36 @@ namespace bolt {
             InputIterator last, 
             Predicate predicate,
             const std::string &cl_code="");
-            
-        
+
+        /*! \brief This version of \p count_if writes the count to a bolt::cl::device_scalar instead of returning it.
+        *  On the OpenCL path the partial counts are also summed on the device, and the call returns as soon as the
+        *  kernels are enqueued.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning,etc. See bolt::cl::control
+        * \param first The first position in the sequence to be counted.
+        * \param last The last position in the sequence to be counted.
+        * \param predicate The count is incremented for each element which returns true when passed to
+        *  the predicate function.
+        * \param result The scalar that receives the count.  It must have been created on the command queue of
+        *  \p ctl.
+        * \param cl_code  Optional OpenCL(TM) code to be prepended to any OpenCL kernels used by this function.
+        *
+        * \sa bolt::cl::device_scalar
+        */
+       template<typename InputIterator, typename Predicate>
+        void count_if(control& ctl, InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            device_scalar< int >& result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename Predicate>
+        void count_if(InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            device_scalar< int >& result,
+            const std::string &cl_code="");
+
          /*!   \}  */
         
     };
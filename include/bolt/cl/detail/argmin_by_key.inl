@@ -0,0 +1,503 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_ARGMIN_BY_KEY_INL )
+#define BOLT_CL_ARGMIN_BY_KEY_INL
+#pragma once
+
+#include <algorithm>
+
+#include "bolt/cl/transform.h"
+#include "bolt/cl/reduce_by_key.h"
+#include "bolt/cl/iterator/counting_iterator.h"
+
+#ifdef ENABLE_TBB
+    #include "bolt/btbb/minmax_element.h"
+#endif
+
+namespace bolt
+{
+namespace cl
+{
+
+namespace detail
+{
+
+//  Serial reference of argmin_by_key; returns the number of runs
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename StrictWeakOrdering >
+unsigned int
+serial_argmin_by_key( InputIterator1 keys_first,
+                      InputIterator1 keys_last,
+                      InputIterator2 values_first,
+                      OutputIterator1 keys_output,
+                      OutputIterator2 indices_output,
+                      BinaryPredicate binary_pred,
+                      StrictWeakOrdering comp )
+{
+    typedef typename std::iterator_traits< OutputIterator2 >::value_type ioType;
+
+    unsigned int numElements = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+    unsigned int count = 0;
+    unsigned int begin = 0;
+    while( begin < numElements )
+    {
+        unsigned int best = begin;
+        unsigned int next = begin + 1;
+        for( ; next < numElements && binary_pred( keys_first[ next - 1 ], keys_first[ next ] ); ++next )
+        {
+            if( comp( values_first[ next ], values_first[ best ] ) )
+                best = next;
+        }
+        keys_output[ count ] = keys_first[ begin ];
+        indices_output[ count ] = static_cast< ioType >( best );
+        ++count;
+        begin = next;
+    }
+    return count;
+}
+
+//  The positions are found by tagging every value with its position, reducing the (value, position) pairs of every
+//  run with ArgOperator, and writing the positions of the reduced pairs.  All three passes stay on the device.
+template<
+    typename DVInputIterator1,
+    typename DVInputIterator2,
+    typename DVOutputIterator1,
+    typename DVOutputIterator2,
+    typename BinaryPredicate,
+    typename ArgOperator >
+unsigned int
+argmin_by_key_enqueue(
+    control& ctl,
+    const DVInputIterator1& keys_first,
+    const DVInputIterator1& keys_last,
+    const DVInputIterator2& values_first,
+    const DVOutputIterator1& keys_output,
+    const DVOutputIterator2& indices_output,
+    const BinaryPredicate& binary_pred,
+    const ArgOperator& arg_op,
+    const std::string& user_code )
+{
+    typedef typename std::iterator_traits< DVInputIterator2 >::value_type vType;
+
+    unsigned int numElements = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+
+    device_vector< arg_value< vType > > dvTagged( numElements, arg_value< vType >( ), CL_MEM_READ_WRITE, false,
+                                                  ctl );
+    device_vector< arg_value< vType > > dvReduced( numElements, arg_value< vType >( ), CL_MEM_READ_WRITE, false,
+                                                   ctl );
+
+    transform_enqueue( ctl, values_first, values_first + numElements, bolt::cl::counting_iterator< int >( 0 ),
+                       dvTagged.begin( ), arg_value_tag< vType >( ), user_code );
+
+    unsigned int numRuns = reduce_by_key_enqueue( ctl, keys_first, keys_last, dvTagged.begin( ), keys_output,
+                                                  dvReduced.begin( ), binary_pred, arg_op, user_code );
+
+    transform_unary_enqueue( ctl, dvReduced.begin( ), dvReduced.begin( ) + numRuns, indices_output,
+                             arg_value_index< vType >( ), user_code );
+
+    return numRuns;
+}
+
+/*!
+* \brief This overload is called strictly for non-device_vector iterators
+*/
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename StrictWeakOrdering,
+    typename ArgOperator >
+bolt::cl::pair< OutputIterator1, OutputIterator2 >
+argmin_by_key_pick_iterator(
+    control& ctl,
+    const InputIterator1& keys_first,
+    const InputIterator1& keys_last,
+    const InputIterator2& values_first,
+    const OutputIterator1& keys_output,
+    const OutputIterator2& indices_output,
+    const BinaryPredicate& binary_pred,
+    const StrictWeakOrdering& comp,
+    const ArgOperator& arg_op,
+    const std::string& user_code,
+    std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< InputIterator2 >::value_type vType;
+    typedef typename std::iterator_traits< OutputIterator1 >::value_type koType;
+    typedef typename std::iterator_traits< OutputIterator2 >::value_type ioType;
+    static_assert( std::is_same< ioType, int >::value, "The positions are written as int" );
+
+    unsigned int numElements = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+    if( numElements == 0 )
+        return bolt::cl::make_pair( keys_output, indices_output );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );  // could be dynamic choice some day.
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        unsigned int sizeOfOut = serial_argmin_by_key( keys_first, keys_last, values_first, keys_output,
+                                                       indices_output, binary_pred, comp );
+        return bolt::cl::make_pair( keys_output + sizeOfOut, indices_output + sizeOfOut );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            std::pair< OutputIterator1, OutputIterator2 > ends = bolt::btbb::argmin_by_key( keys_first, keys_last,
+                values_first, keys_output, indices_output, binary_pred, comp );
+            return bolt::cl::make_pair( ends.first, ends.second );
+        #else
+            throw std::exception( "The MultiCoreCpu version of argmin_by_key is not enabled to be built! \n" );
+        #endif
+    }
+
+    unsigned int sizeOfOut;
+    {
+        // Map the input iterator to a device_vector
+        device_vector< kType > dvKeys( keys_first, keys_last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< vType > dvValues( values_first, numElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, true,
+                                         ctl );
+        device_vector< koType > dvKOutput( keys_output, numElements, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false,
+                                           ctl );
+        device_vector< ioType > dvIOutput( indices_output, numElements, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY,
+                                           false, ctl );
+
+        sizeOfOut = argmin_by_key_enqueue( ctl, dvKeys.begin( ), dvKeys.end( ), dvValues.begin( ),
+                                           dvKOutput.begin( ), dvIOutput.begin( ), binary_pred, arg_op, user_code );
+
+        // This should immediately map/unmap the buffer
+        dvKOutput.data( );
+        dvIOutput.data( );
+    }
+    return bolt::cl::make_pair( keys_output + sizeOfOut, indices_output + sizeOfOut );
+}
+
+/*!
+* \brief This overload is called strictly for device_vector iterators
+*/
+template<
+    typename DVInputIterator1,
+    typename DVInputIterator2,
+    typename DVOutputIterator1,
+    typename DVOutputIterator2,
+    typename BinaryPredicate,
+    typename StrictWeakOrdering,
+    typename ArgOperator >
+bolt::cl::pair< DVOutputIterator1, DVOutputIterator2 >
+argmin_by_key_pick_iterator(
+    control& ctl,
+    const DVInputIterator1& keys_first,
+    const DVInputIterator1& keys_last,
+    const DVInputIterator2& values_first,
+    const DVOutputIterator1& keys_output,
+    const DVOutputIterator2& indices_output,
+    const BinaryPredicate& binary_pred,
+    const StrictWeakOrdering& comp,
+    const ArgOperator& arg_op,
+    const std::string& user_code,
+    bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< DVInputIterator2 >::value_type vType;
+    typedef typename std::iterator_traits< DVOutputIterator1 >::value_type koType;
+    typedef typename std::iterator_traits< DVOutputIterator2 >::value_type ioType;
+    static_assert( std::is_same< ioType, int >::value, "The positions are written as int" );
+
+    unsigned int numElements = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+    if( numElements == 0 )
+        return bolt::cl::make_pair( keys_output, indices_output );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );  // could be dynamic choice some day.
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        typename bolt::cl::device_vector< kType >::pointer keysPtr = keys_first.getContainer( ).data( );
+        typename bolt::cl::device_vector< vType >::pointer valsPtr = values_first.getContainer( ).data( );
+        typename bolt::cl::device_vector< koType >::pointer oKeysPtr = keys_output.getContainer( ).data( );
+        typename bolt::cl::device_vector< ioType >::pointer oIdxPtr = indices_output.getContainer( ).data( );
+
+        unsigned int sizeOfOut;
+        if( runMode == bolt::cl::control::SerialCpu )
+        {
+            sizeOfOut = serial_argmin_by_key( &keysPtr[ keys_first.m_Index ],
+                                              &keysPtr[ keys_first.m_Index + numElements ],
+                                              &valsPtr[ values_first.m_Index ], &oKeysPtr[ keys_output.m_Index ],
+                                              &oIdxPtr[ indices_output.m_Index ], binary_pred, comp );
+        }
+        else
+        {
+            #ifdef ENABLE_TBB
+                std::pair< koType*, ioType* > ends = bolt::btbb::argmin_by_key( &keysPtr[ keys_first.m_Index ],
+                    &keysPtr[ keys_first.m_Index + numElements ], &valsPtr[ values_first.m_Index ],
+                    &oKeysPtr[ keys_output.m_Index ], &oIdxPtr[ indices_output.m_Index ], binary_pred, comp );
+                sizeOfOut = static_cast< unsigned int >( ends.second - &oIdxPtr[ indices_output.m_Index ] );
+            #else
+                throw std::exception( "The MultiCoreCpu version of argmin_by_key is not enabled to be built! \n" );
+            #endif
+        }
+        return bolt::cl::make_pair( keys_output + sizeOfOut, indices_output + sizeOfOut );
+    }
+
+    unsigned int sizeOfOut = argmin_by_key_enqueue( ctl, keys_first, keys_last, values_first, keys_output,
+                                                    indices_output, binary_pred, arg_op, user_code );
+    return bolt::cl::make_pair( keys_output + sizeOfOut, indices_output + sizeOfOut );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename StrictWeakOrdering,
+    typename ArgOperator >
+bolt::cl::pair< OutputIterator1, OutputIterator2 >
+argmin_by_key_detect_random_access(
+    control& ctl,
+    const InputIterator1& keys_first,
+    const InputIterator1& keys_last,
+    const InputIterator2& values_first,
+    const OutputIterator1& keys_output,
+    const OutputIterator2& indices_output,
+    const BinaryPredicate& binary_pred,
+    const StrictWeakOrdering& comp,
+    const ArgOperator& arg_op,
+    const std::string& user_code,
+    std::input_iterator_tag )
+{
+    //  TODO:  It should be possible to support non-random_access_iterator_tag iterators, if we copied the data
+    //  to a temporary buffer.  Should we?
+    static_assert( false, "Bolt only supports random access iterator types" );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename StrictWeakOrdering,
+    typename ArgOperator >
+bolt::cl::pair< OutputIterator1, OutputIterator2 >
+argmin_by_key_detect_random_access(
+    control& ctl,
+    const InputIterator1& keys_first,
+    const InputIterator1& keys_last,
+    const InputIterator2& values_first,
+    const OutputIterator1& keys_output,
+    const OutputIterator2& indices_output,
+    const BinaryPredicate& binary_pred,
+    const StrictWeakOrdering& comp,
+    const ArgOperator& arg_op,
+    const std::string& user_code,
+    std::random_access_iterator_tag )
+{
+    return argmin_by_key_pick_iterator( ctl, keys_first, keys_last, values_first, keys_output, indices_output,
+        binary_pred, comp, arg_op, user_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+} // end of detail namespace
+
+/**********************************************************************************************************************
+ * ARGMIN BY KEY
+ *********************************************************************************************************************/
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate >
+pair< OutputIterator1, OutputIterator2 >
+argmin_by_key(
+    control &ctl,
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 indices_output,
+    BinaryPredicate binary_pred,
+    const std::string& user_code )
+{
+    typedef typename std::iterator_traits< InputIterator2 >::value_type vType;
+    return detail::argmin_by_key_detect_random_access( ctl, keys_first, keys_last, values_first, keys_output,
+        indices_output, binary_pred, bolt::cl::less< vType >( ), arg_min_op< vType >( ), user_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate >
+pair< OutputIterator1, OutputIterator2 >
+argmin_by_key(
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 indices_output,
+    BinaryPredicate binary_pred,
+    const std::string& user_code )
+{
+    return argmin_by_key( control::getDefault( ), keys_first, keys_last, values_first, keys_output,
+        indices_output, binary_pred, user_code );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2 >
+pair< OutputIterator1, OutputIterator2 >
+argmin_by_key(
+    control &ctl,
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 indices_output,
+    const std::string& user_code )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    return argmin_by_key( ctl, keys_first, keys_last, values_first, keys_output, indices_output,
+        bolt::cl::equal_to< kType >( ), user_code );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2 >
+pair< OutputIterator1, OutputIterator2 >
+argmin_by_key(
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 indices_output,
+    const std::string& user_code )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    return argmin_by_key( control::getDefault( ), keys_first, keys_last, values_first, keys_output,
+        indices_output, bolt::cl::equal_to< kType >( ), user_code );
+}
+
+/**********************************************************************************************************************
+ * ARGMAX BY KEY
+ *********************************************************************************************************************/
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate >
+pair< OutputIterator1, OutputIterator2 >
+argmax_by_key(
+    control &ctl,
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 indices_output,
+    BinaryPredicate binary_pred,
+    const std::string& user_code )
+{
+    typedef typename std::iterator_traits< InputIterator2 >::value_type vType;
+    return detail::argmin_by_key_detect_random_access( ctl, keys_first, keys_last, values_first, keys_output,
+        indices_output, binary_pred, bolt::cl::greater< vType >( ), arg_max_op< vType >( ), user_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate >
+pair< OutputIterator1, OutputIterator2 >
+argmax_by_key(
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 indices_output,
+    BinaryPredicate binary_pred,
+    const std::string& user_code )
+{
+    return argmax_by_key( control::getDefault( ), keys_first, keys_last, values_first, keys_output,
+        indices_output, binary_pred, user_code );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2 >
+pair< OutputIterator1, OutputIterator2 >
+argmax_by_key(
+    control &ctl,
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 indices_output,
+    const std::string& user_code )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    return argmax_by_key( ctl, keys_first, keys_last, values_first, keys_output, indices_output,
+        bolt::cl::equal_to< kType >( ), user_code );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2 >
+pair< OutputIterator1, OutputIterator2 >
+argmax_by_key(
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 indices_output,
+    const std::string& user_code )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    return argmax_by_key( control::getDefault( ), keys_first, keys_last, values_first, keys_output,
+        indices_output, bolt::cl::equal_to< kType >( ), user_code );
+}
+
+} // end of cl namespace
+} // end of bolt namespace
+
+#endif
@@ -0,0 +1,818 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_BINARY_SEARCH_INL )
+#define BOLT_CL_BINARY_SEARCH_INL
+#pragma once
+
+#include <algorithm>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/binary_search.h"
+#endif
+
+#define SEARCH_WGSIZE 256
+#define SEARCH_ITEMS_PER_WORKITEM 4
+
+namespace bolt {
+namespace cl {
+
+namespace detail {
+
+//  The values match the SEARCH_ defines of binary_search_kernels.cl
+enum searchModes { search_lower_bound, search_upper_bound, search_binary_search };
+
+}//namespace bolt::cl::detail
+
+/**********************************************************************************************************************
+ * lower_bound
+ *********************************************************************************************************************/
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator lower_bound(control &ctl,
+                           ForwardIterator first,
+                           ForwardIterator last,
+                           InputIterator values_first,
+                           InputIterator values_last,
+                           OutputIterator result,
+                           const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_lower_bound, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator lower_bound(ForwardIterator first,
+                           ForwardIterator last,
+                           InputIterator values_first,
+                           InputIterator values_last,
+                           OutputIterator result,
+                           const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_lower_bound, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator lower_bound(control &ctl,
+                           ForwardIterator first,
+                           ForwardIterator last,
+                           InputIterator values_first,
+                           InputIterator values_last,
+                           OutputIterator result,
+                           StrictWeakOrdering comp,
+                           const std::string& cl_code)
+{
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        comp, detail::search_lower_bound, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator lower_bound(ForwardIterator first,
+                           ForwardIterator last,
+                           InputIterator values_first,
+                           InputIterator values_last,
+                           OutputIterator result,
+                           StrictWeakOrdering comp,
+                           const std::string& cl_code)
+{
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        comp, detail::search_lower_bound, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+/**********************************************************************************************************************
+ * upper_bound
+ *********************************************************************************************************************/
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator upper_bound(control &ctl,
+                           ForwardIterator first,
+                           ForwardIterator last,
+                           InputIterator values_first,
+                           InputIterator values_last,
+                           OutputIterator result,
+                           const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_upper_bound, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator upper_bound(ForwardIterator first,
+                           ForwardIterator last,
+                           InputIterator values_first,
+                           InputIterator values_last,
+                           OutputIterator result,
+                           const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_upper_bound, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator upper_bound(control &ctl,
+                           ForwardIterator first,
+                           ForwardIterator last,
+                           InputIterator values_first,
+                           InputIterator values_last,
+                           OutputIterator result,
+                           StrictWeakOrdering comp,
+                           const std::string& cl_code)
+{
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        comp, detail::search_upper_bound, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator upper_bound(ForwardIterator first,
+                           ForwardIterator last,
+                           InputIterator values_first,
+                           InputIterator values_last,
+                           OutputIterator result,
+                           StrictWeakOrdering comp,
+                           const std::string& cl_code)
+{
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        comp, detail::search_upper_bound, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+/**********************************************************************************************************************
+ * binary_search
+ *********************************************************************************************************************/
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator binary_search(control &ctl,
+                             ForwardIterator first,
+                             ForwardIterator last,
+                             InputIterator values_first,
+                             InputIterator values_last,
+                             OutputIterator result,
+                             const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_binary_search, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator binary_search(ForwardIterator first,
+                             ForwardIterator last,
+                             InputIterator values_first,
+                             InputIterator values_last,
+                             OutputIterator result,
+                             const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_binary_search, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator binary_search(control &ctl,
+                             ForwardIterator first,
+                             ForwardIterator last,
+                             InputIterator values_first,
+                             InputIterator values_last,
+                             OutputIterator result,
+                             StrictWeakOrdering comp,
+                             const std::string& cl_code)
+{
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        comp, detail::search_binary_search, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator binary_search(ForwardIterator first,
+                             ForwardIterator last,
+                             InputIterator values_first,
+                             InputIterator values_last,
+                             OutputIterator result,
+                             StrictWeakOrdering comp,
+                             const std::string& cl_code)
+{
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        comp, detail::search_binary_search, false, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+/**********************************************************************************************************************
+ * lower_bound_sorted
+ *********************************************************************************************************************/
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator lower_bound_sorted(control &ctl,
+                                  ForwardIterator first,
+                                  ForwardIterator last,
+                                  InputIterator values_first,
+                                  InputIterator values_last,
+                                  OutputIterator result,
+                                  const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_lower_bound, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator lower_bound_sorted(ForwardIterator first,
+                                  ForwardIterator last,
+                                  InputIterator values_first,
+                                  InputIterator values_last,
+                                  OutputIterator result,
+                                  const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_lower_bound, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator lower_bound_sorted(control &ctl,
+                                  ForwardIterator first,
+                                  ForwardIterator last,
+                                  InputIterator values_first,
+                                  InputIterator values_last,
+                                  OutputIterator result,
+                                  StrictWeakOrdering comp,
+                                  const std::string& cl_code)
+{
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        comp, detail::search_lower_bound, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator lower_bound_sorted(ForwardIterator first,
+                                  ForwardIterator last,
+                                  InputIterator values_first,
+                                  InputIterator values_last,
+                                  OutputIterator result,
+                                  StrictWeakOrdering comp,
+                                  const std::string& cl_code)
+{
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        comp, detail::search_lower_bound, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+/**********************************************************************************************************************
+ * upper_bound_sorted
+ *********************************************************************************************************************/
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator upper_bound_sorted(control &ctl,
+                                  ForwardIterator first,
+                                  ForwardIterator last,
+                                  InputIterator values_first,
+                                  InputIterator values_last,
+                                  OutputIterator result,
+                                  const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_upper_bound, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator upper_bound_sorted(ForwardIterator first,
+                                  ForwardIterator last,
+                                  InputIterator values_first,
+                                  InputIterator values_last,
+                                  OutputIterator result,
+                                  const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_upper_bound, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator upper_bound_sorted(control &ctl,
+                                  ForwardIterator first,
+                                  ForwardIterator last,
+                                  InputIterator values_first,
+                                  InputIterator values_last,
+                                  OutputIterator result,
+                                  StrictWeakOrdering comp,
+                                  const std::string& cl_code)
+{
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        comp, detail::search_upper_bound, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator upper_bound_sorted(ForwardIterator first,
+                                  ForwardIterator last,
+                                  InputIterator values_first,
+                                  InputIterator values_last,
+                                  OutputIterator result,
+                                  StrictWeakOrdering comp,
+                                  const std::string& cl_code)
+{
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        comp, detail::search_upper_bound, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+/**********************************************************************************************************************
+ * binary_search_sorted
+ *********************************************************************************************************************/
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator binary_search_sorted(control &ctl,
+                                    ForwardIterator first,
+                                    ForwardIterator last,
+                                    InputIterator values_first,
+                                    InputIterator values_last,
+                                    OutputIterator result,
+                                    const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_binary_search, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator>
+OutputIterator binary_search_sorted(ForwardIterator first,
+                                    ForwardIterator last,
+                                    InputIterator values_first,
+                                    InputIterator values_last,
+                                    OutputIterator result,
+                                    const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        less< iType >( ), detail::search_binary_search, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator binary_search_sorted(control &ctl,
+                                    ForwardIterator first,
+                                    ForwardIterator last,
+                                    InputIterator values_first,
+                                    InputIterator values_last,
+                                    OutputIterator result,
+                                    StrictWeakOrdering comp,
+                                    const std::string& cl_code)
+{
+    return detail::search_detect_random_access( ctl, first, last, values_first, values_last, result,
+        comp, detail::search_binary_search, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator binary_search_sorted(ForwardIterator first,
+                                    ForwardIterator last,
+                                    InputIterator values_first,
+                                    InputIterator values_last,
+                                    OutputIterator result,
+                                    StrictWeakOrdering comp,
+                                    const std::string& cl_code)
+{
+    return detail::search_detect_random_access( control::getDefault( ), first, last, values_first, values_last, result,
+        comp, detail::search_binary_search, true, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+namespace bolt {
+namespace cl {
+namespace detail {
+
+enum searchTypes { search_iType, search_iIterType, search_vType, search_vIterType, search_oType, search_oIterType,
+                   search_StrictWeakOrdering, search_end };
+
+class Search_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    Search_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("searchTemplate");
+        addKernelName("searchPartitionTemplate");
+        addKernelName("searchMergeTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value types and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[search_iType] + "* input_ptr,\n"
+            + typeNames[search_iIterType] + " input_iter,\n"
+            "const uint length,\n"
+            "global " + typeNames[search_vType] + "* values_ptr,\n"
+            + typeNames[search_vIterType] + " values_iter,\n"
+            "const uint numValues,\n"
+            "global " + typeNames[search_oType] + "* result_ptr,\n"
+            + typeNames[search_oIterType] + " result_iter,\n"
+            "const uint mode,\n"
+            "local " + typeNames[search_iType] + "* samples,\n"
+            "global " + typeNames[search_StrictWeakOrdering] + "* lessOp\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value types and functor\n"
+            "template __attribute__((mangled_name(" + name(1) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(1) + "(\n"
+            "global " + typeNames[search_iType] + "* input_ptr,\n"
+            + typeNames[search_iIterType] + " input_iter,\n"
+            "const uint length,\n"
+            "global " + typeNames[search_vType] + "* values_ptr,\n"
+            + typeNames[search_vIterType] + " values_iter,\n"
+            "const uint numValues,\n"
+            "const uint tileSize,\n"
+            "const uint numBoundaries,\n"
+            "global uint* splits,\n"
+            "const uint mode,\n"
+            "global " + typeNames[search_StrictWeakOrdering] + "* lessOp\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value types and functor\n"
+            "template __attribute__((mangled_name(" + name(2) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(2) + "(\n"
+            "global " + typeNames[search_iType] + "* input_ptr,\n"
+            + typeNames[search_iIterType] + " input_iter,\n"
+            "const uint length,\n"
+            "global " + typeNames[search_vType] + "* values_ptr,\n"
+            + typeNames[search_vIterType] + " values_iter,\n"
+            "const uint numValues,\n"
+            "global " + typeNames[search_oType] + "* result_ptr,\n"
+            + typeNames[search_oIterType] + " result_iter,\n"
+            "global uint* splits,\n"
+            "const uint mode,\n"
+            "local " + typeNames[search_iType] + "* ldsInput,\n"
+            "local " + typeNames[search_vType] + "* ldsValues,\n"
+            "global " + typeNames[search_StrictWeakOrdering] + "* lessOp\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  All device searches end up here.  Independent values go through searchTemplate; sorted values are merged with
+//  the range by searchPartitionTemplate and searchMergeTemplate.
+template< typename DVForwardIterator, typename DVInputIterator, typename DVOutputIterator,
+          typename StrictWeakOrdering >
+void search_enqueue( control &ctl, const DVForwardIterator& first, const DVForwardIterator& last,
+                     const DVInputIterator& values_first, const DVInputIterator& values_last,
+                     const DVOutputIterator& result, const StrictWeakOrdering& comp, searchModes mode, bool sorted,
+                     const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVForwardIterator >::value_type iType;
+    typedef typename std::iterator_traits< DVInputIterator >::value_type vType;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    cl_int l_Error = CL_SUCCESS;
+    cl_uint length = static_cast< cl_uint >( first.distance_to( last ) );
+    cl_uint numValues = static_cast< cl_uint >( values_first.distance_to( values_last ) );
+    cl_uint clMode = static_cast< cl_uint >( mode );
+
+    std::vector< std::string > typeNames( search_end );
+    typeNames[ search_iType ] = TypeName< iType >::get( );
+    typeNames[ search_iIterType ] = TypeName< DVForwardIterator >::get( );
+    typeNames[ search_vType ] = TypeName< vType >::get( );
+    typeNames[ search_vIterType ] = TypeName< DVInputIterator >::get( );
+    typeNames[ search_oType ] = TypeName< oType >::get( );
+    typeNames[ search_oIterType ] = TypeName< DVOutputIterator >::get( );
+    typeNames[ search_StrictWeakOrdering ] = TypeName< StrictWeakOrdering >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVForwardIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< vType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< oType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOutputIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< StrictWeakOrdering >::get( ) )
+
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << SEARCH_WGSIZE;
+    oss << " -DSEARCH_ITEMS_PER_WORKITEM=" << SEARCH_ITEMS_PER_WORKITEM;
+
+    Search_KernelTemplateSpecializer search_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &search_kts, typeDefinitions,
+                                                                binary_search_kernels, oss.str( ) );
+
+    ALIGNED( 256 ) StrictWeakOrdering aligned_comp( comp );
+    control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_comp ),
+                                                          CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_comp );
+
+    ::cl::Event searchEvent;
+    if( !sorted )
+    {
+        //  Every work-group pays for loading its sample once, so launch just enough of them to fill the device
+        cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+        size_t numWG = computeUnits * ctl.getWGPerComputeUnit( );
+        numWG = std::max< size_t >( 1, std::min< size_t >( numWG, ( numValues + SEARCH_WGSIZE - 1 ) / SEARCH_WGSIZE ) );
+
+        ::cl::LocalSpaceArg ldsSamples;
+        ldsSamples.size_ = SEARCH_WGSIZE * sizeof( iType );
+
+        V_OPENCL( kernels[ 0 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+                  "Error setting a kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 2, length ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 3, values_first.getContainer( ).getBuffer( ) ),
+                  "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 4, values_first.gpuPayloadSize( ), &values_first.gpuPayload( ) ),
+                  "Error setting a kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 5, numValues ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 6, result.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 7, result.gpuPayloadSize( ), &result.gpuPayload( ) ),
+                  "Error setting a kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 8, clMode ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 9, ldsSamples ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 10, *userFunctor ), "Error setting kernel argument" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 0 ],
+            ::cl::NullRange,
+            ::cl::NDRange( numWG * SEARCH_WGSIZE ),
+            ::cl::NDRange( SEARCH_WGSIZE ),
+            NULL,
+            &searchEvent );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for search kernel" );
+        bolt::cl::wait( ctl, searchEvent );
+        return;
+    }
+
+    //  Every work-group walks one tile of the merge path; the tile boundaries are placed on the merge path first
+    cl_uint tileSize = SEARCH_WGSIZE * SEARCH_ITEMS_PER_WORKITEM;
+    cl_uint numTiles = ( length + numValues + tileSize - 1 ) / tileSize;
+    cl_uint numBoundaries = numTiles + 1;
+    size_t partitionThreads = ( ( numBoundaries + SEARCH_WGSIZE - 1 ) / SEARCH_WGSIZE ) * SEARCH_WGSIZE;
+
+    device_vector< cl_uint > dvSplits( numBoundaries, 0, CL_MEM_READ_WRITE, false, ctl );
+
+    V_OPENCL( kernels[ 1 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 2, length ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 3, values_first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 4, values_first.gpuPayloadSize( ), &values_first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 5, numValues ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 6, tileSize ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 7, numBoundaries ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 8, dvSplits.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 9, clMode ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 10, *userFunctor ), "Error setting kernel argument" );
+
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 1 ],
+        ::cl::NullRange,
+        ::cl::NDRange( partitionThreads ),
+        ::cl::NDRange( SEARCH_WGSIZE ) );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for searchPartition kernel" );
+
+    ::cl::LocalSpaceArg ldsInput;
+    ldsInput.size_ = tileSize * sizeof( iType );
+    ::cl::LocalSpaceArg ldsValues;
+    ldsValues.size_ = tileSize * sizeof( vType );
+
+    V_OPENCL( kernels[ 2 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 2, length ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 3, values_first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 4, values_first.gpuPayloadSize( ), &values_first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 5, numValues ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 6, result.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 7, result.gpuPayloadSize( ), &result.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 8, dvSplits.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 9, clMode ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 10, ldsInput ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 11, ldsValues ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 12, *userFunctor ), "Error setting kernel argument" );
+
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 2 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numTiles * SEARCH_WGSIZE ),
+        ::cl::NDRange( SEARCH_WGSIZE ),
+        NULL,
+        &searchEvent );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for searchMerge kernel" );
+    bolt::cl::wait( ctl, searchEvent );
+}
+
+//  Serial searches.  Sorted values are merged with the range: the bound of every value is where the previous one
+//  stopped, plus the elements of the range that lie before it.
+template< typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+void serialCPU_search( ForwardIterator first, ForwardIterator last, InputIterator values_first, size_t numValues,
+                       OutputIterator result, const StrictWeakOrdering& comp, searchModes mode, bool sorted )
+{
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+    ForwardIterator bound = first;
+    for( size_t i = 0; i < numValues; ++i )
+    {
+        if( sorted )
+        {
+            if( mode == search_upper_bound )
+                while( bound != last && !comp( values_first[ i ], *bound ) )
+                    ++bound;
+            else
+                while( bound != last && comp( *bound, values_first[ i ] ) )
+                    ++bound;
+        }
+        else if( mode == search_upper_bound )
+            bound = std::upper_bound( first, last, values_first[ i ], comp );
+        else
+            bound = std::lower_bound( first, last, values_first[ i ], comp );
+
+        if( mode == search_binary_search )
+            result[ i ] = static_cast< oType >( bound != last && !comp( values_first[ i ], *bound ) );
+        else
+            result[ i ] = static_cast< oType >( bound - first );
+    }
+}
+
+template< typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+void search_cpu( bolt::cl::control::e_RunMode runMode, ForwardIterator first, ForwardIterator last,
+                 InputIterator values_first, size_t numValues, OutputIterator result,
+                 const StrictWeakOrdering& comp, searchModes mode, bool sorted )
+{
+    if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        bolt::btbb::detail::searchModes tbbMode = static_cast< bolt::btbb::detail::searchModes >( mode );
+        if( sorted )
+            bolt::btbb::detail::search_sorted( first, last, values_first, values_first + numValues, result, tbbMode,
+                                               comp );
+        else
+            bolt::btbb::detail::search( first, last, values_first, values_first + numValues, result, tbbMode, comp );
+#else
+        throw std::exception( "The MultiCoreCpu version of the batched searches is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        serialCPU_search( first, last, values_first, numValues, result, comp, mode, sorted );
+    }
+}
+
+template< typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+OutputIterator search_detect_random_access( control &ctl, const ForwardIterator& first, const ForwardIterator& last,
+                                            const InputIterator& values_first, const InputIterator& values_last,
+                                            const OutputIterator& result, const StrictWeakOrdering& comp,
+                                            searchModes mode, bool sorted, const std::string& cl_code,
+                                            std::input_iterator_tag )
+{
+    //  \TODO:  It should be possible to support non-random_access_iterator_tag iterators, if we copied the data
+    //  to a temporary buffer.  Should we?
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+OutputIterator search_detect_random_access( control &ctl, const ForwardIterator& first, const ForwardIterator& last,
+                                            const InputIterator& values_first, const InputIterator& values_last,
+                                            const OutputIterator& result, const StrictWeakOrdering& comp,
+                                            searchModes mode, bool sorted, const std::string& cl_code,
+                                            bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "Fancy iterators are not supported by the batched searches" );
+};
+
+template< typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+OutputIterator search_detect_random_access( control &ctl, const ForwardIterator& first, const ForwardIterator& last,
+                                            const InputIterator& values_first, const InputIterator& values_last,
+                                            const OutputIterator& result, const StrictWeakOrdering& comp,
+                                            searchModes mode, bool sorted, const std::string& cl_code,
+                                            std::random_access_iterator_tag )
+{
+    size_t numValues = static_cast< size_t >( std::distance( values_first, values_last ) );
+    if( numValues == 0 )
+        return result;
+
+    search_pick_iterator( ctl, first, last, values_first, values_last, result, comp, mode, sorted, cl_code,
+                         std::iterator_traits< ForwardIterator >::iterator_category( ) );
+    return result + numValues;
+};
+
+//Device Vector specialization; the values and the output have to live in device_vectors as well
+template< typename DVForwardIterator, typename DVInputIterator, typename DVOutputIterator,
+          typename StrictWeakOrdering >
+void search_pick_iterator( control &ctl, const DVForwardIterator& first, const DVForwardIterator& last,
+                           const DVInputIterator& values_first, const DVInputIterator& values_last,
+                           const DVOutputIterator& result, const StrictWeakOrdering& comp,
+                           searchModes mode, bool sorted, const std::string& cl_code,
+                           bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVForwardIterator >::value_type iType;
+    typedef typename std::iterator_traits< DVInputIterator >::value_type vType;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    //  Every answer is 0 for an empty range; there is nothing to search on the device
+    if( first == last && runMode != bolt::cl::control::MultiCoreCpu )
+    {
+        runMode = bolt::cl::control::SerialCpu;
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< iType >::pointer firstPtr = first.getContainer( ).data( );
+        bolt::cl::device_vector< vType >::pointer valuesPtr = values_first.getContainer( ).data( );
+        bolt::cl::device_vector< oType >::pointer resultPtr = result.getContainer( ).data( );
+        search_cpu( runMode, &firstPtr[ first.m_Index ], &firstPtr[ last.m_Index ], &valuesPtr[ values_first.m_Index ],
+                    static_cast< size_t >( values_last - values_first ), &resultPtr[ result.m_Index ], comp, mode,
+                    sorted );
+        return;
+    }
+
+    search_enqueue( ctl, first, last, values_first, values_last, result, comp, mode, sorted, cl_code );
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in device_vectors and calls the device_vector specialization.
+template< typename ForwardIterator, typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+void search_pick_iterator( control &ctl, const ForwardIterator& first, const ForwardIterator& last,
+                           const InputIterator& values_first, const InputIterator& values_last,
+                           const OutputIterator& result, const StrictWeakOrdering& comp,
+                           searchModes mode, bool sorted, const std::string& cl_code,
+                           std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+    typedef typename std::iterator_traits< InputIterator >::value_type vType;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+    size_t numValues = static_cast< size_t >( values_last - values_first );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    //  An empty range cannot be wrapped in a device_vector; every answer is 0 anyway
+    if( first == last && runMode != bolt::cl::control::MultiCoreCpu )
+    {
+        runMode = bolt::cl::control::SerialCpu;
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        search_cpu( runMode, first, last, values_first, numValues, result, comp, mode, sorted );
+        return;
+    }
+
+    device_vector< iType > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+    device_vector< vType > dvValues( values_first, values_last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+    device_vector< oType > dvOutput( result, numValues, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
+    search_enqueue( ctl, dvInput.begin( ), dvInput.end( ), dvValues.begin( ), dvValues.end( ), dvOutput.begin( ),
+                    comp, mode, sorted, cl_code );
+    //Map the buffer back to the host
+    dvOutput.data( );
+}
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
@@ -0,0 +1,579 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_COPY_IF_INL )
+#define BOLT_CL_COPY_IF_INL
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/scan.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/copy_if.h"
+#endif
+
+#define COPY_IF_WGSIZE 256
+
+namespace bolt {
+namespace cl {
+
+/**********************************************************************************************************************
+ * copy_if
+ *********************************************************************************************************************/
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator copy_if(control &ctl,
+                       InputIterator first,
+                       InputIterator last,
+                       OutputIterator result,
+                       Predicate pred,
+                       const std::string& cl_code)
+{
+    return detail::copy_if_detect_random_access( ctl, first, last, result, pred, true, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator copy_if(InputIterator first,
+                       InputIterator last,
+                       OutputIterator result,
+                       Predicate pred,
+                       const std::string& cl_code)
+{
+    return copy_if( control::getDefault( ), first, last, result, pred, cl_code );
+}
+
+/**********************************************************************************************************************
+ * remove_copy_if
+ *********************************************************************************************************************/
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator remove_copy_if(control &ctl,
+                              InputIterator first,
+                              InputIterator last,
+                              OutputIterator result,
+                              Predicate pred,
+                              const std::string& cl_code)
+{
+    return detail::copy_if_detect_random_access( ctl, first, last, result, pred, false, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OutputIterator, typename Predicate>
+OutputIterator remove_copy_if(InputIterator first,
+                              InputIterator last,
+                              OutputIterator result,
+                              Predicate pred,
+                              const std::string& cl_code)
+{
+    return remove_copy_if( control::getDefault( ), first, last, result, pred, cl_code );
+}
+
+/**********************************************************************************************************************
+ * remove_if
+ *********************************************************************************************************************/
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator remove_if(control &ctl,
+                          ForwardIterator first,
+                          ForwardIterator last,
+                          Predicate pred,
+                          const std::string& cl_code)
+{
+    return detail::remove_if_detect_random_access( ctl, first, last, pred, cl_code,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator remove_if(ForwardIterator first,
+                          ForwardIterator last,
+                          Predicate pred,
+                          const std::string& cl_code)
+{
+    return remove_if( control::getDefault( ), first, last, pred, cl_code );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+namespace bolt {
+namespace cl {
+namespace detail {
+
+enum copyIfTypes { copyIf_iType, copyIf_iIterType, copyIf_oType, copyIf_oIterType, copyIf_Predicate,
+                   copyIf_end };
+
+class CopyIf_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    CopyIf_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("copyIfCountTemplate");
+        addKernelName("copyIfTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[copyIf_iType] + "* input_ptr,\n"
+            + typeNames[copyIf_iIterType] + " input_iter,\n"
+            "const uint vecSize,\n"
+            "global " + typeNames[copyIf_Predicate] + "* pred,\n"
+            "int keepSelected,\n"
+            "local uint* ldsCounts,\n"
+            "global uint* tileCounts\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(1) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(1) + "(\n"
+            "global " + typeNames[copyIf_iType] + "* input_ptr,\n"
+            + typeNames[copyIf_iIterType] + " input_iter,\n"
+            "const uint vecSize,\n"
+            "global " + typeNames[copyIf_oType] + "* output_ptr,\n"
+            + typeNames[copyIf_oIterType] + " output_iter,\n"
+            "global " + typeNames[copyIf_oType] + "* rejected,\n"
+            "global " + typeNames[copyIf_Predicate] + "* pred,\n"
+            "int keepSelected,\n"
+            "int keepRejected,\n"
+            "local " + typeNames[copyIf_iType] + "* ldsValues,\n"
+            "local uint* ldsCounts,\n"
+            "global uint* tileStatus,\n"
+            "global uint* tileValues,\n"
+            "global uint* tileOffsets,\n"
+            "int singlePass,\n"
+            "global uint* selectedCount\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  Compile options shared by every kernel of copy_if_kernels.cl
+inline std::string copyIfCompileOptions( cl_uint itemsPerWorkItem )
+{
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << COPY_IF_WGSIZE;
+    oss << " -DCOPY_IF_ITEMS_PER_WORKITEM=" << itemsPerWorkItem;
+    return oss.str( );
+}
+
+//  All device compactions end up here; the return value is the number of kept elements.  Elements for which the
+//  predicate equals keepSelected are kept.  When rejected is given, the other elements are written backwards from
+//  the end of that buffer, which has to hold as many elements as the input.  Devices that can chain tiles compact in
+//  a single pass, and in place if result is first; the others count the tiles and scan the counts first, and must
+//  not compact in place.
+template< typename DVInputIterator, typename DVOutputIterator, typename Predicate >
+cl_uint copy_if_enqueue( control &ctl,
+                         const DVInputIterator& first, const DVInputIterator& last,
+                         const DVOutputIterator& result, const ::cl::Buffer* rejected,
+                         const Predicate& pred, bool keepSelected, const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    cl_int l_Error = CL_SUCCESS;
+    cl_uint numElements = static_cast< cl_uint >( first.distance_to( last ) );
+
+    std::vector< std::string > typeNames( copyIf_end );
+    typeNames[ copyIf_iType ] = TypeName< iType >::get( );
+    typeNames[ copyIf_iIterType ] = TypeName< DVInputIterator >::get( );
+    typeNames[ copyIf_oType ] = TypeName< oType >::get( );
+    typeNames[ copyIf_oIterType ] = TypeName< DVOutputIterator >::get( );
+    typeNames[ copyIf_Predicate ] = TypeName< Predicate >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< oType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOutputIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< Predicate >::get( ) )
+
+    const cl_uint itemsPerWorkItem = singlePassScanItemsPerWorkItem( ctl, sizeof( iType ), COPY_IF_WGSIZE );
+
+    CopyIf_KernelTemplateSpecializer copyIf_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &copyIf_kts, typeDefinitions,
+                                                                lookback_kernels + copy_if_kernels,
+                                                                copyIfCompileOptions( itemsPerWorkItem ) );
+
+    const size_t tileSize = COPY_IF_WGSIZE * itemsPerWorkItem;
+    cl_uint numTiles = static_cast< cl_uint >( ( numElements + tileSize - 1 ) / tileSize );
+    bool singlePass = supportsSinglePassScan( ctl );
+
+    ALIGNED( 256 ) Predicate aligned_pred( pred );
+    control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_pred ),
+                                                          CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_pred );
+    control::buffPointer selectedCount = ctl.acquireBuffer( sizeof( cl_uint ) );
+    cl_int doKeepSelected = keepSelected ? 1 : 0;
+
+    //  The look-back needs zeroed tile states; the two-pass path needs the scanned tile counts instead
+    control::buffPointer tileStatus = ctl.acquireBuffer( ( numTiles + 1 ) * sizeof( cl_uint ) );
+    control::buffPointer tileValues = ctl.acquireBuffer( 2 * numTiles * sizeof( cl_uint ) );
+    device_vector< cl_uint > dvTileOffsets( singlePass ? 1 : numTiles, 0, CL_MEM_READ_WRITE, false, ctl );
+    ::cl::Event prepareEvent;
+    if( singlePass )
+    {
+        l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *tileStatus, 0, 0, ( numTiles + 1 ) * sizeof( cl_uint ),
+            NULL, &prepareEvent );
+        V_OPENCL( l_Error, "enqueueFillBuffer() failed for the copy_if tile status" );
+    }
+    else
+    {
+        V_OPENCL( kernels[ 0 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+                  "Error setting a kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 2, numElements ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 3, *userFunctor ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 4, doKeepSelected ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 5, COPY_IF_WGSIZE * sizeof( cl_uint ), NULL ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 0 ].setArg( 6, dvTileOffsets.getBuffer( ) ), "Error setting kernel argument" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 0 ],
+            ::cl::NullRange,
+            ::cl::NDRange( numTiles * COPY_IF_WGSIZE ),
+            ::cl::NDRange( COPY_IF_WGSIZE ),
+            NULL,
+            &prepareEvent );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for copyIfCount kernel" );
+        bolt::cl::wait( ctl, prepareEvent );
+
+        bolt::cl::inclusive_scan( ctl, dvTileOffsets.begin( ), dvTileOffsets.end( ), dvTileOffsets.begin( ),
+            plus< cl_uint >( ) );
+    }
+
+    cl_int doKeepRejected = rejected ? 1 : 0;
+    cl_int doSinglePass = singlePass ? 1 : 0;
+    cl_uint arg = 0;
+    V_OPENCL( kernels[ 1 ].setArg( arg++, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, numElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, result.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, result.gpuPayloadSize( ), &result.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, rejected ? *rejected : result.getContainer( ).getBuffer( ) ),
+              "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, *userFunctor ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, doKeepSelected ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, doKeepRejected ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, tileSize * sizeof( iType ), NULL ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, COPY_IF_WGSIZE * sizeof( cl_uint ), NULL ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, *tileStatus ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, *tileValues ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, dvTileOffsets.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, doSinglePass ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( arg++, *selectedCount ), "Error setting kernel argument" );
+
+    std::vector< ::cl::Event > prepareEvents;
+    if( singlePass )
+        prepareEvents.push_back( prepareEvent );
+    ::cl::Event copyEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 1 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numTiles * COPY_IF_WGSIZE ),
+        ::cl::NDRange( COPY_IF_WGSIZE ),
+        singlePass ? &prepareEvents : NULL,
+        &copyEvent );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for copyIf kernel" );
+    bolt::cl::wait( ctl, copyEvent );
+
+    cl_uint numSelected = 0;
+    l_Error = ctl.getCommandQueue( ).enqueueReadBuffer( *selectedCount, CL_TRUE, 0, sizeof( cl_uint ),
+        &numSelected );
+    V_OPENCL( l_Error, "enqueueReadBuffer() failed for the copy_if count" );
+    return numSelected;
+}
+
+//  remove_if on the device; the two-pass path cannot compact in place, so it goes through a scratch buffer
+template< typename DVForwardIterator, typename Predicate >
+cl_uint remove_if_enqueue( control &ctl, const DVForwardIterator& first, const DVForwardIterator& last,
+                           const Predicate& pred, const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVForwardIterator >::value_type iType;
+
+    if( supportsSinglePassScan( ctl ) )
+        return copy_if_enqueue( ctl, first, last, first, NULL, pred, false, cl_code );
+
+    cl_uint numElements = static_cast< cl_uint >( first.distance_to( last ) );
+    device_vector< iType > dvKept( numElements, iType( ), CL_MEM_READ_WRITE, false, ctl );
+    cl_uint numKept = copy_if_enqueue( ctl, first, last, dvKept.begin( ), NULL, pred, false, cl_code );
+    if( numKept == 0 )
+        return 0;
+
+    ::cl::Event copyEvent;
+    cl_int l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( dvKept.getBuffer( ), first.getContainer( ).getBuffer( ),
+        0, first.m_Index * sizeof( iType ), numKept * sizeof( iType ), NULL, &copyEvent );
+    V_OPENCL( l_Error, "enqueueCopyBuffer() failed for remove_if" );
+    bolt::cl::wait( ctl, copyEvent );
+    return numKept;
+}
+
+template< typename InputIterator, typename OutputIterator, typename Predicate >
+OutputIterator copy_if_cpu( bolt::cl::control::e_RunMode runMode, InputIterator first, InputIterator last,
+                            OutputIterator result, const Predicate& pred, bool keepSelected )
+{
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        return keepSelected ? std::copy_if( first, last, result, pred )
+                            : std::remove_copy_if( first, last, result, pred );
+    }
+    else
+    {
+#ifdef ENABLE_TBB
+        return keepSelected ? bolt::btbb::copy_if( first, last, result, pred )
+                            : bolt::btbb::remove_copy_if( first, last, result, pred );
+#else
+        throw std::exception( "The MultiCoreCpu version of copy_if is not enabled to be built! \n" );
+#endif
+    }
+}
+
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator remove_if_cpu( bolt::cl::control::e_RunMode runMode, ForwardIterator first, ForwardIterator last,
+                               const Predicate& pred )
+{
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        return std::remove_if( first, last, pred );
+    }
+    else
+    {
+#ifdef ENABLE_TBB
+        return bolt::btbb::remove_if( first, last, pred );
+#else
+        throw std::exception( "The MultiCoreCpu version of remove_if is not enabled to be built! \n" );
+#endif
+    }
+}
+
+template< typename InputIterator, typename OutputIterator, typename Predicate >
+OutputIterator copy_if_detect_random_access( control &ctl,
+                                             const InputIterator& first, const InputIterator& last,
+                                             const OutputIterator& result, const Predicate& pred,
+                                             bool keepSelected, const std::string& cl_code,
+                                             std::input_iterator_tag )
+{
+    //  \TODO:  It should be possible to support non-random_access_iterator_tag iterators, if we copied the data
+    //  to a temporary buffer.  Should we?
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator, typename OutputIterator, typename Predicate >
+OutputIterator copy_if_detect_random_access( control &ctl,
+                                             const InputIterator& first, const InputIterator& last,
+                                             const OutputIterator& result, const Predicate& pred,
+                                             bool keepSelected, const std::string& cl_code,
+                                             bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "Fancy iterators are not supported by copy_if" );
+};
+
+template< typename InputIterator, typename OutputIterator, typename Predicate >
+OutputIterator copy_if_detect_random_access( control &ctl,
+                                             const InputIterator& first, const InputIterator& last,
+                                             const OutputIterator& result, const Predicate& pred,
+                                             bool keepSelected, const std::string& cl_code,
+                                             std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type iType;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+    static_assert( std::is_convertible< iType, oType >::value, "Input and Output iterators are incompatible" );
+
+    if( std::distance( first, last ) == 0 )
+        return result;
+
+    return copy_if_pick_iterator( ctl, first, last, result, pred, keepSelected, cl_code,
+                                  std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+//Device Vector specialization; the output has to live in a device_vector as well
+template< typename DVInputIterator, typename DVOutputIterator, typename Predicate >
+DVOutputIterator copy_if_pick_iterator( control &ctl,
+                                        const DVInputIterator& first, const DVInputIterator& last,
+                                        const DVOutputIterator& result, const Predicate& pred,
+                                        bool keepSelected, const std::string& cl_code,
+                                        bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        size_t szElements = static_cast< size_t >( last - first );
+        bolt::cl::device_vector< iType >::pointer firstPtr = first.getContainer( ).data( );
+        bolt::cl::device_vector< oType >::pointer resultPtr = result.getContainer( ).data( );
+        oType* resultEnd = copy_if_cpu( runMode, &firstPtr[ first.m_Index ], &firstPtr[ first.m_Index ] + szElements,
+                                        &resultPtr[ result.m_Index ], pred, keepSelected );
+        return result + ( resultEnd - &resultPtr[ result.m_Index ] );
+    }
+    else
+    {
+        return result + copy_if_enqueue( ctl, first, last, result, NULL, pred, keepSelected, cl_code );
+    }
+}
+
+//Non Device Vector specialization.
+//The input is wrapped in a device_vector; the output goes to a device buffer as large as the input, and only the
+//kept elements are read back, since the host range only has to hold those.
+template< typename InputIterator, typename OutputIterator, typename Predicate >
+OutputIterator copy_if_pick_iterator( control &ctl,
+                                      const InputIterator& first, const InputIterator& last,
+                                      const OutputIterator& result, const Predicate& pred,
+                                      bool keepSelected, const std::string& cl_code,
+                                      std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type iType;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        return copy_if_cpu( runMode, first, last, result, pred, keepSelected );
+    }
+    else
+    {
+        size_t szElements = static_cast< size_t >( last - first );
+        device_vector< iType > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< oType > dvOutput( szElements, oType( ), CL_MEM_READ_WRITE, false, ctl );
+        cl_uint numSelected = copy_if_enqueue( ctl, dvInput.begin( ), dvInput.end( ), dvOutput.begin( ), NULL, pred,
+                                               keepSelected, cl_code );
+        if( numSelected > 0 )
+        {
+            cl_int l_Error = ctl.getCommandQueue( ).enqueueReadBuffer( dvOutput.getBuffer( ), CL_TRUE, 0,
+                numSelected * sizeof( oType ), &(*result) );
+            V_OPENCL( l_Error, "enqueueReadBuffer() failed for the copy_if output" );
+        }
+        return result + numSelected;
+    }
+}
+
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator remove_if_detect_random_access( control &ctl,
+                                                const ForwardIterator& first, const ForwardIterator& last,
+                                                const Predicate& pred, const std::string& cl_code,
+                                                std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator remove_if_detect_random_access( control &ctl,
+                                                const ForwardIterator& first, const ForwardIterator& last,
+                                                const Predicate& pred, const std::string& cl_code,
+                                                bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "It is not possible to remove from fancy iterators; they are not mutable" );
+};
+
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator remove_if_detect_random_access( control &ctl,
+                                                const ForwardIterator& first, const ForwardIterator& last,
+                                                const Predicate& pred, const std::string& cl_code,
+                                                std::random_access_iterator_tag )
+{
+    if( std::distance( first, last ) == 0 )
+        return first;
+
+    return remove_if_pick_iterator( ctl, first, last, pred, cl_code,
+                                    std::iterator_traits< ForwardIterator >::iterator_category( ) );
+};
+
+//Device Vector specialization
+template< typename DVForwardIterator, typename Predicate >
+DVForwardIterator remove_if_pick_iterator( control &ctl,
+                                           const DVForwardIterator& first, const DVForwardIterator& last,
+                                           const Predicate& pred, const std::string& cl_code,
+                                           bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVForwardIterator >::value_type iType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        size_t szElements = static_cast< size_t >( last - first );
+        bolt::cl::device_vector< iType >::pointer firstPtr = first.getContainer( ).data( );
+        iType* newEnd = remove_if_cpu( runMode, &firstPtr[ first.m_Index ], &firstPtr[ first.m_Index ] + szElements,
+                                       pred );
+        return first + ( newEnd - &firstPtr[ first.m_Index ] );
+    }
+    else
+    {
+        return first + remove_if_enqueue( ctl, first, last, pred, cl_code );
+    }
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in a device_vector and maps it back when done.
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator remove_if_pick_iterator( control &ctl,
+                                         const ForwardIterator& first, const ForwardIterator& last,
+                                         const Predicate& pred, const std::string& cl_code,
+                                         std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        return remove_if_cpu( runMode, first, last, pred );
+    }
+    else
+    {
+        device_vector< iType > dvRange( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, ctl );
+        cl_uint numKept = remove_if_enqueue( ctl, dvRange.begin( ), dvRange.end( ), pred, cl_code );
+        //Map the buffer back to the host
+        dvRange.data( );
+        return first + numKept;
+    }
+}
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
@@ -59,6 +59,38 @@ namespace bolt {
 
         }
 
+        // The CPU paths count on the host and write the count to the scalar; the OpenCL path finishes the count on
+        // the device and does not wait for it.
+       template<typename InputIterator, typename Predicate>
+        void count_if(control& ctl, InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            device_scalar< int >& result,
+            const std::string& cl_code)
+        {
+            bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();
+            if(runMode == bolt::cl::control::Automatic)
+            {
+                runMode = ctl.getDefaultPathToRun();
+            }
+            if (runMode == bolt::cl::control::OpenCL && first != last) {
+                detail::count_pick_iterator(ctl, first, last, predicate, result, cl_code,
+                    std::iterator_traits< InputIterator >::iterator_category( ) );
+            } else {
+                result.set( static_cast< int >( count_if(ctl, first, last, predicate, cl_code) ) );
+            }
+        }
+
+       template<typename InputIterator, typename Predicate>
+        void count_if( InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            device_scalar< int >& result,
+            const std::string& cl_code)
+        {
+            count_if(bolt::cl::control::getDefault(), first, last, predicate, result, cl_code);
+        }
+
 
     }
 
@@ -103,15 +135,17 @@ namespace bolt {
             };
 
             //----
-            // This is the base implementation of reduction that is called by all of the convenience wrappers below.
-            // first and last must be iterators from a DeviceVector
+            // Enqueues the count within the work-groups, which leaves one partial count per work-group in the
+            // returned buffer; numPartials receives the number of work-groups that wrote one.  userFunctor holds a
+            // copy of predicate.
             template<typename DVInputIterator, typename Predicate>
-            typename bolt::cl::iterator_traits<DVInputIterator>::difference_type
-                count_enqueue(bolt::cl::control &ctl,
+            control::buffPointer count_partials_enqueue(bolt::cl::control &ctl,
                 const DVInputIterator& first,
                 const DVInputIterator& last,
                 const Predicate& predicate,
-                const std::string& cl_code )
+                const ::cl::Buffer& userFunctor,
+                const std::string& cl_code,
+                size_t& numPartials )
             {
                 typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
                 typedef typename bolt::cl::iterator_traits<DVInputIterator>::difference_type rType;
@@ -152,20 +186,10 @@ namespace bolt {
                     ctl.getDevice( ), &l_Error );
                 V_OPENCL( l_Error, "Error querying kernel for CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE" );
 
-                // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
-                ALIGNED( 256 ) Predicate aligned_count( predicate );
-
-               //::cl::Buffer userFunctor(ctl.context(), CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, sizeof( aligned_count ),
-
-                //  &aligned_count );
-                control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_count ),
-                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_count );
-
-
                 //::cl::Buffer result(ctl.context(), CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY, sizeof( iType ) * numWG);
 
                 control::buffPointer result = ctl.acquireBuffer( sizeof( int ) * numWG,
-                    CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
+                    CL_MEM_ALLOC_HOST_PTR|CL_MEM_READ_WRITE );
 
                 cl_uint szElements = static_cast< cl_uint >( first.distance_to(last ) );
 
@@ -175,7 +199,7 @@ namespace bolt {
                     "Error setting a kernel argument" );
 
                 V_OPENCL( kernels[0].setArg(2, szElements), "Error setting kernel argument" );
-                V_OPENCL( kernels[0].setArg(3, *userFunctor), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(3, userFunctor), "Error setting kernel argument" );
                 V_OPENCL( kernels[0].setArg(4, *result), "Error setting kernel argument" );
 
                 ::cl::LocalSpaceArg loc2;
@@ -190,17 +214,43 @@ namespace bolt {
                     ::cl::NDRange(wgSize));
                 V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for count() kernel" );
 
+                //  The compute device counts within the workgroups, with one result per workgroup
+                size_t ceilNumWG = static_cast< size_t >( std::ceil( static_cast< float >( szElements ) / wgSize) );
+                bolt::cl::minimum<size_t>  count_size_t;
+                numPartials = count_size_t( ceilNumWG, numWG );
+
+                return result;
+            }
+
+            //----
+            // This is the base implementation of reduction that is called by all of the convenience wrappers below.
+            // first and last must be iterators from a DeviceVector
+            template<typename DVInputIterator, typename Predicate>
+            typename bolt::cl::iterator_traits<DVInputIterator>::difference_type
+                count_enqueue(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const Predicate& predicate,
+                const std::string& cl_code )
+            {
+                typedef typename bolt::cl::iterator_traits<DVInputIterator>::difference_type rType;
+
+                // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
+                ALIGNED( 256 ) Predicate aligned_count( predicate );
+                control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_count ),
+                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_count );
+
+                size_t numTailReduce = 0;
+                control::buffPointer result = count_partials_enqueue( ctl, first, last, predicate, *userFunctor,
+                    cl_code, numTailReduce );
+
+                cl_int l_Error = CL_SUCCESS;
                 ::cl::Event l_mapEvent;
                 int *h_result = (int*)ctl.getCommandQueue().enqueueMapBuffer(*result, false, CL_MAP_READ, 0,
-                    sizeof(int)*numWG, NULL, &l_mapEvent, &l_Error );
+                    sizeof(int)*numTailReduce, NULL, &l_mapEvent, &l_Error );
                 V_OPENCL( l_Error, "Error calling map on the result buffer" );
 
-                //  Finish the tail end of the reduction on host side; the compute device counts within the workgroups,
-                //  with one result per workgroup
-                size_t ceilNumWG = static_cast< size_t >( std::ceil( static_cast< float >( szElements ) / wgSize) );
-                bolt::cl::minimum<size_t>  count_size_t;
-                size_t numTailReduce = count_size_t( ceilNumWG, numWG );
-
+                //  Finish the tail end of the reduction on host side
                 bolt::cl::wait(ctl, l_mapEvent);
 
                 rType count =  h_result[0] ;
@@ -221,6 +271,65 @@ namespace bolt {
                 return count;
             }
 
+            // Same as above, but the partial counts are also summed on the device, and the count stays there
+            template<typename DVInputIterator, typename Predicate>
+            void count_enqueue(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const Predicate& predicate,
+                device_scalar< int >& result,
+                const std::string& cl_code )
+            {
+                ::cl::Buffer userFunctor = reduce_functor_buffer( ctl, predicate );
+
+                size_t numPartials = 0;
+                control::buffPointer partials = count_partials_enqueue( ctl, first, last, predicate, userFunctor,
+                    cl_code, numPartials );
+
+                reduce_final_enqueue( ctl, *partials, numPartials, 0, bolt::cl::plus< int >( ), result, cl_code );
+            }
+
+            // The device_scalar overloads only reach this point on the OpenCL path, with a non-empty range
+            template<typename InputIterator, typename Predicate>
+            void count_pick_iterator(bolt::cl::control &ctl,
+                const InputIterator& first,
+                const InputIterator& last,
+                const Predicate& predicate,
+                device_scalar< int >& result,
+                const std::string& cl_code,
+                std::random_access_iterator_tag )
+            {
+                //  The input is copied rather than wrapped, because the caller's memory is only guaranteed to be valid
+                //  until this returns, which is before the kernels run
+                typedef typename std::iterator_traits<InputIterator>::value_type iType;
+                device_vector< iType > dvInput( first, last, CL_MEM_READ_ONLY, ctl );
+                count_enqueue( ctl, dvInput.begin(), dvInput.end(), predicate, result, cl_code);
+            }
+
+            template<typename DVInputIterator, typename Predicate>
+            void count_pick_iterator(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const Predicate& predicate,
+                device_scalar< int >& result,
+                const std::string& cl_code,
+                bolt::cl::device_vector_tag )
+            {
+                count_enqueue( ctl, first, last, predicate, result, cl_code);
+            }
+
+            template<typename DVInputIterator, typename Predicate>
+            void count_pick_iterator(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const Predicate& predicate,
+                device_scalar< int >& result,
+                const std::string& cl_code,
+                bolt::cl::fancy_iterator_tag )
+            {
+                count_enqueue( ctl, first, last, predicate, result, cl_code);
+            }
+
             template<typename InputIterator, typename Predicate>
             typename bolt::cl::iterator_traits<InputIterator>::difference_type
                 count_detect_random_access(bolt::cl::control &ctl,
@@ -0,0 +1,72 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_EQUAL_INL )
+#define BOLT_CL_EQUAL_INL
+#pragma once
+
+namespace bolt {
+namespace cl {
+
+template<typename InputIterator1, typename InputIterator2>
+bool equal(control &ctl,
+           InputIterator1 first1,
+           InputIterator1 last1,
+           InputIterator2 first2,
+           const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type iType1;
+    return bolt::cl::equal( ctl, first1, last1, first2, equal_to< iType1 >( ), cl_code );
+}
+
+template<typename InputIterator1, typename InputIterator2>
+bool equal(InputIterator1 first1,
+           InputIterator1 last1,
+           InputIterator2 first2,
+           const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type iType1;
+    return bolt::cl::equal( control::getDefault( ), first1, last1, first2, equal_to< iType1 >( ), cl_code );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+bool equal(control &ctl,
+           InputIterator1 first1,
+           InputIterator1 last1,
+           InputIterator2 first2,
+           BinaryPredicate predicate,
+           const std::string& cl_code)
+{
+    size_t szElements = static_cast< size_t >( std::distance( first1, last1 ) );
+    return detail::mismatch_detect_random_access( ctl, first1, last1, first2, predicate, true, cl_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) ) == szElements;
+}
+
+template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+bool equal(InputIterator1 first1,
+           InputIterator1 last1,
+           InputIterator2 first2,
+           BinaryPredicate predicate,
+           const std::string& cl_code)
+{
+    return bolt::cl::equal( control::getDefault( ), first1, last1, first2, predicate, cl_code );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
@@ -0,0 +1,523 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_FIND_INL )
+#define BOLT_CL_FIND_INL
+#pragma once
+
+#include <algorithm>
+#include <sstream>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/device_vector.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/find.h"
+#endif
+
+#define FIND_WGSIZE 256
+#define FIND_ITEMS_PER_WORKITEM 4
+
+namespace bolt {
+namespace cl {
+
+/**********************************************************************************************************************
+ * find, find_if, find_if_not
+ *********************************************************************************************************************/
+template<typename InputIterator, typename EqualityComparable>
+InputIterator find(control &ctl,
+                   InputIterator first,
+                   InputIterator last,
+                   const EqualityComparable& value,
+                   const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator >::value_type iType;
+    return first + detail::find_value_detect_random_access( ctl, first, last, static_cast< iType >( value ),
+        cl_code, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename EqualityComparable>
+InputIterator find(InputIterator first,
+                   InputIterator last,
+                   const EqualityComparable& value,
+                   const std::string& cl_code)
+{
+    return find( control::getDefault( ), first, last, value, cl_code );
+}
+
+template<typename InputIterator, typename Predicate>
+InputIterator find_if(control &ctl,
+                      InputIterator first,
+                      InputIterator last,
+                      Predicate predicate,
+                      const std::string& cl_code)
+{
+    return first + detail::find_if_detect_random_access( ctl, first, last, predicate, true, false, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename Predicate>
+InputIterator find_if(InputIterator first,
+                      InputIterator last,
+                      Predicate predicate,
+                      const std::string& cl_code)
+{
+    return find_if( control::getDefault( ), first, last, predicate, cl_code );
+}
+
+template<typename InputIterator, typename Predicate>
+InputIterator find_if_not(control &ctl,
+                          InputIterator first,
+                          InputIterator last,
+                          Predicate predicate,
+                          const std::string& cl_code)
+{
+    return first + detail::find_if_detect_random_access( ctl, first, last, predicate, false, false, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename Predicate>
+InputIterator find_if_not(InputIterator first,
+                          InputIterator last,
+                          Predicate predicate,
+                          const std::string& cl_code)
+{
+    return find_if_not( control::getDefault( ), first, last, predicate, cl_code );
+}
+
+namespace detail {
+
+enum findIfTypes { findIf_iType, findIf_iIterType, findIf_Predicate, findIf_end };
+enum findValueTypes { findValue_iType, findValue_iIterType, findValue_end };
+
+class FindIf_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    FindIf_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("findIfTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[findIf_iType] + "* input_ptr,\n"
+            + typeNames[findIf_iIterType] + " input_iter,\n"
+            "global " + typeNames[findIf_Predicate] + "* userFunctor,\n"
+            "const int expected,\n"
+            "const int anyMatch,\n"
+            "const uint length,\n"
+            "volatile global int* stopTile,\n"
+            "global int* groupResults,\n"
+            "local int* scratch\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+class FindValue_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    FindValue_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("findValueTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[findValue_iType] + "* input_ptr,\n"
+            + typeNames[findValue_iIterType] + " input_iter,\n"
+            "const " + typeNames[findValue_iType] + " value,\n"
+            "const uint length,\n"
+            "volatile global int* stopTile,\n"
+            "global int* groupResults,\n"
+            "local int* scratch\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  Compile options shared by every kernel of find_kernels.cl
+inline std::string findCompileOptions( )
+{
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << FIND_WGSIZE;
+    oss << " -DFIND_ITEMS_PER_WORKITEM=" << FIND_ITEMS_PER_WORKITEM;
+    return oss.str( );
+}
+
+//  Sets the arguments that every search kernel ends with, starting at argument lengthArg, runs the kernel and returns
+//  the smallest index that any work-group matched, or length
+inline size_t find_first_launch( control &ctl, ::cl::Kernel& kernel, cl_uint lengthArg, cl_uint length )
+{
+    const size_t tileSize = FIND_WGSIZE * FIND_ITEMS_PER_WORKITEM;
+    cl_int numTiles = static_cast< cl_int >( ( length + tileSize - 1 ) / tileSize );
+
+    //  The work-groups walk the tiles round robin; never launch more of them than there are tiles
+    cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+    size_t numWG = computeUnits * ctl.getWGPerComputeUnit( );
+    numWG = std::max< size_t >( 1, std::min< size_t >( numWG, numTiles ) );
+
+    control::buffPointer stopTile = ctl.acquireBuffer( sizeof( cl_int ), CL_MEM_READ_WRITE );
+    control::buffPointer groupResults = ctl.acquireBuffer( sizeof( cl_int ) * numWG,
+                                                           CL_MEM_ALLOC_HOST_PTR | CL_MEM_WRITE_ONLY );
+
+    //  No tile has a match yet
+    cl_int l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *stopTile, numTiles, 0, sizeof( cl_int ) );
+    V_OPENCL( l_Error, "enqueueFillBuffer() failed for the search stop flag" );
+
+    V_OPENCL( kernel.setArg( lengthArg, length ), "Error setting kernel argument" );
+    V_OPENCL( kernel.setArg( lengthArg + 1, *stopTile ), "Error setting kernel argument" );
+    V_OPENCL( kernel.setArg( lengthArg + 2, *groupResults ), "Error setting kernel argument" );
+
+    ::cl::LocalSpaceArg loc;
+    loc.size_ = ( FIND_WGSIZE + 1 ) * sizeof( cl_int );
+    V_OPENCL( kernel.setArg( lengthArg + 3, loc ), "Error setting kernel argument" );
+
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernel,
+        ::cl::NullRange,
+        ::cl::NDRange( numWG * FIND_WGSIZE ),
+        ::cl::NDRange( FIND_WGSIZE ) );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for a search kernel" );
+
+    ::cl::Event l_mapEvent;
+    cl_int *h_results = (cl_int*)ctl.getCommandQueue( ).enqueueMapBuffer( *groupResults, false, CL_MAP_READ, 0,
+        sizeof( cl_int ) * numWG, NULL, &l_mapEvent, &l_Error );
+    V_OPENCL( l_Error, "Error calling map on the result buffer" );
+    bolt::cl::wait( ctl, l_mapEvent );
+
+    cl_int index = *std::min_element( h_results, h_results + numWG );
+
+    ::cl::Event unmapEvent;
+    V_OPENCL( ctl.getCommandQueue( ).enqueueUnmapMemObject( *groupResults, h_results, NULL, &unmapEvent ),
+        "shared_ptr failed to unmap host memory back to device memory" );
+    V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+
+    return static_cast< size_t >( index );
+}
+
+//  Returns the offset of the first element for which the predicate returns expected, or the length of the input.
+//  With anyMatch, any matching offset may be returned.
+template< typename DVInputIterator, typename Predicate >
+size_t find_if_enqueue( control &ctl, const DVInputIterator& first, const DVInputIterator& last,
+                        const Predicate& predicate, bool expected, bool anyMatch, const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+
+    std::vector< std::string > typeNames( findIf_end );
+    typeNames[ findIf_iType ] = TypeName< iType >::get( );
+    typeNames[ findIf_iIterType ] = TypeName< DVInputIterator >::get( );
+    typeNames[ findIf_Predicate ] = TypeName< Predicate >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< Predicate >::get( ) )
+
+    FindIf_KernelTemplateSpecializer findIf_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &findIf_kts, typeDefinitions,
+                                                                find_kernels, findCompileOptions( ) );
+
+    // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
+    ALIGNED( 256 ) Predicate aligned_predicate( predicate );
+    control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_predicate ),
+        CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_predicate );
+
+    V_OPENCL( kernels[ 0 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 2, *userFunctor ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 3, static_cast< cl_int >( expected ? 1 : 0 ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 4, static_cast< cl_int >( anyMatch ? 1 : 0 ) ), "Error setting kernel argument" );
+
+    return find_first_launch( ctl, kernels[ 0 ], 5, static_cast< cl_uint >( first.distance_to( last ) ) );
+}
+
+template< typename DVInputIterator >
+size_t find_value_enqueue( control &ctl, const DVInputIterator& first, const DVInputIterator& last,
+                           const typename std::iterator_traits< DVInputIterator >::value_type& value,
+                           const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+
+    std::vector< std::string > typeNames( findValue_end );
+    typeNames[ findValue_iType ] = TypeName< iType >::get( );
+    typeNames[ findValue_iIterType ] = TypeName< DVInputIterator >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get( ) )
+
+    FindValue_KernelTemplateSpecializer findValue_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &findValue_kts, typeDefinitions,
+                                                                find_kernels, findCompileOptions( ) );
+
+    V_OPENCL( kernels[ 0 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 2, value ), "Error setting kernel argument" );
+
+    return find_first_launch( ctl, kernels[ 0 ], 3, static_cast< cl_uint >( first.distance_to( last ) ) );
+}
+
+//  Serial search; returns the offset of the first element for which the predicate returns expected
+template< typename InputIterator, typename Predicate >
+size_t serialCPU_find_if( InputIterator first, size_t numElements, const Predicate& predicate, bool expected )
+{
+    for( size_t i = 0; i < numElements; ++i )
+    {
+        if( ( predicate( first[ i ] ) ? true : false ) == expected )
+            return i;
+    }
+    return numElements;
+}
+
+template< typename InputIterator, typename Predicate >
+size_t find_if_cpu( bolt::cl::control::e_RunMode runMode, InputIterator first, size_t numElements,
+                    const Predicate& predicate, bool expected, bool anyMatch )
+{
+    if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        return bolt::btbb::detail::find_first_index( bolt::btbb::detail::PredicateMatcher_tbb< InputIterator,
+            Predicate >( first, predicate, expected ), numElements, anyMatch );
+#else
+        throw std::exception( "The MultiCoreCpu version of find_if is not enabled to be built! \n" );
+#endif
+    }
+    return serialCPU_find_if( first, numElements, predicate, expected );
+}
+
+template< typename InputIterator, typename EqualityComparable >
+size_t find_value_cpu( bolt::cl::control::e_RunMode runMode, InputIterator first, size_t numElements,
+                       const EqualityComparable& value )
+{
+    if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        return static_cast< size_t >( bolt::btbb::find( first, first + numElements, value ) - first );
+#else
+        throw std::exception( "The MultiCoreCpu version of find is not enabled to be built! \n" );
+#endif
+    }
+    return static_cast< size_t >( std::find( first, first + numElements, value ) - first );
+}
+
+/**********************************************************************************************************************
+ * find_if dispatch; every predicate test ends up here and gets back an offset
+ *********************************************************************************************************************/
+template< typename InputIterator, typename Predicate >
+size_t find_if_detect_random_access( control &ctl, const InputIterator& first, const InputIterator& last,
+                                     const Predicate& predicate, bool expected, bool anyMatch,
+                                     const std::string& cl_code, std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator, typename Predicate >
+size_t find_if_detect_random_access( control &ctl, const InputIterator& first, const InputIterator& last,
+                                     const Predicate& predicate, bool expected, bool anyMatch,
+                                     const std::string& cl_code, std::random_access_iterator_tag )
+{
+    if( first == last )
+        return 0;
+
+    return find_if_pick_iterator( ctl, first, last, predicate, expected, anyMatch, cl_code,
+                                  std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+// This template is called strictly for any non-device_vector iterator
+template< typename InputIterator, typename Predicate >
+size_t find_if_pick_iterator( control &ctl, const InputIterator& first, const InputIterator& last,
+                              const Predicate& predicate, bool expected, bool anyMatch,
+                              const std::string& cl_code, std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type iType;
+    size_t szElements = static_cast< size_t >( last - first );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        return find_if_cpu( runMode, first, szElements, predicate, expected, anyMatch );
+    }
+
+    device_vector< iType > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+    return find_if_enqueue( ctl, dvInput.begin( ), dvInput.end( ), predicate, expected, anyMatch, cl_code );
+};
+
+// This template is called strictly for iterators that are derived from device_vector< T >::iterator
+template< typename DVInputIterator, typename Predicate >
+size_t find_if_pick_iterator( control &ctl, const DVInputIterator& first, const DVInputIterator& last,
+                              const Predicate& predicate, bool expected, bool anyMatch,
+                              const std::string& cl_code, bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+    size_t szElements = static_cast< size_t >( last - first );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< iType >::pointer firstPtr = first.getContainer( ).data( );
+        return find_if_cpu( runMode, &firstPtr[ first.m_Index ], szElements, predicate, expected, anyMatch );
+    }
+
+    return find_if_enqueue( ctl, first, last, predicate, expected, anyMatch, cl_code );
+};
+
+// This template is called strictly for fancy iterators such as the counting_iterator
+template< typename DVInputIterator, typename Predicate >
+size_t find_if_pick_iterator( control &ctl, const DVInputIterator& first, const DVInputIterator& last,
+                              const Predicate& predicate, bool expected, bool anyMatch,
+                              const std::string& cl_code, bolt::cl::fancy_iterator_tag )
+{
+    size_t szElements = static_cast< size_t >( last - first );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        return find_if_cpu( runMode, first, szElements, predicate, expected, anyMatch );
+    }
+
+    return find_if_enqueue( ctl, first, last, predicate, expected, anyMatch, cl_code );
+};
+
+/**********************************************************************************************************************
+ * find dispatch
+ *********************************************************************************************************************/
+template< typename InputIterator >
+size_t find_value_detect_random_access( control &ctl, const InputIterator& first, const InputIterator& last,
+                                        const typename std::iterator_traits< InputIterator >::value_type& value,
+                                        const std::string& cl_code, std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator >
+size_t find_value_detect_random_access( control &ctl, const InputIterator& first, const InputIterator& last,
+                                        const typename std::iterator_traits< InputIterator >::value_type& value,
+                                        const std::string& cl_code, std::random_access_iterator_tag )
+{
+    if( first == last )
+        return 0;
+
+    return find_value_pick_iterator( ctl, first, last, value, cl_code,
+                                     std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+// This template is called strictly for any non-device_vector iterator
+template< typename InputIterator >
+size_t find_value_pick_iterator( control &ctl, const InputIterator& first, const InputIterator& last,
+                                 const typename std::iterator_traits< InputIterator >::value_type& value,
+                                 const std::string& cl_code, std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type iType;
+    size_t szElements = static_cast< size_t >( last - first );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        return find_value_cpu( runMode, first, szElements, value );
+    }
+
+    device_vector< iType > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+    return find_value_enqueue( ctl, dvInput.begin( ), dvInput.end( ), value, cl_code );
+};
+
+// This template is called strictly for iterators that are derived from device_vector< T >::iterator
+template< typename DVInputIterator >
+size_t find_value_pick_iterator( control &ctl, const DVInputIterator& first, const DVInputIterator& last,
+                                 const typename std::iterator_traits< DVInputIterator >::value_type& value,
+                                 const std::string& cl_code, bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+    size_t szElements = static_cast< size_t >( last - first );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< iType >::pointer firstPtr = first.getContainer( ).data( );
+        return find_value_cpu( runMode, &firstPtr[ first.m_Index ], szElements, value );
+    }
+
+    return find_value_enqueue( ctl, first, last, value, cl_code );
+};
+
+// This template is called strictly for fancy iterators such as the counting_iterator
+template< typename DVInputIterator >
+size_t find_value_pick_iterator( control &ctl, const DVInputIterator& first, const DVInputIterator& last,
+                                 const typename std::iterator_traits< DVInputIterator >::value_type& value,
+                                 const std::string& cl_code, bolt::cl::fancy_iterator_tag )
+{
+    size_t szElements = static_cast< size_t >( last - first );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        return find_value_cpu( runMode, first, szElements, value );
+    }
+
+    return find_value_enqueue( ctl, first, last, value, cl_code );
+};
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
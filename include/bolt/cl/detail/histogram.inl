@@ -0,0 +1,548 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_HISTOGRAM_INL )
+#define BOLT_CL_HISTOGRAM_INL
+#pragma once
+
+#include <algorithm>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#ifdef ENABLE_TBB
+    #include "bolt/btbb/histogram.h"
+#endif
+
+#define HISTOGRAM_WGSIZE 256
+
+namespace bolt {
+namespace cl {
+namespace detail {
+
+//  Host side of histogramBin( ) in histogram_kernels.cl; both sides must compute the bins the same way
+template< typename iType, typename scaleType >
+struct histogram_bin
+{
+    int even;
+    iType lower;
+    iType upper;
+    scaleType scale;
+    cl_uint numBins;
+
+    cl_uint operator( )( const iType& value ) const
+    {
+        if( !even )
+            return static_cast< cl_uint >( value );
+        if( !( lower <= value && value < upper ) )
+            return numBins;
+        cl_uint bin = static_cast< cl_uint >( static_cast< scaleType >( value - lower ) * scale );
+        return std::min( bin, numBins - 1 );
+    }
+};
+
+enum histogramTypes { histogram_iType, histogram_iIterType, histogram_scaleType, histogram_end };
+
+class Histogram_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    Histogram_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("histogramLocalTemplate");
+        addKernelName("histogramGlobalTemplate");
+        addKernelName("histogramMergeTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[histogram_iType] + "* input_ptr,\n"
+            + typeNames[histogram_iIterType] + " input_iter,\n"
+            "const uint length,\n"
+            "const uint numBins,\n"
+            "const int even,\n"
+            "const " + typeNames[histogram_iType] + " lower,\n"
+            "const " + typeNames[histogram_iType] + " upper,\n"
+            "const " + typeNames[histogram_scaleType] + " scale,\n"
+            "const int useAtomics,\n"
+            "global uint* counts,\n"
+            "global uint* partials,\n"
+            "local uint* ldsBins\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(1) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(1) + "(\n"
+            "global " + typeNames[histogram_iType] + "* input_ptr,\n"
+            + typeNames[histogram_iIterType] + " input_iter,\n"
+            "const uint length,\n"
+            "const uint numBins,\n"
+            "const int even,\n"
+            "const " + typeNames[histogram_iType] + " lower,\n"
+            "const " + typeNames[histogram_iType] + " upper,\n"
+            "const " + typeNames[histogram_scaleType] + " scale,\n"
+            "global uint* counts\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(2) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(2) + "(\n"
+            "global uint* partials,\n"
+            "const uint numPartials,\n"
+            "const uint numBins,\n"
+            "global uint* counts\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  The device path needs the bins in local memory, or global atomics to count straight into the output
+inline bool histogram_runs_on_device( const control &ctl, cl_uint numBins )
+{
+    cl_ulong localMemSize = ctl.getDevice( ).getInfo< CL_DEVICE_LOCAL_MEM_SIZE >( );
+    return ( numBins * sizeof( cl_uint ) <= localMemSize / 2 ) || supportsGlobalAtomics( ctl );
+}
+
+//  Counts the elements of every bin into a buffer of numBins counters.  The bins fit in local memory as long as they
+//  take at most half of it, which leaves room for a second work-group per compute unit.
+template< typename DVInputIterator, typename scaleType >
+control::buffPointer histogram_enqueue( control &ctl,
+    const DVInputIterator& first,
+    const DVInputIterator& last,
+    const histogram_bin< typename std::iterator_traits< DVInputIterator >::value_type, scaleType >& binOf,
+    const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+
+    std::vector< std::string > typeNames( histogram_end );
+    typeNames[histogram_iType] = TypeName< iType >::get( );
+    typeNames[histogram_iIterType] = TypeName< DVInputIterator >::get( );
+    typeNames[histogram_scaleType] = TypeName< scaleType >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get( ) )
+
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << HISTOGRAM_WGSIZE;
+
+    Histogram_KernelTemplateSpecializer h_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &h_kts, typeDefinitions,
+        histogram_kernels, oss.str( ) );
+
+    cl_int l_Error = CL_SUCCESS;
+    cl_uint szElements = static_cast< cl_uint >( std::distance( first, last ) );
+    cl_uint numBins = binOf.numBins;
+
+    //  Never launch more work-groups than there are HISTOGRAM_WGSIZE element chunks in the input
+    cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+    size_t numWG = computeUnits * ctl.getWGPerComputeUnit( );
+    numWG = std::max< size_t >( 1, std::min< size_t >( numWG,
+        ( szElements + HISTOGRAM_WGSIZE - 1 ) / HISTOGRAM_WGSIZE ) );
+
+    cl_ulong localMemSize = ctl.getDevice( ).getInfo< CL_DEVICE_LOCAL_MEM_SIZE >( );
+    bool useLocal = ( numBins * sizeof( cl_uint ) <= localMemSize / 2 );
+    bool useAtomics = supportsGlobalAtomics( ctl );
+
+    control::buffPointer counts = ctl.acquireBuffer( numBins * sizeof( cl_uint ),
+                                                     CL_MEM_ALLOC_HOST_PTR | CL_MEM_READ_WRITE );
+    if( useAtomics )
+    {
+        l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *counts, 0, 0, numBins * sizeof( cl_uint ) );
+        V_OPENCL( l_Error, "enqueueFillBuffer() failed for the histogram counts" );
+    }
+
+    if( useLocal )
+    {
+        //  Without global atomics, every work-group writes its sub-histogram and the merge kernel adds them up
+        control::buffPointer partials = useAtomics ? counts :
+            ctl.acquireBuffer( numWG * numBins * sizeof( cl_uint ), CL_MEM_READ_WRITE );
+
+        ::cl::LocalSpaceArg ldsBins;
+        ldsBins.size_ = numBins * sizeof( cl_uint );
+
+        V_OPENCL( kernels[0].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+                  "Error setting a kernel argument" );
+        V_OPENCL( kernels[0].setArg( 2, szElements ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 3, numBins ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 4, binOf.even ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 5, binOf.lower ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 6, binOf.upper ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 7, binOf.scale ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 8, static_cast< cl_int >( useAtomics ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 9, *counts ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 10, *partials ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 11, ldsBins ), "Error setting kernel argument" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[0],
+            ::cl::NullRange,
+            ::cl::NDRange( numWG * HISTOGRAM_WGSIZE ),
+            ::cl::NDRange( HISTOGRAM_WGSIZE ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for histogramLocal kernel" );
+
+        if( !useAtomics )
+        {
+            size_t numMergeWG = ( numBins + HISTOGRAM_WGSIZE - 1 ) / HISTOGRAM_WGSIZE;
+
+            V_OPENCL( kernels[2].setArg( 0, *partials ), "Error setting kernel argument" );
+            V_OPENCL( kernels[2].setArg( 1, static_cast< cl_uint >( numWG ) ), "Error setting kernel argument" );
+            V_OPENCL( kernels[2].setArg( 2, numBins ), "Error setting kernel argument" );
+            V_OPENCL( kernels[2].setArg( 3, *counts ), "Error setting kernel argument" );
+
+            l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+                kernels[2],
+                ::cl::NullRange,
+                ::cl::NDRange( numMergeWG * HISTOGRAM_WGSIZE ),
+                ::cl::NDRange( HISTOGRAM_WGSIZE ) );
+            V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for histogramMerge kernel" );
+        }
+    }
+    else
+    {
+        //  Too many bins for local memory; histogram_runs_on_device( ) guarantees global atomics here
+        V_OPENCL( kernels[1].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[1].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+                  "Error setting a kernel argument" );
+        V_OPENCL( kernels[1].setArg( 2, szElements ), "Error setting kernel argument" );
+        V_OPENCL( kernels[1].setArg( 3, numBins ), "Error setting kernel argument" );
+        V_OPENCL( kernels[1].setArg( 4, binOf.even ), "Error setting kernel argument" );
+        V_OPENCL( kernels[1].setArg( 5, binOf.lower ), "Error setting kernel argument" );
+        V_OPENCL( kernels[1].setArg( 6, binOf.upper ), "Error setting kernel argument" );
+        V_OPENCL( kernels[1].setArg( 7, binOf.scale ), "Error setting kernel argument" );
+        V_OPENCL( kernels[1].setArg( 8, *counts ), "Error setting kernel argument" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[1],
+            ::cl::NullRange,
+            ::cl::NDRange( numWG * HISTOGRAM_WGSIZE ),
+            ::cl::NDRange( HISTOGRAM_WGSIZE ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for histogramGlobal kernel" );
+    }
+
+    return counts;
+}
+
+//  Counts on the host, serially or with one copy of the bins per TBB thread
+template< typename InputIterator, typename BinFunctor >
+std::vector< cl_uint > histogram_cpu( control::e_RunMode runMode,
+    const InputIterator& first,
+    const InputIterator& last,
+    const BinFunctor& binOf )
+{
+    std::vector< cl_uint > counts( binOf.numBins, 0 );
+    if( runMode == control::MultiCoreCpu )
+    {
+        #ifdef ENABLE_TBB
+            bolt::btbb::histogram( first, last, counts.begin( ), counts.size( ), binOf );
+            return counts;
+        #else
+            throw std::exception( "The MultiCoreCpu version of histogram is not enabled to be built! \n" );
+        #endif
+    }
+
+    for( InputIterator i = first; i != last; ++i )
+    {
+        cl_uint bin = binOf( *i );
+        if( bin < binOf.numBins )
+            ++counts[ bin ];
+    }
+    return counts;
+}
+
+//  Writes the counts computed on the host to the output range
+template< typename OutputIterator >
+void histogram_store( control &ctl, const std::vector< cl_uint >& counts, const OutputIterator& bins_first,
+                      std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+    for( size_t b = 0; b < counts.size( ); ++b )
+        bins_first[ b ] = static_cast< oType >( counts[ b ] );
+}
+
+template< typename DVOutputIterator >
+void histogram_store( control &ctl, const std::vector< cl_uint >& counts, const DVOutputIterator& bins_first,
+                      bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+    cl_int l_Error = ctl.getCommandQueue( ).enqueueWriteBuffer( bins_first.getContainer( ).getBuffer( ), CL_TRUE,
+        bins_first.m_Index * sizeof( oType ), counts.size( ) * sizeof( oType ), &counts[ 0 ] );
+    V_OPENCL( l_Error, "enqueueWriteBuffer() failed for the histogram counts" );
+}
+
+//  Writes the counts computed on the device to the output range
+template< typename OutputIterator >
+void histogram_store( control &ctl, const ::cl::Buffer& counts, cl_uint numBins, const OutputIterator& bins_first,
+                      std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+    cl_int l_Error = CL_SUCCESS;
+    ::cl::Event mapEvent;
+    cl_uint* h_counts = static_cast< cl_uint* >( ctl.getCommandQueue( ).enqueueMapBuffer( counts, false,
+        CL_MAP_READ, 0, numBins * sizeof( cl_uint ), NULL, &mapEvent, &l_Error ) );
+    V_OPENCL( l_Error, "Error calling map on the histogram counts" );
+    bolt::cl::wait( ctl, mapEvent );
+
+    for( cl_uint b = 0; b < numBins; ++b )
+        bins_first[ b ] = static_cast< oType >( h_counts[ b ] );
+
+    ::cl::Event unmapEvent;
+    V_OPENCL( ctl.getCommandQueue( ).enqueueUnmapMemObject( counts, h_counts, NULL, &unmapEvent ),
+              "shared_ptr failed to unmap host memory back to device memory" );
+    V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+}
+
+template< typename DVOutputIterator >
+void histogram_store( control &ctl, const ::cl::Buffer& counts, cl_uint numBins, const DVOutputIterator& bins_first,
+                      bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+    cl_int l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( counts, bins_first.getContainer( ).getBuffer( ), 0,
+        bins_first.m_Index * sizeof( oType ), numBins * sizeof( oType ) );
+    V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the histogram counts" );
+}
+
+//  This overload is called strictly for non-device_vector input iterators
+template< typename InputIterator, typename OutputIterator, typename scaleType >
+void histogram_pick_iterator( control &ctl,
+    const InputIterator& first,
+    const InputIterator& last,
+    const OutputIterator& bins_first,
+    const histogram_bin< typename std::iterator_traits< InputIterator >::value_type, scaleType >& binOf,
+    const std::string& cl_code,
+    std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type iType;
+    typedef typename std::iterator_traits< OutputIterator >::iterator_category oCategory;
+
+    size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+
+    control::e_RunMode runMode = ctl.getForceRunMode( );  // could be dynamic choice some day.
+    if( runMode == control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+    if( runMode == control::OpenCL && !histogram_runs_on_device( ctl, binOf.numBins ) )
+    {
+        runMode = control::SerialCpu;
+    }
+
+    if( runMode != control::OpenCL || szElements == 0 )
+    {
+        histogram_store( ctl, histogram_cpu( runMode, first, last, binOf ), bins_first, oCategory( ) );
+        return;
+    }
+
+    device_vector< iType > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+    control::buffPointer counts = histogram_enqueue( ctl, dvInput.begin( ), dvInput.end( ), binOf, cl_code );
+    histogram_store( ctl, *counts, binOf.numBins, bins_first, oCategory( ) );
+}
+
+//  This overload is called strictly for device_vector input iterators
+template< typename DVInputIterator, typename OutputIterator, typename scaleType >
+void histogram_pick_iterator( control &ctl,
+    const DVInputIterator& first,
+    const DVInputIterator& last,
+    const OutputIterator& bins_first,
+    const histogram_bin< typename std::iterator_traits< DVInputIterator >::value_type, scaleType >& binOf,
+    const std::string& cl_code,
+    bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+    typedef typename std::iterator_traits< OutputIterator >::iterator_category oCategory;
+
+    size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+
+    control::e_RunMode runMode = ctl.getForceRunMode( );  // could be dynamic choice some day.
+    if( runMode == control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+    if( runMode == control::OpenCL && !histogram_runs_on_device( ctl, binOf.numBins ) )
+    {
+        runMode = control::SerialCpu;
+    }
+
+    if( runMode != control::OpenCL || szElements == 0 )
+    {
+        std::vector< cl_uint > counts;
+        {
+            typename bolt::cl::device_vector< iType >::pointer inputPtr = first.getContainer( ).data( );
+            counts = histogram_cpu( runMode, &inputPtr[ first.m_Index ], &inputPtr[ last.m_Index ], binOf );
+        }
+        histogram_store( ctl, counts, bins_first, oCategory( ) );
+        return;
+    }
+
+    control::buffPointer counts = histogram_enqueue( ctl, first, last, binOf, cl_code );
+    histogram_store( ctl, *counts, binOf.numBins, bins_first, oCategory( ) );
+}
+
+//  This overload is called strictly for fancy input iterators
+template< typename DVInputIterator, typename OutputIterator, typename scaleType >
+void histogram_pick_iterator( control &ctl,
+    const DVInputIterator& first,
+    const DVInputIterator& last,
+    const OutputIterator& bins_first,
+    const histogram_bin< typename std::iterator_traits< DVInputIterator >::value_type, scaleType >& binOf,
+    const std::string& cl_code,
+    bolt::cl::fancy_iterator_tag )
+{
+    typedef typename std::iterator_traits< OutputIterator >::iterator_category oCategory;
+
+    size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+
+    control::e_RunMode runMode = ctl.getForceRunMode( );  // could be dynamic choice some day.
+    if( runMode == control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+    if( runMode == control::OpenCL && !histogram_runs_on_device( ctl, binOf.numBins ) )
+    {
+        runMode = control::SerialCpu;
+    }
+
+    if( runMode != control::OpenCL || szElements == 0 )
+    {
+        histogram_store( ctl, histogram_cpu( runMode, first, last, binOf ), bins_first, oCategory( ) );
+        return;
+    }
+
+    control::buffPointer counts = histogram_enqueue( ctl, first, last, binOf, cl_code );
+    histogram_store( ctl, *counts, binOf.numBins, bins_first, oCategory( ) );
+}
+
+template< typename InputIterator, typename OutputIterator, typename scaleType >
+void histogram_detect_random_access( control &ctl,
+    const InputIterator& first,
+    const InputIterator& last,
+    const OutputIterator& bins_first,
+    const histogram_bin< typename std::iterator_traits< InputIterator >::value_type, scaleType >& binOf,
+    const std::string& cl_code,
+    std::input_iterator_tag )
+{
+    //  TODO:  It should be possible to support non-random_access_iterator_tag iterators, if we copied the data
+    //  to a temporary buffer.  Should we?
+    static_assert( false, "Bolt only supports random access iterator types" );
+}
+
+template< typename InputIterator, typename OutputIterator, typename scaleType >
+void histogram_detect_random_access( control &ctl,
+    const InputIterator& first,
+    const InputIterator& last,
+    const OutputIterator& bins_first,
+    const histogram_bin< typename std::iterator_traits< InputIterator >::value_type, scaleType >& binOf,
+    const std::string& cl_code,
+    std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+    static_assert( std::is_integral< oType >::value && sizeof( oType ) == sizeof( cl_uint ),
+                   "The counts are written as 32 bit integers" );
+
+    if( binOf.numBins == 0 )
+        return;
+
+    histogram_pick_iterator( ctl, first, last, bins_first, binOf, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+} // end of detail namespace
+
+template<typename InputIterator, typename OutputIterator>
+void histogram(control &ctl,
+    InputIterator first,
+    InputIterator last,
+    OutputIterator bins_first,
+    OutputIterator bins_last,
+    const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type iType;
+    static_assert( std::is_integral< iType >::value, "histogram takes bin numbers; use histogram_even for values" );
+
+    detail::histogram_bin< iType, cl_float > binOf;
+    binOf.even = 0;
+    binOf.lower = 0;
+    binOf.upper = 0;
+    binOf.scale = 0.0f;
+    binOf.numBins = static_cast< cl_uint >( std::distance( bins_first, bins_last ) );
+
+    detail::histogram_detect_random_access( ctl, first, last, bins_first, binOf, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OutputIterator>
+void histogram(InputIterator first,
+    InputIterator last,
+    OutputIterator bins_first,
+    OutputIterator bins_last,
+    const std::string& cl_code)
+{
+    histogram( control::getDefault( ), first, last, bins_first, bins_last, cl_code );
+}
+
+template<typename InputIterator, typename OutputIterator>
+void histogram_even(control &ctl,
+    InputIterator first,
+    InputIterator last,
+    typename std::iterator_traits< InputIterator >::value_type lower,
+    typename std::iterator_traits< InputIterator >::value_type upper,
+    OutputIterator bins_first,
+    OutputIterator bins_last,
+    const std::string& cl_code)
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type iType;
+    typedef typename std::conditional< std::is_same< iType, cl_double >::value, cl_double, cl_float >::type
+        scaleType;
+
+    detail::histogram_bin< iType, scaleType > binOf;
+    binOf.even = 1;
+    binOf.lower = lower;
+    binOf.upper = upper;
+    binOf.numBins = static_cast< cl_uint >( std::distance( bins_first, bins_last ) );
+    binOf.scale = static_cast< scaleType >( binOf.numBins ) /
+                  ( static_cast< scaleType >( upper ) - static_cast< scaleType >( lower ) );
+
+    detail::histogram_detect_random_access( ctl, first, last, bins_first, binOf, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OutputIterator>
+void histogram_even(InputIterator first,
+    InputIterator last,
+    typename std::iterator_traits< InputIterator >::value_type lower,
+    typename std::iterator_traits< InputIterator >::value_type upper,
+    OutputIterator bins_first,
+    OutputIterator bins_last,
+    const std::string& cl_code)
+{
+    histogram_even( control::getDefault( ), first, last, lower, upper, bins_first, bins_last, cl_code );
+}
+
+} // end of cl namespace
+} // end of bolt namespace
+
+#endif
@@ -17,23 +17,25 @@
 
 /*
 TODO:
-1. Optimize the Kernel. In this version transform and reduce are called directly which performs better.
-2. Found a caveat in Multi-GPU scenario (Evergreen+Tahiti). Which basically applies to most of the routines.
+1. Found a caveat in Multi-GPU scenario (Evergreen+Tahiti). Which basically applies to most of the routines.
 */
 
 #if !defined( BOLT_CL_INNERPRODUCT_INL )
 #define BOLT_CL_INNERPRODUCT_INL
-#define USE_KERNEL 0
 #pragma once
 
 #include <boost/thread/once.hpp>
 #include <boost/bind.hpp>
 #include <type_traits>
 #include <bolt/cl/detail/reduce.inl>
-#include <bolt/cl/detail/transform.inl>
 
 #include "bolt/cl/bolt.h"
 
+#ifdef ENABLE_TBB
+//TBB Includes
+#include "bolt/btbb/inner_product.h"
+#endif
+
 namespace bolt {
     namespace cl {
         // default control, two-input transform, std:: iterator
@@ -75,6 +77,36 @@ namespace bolt {
         }
 
 
+        // The CPU paths compute the value on the host and write it to the scalar; the OpenCL path finishes the
+        // reduction on the device and does not wait for it.
+        template<typename InputIterator, typename OutputType, typename BinaryFunction1, typename BinaryFunction2>
+        void inner_product(bolt::cl::control& ctl, InputIterator first1, InputIterator last1,
+            InputIterator first2, OutputType init, BinaryFunction1 f1, BinaryFunction2 f2,
+            device_scalar< OutputType >& result, const std::string& user_code )
+        {
+            bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();
+            if(runMode == bolt::cl::control::Automatic)
+            {
+                 runMode = ctl.getDefaultPathToRun();
+            }
+            if( runMode == bolt::cl::control::OpenCL && first1 != last1 )
+            {
+                detail::inner_product_pick_iterator( ctl, first1, last1, first2, init, f1, f2, result, user_code,
+                    std::iterator_traits< InputIterator >::iterator_category( ) );
+            }
+            else
+            {
+                result.set( inner_product( ctl, first1, last1, first2, init, f1, f2, user_code ) );
+            }
+        }
+
+        template<typename InputIterator, typename OutputType, typename BinaryFunction1, typename BinaryFunction2>
+        void inner_product( InputIterator first1, InputIterator last1, InputIterator first2, OutputType init,
+            BinaryFunction1 f1, BinaryFunction2 f2, device_scalar< OutputType >& result, const std::string& user_code )
+        {
+            inner_product( control::getDefault(), first1, last1, first2, init, f1, f2, result, user_code );
+        }
+
     }//end of cl namespace
 };//end of bolt namespace
 
@@ -83,36 +115,39 @@ namespace bolt {
     namespace cl {
         namespace detail {
 
-#if USE_KERNEL
-             struct CallCompiler_InnerProduct {
-                static void constructAndCompile(::cl::Kernel *masterKernel,  std::string cl_code,
-                    std::string valueTypeName, std::string functorTypeName1, std::string functorTypeName2,
-                    const control *ctl) {
-
-                    const std::string instantiationString =
-                        "// Host generates this instantiation string with user-specified value type and functor\n"
-                        "template __attribute__((mangled_name(innerProductInstantiated)))\n"
-                        "__attribute__((reqd_work_group_size(64,1,1)))\n"
-                        "kernel void innerProductTemplate(\n"
-                        "global " + valueTypeName + "* A,\n"
-                        "global " + valueTypeName + "* B,\n"
-                        "const int length,\n"
-                        "global " + functorTypeName1 + "* userFunctor,\n"
-                        "global " + functorTypeName2 + "* userFunctor2,\n"
-                        "global " + valueTypeName + "* result,\n"
-                        "local " + valueTypeName + "* scratch\n"
-                        ");\n\n";
-
-                    std::string functorTypeNames = functorTypeName1 + " , " + functorTypeName2;
-
-                    bolt::cl::constructAndCompileString( masterKernel, "innerProduct", inner_product_kernels,
-                        instantiationString, cl_code, valueTypeName, functorTypeNames, *ctl);
-
-                };
-            };
+        enum innerProductTypes {ip_iType, ip_iIterType, ip_oType, ip_BinaryFunction1, ip_BinaryFunction2,
+            ip_end };
 
+        class InnerProduct_KernelTemplateSpecializer : public KernelTemplateSpecializer
+        {
+        public:
+            InnerProduct_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+            {
+                addKernelName( "innerProductTemplate" );
+            }
+
+            const ::std::string operator() ( const ::std::vector<::std::string>& typeNames ) const
+            {
+                const std::string templateSpecializationString =
+                    "// Host generates this instantiation string with user-specified value type and functor\n"
+                    "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+                    "__attribute__((reqd_work_group_size(64,1,1)))\n"
+                    "kernel void innerProductTemplate(\n"
+                    "global " + typeNames[ip_iType] + "* input1_ptr,\n"
+                    + typeNames[ip_iIterType] + " input1_iter,\n"
+                    "global " + typeNames[ip_iType] + "* input2_ptr,\n"
+                    + typeNames[ip_iIterType] + " input2_iter,\n"
+                    "const int length,\n"
+                    "global " + typeNames[ip_BinaryFunction1] + "* userFunctor,\n"
+                    "global " + typeNames[ip_BinaryFunction2] + "* productFunctor,\n"
+                    "global " + typeNames[ip_oType] + "* result,\n"
+                    "local " + typeNames[ip_oType] + "* scratch\n"
+                    ");\n\n";
+
+                return templateSpecializationString;
+            }
+        };
 
-#endif
             // Wrapper that uses default control class, iterator interface
             template<typename InputIterator, typename OutputType, typename BinaryFunction1, typename BinaryFunction2>
             OutputType inner_product_detect_random_access( bolt::cl::control& ctl, const InputIterator& first1,
@@ -166,7 +201,7 @@ namespace bolt {
                 else if(runMode == bolt::cl::control::MultiCoreCpu)
                 {
                     #ifdef ENABLE_TBB
-                           return std::inner_product(first1, last1, first2, init, f1, f2);
+                           return bolt::btbb::inner_product(first1, last1, first2, init, f1, f2);
                     #else
                            throw std::exception("MultiCoreCPU Version of inner_product not Enabled! \n");
                     #endif
@@ -222,8 +257,8 @@ namespace bolt {
                 #ifdef ENABLE_TBB
                     bolt::cl::device_vector< iType1 >::pointer firstPtr =  first1.getContainer( ).data( );
                     bolt::cl::device_vector< iType1 >::pointer first2Ptr =  first2.getContainer( ).data( );
-                    return std::inner_product(  &firstPtr[ first1.m_Index ],  &firstPtr[ last1.m_Index ],
-                                                &first2Ptr[ first2.m_Index ], init, f1, f2);
+                    return bolt::btbb::inner_product(  &firstPtr[ first1.m_Index ],  &firstPtr[ last1.m_Index ],
+                                                       &first2Ptr[ first2.m_Index ], init, f1, f2);
                 #else
                            throw std::exception("MultiCoreCPU Version of inner_product not Enabled! \n");
                 #endif
@@ -262,7 +297,7 @@ namespace bolt {
                 else if(runMode == bolt::cl::control::MultiCoreCpu)
                 {
                     #ifdef ENABLE_TBB
-                          return std::inner_product(first1, last1, first2, init, f1, f2);
+                          return bolt::btbb::inner_product(first1, last1, first2, init, f1, f2);
                     #else
                            throw std::exception("MultiCoreCPU Version of inner_product not Enabled! \n");
                     #endif
@@ -273,112 +308,175 @@ namespace bolt {
                 }
             }
 
+            // Enqueues the fused kernel, which leaves one partial result per work-group in the returned buffer;
+            // numPartials receives the number of work-groups that wrote one.  reduceFunctor and productFunctor hold
+            // copies of f1 and f2.
             template< typename DVInputIterator, typename OutputType, typename BinaryFunction1,typename BinaryFunction2>
-            OutputType inner_product_enqueue(bolt::cl::control &ctl, const DVInputIterator& first1,
+            control::buffPointer inner_product_partials_enqueue(bolt::cl::control &ctl, const DVInputIterator& first1,
                 const DVInputIterator& last1, const DVInputIterator& first2, const OutputType& init,
-                const BinaryFunction1& f1, const BinaryFunction2& f2, const std::string& cl_code)
+                const BinaryFunction1& f1, const BinaryFunction2& f2, const ::cl::Buffer& reduceFunctor,
+                const ::cl::Buffer& productFunctor, const std::string& cl_code, size_t& numPartials )
             {
+                typedef std::iterator_traits<DVInputIterator>::value_type iType;
 
-#if USE_KERNEL
-                //NOTE: Kernel version was found to be inefficient. Optimize!!
-                static boost::once_flag initOnlyOnce;
-                static  ::cl::Kernel masterKernel;
-
-
-                // For user-defined types, the user must create a TypeName trait which returns the name of the
-                // class - note use of TypeName<>::get to retreive the name here.
-                boost::call_once( initOnlyOnce, boost::bind( CallCompiler_InnerProduct::constructAndCompile,
-                    &masterKernel,
- "\n//--user Code\n" + cl_code + "\n//---Functions\n" + ClCode<BinaryFunction1>::get()+ClCode<BinaryFunction2>::get(),
-                    TypeName<OutputType>::get(), TypeName<BinaryFunction1>::get(),
-                    TypeName<BinaryFunction2>::get(), &ctl));
-
-                // Set up shape of launch grid and buffers:
-                // FIXME, read from device attributes.
-                int computeUnits     = ctl.device().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();//round up if we don't know.
-                int wgPerComputeUnit =  ctl.wgPerComputeUnit();
-                int numWG = computeUnits * wgPerComputeUnit;
-
-                cl_int l_Error = CL_SUCCESS;
-      const size_t wgSize=masterKernel.getWorkGroupInfo< CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE > (ctl.device(),
-                &l_Error );
-                V_OPENCL( l_Error, "Error querying kernel for CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE" );
-
-                // Create Buffer wrappers so we can access the host functors, for read or writing in the kernel
-                ALIGNED( 256 ) BinaryFunction1 aligned_binary1( f1 );
-                ALIGNED( 256 ) BinaryFunction2 aligned_binary2( f2 );
-
-                ::cl::Buffer userFunctor1(ctl.context(), CL_MEM_USE_HOST_PTR,sizeof(aligned_binary1),&aligned_binary1);
-                ::cl::Buffer userFunctor2(ctl.context(), CL_MEM_USE_HOST_PTR,sizeof(aligned_binary2),&aligned_binary2);
-                ::cl::Buffer result(ctl.context(), CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY, sizeof(OutputType)*numWG);
-
-                ::cl::Kernel k = masterKernel;  // hopefully create a copy of the kernel. FIXME, doesn't work.
-
+                std::vector<std::string> typeNames( ip_end );
+                typeNames[ip_iType] = TypeName< iType >::get( );
+                typeNames[ip_iIterType] = TypeName< DVInputIterator >::get( );
+                typeNames[ip_oType] = TypeName< OutputType >::get( );
+                typeNames[ip_BinaryFunction1] = TypeName< BinaryFunction1 >::get( );
+                typeNames[ip_BinaryFunction2] = TypeName< BinaryFunction2 >::get( );
+
+                std::vector<std::string> typeDefinitions;
+                PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< OutputType >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction1 >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction2 >::get() )
+
+                InnerProduct_KernelTemplateSpecializer ip_kts;
+                std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+                    ctl,
+                    typeNames,
+                    &ip_kts,
+                    typeDefinitions,
+                    reduce_kernels + inner_product_kernels,
+                    std::string( ) );
+
+                const size_t wgSize = 64;
                 cl_uint szElements = static_cast< cl_uint >( std::distance( first1, last1 ) );
 
-                /***** This is a temporaray fix - Same as Transform Reduce *****/
-                /*What if  requiredWorkGroups > numWG? Do you want to loop or increase the work group size or
-                  increase the per item processing?*/
-                int requiredWorkGroups = (int)ceil((float)szElements/wgSize);
-                if (requiredWorkGroups < numWG)
-                    numWG = requiredWorkGroups;
-                /**********************/
-
-                V_OPENCL( k.setArg(0, first1.getContainer().getBuffer() ), "Error setting kernel argument" );
-                V_OPENCL( k.setArg(1, first2.getContainer().getBuffer() ), "Error setting kernel argument" );
-                V_OPENCL( k.setArg(2, szElements), "Error setting kernel argument" );
-                V_OPENCL( k.setArg(3, userFunctor1), "Error setting kernel argument" );
-                V_OPENCL( k.setArg(4, userFunctor2), "Error setting kernel argument" );
-                V_OPENCL( k.setArg(5, result), "Error setting kernel argument" );
+                //  Never launch more work-groups than there are 64 element chunks in the input
+                cl_uint computeUnits = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
+                size_t numWG = computeUnits * ctl.getWGPerComputeUnit();
+                numWG = std::max< size_t >( 1, std::min< size_t >( numWG, ( szElements + wgSize - 1 ) / wgSize ) );
+
+                control::buffPointer result = ctl.acquireBuffer( sizeof( OutputType ) * numWG,
+                    CL_MEM_ALLOC_HOST_PTR|CL_MEM_READ_WRITE );
+
+                V_OPENCL( kernels[0].setArg(0, first1.getContainer().getBuffer() ), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(1, first1.gpuPayloadSize( ), &first1.gpuPayload( ) ),
+                                                           "Error setting a kernel argument" );
+                V_OPENCL( kernels[0].setArg(2, first2.getContainer().getBuffer() ), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(3, first2.gpuPayloadSize( ), &first2.gpuPayload( ) ),
+                                                           "Error setting a kernel argument" );
+                V_OPENCL( kernels[0].setArg(4, szElements), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(5, reduceFunctor), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(6, productFunctor), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(7, *result), "Error setting kernel argument" );
 
                 ::cl::LocalSpaceArg loc;
                 loc.size_ = wgSize*sizeof(OutputType);
-                V_OPENCL( k.setArg(6, loc), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(8, loc), "Error setting kernel argument" );
 
-                l_Error = ctl.commandQueue().enqueueNDRangeKernel(
-                    k,
+                cl_int l_Error = ctl.getCommandQueue().enqueueNDRangeKernel(
+                    kernels[0],
                     ::cl::NullRange,
                     ::cl::NDRange(numWG * wgSize),
                     ::cl::NDRange(wgSize) );
                 V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for inner_product() kernel" );
 
+                numPartials = numWG;
+                return result;
+            };
+
+            template< typename DVInputIterator, typename OutputType, typename BinaryFunction1,typename BinaryFunction2>
+            OutputType inner_product_enqueue(bolt::cl::control &ctl, const DVInputIterator& first1,
+                const DVInputIterator& last1, const DVInputIterator& first2, const OutputType& init,
+                const BinaryFunction1& f1, const BinaryFunction2& f2, const std::string& cl_code)
+            {
+                cl_uint distVec = static_cast< cl_uint >( std::distance( first1, last1 ) );
+                if( distVec == 0 )
+                    return -1;
+
+                // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
+                ALIGNED( 256 ) BinaryFunction1 aligned_binary1( f1 );
+                ALIGNED( 256 ) BinaryFunction2 aligned_binary2( f2 );
+                control::buffPointer reduceFunctor = ctl.acquireBuffer( sizeof( aligned_binary1 ),
+                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary1 );
+                control::buffPointer productFunctor = ctl.acquireBuffer( sizeof( aligned_binary2 ),
+                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary2 );
+
+                size_t numTailReduce = 0;
+                control::buffPointer result = inner_product_partials_enqueue( ctl, first1, last1, first2, init, f1,
+                    f2, *reduceFunctor, *productFunctor, cl_code, numTailReduce );
+
+                cl_int l_Error = CL_SUCCESS;
                 ::cl::Event l_mapEvent;
-                OutputType *h_result = (OutputType*)ctl.commandQueue().enqueueMapBuffer(result, false, CL_MAP_READ, 0,
-               sizeof(OutputType)*numWG, NULL, &l_mapEvent, &l_Error );
+                OutputType *h_result = (OutputType*)ctl.getCommandQueue().enqueueMapBuffer(*result, false,
+                    CL_MAP_READ, 0, sizeof(OutputType)*numTailReduce, NULL, &l_mapEvent, &l_Error );
                 V_OPENCL( l_Error, "Error calling map on the result buffer" );
 
-                //  Finish the tail end of the reduction on host side; the compute device reduces
-                // within the workgroups, with one result per workgroup
-                size_t ceilNumWG = static_cast< size_t >( std::ceil( static_cast< float >( szElements ) / wgSize) );
-                bolt::cl::minimum< size_t >  min_size_t;
-                size_t numTailReduce = min_size_t( ceilNumWG, numWG );
-
+                //  Finish the tail end of the reduction on host side
                 bolt::cl::wait(ctl, l_mapEvent);
 
                 OutputType acc = static_cast< OutputType >( init );
-                for(int i = 0; i < numTailReduce; ++i)
+                for(unsigned int i = 0; i < numTailReduce; ++i)
                 {
                     acc = f1( acc, h_result[ i ] );
                 }
 
+                ::cl::Event unmapEvent;
+                V_OPENCL( ctl.getCommandQueue().enqueueUnmapMemObject(*result,  h_result, NULL, &unmapEvent ),
+                    "shared_ptr failed to unmap host memory back to device memory" );
+                V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+
                 return acc;
+            };
 
-#endif
+            // Same as above, but the tail end of the reduction runs on the device, and the result stays there
+            template< typename DVInputIterator, typename OutputType, typename BinaryFunction1,typename BinaryFunction2>
+            void inner_product_enqueue(bolt::cl::control &ctl, const DVInputIterator& first1,
+                const DVInputIterator& last1, const DVInputIterator& first2, const OutputType& init,
+                const BinaryFunction1& f1, const BinaryFunction2& f2, device_scalar< OutputType >& result,
+                const std::string& cl_code)
+            {
+                ::cl::Buffer reduceFunctor = reduce_functor_buffer( ctl, f1 );
+                ::cl::Buffer productFunctor = reduce_functor_buffer( ctl, f2 );
 
-                //Should we directly call transform and reduce routines or launch a separate kernel?
-                typedef std::iterator_traits<DVInputIterator>::value_type iType;
-                ::cl::Event innerproductEvent;
+                size_t numPartials = 0;
+                control::buffPointer partials = inner_product_partials_enqueue( ctl, first1, last1, first2, init, f1,
+                    f2, reduceFunctor, productFunctor, cl_code, numPartials );
 
-                cl_uint distVec = static_cast< cl_uint >( std::distance( first1, last1 ) );
-                if( distVec == 0 )
-                    return -1;
+                reduce_final_enqueue( ctl, *partials, numPartials, init, f1, result, cl_code );
+            };
 
-                device_vector< iType > tempDV( distVec, 0, CL_MEM_READ_WRITE, false, ctl );
-                detail::transform_enqueue( ctl, first1, last1, first2, tempDV.begin() ,f2,cl_code);
-                return detail::reduce_enqueue( ctl, tempDV.begin(), tempDV.end(), init, f1, cl_code);
-                bolt::cl::wait(ctl, innerproductEvent);
+            // The device_scalar overloads only reach this point on the OpenCL path, with a non-empty range
+            template<typename InputIterator, typename OutputType, typename BinaryFunction1,typename BinaryFunction2>
+            void inner_product_pick_iterator(bolt::cl::control &ctl,  const InputIterator& first1,
+                const InputIterator& last1, const InputIterator& first2, const OutputType& init,
+                const BinaryFunction1& f1, const BinaryFunction2& f2, device_scalar< OutputType >& result,
+                const std::string& user_code, std::random_access_iterator_tag )
+            {
+                typedef std::iterator_traits<InputIterator>::value_type iType;
+                size_t sz = (last1 - first1);
 
-            };
+                //  The inputs are copied rather than wrapped, because the caller's memory is only guaranteed to be
+                //  valid until this returns, which is before the kernels run
+                device_vector< iType > dvInput( first1, last1, CL_MEM_READ_ONLY, ctl );
+                device_vector< iType > dvInput2( first2, sz, CL_MEM_READ_ONLY, true, ctl );
+
+                inner_product_enqueue( ctl, dvInput.begin( ), dvInput.end( ), dvInput2.begin( ), init, f1, f2, result,
+                                       user_code );
+            }
+
+            template<typename DVInputIterator, typename OutputType, typename BinaryFunction1,typename BinaryFunction2>
+            void inner_product_pick_iterator(bolt::cl::control &ctl,  const DVInputIterator& first1,
+                const DVInputIterator& last1, const DVInputIterator& first2, const OutputType& init,
+                const BinaryFunction1& f1, const BinaryFunction2& f2, device_scalar< OutputType >& result,
+                const std::string& user_code, bolt::cl::device_vector_tag )
+            {
+                inner_product_enqueue( ctl, first1, last1, first2, init, f1, f2, result, user_code );
+            }
+
+            template<typename DVInputIterator, typename OutputType, typename BinaryFunction1,typename BinaryFunction2>
+            void inner_product_pick_iterator(bolt::cl::control &ctl,  const DVInputIterator& first1,
+                const DVInputIterator& last1, const DVInputIterator& first2, const OutputType& init,
+                const BinaryFunction1& f1, const BinaryFunction2& f2, device_scalar< OutputType >& result,
+                const std::string& user_code, bolt::cl::fancy_iterator_tag )
+            {
+                inner_product_enqueue( ctl, first1, last1, first2, init, f1, f2, result, user_code );
+            }
 
         }//End OF detail namespace
     }//End OF cl namespace
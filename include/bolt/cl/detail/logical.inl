@@ -0,0 +1,90 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_LOGICAL_INL )
+#define BOLT_CL_LOGICAL_INL
+#pragma once
+
+namespace bolt {
+namespace cl {
+
+template<typename InputIterator, typename Predicate>
+bool any_of(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code)
+{
+    size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+    return detail::find_if_detect_random_access( ctl, first, last, predicate, true, true, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) ) != szElements;
+}
+
+template<typename InputIterator, typename Predicate>
+bool any_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code)
+{
+    return bolt::cl::any_of( control::getDefault( ), first, last, predicate, cl_code );
+}
+
+//  Every element satisfies the predicate unless one of them does not
+template<typename InputIterator, typename Predicate>
+bool all_of(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code)
+{
+    size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+    return detail::find_if_detect_random_access( ctl, first, last, predicate, false, true, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) ) == szElements;
+}
+
+template<typename InputIterator, typename Predicate>
+bool all_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code)
+{
+    return bolt::cl::all_of( control::getDefault( ), first, last, predicate, cl_code );
+}
+
+template<typename InputIterator, typename Predicate>
+bool none_of(control &ctl,
+             InputIterator first,
+             InputIterator last,
+             Predicate predicate,
+             const std::string& cl_code)
+{
+    return !bolt::cl::any_of( ctl, first, last, predicate, cl_code );
+}
+
+template<typename InputIterator, typename Predicate>
+bool none_of(InputIterator first,
+             InputIterator last,
+             Predicate predicate,
+             const std::string& cl_code)
+{
+    return !bolt::cl::any_of( control::getDefault( ), first, last, predicate, cl_code );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
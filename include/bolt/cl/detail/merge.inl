@@ -0,0 +1,742 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_MERGE_INL )
+#define BOLT_CL_MERGE_INL
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/pair.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/merge.h"
+#endif
+
+#define MERGE_WGSIZE 256
+#define MERGE_ITEMS_PER_WORKITEM 4
+
+namespace bolt {
+namespace cl {
+
+/**********************************************************************************************************************
+ * merge
+ *********************************************************************************************************************/
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator merge(InputIterator1 first1,
+                     InputIterator1 last1,
+                     InputIterator2 first2,
+                     InputIterator2 last2,
+                     OutputIterator result,
+                     const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type T;
+    return detail::merge_detect_random_access( control::getDefault( ), first1, last1, first2, last2, result,
+        less< T >( ), cl_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator merge(InputIterator1 first1,
+                     InputIterator1 last1,
+                     InputIterator2 first2,
+                     InputIterator2 last2,
+                     OutputIterator result,
+                     StrictWeakOrdering comp,
+                     const std::string& cl_code)
+{
+    return detail::merge_detect_random_access( control::getDefault( ), first1, last1, first2, last2, result,
+        comp, cl_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+OutputIterator merge(control &ctl,
+                     InputIterator1 first1,
+                     InputIterator1 last1,
+                     InputIterator2 first2,
+                     InputIterator2 last2,
+                     OutputIterator result,
+                     const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type T;
+    return detail::merge_detect_random_access( ctl, first1, last1, first2, last2, result,
+        less< T >( ), cl_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator merge(control &ctl,
+                     InputIterator1 first1,
+                     InputIterator1 last1,
+                     InputIterator2 first2,
+                     InputIterator2 last2,
+                     OutputIterator result,
+                     StrictWeakOrdering comp,
+                     const std::string& cl_code)
+{
+    return detail::merge_detect_random_access( ctl, first1, last1, first2, last2, result,
+        comp, cl_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+/**********************************************************************************************************************
+ * merge_by_key
+ *********************************************************************************************************************/
+template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+         typename OutputIterator1, typename OutputIterator2>
+pair<OutputIterator1, OutputIterator2>
+merge_by_key(InputIterator1 keys_first1,
+             InputIterator1 keys_last1,
+             InputIterator2 keys_first2,
+             InputIterator2 keys_last2,
+             InputIterator3 values_first1,
+             InputIterator4 values_first2,
+             OutputIterator1 keys_result,
+             OutputIterator2 values_result,
+             const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type kType;
+    return detail::merge_by_key_detect_random_access( control::getDefault( ), keys_first1, keys_last1,
+        keys_first2, keys_last2, values_first1, values_first2, keys_result, values_result, less< kType >( ),
+        cl_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+         typename OutputIterator1, typename OutputIterator2, typename StrictWeakOrdering>
+pair<OutputIterator1, OutputIterator2>
+merge_by_key(InputIterator1 keys_first1,
+             InputIterator1 keys_last1,
+             InputIterator2 keys_first2,
+             InputIterator2 keys_last2,
+             InputIterator3 values_first1,
+             InputIterator4 values_first2,
+             OutputIterator1 keys_result,
+             OutputIterator2 values_result,
+             StrictWeakOrdering comp,
+             const std::string& cl_code)
+{
+    return detail::merge_by_key_detect_random_access( control::getDefault( ), keys_first1, keys_last1,
+        keys_first2, keys_last2, values_first1, values_first2, keys_result, values_result, comp,
+        cl_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+         typename OutputIterator1, typename OutputIterator2>
+pair<OutputIterator1, OutputIterator2>
+merge_by_key(control &ctl,
+             InputIterator1 keys_first1,
+             InputIterator1 keys_last1,
+             InputIterator2 keys_first2,
+             InputIterator2 keys_last2,
+             InputIterator3 values_first1,
+             InputIterator4 values_first2,
+             OutputIterator1 keys_result,
+             OutputIterator2 values_result,
+             const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type kType;
+    return detail::merge_by_key_detect_random_access( ctl, keys_first1, keys_last1,
+        keys_first2, keys_last2, values_first1, values_first2, keys_result, values_result, less< kType >( ),
+        cl_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+         typename OutputIterator1, typename OutputIterator2, typename StrictWeakOrdering>
+pair<OutputIterator1, OutputIterator2>
+merge_by_key(control &ctl,
+             InputIterator1 keys_first1,
+             InputIterator1 keys_last1,
+             InputIterator2 keys_first2,
+             InputIterator2 keys_last2,
+             InputIterator3 values_first1,
+             InputIterator4 values_first2,
+             OutputIterator1 keys_result,
+             OutputIterator2 values_result,
+             StrictWeakOrdering comp,
+             const std::string& cl_code)
+{
+    return detail::merge_by_key_detect_random_access( ctl, keys_first1, keys_last1,
+        keys_first2, keys_last2, values_first1, values_first2, keys_result, values_result, comp,
+        cl_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+namespace bolt {
+namespace cl {
+namespace detail {
+
+enum mergeTypes { merge_kType, merge_kIterType1, merge_kIterType2, merge_koIterType,
+                  merge_vType, merge_vIterType1, merge_vIterType2, merge_voIterType,
+                  merge_StrictWeakOrdering, merge_end };
+
+class Merge_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    Merge_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("mergePartitionTemplate");
+        addKernelName("mergeTemplate");
+        addKernelName("mergeByKeyTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[merge_kType] + "* A_ptr,\n"
+            + typeNames[merge_kIterType1] + " A_iter,\n"
+            "const uint aLength,\n"
+            "global " + typeNames[merge_kType] + "* B_ptr,\n"
+            + typeNames[merge_kIterType2] + " B_iter,\n"
+            "const uint bLength,\n"
+            "const uint tileSize,\n"
+            "const uint numBoundaries,\n"
+            "global uint* splits,\n"
+            "global " + typeNames[merge_StrictWeakOrdering] + "* lessOp\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(1) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(1) + "(\n"
+            "global " + typeNames[merge_kType] + "* A_ptr,\n"
+            + typeNames[merge_kIterType1] + " A_iter,\n"
+            "const uint aLength,\n"
+            "global " + typeNames[merge_kType] + "* B_ptr,\n"
+            + typeNames[merge_kIterType2] + " B_iter,\n"
+            "const uint bLength,\n"
+            "global " + typeNames[merge_kType] + "* Z_ptr,\n"
+            + typeNames[merge_koIterType] + " Z_iter,\n"
+            "global uint* splits,\n"
+            "local " + typeNames[merge_kType] + "* lds,\n"
+            "global " + typeNames[merge_StrictWeakOrdering] + "* lessOp\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(2) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(2) + "(\n"
+            "global " + typeNames[merge_kType] + "* A_ptr,\n"
+            + typeNames[merge_kIterType1] + " A_iter,\n"
+            "const uint aLength,\n"
+            "global " + typeNames[merge_kType] + "* B_ptr,\n"
+            + typeNames[merge_kIterType2] + " B_iter,\n"
+            "const uint bLength,\n"
+            "global " + typeNames[merge_vType] + "* AV_ptr,\n"
+            + typeNames[merge_vIterType1] + " AV_iter,\n"
+            "global " + typeNames[merge_vType] + "* BV_ptr,\n"
+            + typeNames[merge_vIterType2] + " BV_iter,\n"
+            "global " + typeNames[merge_kType] + "* Z_ptr,\n"
+            + typeNames[merge_koIterType] + " Z_iter,\n"
+            "global " + typeNames[merge_vType] + "* ZV_ptr,\n"
+            + typeNames[merge_voIterType] + " ZV_iter,\n"
+            "global uint* splits,\n"
+            "local " + typeNames[merge_kType] + "* lds,\n"
+            "global " + typeNames[merge_StrictWeakOrdering] + "* lessOp\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  All device merges end up here.  When hasValues is false the value iterators are ignored, and only the keys are
+//  merged.
+template< typename DVKeys1, typename DVKeys2, typename DVValues1, typename DVValues2,
+          typename DVKeysOut, typename DVValuesOut, typename StrictWeakOrdering >
+void merge_enqueue( control &ctl,
+                    const DVKeys1& keys_first1, const DVKeys1& keys_last1,
+                    const DVKeys2& keys_first2, const DVKeys2& keys_last2,
+                    const DVValues1& values_first1, const DVValues2& values_first2,
+                    const DVKeysOut& keys_result, const DVValuesOut& values_result,
+                    const StrictWeakOrdering& comp, const std::string& cl_code, bool hasValues )
+{
+    typedef typename std::iterator_traits< DVKeys1 >::value_type kType;
+    typedef typename std::iterator_traits< DVValues1 >::value_type vType;
+
+    cl_int l_Error = CL_SUCCESS;
+    cl_uint aLength = static_cast< cl_uint >( keys_first1.distance_to( keys_last1 ) );
+    cl_uint bLength = static_cast< cl_uint >( keys_first2.distance_to( keys_last2 ) );
+
+    std::vector< std::string > typeNames( merge_end );
+    typeNames[ merge_kType ] = TypeName< kType >::get( );
+    typeNames[ merge_kIterType1 ] = TypeName< DVKeys1 >::get( );
+    typeNames[ merge_kIterType2 ] = TypeName< DVKeys2 >::get( );
+    typeNames[ merge_koIterType ] = TypeName< DVKeysOut >::get( );
+    typeNames[ merge_vType ] = TypeName< vType >::get( );
+    typeNames[ merge_vIterType1 ] = TypeName< DVValues1 >::get( );
+    typeNames[ merge_vIterType2 ] = TypeName< DVValues2 >::get( );
+    typeNames[ merge_voIterType ] = TypeName< DVValuesOut >::get( );
+    typeNames[ merge_StrictWeakOrdering ] = TypeName< StrictWeakOrdering >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< kType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVKeys1 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVKeys2 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVKeysOut >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< vType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVValues1 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVValues2 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVValuesOut >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< StrictWeakOrdering >::get( ) )
+
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << MERGE_WGSIZE;
+    oss << " -DMERGE_ITEMS_PER_WORKITEM=" << MERGE_ITEMS_PER_WORKITEM;
+
+    Merge_KernelTemplateSpecializer merge_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &merge_kts, typeDefinitions,
+                                                                merge_kernels, oss.str( ) );
+
+    //  Every work-group merges one tile of the output; the tile boundaries are placed on the merge path first
+    cl_uint tileSize = MERGE_WGSIZE * MERGE_ITEMS_PER_WORKITEM;
+    cl_uint numTiles = ( aLength + bLength + tileSize - 1 ) / tileSize;
+    cl_uint numBoundaries = numTiles + 1;
+    size_t partitionThreads = ( ( numBoundaries + MERGE_WGSIZE - 1 ) / MERGE_WGSIZE ) * MERGE_WGSIZE;
+
+    device_vector< cl_uint > dvSplits( numBoundaries, 0, CL_MEM_READ_WRITE, false, ctl );
+
+    ALIGNED( 256 ) StrictWeakOrdering aligned_comp( comp );
+    control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_comp ),
+                                                          CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_comp );
+
+    V_OPENCL( kernels[ 0 ].setArg( 0, keys_first1.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 1, keys_first1.gpuPayloadSize( ), &keys_first1.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 2, aLength ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 3, keys_first2.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 4, keys_first2.gpuPayloadSize( ), &keys_first2.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 5, bLength ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 6, tileSize ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 7, numBoundaries ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 8, dvSplits.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 9, *userFunctor ), "Error setting kernel argument" );
+
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 0 ],
+        ::cl::NullRange,
+        ::cl::NDRange( partitionThreads ),
+        ::cl::NDRange( MERGE_WGSIZE ) );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for mergePartition kernel" );
+
+    ::cl::LocalSpaceArg ldsKeys;
+    ldsKeys.size_ = tileSize * sizeof( kType );
+
+    ::cl::Kernel& mergeKernel = hasValues ? kernels[ 2 ] : kernels[ 1 ];
+    cl_uint arg = 0;
+    V_OPENCL( mergeKernel.setArg( arg++, keys_first1.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( mergeKernel.setArg( arg++, keys_first1.gpuPayloadSize( ), &keys_first1.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( mergeKernel.setArg( arg++, aLength ), "Error setting kernel argument" );
+    V_OPENCL( mergeKernel.setArg( arg++, keys_first2.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( mergeKernel.setArg( arg++, keys_first2.gpuPayloadSize( ), &keys_first2.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( mergeKernel.setArg( arg++, bLength ), "Error setting kernel argument" );
+    if( hasValues )
+    {
+        V_OPENCL( mergeKernel.setArg( arg++, values_first1.getContainer( ).getBuffer( ) ),
+                  "Error setting kernel argument" );
+        V_OPENCL( mergeKernel.setArg( arg++, values_first1.gpuPayloadSize( ), &values_first1.gpuPayload( ) ),
+                  "Error setting a kernel argument" );
+        V_OPENCL( mergeKernel.setArg( arg++, values_first2.getContainer( ).getBuffer( ) ),
+                  "Error setting kernel argument" );
+        V_OPENCL( mergeKernel.setArg( arg++, values_first2.gpuPayloadSize( ), &values_first2.gpuPayload( ) ),
+                  "Error setting a kernel argument" );
+    }
+    V_OPENCL( mergeKernel.setArg( arg++, keys_result.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( mergeKernel.setArg( arg++, keys_result.gpuPayloadSize( ), &keys_result.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    if( hasValues )
+    {
+        V_OPENCL( mergeKernel.setArg( arg++, values_result.getContainer( ).getBuffer( ) ),
+                  "Error setting kernel argument" );
+        V_OPENCL( mergeKernel.setArg( arg++, values_result.gpuPayloadSize( ), &values_result.gpuPayload( ) ),
+                  "Error setting a kernel argument" );
+    }
+    V_OPENCL( mergeKernel.setArg( arg++, dvSplits.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( mergeKernel.setArg( arg++, ldsKeys ), "Error setting kernel argument" );
+    V_OPENCL( mergeKernel.setArg( arg++, *userFunctor ), "Error setting kernel argument" );
+
+    ::cl::Event mergeEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        mergeKernel,
+        ::cl::NullRange,
+        ::cl::NDRange( numTiles * MERGE_WGSIZE ),
+        ::cl::NDRange( MERGE_WGSIZE ),
+        NULL,
+        &mergeEvent );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for merge kernel" );
+    bolt::cl::wait( ctl, mergeEvent );
+}
+
+//  Serial merge_by_key; of two equivalent keys the one from the first sequence goes first
+template< typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+          typename OutputIterator1, typename OutputIterator2, typename StrictWeakOrdering >
+void serialCPU_merge_by_key( InputIterator1 keys_first1, InputIterator1 keys_last1,
+                             InputIterator2 keys_first2, InputIterator2 keys_last2,
+                             InputIterator3 values_first1, InputIterator4 values_first2,
+                             OutputIterator1 keys_result, OutputIterator2 values_result,
+                             const StrictWeakOrdering& comp )
+{
+    while( keys_first1 != keys_last1 && keys_first2 != keys_last2 )
+    {
+        if( comp( *keys_first2, *keys_first1 ) )
+        {
+            *keys_result++ = *keys_first2++;
+            *values_result++ = *values_first2++;
+        }
+        else
+        {
+            *keys_result++ = *keys_first1++;
+            *values_result++ = *values_first1++;
+        }
+    }
+    for( ; keys_first1 != keys_last1; ++keys_first1 )
+    {
+        *keys_result++ = *keys_first1;
+        *values_result++ = *values_first1++;
+    }
+    for( ; keys_first2 != keys_last2; ++keys_first2 )
+    {
+        *keys_result++ = *keys_first2;
+        *values_result++ = *values_first2++;
+    }
+}
+
+template< typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakOrdering >
+OutputIterator merge_detect_random_access( control &ctl,
+                                           const InputIterator1& first1, const InputIterator1& last1,
+                                           const InputIterator2& first2, const InputIterator2& last2,
+                                           const OutputIterator& result,
+                                           const StrictWeakOrdering& comp, const std::string& cl_code,
+                                           std::input_iterator_tag )
+{
+    //  \TODO:  It should be possible to support non-random_access_iterator_tag iterators, if we copied the data
+    //  to a temporary buffer.  Should we?
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakOrdering >
+OutputIterator merge_detect_random_access( control &ctl,
+                                           const InputIterator1& first1, const InputIterator1& last1,
+                                           const InputIterator2& first2, const InputIterator2& last2,
+                                           const OutputIterator& result,
+                                           const StrictWeakOrdering& comp, const std::string& cl_code,
+                                           bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "Fancy iterators are not supported by merge" );
+};
+
+template< typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakOrdering >
+OutputIterator merge_detect_random_access( control &ctl,
+                                           const InputIterator1& first1, const InputIterator1& last1,
+                                           const InputIterator2& first2, const InputIterator2& last2,
+                                           const OutputIterator& result,
+                                           const StrictWeakOrdering& comp, const std::string& cl_code,
+                                           std::random_access_iterator_tag )
+{
+    static_assert( std::is_same< typename std::iterator_traits< InputIterator1 >::value_type,
+                                 typename std::iterator_traits< InputIterator2 >::value_type >::value,
+                   "merge requires both input sequences to have the same value type" );
+
+    size_t szElements = static_cast< size_t >( std::distance( first1, last1 ) + std::distance( first2, last2 ) );
+    if( szElements == 0 )
+        return result;
+
+    merge_pick_iterator( ctl, first1, last1, first2, last2, result, comp, cl_code,
+                         std::iterator_traits< InputIterator1 >::iterator_category( ) );
+    return result + szElements;
+};
+
+//Device Vector specialization; the second input and the output have to live in device_vectors as well
+template< typename DVInputIterator1, typename DVInputIterator2, typename DVOutputIterator,
+          typename StrictWeakOrdering >
+void merge_pick_iterator( control &ctl,
+                          const DVInputIterator1& first1, const DVInputIterator1& last1,
+                          const DVInputIterator2& first2, const DVInputIterator2& last2,
+                          const DVOutputIterator& result,
+                          const StrictWeakOrdering& comp, const std::string& cl_code,
+                          bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator1 >::value_type T;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< T >::pointer firstPtr1 = first1.getContainer( ).data( );
+        bolt::cl::device_vector< T >::pointer firstPtr2 = first2.getContainer( ).data( );
+        bolt::cl::device_vector< oType >::pointer resultPtr = result.getContainer( ).data( );
+        if( runMode == bolt::cl::control::SerialCpu )
+        {
+            std::merge( &firstPtr1[ first1.m_Index ], &firstPtr1[ last1.m_Index ],
+                        &firstPtr2[ first2.m_Index ], &firstPtr2[ last2.m_Index ],
+                        &resultPtr[ result.m_Index ], comp );
+        }
+        else
+        {
+#ifdef ENABLE_TBB
+            bolt::btbb::merge( &firstPtr1[ first1.m_Index ], &firstPtr1[ last1.m_Index ],
+                               &firstPtr2[ first2.m_Index ], &firstPtr2[ last2.m_Index ],
+                               &resultPtr[ result.m_Index ], comp );
+#else
+            throw std::exception( "The MultiCoreCpu version of merge is not enabled to be built! \n" );
+#endif
+        }
+    }
+    else
+    {
+        merge_enqueue( ctl, first1, last1, first2, last2, first1, first2, result, result, comp, cl_code, false );
+    }
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in device_vectors and calls the device_vector specialization.
+template< typename InputIterator1, typename InputIterator2, typename OutputIterator, typename StrictWeakOrdering >
+void merge_pick_iterator( control &ctl,
+                          const InputIterator1& first1, const InputIterator1& last1,
+                          const InputIterator2& first2, const InputIterator2& last2,
+                          const OutputIterator& result,
+                          const StrictWeakOrdering& comp, const std::string& cl_code,
+                          std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type T;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        std::merge( first1, last1, first2, last2, result, comp );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        bolt::btbb::merge( first1, last1, first2, last2, result, comp );
+#else
+        throw std::exception( "The MultiCoreCpu version of merge is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        size_t szElements = static_cast< size_t >( ( last1 - first1 ) + ( last2 - first2 ) );
+        device_vector< T > dvInput1( first1, last1, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< T > dvInput2( first2, last2, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< oType > dvOutput( result, szElements, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
+        merge_enqueue( ctl, dvInput1.begin( ), dvInput1.end( ), dvInput2.begin( ), dvInput2.end( ),
+                       dvInput1.begin( ), dvInput2.begin( ), dvOutput.begin( ), dvOutput.begin( ),
+                       comp, cl_code, false );
+        //Map the buffer back to the host
+        dvOutput.data( );
+    }
+}
+
+template< typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+          typename OutputIterator1, typename OutputIterator2, typename StrictWeakOrdering >
+pair< OutputIterator1, OutputIterator2 >
+merge_by_key_detect_random_access( control &ctl,
+                                   const InputIterator1& keys_first1, const InputIterator1& keys_last1,
+                                   const InputIterator2& keys_first2, const InputIterator2& keys_last2,
+                                   const InputIterator3& values_first1, const InputIterator4& values_first2,
+                                   const OutputIterator1& keys_result, const OutputIterator2& values_result,
+                                   const StrictWeakOrdering& comp, const std::string& cl_code,
+                                   std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+          typename OutputIterator1, typename OutputIterator2, typename StrictWeakOrdering >
+pair< OutputIterator1, OutputIterator2 >
+merge_by_key_detect_random_access( control &ctl,
+                                   const InputIterator1& keys_first1, const InputIterator1& keys_last1,
+                                   const InputIterator2& keys_first2, const InputIterator2& keys_last2,
+                                   const InputIterator3& values_first1, const InputIterator4& values_first2,
+                                   const OutputIterator1& keys_result, const OutputIterator2& values_result,
+                                   const StrictWeakOrdering& comp, const std::string& cl_code,
+                                   bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "Fancy iterators are not supported by merge_by_key" );
+};
+
+template< typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+          typename OutputIterator1, typename OutputIterator2, typename StrictWeakOrdering >
+pair< OutputIterator1, OutputIterator2 >
+merge_by_key_detect_random_access( control &ctl,
+                                   const InputIterator1& keys_first1, const InputIterator1& keys_last1,
+                                   const InputIterator2& keys_first2, const InputIterator2& keys_last2,
+                                   const InputIterator3& values_first1, const InputIterator4& values_first2,
+                                   const OutputIterator1& keys_result, const OutputIterator2& values_result,
+                                   const StrictWeakOrdering& comp, const std::string& cl_code,
+                                   std::random_access_iterator_tag )
+{
+    static_assert( std::is_same< typename std::iterator_traits< InputIterator1 >::value_type,
+                                 typename std::iterator_traits< InputIterator2 >::value_type >::value,
+                   "merge_by_key requires both key sequences to have the same value type" );
+    static_assert( std::is_same< typename std::iterator_traits< InputIterator3 >::value_type,
+                                 typename std::iterator_traits< InputIterator4 >::value_type >::value,
+                   "merge_by_key requires both value sequences to have the same value type" );
+
+    size_t szElements = static_cast< size_t >( std::distance( keys_first1, keys_last1 ) +
+                                               std::distance( keys_first2, keys_last2 ) );
+    if( szElements == 0 )
+        return bolt::cl::make_pair( keys_result, values_result );
+
+    merge_by_key_pick_iterator( ctl, keys_first1, keys_last1, keys_first2, keys_last2, values_first1, values_first2,
+                                keys_result, values_result, comp, cl_code,
+                                std::iterator_traits< InputIterator1 >::iterator_category( ) );
+    return bolt::cl::make_pair( keys_result + szElements, values_result + szElements );
+};
+
+//Device Vector specialization; all other sequences have to live in device_vectors as well
+template< typename DVKeys1, typename DVKeys2, typename DVValues1, typename DVValues2,
+          typename DVKeysOut, typename DVValuesOut, typename StrictWeakOrdering >
+void merge_by_key_pick_iterator( control &ctl,
+                                 const DVKeys1& keys_first1, const DVKeys1& keys_last1,
+                                 const DVKeys2& keys_first2, const DVKeys2& keys_last2,
+                                 const DVValues1& values_first1, const DVValues2& values_first2,
+                                 const DVKeysOut& keys_result, const DVValuesOut& values_result,
+                                 const StrictWeakOrdering& comp, const std::string& cl_code,
+                                 bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVKeys1 >::value_type kType;
+    typedef typename std::iterator_traits< DVValues1 >::value_type vType;
+    typedef typename std::iterator_traits< DVKeysOut >::value_type koType;
+    typedef typename std::iterator_traits< DVValuesOut >::value_type voType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< kType >::pointer keysPtr1 = keys_first1.getContainer( ).data( );
+        bolt::cl::device_vector< kType >::pointer keysPtr2 = keys_first2.getContainer( ).data( );
+        bolt::cl::device_vector< vType >::pointer valuesPtr1 = values_first1.getContainer( ).data( );
+        bolt::cl::device_vector< vType >::pointer valuesPtr2 = values_first2.getContainer( ).data( );
+        bolt::cl::device_vector< koType >::pointer keysOutPtr = keys_result.getContainer( ).data( );
+        bolt::cl::device_vector< voType >::pointer valuesOutPtr = values_result.getContainer( ).data( );
+        if( runMode == bolt::cl::control::SerialCpu )
+        {
+            serialCPU_merge_by_key( &keysPtr1[ keys_first1.m_Index ], &keysPtr1[ keys_last1.m_Index ],
+                                    &keysPtr2[ keys_first2.m_Index ], &keysPtr2[ keys_last2.m_Index ],
+                                    &valuesPtr1[ values_first1.m_Index ], &valuesPtr2[ values_first2.m_Index ],
+                                    &keysOutPtr[ keys_result.m_Index ], &valuesOutPtr[ values_result.m_Index ],
+                                    comp );
+        }
+        else
+        {
+#ifdef ENABLE_TBB
+            bolt::btbb::merge_by_key( &keysPtr1[ keys_first1.m_Index ], &keysPtr1[ keys_last1.m_Index ],
+                                      &keysPtr2[ keys_first2.m_Index ], &keysPtr2[ keys_last2.m_Index ],
+                                      &valuesPtr1[ values_first1.m_Index ], &valuesPtr2[ values_first2.m_Index ],
+                                      &keysOutPtr[ keys_result.m_Index ], &valuesOutPtr[ values_result.m_Index ],
+                                      comp );
+#else
+            throw std::exception( "The MultiCoreCpu version of merge_by_key is not enabled to be built! \n" );
+#endif
+        }
+    }
+    else
+    {
+        merge_enqueue( ctl, keys_first1, keys_last1, keys_first2, keys_last2, values_first1, values_first2,
+                       keys_result, values_result, comp, cl_code, true );
+    }
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in device_vectors and calls the device_vector specialization.
+template< typename InputIterator1, typename InputIterator2, typename InputIterator3, typename InputIterator4,
+          typename OutputIterator1, typename OutputIterator2, typename StrictWeakOrdering >
+void merge_by_key_pick_iterator( control &ctl,
+                                 const InputIterator1& keys_first1, const InputIterator1& keys_last1,
+                                 const InputIterator2& keys_first2, const InputIterator2& keys_last2,
+                                 const InputIterator3& values_first1, const InputIterator4& values_first2,
+                                 const OutputIterator1& keys_result, const OutputIterator2& values_result,
+                                 const StrictWeakOrdering& comp, const std::string& cl_code,
+                                 std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< InputIterator3 >::value_type vType;
+    typedef typename std::iterator_traits< OutputIterator1 >::value_type koType;
+    typedef typename std::iterator_traits< OutputIterator2 >::value_type voType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        serialCPU_merge_by_key( keys_first1, keys_last1, keys_first2, keys_last2, values_first1, values_first2,
+                                keys_result, values_result, comp );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        bolt::btbb::merge_by_key( keys_first1, keys_last1, keys_first2, keys_last2, values_first1, values_first2,
+                                  keys_result, values_result, comp );
+#else
+        throw std::exception( "The MultiCoreCpu version of merge_by_key is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        size_t aLength = static_cast< size_t >( keys_last1 - keys_first1 );
+        size_t bLength = static_cast< size_t >( keys_last2 - keys_first2 );
+        device_vector< kType > dvKeys1( keys_first1, keys_last1, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< kType > dvKeys2( keys_first2, keys_last2, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< vType > dvValues1( values_first1, aLength, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, true,
+                                          ctl );
+        device_vector< vType > dvValues2( values_first2, bLength, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, true,
+                                          ctl );
+        device_vector< koType > dvKeysOut( keys_result, aLength + bLength, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY,
+                                           false, ctl );
+        device_vector< voType > dvValuesOut( values_result, aLength + bLength,
+                                             CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
+        merge_enqueue( ctl, dvKeys1.begin( ), dvKeys1.end( ), dvKeys2.begin( ), dvKeys2.end( ),
+                       dvValues1.begin( ), dvValues2.begin( ), dvKeysOut.begin( ), dvValuesOut.begin( ),
+                       comp, cl_code, true );
+        //Map the buffers back to the host
+        dvKeysOut.data( );
+        dvValuesOut.data( );
+    }
+}
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
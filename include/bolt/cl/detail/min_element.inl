@@ -28,6 +28,9 @@
 #include "bolt/cl/bolt.h"
 #include "bolt/cl/functional.h"
 
+#ifdef ENABLE_TBB
+    #include "bolt/btbb/minmax_element.h"
+#endif
 
 namespace bolt {
     namespace cl {
@@ -358,7 +361,7 @@ namespace bolt {
 
                 case bolt::cl::control::MultiCoreCpu:
                     #ifdef ENABLE_TBB
-                        return std::min_element(first, last, binary_op);
+                        return bolt::btbb::min_element(first, last, binary_op);
                     #else
                         throw std::exception( "The MultiCoreCpu version of Max-Min is not enabled to be built! \n" );
                     #endif
@@ -404,7 +407,13 @@ namespace bolt {
 
                 case bolt::cl::control::MultiCoreCpu:
                     #ifdef ENABLE_TBB
-                        return std::min_element(first, last, binary_op);
+                    {
+                        typedef typename std::iterator_traits<DVInputIterator>::value_type iType;
+                        typename bolt::cl::device_vector< iType >::pointer inputPtr = first.getContainer( ).data( );
+                        iType* minPtr = bolt::btbb::min_element( &inputPtr[ first.m_Index ], &inputPtr[ last.m_Index ],
+                            binary_op );
+                        return first + ( minPtr - &inputPtr[ first.m_Index ] );
+                    }
                     #else
                         throw std::exception( "The MultiCoreCpu version of Max-Min is not enabled to be built! \n" );
                     #endif
@@ -445,7 +454,7 @@ namespace bolt {
 
                 case bolt::cl::control::MultiCoreCpu:
                     #ifdef ENABLE_TBB
-                        return std::min_element(first, last, binary_op);
+                        return bolt::btbb::min_element(first, last, binary_op);
                     #else
                         throw std::exception( "The MultiCoreCpu version of Max-Min is not enabled to be built! \n" );
                     #endif
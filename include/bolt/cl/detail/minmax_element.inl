@@ -0,0 +1,412 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_MINMAX_ELEMENT_INL )
+#define BOLT_CL_MINMAX_ELEMENT_INL
+#pragma once
+
+#include <algorithm>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+
+#ifdef ENABLE_TBB
+    #include "bolt/btbb/minmax_element.h"
+#endif
+
+
+namespace bolt {
+    namespace cl {
+
+        template<typename ForwardIterator>
+        std::pair< ForwardIterator, ForwardIterator > minmax_element(ForwardIterator first,
+            ForwardIterator last,
+            const std::string& cl_code)
+        {
+            typedef typename std::iterator_traits<ForwardIterator>::value_type T;
+            return minmax_element(bolt::cl::control::getDefault(), first, last, bolt::cl::less<T>(), cl_code);
+        };
+
+        template<typename ForwardIterator,typename BinaryPredicate>
+        std::pair< ForwardIterator, ForwardIterator > minmax_element(ForwardIterator first,
+            ForwardIterator last,
+            BinaryPredicate binary_op,
+            const std::string& cl_code)
+        {
+            return minmax_element(bolt::cl::control::getDefault(), first, last, binary_op, cl_code);
+        };
+
+        template<typename ForwardIterator>
+        std::pair< ForwardIterator, ForwardIterator > minmax_element(bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            const std::string& cl_code)
+        {
+            typedef typename std::iterator_traits<ForwardIterator>::value_type T;
+            return minmax_element(ctl, first, last, bolt::cl::less<T>(), cl_code);
+        };
+
+        // This template is called by all other "convenience" version of minmax_element.
+        // It also implements the CPU-side mappings of the algorithm for SerialCpu and MultiCoreCpu
+        template<typename ForwardIterator, typename BinaryPredicate>
+        std::pair< ForwardIterator, ForwardIterator > minmax_element(bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            BinaryPredicate binary_op,
+            const std::string& cl_code)
+        {
+            return detail::minmax_element_detect_random_access(ctl, first, last, binary_op, cl_code,
+                std::iterator_traits< ForwardIterator >::iterator_category( ) );
+        };
+
+    };
+};
+
+
+namespace bolt {
+    namespace cl {
+        namespace detail {
+
+            enum MinMaxTypes { minmax_iValueType, minmax_iIterType, minmax_BinaryPredicate, minmax_end };
+
+            ///////////////////////////////////////////////////////////////////////
+            //Kernel Template Specializer
+            ///////////////////////////////////////////////////////////////////////
+            class MinMax_KernelTemplateSpecializer : public KernelTemplateSpecializer
+            {
+            public:
+
+                MinMax_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+                {
+                    addKernelName( "minmax_elementTemplate" );
+                }
+
+                const ::std::string operator() ( const ::std::vector<::std::string>& typeNames ) const
+                {
+                    const std::string templateSpecializationString =
+                        "// Host generates this instantiation string with user-specified value type and functor\n"
+                        "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+                        "__attribute__((reqd_work_group_size(64,1,1)))\n"
+                        "kernel void " + name(0) + "(\n"
+                        "global " + typeNames[minmax_iValueType] + "* input_ptr,\n"
+                         + typeNames[minmax_iIterType] + " input_iter,\n"
+                        "const int length,\n"
+                        "global " + typeNames[minmax_BinaryPredicate] + "* userFunctor,\n"
+                        "global int* resultIndices,\n"
+                        "global " + typeNames[minmax_iValueType] + "* resultValues,\n"
+                        "local " + typeNames[minmax_iValueType] + "* scratchMin,\n"
+                        "local int* scratchMinIndex,\n"
+                        "local " + typeNames[minmax_iValueType] + "* scratchMax,\n"
+                        "local int* scratchMaxIndex\n"
+                        ");\n\n";
+
+                    return templateSpecializationString;
+                }
+            };
+
+            //  Launches one pass over [first, last) and combines the candidates of the work-groups on the host.
+            //  Returns the offsets of the first smallest and of the last largest element.
+            template<typename DVInputIterator, typename BinaryPredicate>
+            std::pair< int, int > minmax_element_enqueue(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const BinaryPredicate& binary_op,
+                const std::string& cl_code )
+            {
+                typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+
+                std::vector<std::string> typeNames( minmax_end );
+                typeNames[minmax_iValueType] = TypeName< iType >::get( );
+                typeNames[minmax_iIterType] = TypeName< DVInputIterator >::get( );
+                typeNames[minmax_BinaryPredicate] = TypeName< BinaryPredicate >::get();
+
+                std::vector<std::string> typeDefinitions;
+                PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryPredicate >::get() )
+
+                MinMax_KernelTemplateSpecializer mm_kts;
+                std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+                    ctl,
+                    typeNames,
+                    &mm_kts,
+                    typeDefinitions,
+                    minmax_element_kernels,
+                    std::string( ) );
+
+                const size_t wgSize = 64;
+                cl_uint szElements = static_cast< cl_uint >( first.distance_to( last ) );
+
+                //  Never launch more work-groups than there are 64 element chunks in the input
+                cl_uint computeUnits = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
+                size_t numWG = computeUnits * ctl.getWGPerComputeUnit();
+                numWG = std::max< size_t >( 1, std::min< size_t >( numWG, ( szElements + wgSize - 1 ) / wgSize ) );
+
+                // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
+                ALIGNED( 256 ) BinaryPredicate aligned_binary( binary_op );
+                control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_binary ),
+                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary );
+
+                control::buffPointer resultIndices = ctl.acquireBuffer( sizeof( int ) * 2 * numWG,
+                    CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
+                control::buffPointer resultValues = ctl.acquireBuffer( sizeof( iType ) * 2 * numWG,
+                    CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
+
+                V_OPENCL( kernels[0].setArg(0, first.getContainer().getBuffer() ), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+                                                           "Error setting a kernel argument" );
+                V_OPENCL( kernels[0].setArg(2, szElements), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(3, *userFunctor), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(4, *resultIndices), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(5, *resultValues), "Error setting kernel argument" );
+
+                ::cl::LocalSpaceArg locValues, locIndices;
+                locValues.size_ = wgSize*sizeof(iType);
+                locIndices.size_ = wgSize*sizeof(int);
+                V_OPENCL( kernels[0].setArg(6, locValues), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(7, locIndices), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(8, locValues), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(9, locIndices), "Error setting kernel argument" );
+
+                cl_int l_Error = ctl.getCommandQueue().enqueueNDRangeKernel(
+                    kernels[0],
+                    ::cl::NullRange,
+                    ::cl::NDRange(numWG * wgSize),
+                    ::cl::NDRange(wgSize) );
+                V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for minmax_element() kernel" );
+
+                ::cl::Event l_mapIndices, l_mapValues;
+                int *h_indices = (int*)ctl.getCommandQueue().enqueueMapBuffer(*resultIndices, false, CL_MAP_READ, 0,
+                    sizeof(int) * 2 * numWG, NULL, &l_mapIndices, &l_Error );
+                V_OPENCL( l_Error, "Error calling map on the result buffer" );
+                iType *h_values = (iType*)ctl.getCommandQueue().enqueueMapBuffer(*resultValues, false, CL_MAP_READ, 0,
+                    sizeof(iType) * 2 * numWG, NULL, &l_mapValues, &l_Error );
+                V_OPENCL( l_Error, "Error calling map on the result buffer" );
+
+                bolt::cl::wait(ctl, l_mapIndices);
+                bolt::cl::wait(ctl, l_mapValues);
+
+                //  Finish the tail end of the reduction on host side, with the same tie-break as the kernel
+                int minIndex = h_indices[0];
+                int maxIndex = h_indices[1];
+                iType minimum = h_values[0];
+                iType maximum = h_values[1];
+                for(size_t i = 1; i < numWG; ++i)
+                {
+                    int index = h_indices[2 * i];
+                    iType value = h_values[2 * i];
+                    if( binary_op( value, minimum ) || ( !binary_op( minimum, value ) && index < minIndex ) )
+                    {
+                        minimum = value;
+                        minIndex = index;
+                    }
+
+                    index = h_indices[2 * i + 1];
+                    value = h_values[2 * i + 1];
+                    if( binary_op( maximum, value ) || ( !binary_op( value, maximum ) && index > maxIndex ) )
+                    {
+                        maximum = value;
+                        maxIndex = index;
+                    }
+                }
+
+                ::cl::Event unmapIndices, unmapValues;
+                V_OPENCL( ctl.getCommandQueue().enqueueUnmapMemObject(*resultIndices, h_indices, NULL, &unmapIndices ),
+                    "shared_ptr failed to unmap host memory back to device memory" );
+                V_OPENCL( ctl.getCommandQueue().enqueueUnmapMemObject(*resultValues, h_values, NULL, &unmapValues ),
+                    "shared_ptr failed to unmap host memory back to device memory" );
+                V_OPENCL( unmapIndices.wait( ), "failed to wait for unmap event" );
+                V_OPENCL( unmapValues.wait( ), "failed to wait for unmap event" );
+
+                return std::make_pair( minIndex, maxIndex );
+            }
+
+            template<typename ForwardIterator, typename BinaryPredicate>
+            std::pair< ForwardIterator, ForwardIterator > minmax_element_detect_random_access(
+                bolt::cl::control &ctl,
+                const ForwardIterator& first,
+                const ForwardIterator& last,
+                const BinaryPredicate& binary_op,
+                const std::string& cl_code,
+                std::input_iterator_tag)
+            {
+                //TODO:It should be possible to support non-random_access_iterator_tag iterators,if we copied the data
+                //to a temporary buffer.  Should we?
+                static_assert( false, "Bolt only supports random access iterator types" );
+            }
+
+            template<typename ForwardIterator, typename BinaryPredicate>
+            std::pair< ForwardIterator, ForwardIterator > minmax_element_detect_random_access(
+                bolt::cl::control &ctl,
+                const ForwardIterator& first,
+                const ForwardIterator& last,
+                const BinaryPredicate& binary_op,
+                const std::string& cl_code,
+                std::random_access_iterator_tag)
+            {
+                return minmax_element_pick_iterator( ctl, first, last, binary_op, cl_code,
+                    std::iterator_traits< ForwardIterator >::iterator_category( ) );
+            }
+
+            // This template is called after we detect random access iterators
+            // This is called strictly for any non-device_vector iterator
+            template<typename ForwardIterator, typename BinaryPredicate>
+            std::pair< ForwardIterator, ForwardIterator > minmax_element_pick_iterator(bolt::cl::control &ctl,
+                const ForwardIterator& first,
+                const ForwardIterator& last,
+                const BinaryPredicate& binary_op,
+                const std::string& cl_code,
+                std::random_access_iterator_tag )
+            {
+                typedef typename std::iterator_traits<ForwardIterator>::value_type iType;
+                size_t szElements = (size_t)(last - first);
+                if (szElements == 0)
+                    return std::make_pair( last, last );
+
+                bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
+                if(runMode == bolt::cl::control::Automatic)
+                {
+                    runMode = ctl.getDefaultPathToRun();
+                }
+
+                switch(runMode)
+                {
+                case bolt::cl::control::OpenCL :
+                    {
+                        device_vector< iType > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+                        std::pair< int, int > pos = minmax_element_enqueue( ctl, dvInput.begin(), dvInput.end(),
+                            binary_op, cl_code);
+                        return std::make_pair( first + pos.first, first + pos.second );
+                    }
+
+                case bolt::cl::control::MultiCoreCpu:
+                    #ifdef ENABLE_TBB
+                        return bolt::btbb::minmax_element(first, last, binary_op);
+                    #else
+                        throw std::exception( "The MultiCoreCpu version of minmax_element is not enabled! \n" );
+                    #endif
+
+                case bolt::cl::control::SerialCpu:
+                    return std::minmax_element(first, last, binary_op);
+
+                default:
+                    return std::minmax_element(first, last, binary_op);
+
+                }
+            };
+
+            // This template is called after we detect random access iterators
+            // This is called strictly for iterators that are derived from device_vector< T >::iterator
+            template<typename DVInputIterator, typename BinaryPredicate>
+            std::pair< DVInputIterator, DVInputIterator > minmax_element_pick_iterator(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const BinaryPredicate& binary_op,
+                const std::string& cl_code,
+                bolt::cl::device_vector_tag )
+            {
+                typedef typename std::iterator_traits<DVInputIterator>::value_type iType;
+                size_t szElements = (size_t)(last - first);
+                if (szElements == 0)
+                    return std::make_pair( last, last );
+
+                bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
+                if(runMode == bolt::cl::control::Automatic)
+                {
+                    runMode = ctl.getDefaultPathToRun();
+                }
+
+                switch(runMode)
+                {
+                case bolt::cl::control::OpenCL :
+                    {
+                        std::pair< int, int > pos = minmax_element_enqueue( ctl, first, last, binary_op, cl_code);
+                        return std::make_pair( first + pos.first, first + pos.second );
+                    }
+
+                case bolt::cl::control::MultiCoreCpu:
+                    #ifdef ENABLE_TBB
+                    {
+                        typename bolt::cl::device_vector< iType >::pointer inputPtr = first.getContainer( ).data( );
+                        std::pair< iType*, iType* > pos = bolt::btbb::minmax_element( &inputPtr[ first.m_Index ],
+                            &inputPtr[ last.m_Index ], binary_op );
+                        return std::make_pair( first + ( pos.first - &inputPtr[ first.m_Index ] ),
+                                               first + ( pos.second - &inputPtr[ first.m_Index ] ) );
+                    }
+                    #else
+                        throw std::exception( "The MultiCoreCpu version of minmax_element is not enabled! \n" );
+                    #endif
+
+                default:
+                    {
+                        typename bolt::cl::device_vector< iType >::pointer inputPtr = first.getContainer( ).data( );
+                        std::pair< iType*, iType* > pos = std::minmax_element( &inputPtr[ first.m_Index ],
+                            &inputPtr[ last.m_Index ], binary_op );
+                        return std::make_pair( first + ( pos.first - &inputPtr[ first.m_Index ] ),
+                                               first + ( pos.second - &inputPtr[ first.m_Index ] ) );
+                    }
+
+                }
+            }
+
+            // This template is called after we detect random access iterators
+            // This is called strictly for fancy iterators such as the counting_iterator
+            template<typename DVInputIterator, typename BinaryPredicate>
+            std::pair< DVInputIterator, DVInputIterator > minmax_element_pick_iterator(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const BinaryPredicate& binary_op,
+                const std::string& cl_code,
+                bolt::cl::fancy_iterator_tag )
+            {
+                size_t szElements = (size_t)(last - first);
+                if (szElements == 0)
+                    return std::make_pair( last, last );
+
+                bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();  // could be dynamic choice some day.
+                if(runMode == bolt::cl::control::Automatic)
+                {
+                    runMode = ctl.getDefaultPathToRun();
+                }
+
+                switch(runMode)
+                {
+                case bolt::cl::control::OpenCL :
+                    {
+                        std::pair< int, int > pos = minmax_element_enqueue( ctl, first, last, binary_op, cl_code);
+                        return std::make_pair( first + pos.first, first + pos.second );
+                    }
+
+                case bolt::cl::control::MultiCoreCpu:
+                    #ifdef ENABLE_TBB
+                        return bolt::btbb::minmax_element(first, last, binary_op);
+                    #else
+                        throw std::exception( "The MultiCoreCpu version of minmax_element is not enabled! \n" );
+                    #endif
+
+                default:
+                    return std::minmax_element(first, last, binary_op);
+
+                }
+            }
+
+        };
+    };
+};
+
+#endif
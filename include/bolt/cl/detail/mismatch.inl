@@ -0,0 +1,267 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_MISMATCH_INL )
+#define BOLT_CL_MISMATCH_INL
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/find.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/mismatch.h"
+#endif
+
+namespace bolt {
+namespace cl {
+
+/**********************************************************************************************************************
+ * mismatch
+ *********************************************************************************************************************/
+template<typename InputIterator1, typename InputIterator2>
+std::pair< InputIterator1, InputIterator2 > mismatch(control &ctl,
+                                                     InputIterator1 first1,
+                                                     InputIterator1 last1,
+                                                     InputIterator2 first2,
+                                                     const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type iType1;
+    return bolt::cl::mismatch( ctl, first1, last1, first2, equal_to< iType1 >( ), cl_code );
+}
+
+template<typename InputIterator1, typename InputIterator2>
+std::pair< InputIterator1, InputIterator2 > mismatch(InputIterator1 first1,
+                                                     InputIterator1 last1,
+                                                     InputIterator2 first2,
+                                                     const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type iType1;
+    return bolt::cl::mismatch( control::getDefault( ), first1, last1, first2, equal_to< iType1 >( ), cl_code );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+std::pair< InputIterator1, InputIterator2 > mismatch(control &ctl,
+                                                     InputIterator1 first1,
+                                                     InputIterator1 last1,
+                                                     InputIterator2 first2,
+                                                     BinaryPredicate predicate,
+                                                     const std::string& cl_code)
+{
+    size_t index = detail::mismatch_detect_random_access( ctl, first1, last1, first2, predicate, false, cl_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+    return std::make_pair( first1 + index, first2 + index );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+std::pair< InputIterator1, InputIterator2 > mismatch(InputIterator1 first1,
+                                                     InputIterator1 last1,
+                                                     InputIterator2 first2,
+                                                     BinaryPredicate predicate,
+                                                     const std::string& cl_code)
+{
+    return bolt::cl::mismatch( control::getDefault( ), first1, last1, first2, predicate, cl_code );
+}
+
+namespace detail {
+
+enum mismatchTypes { mismatch_iType1, mismatch_iIterType1, mismatch_iType2, mismatch_iIterType2,
+                     mismatch_BinaryPredicate, mismatch_end };
+
+class Mismatch_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    Mismatch_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("mismatchTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value types and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[mismatch_iType1] + "* input_ptr1,\n"
+            + typeNames[mismatch_iIterType1] + " input_iter1,\n"
+            "global " + typeNames[mismatch_iType2] + "* input_ptr2,\n"
+            + typeNames[mismatch_iIterType2] + " input_iter2,\n"
+            "global " + typeNames[mismatch_BinaryPredicate] + "* userFunctor,\n"
+            "const uint length,\n"
+            "volatile global int* stopTile,\n"
+            "global int* groupResults,\n"
+            "local int* scratch\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  Returns the offset of the first pair that does not match, or the length of the first sequence.  The kernel always
+//  looks for the first mismatch; equal still gains from the early exit, since nothing past it is read.
+template< typename DVInputIterator1, typename DVInputIterator2, typename BinaryPredicate >
+size_t mismatch_enqueue( control &ctl, const DVInputIterator1& first1, const DVInputIterator1& last1,
+                         const DVInputIterator2& first2, const BinaryPredicate& predicate,
+                         const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVInputIterator1 >::value_type iType1;
+    typedef typename std::iterator_traits< DVInputIterator2 >::value_type iType2;
+
+    std::vector< std::string > typeNames( mismatch_end );
+    typeNames[ mismatch_iType1 ] = TypeName< iType1 >::get( );
+    typeNames[ mismatch_iIterType1 ] = TypeName< DVInputIterator1 >::get( );
+    typeNames[ mismatch_iType2 ] = TypeName< iType2 >::get( );
+    typeNames[ mismatch_iIterType2 ] = TypeName< DVInputIterator2 >::get( );
+    typeNames[ mismatch_BinaryPredicate ] = TypeName< BinaryPredicate >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType1 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator1 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType2 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator2 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryPredicate >::get( ) )
+
+    Mismatch_KernelTemplateSpecializer mismatch_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &mismatch_kts, typeDefinitions,
+                                                                find_kernels, findCompileOptions( ) );
+
+    // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
+    ALIGNED( 256 ) BinaryPredicate aligned_predicate( predicate );
+    control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_predicate ),
+        CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_predicate );
+
+    V_OPENCL( kernels[ 0 ].setArg( 0, first1.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 1, first1.gpuPayloadSize( ), &first1.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 2, first2.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 3, first2.gpuPayloadSize( ), &first2.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 4, *userFunctor ), "Error setting kernel argument" );
+
+    return find_first_launch( ctl, kernels[ 0 ], 5, static_cast< cl_uint >( first1.distance_to( last1 ) ) );
+}
+
+template< typename InputIterator1, typename InputIterator2, typename BinaryPredicate >
+size_t mismatch_cpu( bolt::cl::control::e_RunMode runMode, InputIterator1 first1, size_t numElements,
+                     InputIterator2 first2, const BinaryPredicate& predicate, bool anyMatch )
+{
+    if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        return bolt::btbb::detail::find_first_index( bolt::btbb::detail::MismatchMatcher_tbb< InputIterator1,
+            InputIterator2, BinaryPredicate >( first1, first2, predicate ), numElements, anyMatch );
+#else
+        throw std::exception( "The MultiCoreCpu version of mismatch is not enabled to be built! \n" );
+#endif
+    }
+
+    for( size_t i = 0; i < numElements; ++i )
+    {
+        if( !predicate( first1[ i ], first2[ i ] ) )
+            return i;
+    }
+    return numElements;
+}
+
+template< typename InputIterator1, typename InputIterator2, typename BinaryPredicate >
+size_t mismatch_detect_random_access( control &ctl, const InputIterator1& first1, const InputIterator1& last1,
+                                      const InputIterator2& first2, const BinaryPredicate& predicate,
+                                      bool anyMatch, const std::string& cl_code, std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator1, typename InputIterator2, typename BinaryPredicate >
+size_t mismatch_detect_random_access( control &ctl, const InputIterator1& first1, const InputIterator1& last1,
+                                      const InputIterator2& first2, const BinaryPredicate& predicate,
+                                      bool anyMatch, const std::string& cl_code, bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "Fancy iterators are not supported by mismatch" );
+};
+
+template< typename InputIterator1, typename InputIterator2, typename BinaryPredicate >
+size_t mismatch_detect_random_access( control &ctl, const InputIterator1& first1, const InputIterator1& last1,
+                                      const InputIterator2& first2, const BinaryPredicate& predicate,
+                                      bool anyMatch, const std::string& cl_code, std::random_access_iterator_tag )
+{
+    if( first1 == last1 )
+        return 0;
+
+    return mismatch_pick_iterator( ctl, first1, last1, first2, predicate, anyMatch, cl_code,
+                                   std::iterator_traits< InputIterator1 >::iterator_category( ) );
+};
+
+//Device Vector specialization; the second sequence has to live in a device_vector as well.
+template< typename DVInputIterator1, typename DVInputIterator2, typename BinaryPredicate >
+size_t mismatch_pick_iterator( control &ctl, const DVInputIterator1& first1, const DVInputIterator1& last1,
+                               const DVInputIterator2& first2, const BinaryPredicate& predicate,
+                               bool anyMatch, const std::string& cl_code, bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator1 >::value_type iType1;
+    typedef typename std::iterator_traits< DVInputIterator2 >::value_type iType2;
+    size_t szElements = static_cast< size_t >( last1 - first1 );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< iType1 >::pointer firstPtr1 = first1.getContainer( ).data( );
+        bolt::cl::device_vector< iType2 >::pointer firstPtr2 = first2.getContainer( ).data( );
+        return mismatch_cpu( runMode, &firstPtr1[ first1.m_Index ], szElements, &firstPtr2[ first2.m_Index ],
+                             predicate, anyMatch );
+    }
+
+    return mismatch_enqueue( ctl, first1, last1, first2, predicate, cl_code );
+};
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in device_vectors and calls the device_vector specialization.
+template< typename InputIterator1, typename InputIterator2, typename BinaryPredicate >
+size_t mismatch_pick_iterator( control &ctl, const InputIterator1& first1, const InputIterator1& last1,
+                               const InputIterator2& first2, const BinaryPredicate& predicate,
+                               bool anyMatch, const std::string& cl_code, std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type iType1;
+    typedef typename std::iterator_traits< InputIterator2 >::value_type iType2;
+    size_t szElements = static_cast< size_t >( last1 - first1 );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        return mismatch_cpu( runMode, first1, szElements, first2, predicate, anyMatch );
+    }
+
+    device_vector< iType1 > dvInput1( first1, last1, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+    device_vector< iType2 > dvInput2( first2, first2 + szElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+    return mismatch_enqueue( ctl, dvInput1.begin( ), dvInput1.end( ), dvInput2.begin( ), predicate, cl_code );
+};
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
@@ -0,0 +1,1132 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_PARTIAL_SORT_INL )
+#define BOLT_CL_PARTIAL_SORT_INL
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/sort.h"
+#include "bolt/cl/sort_by_key.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/partial_sort.h"
+#endif
+
+#define RADIX_SELECT_BITS 8
+#define RADIX_SELECT_BINS ( 1 << RADIX_SELECT_BITS )
+#define RADIX_SELECT_WGSIZE 256
+
+namespace bolt {
+namespace cl {
+
+/**********************************************************************************************************************
+ * partial_sort
+ *********************************************************************************************************************/
+template<typename RandomAccessIterator>
+void partial_sort(RandomAccessIterator first,
+                  RandomAccessIterator middle,
+                  RandomAccessIterator last,
+                  const std::string& cl_code)
+{
+    typedef std::iterator_traits< RandomAccessIterator >::value_type T;
+    detail::select_detect_random_access( control::getDefault( ), first, middle, last, less< T >( ), cl_code, true,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+template<typename RandomAccessIterator, typename StrictWeakOrdering>
+void partial_sort(RandomAccessIterator first,
+                  RandomAccessIterator middle,
+                  RandomAccessIterator last,
+                  StrictWeakOrdering comp,
+                  const std::string& cl_code)
+{
+    detail::select_detect_random_access( control::getDefault( ), first, middle, last, comp, cl_code, true,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+template<typename RandomAccessIterator>
+void partial_sort(control &ctl,
+                  RandomAccessIterator first,
+                  RandomAccessIterator middle,
+                  RandomAccessIterator last,
+                  const std::string& cl_code)
+{
+    typedef std::iterator_traits< RandomAccessIterator >::value_type T;
+    detail::select_detect_random_access( ctl, first, middle, last, less< T >( ), cl_code, true,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+template<typename RandomAccessIterator, typename StrictWeakOrdering>
+void partial_sort(control &ctl,
+                  RandomAccessIterator first,
+                  RandomAccessIterator middle,
+                  RandomAccessIterator last,
+                  StrictWeakOrdering comp,
+                  const std::string& cl_code)
+{
+    detail::select_detect_random_access( ctl, first, middle, last, comp, cl_code, true,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+/**********************************************************************************************************************
+ * nth_element
+ *********************************************************************************************************************/
+template<typename RandomAccessIterator>
+void nth_element(RandomAccessIterator first,
+                 RandomAccessIterator nth,
+                 RandomAccessIterator last,
+                 const std::string& cl_code)
+{
+    typedef std::iterator_traits< RandomAccessIterator >::value_type T;
+    detail::select_detect_random_access( control::getDefault( ), first, nth, last, less< T >( ), cl_code, false,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+template<typename RandomAccessIterator, typename StrictWeakOrdering>
+void nth_element(RandomAccessIterator first,
+                 RandomAccessIterator nth,
+                 RandomAccessIterator last,
+                 StrictWeakOrdering comp,
+                 const std::string& cl_code)
+{
+    detail::select_detect_random_access( control::getDefault( ), first, nth, last, comp, cl_code, false,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+template<typename RandomAccessIterator>
+void nth_element(control &ctl,
+                 RandomAccessIterator first,
+                 RandomAccessIterator nth,
+                 RandomAccessIterator last,
+                 const std::string& cl_code)
+{
+    typedef std::iterator_traits< RandomAccessIterator >::value_type T;
+    detail::select_detect_random_access( ctl, first, nth, last, less< T >( ), cl_code, false,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+template<typename RandomAccessIterator, typename StrictWeakOrdering>
+void nth_element(control &ctl,
+                 RandomAccessIterator first,
+                 RandomAccessIterator nth,
+                 RandomAccessIterator last,
+                 StrictWeakOrdering comp,
+                 const std::string& cl_code)
+{
+    detail::select_detect_random_access( ctl, first, nth, last, comp, cl_code, false,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+/**********************************************************************************************************************
+ * top_k
+ *********************************************************************************************************************/
+template<typename InputIterator, typename OutputIterator>
+OutputIterator top_k(InputIterator first,
+                     InputIterator last,
+                     size_t k,
+                     OutputIterator result,
+                     const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator >::value_type T;
+    return detail::top_k_detect_random_access( control::getDefault( ), first, last, k, result, greater< T >( ),
+        cl_code, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator top_k(InputIterator first,
+                     InputIterator last,
+                     size_t k,
+                     OutputIterator result,
+                     StrictWeakOrdering comp,
+                     const std::string& cl_code)
+{
+    return detail::top_k_detect_random_access( control::getDefault( ), first, last, k, result, comp, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OutputIterator>
+OutputIterator top_k(control &ctl,
+                     InputIterator first,
+                     InputIterator last,
+                     size_t k,
+                     OutputIterator result,
+                     const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator >::value_type T;
+    return detail::top_k_detect_random_access( ctl, first, last, k, result, greater< T >( ), cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+OutputIterator top_k(control &ctl,
+                     InputIterator first,
+                     InputIterator last,
+                     size_t k,
+                     OutputIterator result,
+                     StrictWeakOrdering comp,
+                     const std::string& cl_code)
+{
+    return detail::top_k_detect_random_access( ctl, first, last, k, result, comp, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+/**********************************************************************************************************************
+ * top_k_by_key
+ *********************************************************************************************************************/
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2>
+pair<OutputIterator1, OutputIterator2>
+top_k_by_key(InputIterator1 keys_first,
+             InputIterator1 keys_last,
+             InputIterator2 values_first,
+             size_t k,
+             OutputIterator1 keys_result,
+             OutputIterator2 values_result,
+             const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type kType;
+    return detail::top_k_by_key_detect_random_access( control::getDefault( ), keys_first, keys_last, values_first,
+        k, keys_result, values_result, greater< kType >( ), cl_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2,
+         typename StrictWeakOrdering>
+pair<OutputIterator1, OutputIterator2>
+top_k_by_key(InputIterator1 keys_first,
+             InputIterator1 keys_last,
+             InputIterator2 values_first,
+             size_t k,
+             OutputIterator1 keys_result,
+             OutputIterator2 values_result,
+             StrictWeakOrdering comp,
+             const std::string& cl_code)
+{
+    return detail::top_k_by_key_detect_random_access( control::getDefault( ), keys_first, keys_last, values_first,
+        k, keys_result, values_result, comp, cl_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2>
+pair<OutputIterator1, OutputIterator2>
+top_k_by_key(control &ctl,
+             InputIterator1 keys_first,
+             InputIterator1 keys_last,
+             InputIterator2 values_first,
+             size_t k,
+             OutputIterator1 keys_result,
+             OutputIterator2 values_result,
+             const std::string& cl_code)
+{
+    typedef std::iterator_traits< InputIterator1 >::value_type kType;
+    return detail::top_k_by_key_detect_random_access( ctl, keys_first, keys_last, values_first,
+        k, keys_result, values_result, greater< kType >( ), cl_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2,
+         typename StrictWeakOrdering>
+pair<OutputIterator1, OutputIterator2>
+top_k_by_key(control &ctl,
+             InputIterator1 keys_first,
+             InputIterator1 keys_last,
+             InputIterator2 values_first,
+             size_t k,
+             OutputIterator1 keys_result,
+             OutputIterator2 values_result,
+             StrictWeakOrdering comp,
+             const std::string& cl_code)
+{
+    return detail::top_k_by_key_detect_random_access( ctl, keys_first, keys_last, values_first,
+        k, keys_result, values_result, comp, cl_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+namespace bolt {
+namespace cl {
+namespace detail {
+
+enum radixSelectTypes { radixSelect_kType, radixSelect_kIterType, radixSelect_vType, radixSelect_vIterType,
+                        radixSelect_end };
+
+class RadixSelect_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    RadixSelect_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("radixSelectHistogramTemplate");
+        addKernelName("radixSelectPartitionTemplate");
+        addKernelName("radixSelectTopKTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[radixSelect_kType] + "* keys_ptr,\n"
+            + typeNames[radixSelect_kIterType] + " keys_iter,\n"
+            "const uint length,\n"
+            "const uint prefix,\n"
+            "const uint prefixMask,\n"
+            "const uint shiftCount,\n"
+            "const uint flipBits,\n"
+            "global uint* histogram,\n"
+            "local uint* ldsHistogram\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(1) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(1) + "(\n"
+            "global " + typeNames[radixSelect_kType] + "* keys_ptr,\n"
+            + typeNames[radixSelect_kIterType] + " keys_iter,\n"
+            "const uint length,\n"
+            "const uint prefix,\n"
+            "const uint prefixMask,\n"
+            "const uint flipBits,\n"
+            "const uint equalBase,\n"
+            "global " + typeNames[radixSelect_kType] + "* output,\n"
+            "global uint* counters,\n"
+            "local uint* ldsCounters\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(2) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(2) + "(\n"
+            "global " + typeNames[radixSelect_kType] + "* keys_ptr,\n"
+            + typeNames[radixSelect_kIterType] + " keys_iter,\n"
+            "global " + typeNames[radixSelect_vType] + "* values_ptr,\n"
+            + typeNames[radixSelect_vIterType] + " values_iter,\n"
+            "const uint length,\n"
+            "const uint prefix,\n"
+            "const uint prefixMask,\n"
+            "const uint flipBits,\n"
+            "const uint equalBase,\n"
+            "const uint k,\n"
+            "global " + typeNames[radixSelect_kType] + "* keys_output,\n"
+            "global " + typeNames[radixSelect_vType] + "* values_output,\n"
+            "global uint* counters,\n"
+            "local uint* ldsCounters\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  Radix select needs keys whose order can be read off their bits, compared with the default less or greater
+//  functors.  Every other combination falls back to sorting on the device.
+template< typename T >
+struct radix_select_key : std::integral_constant< bool,
+    std::is_same< T, cl_int >::value || std::is_same< T, cl_uint >::value || std::is_same< T, cl_float >::value >
+{
+};
+
+template< typename T, typename StrictWeakOrdering >
+struct radix_select_traits : std::false_type
+{
+    static const cl_uint flipBits = 0;
+};
+
+template< typename T >
+struct radix_select_traits< T, bolt::cl::less< T > > : radix_select_key< T >
+{
+    static const cl_uint flipBits = 0;
+};
+
+template< typename T >
+struct radix_select_traits< T, bolt::cl::greater< T > > : radix_select_key< T >
+{
+    static const cl_uint flipBits = 0xFFFFFFFF;
+};
+
+template< typename DVKeys, typename DVValues >
+std::vector< ::cl::Kernel > radix_select_kernels( control &ctl, const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVKeys >::value_type kType;
+    typedef typename std::iterator_traits< DVValues >::value_type vType;
+
+    std::vector< std::string > typeNames( radixSelect_end );
+    typeNames[ radixSelect_kType ] = TypeName< kType >::get( );
+    typeNames[ radixSelect_kIterType ] = TypeName< DVKeys >::get( );
+    typeNames[ radixSelect_vType ] = TypeName< vType >::get( );
+    typeNames[ radixSelect_vIterType ] = TypeName< DVValues >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< kType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVKeys >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< vType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVValues >::get( ) )
+
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << RADIX_SELECT_WGSIZE;
+
+    RadixSelect_KernelTemplateSpecializer rs_kts;
+    return bolt::cl::getKernels( ctl, typeNames, &rs_kts, typeDefinitions, partial_sort_kernels, oss.str( ) );
+}
+
+//  Finds the bit pattern of the element of the given rank, one 8-bit digit per pass, starting with the most
+//  significant digit.  Each pass only histograms the elements that still share the digits chosen so far.  Returns the
+//  number of elements that order strictly before the selected prefix.
+template< typename DVKeys >
+cl_uint radix_select_prefix( control &ctl, ::cl::Kernel& histogramKernel,
+                             const DVKeys& first, cl_uint szElements, cl_uint rank, cl_uint flipBits,
+                             cl_uint& prefix, cl_uint& prefixMask )
+{
+    cl_int l_Error = CL_SUCCESS;
+
+    cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+    size_t numWG = computeUnits * ctl.getWGPerComputeUnit( );
+    size_t neededWG = ( szElements + RADIX_SELECT_WGSIZE - 1 ) / RADIX_SELECT_WGSIZE;
+    numWG = std::min( numWG, neededWG );
+
+    control::buffPointer histogram = ctl.acquireBuffer( RADIX_SELECT_BINS * sizeof( cl_uint ),
+                                                        CL_MEM_ALLOC_HOST_PTR | CL_MEM_READ_WRITE );
+
+    ::cl::LocalSpaceArg ldsHistogram;
+    ldsHistogram.size_ = RADIX_SELECT_BINS * sizeof( cl_uint );
+
+    V_OPENCL( histogramKernel.setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( histogramKernel.setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( histogramKernel.setArg( 2, szElements ), "Error setting kernel argument" );
+    V_OPENCL( histogramKernel.setArg( 6, flipBits ), "Error setting kernel argument" );
+    V_OPENCL( histogramKernel.setArg( 7, *histogram ), "Error setting kernel argument" );
+    V_OPENCL( histogramKernel.setArg( 8, ldsHistogram ), "Error setting kernel argument" );
+
+    cl_uint lessCount = 0;
+    prefix = 0;
+    prefixMask = 0;
+    for( int shiftCount = 32 - RADIX_SELECT_BITS; shiftCount >= 0; shiftCount -= RADIX_SELECT_BITS )
+    {
+        ::cl::Event fillEvent;
+        l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *histogram, 0, 0, RADIX_SELECT_BINS * sizeof( cl_uint ),
+                                                            NULL, &fillEvent );
+        V_OPENCL( l_Error, "enqueueFillBuffer() failed for the radix select histogram" );
+
+        V_OPENCL( histogramKernel.setArg( 3, prefix ), "Error setting kernel argument" );
+        V_OPENCL( histogramKernel.setArg( 4, prefixMask ), "Error setting kernel argument" );
+        V_OPENCL( histogramKernel.setArg( 5, static_cast< cl_uint >( shiftCount ) ), "Error setting kernel argument" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            histogramKernel,
+            ::cl::NullRange,
+            ::cl::NDRange( numWG * RADIX_SELECT_WGSIZE ),
+            ::cl::NDRange( RADIX_SELECT_WGSIZE ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for radixSelectHistogram kernel" );
+
+        ::cl::Event mapEvent;
+        cl_uint* h_histogram = static_cast< cl_uint* >( ctl.getCommandQueue( ).enqueueMapBuffer( *histogram, false,
+            CL_MAP_READ, 0, RADIX_SELECT_BINS * sizeof( cl_uint ), NULL, &mapEvent, &l_Error ) );
+        V_OPENCL( l_Error, "Error calling map on the radix select histogram" );
+        bolt::cl::wait( ctl, mapEvent );
+
+        //  Walk the bins until the one holding the requested rank
+        cl_uint bin = 0;
+        while( lessCount + h_histogram[ bin ] <= rank )
+        {
+            lessCount += h_histogram[ bin ];
+            ++bin;
+        }
+        cl_uint binCount = h_histogram[ bin ];
+
+        ::cl::Event unmapEvent;
+        V_OPENCL( ctl.getCommandQueue( ).enqueueUnmapMemObject( *histogram, h_histogram, NULL, &unmapEvent ),
+                  "shared_ptr failed to unmap host memory back to device memory" );
+        V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+
+        prefix |= bin << shiftCount;
+        prefixMask |= ( RADIX_SELECT_BINS - 1 ) << shiftCount;
+
+        //  A single remaining candidate already identifies the element; the lower digits do not matter
+        if( binCount == 1 )
+            break;
+    }
+
+    return lessCount;
+}
+
+//  Radix select specialization: partitions [first, last) into a temporary buffer around the element of rank
+//  nthIndex, optionally sorts the part in front of it, and copies the result back into the input.
+template< typename DVRandomAccessIterator, typename StrictWeakOrdering >
+void select_enqueue( control &ctl,
+                     const DVRandomAccessIterator& first, size_t nthIndex, const DVRandomAccessIterator& last,
+                     const StrictWeakOrdering& comp, const std::string& cl_code, bool sortHead,
+                     std::true_type )
+{
+    typedef typename std::iterator_traits< DVRandomAccessIterator >::value_type T;
+    typedef radix_select_traits< T, StrictWeakOrdering > traits;
+
+    cl_uint szElements = static_cast< cl_uint >( first.distance_to( last ) );
+    std::vector< ::cl::Kernel > kernels = radix_select_kernels< DVRandomAccessIterator, DVRandomAccessIterator >(
+        ctl, cl_code );
+
+    cl_uint prefix, prefixMask;
+    cl_uint lessCount = radix_select_prefix( ctl, kernels[ 0 ], first, szElements,
+                                             static_cast< cl_uint >( nthIndex ), traits::flipBits,
+                                             prefix, prefixMask );
+
+    cl_int l_Error = CL_SUCCESS;
+    cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+    size_t numWG = computeUnits * ctl.getWGPerComputeUnit( );
+    size_t neededWG = ( szElements + RADIX_SELECT_WGSIZE - 1 ) / RADIX_SELECT_WGSIZE;
+    numWG = std::min( numWG, neededWG );
+
+    device_vector< T > dvPartitioned( szElements, T( ), CL_MEM_READ_WRITE, false, ctl );
+    control::buffPointer counters = ctl.acquireBuffer( 3 * sizeof( cl_uint ) );
+
+    ::cl::Event fillEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *counters, 0, 0, 3 * sizeof( cl_uint ), NULL, &fillEvent );
+    V_OPENCL( l_Error, "enqueueFillBuffer() failed for the radix select counters" );
+
+    ::cl::LocalSpaceArg ldsCounters;
+    ldsCounters.size_ = 6 * sizeof( cl_uint );
+
+    V_OPENCL( kernels[ 1 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 2, szElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 3, prefix ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 4, prefixMask ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 5, traits::flipBits ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 6, lessCount ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 7, dvPartitioned.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 8, *counters ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 9, ldsCounters ), "Error setting kernel argument" );
+
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 1 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numWG * RADIX_SELECT_WGSIZE ),
+        ::cl::NDRange( RADIX_SELECT_WGSIZE ) );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for radixSelectPartition kernel" );
+
+    //  Everything in front of the selected element was moved to the head; only that part needs ordering
+    if( sortHead && lessCount > 1 )
+        bolt::cl::sort( ctl, dvPartitioned.begin( ), dvPartitioned.begin( ) + lessCount, comp, cl_code );
+
+    ::cl::Event copyEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( dvPartitioned.getBuffer( ), first.getContainer( ).getBuffer( ),
+        0, first.m_Index * sizeof( T ), szElements * sizeof( T ), NULL, &copyEvent );
+    V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the radix select result" );
+    bolt::cl::wait( ctl, copyEvent );
+}
+
+//  Generic specialization: the selection falls out of a device sort of the whole range.  The sort runs on a
+//  zero-based copy because not every sort specialization honours the offset of the input iterator.
+template< typename DVRandomAccessIterator, typename StrictWeakOrdering >
+void select_enqueue( control &ctl,
+                     const DVRandomAccessIterator& first, size_t nthIndex, const DVRandomAccessIterator& last,
+                     const StrictWeakOrdering& comp, const std::string& cl_code, bool sortHead,
+                     std::false_type )
+{
+    typedef typename std::iterator_traits< DVRandomAccessIterator >::value_type T;
+
+    cl_int l_Error = CL_SUCCESS;
+    size_t szElements = static_cast< size_t >( first.distance_to( last ) );
+    device_vector< T > dvSorted( szElements, T( ), CL_MEM_READ_WRITE, false, ctl );
+
+    ::cl::Event copyInEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( first.getContainer( ).getBuffer( ), dvSorted.getBuffer( ),
+        first.m_Index * sizeof( T ), 0, szElements * sizeof( T ), NULL, &copyInEvent );
+    V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the selection input" );
+    bolt::cl::wait( ctl, copyInEvent );
+
+    bolt::cl::sort( ctl, dvSorted.begin( ), dvSorted.end( ), comp, cl_code );
+
+    ::cl::Event copyOutEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( dvSorted.getBuffer( ), first.getContainer( ).getBuffer( ),
+        0, first.m_Index * sizeof( T ), szElements * sizeof( T ), NULL, &copyOutEvent );
+    V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the selection result" );
+    bolt::cl::wait( ctl, copyOutEvent );
+}
+
+//  Radix select specialization of top_k: writes the first k keys (and values) straight into k-sized buffers, sorts
+//  them, and copies them to the outputs.  When hasValues is false the keys stand in for the values.
+template< typename DVKeys, typename DVValues, typename DVKeysOut, typename DVValuesOut, typename StrictWeakOrdering >
+void top_k_enqueue( control &ctl,
+                    const DVKeys& keys_first, const DVKeys& keys_last, const DVValues& values_first,
+                    size_t k, const DVKeysOut& keys_result, const DVValuesOut& values_result,
+                    const StrictWeakOrdering& comp, const std::string& cl_code, bool hasValues,
+                    std::true_type )
+{
+    typedef typename std::iterator_traits< DVKeys >::value_type kType;
+    typedef typename std::iterator_traits< DVValues >::value_type vType;
+    typedef radix_select_traits< kType, StrictWeakOrdering > traits;
+
+    cl_uint szElements = static_cast< cl_uint >( keys_first.distance_to( keys_last ) );
+    std::vector< ::cl::Kernel > kernels = radix_select_kernels< DVKeys, DVValues >( ctl, cl_code );
+
+    cl_uint prefix, prefixMask;
+    cl_uint lessCount = radix_select_prefix( ctl, kernels[ 0 ], keys_first, szElements,
+                                             static_cast< cl_uint >( k - 1 ), traits::flipBits,
+                                             prefix, prefixMask );
+
+    cl_int l_Error = CL_SUCCESS;
+    cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+    size_t numWG = computeUnits * ctl.getWGPerComputeUnit( );
+    size_t neededWG = ( szElements + RADIX_SELECT_WGSIZE - 1 ) / RADIX_SELECT_WGSIZE;
+    numWG = std::min( numWG, neededWG );
+
+    device_vector< kType > dvKeys( k, kType( ), CL_MEM_READ_WRITE, false, ctl );
+    device_vector< vType > dvValues( hasValues ? k : 1, vType( ), CL_MEM_READ_WRITE, false, ctl );
+    control::buffPointer counters = ctl.acquireBuffer( 2 * sizeof( cl_uint ) );
+
+    ::cl::Event fillEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *counters, 0, 0, 2 * sizeof( cl_uint ), NULL, &fillEvent );
+    V_OPENCL( l_Error, "enqueueFillBuffer() failed for the radix select counters" );
+
+    ::cl::LocalSpaceArg ldsCounters;
+    ldsCounters.size_ = 4 * sizeof( cl_uint );
+
+    V_OPENCL( kernels[ 2 ].setArg( 0, keys_first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 1, keys_first.gpuPayloadSize( ), &keys_first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 2, values_first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 3, values_first.gpuPayloadSize( ), &values_first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 4, szElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 5, prefix ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 6, prefixMask ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 7, traits::flipBits ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 8, lessCount ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 9, static_cast< cl_uint >( k ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 10, dvKeys.getBuffer( ) ), "Error setting kernel argument" );
+    //  Without values the key is written twice to the same slot, which is harmless
+    V_OPENCL( kernels[ 2 ].setArg( 11, hasValues ? dvValues.getBuffer( ) : dvKeys.getBuffer( ) ),
+              "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 12, *counters ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 2 ].setArg( 13, ldsCounters ), "Error setting kernel argument" );
+
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 2 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numWG * RADIX_SELECT_WGSIZE ),
+        ::cl::NDRange( RADIX_SELECT_WGSIZE ) );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for radixSelectTopK kernel" );
+
+    //  The keys matching the selected prefix are identical, so only the head in front of them needs sorting
+    if( lessCount > 1 )
+    {
+        if( hasValues )
+            bolt::cl::sort_by_key( ctl, dvKeys.begin( ), dvKeys.begin( ) + lessCount, dvValues.begin( ), comp,
+                                   cl_code );
+        else
+            bolt::cl::sort( ctl, dvKeys.begin( ), dvKeys.begin( ) + lessCount, comp, cl_code );
+    }
+
+    ::cl::Event keysEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( dvKeys.getBuffer( ), keys_result.getContainer( ).getBuffer( ),
+        0, keys_result.m_Index * sizeof( kType ), k * sizeof( kType ), NULL, &keysEvent );
+    V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the top_k keys" );
+    bolt::cl::wait( ctl, keysEvent );
+
+    if( hasValues )
+    {
+        ::cl::Event valuesEvent;
+        l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( dvValues.getBuffer( ),
+            values_result.getContainer( ).getBuffer( ), 0, values_result.m_Index * sizeof( vType ),
+            k * sizeof( vType ), NULL, &valuesEvent );
+        V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the top_k values" );
+        bolt::cl::wait( ctl, valuesEvent );
+    }
+}
+
+//  Generic specialization of top_k: sorts a copy of the whole input on the device and keeps the first k elements.
+template< typename DVKeys, typename DVValues, typename DVKeysOut, typename DVValuesOut, typename StrictWeakOrdering >
+void top_k_enqueue( control &ctl,
+                    const DVKeys& keys_first, const DVKeys& keys_last, const DVValues& values_first,
+                    size_t k, const DVKeysOut& keys_result, const DVValuesOut& values_result,
+                    const StrictWeakOrdering& comp, const std::string& cl_code, bool hasValues,
+                    std::false_type )
+{
+    typedef typename std::iterator_traits< DVKeys >::value_type kType;
+    typedef typename std::iterator_traits< DVValues >::value_type vType;
+
+    cl_int l_Error = CL_SUCCESS;
+    size_t szElements = static_cast< size_t >( keys_first.distance_to( keys_last ) );
+    device_vector< kType > dvKeys( szElements, kType( ), CL_MEM_READ_WRITE, false, ctl );
+    device_vector< vType > dvValues( hasValues ? szElements : 1, vType( ), CL_MEM_READ_WRITE, false, ctl );
+
+    ::cl::Event keysInEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( keys_first.getContainer( ).getBuffer( ), dvKeys.getBuffer( ),
+        keys_first.m_Index * sizeof( kType ), 0, szElements * sizeof( kType ), NULL, &keysInEvent );
+    V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the top_k keys" );
+    bolt::cl::wait( ctl, keysInEvent );
+
+    if( hasValues )
+    {
+        ::cl::Event valuesInEvent;
+        l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( values_first.getContainer( ).getBuffer( ),
+            dvValues.getBuffer( ), values_first.m_Index * sizeof( vType ), 0, szElements * sizeof( vType ), NULL,
+            &valuesInEvent );
+        V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the top_k values" );
+        bolt::cl::wait( ctl, valuesInEvent );
+
+        bolt::cl::sort_by_key( ctl, dvKeys.begin( ), dvKeys.end( ), dvValues.begin( ), comp, cl_code );
+    }
+    else
+    {
+        bolt::cl::sort( ctl, dvKeys.begin( ), dvKeys.end( ), comp, cl_code );
+    }
+
+    ::cl::Event keysEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( dvKeys.getBuffer( ), keys_result.getContainer( ).getBuffer( ),
+        0, keys_result.m_Index * sizeof( kType ), k * sizeof( kType ), NULL, &keysEvent );
+    V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the top_k keys" );
+    bolt::cl::wait( ctl, keysEvent );
+
+    if( hasValues )
+    {
+        ::cl::Event valuesEvent;
+        l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( dvValues.getBuffer( ),
+            values_result.getContainer( ).getBuffer( ), 0, values_result.m_Index * sizeof( vType ),
+            k * sizeof( vType ), NULL, &valuesEvent );
+        V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the top_k values" );
+        bolt::cl::wait( ctl, valuesEvent );
+    }
+}
+
+//  Serial top_k_by_key: zips keys and values like serialCPU_sort_by_key, but only orders the first k records
+template< typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2,
+          typename StrictWeakOrdering >
+void serialCPU_top_k_by_key( const InputIterator1 keys_first, const InputIterator1 keys_last,
+                             const InputIterator2 values_first, size_t k,
+                             const OutputIterator1 keys_result, const OutputIterator2 values_result,
+                             const StrictWeakOrdering& comp )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type keyType;
+    typedef typename std::iterator_traits< InputIterator2 >::value_type valType;
+    typedef std_sort< keyType, valType > KeyValuePair;
+    typedef std_sort_comp< keyType, valType, StrictWeakOrdering > KeyValuePairFunctor;
+
+    size_t vecSize = std::distance( keys_first, keys_last );
+    std::vector< KeyValuePair > KeyValuePairVector( vecSize );
+    KeyValuePairFunctor functor( comp );
+    for( size_t i = 0; i < vecSize; i++ )
+    {
+        KeyValuePairVector[ i ].key   = *( keys_first + i );
+        KeyValuePairVector[ i ].value = *( values_first + i );
+    }
+    std::partial_sort( KeyValuePairVector.begin( ), KeyValuePairVector.begin( ) + k, KeyValuePairVector.end( ),
+                       functor );
+    for( size_t i = 0; i < k; i++ )
+    {
+        *( keys_result + i )   = KeyValuePairVector[ i ].key;
+        *( values_result + i ) = KeyValuePairVector[ i ].value;
+    }
+}
+
+//  CPU selection shared by the host and device_vector paths; sortHead tells partial_sort from nth_element
+template< typename RandomAccessIterator, typename StrictWeakOrdering >
+void select_cpu( bolt::cl::control::e_RunMode runMode,
+                 RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last,
+                 const StrictWeakOrdering& comp, bool sortHead )
+{
+    if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        if( sortHead )
+            bolt::btbb::partial_sort( first, nth + 1, last, comp );
+        else
+            bolt::btbb::nth_element( first, nth, last, comp );
+#else
+        throw std::exception( "The MultiCoreCpu version of partial_sort is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        if( sortHead )
+            std::partial_sort( first, nth + 1, last, comp );
+        else
+            std::nth_element( first, nth, last, comp );
+    }
+}
+
+template< typename RandomAccessIterator, typename StrictWeakOrdering >
+void select_detect_random_access( control &ctl,
+                                  const RandomAccessIterator& first, const RandomAccessIterator& nth,
+                                  const RandomAccessIterator& last,
+                                  const StrictWeakOrdering& comp, const std::string& cl_code, bool sortHead,
+                                  std::input_iterator_tag )
+{
+    //  \TODO:  It should be possible to support non-random_access_iterator_tag iterators, if we copied the data
+    //  to a temporary buffer.  Should we?
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename RandomAccessIterator, typename StrictWeakOrdering >
+void select_detect_random_access( control &ctl,
+                                  const RandomAccessIterator& first, const RandomAccessIterator& nth,
+                                  const RandomAccessIterator& last,
+                                  const StrictWeakOrdering& comp, const std::string& cl_code, bool sortHead,
+                                  bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "It is not possible to sort fancy iterators. They are not mutable" );
+};
+
+template< typename RandomAccessIterator, typename StrictWeakOrdering >
+void select_detect_random_access( control &ctl,
+                                  const RandomAccessIterator& first, const RandomAccessIterator& nth,
+                                  const RandomAccessIterator& last,
+                                  const StrictWeakOrdering& comp, const std::string& cl_code, bool sortHead,
+                                  std::random_access_iterator_tag )
+{
+    //  partial_sort hands over its middle; the last element of the sorted head is the one to select
+    if( sortHead )
+    {
+        if( nth == first )
+            return;
+        select_pick_iterator( ctl, first, nth - 1, last, comp, cl_code, sortHead,
+                              std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+    }
+    else
+    {
+        if( nth == last )
+            return;
+        select_pick_iterator( ctl, first, nth, last, comp, cl_code, sortHead,
+                              std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+    }
+};
+
+//Device Vector specialization
+template< typename DVRandomAccessIterator, typename StrictWeakOrdering >
+void select_pick_iterator( control &ctl,
+                           const DVRandomAccessIterator& first, const DVRandomAccessIterator& nth,
+                           const DVRandomAccessIterator& last,
+                           const StrictWeakOrdering& comp, const std::string& cl_code, bool sortHead,
+                           bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVRandomAccessIterator >::value_type T;
+    size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+    if( szElements < 2 )
+        return;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< T >::pointer firstPtr = first.getContainer( ).data( );
+        select_cpu( runMode, &firstPtr[ first.m_Index ], &firstPtr[ nth.m_Index ], &firstPtr[ last.m_Index ],
+                    comp, sortHead );
+    }
+    else
+    {
+        select_enqueue( ctl, first, static_cast< size_t >( nth - first ), last, comp, cl_code, sortHead,
+                        radix_select_traits< T, StrictWeakOrdering >( ) );
+    }
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in a device_vector and calls the device_vector specialization.
+template< typename RandomAccessIterator, typename StrictWeakOrdering >
+void select_pick_iterator( control &ctl,
+                           const RandomAccessIterator& first, const RandomAccessIterator& nth,
+                           const RandomAccessIterator& last,
+                           const StrictWeakOrdering& comp, const std::string& cl_code, bool sortHead,
+                           std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+    size_t szElements = static_cast< size_t >( last - first );
+    if( szElements < 2 )
+        return;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        select_cpu( runMode, first, nth, last, comp, sortHead );
+    }
+    else
+    {
+        device_vector< T > dvInputOutput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, ctl );
+        select_enqueue( ctl, dvInputOutput.begin( ), static_cast< size_t >( nth - first ), dvInputOutput.end( ),
+                        comp, cl_code, sortHead, radix_select_traits< T, StrictWeakOrdering >( ) );
+        //Map the buffer back to the host
+        dvInputOutput.data( );
+    }
+}
+
+template< typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+OutputIterator top_k_detect_random_access( control &ctl,
+                                           const InputIterator& first, const InputIterator& last, size_t k,
+                                           const OutputIterator& result,
+                                           const StrictWeakOrdering& comp, const std::string& cl_code,
+                                           std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+OutputIterator top_k_detect_random_access( control &ctl,
+                                           const InputIterator& first, const InputIterator& last, size_t k,
+                                           const OutputIterator& result,
+                                           const StrictWeakOrdering& comp, const std::string& cl_code,
+                                           std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type iType;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+    static_assert( std::is_same< iType, oType >::value, "top_k requires matching input and output value types" );
+
+    k = std::min( k, static_cast< size_t >( std::distance( first, last ) ) );
+    if( k == 0 )
+        return result;
+
+    return top_k_pick_iterator( ctl, first, last, k, result, comp, cl_code,
+                                std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+//Device Vector specialization; the output has to live in a device_vector as well
+template< typename DVInputIterator, typename DVOutputIterator, typename StrictWeakOrdering >
+DVOutputIterator top_k_pick_iterator( control &ctl,
+                                      const DVInputIterator& first, const DVInputIterator& last, size_t k,
+                                      const DVOutputIterator& result,
+                                      const StrictWeakOrdering& comp, const std::string& cl_code,
+                                      bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type T;
+    static_assert( std::is_same< typename std::iterator_traits< DVOutputIterator >::iterator_category,
+                                 bolt::cl::device_vector_tag >::value,
+                   "top_k over a device_vector requires a device_vector output" );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        bolt::cl::device_vector< T >::pointer firstPtr = first.getContainer( ).data( );
+        bolt::cl::device_vector< T >::pointer resultPtr = result.getContainer( ).data( );
+        std::partial_sort_copy( &firstPtr[ first.m_Index ], &firstPtr[ last.m_Index ],
+                                &resultPtr[ result.m_Index ], &resultPtr[ result.m_Index + k ], comp );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        bolt::cl::device_vector< T >::pointer firstPtr = first.getContainer( ).data( );
+        bolt::cl::device_vector< T >::pointer resultPtr = result.getContainer( ).data( );
+        bolt::btbb::top_k( &firstPtr[ first.m_Index ], &firstPtr[ last.m_Index ], k, &resultPtr[ result.m_Index ],
+                           comp );
+#else
+        throw std::exception( "The MultiCoreCpu version of top_k is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        top_k_enqueue( ctl, first, last, first, k, result, result, comp, cl_code, false,
+                       radix_select_traits< T, StrictWeakOrdering >( ) );
+    }
+    return result + k;
+}
+
+//Non Device Vector specialization.
+template< typename InputIterator, typename OutputIterator, typename StrictWeakOrdering >
+OutputIterator top_k_pick_iterator( control &ctl,
+                                    const InputIterator& first, const InputIterator& last, size_t k,
+                                    const OutputIterator& result,
+                                    const StrictWeakOrdering& comp, const std::string& cl_code,
+                                    std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type T;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        std::partial_sort_copy( first, last, result, result + k, comp );
+        return result + k;
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        return bolt::btbb::top_k( first, last, k, result, comp );
+#else
+        throw std::exception( "The MultiCoreCpu version of top_k is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        device_vector< T > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< T > dvResult( result, k, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
+        top_k_enqueue( ctl, dvInput.begin( ), dvInput.end( ), dvInput.begin( ), k,
+                       dvResult.begin( ), dvResult.begin( ), comp, cl_code, false,
+                       radix_select_traits< T, StrictWeakOrdering >( ) );
+        //Map the buffer back to the host
+        dvResult.data( );
+        return result + k;
+    }
+}
+
+template< typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2,
+          typename StrictWeakOrdering >
+pair< OutputIterator1, OutputIterator2 >
+top_k_by_key_detect_random_access( control &ctl,
+                                   const InputIterator1& keys_first, const InputIterator1& keys_last,
+                                   const InputIterator2& values_first, size_t k,
+                                   const OutputIterator1& keys_result, const OutputIterator2& values_result,
+                                   const StrictWeakOrdering& comp, const std::string& cl_code,
+                                   std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2,
+          typename StrictWeakOrdering >
+pair< OutputIterator1, OutputIterator2 >
+top_k_by_key_detect_random_access( control &ctl,
+                                   const InputIterator1& keys_first, const InputIterator1& keys_last,
+                                   const InputIterator2& values_first, size_t k,
+                                   const OutputIterator1& keys_result, const OutputIterator2& values_result,
+                                   const StrictWeakOrdering& comp, const std::string& cl_code,
+                                   std::random_access_iterator_tag )
+{
+    k = std::min( k, static_cast< size_t >( std::distance( keys_first, keys_last ) ) );
+    if( k == 0 )
+        return bolt::cl::make_pair( keys_result, values_result );
+
+    top_k_by_key_pick_iterator( ctl, keys_first, keys_last, values_first, k, keys_result, values_result,
+                                comp, cl_code, std::iterator_traits< InputIterator1 >::iterator_category( ) );
+    return bolt::cl::make_pair( keys_result + k, values_result + k );
+};
+
+//Device Vector specialization; values and outputs have to live in device_vectors as well
+template< typename DVKeys, typename DVValues, typename DVKeysOut, typename DVValuesOut, typename StrictWeakOrdering >
+void top_k_by_key_pick_iterator( control &ctl,
+                                 const DVKeys& keys_first, const DVKeys& keys_last,
+                                 const DVValues& values_first, size_t k,
+                                 const DVKeysOut& keys_result, const DVValuesOut& values_result,
+                                 const StrictWeakOrdering& comp, const std::string& cl_code,
+                                 bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVKeys >::value_type kType;
+    typedef typename std::iterator_traits< DVValues >::value_type vType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< kType >::pointer keysPtr = keys_first.getContainer( ).data( );
+        bolt::cl::device_vector< vType >::pointer valuesPtr = values_first.getContainer( ).data( );
+        bolt::cl::device_vector< kType >::pointer keysOutPtr = keys_result.getContainer( ).data( );
+        bolt::cl::device_vector< vType >::pointer valuesOutPtr = values_result.getContainer( ).data( );
+        if( runMode == bolt::cl::control::SerialCpu )
+        {
+            serialCPU_top_k_by_key( &keysPtr[ keys_first.m_Index ], &keysPtr[ keys_last.m_Index ],
+                                    &valuesPtr[ values_first.m_Index ], k, &keysOutPtr[ keys_result.m_Index ],
+                                    &valuesOutPtr[ values_result.m_Index ], comp );
+        }
+        else
+        {
+#ifdef ENABLE_TBB
+            bolt::btbb::top_k_by_key( &keysPtr[ keys_first.m_Index ], &keysPtr[ keys_last.m_Index ],
+                                      &valuesPtr[ values_first.m_Index ], k, &keysOutPtr[ keys_result.m_Index ],
+                                      &valuesOutPtr[ values_result.m_Index ], comp );
+#else
+            throw std::exception( "The MultiCoreCpu version of top_k_by_key is not enabled to be built! \n" );
+#endif
+        }
+    }
+    else
+    {
+        top_k_enqueue( ctl, keys_first, keys_last, values_first, k, keys_result, values_result, comp, cl_code, true,
+                       radix_select_traits< kType, StrictWeakOrdering >( ) );
+    }
+}
+
+//Non Device Vector specialization.
+template< typename InputIterator1, typename InputIterator2, typename OutputIterator1, typename OutputIterator2,
+          typename StrictWeakOrdering >
+void top_k_by_key_pick_iterator( control &ctl,
+                                 const InputIterator1& keys_first, const InputIterator1& keys_last,
+                                 const InputIterator2& values_first, size_t k,
+                                 const OutputIterator1& keys_result, const OutputIterator2& values_result,
+                                 const StrictWeakOrdering& comp, const std::string& cl_code,
+                                 std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< InputIterator2 >::value_type vType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        serialCPU_top_k_by_key( keys_first, keys_last, values_first, k, keys_result, values_result, comp );
+    }
+    else if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        bolt::btbb::top_k_by_key( keys_first, keys_last, values_first, k, keys_result, values_result, comp );
+#else
+        throw std::exception( "The MultiCoreCpu version of top_k_by_key is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        size_t szElements = static_cast< size_t >( keys_last - keys_first );
+        device_vector< kType > dvKeys( keys_first, keys_last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< vType > dvValues( values_first, szElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, true,
+                                         ctl );
+        device_vector< kType > dvKeysOut( keys_result, k, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
+        device_vector< vType > dvValuesOut( values_result, k, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false,
+                                            ctl );
+        top_k_enqueue( ctl, dvKeys.begin( ), dvKeys.end( ), dvValues.begin( ), k,
+                       dvKeysOut.begin( ), dvValuesOut.begin( ), comp, cl_code, true,
+                       radix_select_traits< kType, StrictWeakOrdering >( ) );
+        //Map the buffers back to the host
+        dvKeysOut.data( );
+        dvValuesOut.data( );
+    }
+}
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
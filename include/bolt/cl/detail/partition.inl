@@ -0,0 +1,281 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_PARTITION_INL )
+#define BOLT_CL_PARTITION_INL
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/copy_if.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/partition.h"
+#endif
+
+namespace bolt {
+namespace cl {
+
+/**********************************************************************************************************************
+ * stable_partition
+ *********************************************************************************************************************/
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator stable_partition(control &ctl,
+                                 ForwardIterator first,
+                                 ForwardIterator last,
+                                 Predicate pred,
+                                 const std::string& cl_code)
+{
+    return detail::partition_detect_random_access( ctl, first, last, pred, cl_code, true,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator stable_partition(ForwardIterator first,
+                                 ForwardIterator last,
+                                 Predicate pred,
+                                 const std::string& cl_code)
+{
+    return stable_partition( control::getDefault( ), first, last, pred, cl_code );
+}
+
+/**********************************************************************************************************************
+ * partition
+ *********************************************************************************************************************/
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator partition(control &ctl,
+                          ForwardIterator first,
+                          ForwardIterator last,
+                          Predicate pred,
+                          const std::string& cl_code)
+{
+    return detail::partition_detect_random_access( ctl, first, last, pred, cl_code, false,
+        std::iterator_traits< ForwardIterator >::iterator_category( ) );
+}
+
+template<typename ForwardIterator, typename Predicate>
+ForwardIterator partition(ForwardIterator first,
+                          ForwardIterator last,
+                          Predicate pred,
+                          const std::string& cl_code)
+{
+    return partition( control::getDefault( ), first, last, pred, cl_code );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+namespace bolt {
+namespace cl {
+namespace detail {
+
+enum partitionCopyBackTypes { partCopyBack_oType, partCopyBack_oIterType, partCopyBack_end };
+
+class PartitionCopyBack_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    PartitionCopyBack_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("partitionCopyBackTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[partCopyBack_oType] + "* scratch,\n"
+            "const uint vecSize,\n"
+            "const uint numSelected,\n"
+            "global " + typeNames[partCopyBack_oType] + "* output_ptr,\n"
+            + typeNames[partCopyBack_oIterType] + " output_iter\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  Partitions on the device and returns the number of elements that satisfy the predicate.  One copy_if pass
+//  writes the kept elements forwards and the others backwards into a scratch buffer, then both halves move back.
+template< typename DVForwardIterator, typename Predicate >
+cl_uint partition_enqueue( control &ctl, const DVForwardIterator& first, const DVForwardIterator& last,
+                           const Predicate& pred, const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVForwardIterator >::value_type iType;
+
+    cl_uint numElements = static_cast< cl_uint >( first.distance_to( last ) );
+    device_vector< iType > dvScratch( numElements, iType( ), CL_MEM_READ_WRITE, false, ctl );
+    cl_uint numSelected = copy_if_enqueue( ctl, first, last, dvScratch.begin( ), &dvScratch.getBuffer( ), pred, true,
+                                           cl_code );
+
+    std::vector< std::string > typeNames( partCopyBack_end );
+    typeNames[ partCopyBack_oType ] = TypeName< iType >::get( );
+    typeNames[ partCopyBack_oIterType ] = TypeName< DVForwardIterator >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVForwardIterator >::get( ) )
+
+    PartitionCopyBack_KernelTemplateSpecializer copyBack_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &copyBack_kts, typeDefinitions,
+                                                                lookback_kernels + copy_if_kernels,
+                                                                copyIfCompileOptions( 1 ) );
+
+    V_OPENCL( kernels[ 0 ].setArg( 0, dvScratch.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 1, numElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 2, numSelected ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 3, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 4, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+
+    cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+    size_t numWorkGroups = ( numElements + COPY_IF_WGSIZE - 1 ) / COPY_IF_WGSIZE;
+    numWorkGroups = std::min< size_t >( numWorkGroups, computeUnits * ctl.getWGPerComputeUnit( ) );
+
+    ::cl::Event copyBackEvent;
+    cl_int l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 0 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numWorkGroups * COPY_IF_WGSIZE ),
+        ::cl::NDRange( COPY_IF_WGSIZE ),
+        NULL,
+        &copyBackEvent );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for partitionCopyBack kernel" );
+    bolt::cl::wait( ctl, copyBackEvent );
+    return numSelected;
+}
+
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator partition_cpu( bolt::cl::control::e_RunMode runMode, ForwardIterator first, ForwardIterator last,
+                               const Predicate& pred, bool stable )
+{
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        return stable ? std::stable_partition( first, last, pred ) : std::partition( first, last, pred );
+    }
+    else
+    {
+#ifdef ENABLE_TBB
+        return bolt::btbb::stable_partition( first, last, pred );
+#else
+        throw std::exception( "The MultiCoreCpu version of partition is not enabled to be built! \n" );
+#endif
+    }
+}
+
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator partition_detect_random_access( control &ctl,
+                                                const ForwardIterator& first, const ForwardIterator& last,
+                                                const Predicate& pred, const std::string& cl_code, bool stable,
+                                                std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator partition_detect_random_access( control &ctl,
+                                                const ForwardIterator& first, const ForwardIterator& last,
+                                                const Predicate& pred, const std::string& cl_code, bool stable,
+                                                bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "It is not possible to partition fancy iterators; they are not mutable" );
+};
+
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator partition_detect_random_access( control &ctl,
+                                                const ForwardIterator& first, const ForwardIterator& last,
+                                                const Predicate& pred, const std::string& cl_code, bool stable,
+                                                std::random_access_iterator_tag )
+{
+    if( std::distance( first, last ) == 0 )
+        return first;
+
+    return partition_pick_iterator( ctl, first, last, pred, cl_code, stable,
+                                    std::iterator_traits< ForwardIterator >::iterator_category( ) );
+};
+
+//Device Vector specialization
+template< typename DVForwardIterator, typename Predicate >
+DVForwardIterator partition_pick_iterator( control &ctl,
+                                           const DVForwardIterator& first, const DVForwardIterator& last,
+                                           const Predicate& pred, const std::string& cl_code, bool stable,
+                                           bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVForwardIterator >::value_type iType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        size_t szElements = static_cast< size_t >( last - first );
+        bolt::cl::device_vector< iType >::pointer firstPtr = first.getContainer( ).data( );
+        iType* middle = partition_cpu( runMode, &firstPtr[ first.m_Index ], &firstPtr[ first.m_Index ] + szElements,
+                                       pred, stable );
+        return first + ( middle - &firstPtr[ first.m_Index ] );
+    }
+    else
+    {
+        return first + partition_enqueue( ctl, first, last, pred, cl_code );
+    }
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in a device_vector and maps it back when done.
+template< typename ForwardIterator, typename Predicate >
+ForwardIterator partition_pick_iterator( control &ctl,
+                                         const ForwardIterator& first, const ForwardIterator& last,
+                                         const Predicate& pred, const std::string& cl_code, bool stable,
+                                         std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< ForwardIterator >::value_type iType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        return partition_cpu( runMode, first, last, pred, stable );
+    }
+    else
+    {
+        device_vector< iType > dvRange( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, ctl );
+        cl_uint numSelected = partition_enqueue( ctl, dvRange.begin( ), dvRange.end( ), pred, cl_code );
+        //Map the buffer back to the host
+        dvRange.data( );
+        return first + numSelected;
+    }
+}
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
@@ -26,6 +26,7 @@
 #include <boost/bind.hpp>
 #include "bolt/cl/bolt.h"
 #include "bolt/cl/functional.h"
+#include "bolt/cl/device_scalar.h"
 #ifdef ENABLE_TBB
 //TBB Includes
 #include "bolt/btbb/reduce.h"
@@ -111,6 +112,41 @@ namespace bolt {
             }
         }
 
+        template<typename InputIterator, typename T, typename BinaryFunction>
+        void reduce(InputIterator first,
+            InputIterator last,
+            T init,
+            BinaryFunction binary_op,
+            device_scalar< T >& result,
+            const std::string& cl_code)
+        {
+            reduce(bolt::cl::control::getDefault(), first, last, init, binary_op, result, cl_code);
+        }
+
+        // The CPU paths compute the value on the host and write it to the scalar; the OpenCL path finishes the
+        // reduction on the device and does not wait for it.
+        template<typename InputIterator, typename T, typename BinaryFunction>
+        void reduce(bolt::cl::control &ctl,
+            InputIterator first,
+            InputIterator last,
+            T init,
+            BinaryFunction binary_op,
+            device_scalar< T >& result,
+            const std::string& cl_code)
+        {
+            bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();
+            if(runMode == bolt::cl::control::Automatic)
+            {
+                  runMode = ctl.getDefaultPathToRun();
+            }
+            if (runMode == bolt::cl::control::OpenCL && first != last) {
+                detail::reduce_pick_iterator(ctl, first, last, init, binary_op, result, cl_code,
+                    std::iterator_traits< InputIterator >::iterator_category( ) );
+            } else {
+                result.set( reduce(ctl, first, last, init, binary_op, cl_code) );
+            }
+        }
+
     }
 
 };
@@ -155,6 +191,70 @@ namespace bolt {
             }
             };
 
+        enum ReduceFinalTypes {reduceFinal_resType, reduceFinal_BinaryFunction, reduceFinal_end };
+
+        class ReduceFinal_KernelTemplateSpecializer : public KernelTemplateSpecializer
+            {
+            public:
+
+            ReduceFinal_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+                {
+                    addKernelName( "reduceFinalTemplate" );
+                }
+
+            const ::std::string operator() ( const ::std::vector<::std::string>& typeNames ) const
+            {
+                const std::string templateSpecializationString =
+                        "// Host generates this instantiation string with user-specified value type and functor\n"
+                        "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+                        "__attribute__((reqd_work_group_size(64,1,1)))\n"
+                        "kernel void reduceFinalTemplate(\n"
+                        "global " + typeNames[reduceFinal_resType] + "* partials,\n"
+                        "const int count,\n"
+                        "const " + typeNames[reduceFinal_resType] + " init,\n"
+                        "global " + typeNames[reduceFinal_BinaryFunction] + "* userFunctor,\n"
+                        "global " + typeNames[reduceFinal_resType] + "* result,\n"
+                        "local " + typeNames[reduceFinal_resType] + "* scratch\n"
+                        ");\n\n";
+
+                return templateSpecializationString;
+            }
+            };
+
+        enum ReduceTicketTypes {reduceTicket_iValueType, reduceTicket_iIterType, reduceTicket_BinaryFunction,
+            reduceTicket_resType, reduceTicket_end };
+
+        class ReduceTicket_KernelTemplateSpecializer : public KernelTemplateSpecializer
+            {
+            public:
+
+            ReduceTicket_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+                {
+                    addKernelName( "reduceTicketTemplate" );
+                }
+
+            const ::std::string operator() ( const ::std::vector<::std::string>& typeNames ) const
+            {
+                const std::string templateSpecializationString =
+                        "// Host generates this instantiation string with user-specified value type and functor\n"
+                        "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+                        "__attribute__((reqd_work_group_size(64,1,1)))\n"
+                        "kernel void reduceTicketTemplate(\n"
+                        "global " + typeNames[reduceTicket_iValueType] + "* input_ptr,\n"
+                         + typeNames[reduceTicket_iIterType] + " input_iter,\n"
+                        "const int length,\n"
+                        "const " + typeNames[reduceTicket_resType] + " init,\n"
+                        "global " + typeNames[reduceTicket_BinaryFunction] + "* userFunctor,\n"
+                        "global " + typeNames[reduceTicket_resType] + "* partials,\n"
+                        "global uint* ticket,\n"
+                        "global " + typeNames[reduceTicket_resType] + "* result,\n"
+                        "local " + typeNames[reduceTicket_resType] + "* scratch\n"
+                        ");\n\n";
+
+                return templateSpecializationString;
+            }
+            };
+
             template<typename T, typename DVInputIterator, typename BinaryFunction>
             T reduce_detect_random_access(bolt::cl::control &ctl,
 
@@ -338,16 +438,130 @@ namespace bolt {
 
             }
 
-            //----
-            // This is the base implementation of reduction that is called by all of the convenience wrappers below.
-            // first and last must be iterators from a DeviceVector
+            // The device_scalar overloads only reach this point on the OpenCL path, with a non-empty range
+            template<typename T, typename InputIterator, typename BinaryFunction>
+            void reduce_pick_iterator(bolt::cl::control &ctl,
+                const InputIterator& first,
+                const InputIterator& last,
+                const T& init,
+                const BinaryFunction& binary_op,
+                device_scalar< T >& result,
+                const std::string& cl_code,
+                std::random_access_iterator_tag )
+            {
+                //  The input is copied rather than wrapped, because the caller's memory is only guaranteed to be valid
+                //  until this returns, which is before the kernels run
+                typedef typename std::iterator_traits<InputIterator>::value_type iType;
+                device_vector< iType > dvInput( first, last, CL_MEM_READ_ONLY, ctl );
+                reduce_enqueue( ctl, dvInput.begin(), dvInput.end(), init, binary_op, result, cl_code);
+            }
+
             template<typename T, typename DVInputIterator, typename BinaryFunction>
-            T reduce_enqueue(bolt::cl::control &ctl,
+            void reduce_pick_iterator(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const T& init,
+                const BinaryFunction& binary_op,
+                device_scalar< T >& result,
+                const std::string& cl_code,
+                bolt::cl::device_vector_tag )
+            {
+                reduce_enqueue( ctl, first, last, init, binary_op, result, cl_code);
+            }
+
+            template<typename T, typename DVInputIterator, typename BinaryFunction>
+            void reduce_pick_iterator(bolt::cl::control &ctl,
                 const DVInputIterator& first,
                 const DVInputIterator& last,
                 const T& init,
                 const BinaryFunction& binary_op,
+                device_scalar< T >& result,
+                const std::string& cl_code,
+                bolt::cl::fancy_iterator_tag )
+            {
+                reduce_enqueue( ctl, first, last, init, binary_op, result, cl_code);
+            }
+
+            //----
+            // Copies a functor into a buffer of its own.  The reductions that leave their result on the device return
+            // before their kernels run, so they cannot hand the runtime a pointer to a functor on their stack.
+            template<typename Functor>
+            ::cl::Buffer reduce_functor_buffer(bolt::cl::control &ctl, const Functor& functor )
+            {
+                ALIGNED( 256 ) Functor aligned_functor( functor );
+                cl_int l_Error = CL_SUCCESS;
+                ::cl::Buffer userFunctor( ctl.getContext( ), CL_MEM_COPY_HOST_PTR|CL_MEM_READ_ONLY,
+                    sizeof( aligned_functor ), &aligned_functor, &l_Error );
+                V_OPENCL( l_Error, "Error creating the functor buffer" );
+
+                return userFunctor;
+            }
+
+            //----
+            // Combines numPartials values of the partials buffer with init on the device, and writes the result to
+            // the scalar.  This is the last step of every reduction that leaves its result on the device.
+            template<typename T, typename BinaryFunction>
+            void reduce_final_enqueue(bolt::cl::control &ctl,
+                const ::cl::Buffer& partials,
+                size_t numPartials,
+                const T& init,
+                const BinaryFunction& binary_op,
+                device_scalar< T >& result,
                 const std::string& cl_code )
+            {
+                std::vector<std::string> typeNames( reduceFinal_end );
+                typeNames[reduceFinal_resType] = TypeName< T >::get( );
+                typeNames[reduceFinal_BinaryFunction] = TypeName< BinaryFunction >::get();
+
+                std::vector<std::string> typeDefinitions;
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< T >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction  >::get() )
+
+                ReduceFinal_KernelTemplateSpecializer ts_kts;
+                std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+                    ctl,
+                    typeNames,
+                    &ts_kts,
+                    typeDefinitions,
+                    reduce_kernels,
+                    std::string( ) );
+
+                const size_t wgSize = 64;
+
+                ::cl::Buffer userFunctor = reduce_functor_buffer( ctl, binary_op );
+
+                V_OPENCL( kernels[0].setArg(0, partials ), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(1, static_cast< cl_int >( numPartials ) ), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(2, init ), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(3, userFunctor), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(4, result.getBuffer( ) ), "Error setting kernel argument" );
+
+                ::cl::LocalSpaceArg loc;
+                loc.size_ = wgSize*sizeof(T);
+                V_OPENCL( kernels[0].setArg(5, loc), "Error setting kernel argument" );
+
+                cl_int l_Error = ctl.getCommandQueue().enqueueNDRangeKernel(
+                    kernels[0],
+                    ::cl::NullRange,
+                    ::cl::NDRange(wgSize),
+                    ::cl::NDRange(wgSize));
+
+                V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for reduce() final kernel" );
+            }
+
+            //----
+            // Enqueues the first pass of the reduction, which leaves one partial result per work-group in the
+            // returned buffer; numPartials receives the number of work-groups that wrote one.  userFunctor holds a
+            // copy of binary_op.
+            template<typename T, typename DVInputIterator, typename BinaryFunction>
+            control::buffPointer reduce_partials_enqueue(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const T& init,
+                const BinaryFunction& binary_op,
+                const ::cl::Buffer& userFunctor,
+                const std::string& cl_code,
+                size_t& numPartials )
             {
                 typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
 
@@ -393,16 +607,9 @@ namespace bolt {
 
                 V_OPENCL( l_Error, "Error querying kernel for CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE" );
 
-                // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
-                ALIGNED( 256 ) BinaryFunction aligned_reduce( binary_op );
-                //::cl::Buffer userFunctor(ctl.context(), CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, sizeof(aligned_reduce),
-                //  &aligned_reduce );
-                control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_reduce ),
-                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_reduce );
-
                 // ::cl::Buffer result(ctl.context(), CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY, sizeof( iType )*numWG);
                 control::buffPointer result = ctl.acquireBuffer( sizeof( T ) * numWG,
-                    CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
+                    CL_MEM_ALLOC_HOST_PTR|CL_MEM_READ_WRITE );
 
                 cl_uint szElements = static_cast< cl_uint >( first.distance_to(last ) );
 
@@ -412,7 +619,7 @@ namespace bolt {
                                                            "Error setting a kernel argument" );
 
                 V_OPENCL( kernels[0].setArg(2, szElements), "Error setting kernel argument" );
-                V_OPENCL( kernels[0].setArg(3, *userFunctor), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(3, userFunctor), "Error setting kernel argument" );
                 V_OPENCL( kernels[0].setArg(4, *result), "Error setting kernel argument" );
 
                 ::cl::LocalSpaceArg loc;
@@ -427,17 +634,129 @@ namespace bolt {
 
                 V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for reduce() kernel" );
 
+                //  The compute device reduces within the workgroups, with one result per workgroup
+                size_t ceilNumWG = static_cast< size_t >( std::ceil( static_cast< float >( szElements ) / wgSize) );
+                bolt::cl::minimum<size_t>  min_size_t;
+                numPartials = min_size_t( ceilNumWG, numWG );
+
+                return result;
+            }
+
+            //----
+            // Enqueues the single-launch reduction, which combines the per work-group partials with init on the
+            // device and writes the reduced value to the first element of result.  The work-groups count themselves
+            // in with a global atomic, so this needs supportsGlobalAtomics( ctl ).  userFunctor holds a copy of
+            // binary_op.
+            template<typename T, typename DVInputIterator, typename BinaryFunction>
+            void reduce_ticket_enqueue(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const T& init,
+                const BinaryFunction& binary_op,
+                const ::cl::Buffer& userFunctor,
+                const ::cl::Buffer& result,
+                const std::string& cl_code )
+            {
+                typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+
+                std::vector<std::string> typeNames( reduceTicket_end );
+                typeNames[reduceTicket_iValueType] = TypeName< iType >::get( );
+                typeNames[reduceTicket_iIterType] = TypeName< DVInputIterator >::get( );
+                typeNames[reduceTicket_BinaryFunction] = TypeName< BinaryFunction >::get();
+                typeNames[reduceTicket_resType] = TypeName< T >::get( );
+
+                std::vector<std::string> typeDefinitions;
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction  >::get() )
+                PUSH_BACK_UNIQUE( typeDefinitions, ClCode< T >::get() )
+
+                ReduceTicket_KernelTemplateSpecializer ts_kts;
+                std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+                    ctl,
+                    typeNames,
+                    &ts_kts,
+                    typeDefinitions,
+                    reduce_kernels,
+                    std::string( ) );
+
+                const size_t wgSize = 64;
+                cl_uint szElements = static_cast< cl_uint >( first.distance_to( last ) );
+
+                //  Launch computeUnits * wgPerComputeUnit work-groups, but never more than there are 64 element
+                //  chunks in the input, so that every work-group reduces at least one element
+                cl_uint computeUnits = ctl.getDevice().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
+                size_t numWG = computeUnits * ctl.getWGPerComputeUnit();
+                numWG = std::max< size_t >( 1, std::min< size_t >( numWG, ( szElements + wgSize - 1 ) / wgSize ) );
+
+                control::buffPointer partials = ctl.acquireBuffer( sizeof( T ) * numWG, CL_MEM_READ_WRITE );
+                control::buffPointer ticket = ctl.acquireBuffer( sizeof( cl_uint ), CL_MEM_READ_WRITE );
+
+                cl_int l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *ticket, 0, 0, sizeof( cl_uint ) );
+                V_OPENCL( l_Error, "enqueueFillBuffer() failed for the reduce() ticket" );
+
+                V_OPENCL( kernels[0].setArg(0, first.getContainer().getBuffer() ), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+                                                           "Error setting a kernel argument" );
+                V_OPENCL( kernels[0].setArg(2, szElements), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(3, init), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(4, userFunctor), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(5, *partials), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(6, *ticket), "Error setting kernel argument" );
+                V_OPENCL( kernels[0].setArg(7, result), "Error setting kernel argument" );
+
+                ::cl::LocalSpaceArg loc;
+                loc.size_ = wgSize*sizeof(T);
+                V_OPENCL( kernels[0].setArg(8, loc), "Error setting kernel argument" );
+
+                l_Error = ctl.getCommandQueue().enqueueNDRangeKernel(
+                    kernels[0],
+                    ::cl::NullRange,
+                    ::cl::NDRange(numWG * wgSize),
+                    ::cl::NDRange(wgSize));
+
+                V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for reduce() single-launch kernel" );
+            }
+
+            //----
+            // This is the base implementation of reduction that is called by all of the convenience wrappers below.
+            // first and last must be iterators from a DeviceVector
+            template<typename T, typename DVInputIterator, typename BinaryFunction>
+            T reduce_enqueue(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const T& init,
+                const BinaryFunction& binary_op,
+                const std::string& cl_code )
+            {
+                // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
+                ALIGNED( 256 ) BinaryFunction aligned_reduce( binary_op );
+                control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_reduce ),
+                    CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_reduce );
+
+                cl_int l_Error = CL_SUCCESS;
+                if( supportsGlobalAtomics( ctl ) )
+                {
+                    control::buffPointer deviceResult = ctl.acquireBuffer( sizeof( T ), CL_MEM_READ_WRITE );
+                    reduce_ticket_enqueue( ctl, first, last, init, binary_op, *userFunctor, *deviceResult, cl_code );
+
+                    T acc;
+                    l_Error = ctl.getCommandQueue( ).enqueueReadBuffer( *deviceResult, CL_TRUE, 0, sizeof( T ), &acc );
+                    V_OPENCL( l_Error, "Error reading the reduce() result" );
+                    return acc;
+                }
+
+                //  Without global atomics, the work-group partials are combined on the host
+                size_t numTailReduce = 0;
+                control::buffPointer result = reduce_partials_enqueue( ctl, first, last, init, binary_op, *userFunctor,
+                    cl_code, numTailReduce );
+
                 ::cl::Event l_mapEvent;
                 T *h_result = (T*)ctl.getCommandQueue().enqueueMapBuffer(*result, false, CL_MAP_READ, 0,
-                    sizeof(T)*numWG, NULL, &l_mapEvent, &l_Error );
+                    sizeof(T)*numTailReduce, NULL, &l_mapEvent, &l_Error );
                 V_OPENCL( l_Error, "Error calling map on the result buffer" );
 
-                //  Finish the tail end of the reduction on host side;the compute device reduces within the workgroups,
-                //  with one result per workgroup
-                size_t ceilNumWG = static_cast< size_t >( std::ceil( static_cast< float >( szElements ) / wgSize) );
-                bolt::cl::minimum<size_t>  min_size_t;
-                size_t numTailReduce = min_size_t( ceilNumWG, numWG );
-
+                //  Finish the tail end of the reduction on host side
                 bolt::cl::wait(ctl, l_mapEvent);
 
                 T acc = init;
@@ -455,6 +774,33 @@ namespace bolt {
 
                 return acc;
             };
+
+            // Same as above, but the tail end of the reduction also runs on the device, and the result stays there.
+            // Without global atomics, a second launch combines the work-group partials.
+            template<typename T, typename DVInputIterator, typename BinaryFunction>
+            void reduce_enqueue(bolt::cl::control &ctl,
+                const DVInputIterator& first,
+                const DVInputIterator& last,
+                const T& init,
+                const BinaryFunction& binary_op,
+                device_scalar< T >& result,
+                const std::string& cl_code )
+            {
+                ::cl::Buffer userFunctor = reduce_functor_buffer( ctl, binary_op );
+
+                if( supportsGlobalAtomics( ctl ) )
+                {
+                    reduce_ticket_enqueue( ctl, first, last, init, binary_op, userFunctor, result.getBuffer( ),
+                        cl_code );
+                    return;
+                }
+
+                size_t numPartials = 0;
+                control::buffPointer partials = reduce_partials_enqueue( ctl, first, last, init, binary_op,
+                    userFunctor, cl_code, numPartials );
+
+                reduce_final_enqueue( ctl, *partials, numPartials, init, binary_op, result, cl_code );
+            };
         }
     }
 }
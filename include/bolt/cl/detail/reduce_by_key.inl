@@ -19,15 +19,11 @@
 #if !defined( BOLT_CL_REDUCE_BY_KEY_INL )
 #define BOLT_CL_REDUCE_BY_KEY_INL
 
-#define KERNEL02WAVES 4
-#define KERNEL1WAVES 4
-#define WAVESIZE 64
-
-#define LENGTH_TEST 10
-#define ENABLE_PRINTS 0
+#define REDUCE_BY_KEY_WGSIZE 256
 
+#include <algorithm>
 #include <iostream>
-#include <fstream>
+#include <sstream>
 
 namespace bolt
 {
@@ -336,10 +332,9 @@ class ReduceByKey_KernelTemplateSpecializer : public KernelTemplateSpecializer
 
     ReduceByKey_KernelTemplateSpecializer() : KernelTemplateSpecializer()
     {
-        addKernelName("perBlockScanByKey");
-        addKernelName("intraBlockInclusiveScanByKey");
-        addKernelName("perBlockAdditionByKey");
-        addKernelName("keyValueMapping");
+        addKernelName("reduceByKeyTileAggregateTemplate");
+        addKernelName("reduceByKeyTileScanTemplate");
+        addKernelName("reduceByKeyTemplate");
     }
 
     const ::std::string operator() ( const ::std::vector<::std::string>& typeNames ) const
@@ -348,67 +343,59 @@ class ReduceByKey_KernelTemplateSpecializer : public KernelTemplateSpecializer
             "// Dynamic specialization of generic template definition, using user supplied types\n"
             "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
             "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
-            "__kernel void " + name(0) + "(\n"
+            "kernel void " + name(0) + "(\n"
             "global " + typeNames[e_kType] + "* ikeys,\n"
             + typeNames[e_kIterType] + " keys,\n"
             "global " + typeNames[e_vType] + "* ivals,\n"
             + typeNames[e_vIterType] + " vals,\n"
-            "global " + typeNames[e_voType] + "* output,\n"
-            "global int * output2,\n"
             "const uint vecSize,\n"
             "local "  + typeNames[e_kType] + "* ldsKeys,\n"
             "local "  + typeNames[e_voType] + "* ldsVals,\n"
+            "local uint* ldsCounts,\n"
+            "local "  + typeNames[e_voType] + "* ldsCarries,\n"
             "global " + typeNames[e_BinaryPredicate] + "* binaryPred,\n"
-            "global " + typeNames[e_BinaryFunction]  + "* binaryFunct,\n"
-            "global " + typeNames[e_kType] + "* keyBuffer,\n"
-            "global " + typeNames[e_voType] + "* valBuffer\n"
+            "global " + typeNames[e_BinaryFunction]  + "* binaryOp,\n"
+            "global uint* tileCounts,\n"
+            "global " + typeNames[e_voType] + "* tileSums\n"
             ");\n\n"
 
             "// Dynamic specialization of generic template definition, using user supplied types\n"
             "template __attribute__((mangled_name(" + name(1) + "Instantiated)))\n"
-            "__attribute__((reqd_work_group_size(KERNEL1WORKGROUPSIZE,1,1)))\n"
-            "__kernel void " + name(1) + "(\n"
-            "global " + typeNames[e_kType] + "* keySumArray,\n"
-            "global " + typeNames[e_voType] + "* preSumArray,\n"
-            "global " + typeNames[e_voType] + "* postSumArray,\n"
-            "const uint vecSize,\n"
-            "local "  + typeNames[e_kType] + "* ldsKeys,\n"
-            "local "  + typeNames[e_voType] + "* ldsVals,\n"
-            "const uint workPerThread,\n"
-            "global " + typeNames[e_BinaryPredicate] + "* binaryPred,\n"
-            "global " + typeNames[e_BinaryFunction] + "* binaryFunct\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(1) + "(\n"
+            "global uint* tileCounts,\n"
+            "global " + typeNames[e_voType] + "* tileSums,\n"
+            "const uint numTiles,\n"
+            "local uint* ldsCounts,\n"
+            "local "  + typeNames[e_voType] + "* ldsCarries,\n"
+            "global " + typeNames[e_BinaryFunction] + "* binaryOp\n"
             ");\n\n"
 
-
             "// Dynamic specialization of generic template definition, using user supplied types\n"
             "template __attribute__((mangled_name(" + name(2) + "Instantiated)))\n"
-            "__attribute__((reqd_work_group_size(KERNEL2WORKGROUPSIZE,1,1)))\n"
-            "__kernel void " + name(2) + "(\n"
-            "global " + typeNames[e_kType] + "* keySumArray,\n"
-            "global " + typeNames[e_voType] + "* postSumArray,\n"
-            "global " + typeNames[e_kType] + "* ikeys,\n"
-            + typeNames[e_kIterType] + " keys,\n"
-            "global int * output2,\n"
-            "global " + typeNames[e_voType] + "* output,\n"
-            "const uint vecSize,\n"
-            "global " + typeNames[e_BinaryPredicate] + "* binaryPred,\n"
-            "global " + typeNames[e_BinaryFunction] + "* binaryFunct\n"
-            ");\n\n"
-
-            "// Dynamic specialization of generic template definition, using user supplied types\n"
-            "template __attribute__((mangled_name(" + name(3) + "Instantiated)))\n"
             "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
-            "__kernel void " + name(3) + "(\n"
-            "global " + typeNames[e_kType] + "*ikeys,\n"
+            "kernel void " + name(2) + "(\n"
+            "global " + typeNames[e_kType] + "* ikeys,\n"
             + typeNames[e_kIterType] + " keys,\n"
-            "global " + typeNames[e_koType] + "*ikeys_output,\n"
+            "global " + typeNames[e_vType] + "* ivals,\n"
+            + typeNames[e_vIterType] + " vals,\n"
+            "global " + typeNames[e_koType] + "* ikeys_output,\n"
             + typeNames[e_koIterType] + " keys_output,\n"
-            "global " + typeNames[e_voType] + "*ivals_output,\n"
+            "global " + typeNames[e_voType] + "* ivals_output,\n"
             + typeNames[e_voIterType] + " vals_output,\n"
-            "global int *offsetArray,\n"
-            "global " + typeNames[e_voType] + "*offsetValArray,\n"
             "const uint vecSize,\n"
-            "const int numSections\n"
+            "local "  + typeNames[e_kType] + "* ldsKeys,\n"
+            "local "  + typeNames[e_voType] + "* ldsVals,\n"
+            "local uint* ldsCounts,\n"
+            "local "  + typeNames[e_voType] + "* ldsCarries,\n"
+            "global " + typeNames[e_BinaryPredicate] + "* binaryPred,\n"
+            "global " + typeNames[e_BinaryFunction]  + "* binaryOp,\n"
+            "global uint* tileStatus,\n"
+            "global uint* tileValues,\n"
+            "global uint* tileCounts,\n"
+            "global " + typeNames[e_voType] + "* tileSums,\n"
+            "int singlePass,\n"
+            "global uint* outputCount\n"
             ");\n\n";
 
         return templateSpecializationString;
@@ -614,7 +601,8 @@ reduce_by_key_pick_iterator(
         bolt::cl::device_vector< vType >::pointer valsPtr =  values_first.getContainer( ).data( );
         bolt::cl::device_vector< koType >::pointer oKeysPtr =  keys_output.getContainer( ).data( );
         bolt::cl::device_vector< voType >::pointer oValsPtr =  values_output.getContainer( ).data( );
-        unsigned int sizeOfOut = gold_reduce_by_key_enqueue( &keysPtr[keys_first.m_Index], &keysPtr[numElements],
+        unsigned int sizeOfOut = gold_reduce_by_key_enqueue( &keysPtr[keys_first.m_Index],
+                                           &keysPtr[keys_first.m_Index+numElements],
                                            &valsPtr[values_first.m_Index], &oKeysPtr[keys_output.m_Index],
                                           &oValsPtr[values_output.m_Index], binary_pred, binary_op);
         return bolt::cl::make_pair(keys_output+sizeOfOut, values_output+sizeOfOut);
@@ -627,7 +615,8 @@ reduce_by_key_pick_iterator(
         bolt::cl::device_vector< vType >::pointer valsPtr =  values_first.getContainer( ).data( );
         bolt::cl::device_vector< koType >::pointer oKeysPtr =  keys_output.getContainer( ).data( );
         bolt::cl::device_vector< voType >::pointer oValsPtr =  values_output.getContainer( ).data( );
-        unsigned int sizeOfOut = gold_reduce_by_key_enqueue( &keysPtr[keys_first.m_Index], &keysPtr[numElements],
+        unsigned int sizeOfOut = gold_reduce_by_key_enqueue( &keysPtr[keys_first.m_Index],
+                                           &keysPtr[keys_first.m_Index+numElements],
                                            &valsPtr[values_first.m_Index], &oKeysPtr[keys_output.m_Index],
                                           &oValsPtr[values_output.m_Index], binary_pred, binary_op);
         return bolt::cl::make_pair(keys_output+sizeOfOut, values_output+sizeOfOut);
@@ -647,7 +636,10 @@ reduce_by_key_pick_iterator(
 
 
 //  All calls to reduce_by_key end up here, unless an exception was thrown
-//  This is the function that sets up the kernels to compile (once only) and execute
+//  This is the function that sets up the kernels to compile (once only) and execute.  Devices that can chain tiles
+//  reduce the whole input in a single launch; the others compute the pair of every tile, scan the pairs in one
+//  work-group and then reduce.  The scratch buffers come from the control's buffer pool, and the only transfer back to
+//  the host is the number of runs.
 template<
     typename DVInputIterator1,
     typename DVInputIterator2,
@@ -669,6 +661,11 @@ reduce_by_key_enqueue(
 {
     cl_int l_Error;
 
+    //  An empty input has no runs, and an empty NDRange is not a valid launch
+    cl_uint numElements = static_cast< cl_uint >( std::distance( keys_first, keys_last ) );
+    if( numElements == 0 )
+        return 0;
+
     /**********************************************************************************
      * Type Names - used in KernelTemplateSpecializer
      *********************************************************************************/
@@ -682,52 +679,39 @@ reduce_by_key_enqueue(
     typeNames[e_vType] = TypeName< vType >::get( );
     typeNames[e_vIterType] = TypeName< DVInputIterator2 >::get( );
     typeNames[e_koType] = TypeName< koType >::get( );
-    typeNames[e_koIterType] = TypeName< DVInputIterator1 >::get( );
+    typeNames[e_koIterType] = TypeName< DVOutputIterator1 >::get( );
     typeNames[e_voType] = TypeName< voType >::get( );
-    typeNames[e_voIterType] = TypeName< DVInputIterator2 >::get( );
+    typeNames[e_voIterType] = TypeName< DVOutputIterator2 >::get( );
     typeNames[e_BinaryPredicate] = TypeName< BinaryPredicate >::get( );
     typeNames[e_BinaryFunction]  = TypeName< BinaryFunction >::get( );
 
     /**********************************************************************************
      * Type Definitions - directly concatenated into kernel string
      *********************************************************************************/
-    /*std::vector<std::string> typeDefs; // try substituting a map
-    typeDefs.push_back( ClCode< kType >::get() );
-    if (TypeName< vType >::get() != TypeName< kType >::get())
-    {
-        typeDefs.push_back( ClCode< vType >::get() );
-    }
-    if (TypeName< oType >::get() != TypeName< kType >::get() &&
-        TypeName< oType >::get() != TypeName< vType >::get())
-    {
-        typeDefs.push_back( ClCode< oType >::get() );
-    }
-    typeDefs.push_back( ClCode< BinaryPredicate >::get() );
-    typeDefs.push_back( ClCode< BinaryFunction >::get() );*/
     std::vector<std::string> typeDefs; // typeDefs must be unique and order does matter
+    PUSH_BACK_UNIQUE( typeDefs, user_code )
     PUSH_BACK_UNIQUE( typeDefs, ClCode< kType >::get() )
     PUSH_BACK_UNIQUE( typeDefs, ClCode< DVInputIterator1 >::get() )
     PUSH_BACK_UNIQUE( typeDefs, ClCode< vType >::get() )
     PUSH_BACK_UNIQUE( typeDefs, ClCode< DVInputIterator2 >::get() )
     PUSH_BACK_UNIQUE( typeDefs, ClCode< koType >::get() )
+    PUSH_BACK_UNIQUE( typeDefs, ClCode< DVOutputIterator1 >::get() )
     PUSH_BACK_UNIQUE( typeDefs, ClCode< voType >::get() )
+    PUSH_BACK_UNIQUE( typeDefs, ClCode< DVOutputIterator2 >::get() )
     PUSH_BACK_UNIQUE( typeDefs, ClCode< BinaryPredicate >::get() )
     PUSH_BACK_UNIQUE( typeDefs, ClCode< BinaryFunction  >::get() )
 
     /**********************************************************************************
      * Compile Options
      *********************************************************************************/
-    bool cpuDevice = ctl.getDevice().getInfo<CL_DEVICE_TYPE>() == CL_DEVICE_TYPE_CPU;
-    //std::cout << "Device is CPU: " << (cpuDevice?"TRUE":"FALSE") << std::endl;
-    const size_t kernel0_WgSize = (cpuDevice) ? 1 : WAVESIZE*KERNEL02WAVES;
-    const size_t kernel1_WgSize = (cpuDevice) ? 1 : WAVESIZE*KERNEL1WAVES;
-    const size_t kernel2_WgSize = (cpuDevice) ? 1 : WAVESIZE*KERNEL02WAVES;
-    std::string compileOptions;
+    //  CPU devices run work-groups of a single work-item, GPUs work-groups of REDUCE_BY_KEY_WGSIZE
+    bool cpuDevice = ctl.getDevice( ).getInfo< CL_DEVICE_TYPE >( ) == CL_DEVICE_TYPE_CPU;
+    const size_t wgSize = cpuDevice ? 1 : REDUCE_BY_KEY_WGSIZE;
+    const cl_uint itemsPerWorkItem = singlePassScanItemsPerWorkItem( ctl, sizeof( kType ) + sizeof( voType ),
+                                                                     wgSize );
     std::ostringstream oss;
-    oss << " -DKERNEL0WORKGROUPSIZE=" << kernel0_WgSize;
-    oss << " -DKERNEL1WORKGROUPSIZE=" << kernel1_WgSize;
-    oss << " -DKERNEL2WORKGROUPSIZE=" << kernel2_WgSize;
-    compileOptions = oss.str();
+    oss << " -DKERNEL0WORKGROUPSIZE=" << wgSize;
+    oss << " -DREDUCE_BY_KEY_ITEMS_PER_WORKITEM=" << itemsPerWorkItem;
 
     /**********************************************************************************
      * Request Compiled Kernels
@@ -738,343 +722,144 @@ reduce_by_key_enqueue(
         typeNames,
         &ts_kts,
         typeDefs,
-        reduce_by_key_kernels,
-        compileOptions);
+        lookback_kernels + reduce_by_key_kernels,
+        oss.str( ) );
     // kernels returned in same order as added in KernelTemplaceSpecializer constructor
 
-    // for profiling
-    ::cl::Event kernel0Event, kernel1Event, kernel2Event, kernelAEvent, kernel3Event;
-
-    // Set up shape of launch grid and buffers:
-    int computeUnits     = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
-    int wgPerComputeUnit =  ctl.getWGPerComputeUnit( );
-    int resultCnt = computeUnits * wgPerComputeUnit;
-
-    //  Ceiling function to bump the size of input to the next whole wavefront size
-    cl_uint numElements = static_cast< cl_uint >( std::distance( keys_first, keys_last ) );
-    device_vector< kType >::size_type sizeInputBuff = numElements;
-    size_t modWgSize = (sizeInputBuff & (kernel0_WgSize-1));
-    if( modWgSize )
-    {
-        sizeInputBuff &= ~modWgSize;
-        sizeInputBuff += kernel0_WgSize;
-    }
-    cl_uint numWorkGroupsK0 = static_cast< cl_uint >( sizeInputBuff / kernel0_WgSize );
-
-    //  Ceiling function to bump the size of the sum array to the next whole wavefront size
-    device_vector< kType >::size_type sizeScanBuff = numWorkGroupsK0;
-    modWgSize = (sizeScanBuff & (kernel0_WgSize-1));
-    if( modWgSize )
-    {
-        sizeScanBuff &= ~modWgSize;
-        sizeScanBuff += kernel0_WgSize;
-    }
+    const size_t tileSize = wgSize * itemsPerWorkItem;
+    cl_uint numTiles = static_cast< cl_uint >( ( numElements + tileSize - 1 ) / tileSize );
+    bool singlePass = supportsSinglePassScan( ctl );
 
     // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
-
     ALIGNED( 256 ) BinaryPredicate aligned_binary_pred( binary_pred );
     control::buffPointer binaryPredicateBuffer = ctl.acquireBuffer( sizeof( aligned_binary_pred ),
         CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_pred );
-     ALIGNED( 256 ) BinaryFunction aligned_binary_op( binary_op );
+    ALIGNED( 256 ) BinaryFunction aligned_binary_op( binary_op );
     control::buffPointer binaryFunctionBuffer = ctl.acquireBuffer( sizeof( aligned_binary_op ),
         CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_op );
 
-    control::buffPointer keySumArray  = ctl.acquireBuffer( sizeScanBuff*sizeof( kType ) );
-    control::buffPointer preSumArray  = ctl.acquireBuffer( sizeScanBuff*sizeof( voType ) );
-    control::buffPointer postSumArray = ctl.acquireBuffer( sizeScanBuff*sizeof( voType ) );
-    control::buffPointer offsetArray  = ctl.acquireBuffer( numElements *sizeof( int ) );
-    control::buffPointer offsetValArray  = ctl.acquireBuffer( numElements *sizeof( voType ) );
-    cl_uint ldsKeySize, ldsValueSize;
-
-    //Fill the buffer with zeros
-    ::cl::Event fillEvent;
-    ctl.getCommandQueue().enqueueFillBuffer( *offsetArray, 0, 0, numElements *sizeof( int ), NULL, &fillEvent);
-    bolt::cl::wait(ctl, fillEvent);
-
-
-    /**********************************************************************************
-     *  Kernel 0
-     *********************************************************************************/
-    try
-    {
-    ldsKeySize   = static_cast< cl_uint >( kernel0_WgSize * sizeof( kType ) );
-    ldsValueSize = static_cast< cl_uint >( kernel0_WgSize * sizeof( voType ) );
-    V_OPENCL( kernels[0].setArg( 0, keys_first.getContainer().getBuffer()), "Error setArg kernels[ 0 ]" ); // Input keys
-    V_OPENCL( kernels[0].setArg( 1, keys_first.gpuPayloadSize( ), &keys_first.gpuPayload( )), "Error setArg kernels[ 0 ]" );
-    V_OPENCL( kernels[0].setArg( 2, values_first.getContainer().getBuffer()),"Error setArg kernels[ 0 ]" ); // Input values
-    V_OPENCL( kernels[0].setArg( 3, values_first.gpuPayloadSize( ), &values_first.gpuPayload( )), "Error setArg kernels[ 0 ]" ); // Input values
-    V_OPENCL( kernels[0].setArg( 4, *offsetValArray ), "Error setArg kernels[ 0 ]" ); // Output values
-    V_OPENCL( kernels[0].setArg( 5, *offsetArray  ), "Error setArg kernels[ 0 ]" ); // Output keys
-    V_OPENCL( kernels[0].setArg( 6, numElements ), "Error setArg kernels[ 0 ]" ); // vecSize
-    V_OPENCL( kernels[0].setArg( 7, ldsKeySize, NULL ),     "Error setArg kernels[ 0 ]" ); // Scratch buffer
-    V_OPENCL( kernels[0].setArg( 8, ldsValueSize, NULL ),   "Error setArg kernels[ 0 ]" ); // Scratch buffer
-    V_OPENCL( kernels[0].setArg( 9, *binaryPredicateBuffer),"Error setArg kernels[ 0 ]" ); // User provided functor
-    V_OPENCL( kernels[0].setArg( 10, *binaryFunctionBuffer ),"Error setArg kernels[ 0 ]" ); // User provided functor
-    V_OPENCL( kernels[0].setArg( 11, *keySumArray ),         "Error setArg kernels[ 0 ]" ); // Output per block sum
-    V_OPENCL( kernels[0].setArg( 12, *preSumArray ),         "Error setArg kernels[ 0 ]" ); // Output per block sum
-
-    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
-        kernels[0],
-        ::cl::NullRange,
-        ::cl::NDRange( sizeInputBuff ),
-        ::cl::NDRange( kernel0_WgSize ),
-        NULL,
-        &kernel0Event);
-    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for kernel[0]" );
-    }
-    catch( const ::cl::Error& e)
-    {
-        std::cerr << "::cl::enqueueNDRangeKernel( 0 ) in bolt::cl::reduce_by_key_enqueue()" << std::endl;
-        std::cerr << "Error Code:   " << clErrorStringA(e.err()) << " (" << e.err() << ")" << std::endl;
-        std::cerr << "File:         " << __FILE__ << ", line " << __LINE__ << std::endl;
-        std::cerr << "Error String: " << e.what() << std::endl;
-    }
-
-    /**********************************************************************************
-     *  Kernel 1
-     *********************************************************************************/
-    cl_uint workPerThread = static_cast< cl_uint >( sizeScanBuff / kernel1_WgSize );
-    V_OPENCL( kernels[1].setArg( 0, *keySumArray ),         "Error setArg kernels[ 1 ]" ); // Input keys
-    V_OPENCL( kernels[1].setArg( 1, *preSumArray ),         "Error setArg kernels[ 1 ]" ); // Input buffer
-    V_OPENCL( kernels[1].setArg( 2, *postSumArray ),        "Error setArg kernels[ 1 ]" ); // Output buffer
-    V_OPENCL( kernels[1].setArg( 3, numWorkGroupsK0 ),      "Error setArg kernels[ 1 ]" ); // Size of scratch buffer
-    V_OPENCL( kernels[1].setArg( 4, ldsKeySize, NULL ),     "Error setArg kernels[ 1 ]" ); // Scratch buffer
-    V_OPENCL( kernels[1].setArg( 5, ldsValueSize, NULL ),   "Error setArg kernels[ 1 ]" ); // Scratch buffer
-    V_OPENCL( kernels[1].setArg( 6, workPerThread ),        "Error setArg kernels[ 1 ]" ); // Work Per Thread
-    V_OPENCL( kernels[1].setArg( 7, *binaryPredicateBuffer ),"Error setArg kernels[ 1 ]" ); // User provided functor
-    V_OPENCL( kernels[1].setArg( 8, *binaryFunctionBuffer ),"Error setArg kernels[ 1 ]" ); // User provided functor
-
-    try
+    //  The look-back needs zeroed tile states and room for two pairs per tile; the two-pass path needs one pair per
+    //  tile instead.  The buffers of the path that is not taken are only placeholders.  LookBackPair has the layout
+    //  of the reduceByKeyPair the kernel publishes.
+    struct LookBackPair
     {
-    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
-        kernels[1],
-        ::cl::NullRange,
-        ::cl::NDRange( kernel1_WgSize ), // only 1 work-group
-        ::cl::NDRange( kernel1_WgSize ),
-        NULL,
-        &kernel1Event);
-    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for kernel[1]" );
-    }
-    catch( const ::cl::Error& e)
+        cl_uint count;
+        voType value;
+    };
+    const size_t pairWords = ( sizeof( LookBackPair ) + sizeof( cl_uint ) - 1 ) / sizeof( cl_uint );
+    control::buffPointer tileStatus = ctl.acquireBuffer( ( singlePass ? numTiles + 1 : 1 ) * sizeof( cl_uint ) );
+    control::buffPointer tileValues = ctl.acquireBuffer(
+        ( singlePass ? 2 * numTiles * pairWords : 1 ) * sizeof( cl_uint ) );
+    control::buffPointer tileCounts = ctl.acquireBuffer( ( singlePass ? 1 : numTiles ) * sizeof( cl_uint ) );
+    control::buffPointer tileSums = ctl.acquireBuffer( ( singlePass ? 1 : numTiles ) * sizeof( voType ) );
+    control::buffPointer outputCount = ctl.acquireBuffer( sizeof( cl_uint ) );
+
+    ::cl::LocalSpaceArg ldsKeys, ldsVals, ldsCounts, ldsCarries;
+    ldsKeys.size_ = tileSize * sizeof( kType );
+    ldsVals.size_ = tileSize * sizeof( voType );
+    ldsCounts.size_ = wgSize * sizeof( cl_uint );
+    ldsCarries.size_ = wgSize * sizeof( voType );
+
+    std::vector< ::cl::Event > prepareEvents;
+    if( singlePass )
     {
-        std::cerr << "::cl::enqueueNDRangeKernel( 1 ) in bolt::cl::reduce_by_key_enqueue()" << std::endl;
-        std::cerr << "Error Code:   " << clErrorStringA(e.err()) << " (" << e.err() << ")" << std::endl;
-        std::cerr << "File:         " << __FILE__ << ", line " << __LINE__ << std::endl;
-        std::cerr << "Error String: " << e.what() << std::endl;
+        ::cl::Event fillEvent;
+        l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *tileStatus, 0, 0, ( numTiles + 1 ) * sizeof( cl_uint ),
+            NULL, &fillEvent );
+        V_OPENCL( l_Error, "enqueueFillBuffer() failed for the reduce_by_key tile status" );
+        prepareEvents.push_back( fillEvent );
     }
-
-#if ENABLE_PRINTS
-    //delete this code -start
-    bolt::cl::wait(ctl, kernel0Event);
-    bolt::cl::wait(ctl, kernel1Event);
-    ::cl::Event l_mapEvent_k1;
-    voType *post_sum_k1= (voType*)ctl.commandQueue().enqueueMapBuffer( *postSumArray,
-                                                                    false,
-                                                                    CL_MAP_READ,
-                                                                    0,
-                                                                    sizeof(voType)*sizeScanBuff,
-                                                                    NULL,
-                                                                    &l_mapEvent_k1,
-                                                                    &l_Error );
-    V_OPENCL( l_Error, "Error calling map on the result buffer" );
-    std::cout<<"Myval-------------------------starts"<<std::endl;
-    std::ofstream postsum("postsum.txt");
-    for(unsigned int i = 0; i < sizeScanBuff ; i++)
+    else
     {
-        postsum<<post_sum_k1[i]<<std::endl;
+        /**********************************************************************************
+         *  Kernel 0
+         *********************************************************************************/
+        V_OPENCL( kernels[0].setArg( 0, keys_first.getContainer().getBuffer()), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 1, keys_first.gpuPayloadSize( ), &keys_first.gpuPayload( )),
+                  "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 2, values_first.getContainer().getBuffer()), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 3, values_first.gpuPayloadSize( ), &values_first.gpuPayload( )),
+                  "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 4, numElements ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 5, ldsKeys ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 6, ldsVals ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 7, ldsCounts ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 8, ldsCarries ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 9, *binaryPredicateBuffer ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 10, *binaryFunctionBuffer ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 11, *tileCounts ), "Error setArg kernels[ 0 ]" );
+        V_OPENCL( kernels[0].setArg( 12, *tileSums ), "Error setArg kernels[ 0 ]" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[0],
+            ::cl::NullRange,
+            ::cl::NDRange( numTiles * wgSize ),
+            ::cl::NDRange( wgSize ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for kernel[0]" );
+
+        /**********************************************************************************
+         *  Kernel 1
+         *********************************************************************************/
+        V_OPENCL( kernels[1].setArg( 0, *tileCounts ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[1].setArg( 1, *tileSums ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[1].setArg( 2, numTiles ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[1].setArg( 3, ldsCounts ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[1].setArg( 4, ldsCarries ), "Error setArg kernels[ 1 ]" );
+        V_OPENCL( kernels[1].setArg( 5, *binaryFunctionBuffer ), "Error setArg kernels[ 1 ]" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[1],
+            ::cl::NullRange,
+            ::cl::NDRange( wgSize ), // only 1 work-group
+            ::cl::NDRange( wgSize ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for kernel[1]" );
     }
-    postsum.close();
-    std::cout<<"Myval-------------------------ends"<<std::endl;
-    bolt::cl::wait(ctl, l_mapEvent_k1);
-    //delete this code -end
-
-#endif
 
     /**********************************************************************************
      *  Kernel 2
      *********************************************************************************/
-    V_OPENCL( kernels[2].setArg( 0, *keySumArray ),         "Error setArg kernels[ 2 ]" ); // Input buffer
-    V_OPENCL( kernels[2].setArg( 1, *postSumArray ),        "Error setArg kernels[ 2 ]" ); // Input buffer
-    V_OPENCL( kernels[2].setArg( 2, keys_first.getContainer().getBuffer()), "Error setArg kernels[ 2 ]" ); // Output buffer
-    V_OPENCL( kernels[2].setArg( 3, keys_first.gpuPayloadSize( ), &keys_first.gpuPayload( )), "Error setArg kernels[ 0 ]" );
-    V_OPENCL( kernels[2].setArg( 4, *offsetArray), "Error setArg kernels[ 2 ]" ); // Output buffer
-    V_OPENCL( kernels[2].setArg( 5, *offsetValArray),   "Error setArg kernels[ 2 ]" ); // Output buffer
-    V_OPENCL( kernels[2].setArg( 6, numElements ),          "Error setArg kernels[ 2 ]" ); // Size of scratch buffer
-    V_OPENCL( kernels[2].setArg( 7, *binaryPredicateBuffer ),"Error setArg kernels[ 2 ]" ); // User provided functor
-    V_OPENCL( kernels[2].setArg( 8, *binaryFunctionBuffer ),"Error setArg kernels[ 2 ]" ); // User provided functor
-
-    try
-    {
+    cl_int doSinglePass = singlePass ? 1 : 0;
+    cl_uint arg = 0;
+    V_OPENCL( kernels[2].setArg( arg++, keys_first.getContainer().getBuffer()), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, keys_first.gpuPayloadSize( ), &keys_first.gpuPayload( )),
+              "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, values_first.getContainer().getBuffer()), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, values_first.gpuPayloadSize( ), &values_first.gpuPayload( )),
+              "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, keys_output.getContainer().getBuffer()), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, keys_output.gpuPayloadSize( ), &keys_output.gpuPayload( )),
+              "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, values_output.getContainer().getBuffer()), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, values_output.gpuPayloadSize( ), &values_output.gpuPayload( )),
+              "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, numElements ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, ldsKeys ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, ldsVals ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, ldsCounts ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, ldsCarries ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, *binaryPredicateBuffer ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, *binaryFunctionBuffer ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, *tileStatus ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, *tileValues ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, *tileCounts ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, *tileSums ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, doSinglePass ), "Error setArg kernels[ 2 ]" );
+    V_OPENCL( kernels[2].setArg( arg++, *outputCount ), "Error setArg kernels[ 2 ]" );
+
     l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
         kernels[2],
         ::cl::NullRange,
-        ::cl::NDRange( sizeInputBuff ),
-        ::cl::NDRange( kernel2_WgSize ),
-        NULL,
-        &kernel2Event );
+        ::cl::NDRange( numTiles * wgSize ),
+        ::cl::NDRange( wgSize ),
+        singlePass ? &prepareEvents : NULL );
     V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for kernel[2]" );
-    }
-    catch( const ::cl::Error& e)
-    {
-        std::cerr << "::cl::enqueueNDRangeKernel( 2 ) in bolt::cl::reduce_by_key_enqueue()" << std::endl;
-        std::cerr << "Error Code:   " << clErrorStringA(e.err()) << " (" << e.err() << ")" << std::endl;
-        std::cerr << "File:         " << __FILE__ << ", line " << __LINE__ << std::endl;
-        std::cerr << "Error String: " << e.what() << std::endl;
-    }
-
-    // wait for results
-    l_Error = kernel2Event.wait( );
-    V_OPENCL( l_Error, "post-kernel[2] failed wait" );
-
-    //
-    // Now take the output keys and increment each non-zero value from previous value.
-    // This is done serially. It doesn't look GPU friendly.
-    //
-
-    ::cl::Event l_mapEvent;
-    int *h_result = (int*)ctl.getCommandQueue().enqueueMapBuffer( *offsetArray,
-                                                                    false,
-                                                                    CL_MAP_READ | CL_MAP_WRITE,
-                                                                    0,
-                                                                    sizeof(int)*numElements,
-                                                                    NULL,
-                                                                    &l_mapEvent,
-                                                                    &l_Error );
-    V_OPENCL( l_Error, "Error calling map on the result buffer" );
-
-    bolt::cl::wait(ctl, l_mapEvent);
-
-#if ENABLE_PRINTS
-    //delete this code -start
-    ::cl::Event l_mapEvent2;
-    voType *v_result = (voType*)ctl.commandQueue().enqueueMapBuffer( *offsetValArray,
-                                                                    false,
-                                                                    CL_MAP_READ,
-                                                                    0,
-                                                                    sizeof(voType)*numElements,
-                                                                    NULL,
-                                                                    &l_mapEvent2,
-                                                                    &l_Error );
-    V_OPENCL( l_Error, "Error calling map on the result buffer" );
-    std::cout<<"Myval-------------------------starts"<<std::endl;
-    std::ofstream val_result("offsetValArray.txt");
-    val_result<<numElements<<std::endl;
-    for(unsigned int i = 0; i < LENGTH_TEST ; i++)
-    {
-        val_result<<v_result[i]<<std::endl;
-    }
-    val_result.close();
-    std::cout<<"Myval-------------------------ends"<<std::endl;
-    bolt::cl::wait(ctl, l_mapEvent2);
-    //delete this code -end
-    std::ofstream result_b4_ser("result_b4_ser.txt");
-    for(unsigned int i = 0; i < LENGTH_TEST ; i++)
-    {
-        //std::cout<<h_result[i]<<std::endl;
-
-        result_b4_ser<<h_result[i]<<std::endl;
-    }
-    result_b4_ser.close();
 
-#endif
+    //  The blocking read also waits for the outputs, which are written by the same in-order queue
+    cl_uint numSections = 0;
+    l_Error = ctl.getCommandQueue( ).enqueueReadBuffer( *outputCount, CL_TRUE, 0, sizeof( cl_uint ), &numSections );
+    V_OPENCL( l_Error, "enqueueReadBuffer() failed for the reduce_by_key output count" );
 
-    // Doing this serially; Performance killer!!
-    unsigned int count_number_of_sections = 0;
-    //h_result [ numElements - 1 ] = 1;  //This is a quick fix!
-    for( unsigned int i = 0; i < numElements; i++ )
-    {
-        if(h_result[i]>0)
-        {
-            h_result[i] = count_number_of_sections;
-            count_number_of_sections++;
-        }
-    }
-
-
-#if ENABLE_PRINTS
-    std::cout<<count_number_of_sections<<std::endl;
-    std::ofstream result_file("offsetArray.txt");
-    for(unsigned int i = 0; i < LENGTH_TEST ; i++)
-    {
-        result_file<<h_result[i]<<std::endl;
-    }
-    result_file.close();
-
-#endif
-    //
-    // Now unmap it. We map the indices back to keys_output using "keys_output"
-    //
-
-    ::cl::Event l_unmapEvent;
-    cl_int l_unmapError = CL_SUCCESS;
-    l_unmapError = ctl.getCommandQueue().enqueueUnmapMemObject( *offsetArray , h_result, NULL, &l_unmapEvent );
-    V_OPENCL( l_unmapError, "device_vector failed to unmap host memory back to device memory" );
-    //V_OPENCL( l_unmapEvent.wait( ), "failed to wait for unmap event" );
-
-    bolt::cl::wait(ctl, l_unmapEvent);
-
-    /**********************************************************************************
-     *  Kernel 3
-     *********************************************************************************/
-    V_OPENCL( kernels[3].setArg( 0, keys_first.getContainer().getBuffer()),    "Error setArg kernels[ 3 ]" ); // Input buffer
-    V_OPENCL( kernels[3].setArg( 1, keys_first.gpuPayloadSize( ), &keys_first.gpuPayload( )), "Error setArg kernels[ 0 ]" );
-    V_OPENCL( kernels[3].setArg( 2, keys_output.getContainer().getBuffer() ),  "Error setArg kernels[ 3 ]" ); // Output buffer
-    V_OPENCL( kernels[3].setArg( 3, keys_output.gpuPayloadSize( ), &keys_output.gpuPayload( )), "Error setArg kernels[ 0 ]" );
-    V_OPENCL( kernels[3].setArg( 4, values_output.getContainer().getBuffer()), "Error setArg kernels[ 3 ]" ); // Output buffer
-    V_OPENCL( kernels[3].setArg( 5, values_output.gpuPayloadSize( ), &values_output.gpuPayload( )), "Error setArg kernels[ 0 ]" );
-    V_OPENCL( kernels[3].setArg( 6, *offsetArray),                "Error setArg kernels[ 3 ]" ); // Input buffer
-    V_OPENCL( kernels[3].setArg( 7, *offsetValArray),             "Error setArg kernels[ 3 ]"  );
-    V_OPENCL( kernels[3].setArg( 8, numElements ),             "Error setArg kernels[ 3 ]" ); // Size of scratch buffer
-    V_OPENCL( kernels[3].setArg( 9, count_number_of_sections), "Error setArg kernels[ 3 ]" ); // Size of scratch buffer
-
-
-    try
-    {
-    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
-        kernels[3],
-        ::cl::NullRange,
-        ::cl::NDRange( sizeInputBuff ),
-        ::cl::NDRange( kernel0_WgSize ),
-        NULL,
-        &kernel3Event );
-    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for kernel[3]" );
-    }
-    catch( const ::cl::Error& e)
-    {
-        std::cerr << "::cl::enqueueNDRangeKernel( 3 ) in bolt::cl::reduce_by_key_enqueue()" << std::endl;
-        std::cerr << "Error Code:   " << clErrorStringA(e.err()) << " (" << e.err() << ")" << std::endl;
-        std::cerr << "File:         " << __FILE__ << ", line " << __LINE__ << std::endl;
-        std::cerr << "Error String: " << e.what() << std::endl;
-    }
-    // wait for results
-    l_Error = kernel3Event.wait( );
-    V_OPENCL( l_Error, "post-kernel[3] failed wait" );
-
-#if ENABLE_PRINTS
-    //delete this code -start
-    ::cl::Event l_mapEvent3;
-    voType *v_result2 = (voType*)ctl.commandQueue().enqueueMapBuffer( *offsetValArray,
-                                                                    false,
-                                                                    CL_MAP_READ,
-                                                                    0,
-                                                                    sizeof(voType)*numElements,
-                                                                    NULL,
-                                                                    &l_mapEvent3,
-                                                                    &l_Error );
-    V_OPENCL( l_Error, "Error calling map on the result buffer" );
-    std::cout<<"Myval-------------------------starts"<<std::endl;
-    std::ofstream result_val_after_launch("result_val_after_launch.txt");
-    for(unsigned int i = 0; i < LENGTH_TEST ; i++)
-    {
-        result_val_after_launch<<v_result2[i]<<std::endl;
-    }
-    result_val_after_launch.close();
-    std::cout<<"Myval-------------------------ends"<<std::endl;
-    bolt::cl::wait(ctl, l_mapEvent3);
-    //delete this code -end
-
-#endif
-    return count_number_of_sections;
+    return numSections;
     }   //end of reduce_by_key_enqueue( )
 
     /*!   \}  */
@@ -0,0 +1,868 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_REDUCE_BY_KEY_UNSORTED_INL )
+#define BOLT_CL_REDUCE_BY_KEY_UNSORTED_INL
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/copy.h"
+#include "bolt/cl/reduce_by_key.h"
+#include "bolt/cl/stablesort_by_key.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/stablesort.h"
+#endif
+
+#define REDUCE_BY_KEY_UNSORTED_WGSIZE 256
+//  The table always has at least twice as many slots as there are elements, up to this cap; 4M slots of an int key
+//  and a float value take 32MB
+#define REDUCE_BY_KEY_UNSORTED_MIN_SLOTS ( 1 << 6 )
+#define REDUCE_BY_KEY_UNSORTED_MAX_SLOTS ( 1 << 22 )
+#define REDUCE_BY_KEY_UNSORTED_EMPTY 0xFFFFFFFF
+
+namespace bolt
+{
+namespace cl
+{
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2>
+bolt::cl::pair<OutputIterator1, OutputIterator2>
+reduce_by_key_unsorted(
+    control& ctl,
+    InputIterator1  keys_first,
+    InputIterator1  keys_last,
+    InputIterator2  values_first,
+    OutputIterator1  keys_output,
+    OutputIterator2  values_output,
+    const std::string& user_code )
+{
+    typedef std::iterator_traits<InputIterator1>::value_type kType;
+    typedef std::iterator_traits<OutputIterator2>::value_type ValOType;
+    return detail::reduce_by_key_unsorted_detect_random_access( ctl, keys_first, keys_last, values_first,
+        keys_output, values_output, equal_to< kType >( ), plus< ValOType >( ), user_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2>
+bolt::cl::pair<OutputIterator1, OutputIterator2>
+reduce_by_key_unsorted(
+    InputIterator1  keys_first,
+    InputIterator1  keys_last,
+    InputIterator2  values_first,
+    OutputIterator1  keys_output,
+    OutputIterator2  values_output,
+    const std::string& user_code )
+{
+    return reduce_by_key_unsorted( control::getDefault( ), keys_first, keys_last, values_first, keys_output,
+                                   values_output, user_code );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryFunction>
+bolt::cl::pair<OutputIterator1, OutputIterator2>
+reduce_by_key_unsorted(
+    control& ctl,
+    InputIterator1  keys_first,
+    InputIterator1  keys_last,
+    InputIterator2  values_first,
+    OutputIterator1  keys_output,
+    OutputIterator2  values_output,
+    BinaryFunction binary_op,
+    const std::string& user_code )
+{
+    typedef std::iterator_traits<InputIterator1>::value_type kType;
+    return detail::reduce_by_key_unsorted_detect_random_access( ctl, keys_first, keys_last, values_first,
+        keys_output, values_output, equal_to< kType >( ), binary_op, user_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryFunction>
+bolt::cl::pair<OutputIterator1, OutputIterator2>
+reduce_by_key_unsorted(
+    InputIterator1  keys_first,
+    InputIterator1  keys_last,
+    InputIterator2  values_first,
+    OutputIterator1  keys_output,
+    OutputIterator2  values_output,
+    BinaryFunction binary_op,
+    const std::string& user_code )
+{
+    return reduce_by_key_unsorted( control::getDefault( ), keys_first, keys_last, values_first, keys_output,
+                                   values_output, binary_op, user_code );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+bolt::cl::pair<OutputIterator1, OutputIterator2>
+reduce_by_key_unsorted(
+    control& ctl,
+    InputIterator1  keys_first,
+    InputIterator1  keys_last,
+    InputIterator2  values_first,
+    OutputIterator1  keys_output,
+    OutputIterator2  values_output,
+    BinaryPredicate binary_pred,
+    BinaryFunction binary_op,
+    const std::string& user_code )
+{
+    return detail::reduce_by_key_unsorted_detect_random_access( ctl, keys_first, keys_last, values_first,
+        keys_output, values_output, binary_pred, binary_op, user_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+bolt::cl::pair<OutputIterator1, OutputIterator2>
+reduce_by_key_unsorted(
+    InputIterator1  keys_first,
+    InputIterator1  keys_last,
+    InputIterator2  values_first,
+    OutputIterator1  keys_output,
+    OutputIterator2  values_output,
+    BinaryPredicate binary_pred,
+    BinaryFunction binary_op,
+    const std::string& user_code )
+{
+    return reduce_by_key_unsorted( control::getDefault( ), keys_first, keys_last, values_first, keys_output,
+                                   values_output, binary_pred, binary_op, user_code );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+namespace bolt
+{
+namespace cl
+{
+namespace detail
+{
+
+enum reduceByKeyUnsortedTypes { rbku_kType, rbku_kIterType, rbku_vType, rbku_vIterType, rbku_koType,
+                                rbku_koIterType, rbku_voType, rbku_voIterType, rbku_end };
+
+class ReduceByKeyUnsorted_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    ReduceByKeyUnsorted_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("hashAggregateTemplate");
+        addKernelName("hashCompactTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified key and value types\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[rbku_kType] + "* keys_ptr,\n"
+            + typeNames[rbku_kIterType] + " keys_iter,\n"
+            "global " + typeNames[rbku_vType] + "* values_ptr,\n"
+            + typeNames[rbku_vIterType] + " values_iter,\n"
+            "const uint length,\n"
+            "const uint tableMask,\n"
+            "global " + typeNames[rbku_kType] + "* tableKeys,\n"
+            "global " + typeNames[rbku_vType] + "* tableValues,\n"
+            "global uint* counters\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified key and value types\n"
+            "template __attribute__((mangled_name(" + name(1) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(1) + "(\n"
+            "global " + typeNames[rbku_kType] + "* tableKeys,\n"
+            "global " + typeNames[rbku_vType] + "* tableValues,\n"
+            "const uint tableMask,\n"
+            "global uint* counters,\n"
+            "global " + typeNames[rbku_koType] + "* keys_output_ptr,\n"
+            + typeNames[rbku_koIterType] + " keys_output_iter,\n"
+            "global " + typeNames[rbku_voType] + "* values_output_ptr,\n"
+            + typeNames[rbku_voIterType] + " values_output_iter\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  The device table stores keys that fit the 32 bit atomics and compares them bitwise, which is only the same as the
+//  predicate for integer keys compared with equal_to.  The host hash map has the same requirement.
+template< typename kType, typename BinaryPredicate >
+struct reduce_by_key_unsorted_hash_key : std::integral_constant< bool,
+    ( std::is_same< kType, cl_int >::value || std::is_same< kType, cl_uint >::value ) &&
+    std::is_same< BinaryPredicate, bolt::cl::equal_to< kType > >::value >
+{
+};
+
+template< typename T >
+struct reduce_by_key_unsorted_atomic_value : std::integral_constant< bool,
+    std::is_same< T, cl_int >::value || std::is_same< T, cl_uint >::value || std::is_same< T, cl_float >::value >
+{
+};
+
+//  Reductions with a global atomic, or a compare-and-swap loop for float; value is the REDUCE_BY_KEY_UNSORTED_OP
+//  define of the kernels, and identity() is what every table slot starts from
+template< typename T, typename BinaryFunction >
+struct reduce_by_key_unsorted_atomic_op : std::false_type
+{
+};
+
+template< typename T >
+struct reduce_by_key_unsorted_atomic_op< T, bolt::cl::plus< T > > : reduce_by_key_unsorted_atomic_value< T >
+{
+    static const int op = 0;
+    static T identity( ) { return T( 0 ); }
+};
+
+template< typename T >
+struct reduce_by_key_unsorted_atomic_op< T, bolt::cl::minimum< T > > : reduce_by_key_unsorted_atomic_value< T >
+{
+    static const int op = 1;
+    static T identity( )
+    {
+        return std::numeric_limits< T >::has_infinity ? std::numeric_limits< T >::infinity( )
+                                                       : ( std::numeric_limits< T >::max )( );
+    }
+};
+
+template< typename T >
+struct reduce_by_key_unsorted_atomic_op< T, bolt::cl::maximum< T > > : reduce_by_key_unsorted_atomic_value< T >
+{
+    static const int op = 2;
+    static T identity( )
+    {
+        return std::numeric_limits< T >::has_infinity ? -std::numeric_limits< T >::infinity( )
+                                                       : ( std::numeric_limits< T >::min )( );
+    }
+};
+
+template< typename kType, typename vType, typename BinaryPredicate, typename BinaryFunction >
+struct reduce_by_key_unsorted_device_hash : std::integral_constant< bool,
+    reduce_by_key_unsorted_hash_key< kType, BinaryPredicate >::value &&
+    reduce_by_key_unsorted_atomic_op< vType, BinaryFunction >::value >
+{
+};
+
+//  Orders (key, value) records on the key alone; used by the sorting CPU path
+template< typename Record >
+struct reduce_by_key_unsorted_key_less
+{
+    bool operator( )( const Record& lhs, const Record& rhs ) const
+    {
+        return lhs.first < rhs.first;
+    }
+};
+
+//  Serial aggregation in a hash map from every key to its output position; the groups come out in the order in which
+//  their keys first appear
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryFunction>
+unsigned int
+reduce_by_key_unsorted_hash_cpu(
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 values_output,
+    const BinaryFunction& binary_op )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    typedef typename std::unordered_map< kType, size_t >::iterator groupIterator;
+
+    std::unordered_map< kType, size_t > groups;
+    groups.reserve( static_cast< size_t >( std::distance( keys_first, keys_last ) ) );
+
+    size_t numGroups = 0;
+    for( ; keys_first != keys_last; ++keys_first, ++values_first )
+    {
+        std::pair< groupIterator, bool > inserted = groups.insert( std::make_pair( *keys_first, numGroups ) );
+        if( inserted.second )
+        {
+            keys_output[ numGroups ] = *keys_first;
+            values_output[ numGroups ] = *values_first;
+            ++numGroups;
+        }
+        else
+        {
+            size_t group = inserted.first->second;
+            values_output[ group ] = binary_op( values_output[ group ], *values_first );
+        }
+    }
+
+    return static_cast< unsigned int >( numGroups );
+}
+
+//  Stable sort of the (key, value) records on the key, then a reduction of the runs of equal keys; the groups come
+//  out in ascending key order
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+unsigned int
+reduce_by_key_unsorted_sort_cpu(
+    bolt::cl::control::e_RunMode runMode,
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 values_output,
+    const BinaryPredicate& binary_pred,
+    const BinaryFunction& binary_op )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< InputIterator2 >::value_type vType;
+    typedef std::pair< kType, vType > Record;
+
+    size_t numElements = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+    std::vector< Record > records( numElements );
+    for( size_t i = 0; i < numElements; ++i, ++keys_first, ++values_first )
+        records[ i ] = Record( *keys_first, *values_first );
+
+    if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        bolt::btbb::stable_sort( records.begin( ), records.end( ), reduce_by_key_unsorted_key_less< Record >( ) );
+#else
+        throw std::exception( "The MultiCoreCpu version of reduce_by_key_unsorted is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        std::stable_sort( records.begin( ), records.end( ), reduce_by_key_unsorted_key_less< Record >( ) );
+    }
+
+    size_t numGroups = 0;
+    for( size_t i = 0; i < numElements; ++i )
+    {
+        if( i > 0 && binary_pred( records[ i - 1 ].first, records[ i ].first ) )
+        {
+            values_output[ numGroups - 1 ] = binary_op( values_output[ numGroups - 1 ], records[ i ].second );
+        }
+        else
+        {
+            keys_output[ numGroups ] = records[ i ].first;
+            values_output[ numGroups ] = records[ i ].second;
+            ++numGroups;
+        }
+    }
+
+    return static_cast< unsigned int >( numGroups );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+unsigned int
+reduce_by_key_unsorted_cpu(
+    bolt::cl::control::e_RunMode runMode,
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 values_output,
+    const BinaryPredicate& binary_pred,
+    const BinaryFunction& binary_op,
+    std::true_type )
+{
+    if( runMode == bolt::cl::control::SerialCpu )
+        return reduce_by_key_unsorted_hash_cpu( keys_first, keys_last, values_first, keys_output, values_output,
+                                                binary_op );
+
+    return reduce_by_key_unsorted_sort_cpu( runMode, keys_first, keys_last, values_first, keys_output,
+                                            values_output, binary_pred, binary_op );
+}
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+unsigned int
+reduce_by_key_unsorted_cpu(
+    bolt::cl::control::e_RunMode runMode,
+    InputIterator1 keys_first,
+    InputIterator1 keys_last,
+    InputIterator2 values_first,
+    OutputIterator1 keys_output,
+    OutputIterator2 values_output,
+    const BinaryPredicate& binary_pred,
+    const BinaryFunction& binary_op,
+    std::false_type )
+{
+    return reduce_by_key_unsorted_sort_cpu( runMode, keys_first, keys_last, values_first, keys_output,
+                                            values_output, binary_pred, binary_op );
+}
+
+//  Sorting fallback of the OpenCL path: stable sort a copy of the keys and values, so that equal keys become
+//  adjacent, and hand them to reduce_by_key
+template<
+    typename DVInputIterator1,
+    typename DVInputIterator2,
+    typename DVOutputIterator1,
+    typename DVOutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+unsigned int
+reduce_by_key_unsorted_sort_enqueue(
+    control& ctl,
+    const DVInputIterator1& keys_first,
+    const DVInputIterator1& keys_last,
+    const DVInputIterator2& values_first,
+    const DVOutputIterator1& keys_output,
+    const DVOutputIterator2& values_output,
+    const BinaryPredicate& binary_pred,
+    const BinaryFunction& binary_op,
+    const std::string& user_code )
+{
+    typedef typename std::iterator_traits< DVInputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< DVInputIterator2 >::value_type vType;
+
+    size_t numElements = static_cast< size_t >( std::distance( keys_first, keys_last ) );
+    device_vector< kType > dvKeys( numElements, kType( ), CL_MEM_READ_WRITE, false, ctl );
+    device_vector< vType > dvValues( numElements, vType( ), CL_MEM_READ_WRITE, false, ctl );
+
+    bolt::cl::copy( ctl, keys_first, keys_last, dvKeys.begin( ), user_code );
+    bolt::cl::copy( ctl, values_first, values_first + numElements, dvValues.begin( ), user_code );
+    bolt::cl::stable_sort_by_key( ctl, dvKeys.begin( ), dvKeys.end( ), dvValues.begin( ), less< kType >( ),
+                                  user_code );
+
+    bolt::cl::pair< DVOutputIterator1, DVOutputIterator2 > ends = bolt::cl::reduce_by_key( ctl, dvKeys.begin( ),
+        dvKeys.end( ), dvValues.begin( ), keys_output, values_output, binary_pred, binary_op, user_code );
+
+    return static_cast< unsigned int >( ends.first - keys_output );
+}
+
+//  Hash aggregation on the device.  Returns false, leaving the outputs untouched, when the table overflowed and the
+//  caller has to sort instead.
+template<
+    typename DVInputIterator1,
+    typename DVInputIterator2,
+    typename DVOutputIterator1,
+    typename DVOutputIterator2,
+    typename BinaryFunction>
+bool
+reduce_by_key_unsorted_hash_enqueue(
+    control& ctl,
+    const DVInputIterator1& keys_first,
+    const DVInputIterator1& keys_last,
+    const DVInputIterator2& values_first,
+    const DVOutputIterator1& keys_output,
+    const DVOutputIterator2& values_output,
+    const BinaryFunction& binary_op,
+    const std::string& user_code,
+    unsigned int& numGroups,
+    std::true_type )
+{
+    typedef typename std::iterator_traits< DVInputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< DVInputIterator2 >::value_type vType;
+    typedef typename std::iterator_traits< DVOutputIterator1 >::value_type koType;
+    typedef typename std::iterator_traits< DVOutputIterator2 >::value_type voType;
+    typedef reduce_by_key_unsorted_atomic_op< vType, BinaryFunction > atomicOp;
+
+    cl_int l_Error = CL_SUCCESS;
+    cl_uint szElements = static_cast< cl_uint >( std::distance( keys_first, keys_last ) );
+
+    //  At most half of the slots are ever taken, which keeps the probe sequences short
+    cl_uint capacity = REDUCE_BY_KEY_UNSORTED_MIN_SLOTS;
+    while( capacity < 2 * static_cast< size_t >( szElements ) && capacity < REDUCE_BY_KEY_UNSORTED_MAX_SLOTS )
+        capacity <<= 1;
+    cl_uint tableMask = capacity - 1;
+
+    std::vector< std::string > typeNames( rbku_end );
+    typeNames[ rbku_kType ] = TypeName< kType >::get( );
+    typeNames[ rbku_kIterType ] = TypeName< DVInputIterator1 >::get( );
+    typeNames[ rbku_vType ] = TypeName< vType >::get( );
+    typeNames[ rbku_vIterType ] = TypeName< DVInputIterator2 >::get( );
+    typeNames[ rbku_koType ] = TypeName< koType >::get( );
+    typeNames[ rbku_koIterType ] = TypeName< DVOutputIterator1 >::get( );
+    typeNames[ rbku_voType ] = TypeName< voType >::get( );
+    typeNames[ rbku_voIterType ] = TypeName< DVOutputIterator2 >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, user_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< kType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator1 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< vType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator2 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< koType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOutputIterator1 >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< voType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOutputIterator2 >::get( ) )
+
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << REDUCE_BY_KEY_UNSORTED_WGSIZE;
+    oss << " -DREDUCE_BY_KEY_UNSORTED_OP=" << atomicOp::op;
+
+    ReduceByKeyUnsorted_KernelTemplateSpecializer kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &kts, typeDefinitions,
+                                                                reduce_by_key_unsorted_kernels, oss.str( ) );
+
+    cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+    size_t maxWG = computeUnits * ctl.getWGPerComputeUnit( );
+    size_t aggregateWG = std::min( maxWG,
+        static_cast< size_t >( ( szElements + REDUCE_BY_KEY_UNSORTED_WGSIZE - 1 ) / REDUCE_BY_KEY_UNSORTED_WGSIZE ) );
+    size_t compactWG = std::min( maxWG,
+        static_cast< size_t >( capacity / REDUCE_BY_KEY_UNSORTED_WGSIZE + 1 ) );
+
+    //  The slot past the end of the table holds the key whose bits mark an empty slot
+    device_vector< kType > dvTableKeys( capacity + 1, static_cast< kType >( REDUCE_BY_KEY_UNSORTED_EMPTY ),
+                                        CL_MEM_READ_WRITE, true, ctl );
+    device_vector< vType > dvTableValues( capacity + 1, atomicOp::identity( ), CL_MEM_READ_WRITE, true, ctl );
+
+    control::buffPointer counters = ctl.acquireBuffer( 4 * sizeof( cl_uint ) );
+    ::cl::Event fillEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *counters, 0, 0, 4 * sizeof( cl_uint ), NULL, &fillEvent );
+    V_OPENCL( l_Error, "enqueueFillBuffer() failed for the reduce_by_key_unsorted counters" );
+
+    V_OPENCL( kernels[ 0 ].setArg( 0, keys_first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 1, keys_first.gpuPayloadSize( ), &keys_first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 2, values_first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 3, values_first.gpuPayloadSize( ), &values_first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 4, szElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 5, tableMask ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 6, dvTableKeys.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 7, dvTableValues.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 8, *counters ), "Error setting kernel argument" );
+
+    std::vector< ::cl::Event > fillEvents( 1, fillEvent );
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 0 ],
+        ::cl::NullRange,
+        ::cl::NDRange( aggregateWG * REDUCE_BY_KEY_UNSORTED_WGSIZE ),
+        ::cl::NDRange( REDUCE_BY_KEY_UNSORTED_WGSIZE ),
+        &fillEvents );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for hashAggregate kernel" );
+
+    cl_uint h_counters[ 3 ] = { 0, 0, 0 };
+    l_Error = ctl.getCommandQueue( ).enqueueReadBuffer( *counters, CL_TRUE, 0, 3 * sizeof( cl_uint ), h_counters );
+    V_OPENCL( l_Error, "enqueueReadBuffer() failed for the reduce_by_key_unsorted counters" );
+
+    //  Too many distinct keys for the table; nothing has been written to the outputs yet
+    if( h_counters[ 0 ] )
+        return false;
+
+    V_OPENCL( kernels[ 1 ].setArg( 0, dvTableKeys.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 1, dvTableValues.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 2, tableMask ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 3, *counters ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 4, keys_output.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 5, keys_output.gpuPayloadSize( ), &keys_output.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 6, values_output.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 7, values_output.gpuPayloadSize( ), &values_output.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+
+    ::cl::Event compactEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 1 ],
+        ::cl::NullRange,
+        ::cl::NDRange( compactWG * REDUCE_BY_KEY_UNSORTED_WGSIZE ),
+        ::cl::NDRange( REDUCE_BY_KEY_UNSORTED_WGSIZE ),
+        NULL,
+        &compactEvent );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for hashCompact kernel" );
+    bolt::cl::wait( ctl, compactEvent );
+
+    numGroups = h_counters[ 1 ] + h_counters[ 2 ];
+    return true;
+}
+
+template<
+    typename DVInputIterator1,
+    typename DVInputIterator2,
+    typename DVOutputIterator1,
+    typename DVOutputIterator2,
+    typename BinaryFunction>
+bool
+reduce_by_key_unsorted_hash_enqueue(
+    control& ctl,
+    const DVInputIterator1& keys_first,
+    const DVInputIterator1& keys_last,
+    const DVInputIterator2& values_first,
+    const DVOutputIterator1& keys_output,
+    const DVOutputIterator2& values_output,
+    const BinaryFunction& binary_op,
+    const std::string& user_code,
+    unsigned int& numGroups,
+    std::false_type )
+{
+    return false;
+}
+
+template<
+    typename DVInputIterator1,
+    typename DVInputIterator2,
+    typename DVOutputIterator1,
+    typename DVOutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+unsigned int
+reduce_by_key_unsorted_enqueue(
+    control& ctl,
+    const DVInputIterator1& keys_first,
+    const DVInputIterator1& keys_last,
+    const DVInputIterator2& values_first,
+    const DVOutputIterator1& keys_output,
+    const DVOutputIterator2& values_output,
+    const BinaryPredicate& binary_pred,
+    const BinaryFunction& binary_op,
+    const std::string& user_code )
+{
+    typedef typename std::iterator_traits< DVInputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< DVInputIterator2 >::value_type vType;
+
+    unsigned int numGroups = 0;
+    if( reduce_by_key_unsorted_hash_enqueue( ctl, keys_first, keys_last, values_first, keys_output, values_output,
+            binary_op, user_code, numGroups,
+            reduce_by_key_unsorted_device_hash< kType, vType, BinaryPredicate, BinaryFunction >( ) ) )
+        return numGroups;
+
+    return reduce_by_key_unsorted_sort_enqueue( ctl, keys_first, keys_last, values_first, keys_output,
+                                                values_output, binary_pred, binary_op, user_code );
+}
+
+/*********************************************************************************************************************
+ * Detect Random Access
+ ********************************************************************************************************************/
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+bolt::cl::pair<OutputIterator1, OutputIterator2>
+reduce_by_key_unsorted_detect_random_access(
+    control& ctl,
+    const InputIterator1& keys_first,
+    const InputIterator1& keys_last,
+    const InputIterator2& values_first,
+    const OutputIterator1& keys_output,
+    const OutputIterator2& values_output,
+    const BinaryPredicate& binary_pred,
+    const BinaryFunction& binary_op,
+    const std::string& user_code,
+    std::input_iterator_tag )
+{
+    //  TODO:  It should be possible to support non-random_access_iterator_tag iterators, if we copied the data
+    //  to a temporary buffer.  Should we?
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+bolt::cl::pair<OutputIterator1, OutputIterator2>
+reduce_by_key_unsorted_detect_random_access(
+    control& ctl,
+    const InputIterator1& keys_first,
+    const InputIterator1& keys_last,
+    const InputIterator2& values_first,
+    const OutputIterator1& keys_output,
+    const OutputIterator2& values_output,
+    const BinaryPredicate& binary_pred,
+    const BinaryFunction& binary_op,
+    const std::string& user_code,
+    std::random_access_iterator_tag )
+{
+    return reduce_by_key_unsorted_pick_iterator( ctl, keys_first, keys_last, values_first, keys_output,
+        values_output, binary_pred, binary_op, user_code,
+        std::iterator_traits< InputIterator1 >::iterator_category( ) );
+}
+
+//  Device Vector specialization; the values and the outputs have to be device_vector iterators as well
+template<
+    typename DVInputIterator1,
+    typename DVInputIterator2,
+    typename DVOutputIterator1,
+    typename DVOutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+bolt::cl::pair<DVOutputIterator1, DVOutputIterator2>
+reduce_by_key_unsorted_pick_iterator(
+    control& ctl,
+    const DVInputIterator1& keys_first,
+    const DVInputIterator1& keys_last,
+    const DVInputIterator2& values_first,
+    const DVOutputIterator1& keys_output,
+    const DVOutputIterator2& values_output,
+    const BinaryPredicate& binary_pred,
+    const BinaryFunction& binary_op,
+    const std::string& user_code,
+    bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< DVInputIterator2 >::value_type vType;
+    typedef typename std::iterator_traits< DVOutputIterator1 >::value_type koType;
+    typedef typename std::iterator_traits< DVOutputIterator2 >::value_type voType;
+    static_assert( std::is_convertible< vType, voType >::value, "InputValue and Output iterators are incompatible" );
+
+    unsigned int numElements = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+    if( numElements == 0 )
+        return bolt::cl::make_pair( keys_output, values_output );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< kType >::pointer keysPtr = keys_first.getContainer( ).data( );
+        bolt::cl::device_vector< vType >::pointer valsPtr = values_first.getContainer( ).data( );
+        bolt::cl::device_vector< koType >::pointer oKeysPtr = keys_output.getContainer( ).data( );
+        bolt::cl::device_vector< voType >::pointer oValsPtr = values_output.getContainer( ).data( );
+        unsigned int sizeOfOut = reduce_by_key_unsorted_cpu( runMode, &keysPtr[ keys_first.m_Index ],
+            &keysPtr[ keys_first.m_Index ] + numElements, &valsPtr[ values_first.m_Index ], &oKeysPtr[ keys_output.m_Index ],
+            &oValsPtr[ values_output.m_Index ], binary_pred, binary_op,
+            reduce_by_key_unsorted_hash_key< kType, BinaryPredicate >( ) );
+        return bolt::cl::make_pair( keys_output + sizeOfOut, values_output + sizeOfOut );
+    }
+
+    unsigned int sizeOfOut = reduce_by_key_unsorted_enqueue( ctl, keys_first, keys_last, values_first, keys_output,
+                                                             values_output, binary_pred, binary_op, user_code );
+    return bolt::cl::make_pair( keys_output + sizeOfOut, values_output + sizeOfOut );
+}
+
+//  Non Device Vector specialization.
+//  This implementation wraps the host memory in device_vectors and calls the device_vector path.
+template<
+    typename InputIterator1,
+    typename InputIterator2,
+    typename OutputIterator1,
+    typename OutputIterator2,
+    typename BinaryPredicate,
+    typename BinaryFunction>
+bolt::cl::pair<OutputIterator1, OutputIterator2>
+reduce_by_key_unsorted_pick_iterator(
+    control& ctl,
+    const InputIterator1& keys_first,
+    const InputIterator1& keys_last,
+    const InputIterator2& values_first,
+    const OutputIterator1& keys_output,
+    const OutputIterator2& values_output,
+    const BinaryPredicate& binary_pred,
+    const BinaryFunction& binary_op,
+    const std::string& user_code,
+    std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator1 >::value_type kType;
+    typedef typename std::iterator_traits< InputIterator2 >::value_type vType;
+    typedef typename std::iterator_traits< OutputIterator1 >::value_type koType;
+    typedef typename std::iterator_traits< OutputIterator2 >::value_type voType;
+    static_assert( std::is_convertible< vType, voType >::value, "InputValue and Output iterators are incompatible" );
+
+    unsigned int numElements = static_cast< unsigned int >( std::distance( keys_first, keys_last ) );
+    if( numElements == 0 )
+        return bolt::cl::make_pair( keys_output, values_output );
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        unsigned int sizeOfOut = reduce_by_key_unsorted_cpu( runMode, keys_first, keys_last, values_first,
+            keys_output, values_output, binary_pred, binary_op,
+            reduce_by_key_unsorted_hash_key< kType, BinaryPredicate >( ) );
+        return bolt::cl::make_pair( keys_output + sizeOfOut, values_output + sizeOfOut );
+    }
+
+    unsigned int sizeOfOut;
+    {
+        device_vector< kType > dvKeys( keys_first, keys_last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< vType > dvValues( values_first, numElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, true,
+                                         ctl );
+        device_vector< koType > dvKOutput( keys_output, numElements, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false,
+                                           ctl );
+        device_vector< voType > dvVOutput( values_output, numElements, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false,
+                                           ctl );
+
+        sizeOfOut = reduce_by_key_unsorted_enqueue( ctl, dvKeys.begin( ), dvKeys.end( ), dvValues.begin( ),
+            dvKOutput.begin( ), dvVOutput.begin( ), binary_pred, binary_op, user_code );
+
+        //  Map the outputs back to the host
+        dvKOutput.data( );
+        dvVOutput.data( );
+    }
+    return bolt::cl::make_pair( keys_output + sizeOfOut, values_output + sizeOfOut );
+}
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
@@ -19,17 +19,6 @@
  *****************************************************************************/
 #if !defined( BOLT_CL_SCAN_INL )
 #define BOLT_CL_SCAN_INL
-//#ifndef USE_AMD_HSA
-#define USE_AMD_HSA 0
-//#endif
-
-#if USE_AMD_HSA
-#define HSA_STAT_INIT 0 // device hasn't done pre-scan
-#define HSA_STAT_DEVP1COMPLETE 1 // device has done pre-scan
-#define HSA_STAT_CPUP2COMPLETE 2 // cpu has done intermediate scan
-#define HSA_STAT_DEVP3COMPLETE 3 // gpu has done post scan
-#endif
-
 
 #pragma once
 
@@ -37,7 +26,6 @@
 
 #define KERNEL02WAVES 4
 #define KERNEL1WAVES 4
-#define HSAWAVES 4
 #define WAVESIZE 64
 
 #ifdef BOLT_PROFILER_ENABLED
@@ -227,6 +215,125 @@ OutputIterator exclusive_scan(
            std::iterator_traits< InputIterator >::iterator_category( ) );
 };
 
+//////////////////////////////////////////
+//  Scan with carry overloads
+//////////////////////////////////////////
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator inclusive_scan_with_carry(
+    control &ctrl,
+    InputIterator first,
+    InputIterator last,
+    OutputIterator result,
+    device_vector< T >& carry,
+    BinaryFunction binary_op,
+    const std::string& user_code )
+{
+    return detail::scan_with_carry_detect_random_access(
+           ctrl, first, last, result, carry, true, binary_op,
+           std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator inclusive_scan_with_carry(
+    InputIterator first,
+    InputIterator last,
+    OutputIterator result,
+    device_vector< T >& carry,
+    BinaryFunction binary_op,
+    const std::string& user_code )
+{
+    return detail::scan_with_carry_detect_random_access(
+           control::getDefault( ), first, last, result, carry, true, binary_op,
+           std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+template< typename InputIterator, typename OutputIterator, typename T >
+OutputIterator inclusive_scan_with_carry(
+    control &ctrl,
+    InputIterator first,
+    InputIterator last,
+    OutputIterator result,
+    device_vector< T >& carry,
+    const std::string& user_code )
+{
+    typedef std::iterator_traits<InputIterator>::value_type iType;
+    return detail::scan_with_carry_detect_random_access(
+           ctrl, first, last, result, carry, true, plus< iType >( ),
+           std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+template< typename InputIterator, typename OutputIterator, typename T >
+OutputIterator inclusive_scan_with_carry(
+    InputIterator first,
+    InputIterator last,
+    OutputIterator result,
+    device_vector< T >& carry,
+    const std::string& user_code )
+{
+    typedef std::iterator_traits<InputIterator>::value_type iType;
+    return detail::scan_with_carry_detect_random_access(
+           control::getDefault( ), first, last, result, carry, true, plus< iType >( ),
+           std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator exclusive_scan_with_carry(
+    control &ctrl,
+    InputIterator first,
+    InputIterator last,
+    OutputIterator result,
+    device_vector< T >& carry,
+    BinaryFunction binary_op,
+    const std::string& user_code )
+{
+    return detail::scan_with_carry_detect_random_access(
+           ctrl, first, last, result, carry, false, binary_op,
+           std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator exclusive_scan_with_carry(
+    InputIterator first,
+    InputIterator last,
+    OutputIterator result,
+    device_vector< T >& carry,
+    BinaryFunction binary_op,
+    const std::string& user_code )
+{
+    return detail::scan_with_carry_detect_random_access(
+           control::getDefault( ), first, last, result, carry, false, binary_op,
+           std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+template< typename InputIterator, typename OutputIterator, typename T >
+OutputIterator exclusive_scan_with_carry(
+    control &ctrl,
+    InputIterator first,
+    InputIterator last,
+    OutputIterator result,
+    device_vector< T >& carry,
+    const std::string& user_code )
+{
+    typedef std::iterator_traits<InputIterator>::value_type iType;
+    return detail::scan_with_carry_detect_random_access(
+           ctrl, first, last, result, carry, false, plus< iType >( ),
+           std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
+template< typename InputIterator, typename OutputIterator, typename T >
+OutputIterator exclusive_scan_with_carry(
+    InputIterator first,
+    InputIterator last,
+    OutputIterator result,
+    device_vector< T >& carry,
+    const std::string& user_code )
+{
+    typedef std::iterator_traits<InputIterator>::value_type iType;
+    return detail::scan_with_carry_detect_random_access(
+           control::getDefault( ), first, last, result, carry, false, plus< iType >( ),
+           std::iterator_traits< InputIterator >::iterator_category( ) );
+};
+
 template<
     typename vType,
     typename oType,
@@ -272,6 +379,37 @@ Serial_scan(
 
 
 
+//  Scans one batch of a stream, starting from the carry and leaving the running value in it
+template< typename vType, typename oType, typename BinaryFunction >
+oType*
+Serial_scan_with_carry(
+    vType *values,
+    oType *result,
+    unsigned int  num,
+    const BinaryFunction binary_op,
+    const bool Incl,
+    oType &carry)
+{
+    oType sum = carry;
+    for ( unsigned int i= 0; i<num; i++)
+    {
+        vType currentValue = *(values + i);
+        if (Incl)
+        {
+            sum = binary_op( sum, currentValue);
+            *(result + i) = sum;
+        }
+        else
+        {
+            *(result + i) = sum;
+            sum = binary_op( sum, currentValue);
+        }
+    }
+    carry = sum;
+    return result;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 namespace detail
@@ -285,36 +423,15 @@ class Scan_KernelTemplateSpecializer : public KernelTemplateSpecializer
 public:
     Scan_KernelTemplateSpecializer() : KernelTemplateSpecializer()
         {
-#if USE_AMD_HSA
-        addKernelName("HSA_Scan");
-#else
         addKernelName("perBlockInclusiveScan");
         addKernelName("intraBlockInclusiveScan");
         addKernelName("perBlockAddition");
-#endif
+        addKernelName("singlePassScan");
+        addKernelName("scanApplyCarry");
     }
 
     const ::std::string operator() ( const ::std::vector<::std::string>& typeNames ) const
             {
-#if USE_AMD_HSA
-                    const std::string templateSpecializationString =
-                        "// Dynamic specialization of generic template definition, using user supplied types\n"
-            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
-            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
-            "kernel void " + name(0) + "(\n"
-            "global " + typeNames[scan_oType] + " *output,\n"
-            "global " + typeNames[scan_iType] + " *input,\n"
-            ""        + typeNames[scan_initType] + " init,\n"
-            "const uint numElements,\n"
-            "const uint numIterations,\n"
-            "local "  + typeNames[scan_oType] + " *lds,\n"
-            "global " + typeNames[scan_BinaryFunction] + " *binaryOp,\n"
-            "global " + typeNames[scan_oType] + " *intermediateScanArray,\n"
-            "global int *status1,\n"
-            "global int *status2,\n"
-            "int exclusive\n"
-            ");\n\n";
-#else
         const std::string templateSpecializationString =
             "// Template specialization\n"
             "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
@@ -359,8 +476,40 @@ public:
             "global " + typeNames[scan_BinaryFunction] + "* binaryOp,\n"
             "int exclusive,\n"
              ""        + typeNames[scan_initType] + " identity\n"
+            ");\n\n"
+
+            "// Template specialization\n"
+            "template __attribute__((mangled_name(" + name(3) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(3) + "(\n"
+            "global " + typeNames[scan_oValueType] + "* output_ptr,\n"
+            ""        + typeNames[scan_oIterType] + " output_iter,\n"
+            "global " + typeNames[scan_iValueType] + "* input_ptr,\n"
+            ""        + typeNames[scan_iIterType] + " input_iter,\n"
+            ""        + typeNames[scan_initType] + " identity,\n"
+            "const uint vecSize,\n"
+            "local "  + typeNames[scan_iValueType] + "* lds,\n"
+            "global " + typeNames[scan_BinaryFunction] + "* binaryOp,\n"
+            "global uint* tileStatus,\n"
+            "global uint* tileValues,\n"
+            "int exclusive,\n"
+            "global " + typeNames[scan_oValueType] + "* carry,\n"
+            "int useCarry\n"
+            ");\n\n"
+
+            "// Template specialization\n"
+            "template __attribute__((mangled_name(" + name(4) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(4) + "(\n"
+            "global " + typeNames[scan_oValueType] + "* output_ptr,\n"
+            ""        + typeNames[scan_oIterType] + " output_iter,\n"
+            "global " + typeNames[scan_oValueType] + "* scanned,\n"
+            "const uint vecSize,\n"
+            "global " + typeNames[scan_oValueType] + "* carryIn,\n"
+            "global " + typeNames[scan_oValueType] + "* carry,\n"
+            "global " + typeNames[scan_BinaryFunction] + "* binaryOp,\n"
+            "int exclusive\n"
             ");\n\n";
-#endif
             return templateSpecializationString;
             }
 };
@@ -583,11 +732,11 @@ aProfiler.stopTrial();
 
                if(inclusive)
                {
-                 return bolt::btbb::inclusive_scan(first, last, result, binary_op);
+                 return bolt::btbb::inclusive_scan(fancyFirst, fancyLast, result, binary_op);
                }
                else
                {
-                return bolt::btbb::exclusive_scan( first, last, result, init, binary_op);
+                return bolt::btbb::exclusive_scan( fancyFirst, fancyLast, result, init, binary_op);
                }
 
 #else
@@ -609,7 +758,156 @@ aProfiler.stopTrial();
             return result + numElements;
         }
 
-static int tmp = 0;
+        template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+        OutputIterator scan_with_carry_detect_random_access( control &ctrl, const InputIterator& first,
+            const InputIterator& last, const OutputIterator& result, device_vector< T >& carry,
+            const bool& inclusive, const BinaryFunction& binary_op, std::input_iterator_tag )
+        {
+            static_assert( false, "Bolt only supports random access iterator types" );
+        };
+
+        template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+        OutputIterator scan_with_carry_detect_random_access( control &ctrl, const InputIterator& first,
+            const InputIterator& last, const OutputIterator& result, device_vector< T >& carry,
+            const bool& inclusive, const BinaryFunction& binary_op, bolt::cl::fancy_iterator_tag )
+        {
+            static_assert( false, "Scan with a carry does not support fancy iterators yet" );
+        };
+
+        template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+        OutputIterator scan_with_carry_detect_random_access( control &ctrl, const InputIterator& first,
+            const InputIterator& last, const OutputIterator& result, device_vector< T >& carry,
+            const bool& inclusive, const BinaryFunction& binary_op, std::random_access_iterator_tag )
+        {
+            typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+            static_assert( std::is_same< T, oType >::value, "The carry must have the value type of the output" );
+
+            return detail::scan_with_carry_pick_iterator( ctrl, first, last, result, carry, inclusive, binary_op,
+                std::iterator_traits< InputIterator >::iterator_category( ) );
+        };
+
+        /*!
+        * \brief This overload is called strictly for non-device_vector iterators
+        * \details This template function overload is used to seperate device_vector iterators from all other iterators
+        */
+        template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+        OutputIterator scan_with_carry_pick_iterator( control &ctrl, const InputIterator& first,
+            const InputIterator& last, const OutputIterator& result, device_vector< T >& carry,
+            const bool& inclusive, const BinaryFunction& binary_op, std::random_access_iterator_tag )
+        {
+            typedef typename std::iterator_traits< InputIterator >::value_type iType;
+            typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+            static_assert( std::is_convertible< iType, oType >::value, "Input and Output iterators are incompatible" );
+
+            unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
+            if( numElements < 1 )
+                return result;
+
+            bolt::cl::control::e_RunMode runMode = ctrl.getForceRunMode( );
+
+            if( runMode == bolt::cl::control::Automatic )
+            {
+                runMode = ctrl.getDefaultPathToRun( );
+            }
+
+            if( runMode == bolt::cl::control::SerialCpu )
+            {
+                bolt::cl::device_vector< oType >::pointer carryPtr = carry.data( );
+                Serial_scan_with_carry<iType, oType, BinaryFunction>( &(*first), &(*result), numElements, binary_op,
+                                                                     inclusive, carryPtr[ 0 ] );
+                return result + numElements;
+            }
+            else if( runMode == bolt::cl::control::MultiCoreCpu )
+            {
+#ifdef ENABLE_TBB
+                bolt::cl::device_vector< oType >::pointer carryPtr = carry.data( );
+                if( inclusive )
+                    return bolt::btbb::inclusive_scan_with_carry( first, last, result, carryPtr[ 0 ], binary_op );
+                else
+                    return bolt::btbb::exclusive_scan_with_carry( first, last, result, carryPtr[ 0 ], binary_op );
+#else
+                throw std::exception( "The MultiCoreCpu version of Scan is not enabled to be built! \n" );
+#endif
+            }
+            else
+            {
+                // Map the input iterator to a device_vector
+                device_vector< iType > dvInput( first, last,  CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, ctrl );
+                device_vector< oType > dvOutput(result,numElements,CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY,false,ctrl);
+
+                //  The carry takes the place of init, so init is only a placeholder
+                scan_enqueue( ctrl, dvInput.begin( ), dvInput.end( ), dvOutput.begin( ), oType( ), binary_op,
+                    inclusive, &carry.getBuffer( ) );
+
+                // This should immediately map/unmap the buffer
+                dvOutput.data( );
+            }
+
+            return result + numElements;
+        }
+
+        /*!
+        * \brief This overload is called strictly for device_vector iterators
+        * \details This template function overload is used to seperate device_vector iterators from all other iterators
+        */
+        template< typename DVInputIterator, typename DVOutputIterator, typename T, typename BinaryFunction >
+        DVOutputIterator scan_with_carry_pick_iterator( control &ctrl, const DVInputIterator& first,
+            const DVInputIterator& last, const DVOutputIterator& result, device_vector< T >& carry,
+            const bool& inclusive, const BinaryFunction& binary_op, bolt::cl::device_vector_tag )
+        {
+            typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+            typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+            static_assert( std::is_convertible< iType, oType >::value, "Input and Output iterators are incompatible" );
+
+            unsigned int numElements = static_cast< unsigned int >( std::distance( first, last ) );
+            if( numElements < 1 )
+                return result;
+
+            bolt::cl::control::e_RunMode runMode = ctrl.getForceRunMode( );
+
+            if( runMode == bolt::cl::control::Automatic )
+            {
+                runMode = ctrl.getDefaultPathToRun( );
+            }
+
+            if( runMode == bolt::cl::control::SerialCpu )
+            {
+                bolt::cl::device_vector< iType >::pointer scanInputBuffer =  first.getContainer( ).data( );
+                bolt::cl::device_vector< oType >::pointer scanResultBuffer =  result.getContainer( ).data( );
+                bolt::cl::device_vector< oType >::pointer carryPtr = carry.data( );
+                Serial_scan_with_carry<iType, oType, BinaryFunction>( &scanInputBuffer[first.m_Index],
+                    &scanResultBuffer[result.m_Index], numElements, binary_op, inclusive, carryPtr[ 0 ] );
+                return result + numElements;
+            }
+            else if( runMode == bolt::cl::control::MultiCoreCpu )
+            {
+#ifdef ENABLE_TBB
+                bolt::cl::device_vector< iType >::pointer scanInputBuffer =  first.getContainer( ).data( );
+                bolt::cl::device_vector< oType >::pointer scanResultBuffer =  result.getContainer( ).data( );
+                bolt::cl::device_vector< oType >::pointer carryPtr = carry.data( );
+
+                if( inclusive )
+                    bolt::btbb::inclusive_scan_with_carry( &scanInputBuffer[first.m_Index],
+                        &scanInputBuffer[first.m_Index] + numElements, &scanResultBuffer[result.m_Index],
+                        carryPtr[ 0 ], binary_op );
+                else
+                    bolt::btbb::exclusive_scan_with_carry( &scanInputBuffer[first.m_Index],
+                        &scanInputBuffer[first.m_Index] + numElements, &scanResultBuffer[result.m_Index],
+                        carryPtr[ 0 ], binary_op );
+
+                return result + numElements;
+#else
+                throw std::exception( "The MultiCoreCpu version of Scan with device vector is not enabled to be built! \n" );
+#endif
+            }
+            else
+            {
+                //  The carry takes the place of init, so init is only a placeholder
+                scan_enqueue( ctrl, first, last, result, oType( ), binary_op, inclusive, &carry.getBuffer( ) );
+            }
+
+            return result + numElements;
+        }
 
 //  All calls to inclusive_scan end up here, unless an exception was thrown
 //  This is the function that sets up the kernels to compile (once only) and execute
@@ -621,7 +919,8 @@ void scan_enqueue(
     const DVOutputIterator& result,
     const T& init_T,
     const BinaryFunction& binary_op,
-    const bool& inclusive = true )
+    const bool& inclusive = true,
+    const ::cl::Buffer* carry = NULL )
 {
 #ifdef BOLT_PROFILER_ENABLED
 aProfiler.nextStep();
@@ -630,9 +929,6 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
 #endif
     cl_int l_Error = CL_SUCCESS;
     cl_uint doExclusiveScan = inclusive ? 0 : 1;
-    const size_t numComputeUnits = ctrl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
-    const size_t numWorkGroupsPerComputeUnit = ctrl.getWGPerComputeUnit( );
-    const size_t workGroupSize = HSAWAVES*WAVESIZE;
 
     /**********************************************************************************
      * Type Names - used in KernelTemplateSpecializer
@@ -672,8 +968,8 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
     oss << " -DKERNEL0WORKGROUPSIZE=" << kernel0_WgSize;
     oss << " -DKERNEL1WORKGROUPSIZE=" << kernel1_WgSize;
     oss << " -DKERNEL2WORKGROUPSIZE=" << kernel2_WgSize;
-
-    oss << " -DUSE_AMD_HSA=" << USE_AMD_HSA;
+    const cl_uint itemsPerWorkItem = singlePassScanItemsPerWorkItem( ctrl, sizeof( iType ), kernel0_WgSize );
+    oss << " -DSCAN_ITEMS_PER_WORKITEM=" << itemsPerWorkItem;
     compileOptions = oss.str();
 
     /**********************************************************************************
@@ -685,7 +981,7 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
         typeNames,
         &ts_kts,
         typeDefinitions,
-        scan_kernels,
+        lookback_kernels + scan_kernels,
         compileOptions);
     // kernels returned in same order as added in KernelTemplaceSpecializer constructor
 
@@ -720,169 +1016,100 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
 
 
 
-#if USE_AMD_HSA
-    /**********************************************************************************
-     *
-     *  HSA Implementation
-     *
-     *********************************************************************************/
-#ifdef BOLT_PROFILER_ENABLED
-aProfiler.nextStep();
-aProfiler.setStepName("Setup HSA Kernel");
-aProfiler.set(AsyncProfiler::device, control::SerialCpu);
-#endif
-
-    ::cl::Event kernel0Event;
-    size_t numWorkGroups = numComputeUnits * numWorkGroupsPerComputeUnit;
-    if (numWorkGroupsK0 < numWorkGroups)
-        numWorkGroups = numWorkGroupsK0; // nWG is lesser of elements vs compute units
-    ldsSize = static_cast< cl_uint >( ( kernel0_WgSize ) * sizeof( oType ) );
-
-    // allocate and initialize gpu -> cpu array
-    control::buffPointer dev2hostD = ctrl.acquireBuffer( numWorkGroups*sizeof( int ),
-        CL_MEM_ALLOC_HOST_PTR /*| CL_MEM_READ_WRITE*/ );
-    ctrl.getCommandQueue().enqueueFillBuffer( *dev2hostD, HSA_STAT_INIT, 0, numWorkGroups*sizeof( int ) );
-    int *dev2hostH = (int *) ctrl.getCommandQueue().enqueueMapBuffer( *dev2hostD, CL_TRUE, CL_MAP_READ, 0,
-        numWorkGroups*sizeof( int ), NULL, NULL, &l_Error);
-    V_OPENCL( l_Error, "Error: Mapping Device->Host Buffer." );
-
-    // allocate and initialize cpu -> gpu array
-    control::buffPointer host2devD = ctrl.acquireBuffer( numWorkGroups*sizeof( int ),
-        CL_MEM_USE_PERSISTENT_MEM_AMD | CL_MEM_READ_ONLY /*CL_MEM_ALLOC_HOST_PTR | CL_MEM_READ_ONLY*/ );
-    ctrl.getCommandQueue().enqueueFillBuffer( *host2devD, HSA_STAT_INIT, 0, numWorkGroups*sizeof( int ) );
-    int *host2devH = (int *) ctrl.getCommandQueue().enqueueMapBuffer( *host2devD, CL_TRUE, CL_MAP_WRITE, 0,
-        numWorkGroups*sizeof( int ), NULL, NULL, &l_Error);
-    V_OPENCL( l_Error, "Error: Mapping Host->Device Buffer." );
-
-
-
-    int *intermediateScanStatusHost = new int[ numWorkGroups ];
-    memset( intermediateScanStatusHost, HSA_STAT_INIT, numWorkGroups*sizeof( int ) );
-    oType *intermediateScanArrayHost = new oType[ numWorkGroups ];
-    // TODO remove me b/c wrong and superfluous
-    memset( intermediateScanArrayHost, init_T, numWorkGroups*sizeof( oType ) );
-    control::buffPointer intermediateScanArray  = ctrl.acquireBuffer( numWorkGroups*sizeof( oType ),
-        CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, intermediateScanArrayHost );
-    control::buffPointer intermediateScanStatus = ctrl.acquireBuffer( numWorkGroups*sizeof( int ),
-        CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, intermediateScanStatusHost );
-    // how many iterations
-    cl_uint numIterations = static_cast< cl_uint >( numElementsRUP / (numWorkGroups*workGroupSize) );
-    if (numWorkGroups*workGroupSize*numIterations < numElementsRUP) numIterations++;
-
-    for (size_t i = 0; i < numWorkGroups; i++ )
+    if( supportsSinglePassScan( ctrl ) )
     {
-        std::cout << "preScanStat[" << i << "]="
-            << intermediateScanArrayHost[i]
-        << " ( " << dev2hostH[i] << ", " << host2devH[i] << " )"<< std::endl;
+        /**********************************************************************************
+         *
+         *  Single-pass implementation: the tiles chain their prefixes through a decoupled
+         *  look-back, so the input is read once and the output written once
+         *
+         *********************************************************************************/
+        ::cl::Event fillEvent, singlePassEvent;
+        const size_t tileSize = kernel0_WgSize * itemsPerWorkItem;
+        cl_uint numTiles = static_cast< cl_uint >( ( numElements + tileSize - 1 ) / tileSize );
+        size_t tileWords = ( sizeof( iType ) + sizeof( cl_uint ) - 1 ) / sizeof( cl_uint );
+
+        control::buffPointer tileStatus = ctrl.acquireBuffer( ( numTiles + 1 ) * sizeof( cl_uint ) );
+        control::buffPointer tileValues = ctrl.acquireBuffer( 2 * numTiles * tileWords * sizeof( cl_uint ) );
+        l_Error = ctrl.getCommandQueue( ).enqueueFillBuffer( *tileStatus, 0, 0, ( numTiles + 1 ) * sizeof( cl_uint ),
+            NULL, &fillEvent );
+        V_OPENCL( l_Error, "enqueueFillBuffer() failed for the scan tile status" );
+
+        ldsSize  = static_cast< cl_uint >( tileSize * sizeof( iType ) );
+        V_OPENCL( kernels[ 3 ].setArg( 0, result.getContainer().getBuffer() ), "Error setting argument for kernels[ 3 ]" ); // Output buffer
+        V_OPENCL( kernels[ 3 ].setArg( 1, result.gpuPayloadSize( ), &result.gpuPayload( ) ), "Error setting a kernel argument" );
+        V_OPENCL( kernels[ 3 ].setArg( 2, first.getContainer().getBuffer() ), "Error setting argument for kernels[ 3 ]" ); // Input buffer
+        V_OPENCL( kernels[ 3 ].setArg( 3, first.gpuPayloadSize( ), &first.gpuPayload( ) ), "Error setting a kernel argument" );
+        V_OPENCL( kernels[ 3 ].setArg( 4, init_T ),          "Error setting argument for kernels[ 3 ]" ); // Initial value used for exclusive scan
+        V_OPENCL( kernels[ 3 ].setArg( 5, numElements ),     "Error setting argument for kernels[ 3 ]" ); // Number of elements
+        V_OPENCL( kernels[ 3 ].setArg( 6, ldsSize, NULL ),   "Error setting argument for kernels[ 3 ]" ); // Scratch buffer
+        V_OPENCL( kernels[ 3 ].setArg( 7, *userFunctor ),    "Error setting argument for kernels[ 3 ]" ); // User provided functor class
+        V_OPENCL( kernels[ 3 ].setArg( 8, *tileStatus ),     "Error setting argument for kernels[ 3 ]" ); // Tile counter and states
+        V_OPENCL( kernels[ 3 ].setArg( 9, *tileValues ),     "Error setting argument for kernels[ 3 ]" ); // Tile aggregates and prefixes
+        V_OPENCL( kernels[ 3 ].setArg( 10, doExclusiveScan ), "Error setting argument for kernels[ 3 ]" ); // Exclusive scan?
+        V_OPENCL( kernels[ 3 ].setArg( 11, carry ? *carry : *tileValues ), "Error setting argument for kernels[ 3 ]" ); // Carry in and out
+        V_OPENCL( kernels[ 3 ].setArg( 12, carry ? 1 : 0 ), "Error setting argument for kernels[ 3 ]" ); // Carry used?
+
+        std::vector< ::cl::Event > fillEvents( 1, fillEvent );
+        l_Error = ctrl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 3 ],
+            ::cl::NullRange,
+            ::cl::NDRange( numTiles * kernel0_WgSize ),
+            ::cl::NDRange( kernel0_WgSize ),
+            &fillEvents,
+            &singlePassEvent );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for singlePassScan kernel" );
+
+        l_Error = singlePassEvent.wait( );
+        V_OPENCL( l_Error, "singlePassScan failed to wait" );
+        return;
     }
 
-    /**********************************************************************************
-     * Set Kernel Arguments
-     *********************************************************************************/
-    V_OPENCL( kernels[ 0 ].setArg( 0, result->getBuffer( ) ),   "Error: Output Buffer" );
-    V_OPENCL( kernels[ 0 ].setArg( 1, first->getBuffer( ) ),    "Error: Input Buffer" );
-    V_OPENCL( kernels[ 0 ].setArg( 2, init_T ),                 "Error: Initial Value" );
-    V_OPENCL( kernels[ 0 ].setArg( 3, numElements ),            "Error: Number of Elements" );
-    V_OPENCL( kernels[ 0 ].setArg( 4, numIterations ),          "Error: Number of Iterations" );
-    V_OPENCL( kernels[ 0 ].setArg( 5, ldsSize, NULL ),          "Error: Local Memory" );
-    V_OPENCL( kernels[ 0 ].setArg( 6, *userFunctor ),           "Error: Binary Function" );
-    V_OPENCL( kernels[ 0 ].setArg( 7, *intermediateScanArray ), "Error: Intermediate Scan Array" );
-    V_OPENCL( kernels[ 0 ].setArg( 8, *dev2hostD ),             "Error: Intermediate Scan Status" );
-    V_OPENCL( kernels[ 0 ].setArg( 9, *host2devD ),             "Error: Intermediate Scan Status" );
-    V_OPENCL( kernels[ 0 ].setArg( 10, doExclusiveScan ),       "Error: Do Exclusive Scan" );
-
-#ifdef BOLT_PROFILER_ENABLED
-aProfiler.nextStep();
-aProfiler.setStepName("HSA Kernel");
-aProfiler.set(AsyncProfiler::device, ctrl.forceRunMode());
-aProfiler.set(AsyncProfiler::flops, 2*numElements);
-aProfiler.set(AsyncProfiler::memory,
-    1*numElements*sizeof(iType) + // read input
-    3*numElements*sizeof(oType) + // write,read,write output
-    1*numWorkGroups*sizeof(binary_op) + // in case the functor has state
-    2*numWorkGroups*sizeof(oType)+ // write,read intermediate array
-    2*numWorkGroups*sizeof(int)); // write,read intermediate array status (perhaps multiple times)
-std::string strDeviceName = ctrl.getDevice().getInfo< CL_DEVICE_NAME >( &l_Error );
-bolt::cl::V_OPENCL( l_Error, "Device::getInfo< CL_DEVICE_NAME > failed" );
-aProfiler.setArchitecture(strDeviceName);
-#endif
-    /**********************************************************************************
-     * Launch Kernel
-     *********************************************************************************/
-    l_Error = ctrl.getCommandQueue( ).enqueueNDRangeKernel(
-        kernels[ 0 ],
-        ::cl::NullRange,
-        ::cl::NDRange( numElementsRUP ),
-        ::cl::NDRange( workGroupSize ),
-        NULL,
-        &kernel0Event);
-    ctrl.getCommandQueue().flush(); // needed
-
-    bool printAgain = true;
-    while (printAgain)
-    {
-        printAgain = false;
-        bool writtenToDevice = false;
-        for (size_t i = 0; i < numWorkGroups; i++ )
-        {
-            int stat = dev2hostH[i];
-            std::cout << "interScan[" << i << "]="
-                << intermediateScanArrayHost[i]
-                << " ( " << stat << ", " << host2devH[i] << " )" << std::endl;
-            switch( stat )
-            {
-            case HSA_STAT_INIT: // device hasn't reported P1 completion
-                printAgain = true;
-                break;
-            case HSA_STAT_DEVP1COMPLETE: // device has reported P1 completion
-                // pretend to do P2 here
-                std::cout << "P1[ " << i << " ] completed" << std::endl;
-                host2devH[i] = HSA_STAT_CPUP2COMPLETE; // report P2 completion to device
-                printAgain = true;
-                writtenToDevice = true;
-                break;
-            case HSA_STAT_CPUP2COMPLETE: // n/a
-                // device shouldn't be reporting that host is reporting P2 completion
-                std::cout << "ERROR: dev2host[" << i << "] reporting P2 completion" << std::endl;
-                printAgain = true;
-                break;
-            case HSA_STAT_DEVP3COMPLETE: // device has reported p3 (full) completion
-                // done, don't print Again
-                break;
-            default:
-                std::cout << "ERROR: dev2host[" << i << "] reporting unrecognized" << dev2hostH[i] << std::endl;
-                printAgain = true;
-                break;
-            } // switch
-        } // for workGroups
-        if (writtenToDevice)
-        {
-            std::cout << "\ttmp readback" << std::endl;
-
-            for (size_t i = 0; i < numWorkGroups; i++)
-            {
-                tmp += host2devH[i];
-            }
-        }
-        std::cout << std::endl;
-    } // while printAgain
-
-    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for HSA Kernel." );
-    l_Error = kernel0Event.wait( );
-    V_OPENCL( l_Error, "HSA Kernel failed to wait" );
-
-
-    for (size_t i = 0; i < numWorkGroups; i++ )
+    if( carry )
     {
-        std::cout << "inter2can[" << i << "]=" << intermediateScanArrayHost[i] << " ( " << dev2hostH[i] << " )";
-        std::cout << std::endl;
-                }
-
-#ifdef BOLT_PROFILER_ENABLED
-aProfiler.stopTrial();
-#endif
+        /**********************************************************************************
+         *
+         *  The multi-pass kernels have no carry: scan the batch into a scratch buffer,
+         *  then fold the carry in while writing the result
+         *
+         *********************************************************************************/
+        ::cl::Event copyEvent, carryEvent;
+        device_vector< oType > scanned( numElements, oType( ), CL_MEM_READ_WRITE, false, ctrl );
+        scan_enqueue( ctrl, first, last, scanned.begin( ), init_T, binary_op, true );
+
+        control::buffPointer carryIn = ctrl.acquireBuffer( sizeof( oType ) );
+        l_Error = ctrl.getCommandQueue( ).enqueueCopyBuffer( *carry, *carryIn, 0, 0, sizeof( oType ), NULL,
+            &copyEvent );
+        V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the scan carry" );
+
+        cl_uint computeUnits = ctrl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+        size_t numWorkGroups = ( numElements + kernel0_WgSize - 1 ) / kernel0_WgSize;
+        numWorkGroups = std::min< size_t >( numWorkGroups, computeUnits * ctrl.getWGPerComputeUnit( ) );
+
+        V_OPENCL( kernels[ 4 ].setArg( 0, result.getContainer().getBuffer() ), "Error setting argument for kernels[ 4 ]" ); // Output buffer
+        V_OPENCL( kernels[ 4 ].setArg( 1, result.gpuPayloadSize( ), &result.gpuPayload( ) ), "Error setting a kernel argument" );
+        V_OPENCL( kernels[ 4 ].setArg( 2, scanned.begin( ).getContainer( ).getBuffer( ) ), "Error setting argument for kernels[ 4 ]" ); // Inclusive scan of the batch
+        V_OPENCL( kernels[ 4 ].setArg( 3, numElements ),     "Error setting argument for kernels[ 4 ]" ); // Number of elements
+        V_OPENCL( kernels[ 4 ].setArg( 4, *carryIn ),        "Error setting argument for kernels[ 4 ]" ); // Copy of the carry in
+        V_OPENCL( kernels[ 4 ].setArg( 5, *carry ),          "Error setting argument for kernels[ 4 ]" ); // Carry out
+        V_OPENCL( kernels[ 4 ].setArg( 6, *userFunctor ),    "Error setting argument for kernels[ 4 ]" ); // User provided functor class
+        V_OPENCL( kernels[ 4 ].setArg( 7, doExclusiveScan ), "Error setting argument for kernels[ 4 ]" ); // Exclusive scan?
+
+        std::vector< ::cl::Event > copyEvents( 1, copyEvent );
+        l_Error = ctrl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 4 ],
+            ::cl::NullRange,
+            ::cl::NDRange( numWorkGroups * kernel0_WgSize ),
+            ::cl::NDRange( kernel0_WgSize ),
+            &copyEvents,
+            &carryEvent );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for scanApplyCarry kernel" );
+
+        l_Error = carryEvent.wait( );
+        V_OPENCL( l_Error, "scanApplyCarry failed to wait" );
+        return;
+    }
 
-#else
     /**********************************************************************************
      *
      *  Discrete GPU implementation
@@ -1144,8 +1371,6 @@ aProfiler.setArchitecture(strDeviceName);
 
 #endif // ENABLE_PROFILING
 
-#endif
-
 }   //end of inclusive_scan_enqueue( )
 
 }   //namespace detail
@@ -637,6 +637,7 @@ class ScanByKey_KernelTemplateSpecializer : public KernelTemplateSpecializer
         addKernelName("perBlockScanByKey");
         addKernelName("intraBlockInclusiveScanByKey");
         addKernelName("perBlockAdditionByKey");
+        addKernelName("singlePassScanByKey");
     }
 
     const ::std::string operator() ( const ::std::vector<::std::string>& typeNames ) const
@@ -698,6 +699,28 @@ class ScanByKey_KernelTemplateSpecializer : public KernelTemplateSpecializer
             "global " + typeNames[scanByKey_BinaryFunction] + "* binaryFunct,\n"
             "int exclusive,\n"
             ""        + typeNames[scanByKey_initType] + " identity\n"
+            ");\n\n"
+
+
+            "// Dynamic specialization of generic template definition, using user supplied types\n"
+            "template __attribute__((mangled_name(" + name(3) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "__kernel void " + name(3) + "(\n"
+            "global " + typeNames[scanByKey_kType] + "* keys,\n"
+            ""        + typeNames[scanByKey_kIterType] + " keys_iter,\n"
+            "global " + typeNames[scanByKey_vType] + "* vals,\n"
+            ""        + typeNames[scanByKey_iIterType] + " vals_iter,\n"
+            "global " + typeNames[scanByKey_oType] + "* output,\n"
+            ""        + typeNames[scanByKey_oIterType] + " output_iter,\n"
+            ""        + typeNames[scanByKey_initType] + " init,\n"
+            "const uint vecSize,\n"
+            "local uint* ldsHeads,\n"
+            "local "  + typeNames[scanByKey_oType] + "* ldsVals,\n"
+            "global " + typeNames[scanByKey_BinaryPredicate] + "* binaryPred,\n"
+            "global " + typeNames[scanByKey_BinaryFunction] + "* binaryFunct,\n"
+            "global uint* tileStatus,\n"
+            "global uint* tileValues,\n"
+            "int exclusive\n"
             ");\n\n";
     
         return templateSpecializationString;
@@ -1024,6 +1047,9 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
     oss << " -DKERNEL0WORKGROUPSIZE=" << kernel0_WgSize;
     oss << " -DKERNEL1WORKGROUPSIZE=" << kernel1_WgSize;
     oss << " -DKERNEL2WORKGROUPSIZE=" << kernel2_WgSize;
+    const cl_uint itemsPerWorkItem = singlePassScanItemsPerWorkItem( ctl, sizeof( oType ) + sizeof( cl_uint ),
+        kernel0_WgSize );
+    oss << " -DSCAN_ITEMS_PER_WORKITEM=" << itemsPerWorkItem;
     compileOptions = oss.str();
 
     /**********************************************************************************
@@ -1035,7 +1061,7 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
         typeNames,
         &ts_kts,
         typeDefs,
-        scan_by_key_kernels,
+        lookback_kernels + scan_by_key_kernels,
         compileOptions);
     // kernels returned in same order as added in KernelTemplaceSpecializer constructor
 
@@ -1077,6 +1103,59 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
     control::buffPointer binaryFunctionBuffer = ctl.acquireBuffer( sizeof( aligned_binary_funct ),
         CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_funct );
 
+    if( supportsSinglePassScan( ctl ) )
+    {
+        /**********************************************************************************
+         *  Single-pass implementation: the tiles chain their prefixes through a decoupled
+         *  look-back, so the keys and values are read once and the output written once
+         *********************************************************************************/
+        ::cl::Event fillEvent, singlePassEvent;
+        const size_t tileSize = kernel0_WgSize * itemsPerWorkItem;
+        cl_uint numTiles = static_cast< cl_uint >( ( numElements + tileSize - 1 ) / tileSize );
+        size_t tileWords = ( sizeof( oType ) + sizeof( cl_uint ) - 1 ) / sizeof( cl_uint );
+
+        control::buffPointer tileStatus = ctl.acquireBuffer( ( numTiles + 1 ) * sizeof( cl_uint ) );
+        control::buffPointer tileValues = ctl.acquireBuffer( 2 * numTiles * tileWords * sizeof( cl_uint ) );
+        l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *tileStatus, 0, 0, ( numTiles + 1 ) * sizeof( cl_uint ),
+            NULL, &fillEvent );
+        V_OPENCL( l_Error, "enqueueFillBuffer() failed for the scan_by_key tile status" );
+
+        cl_uint ldsHeadSize = static_cast< cl_uint >( tileSize * sizeof( cl_uint ) );
+        cl_uint ldsOutputSize = static_cast< cl_uint >( tileSize * sizeof( oType ) );
+        V_OPENCL( kernels[3].setArg( 0, firstKey.getContainer().getBuffer()), "Error setArg kernels[ 3 ]" ); // Input keys
+        V_OPENCL( kernels[3].setArg( 1, firstKey.gpuPayloadSize( ), &firstKey.gpuPayload( ) ), "Error setting a kernel argument" );
+        V_OPENCL( kernels[3].setArg( 2, firstValue.getContainer().getBuffer()),"Error setArg kernels[ 3 ]" ); // Input values
+        V_OPENCL( kernels[3].setArg( 3, firstValue.gpuPayloadSize( ), &firstValue.gpuPayload( ) ), "Error setting a kernel argument" );
+        V_OPENCL( kernels[3].setArg( 4, result.getContainer().getBuffer()), "Error setArg kernels[ 3 ]" ); // Output buffer
+        V_OPENCL( kernels[3].setArg( 5, result.gpuPayloadSize( ), &result.gpuPayload( ) ), "Error setting a kernel argument" );
+        V_OPENCL( kernels[3].setArg( 6, init ),                   "Error setArg kernels[ 3 ]" ); // Initial value exclusive
+        V_OPENCL( kernels[3].setArg( 7, numElements ),            "Error setArg kernels[ 3 ]" ); // Number of elements
+        V_OPENCL( kernels[3].setArg( 8, ldsHeadSize, NULL ),      "Error setArg kernels[ 3 ]" ); // Scratch buffer
+        V_OPENCL( kernels[3].setArg( 9, ldsOutputSize, NULL ),    "Error setArg kernels[ 3 ]" ); // Scratch buffer
+        V_OPENCL( kernels[3].setArg( 10, *binaryPredicateBuffer ),"Error setArg kernels[ 3 ]" ); // User provided functor
+        V_OPENCL( kernels[3].setArg( 11, *binaryFunctionBuffer ), "Error setArg kernels[ 3 ]" ); // User provided functor
+        V_OPENCL( kernels[3].setArg( 12, *tileStatus ),           "Error setArg kernels[ 3 ]" ); // Tile counter and states
+        V_OPENCL( kernels[3].setArg( 13, *tileValues ),           "Error setArg kernels[ 3 ]" ); // Tile aggregates and prefixes
+        V_OPENCL( kernels[3].setArg( 14, doExclusiveScan ),       "Error setArg kernels[ 3 ]" ); // Exclusive scan?
+
+        std::vector< ::cl::Event > fillEvents( 1, fillEvent );
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[3],
+            ::cl::NullRange,
+            ::cl::NDRange( numTiles * kernel0_WgSize ),
+            ::cl::NDRange( kernel0_WgSize ),
+            &fillEvents,
+            &singlePassEvent );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for kernel[3]" );
+
+        l_Error = singlePassEvent.wait( );
+        V_OPENCL( l_Error, "post-kernel[3] failed wait" );
+#ifdef BOLT_ENABLE_PROFILING
+aProfiler.stopTrial();
+#endif
+        return;
+    }
+
     control::buffPointer keySumArray  = ctl.acquireBuffer( sizeScanBuff*sizeof( kType ) );
     control::buffPointer preSumArray  = ctl.acquireBuffer( sizeScanBuff*sizeof( vType ) );
     control::buffPointer preSumArray1  = ctl.acquireBuffer( sizeScanBuff*sizeof( vType ) );
@@ -0,0 +1,477 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SEGMENTED_REDUCE_INL )
+#define BOLT_CL_SEGMENTED_REDUCE_INL
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/fill.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/segmented_reduce.h"
+#endif
+
+#define SEGMENTED_REDUCE_WGSIZE 256
+#define SEGMENTED_REDUCE_LONG_FACTOR 8
+
+namespace bolt {
+namespace cl {
+
+/**********************************************************************************************************************
+ * segmented_reduce
+ *********************************************************************************************************************/
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator>
+OutputIterator segmented_reduce(control &ctl,
+                                InputIterator first,
+                                InputIterator last,
+                                OffsetIterator offsets_first,
+                                OffsetIterator offsets_last,
+                                OutputIterator result,
+                                const std::string& cl_code)
+{
+    typedef std::iterator_traits< OutputIterator >::value_type oType;
+    oType init; memset( &init, 0, sizeof( oType ) );
+    return detail::segmented_reduce_detect_random_access( ctl, first, last, offsets_first, offsets_last, result,
+        init, plus< oType >( ), cl_code, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator>
+OutputIterator segmented_reduce(InputIterator first,
+                                InputIterator last,
+                                OffsetIterator offsets_first,
+                                OffsetIterator offsets_last,
+                                OutputIterator result,
+                                const std::string& cl_code)
+{
+    return segmented_reduce( control::getDefault( ), first, last, offsets_first, offsets_last, result, cl_code );
+}
+
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+         typename BinaryFunction>
+OutputIterator segmented_reduce(control &ctl,
+                                InputIterator first,
+                                InputIterator last,
+                                OffsetIterator offsets_first,
+                                OffsetIterator offsets_last,
+                                OutputIterator result,
+                                T init,
+                                BinaryFunction binary_op,
+                                const std::string& cl_code)
+{
+    typedef std::iterator_traits< OutputIterator >::value_type oType;
+    return detail::segmented_reduce_detect_random_access( ctl, first, last, offsets_first, offsets_last, result,
+        static_cast< oType >( init ), binary_op, cl_code,
+        std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+         typename BinaryFunction>
+OutputIterator segmented_reduce(InputIterator first,
+                                InputIterator last,
+                                OffsetIterator offsets_first,
+                                OffsetIterator offsets_last,
+                                OutputIterator result,
+                                T init,
+                                BinaryFunction binary_op,
+                                const std::string& cl_code)
+{
+    return segmented_reduce( control::getDefault( ), first, last, offsets_first, offsets_last, result, init,
+        binary_op, cl_code );
+}
+
+namespace detail {
+
+enum segmentedReduceTypes { segRed_iType, segRed_iIterType, segRed_sType, segRed_sIterType, segRed_oType,
+                            segRed_oIterType, segRed_BinaryFunction, segRed_end };
+
+class SegmentedReduce_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    SegmentedReduce_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("segmentedReduceTemplate");
+        addKernelName("segmentedReduceLongTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[segRed_iType] + "* input_ptr,\n"
+            + typeNames[segRed_iIterType] + " input_iter,\n"
+            "global " + typeNames[segRed_sType] + "* offsets_ptr,\n"
+            + typeNames[segRed_sIterType] + " offsets_iter,\n"
+            "global " + typeNames[segRed_oType] + "* output_ptr,\n"
+            + typeNames[segRed_oIterType] + " output_iter,\n"
+            "const uint numSegments,\n"
+            "const uint lanesPerSegment,\n"
+            "const uint longThreshold,\n"
+            "global uint* longSegments,\n"
+            "global uint* longCount,\n"
+            "const " + typeNames[segRed_oType] + " init,\n"
+            "global " + typeNames[segRed_BinaryFunction] + "* userFunctor,\n"
+            "local " + typeNames[segRed_oType] + "* scratch\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(1) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(1) + "(\n"
+            "global " + typeNames[segRed_iType] + "* input_ptr,\n"
+            + typeNames[segRed_iIterType] + " input_iter,\n"
+            "global " + typeNames[segRed_sType] + "* offsets_ptr,\n"
+            + typeNames[segRed_sIterType] + " offsets_iter,\n"
+            "global " + typeNames[segRed_oType] + "* output_ptr,\n"
+            + typeNames[segRed_oIterType] + " output_iter,\n"
+            "global uint* longSegments,\n"
+            "global uint* longCount,\n"
+            "const " + typeNames[segRed_oType] + " init,\n"
+            "global " + typeNames[segRed_BinaryFunction] + "* userFunctor,\n"
+            "local " + typeNames[segRed_oType] + "* scratch\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  The smallest power of two that covers the mean segment length, so that a lane rarely loops more than once and
+//  rarely idles; a whole work-group is the most a segment gets.  Segments longer than SEGMENTED_REDUCE_LONG_FACTOR
+//  times that go to the work-group per segment pass, so a few long segments among many short ones do not end up on
+//  a couple of lanes.
+inline cl_uint segmentedReduceLanes( size_t numElements, size_t numSegments )
+{
+    size_t meanLength = ( numElements + numSegments - 1 ) / numSegments;
+    cl_uint lanes = 1;
+    while( lanes < meanLength && lanes < SEGMENTED_REDUCE_WGSIZE )
+        lanes *= 2;
+    return lanes;
+}
+
+template< typename DVInputIterator, typename DVOffsetIterator, typename DVOutputIterator, typename BinaryFunction >
+void segmented_reduce_enqueue( control &ctl,
+                               const DVInputIterator& first, const DVInputIterator& last,
+                               const DVOffsetIterator& offsets_first, const DVOffsetIterator& offsets_last,
+                               const DVOutputIterator& result,
+                               const typename std::iterator_traits< DVOutputIterator >::value_type& init,
+                               const BinaryFunction& binary_op, const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+    typedef typename std::iterator_traits< DVOffsetIterator >::value_type sType;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    cl_uint numElements = static_cast< cl_uint >( first.distance_to( last ) );
+    cl_uint numSegments = static_cast< cl_uint >( offsets_first.distance_to( offsets_last ) - 1 );
+
+    std::vector< std::string > typeNames( segRed_end );
+    typeNames[ segRed_iType ] = TypeName< iType >::get( );
+    typeNames[ segRed_iIterType ] = TypeName< DVInputIterator >::get( );
+    typeNames[ segRed_sType ] = TypeName< sType >::get( );
+    typeNames[ segRed_sIterType ] = TypeName< DVOffsetIterator >::get( );
+    typeNames[ segRed_oType ] = TypeName< oType >::get( );
+    typeNames[ segRed_oIterType ] = TypeName< DVOutputIterator >::get( );
+    typeNames[ segRed_BinaryFunction ] = TypeName< BinaryFunction >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< sType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOffsetIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< oType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOutputIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction >::get( ) )
+
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << SEGMENTED_REDUCE_WGSIZE;
+
+    SegmentedReduce_KernelTemplateSpecializer segRed_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &segRed_kts, typeDefinitions,
+                                                                segmented_reduce_kernels, oss.str( ) );
+
+    cl_uint lanesPerSegment = segmentedReduceLanes( numElements, numSegments );
+    cl_uint longThreshold = SEGMENTED_REDUCE_LONG_FACTOR * lanesPerSegment;
+    size_t segmentsPerGroup = SEGMENTED_REDUCE_WGSIZE / lanesPerSegment;
+
+    //  The work-groups loop over the segments, so never launch more of them than there are segments to cover
+    cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+    size_t maxWG = computeUnits * ctl.getWGPerComputeUnit( );
+    size_t numWG = std::max< size_t >( 1, std::min< size_t >( maxWG,
+        ( numSegments + segmentsPerGroup - 1 ) / segmentsPerGroup ) );
+
+    // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
+    ALIGNED( 256 ) BinaryFunction aligned_binary( binary_op );
+    control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_binary ),
+        CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary );
+
+    //  The long segments are listed on the device, so the host never learns how many there are; the second kernel
+    //  reads the count itself
+    control::buffPointer longSegments = ctl.acquireBuffer( numSegments * sizeof( cl_uint ) );
+    control::buffPointer longCount = ctl.acquireBuffer( sizeof( cl_uint ) );
+
+    ::cl::Event fillEvent;
+    cl_int l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *longCount, 0, 0, sizeof( cl_uint ), NULL,
+        &fillEvent );
+    V_OPENCL( l_Error, "enqueueFillBuffer() failed for the segmented_reduce long segment count" );
+    std::vector< ::cl::Event > fillEvents( 1, fillEvent );
+
+    ::cl::LocalSpaceArg loc;
+    loc.size_ = SEGMENTED_REDUCE_WGSIZE * sizeof( oType );
+
+    V_OPENCL( kernels[ 0 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 2, offsets_first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 3, offsets_first.gpuPayloadSize( ), &offsets_first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 4, result.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 5, result.gpuPayloadSize( ), &result.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 6, numSegments ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 7, lanesPerSegment ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 8, longThreshold ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 9, *longSegments ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 10, *longCount ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 11, init ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 12, *userFunctor ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 13, loc ), "Error setting kernel argument" );
+
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 0 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numWG * SEGMENTED_REDUCE_WGSIZE ),
+        ::cl::NDRange( SEGMENTED_REDUCE_WGSIZE ),
+        &fillEvents );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for segmentedReduce kernel" );
+
+    V_OPENCL( kernels[ 1 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 2, offsets_first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 3, offsets_first.gpuPayloadSize( ), &offsets_first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 4, result.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 5, result.gpuPayloadSize( ), &result.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 6, *longSegments ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 7, *longCount ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 8, init ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 9, *userFunctor ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 1 ].setArg( 10, loc ), "Error setting kernel argument" );
+
+    //  There are at most numElements / ( longThreshold + 1 ) long segments; the work-groups loop over the list
+    size_t longWG = std::max< size_t >( 1, std::min< size_t >( maxWG,
+        std::min< size_t >( numSegments, numElements / ( longThreshold + 1 ) ) ) );
+
+    ::cl::Event reduceEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 1 ],
+        ::cl::NullRange,
+        ::cl::NDRange( longWG * SEGMENTED_REDUCE_WGSIZE ),
+        ::cl::NDRange( SEGMENTED_REDUCE_WGSIZE ),
+        NULL,
+        &reduceEvent );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for segmentedReduceLong kernel" );
+    bolt::cl::wait( ctl, reduceEvent );
+}
+
+//  Serial segmented reduce; segment i covers [offsets[ i ], offsets[ i + 1 ])
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction >
+void serialCPU_segmented_reduce( InputIterator first, OffsetIterator offsets_first, OffsetIterator offsets_last,
+                                 OutputIterator result,
+                                 const typename std::iterator_traits< OutputIterator >::value_type& init,
+                                 const BinaryFunction& binary_op )
+{
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+    size_t numSegments = static_cast< size_t >( std::distance( offsets_first, offsets_last ) ) - 1;
+    for( size_t segment = 0; segment < numSegments; ++segment )
+    {
+        oType acc = init;
+        for( size_t i = static_cast< size_t >( offsets_first[ segment ] ),
+             end = static_cast< size_t >( offsets_first[ segment + 1 ] ); i < end; ++i )
+        {
+            acc = binary_op( acc, first[ i ] );
+        }
+        result[ segment ] = acc;
+    }
+}
+
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction >
+void segmented_reduce_cpu( bolt::cl::control::e_RunMode runMode, InputIterator first,
+                           OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator result,
+                           const typename std::iterator_traits< OutputIterator >::value_type& init,
+                           const BinaryFunction& binary_op )
+{
+    if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        bolt::btbb::segmented_reduce( first, offsets_first, offsets_last, result, init, binary_op );
+#else
+        throw std::exception( "The MultiCoreCpu version of segmented_reduce is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        serialCPU_segmented_reduce( first, offsets_first, offsets_last, result, init, binary_op );
+    }
+}
+
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction >
+OutputIterator segmented_reduce_detect_random_access( control &ctl,
+                                                      const InputIterator& first, const InputIterator& last,
+                                                      const OffsetIterator& offsets_first,
+                                                      const OffsetIterator& offsets_last,
+                                                      const OutputIterator& result,
+                                                      const typename std::iterator_traits<
+                                                          OutputIterator >::value_type& init,
+                                                      const BinaryFunction& binary_op,
+                                                      const std::string& cl_code, std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction >
+OutputIterator segmented_reduce_detect_random_access( control &ctl,
+                                                      const InputIterator& first, const InputIterator& last,
+                                                      const OffsetIterator& offsets_first,
+                                                      const OffsetIterator& offsets_last,
+                                                      const OutputIterator& result,
+                                                      const typename std::iterator_traits<
+                                                          OutputIterator >::value_type& init,
+                                                      const BinaryFunction& binary_op,
+                                                      const std::string& cl_code, bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "Fancy iterators are not supported by segmented reduce" );
+};
+
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction >
+OutputIterator segmented_reduce_detect_random_access( control &ctl,
+                                                      const InputIterator& first, const InputIterator& last,
+                                                      const OffsetIterator& offsets_first,
+                                                      const OffsetIterator& offsets_last,
+                                                      const OutputIterator& result,
+                                                      const typename std::iterator_traits<
+                                                          OutputIterator >::value_type& init,
+                                                      const BinaryFunction& binary_op,
+                                                      const std::string& cl_code, std::random_access_iterator_tag )
+{
+    size_t numOffsets = static_cast< size_t >( std::distance( offsets_first, offsets_last ) );
+    if( numOffsets < 2 )
+        return result;
+
+    segmented_reduce_pick_iterator( ctl, first, last, offsets_first, offsets_last, result, init, binary_op,
+                                    cl_code, std::iterator_traits< InputIterator >::iterator_category( ) );
+    return result + ( numOffsets - 1 );
+};
+
+//Device Vector specialization; the offsets and the output have to live in device_vectors as well.
+template< typename DVInputIterator, typename DVOffsetIterator, typename DVOutputIterator, typename BinaryFunction >
+void segmented_reduce_pick_iterator( control &ctl,
+                                     const DVInputIterator& first, const DVInputIterator& last,
+                                     const DVOffsetIterator& offsets_first, const DVOffsetIterator& offsets_last,
+                                     const DVOutputIterator& result,
+                                     const typename std::iterator_traits< DVOutputIterator >::value_type& init,
+                                     const BinaryFunction& binary_op,
+                                     const std::string& cl_code, bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+    typedef typename std::iterator_traits< DVOffsetIterator >::value_type sType;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    size_t numSegments = static_cast< size_t >( offsets_last - offsets_first ) - 1;
+    if( first == last )
+    {
+        //  Every segment is empty
+        bolt::cl::fill( ctl, result, result + numSegments, init );
+    }
+    else if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< iType >::pointer firstPtr = first.getContainer( ).data( );
+        bolt::cl::device_vector< sType >::pointer offsetsPtr = offsets_first.getContainer( ).data( );
+        bolt::cl::device_vector< oType >::pointer resultPtr = result.getContainer( ).data( );
+
+        segmented_reduce_cpu( runMode, &firstPtr[ first.m_Index ], &offsetsPtr[ offsets_first.m_Index ],
+                              &offsetsPtr[ offsets_last.m_Index ], &resultPtr[ result.m_Index ], init, binary_op );
+    }
+    else
+    {
+        segmented_reduce_enqueue( ctl, first, last, offsets_first, offsets_last, result, init, binary_op, cl_code );
+    }
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in device_vectors and calls the device_vector specialization.
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction >
+void segmented_reduce_pick_iterator( control &ctl,
+                                     const InputIterator& first, const InputIterator& last,
+                                     const OffsetIterator& offsets_first, const OffsetIterator& offsets_last,
+                                     const OutputIterator& result,
+                                     const typename std::iterator_traits< OutputIterator >::value_type& init,
+                                     const BinaryFunction& binary_op,
+                                     const std::string& cl_code, std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type iType;
+    typedef typename std::iterator_traits< OffsetIterator >::value_type sType;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    size_t numSegments = static_cast< size_t >( offsets_last - offsets_first ) - 1;
+    if( first == last )
+    {
+        //  Every segment is empty
+        std::fill( result, result + numSegments, init );
+    }
+    else if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        segmented_reduce_cpu( runMode, first, offsets_first, offsets_last, result, init, binary_op );
+    }
+    else
+    {
+        device_vector< iType > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< sType > dvOffsets( offsets_first, offsets_last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< oType > dvOutput( result, numSegments, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
+        segmented_reduce_enqueue( ctl, dvInput.begin( ), dvInput.end( ), dvOffsets.begin( ), dvOffsets.end( ),
+                                  dvOutput.begin( ), init, binary_op, cl_code );
+        //Map the buffer back to the host
+        dvOutput.data( );
+    }
+}
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
@@ -0,0 +1,846 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SEGMENTED_SCAN_INL )
+#define BOLT_CL_SEGMENTED_SCAN_INL
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/scan.h"
+#include "bolt/cl/scan_by_key.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/segmented_scan.h"
+#endif
+
+#define SEGMENTED_SCAN_WGSIZE 256
+
+namespace bolt {
+namespace cl {
+
+/**********************************************************************************************************************
+ * segmented_inclusive_scan
+ *********************************************************************************************************************/
+template<typename InputIterator, typename FlagIterator, typename OutputIterator>
+OutputIterator segmented_inclusive_scan(control &ctl,
+                                        InputIterator first,
+                                        InputIterator last,
+                                        FlagIterator flags,
+                                        OutputIterator result,
+                                        const std::string& cl_code)
+{
+    typedef std::iterator_traits< OutputIterator >::value_type oType;
+    oType init; memset( &init, 0, sizeof( oType ) );
+    return detail::segmented_scan_detect_random_access( ctl, first, last, flags, result, init, plus< oType >( ),
+        cl_code, true, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename FlagIterator, typename OutputIterator>
+OutputIterator segmented_inclusive_scan(InputIterator first,
+                                        InputIterator last,
+                                        FlagIterator flags,
+                                        OutputIterator result,
+                                        const std::string& cl_code)
+{
+    return segmented_inclusive_scan( control::getDefault( ), first, last, flags, result, cl_code );
+}
+
+template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename BinaryFunction>
+OutputIterator segmented_inclusive_scan(control &ctl,
+                                        InputIterator first,
+                                        InputIterator last,
+                                        FlagIterator flags,
+                                        OutputIterator result,
+                                        BinaryFunction binary_op,
+                                        const std::string& cl_code)
+{
+    typedef std::iterator_traits< OutputIterator >::value_type oType;
+    oType init; memset( &init, 0, sizeof( oType ) );
+    return detail::segmented_scan_detect_random_access( ctl, first, last, flags, result, init, binary_op,
+        cl_code, true, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename BinaryFunction>
+OutputIterator segmented_inclusive_scan(InputIterator first,
+                                        InputIterator last,
+                                        FlagIterator flags,
+                                        OutputIterator result,
+                                        BinaryFunction binary_op,
+                                        const std::string& cl_code)
+{
+    return segmented_inclusive_scan( control::getDefault( ), first, last, flags, result, binary_op, cl_code );
+}
+
+/**********************************************************************************************************************
+ * segmented_exclusive_scan
+ *********************************************************************************************************************/
+template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T>
+OutputIterator segmented_exclusive_scan(control &ctl,
+                                        InputIterator first,
+                                        InputIterator last,
+                                        FlagIterator flags,
+                                        OutputIterator result,
+                                        T init,
+                                        const std::string& cl_code)
+{
+    typedef std::iterator_traits< OutputIterator >::value_type oType;
+    return detail::segmented_scan_detect_random_access( ctl, first, last, flags, result, init, plus< oType >( ),
+        cl_code, false, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T>
+OutputIterator segmented_exclusive_scan(InputIterator first,
+                                        InputIterator last,
+                                        FlagIterator flags,
+                                        OutputIterator result,
+                                        T init,
+                                        const std::string& cl_code)
+{
+    return segmented_exclusive_scan( control::getDefault( ), first, last, flags, result, init, cl_code );
+}
+
+template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+         typename BinaryFunction>
+OutputIterator segmented_exclusive_scan(control &ctl,
+                                        InputIterator first,
+                                        InputIterator last,
+                                        FlagIterator flags,
+                                        OutputIterator result,
+                                        T init,
+                                        BinaryFunction binary_op,
+                                        const std::string& cl_code)
+{
+    return detail::segmented_scan_detect_random_access( ctl, first, last, flags, result, init, binary_op,
+        cl_code, false, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+         typename BinaryFunction>
+OutputIterator segmented_exclusive_scan(InputIterator first,
+                                        InputIterator last,
+                                        FlagIterator flags,
+                                        OutputIterator result,
+                                        T init,
+                                        BinaryFunction binary_op,
+                                        const std::string& cl_code)
+{
+    return segmented_exclusive_scan( control::getDefault( ), first, last, flags, result, init, binary_op,
+        cl_code );
+}
+
+/**********************************************************************************************************************
+ * segmented_inclusive_scan_by_offsets
+ *********************************************************************************************************************/
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator>
+OutputIterator segmented_inclusive_scan_by_offsets(control &ctl,
+                                                   InputIterator first,
+                                                   InputIterator last,
+                                                   OffsetIterator offsets_first,
+                                                   OffsetIterator offsets_last,
+                                                   OutputIterator result,
+                                                   const std::string& cl_code)
+{
+    typedef std::iterator_traits< OutputIterator >::value_type oType;
+    oType init; memset( &init, 0, sizeof( oType ) );
+    return detail::segmented_scan_by_offsets_detect_random_access( ctl, first, last, offsets_first, offsets_last,
+        result, init, plus< oType >( ), cl_code, true, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator>
+OutputIterator segmented_inclusive_scan_by_offsets(InputIterator first,
+                                                   InputIterator last,
+                                                   OffsetIterator offsets_first,
+                                                   OffsetIterator offsets_last,
+                                                   OutputIterator result,
+                                                   const std::string& cl_code)
+{
+    return segmented_inclusive_scan_by_offsets( control::getDefault( ), first, last, offsets_first, offsets_last,
+        result, cl_code );
+}
+
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction>
+OutputIterator segmented_inclusive_scan_by_offsets(control &ctl,
+                                                   InputIterator first,
+                                                   InputIterator last,
+                                                   OffsetIterator offsets_first,
+                                                   OffsetIterator offsets_last,
+                                                   OutputIterator result,
+                                                   BinaryFunction binary_op,
+                                                   const std::string& cl_code)
+{
+    typedef std::iterator_traits< OutputIterator >::value_type oType;
+    oType init; memset( &init, 0, sizeof( oType ) );
+    return detail::segmented_scan_by_offsets_detect_random_access( ctl, first, last, offsets_first, offsets_last,
+        result, init, binary_op, cl_code, true, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction>
+OutputIterator segmented_inclusive_scan_by_offsets(InputIterator first,
+                                                   InputIterator last,
+                                                   OffsetIterator offsets_first,
+                                                   OffsetIterator offsets_last,
+                                                   OutputIterator result,
+                                                   BinaryFunction binary_op,
+                                                   const std::string& cl_code)
+{
+    return segmented_inclusive_scan_by_offsets( control::getDefault( ), first, last, offsets_first, offsets_last,
+        result, binary_op, cl_code );
+}
+
+/**********************************************************************************************************************
+ * segmented_exclusive_scan_by_offsets
+ *********************************************************************************************************************/
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T>
+OutputIterator segmented_exclusive_scan_by_offsets(control &ctl,
+                                                   InputIterator first,
+                                                   InputIterator last,
+                                                   OffsetIterator offsets_first,
+                                                   OffsetIterator offsets_last,
+                                                   OutputIterator result,
+                                                   T init,
+                                                   const std::string& cl_code)
+{
+    typedef std::iterator_traits< OutputIterator >::value_type oType;
+    return detail::segmented_scan_by_offsets_detect_random_access( ctl, first, last, offsets_first, offsets_last,
+        result, init, plus< oType >( ), cl_code, false, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T>
+OutputIterator segmented_exclusive_scan_by_offsets(InputIterator first,
+                                                   InputIterator last,
+                                                   OffsetIterator offsets_first,
+                                                   OffsetIterator offsets_last,
+                                                   OutputIterator result,
+                                                   T init,
+                                                   const std::string& cl_code)
+{
+    return segmented_exclusive_scan_by_offsets( control::getDefault( ), first, last, offsets_first, offsets_last,
+        result, init, cl_code );
+}
+
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+         typename BinaryFunction>
+OutputIterator segmented_exclusive_scan_by_offsets(control &ctl,
+                                                   InputIterator first,
+                                                   InputIterator last,
+                                                   OffsetIterator offsets_first,
+                                                   OffsetIterator offsets_last,
+                                                   OutputIterator result,
+                                                   T init,
+                                                   BinaryFunction binary_op,
+                                                   const std::string& cl_code)
+{
+    return detail::segmented_scan_by_offsets_detect_random_access( ctl, first, last, offsets_first, offsets_last,
+        result, init, binary_op, cl_code, false, std::iterator_traits< InputIterator >::iterator_category( ) );
+}
+
+template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+         typename BinaryFunction>
+OutputIterator segmented_exclusive_scan_by_offsets(InputIterator first,
+                                                   InputIterator last,
+                                                   OffsetIterator offsets_first,
+                                                   OffsetIterator offsets_last,
+                                                   OutputIterator result,
+                                                   T init,
+                                                   BinaryFunction binary_op,
+                                                   const std::string& cl_code)
+{
+    return segmented_exclusive_scan_by_offsets( control::getDefault( ), first, last, offsets_first, offsets_last,
+        result, init, binary_op, cl_code );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+namespace bolt {
+namespace cl {
+namespace detail {
+
+enum segmentedScanTypes { segScan_fType, segScan_fIterType, segScan_vType, segScan_iIterType,
+                          segScan_oType, segScan_oIterType, segScan_initType, segScan_BinaryFunction,
+                          segScan_end };
+
+enum segmentedScanHeadTypes { segScanHeads_sType, segScanHeads_sIterType, segScanHeads_end };
+
+class SegmentedScan_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    SegmentedScan_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("singlePassSegmentedScanTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[segScan_fType] + "* flags,\n"
+            + typeNames[segScan_fIterType] + " flags_iter,\n"
+            "global " + typeNames[segScan_vType] + "* vals,\n"
+            + typeNames[segScan_iIterType] + " vals_iter,\n"
+            "global " + typeNames[segScan_oType] + "* output,\n"
+            + typeNames[segScan_oIterType] + " output_iter,\n"
+            + typeNames[segScan_initType] + " init,\n"
+            "const uint vecSize,\n"
+            "local uint* ldsHeads,\n"
+            "local " + typeNames[segScan_oType] + "* ldsVals,\n"
+            "global " + typeNames[segScan_BinaryFunction] + "* binaryFunct,\n"
+            "global uint* tileStatus,\n"
+            "global uint* tileValues,\n"
+            "int exclusive\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+class SegmentedScanHeads_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    SegmentedScanHeads_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("segmentedScanHeadsFromOffsetsTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[segScanHeads_sType] + "* offsets_ptr,\n"
+            + typeNames[segScanHeads_sIterType] + " offsets_iter,\n"
+            "const uint numOffsets,\n"
+            "const uint vecSize,\n"
+            "global uint* flags\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  Compile options shared by both kernel families; the file holds both, so both macros have to be defined
+inline std::string segmentedScanCompileOptions( cl_uint itemsPerWorkItem )
+{
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << SEGMENTED_SCAN_WGSIZE;
+    oss << " -DSCAN_ITEMS_PER_WORKITEM=" << itemsPerWorkItem;
+    return oss.str( );
+}
+
+//  All device segmented scans end up here.  Devices that can chain tiles run the single-pass kernel; the others
+//  number the segments with a scan of the flags and hand them to scan_by_key as keys.
+template< typename DVInputIterator, typename DVFlagIterator, typename DVOutputIterator, typename T,
+          typename BinaryFunction >
+void segmented_scan_enqueue( control &ctl,
+                             const DVInputIterator& first, const DVInputIterator& last,
+                             const DVFlagIterator& flags, const DVOutputIterator& result,
+                             const T& init, const BinaryFunction& binary_op, const std::string& cl_code,
+                             bool inclusive )
+{
+    typedef typename std::iterator_traits< DVFlagIterator >::value_type fType;
+    typedef typename std::iterator_traits< DVInputIterator >::value_type vType;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    cl_int l_Error = CL_SUCCESS;
+    cl_uint numElements = static_cast< cl_uint >( first.distance_to( last ) );
+
+    if( !supportsSinglePassScan( ctl ) )
+    {
+        device_vector< cl_uint > dvSegments( numElements, 0, CL_MEM_READ_WRITE, false, ctl );
+        bolt::cl::inclusive_scan( ctl, flags, flags + numElements, dvSegments.begin( ), plus< cl_uint >( ) );
+        if( inclusive )
+            bolt::cl::inclusive_scan_by_key( ctl, dvSegments.begin( ), dvSegments.end( ), first, result,
+                equal_to< cl_uint >( ), binary_op, cl_code );
+        else
+            bolt::cl::exclusive_scan_by_key( ctl, dvSegments.begin( ), dvSegments.end( ), first, result,
+                init, equal_to< cl_uint >( ), binary_op, cl_code );
+        return;
+    }
+
+    std::vector< std::string > typeNames( segScan_end );
+    typeNames[ segScan_fType ] = TypeName< fType >::get( );
+    typeNames[ segScan_fIterType ] = TypeName< DVFlagIterator >::get( );
+    typeNames[ segScan_vType ] = TypeName< vType >::get( );
+    typeNames[ segScan_iIterType ] = TypeName< DVInputIterator >::get( );
+    typeNames[ segScan_oType ] = TypeName< oType >::get( );
+    typeNames[ segScan_oIterType ] = TypeName< DVOutputIterator >::get( );
+    typeNames[ segScan_initType ] = TypeName< T >::get( );
+    typeNames[ segScan_BinaryFunction ] = TypeName< BinaryFunction >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< fType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVFlagIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< vType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< oType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOutputIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< T >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction >::get( ) )
+
+    const cl_uint itemsPerWorkItem = singlePassScanItemsPerWorkItem( ctl, sizeof( oType ) + sizeof( cl_uint ),
+        SEGMENTED_SCAN_WGSIZE );
+
+    SegmentedScan_KernelTemplateSpecializer segScan_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &segScan_kts, typeDefinitions,
+                                                                lookback_kernels + segmented_scan_kernels,
+                                                                segmentedScanCompileOptions( itemsPerWorkItem ) );
+
+    //  The tiles chain their prefixes through a decoupled look-back, so the flags and values are read once and the
+    //  output written once
+    const size_t tileSize = SEGMENTED_SCAN_WGSIZE * itemsPerWorkItem;
+    cl_uint numTiles = static_cast< cl_uint >( ( numElements + tileSize - 1 ) / tileSize );
+    size_t tileWords = ( sizeof( oType ) + sizeof( cl_uint ) - 1 ) / sizeof( cl_uint );
+
+    control::buffPointer tileStatus = ctl.acquireBuffer( ( numTiles + 1 ) * sizeof( cl_uint ) );
+    control::buffPointer tileValues = ctl.acquireBuffer( 2 * numTiles * tileWords * sizeof( cl_uint ) );
+    ::cl::Event fillEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *tileStatus, 0, 0, ( numTiles + 1 ) * sizeof( cl_uint ),
+        NULL, &fillEvent );
+    V_OPENCL( l_Error, "enqueueFillBuffer() failed for the segmented scan tile status" );
+
+    ALIGNED( 256 ) BinaryFunction aligned_binary_op( binary_op );
+    control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_binary_op ),
+                                                          CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_op );
+
+    cl_int doExclusiveScan = inclusive ? 0 : 1;
+    cl_uint arg = 0;
+    V_OPENCL( kernels[ 0 ].setArg( arg++, flags.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, flags.gpuPayloadSize( ), &flags.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, result.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, result.gpuPayloadSize( ), &result.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, init ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, numElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, tileSize * sizeof( cl_uint ), NULL ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, tileSize * sizeof( oType ), NULL ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, *userFunctor ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, *tileStatus ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, *tileValues ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( arg++, doExclusiveScan ), "Error setting kernel argument" );
+
+    std::vector< ::cl::Event > fillEvents( 1, fillEvent );
+    ::cl::Event scanEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 0 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numTiles * SEGMENTED_SCAN_WGSIZE ),
+        ::cl::NDRange( SEGMENTED_SCAN_WGSIZE ),
+        &fillEvents,
+        &scanEvent );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for singlePassSegmentedScan kernel" );
+    bolt::cl::wait( ctl, scanEvent );
+}
+
+//  Turns segment offsets into head flags on the device; dvFlags has to hold numElements zeros
+template< typename DVOffsetIterator >
+void segmented_scan_heads_enqueue( control &ctl,
+                                   const DVOffsetIterator& offsets_first, const DVOffsetIterator& offsets_last,
+                                   cl_uint numElements, device_vector< cl_uint >& dvFlags )
+{
+    typedef typename std::iterator_traits< DVOffsetIterator >::value_type sType;
+
+    cl_uint numOffsets = static_cast< cl_uint >( offsets_first.distance_to( offsets_last ) );
+    if( numOffsets == 0 )
+        return;
+
+    std::vector< std::string > typeNames( segScanHeads_end );
+    typeNames[ segScanHeads_sType ] = TypeName< sType >::get( );
+    typeNames[ segScanHeads_sIterType ] = TypeName< DVOffsetIterator >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< sType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVOffsetIterator >::get( ) )
+
+    SegmentedScanHeads_KernelTemplateSpecializer heads_kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &heads_kts, typeDefinitions,
+                                                                lookback_kernels + segmented_scan_kernels,
+                                                                segmentedScanCompileOptions( 1 ) );
+
+    V_OPENCL( kernels[ 0 ].setArg( 0, offsets_first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 1, offsets_first.gpuPayloadSize( ), &offsets_first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 2, numOffsets ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 3, numElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 4, dvFlags.getBuffer( ) ), "Error setting kernel argument" );
+
+    size_t numWorkGroups = ( numOffsets + SEGMENTED_SCAN_WGSIZE - 1 ) / SEGMENTED_SCAN_WGSIZE;
+    ::cl::Event headsEvent;
+    cl_int l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 0 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numWorkGroups * SEGMENTED_SCAN_WGSIZE ),
+        ::cl::NDRange( SEGMENTED_SCAN_WGSIZE ),
+        NULL,
+        &headsEvent );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for segmentedScanHeadsFromOffsets kernel" );
+    bolt::cl::wait( ctl, headsEvent );
+}
+
+//  Serial segmented scan; the values are read before the output is written, so the scan may run in place
+template< typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+void serialCPU_segmented_scan( InputIterator first, InputIterator last, FlagIterator flags,
+                               OutputIterator result, const T& init, const BinaryFunction& binary_op,
+                               bool inclusive )
+{
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+    size_t numElements = static_cast< size_t >( std::distance( first, last ) );
+    oType sum;
+    for( size_t i = 0; i < numElements; ++i )
+    {
+        bool head = ( i == 0 ) || ( flags[ i ] != 0 );
+        oType value = first[ i ];
+        if( inclusive )
+        {
+            sum = head ? value : binary_op( sum, value );
+            result[ i ] = sum;
+        }
+        else
+        {
+            if( head )
+                sum = static_cast< oType >( init );
+            result[ i ] = sum;
+            sum = binary_op( sum, value );
+        }
+    }
+}
+
+//  Marks the first element of every segment given by its offset; offsets outside of the input are ignored
+template< typename OffsetIterator >
+void serialCPU_segmented_scan_heads( OffsetIterator offsets_first, OffsetIterator offsets_last,
+                                     std::vector< cl_uint >& heads )
+{
+    for( ; offsets_first != offsets_last; ++offsets_first )
+    {
+        size_t offset = static_cast< size_t >( *offsets_first );
+        if( offset < heads.size( ) )
+            heads[ offset ] = 1;
+    }
+}
+
+template< typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+void segmented_scan_cpu( bolt::cl::control::e_RunMode runMode,
+                         InputIterator first, InputIterator last, FlagIterator flags,
+                         OutputIterator result, const T& init, const BinaryFunction& binary_op, bool inclusive )
+{
+    if( runMode == bolt::cl::control::SerialCpu )
+    {
+        serialCPU_segmented_scan( first, last, flags, result, init, binary_op, inclusive );
+    }
+    else
+    {
+#ifdef ENABLE_TBB
+        if( inclusive )
+            bolt::btbb::segmented_inclusive_scan( first, last, flags, result, binary_op );
+        else
+            bolt::btbb::segmented_exclusive_scan( first, last, flags, result, init, binary_op );
+#else
+        throw std::exception( "The MultiCoreCpu version of segmented scan is not enabled to be built! \n" );
+#endif
+    }
+}
+
+template< typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+OutputIterator segmented_scan_detect_random_access( control &ctl,
+                                                    const InputIterator& first, const InputIterator& last,
+                                                    const FlagIterator& flags, const OutputIterator& result,
+                                                    const T& init, const BinaryFunction& binary_op,
+                                                    const std::string& cl_code, bool inclusive,
+                                                    std::input_iterator_tag )
+{
+    //  \TODO:  It should be possible to support non-random_access_iterator_tag iterators, if we copied the data
+    //  to a temporary buffer.  Should we?
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+OutputIterator segmented_scan_detect_random_access( control &ctl,
+                                                    const InputIterator& first, const InputIterator& last,
+                                                    const FlagIterator& flags, const OutputIterator& result,
+                                                    const T& init, const BinaryFunction& binary_op,
+                                                    const std::string& cl_code, bool inclusive,
+                                                    bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "Fancy iterators are not supported by segmented scan" );
+};
+
+template< typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+OutputIterator segmented_scan_detect_random_access( control &ctl,
+                                                    const InputIterator& first, const InputIterator& last,
+                                                    const FlagIterator& flags, const OutputIterator& result,
+                                                    const T& init, const BinaryFunction& binary_op,
+                                                    const std::string& cl_code, bool inclusive,
+                                                    std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type vType;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+    static_assert( std::is_convertible< vType, oType >::value, "Input and Output iterators are incompatible" );
+
+    size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+    if( szElements == 0 )
+        return result;
+
+    segmented_scan_pick_iterator( ctl, first, last, flags, result, init, binary_op, cl_code, inclusive,
+                                  std::iterator_traits< InputIterator >::iterator_category( ) );
+    return result + szElements;
+};
+
+//Device Vector specialization; the flags and the output have to live in device_vectors as well
+template< typename DVInputIterator, typename DVFlagIterator, typename DVOutputIterator, typename T,
+          typename BinaryFunction >
+void segmented_scan_pick_iterator( control &ctl,
+                                   const DVInputIterator& first, const DVInputIterator& last,
+                                   const DVFlagIterator& flags, const DVOutputIterator& result,
+                                   const T& init, const BinaryFunction& binary_op,
+                                   const std::string& cl_code, bool inclusive,
+                                   bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type vType;
+    typedef typename std::iterator_traits< DVFlagIterator >::value_type fType;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        size_t szElements = static_cast< size_t >( last - first );
+        bolt::cl::device_vector< vType >::pointer firstPtr = first.getContainer( ).data( );
+        bolt::cl::device_vector< fType >::pointer flagsPtr = flags.getContainer( ).data( );
+        bolt::cl::device_vector< oType >::pointer resultPtr = result.getContainer( ).data( );
+        segmented_scan_cpu( runMode, &firstPtr[ first.m_Index ], &firstPtr[ first.m_Index ] + szElements,
+                            &flagsPtr[ flags.m_Index ], &resultPtr[ result.m_Index ], init, binary_op, inclusive );
+    }
+    else
+    {
+        segmented_scan_enqueue( ctl, first, last, flags, result, init, binary_op, cl_code, inclusive );
+    }
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in device_vectors and calls the device_vector specialization.
+template< typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+void segmented_scan_pick_iterator( control &ctl,
+                                   const InputIterator& first, const InputIterator& last,
+                                   const FlagIterator& flags, const OutputIterator& result,
+                                   const T& init, const BinaryFunction& binary_op,
+                                   const std::string& cl_code, bool inclusive,
+                                   std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type vType;
+    typedef typename std::iterator_traits< FlagIterator >::value_type fType;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        segmented_scan_cpu( runMode, first, last, flags, result, init, binary_op, inclusive );
+    }
+    else
+    {
+        size_t szElements = static_cast< size_t >( last - first );
+        device_vector< vType > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< fType > dvFlags( flags, szElements, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, true, ctl );
+        device_vector< oType > dvOutput( result, szElements, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
+        segmented_scan_enqueue( ctl, dvInput.begin( ), dvInput.end( ), dvFlags.begin( ), dvOutput.begin( ),
+                                init, binary_op, cl_code, inclusive );
+        //Map the buffer back to the host
+        dvOutput.data( );
+    }
+}
+
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+OutputIterator segmented_scan_by_offsets_detect_random_access( control &ctl,
+                                                               const InputIterator& first, const InputIterator& last,
+                                                               const OffsetIterator& offsets_first,
+                                                               const OffsetIterator& offsets_last,
+                                                               const OutputIterator& result,
+                                                               const T& init, const BinaryFunction& binary_op,
+                                                               const std::string& cl_code, bool inclusive,
+                                                               std::input_iterator_tag )
+{
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+OutputIterator segmented_scan_by_offsets_detect_random_access( control &ctl,
+                                                               const InputIterator& first, const InputIterator& last,
+                                                               const OffsetIterator& offsets_first,
+                                                               const OffsetIterator& offsets_last,
+                                                               const OutputIterator& result,
+                                                               const T& init, const BinaryFunction& binary_op,
+                                                               const std::string& cl_code, bool inclusive,
+                                                               bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "Fancy iterators are not supported by segmented scan" );
+};
+
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+OutputIterator segmented_scan_by_offsets_detect_random_access( control &ctl,
+                                                               const InputIterator& first, const InputIterator& last,
+                                                               const OffsetIterator& offsets_first,
+                                                               const OffsetIterator& offsets_last,
+                                                               const OutputIterator& result,
+                                                               const T& init, const BinaryFunction& binary_op,
+                                                               const std::string& cl_code, bool inclusive,
+                                                               std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type vType;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+    static_assert( std::is_convertible< vType, oType >::value, "Input and Output iterators are incompatible" );
+
+    size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+    if( szElements == 0 )
+        return result;
+
+    segmented_scan_by_offsets_pick_iterator( ctl, first, last, offsets_first, offsets_last, result, init,
+                                             binary_op, cl_code, inclusive,
+                                             std::iterator_traits< InputIterator >::iterator_category( ) );
+    return result + szElements;
+};
+
+//Device Vector specialization; the offsets and the output have to live in device_vectors as well.  The offsets
+//are scattered into head flags, which is one write per segment rather than a key comparison per element.
+template< typename DVInputIterator, typename DVOffsetIterator, typename DVOutputIterator, typename T,
+          typename BinaryFunction >
+void segmented_scan_by_offsets_pick_iterator( control &ctl,
+                                              const DVInputIterator& first, const DVInputIterator& last,
+                                              const DVOffsetIterator& offsets_first,
+                                              const DVOffsetIterator& offsets_last,
+                                              const DVOutputIterator& result,
+                                              const T& init, const BinaryFunction& binary_op,
+                                              const std::string& cl_code, bool inclusive,
+                                              bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVInputIterator >::value_type vType;
+    typedef typename std::iterator_traits< DVOffsetIterator >::value_type sType;
+    typedef typename std::iterator_traits< DVOutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    size_t szElements = static_cast< size_t >( last - first );
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< vType >::pointer firstPtr = first.getContainer( ).data( );
+        bolt::cl::device_vector< sType >::pointer offsetsPtr = offsets_first.getContainer( ).data( );
+        bolt::cl::device_vector< oType >::pointer resultPtr = result.getContainer( ).data( );
+
+        std::vector< cl_uint > heads( szElements, 0 );
+        serialCPU_segmented_scan_heads( &offsetsPtr[ offsets_first.m_Index ], &offsetsPtr[ offsets_last.m_Index ],
+                                        heads );
+        segmented_scan_cpu( runMode, &firstPtr[ first.m_Index ], &firstPtr[ first.m_Index ] + szElements,
+                            heads.begin( ), &resultPtr[ result.m_Index ], init, binary_op, inclusive );
+    }
+    else
+    {
+        device_vector< cl_uint > dvFlags( szElements, 0, CL_MEM_READ_WRITE, false, ctl );
+        segmented_scan_heads_enqueue( ctl, offsets_first, offsets_last, static_cast< cl_uint >( szElements ),
+                                      dvFlags );
+        segmented_scan_enqueue( ctl, first, last, dvFlags.begin( ), result, init, binary_op, cl_code, inclusive );
+    }
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in device_vectors and calls the device_vector specialization.
+template< typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+          typename BinaryFunction >
+void segmented_scan_by_offsets_pick_iterator( control &ctl,
+                                              const InputIterator& first, const InputIterator& last,
+                                              const OffsetIterator& offsets_first,
+                                              const OffsetIterator& offsets_last,
+                                              const OutputIterator& result,
+                                              const T& init, const BinaryFunction& binary_op,
+                                              const std::string& cl_code, bool inclusive,
+                                              std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< InputIterator >::value_type vType;
+    typedef typename std::iterator_traits< OffsetIterator >::value_type sType;
+    typedef typename std::iterator_traits< OutputIterator >::value_type oType;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    size_t szElements = static_cast< size_t >( last - first );
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        std::vector< cl_uint > heads( szElements, 0 );
+        serialCPU_segmented_scan_heads( offsets_first, offsets_last, heads );
+        segmented_scan_cpu( runMode, first, last, heads.begin( ), result, init, binary_op, inclusive );
+    }
+    else
+    {
+        device_vector< vType > dvInput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+        device_vector< oType > dvOutput( result, szElements, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, false, ctl );
+        device_vector< cl_uint > dvFlags( szElements, 0, CL_MEM_READ_WRITE, false, ctl );
+        if( offsets_first != offsets_last )
+        {
+            device_vector< sType > dvOffsets( offsets_first, offsets_last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY,
+                                              ctl );
+            segmented_scan_heads_enqueue( ctl, dvOffsets.begin( ), dvOffsets.end( ),
+                                          static_cast< cl_uint >( szElements ), dvFlags );
+        }
+        segmented_scan_enqueue( ctl, dvInput.begin( ), dvInput.end( ), dvFlags.begin( ), dvOutput.begin( ),
+                                init, binary_op, cl_code, inclusive );
+        //Map the buffer back to the host
+        dvOutput.data( );
+    }
+}
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
@@ -0,0 +1,399 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SORT_BY_EXTRACTED_KEY_INL )
+#define BOLT_CL_SORT_BY_EXTRACTED_KEY_INL
+#pragma once
+
+#include <algorithm>
+#include <sstream>
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/scan.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/stablesort.h"
+#endif
+
+#define EXTRACTED_KEY_RADIX 4
+#define EXTRACTED_KEY_RADICES ( 1 << EXTRACTED_KEY_RADIX )
+#define EXTRACTED_KEY_WGSIZE 256
+
+namespace bolt {
+namespace cl {
+
+template<typename RandomAccessIterator, typename KeyFunctor>
+void sort_by_extracted_key(RandomAccessIterator first,
+                           RandomAccessIterator last,
+                           KeyFunctor key_functor,
+                           const std::string& cl_code)
+{
+    detail::sort_by_extracted_key_detect_random_access( control::getDefault( ), first, last, key_functor, cl_code,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+template<typename RandomAccessIterator, typename KeyFunctor>
+void sort_by_extracted_key(control &ctl,
+                           RandomAccessIterator first,
+                           RandomAccessIterator last,
+                           KeyFunctor key_functor,
+                           const std::string& cl_code)
+{
+    detail::sort_by_extracted_key_detect_random_access( ctl, first, last, key_functor, cl_code,
+        std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+}
+
+}//namespace bolt::cl
+}//namespace bolt
+
+namespace bolt {
+namespace cl {
+namespace detail {
+
+enum extractedKeyTypes { extractedKey_iType, extractedKey_iIterType, extractedKey_KeyFunctor, extractedKey_end };
+
+class SortByExtractedKey_KernelTemplateSpecializer : public KernelTemplateSpecializer
+{
+public:
+    SortByExtractedKey_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+    {
+        addKernelName("extractKeyTemplate");
+        addKernelName("extractedKeyHistogramTemplate");
+        addKernelName("extractedKeyPermuteTemplate");
+        addKernelName("extractedKeyGatherTemplate");
+    }
+
+    const ::std::string operator() ( const ::std::vector< ::std::string >& typeNames ) const
+    {
+        std::stringstream radixStream;
+        radixStream << EXTRACTED_KEY_RADIX;
+
+        const std::string templateSpecializationString =
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(0) + "(\n"
+            "global " + typeNames[extractedKey_iType] + "* input_ptr,\n"
+            + typeNames[extractedKey_iIterType] + " input_iter,\n"
+            "const uint length,\n"
+            "const uint paddedLength,\n"
+            "global " + typeNames[extractedKey_KeyFunctor] + "* userFunctor,\n"
+            "global uint* keys,\n"
+            "global uint* indices\n"
+            ");\n\n"
+
+            "template __attribute__((mangled_name(" + name(1) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(1) + "< " + radixStream.str() + " >(\n"
+            "global uint* keys,\n"
+            "global uint* buckets,\n"
+            "uint shiftCount\n"
+            ");\n\n"
+
+            "template __attribute__((mangled_name(" + name(2) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(2) + "< " + radixStream.str() + " >(\n"
+            "global uint* keys,\n"
+            "global uint* indices,\n"
+            "global uint* scannedBuckets,\n"
+            "uint shiftCount,\n"
+            "global uint* sortedKeys,\n"
+            "global uint* sortedIndices\n"
+            ");\n\n"
+
+            "// Host generates this instantiation string with user-specified value type and functor\n"
+            "template __attribute__((mangled_name(" + name(3) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "kernel void " + name(3) + "(\n"
+            "global " + typeNames[extractedKey_iType] + "* input_ptr,\n"
+            + typeNames[extractedKey_iIterType] + " input_iter,\n"
+            "const uint length,\n"
+            "global uint* indices,\n"
+            "global " + typeNames[extractedKey_iType] + "* output\n"
+            ");\n\n";
+
+        return templateSpecializationString;
+    }
+};
+
+//  Orders two records by the keys the user functor extracts from them; used by the CPU paths
+template< typename KeyFunctor >
+struct extracted_key_less
+{
+    extracted_key_less( const KeyFunctor& _keyFunctor ) : keyFunctor( _keyFunctor ) { }
+
+    template< typename T >
+    bool operator( )( const T& lhs, const T& rhs ) const
+    {
+        return keyFunctor( lhs ) < keyFunctor( rhs );
+    }
+
+    KeyFunctor keyFunctor;
+};
+
+template< typename DVRandomAccessIterator, typename KeyFunctor >
+void sort_by_extracted_key_enqueue( control &ctl,
+                                    const DVRandomAccessIterator& first, const DVRandomAccessIterator& last,
+                                    const KeyFunctor& key_functor, const std::string& cl_code )
+{
+    typedef typename std::iterator_traits< DVRandomAccessIterator >::value_type iType;
+
+    cl_int l_Error = CL_SUCCESS;
+    cl_uint szElements = static_cast< cl_uint >( first.distance_to( last ) );
+
+    std::vector< std::string > typeNames( extractedKey_end );
+    typeNames[ extractedKey_iType ] = TypeName< iType >::get( );
+    typeNames[ extractedKey_iIterType ] = TypeName< DVRandomAccessIterator >::get( );
+    typeNames[ extractedKey_KeyFunctor ] = TypeName< KeyFunctor >::get( );
+
+    std::vector< std::string > typeDefinitions;
+    PUSH_BACK_UNIQUE( typeDefinitions, cl_code )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVRandomAccessIterator >::get( ) )
+    PUSH_BACK_UNIQUE( typeDefinitions, ClCode< KeyFunctor >::get( ) )
+
+    std::ostringstream oss;
+    oss << " -DKERNEL0WORKGROUPSIZE=" << EXTRACTED_KEY_WGSIZE;
+
+    SortByExtractedKey_KernelTemplateSpecializer kts;
+    std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels( ctl, typeNames, &kts, typeDefinitions,
+                                                                sort_by_extracted_key_kernels, oss.str( ) );
+
+    //  Every work-item of the radix passes owns EXTRACTED_KEY_RADICES consecutive keys, so the key buffers are
+    //  padded to whole work-groups of those
+    const cl_uint elementsPerGroup = EXTRACTED_KEY_WGSIZE * EXTRACTED_KEY_RADICES;
+    cl_uint paddedElements = ( ( szElements + elementsPerGroup - 1 ) / elementsPerGroup ) * elementsPerGroup;
+    size_t radixWorkItems = paddedElements / EXTRACTED_KEY_RADICES;
+
+    cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+    size_t numWG = computeUnits * ctl.getWGPerComputeUnit( );
+    size_t neededWG = ( paddedElements + EXTRACTED_KEY_WGSIZE - 1 ) / EXTRACTED_KEY_WGSIZE;
+    numWG = std::min( numWG, neededWG );
+
+    device_vector< cl_uint > dvKeys( paddedElements, 0, CL_MEM_READ_WRITE, false, ctl );
+    device_vector< cl_uint > dvIndices( paddedElements, 0, CL_MEM_READ_WRITE, false, ctl );
+    device_vector< cl_uint > dvSwapKeys( paddedElements, 0, CL_MEM_READ_WRITE, false, ctl );
+    device_vector< cl_uint > dvSwapIndices( paddedElements, 0, CL_MEM_READ_WRITE, false, ctl );
+    device_vector< cl_uint > dvHistogram( radixWorkItems * EXTRACTED_KEY_RADICES, 0, CL_MEM_READ_WRITE, false,
+                                          ctl );
+    device_vector< cl_uint > dvScannedHistogram( radixWorkItems * EXTRACTED_KEY_RADICES, 0, CL_MEM_READ_WRITE,
+                                                 false, ctl );
+
+    ALIGNED( 256 ) KeyFunctor aligned_functor( key_functor );
+    control::buffPointer userFunctor = ctl.acquireBuffer( sizeof( aligned_functor ),
+                                                          CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_functor );
+
+    //  Extract the keys once; the records themselves stay where they are until the gather
+    V_OPENCL( kernels[ 0 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 2, szElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 3, paddedElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 4, *userFunctor ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 5, dvKeys.getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 0 ].setArg( 6, dvIndices.getBuffer( ) ), "Error setting kernel argument" );
+
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 0 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numWG * EXTRACTED_KEY_WGSIZE ),
+        ::cl::NDRange( EXTRACTED_KEY_WGSIZE ) );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for extractKey kernel" );
+
+    device_vector< cl_uint >* keysIn = &dvKeys;
+    device_vector< cl_uint >* indicesIn = &dvIndices;
+    device_vector< cl_uint >* keysOut = &dvSwapKeys;
+    device_vector< cl_uint >* indicesOut = &dvSwapIndices;
+
+    for( cl_uint bits = 0; bits < 32; bits += EXTRACTED_KEY_RADIX )
+    {
+        V_OPENCL( kernels[ 1 ].setArg( 0, keysIn->getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 1 ].setArg( 1, dvHistogram.getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 1 ].setArg( 2, bits ), "Error setting kernel argument" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 1 ],
+            ::cl::NullRange,
+            ::cl::NDRange( radixWorkItems ),
+            ::cl::NDRange( EXTRACTED_KEY_WGSIZE ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for extractedKeyHistogram kernel" );
+
+        detail::scan_enqueue( ctl, dvHistogram.begin( ), dvHistogram.end( ), dvScannedHistogram.begin( ), 0,
+                              plus< cl_uint >( ), false );
+
+        V_OPENCL( kernels[ 2 ].setArg( 0, keysIn->getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 2 ].setArg( 1, indicesIn->getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 2 ].setArg( 2, dvScannedHistogram.getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 2 ].setArg( 3, bits ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 2 ].setArg( 4, keysOut->getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[ 2 ].setArg( 5, indicesOut->getBuffer( ) ), "Error setting kernel argument" );
+
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[ 2 ],
+            ::cl::NullRange,
+            ::cl::NDRange( radixWorkItems ),
+            ::cl::NDRange( EXTRACTED_KEY_WGSIZE ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for extractedKeyPermute kernel" );
+
+        std::swap( keysIn, keysOut );
+        std::swap( indicesIn, indicesOut );
+    }
+
+    //  The record indices are now in key order; move every record once into a scratch buffer and copy it back
+    device_vector< iType > dvSorted( szElements, iType( ), CL_MEM_READ_WRITE, false, ctl );
+
+    V_OPENCL( kernels[ 3 ].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 3 ].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+              "Error setting a kernel argument" );
+    V_OPENCL( kernels[ 3 ].setArg( 2, szElements ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 3 ].setArg( 3, indicesIn->getBuffer( ) ), "Error setting kernel argument" );
+    V_OPENCL( kernels[ 3 ].setArg( 4, dvSorted.getBuffer( ) ), "Error setting kernel argument" );
+
+    l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+        kernels[ 3 ],
+        ::cl::NullRange,
+        ::cl::NDRange( numWG * EXTRACTED_KEY_WGSIZE ),
+        ::cl::NDRange( EXTRACTED_KEY_WGSIZE ) );
+    V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for extractedKeyGather kernel" );
+
+    ::cl::Event copyEvent;
+    l_Error = ctl.getCommandQueue( ).enqueueCopyBuffer( dvSorted.getBuffer( ), first.getContainer( ).getBuffer( ),
+        0, first.m_Index * sizeof( iType ), szElements * sizeof( iType ), NULL, &copyEvent );
+    V_OPENCL( l_Error, "enqueueCopyBuffer() failed for the sorted records" );
+    bolt::cl::wait( ctl, copyEvent );
+}
+
+template< typename RandomAccessIterator, typename KeyFunctor >
+void sort_by_extracted_key_cpu( bolt::cl::control::e_RunMode runMode,
+                                RandomAccessIterator first, RandomAccessIterator last,
+                                const KeyFunctor& key_functor )
+{
+    extracted_key_less< KeyFunctor > comp( key_functor );
+    if( runMode == bolt::cl::control::MultiCoreCpu )
+    {
+#ifdef ENABLE_TBB
+        bolt::btbb::stable_sort( first, last, comp );
+#else
+        throw std::exception( "The MultiCoreCpu version of sort_by_extracted_key is not enabled to be built! \n" );
+#endif
+    }
+    else
+    {
+        std::stable_sort( first, last, comp );
+    }
+}
+
+template< typename RandomAccessIterator, typename KeyFunctor >
+void sort_by_extracted_key_detect_random_access( control &ctl,
+                                                 const RandomAccessIterator& first,
+                                                 const RandomAccessIterator& last,
+                                                 const KeyFunctor& key_functor, const std::string& cl_code,
+                                                 std::input_iterator_tag )
+{
+    //  \TODO:  It should be possible to support non-random_access_iterator_tag iterators, if we copied the data
+    //  to a temporary buffer.  Should we?
+    static_assert( false, "Bolt only supports random access iterator types" );
+};
+
+template< typename RandomAccessIterator, typename KeyFunctor >
+void sort_by_extracted_key_detect_random_access( control &ctl,
+                                                 const RandomAccessIterator& first,
+                                                 const RandomAccessIterator& last,
+                                                 const KeyFunctor& key_functor, const std::string& cl_code,
+                                                 bolt::cl::fancy_iterator_tag )
+{
+    static_assert( false, "It is not possible to sort fancy iterators. They are not mutable" );
+};
+
+template< typename RandomAccessIterator, typename KeyFunctor >
+void sort_by_extracted_key_detect_random_access( control &ctl,
+                                                 const RandomAccessIterator& first,
+                                                 const RandomAccessIterator& last,
+                                                 const KeyFunctor& key_functor, const std::string& cl_code,
+                                                 std::random_access_iterator_tag )
+{
+    sort_by_extracted_key_pick_iterator( ctl, first, last, key_functor, cl_code,
+                                         std::iterator_traits< RandomAccessIterator >::iterator_category( ) );
+};
+
+//Device Vector specialization
+template< typename DVRandomAccessIterator, typename KeyFunctor >
+void sort_by_extracted_key_pick_iterator( control &ctl,
+                                          const DVRandomAccessIterator& first, const DVRandomAccessIterator& last,
+                                          const KeyFunctor& key_functor, const std::string& cl_code,
+                                          bolt::cl::device_vector_tag )
+{
+    typedef typename std::iterator_traits< DVRandomAccessIterator >::value_type T;
+    size_t szElements = static_cast< size_t >( std::distance( first, last ) );
+    if( szElements < 2 )
+        return;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        bolt::cl::device_vector< T >::pointer firstPtr = first.getContainer( ).data( );
+        sort_by_extracted_key_cpu( runMode, &firstPtr[ first.m_Index ], &firstPtr[ last.m_Index ], key_functor );
+    }
+    else
+    {
+        sort_by_extracted_key_enqueue( ctl, first, last, key_functor, cl_code );
+    }
+}
+
+//Non Device Vector specialization.
+//This implementation wraps the host memory in a device_vector and calls the device_vector specialization.
+template< typename RandomAccessIterator, typename KeyFunctor >
+void sort_by_extracted_key_pick_iterator( control &ctl,
+                                          const RandomAccessIterator& first, const RandomAccessIterator& last,
+                                          const KeyFunctor& key_functor, const std::string& cl_code,
+                                          std::random_access_iterator_tag )
+{
+    typedef typename std::iterator_traits< RandomAccessIterator >::value_type T;
+    size_t szElements = static_cast< size_t >( last - first );
+    if( szElements < 2 )
+        return;
+
+    bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );
+    if( runMode == bolt::cl::control::Automatic )
+    {
+        runMode = ctl.getDefaultPathToRun( );
+    }
+
+    if( runMode == bolt::cl::control::SerialCpu || runMode == bolt::cl::control::MultiCoreCpu )
+    {
+        sort_by_extracted_key_cpu( runMode, first, last, key_functor );
+    }
+    else
+    {
+        device_vector< T > dvInputOutput( first, last, CL_MEM_USE_HOST_PTR | CL_MEM_READ_WRITE, ctl );
+        sort_by_extracted_key_enqueue( ctl, dvInputOutput.begin( ), dvInputOutput.end( ), key_functor, cl_code );
+        //Map the buffer back to the host
+        dvInputOutput.data( );
+    }
+}
+
+}//namespace bolt::cl::detail
+}//namespace bolt::cl
+}//namespace bolt
+
+#endif
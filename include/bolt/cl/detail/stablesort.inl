@@ -29,6 +29,9 @@
 #include "bolt/cl/bolt.h"
 #include "bolt/cl/functional.h"
 #include "bolt/cl/device_vector.h"
+#ifdef ENABLE_TBB
+#include "bolt/btbb/stablesort.h"
+#endif
 
 #define BOLT_CL_STABLESORT_CPU_THRESHOLD 64
 
@@ -199,8 +202,7 @@ void stablesort_pick_iterator( control &ctl, const RandomAccessIterator& first,
     else if( runMode == bolt::cl::control::MultiCoreCpu )
     {
         #ifdef ENABLE_TBB
-            //TODO - Add Log for the serial CPU code path taken when multicore is called
-            std::stable_sort( first, last, comp );
+            bolt::btbb::stable_sort( first, last, comp );
         #else
             throw std::exception("MultiCoreCPU Version of stable_sort not Enabled! \n");
         #endif
@@ -250,9 +252,8 @@ void stablesort_pick_iterator( control &ctl,
     else if( runMode == bolt::cl::control::MultiCoreCpu )
     {
         #ifdef ENABLE_TBB
-            //TODO - ADDLOG calling serial CPU code paths 
             bolt::cl::device_vector< Type >::pointer firstPtr =  first.getContainer( ).data( );
-            std::stable_sort( &firstPtr[ first.m_Index ], &firstPtr[ last.m_Index ], comp );
+            bolt::btbb::stable_sort( &firstPtr[ first.m_Index ], &firstPtr[ last.m_Index ], comp );
         #else
             throw std::exception("MultiCoreCPU Version of stable_sort not Enabled! \n");
         #endif
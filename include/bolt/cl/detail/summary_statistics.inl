@@ -0,0 +1,93 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SUMMARY_STATISTICS_INL )
+#define BOLT_CL_SUMMARY_STATISTICS_INL
+#pragma once
+
+namespace bolt {
+    namespace cl {
+
+        namespace detail {
+
+            //  The initial value of the accumulator; the binary operator treats an accumulator with a zero count as
+            //  empty, so the minimum and maximum of the initial value never take part
+            template< typename T >
+            summary_statistics< T > summary_statistics_identity( )
+            {
+                summary_statistics< T > identity;
+                identity.count = 0;
+                identity.sum = T( );
+                identity.sum_of_squares = T( );
+                identity.minimum = T( );
+                identity.maximum = T( );
+                return identity;
+            }
+
+        }
+
+        //  All paths go through transform_reduce: the OpenCL kernel applies the unary operator as it reads each
+        //  element, and the TBB and serial paths accumulate in the same loop that reads the range.
+        template<typename InputIterator>
+        summary_statistics< typename std::iterator_traits< InputIterator >::value_type >
+            reduce_statistics(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            const std::string& cl_code)
+        {
+            typedef typename std::iterator_traits< InputIterator >::value_type iType;
+
+            return transform_reduce( ctl, first, last, summary_statistics_unary_op< iType >( ),
+                detail::summary_statistics_identity< iType >( ), summary_statistics_binary_op< iType >( ), cl_code );
+        }
+
+        template<typename InputIterator>
+        summary_statistics< typename std::iterator_traits< InputIterator >::value_type >
+            reduce_statistics(InputIterator first,
+            InputIterator last,
+            const std::string& cl_code)
+        {
+            return reduce_statistics( control::getDefault( ), first, last, cl_code );
+        }
+
+        template<typename InputIterator>
+        void reduce_statistics(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            device_scalar< summary_statistics< typename std::iterator_traits< InputIterator >::value_type > >& result,
+            const std::string& cl_code)
+        {
+            typedef typename std::iterator_traits< InputIterator >::value_type iType;
+
+            transform_reduce( ctl, first, last, summary_statistics_unary_op< iType >( ),
+                detail::summary_statistics_identity< iType >( ), summary_statistics_binary_op< iType >( ), result,
+                cl_code );
+        }
+
+        template<typename InputIterator>
+        void reduce_statistics(InputIterator first,
+            InputIterator last,
+            device_scalar< summary_statistics< typename std::iterator_traits< InputIterator >::value_type > >& result,
+            const std::string& cl_code)
+        {
+            reduce_statistics( control::getDefault( ), first, last, result, cl_code );
+        }
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#endif
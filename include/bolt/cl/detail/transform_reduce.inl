@@ -26,6 +26,8 @@
 #include <numeric>
 
 #include "bolt/cl/bolt.h"
+#include "bolt/cl/device_scalar.h"
+#include "bolt/cl/reduce.h"
 
 #ifdef ENABLE_TBB
 //TBB Includes
@@ -62,6 +64,37 @@ namespace cl {
 
     };
 
+    // The CPU paths compute the value on the host and write it to the scalar; the OpenCL path finishes the
+    // reduction on the device and does not wait for it.
+    template<typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction>
+    void transform_reduce( control& ctl, InputIterator first, InputIterator last,
+        UnaryFunction transform_op,
+        T init,  BinaryFunction reduce_op, device_scalar< T >& result, const std::string& user_code )
+    {
+        bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode();
+        if(runMode == bolt::cl::control::Automatic)
+        {
+            runMode = ctl.getDefaultPathToRun();
+        }
+        if( runMode == bolt::cl::control::OpenCL && first != last )
+        {
+            detail::transform_reduce_pick_iterator( ctl, first, last, transform_op, init, reduce_op, result, user_code,
+                std::iterator_traits< InputIterator >::iterator_category( ) );
+        }
+        else
+        {
+            result.set( transform_reduce( ctl, first, last, transform_op, init, reduce_op, user_code ) );
+        }
+    };
+
+    template<typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction>
+    void transform_reduce(InputIterator first, InputIterator last,
+        UnaryFunction transform_op,
+        T init,  BinaryFunction reduce_op, device_scalar< T >& result, const std::string& user_code )
+    {
+        transform_reduce( control::getDefault(), first, last, transform_op, init, reduce_op, result, user_code );
+    };
+
 
 namespace  detail {
 
@@ -99,6 +132,19 @@ namespace  detail {
 
 
 
+        //  Transforms each element as it is read and folds it into the accumulator, so that the range is read once
+        //  and no temporary sequence is needed
+        template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+        oType transform_reduce_serial( InputIterator first, InputIterator last, UnaryFunction transform_op,
+            const oType& init, BinaryFunction reduce_op )
+        {
+            oType acc = init;
+            for( ; first != last; ++first )
+                acc = reduce_op( acc, transform_op( *first ) );
+
+            return acc;
+        };
+
         //  The following two functions disallow non-random access functions
         // Wrapper that uses default control class, iterator interface
         template<typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction>
@@ -150,11 +196,7 @@ namespace  detail {
             }
             if (runMode == bolt::cl::control::SerialCpu)
             {
-                //Create a temporary array to store the transform result;
-                std::vector<oType> output(szElements);
-
-                std::transform(first, last, output.begin(),transform_op);
-                return std::accumulate(output.begin(), output.end(), init, reduce_op);
+                return transform_reduce_serial( first, last, transform_op, init, reduce_op );
 
             } else if (runMode == bolt::cl::control::MultiCoreCpu) {
 
@@ -203,11 +245,9 @@ namespace  detail {
             if (runMode == bolt::cl::control::SerialCpu)
             {
                 bolt::cl::device_vector< iType >::pointer firstPtr = first.getContainer( ).data( );
-                std::vector< oType > result ( last.m_Index - first.m_Index );
 
-                std::transform( &firstPtr[ first.m_Index ], &firstPtr[ last.m_Index ], result.begin(), transform_op );
-            
-                return std::accumulate(  result.begin(), result.end(), init, reduce_op );
+                return transform_reduce_serial( &firstPtr[ first.m_Index ], &firstPtr[ last.m_Index ], transform_op,
+                                                init, reduce_op );
 
             }
             else if (runMode == bolt::cl::control::MultiCoreCpu)
@@ -228,15 +268,57 @@ namespace  detail {
             return  transform_reduce_enqueue( c, first, last, transform_op, init, reduce_op, user_code );
         };
 
+        // The device_scalar overloads only reach this point on the OpenCL path, with a non-empty range
+        template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+        void transform_reduce_pick_iterator(
+            control &c,
+            const InputIterator& first,
+            const InputIterator& last,
+            const UnaryFunction& transform_op,
+            const oType& init,
+            const BinaryFunction& reduce_op,
+            device_scalar< oType >& result,
+            const std::string& user_code,
+            std::random_access_iterator_tag )
+        {
+            //  The input is copied rather than wrapped, because the caller's memory is only guaranteed to be valid
+            //  until this returns, which is before the kernels run
+            typedef std::iterator_traits<InputIterator>::value_type iType;
+            device_vector< iType > dvInput( first, last, CL_MEM_READ_ONLY, c );
+
+            transform_reduce_enqueue( c, dvInput.begin( ), dvInput.end( ), transform_op, init, reduce_op, result,
+                                      user_code );
+        };
+
         template<typename DVInputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
-        oType transform_reduce_enqueue(
+        void transform_reduce_pick_iterator(
+            control &c,
+            const DVInputIterator& first,
+            const DVInputIterator& last,
+            const UnaryFunction& transform_op,
+            const oType& init,
+            const BinaryFunction& reduce_op,
+            device_scalar< oType >& result,
+            const std::string& user_code,
+            bolt::cl::device_vector_tag )
+        {
+            transform_reduce_enqueue( c, first, last, transform_op, init, reduce_op, result, user_code );
+        };
+
+        // Enqueues the transform and the first pass of the reduction, which leaves one partial result per work-group
+        // in the returned buffer; numPartials receives the number of work-groups that wrote one.
+        template<typename DVInputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+        control::buffPointer transform_reduce_partials_enqueue(
             control& ctl,
             const DVInputIterator& first,
             const DVInputIterator& last,
             const UnaryFunction& transform_op,
             const oType& init,
             const BinaryFunction& reduce_op,
-            const std::string& user_code="")
+            const ::cl::Buffer& transformFunctor,
+            const ::cl::Buffer& reduceFunctor,
+            const std::string& user_code,
+            size_t& numPartials )
         {
             unsigned debugMode = 0; //FIXME, use control
 
@@ -302,16 +384,8 @@ namespace  detail {
             // kernels returned in same order as added in KernelTemplaceSpecializer constructor
 
 
-            // Create Buffer wrappers so we can access the host functors, for read or writing in the kernel
-            ALIGNED( 256 ) UnaryFunction aligned_unary( transform_op );
-            ALIGNED( 256 ) BinaryFunction aligned_binary( reduce_op );
-
-            control::buffPointer transformFunctor = ctl.acquireBuffer( sizeof( aligned_unary ),
-                                       CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_unary );
-            control::buffPointer reduceFunctor = ctl.acquireBuffer( sizeof( aligned_binary ),
-                                      CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary );
             control::buffPointer result = ctl.acquireBuffer( sizeof( oType ) * numWG,
-                                                   CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
+                                                   CL_MEM_ALLOC_HOST_PTR|CL_MEM_READ_WRITE );
 
             cl_uint szElements = static_cast< cl_uint >( std::distance( first, last ) );
 
@@ -331,9 +405,9 @@ namespace  detail {
                                                             "Error setting kernel argument" );
 
             V_OPENCL( kernels[0].setArg( 2, szElements), "Error setting kernel argument" );
-            V_OPENCL( kernels[0].setArg( 3, *transformFunctor), "Error setting kernel argument" );
+            V_OPENCL( kernels[0].setArg( 3, transformFunctor), "Error setting kernel argument" );
             V_OPENCL( kernels[0].setArg( 4, init), "Error setting kernel argument" );
-            V_OPENCL( kernels[0].setArg( 5, *reduceFunctor), "Error setting kernel argument" );
+            V_OPENCL( kernels[0].setArg( 5, reduceFunctor), "Error setting kernel argument" );
             V_OPENCL( kernels[0].setArg( 6, *result), "Error setting kernel argument" );
 
             ::cl::LocalSpaceArg loc;
@@ -347,17 +421,44 @@ namespace  detail {
                 ::cl::NDRange(wgSize) );
             V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for transform_reduce() kernel" );
 
+            // The compute device reduces within the workgroups, with one result per workgroup
+            size_t ceilNumWG = static_cast< size_t >( std::ceil( static_cast< float >( szElements ) / wgSize) );
+            bolt::cl::minimum< size_t >  min_size_t;
+            numPartials = min_size_t( ceilNumWG, numWG );
+
+            return result;
+        };
+
+        template<typename DVInputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+        oType transform_reduce_enqueue(
+            control& ctl,
+            const DVInputIterator& first,
+            const DVInputIterator& last,
+            const UnaryFunction& transform_op,
+            const oType& init,
+            const BinaryFunction& reduce_op,
+            const std::string& user_code="")
+        {
+            // Create Buffer wrappers so we can access the host functors, for read or writing in the kernel
+            ALIGNED( 256 ) UnaryFunction aligned_unary( transform_op );
+            ALIGNED( 256 ) BinaryFunction aligned_binary( reduce_op );
+
+            control::buffPointer transformFunctor = ctl.acquireBuffer( sizeof( aligned_unary ),
+                                       CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_unary );
+            control::buffPointer reduceFunctor = ctl.acquireBuffer( sizeof( aligned_binary ),
+                                      CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary );
+
+            size_t numTailReduce = 0;
+            control::buffPointer result = transform_reduce_partials_enqueue( ctl, first, last, transform_op, init,
+                reduce_op, *transformFunctor, *reduceFunctor, user_code, numTailReduce );
+
+            cl_int l_Error = CL_SUCCESS;
             ::cl::Event l_mapEvent;
             oType *h_result = (oType*)ctl.getCommandQueue().enqueueMapBuffer(*result, false, CL_MAP_READ, 0,
-                                                        sizeof(oType)*numWG, NULL, &l_mapEvent, &l_Error );
+                                                        sizeof(oType)*numTailReduce, NULL, &l_mapEvent, &l_Error );
             V_OPENCL( l_Error, "Error calling map on the result buffer" );
 
-            //  Finish the tail end of the reduction on host side; the compute device reduces within the workgroups,
-            // with one result per workgroup
-            size_t ceilNumWG = static_cast< size_t >( std::ceil( static_cast< float >( szElements ) / wgSize) );
-            bolt::cl::minimum< size_t >  min_size_t;
-            size_t numTailReduce = min_size_t( ceilNumWG, numWG );
-
+            //  Finish the tail end of the reduction on host side
             bolt::cl::wait(ctl, l_mapEvent);
 
             oType acc = static_cast< oType >( init );
@@ -376,6 +477,28 @@ namespace  detail {
             return acc;
         };
 
+        // Same as above, but the tail end of the reduction also runs on the device, and the result stays there
+        template<typename DVInputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+        void transform_reduce_enqueue(
+            control& ctl,
+            const DVInputIterator& first,
+            const DVInputIterator& last,
+            const UnaryFunction& transform_op,
+            const oType& init,
+            const BinaryFunction& reduce_op,
+            device_scalar< oType >& result,
+            const std::string& user_code="")
+        {
+            ::cl::Buffer transformFunctor = reduce_functor_buffer( ctl, transform_op );
+            ::cl::Buffer reduceFunctor = reduce_functor_buffer( ctl, reduce_op );
+
+            size_t numPartials = 0;
+            control::buffPointer partials = transform_reduce_partials_enqueue( ctl, first, last, transform_op, init,
+                reduce_op, transformFunctor, reduceFunctor, user_code, numPartials );
+
+            reduce_final_enqueue( ctl, *partials, numPartials, init, reduce_op, result, user_code );
+        };
+
 }// end of namespace detail
 }// end of namespace cl
 }// end of namespace bolt
@@ -0,0 +1,402 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_TRANSFORM_REDUCE_RANGE_INL )
+#define BOLT_CL_TRANSFORM_REDUCE_RANGE_INL
+#pragma once
+
+#include <algorithm>
+
+#include "bolt/cl/bolt.h"
+
+#ifdef ENABLE_TBB
+    #include "bolt/btbb/transform_reduce_range.h"
+#endif
+
+namespace bolt {
+namespace cl {
+
+    template<typename InputIterator, int Rank, typename UnaryFunction, typename T, typename BinaryFunction>
+    T transform_reduce_range(
+        control& ctl,
+        InputIterator first,
+        const array_region< Rank >& region,
+        UnaryFunction transform_op,
+        T init,
+        BinaryFunction reduce_op,
+        const std::string& user_code )
+    {
+        int origin[ 3 ], extent[ 3 ], stride[ 3 ];
+        detail::transform_reduce_range_normalize( region, origin, extent, stride );
+
+        if( extent[ 0 ] <= 0 || extent[ 1 ] <= 0 || extent[ 2 ] <= 0 )
+            return init;
+
+        return detail::transform_reduce_range_detect_random_access( ctl, first, origin, extent, stride,
+            transform_op, init, reduce_op, user_code, std::iterator_traits< InputIterator >::iterator_category( ) );
+    };
+
+    template<typename InputIterator, int Rank, typename UnaryFunction, typename T, typename BinaryFunction>
+    T transform_reduce_range(
+        InputIterator first,
+        const array_region< Rank >& region,
+        UnaryFunction transform_op,
+        T init,
+        BinaryFunction reduce_op,
+        const std::string& user_code )
+    {
+        return transform_reduce_range( control::getDefault( ), first, region, transform_op, init, reduce_op,
+            user_code );
+    };
+
+
+namespace  detail {
+
+    enum transformReduceRangeTypes { trr_iType, trr_iIterType, trr_oType, trr_UnaryFunction, trr_BinaryFunction,
+        trr_end };
+
+    class TransformReduceRange_KernelTemplateSpecializer : public KernelTemplateSpecializer
+    {
+    public:
+        TransformReduceRange_KernelTemplateSpecializer() : KernelTemplateSpecializer()
+        {
+            addKernelName( "transformReduceRangeTemplate" );
+        }
+
+        const ::std::string operator() ( const ::std::vector<::std::string>& typeNames ) const
+        {
+            const std::string templateSpecializationString =
+                "// Host generates this instantiation string with user-specified value type and functor\n"
+                "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
+                "__attribute__((reqd_work_group_size(16,4,1)))\n"
+                "kernel void " + name(0) + "(\n"
+                "global " + typeNames[trr_iType] + "* input_ptr,\n"
+                + typeNames[trr_iIterType] + " input_iter,\n"
+                "const int origin0,\n"
+                "const int origin1,\n"
+                "const int origin2,\n"
+                "const int extent0,\n"
+                "const int extent1,\n"
+                "const int extent2,\n"
+                "const int stride0,\n"
+                "const int stride1,\n"
+                "const int stride2,\n"
+                "global " + typeNames[trr_UnaryFunction] + "* transformFunctor,\n"
+                "global " + typeNames[trr_BinaryFunction] + "* reduceFunctor,\n"
+                "global " + typeNames[trr_oType] + "* result,\n"
+                "local " + typeNames[trr_oType] + "* scratch,\n"
+                "local int* scratchValid\n"
+                ");\n\n";
+            return templateSpecializationString;
+        }
+    };
+
+    //  A 2D region is handled as a 3D region with a single slice, so every path only deals with three dimensions
+    template< int Rank >
+    void transform_reduce_range_normalize( const array_region< Rank >& region, int ( &origin )[ 3 ],
+        int ( &extent )[ 3 ], int ( &stride )[ 3 ] )
+    {
+        static_assert( Rank == 2 || Rank == 3, "transform_reduce_range only supports 2D and 3D regions" );
+
+        const int lead = 3 - Rank;
+        for( int d = 0; d < lead; ++d )
+        {
+            origin[ d ] = 0;
+            extent[ d ] = 1;
+            stride[ d ] = 0;
+        }
+        for( int d = 0; d < Rank; ++d )
+        {
+            origin[ lead + d ] = region.origin[ d ];
+            extent[ lead + d ] = region.extent[ d ];
+            stride[ lead + d ] = region.stride[ d ];
+        }
+    };
+
+    //  Number of elements from the beginning of the array up to and including the last element of the region
+    inline size_t transform_reduce_range_span( const int ( &origin )[ 3 ], const int ( &extent )[ 3 ],
+        const int ( &stride )[ 3 ] )
+    {
+        size_t last = 0;
+        for( int d = 0; d < 3; ++d )
+            last += static_cast< size_t >( origin[ d ] + extent[ d ] - 1 ) * static_cast< size_t >( stride[ d ] );
+        return last + 1;
+    };
+
+    template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+    oType transform_reduce_range_serial( InputIterator first, const int ( &origin )[ 3 ], const int ( &extent )[ 3 ],
+        const int ( &stride )[ 3 ], const UnaryFunction& transform_op, const oType& init,
+        const BinaryFunction& reduce_op )
+    {
+        oType acc = init;
+        for( int z = 0; z < extent[ 0 ]; ++z )
+        {
+            for( int y = 0; y < extent[ 1 ]; ++y )
+            {
+                InputIterator row = first + ( ( origin[ 0 ] + z ) * stride[ 0 ] + ( origin[ 1 ] + y ) * stride[ 1 ] +
+                    origin[ 2 ] * stride[ 2 ] );
+                for( int x = 0; x < extent[ 2 ]; ++x )
+                    acc = reduce_op( acc, transform_op( row[ x * stride[ 2 ] ] ) );
+            }
+        }
+        return acc;
+    };
+
+    template<typename DVInputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+    oType transform_reduce_range_enqueue(
+        control& ctl,
+        const DVInputIterator& first,
+        const int ( &origin )[ 3 ],
+        const int ( &extent )[ 3 ],
+        const int ( &stride )[ 3 ],
+        const UnaryFunction& transform_op,
+        const oType& init,
+        const BinaryFunction& reduce_op,
+        const std::string& user_code )
+    {
+        typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+
+        std::vector<std::string> typeNames( trr_end );
+        typeNames[trr_iType] = TypeName< iType >::get( );
+        typeNames[trr_iIterType] = TypeName< DVInputIterator >::get( );
+        typeNames[trr_oType] = TypeName< oType >::get( );
+        typeNames[trr_UnaryFunction] = TypeName< UnaryFunction >::get( );
+        typeNames[trr_BinaryFunction] = TypeName< BinaryFunction >::get( );
+
+        std::vector<std::string> typeDefinitions;
+        PUSH_BACK_UNIQUE( typeDefinitions, user_code )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< iType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< DVInputIterator >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< oType >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< UnaryFunction >::get( ) )
+        PUSH_BACK_UNIQUE( typeDefinitions, ClCode< BinaryFunction >::get( ) )
+
+        TransformReduceRange_KernelTemplateSpecializer trr_kts;
+        std::vector< ::cl::Kernel > kernels = bolt::cl::getKernels(
+            ctl,
+            typeNames,
+            &trr_kts,
+            typeDefinitions,
+            transform_reduce_range_kernels,
+            std::string( ) );
+
+        const size_t tileWidth = 16;
+        const size_t tileHeight = 4;
+
+        //  Spread the work-groups over the columns first, then over the rows.  A work-group never starts past the
+        //  end of the window, so its first work-item always owns at least one element.
+        cl_uint computeUnits = ctl.getDevice( ).getInfo< CL_DEVICE_MAX_COMPUTE_UNITS >( );
+        size_t numWG = std::max< size_t >( 1, computeUnits * ctl.getWGPerComputeUnit( ) );
+        size_t groupsX = std::min< size_t >( ( extent[ 2 ] + tileWidth - 1 ) / tileWidth, numWG );
+        size_t groupsY = std::min< size_t >( ( extent[ 1 ] + tileHeight - 1 ) / tileHeight,
+            std::max< size_t >( 1, numWG / groupsX ) );
+        size_t numPartials = groupsX * groupsY;
+
+        // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
+        ALIGNED( 256 ) UnaryFunction aligned_unary( transform_op );
+        ALIGNED( 256 ) BinaryFunction aligned_binary( reduce_op );
+        control::buffPointer transformFunctor = ctl.acquireBuffer( sizeof( aligned_unary ),
+            CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_unary );
+        control::buffPointer reduceFunctor = ctl.acquireBuffer( sizeof( aligned_binary ),
+            CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary );
+        control::buffPointer result = ctl.acquireBuffer( sizeof( oType ) * numPartials,
+            CL_MEM_ALLOC_HOST_PTR|CL_MEM_WRITE_ONLY );
+
+        V_OPENCL( kernels[0].setArg( 0, first.getContainer( ).getBuffer( ) ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),
+                                                   "Error setting a kernel argument" );
+        for( int d = 0; d < 3; ++d )
+        {
+            V_OPENCL( kernels[0].setArg( 2 + d, origin[ d ] ), "Error setting kernel argument" );
+            V_OPENCL( kernels[0].setArg( 5 + d, extent[ d ] ), "Error setting kernel argument" );
+            V_OPENCL( kernels[0].setArg( 8 + d, stride[ d ] ), "Error setting kernel argument" );
+        }
+        V_OPENCL( kernels[0].setArg( 11, *transformFunctor ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 12, *reduceFunctor ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 13, *result ), "Error setting kernel argument" );
+
+        ::cl::LocalSpaceArg locScratch, locValid;
+        locScratch.size_ = tileWidth * tileHeight * sizeof( oType );
+        locValid.size_ = tileWidth * tileHeight * sizeof( int );
+        V_OPENCL( kernels[0].setArg( 14, locScratch ), "Error setting kernel argument" );
+        V_OPENCL( kernels[0].setArg( 15, locValid ), "Error setting kernel argument" );
+
+        cl_int l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[0],
+            ::cl::NullRange,
+            ::cl::NDRange( groupsX * tileWidth, groupsY * tileHeight ),
+            ::cl::NDRange( tileWidth, tileHeight ) );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for transform_reduce_range() kernel" );
+
+        ::cl::Event l_mapEvent;
+        oType *h_result = (oType*)ctl.getCommandQueue( ).enqueueMapBuffer( *result, false, CL_MAP_READ, 0,
+            sizeof( oType ) * numPartials, NULL, &l_mapEvent, &l_Error );
+        V_OPENCL( l_Error, "Error calling map on the result buffer" );
+
+        bolt::cl::wait( ctl, l_mapEvent );
+
+        //  Finish the tail end of the reduction on host side; there is one partial per work-group
+        oType acc = init;
+        for( size_t i = 0; i < numPartials; ++i )
+            acc = reduce_op( acc, h_result[ i ] );
+
+        ::cl::Event unmapEvent;
+        V_OPENCL( ctl.getCommandQueue( ).enqueueUnmapMemObject( *result, h_result, NULL, &unmapEvent ),
+            "shared_ptr failed to unmap host memory back to device memory" );
+        V_OPENCL( unmapEvent.wait( ), "failed to wait for unmap event" );
+
+        return acc;
+    };
+
+    template<typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction>
+    T transform_reduce_range_detect_random_access( control& ctl, const InputIterator& first,
+        const int ( &origin )[ 3 ], const int ( &extent )[ 3 ], const int ( &stride )[ 3 ],
+        const UnaryFunction& transform_op, const T& init, const BinaryFunction& reduce_op,
+        const std::string& user_code, std::input_iterator_tag )
+    {
+        //  TODO:  It should be possible to support non-random_access_iterator_tag iterators,if we copied the data
+        //  to a temporary buffer.  Should we?
+        static_assert( false, "Bolt only supports random access iterator types" );
+    };
+
+    template<typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction>
+    T transform_reduce_range_detect_random_access( control& ctl, const InputIterator& first,
+        const int ( &origin )[ 3 ], const int ( &extent )[ 3 ], const int ( &stride )[ 3 ],
+        const UnaryFunction& transform_op, const T& init, const BinaryFunction& reduce_op,
+        const std::string& user_code, std::random_access_iterator_tag )
+    {
+        return transform_reduce_range_pick_iterator( ctl, first, origin, extent, stride, transform_op, init,
+            reduce_op, user_code, std::iterator_traits< InputIterator >::iterator_category( ) );
+    };
+
+    // This template is called strictly for any non-device_vector iterator
+    template<typename InputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+    oType transform_reduce_range_pick_iterator( control& ctl, const InputIterator& first,
+        const int ( &origin )[ 3 ], const int ( &extent )[ 3 ], const int ( &stride )[ 3 ],
+        const UnaryFunction& transform_op, const oType& init, const BinaryFunction& reduce_op,
+        const std::string& user_code, std::random_access_iterator_tag )
+    {
+        typedef typename std::iterator_traits< InputIterator >::value_type iType;
+
+        bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );  // could be dynamic choice some day.
+        if( runMode == bolt::cl::control::Automatic )
+        {
+            runMode = ctl.getDefaultPathToRun( );
+        }
+
+        switch( runMode )
+        {
+        case bolt::cl::control::OpenCL :
+            {
+                //  Only the part of the array that ends with the last element of the region is mapped
+                size_t span = transform_reduce_range_span( origin, extent, stride );
+                device_vector< iType > dvInput( first, first + span, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY, ctl );
+                return transform_reduce_range_enqueue( ctl, dvInput.begin( ), origin, extent, stride, transform_op,
+                    init, reduce_op, user_code );
+            }
+
+        case bolt::cl::control::MultiCoreCpu:
+            #ifdef ENABLE_TBB
+                return bolt::btbb::transform_reduce_range( first, origin, extent, stride, transform_op, init,
+                    reduce_op );
+            #else
+                throw std::exception( "The MultiCoreCpu version of transform_reduce_range is not enabled! \n" );
+            #endif
+
+        default:
+            return transform_reduce_range_serial( first, origin, extent, stride, transform_op, init, reduce_op );
+        }
+    };
+
+    // This template is called strictly for iterators that are derived from device_vector< T >::iterator
+    template<typename DVInputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+    oType transform_reduce_range_pick_iterator( control& ctl, const DVInputIterator& first,
+        const int ( &origin )[ 3 ], const int ( &extent )[ 3 ], const int ( &stride )[ 3 ],
+        const UnaryFunction& transform_op, const oType& init, const BinaryFunction& reduce_op,
+        const std::string& user_code, bolt::cl::device_vector_tag )
+    {
+        typedef typename std::iterator_traits< DVInputIterator >::value_type iType;
+
+        bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );  // could be dynamic choice some day.
+        if( runMode == bolt::cl::control::Automatic )
+        {
+            runMode = ctl.getDefaultPathToRun( );
+        }
+
+        switch( runMode )
+        {
+        case bolt::cl::control::OpenCL :
+            return transform_reduce_range_enqueue( ctl, first, origin, extent, stride, transform_op, init, reduce_op,
+                user_code );
+
+        case bolt::cl::control::MultiCoreCpu:
+            #ifdef ENABLE_TBB
+            {
+                typename bolt::cl::device_vector< iType >::pointer inputPtr = first.getContainer( ).data( );
+                return bolt::btbb::transform_reduce_range( &inputPtr[ first.m_Index ], origin, extent, stride,
+                    transform_op, init, reduce_op );
+            }
+            #else
+                throw std::exception( "The MultiCoreCpu version of transform_reduce_range is not enabled! \n" );
+            #endif
+
+        default:
+            {
+                typename bolt::cl::device_vector< iType >::pointer inputPtr = first.getContainer( ).data( );
+                return transform_reduce_range_serial( &inputPtr[ first.m_Index ], origin, extent, stride,
+                    transform_op, init, reduce_op );
+            }
+        }
+    };
+
+    // This template is called strictly for fancy iterators such as the counting_iterator
+    template<typename DVInputIterator, typename UnaryFunction, typename oType, typename BinaryFunction>
+    oType transform_reduce_range_pick_iterator( control& ctl, const DVInputIterator& first,
+        const int ( &origin )[ 3 ], const int ( &extent )[ 3 ], const int ( &stride )[ 3 ],
+        const UnaryFunction& transform_op, const oType& init, const BinaryFunction& reduce_op,
+        const std::string& user_code, bolt::cl::fancy_iterator_tag )
+    {
+        bolt::cl::control::e_RunMode runMode = ctl.getForceRunMode( );  // could be dynamic choice some day.
+        if( runMode == bolt::cl::control::Automatic )
+        {
+            runMode = ctl.getDefaultPathToRun( );
+        }
+
+        switch( runMode )
+        {
+        case bolt::cl::control::OpenCL :
+            return transform_reduce_range_enqueue( ctl, first, origin, extent, stride, transform_op, init, reduce_op,
+                user_code );
+
+        case bolt::cl::control::MultiCoreCpu:
+            #ifdef ENABLE_TBB
+                return bolt::btbb::transform_reduce_range( first, origin, extent, stride, transform_op, init,
+                    reduce_op );
+            #else
+                throw std::exception( "The MultiCoreCpu version of transform_reduce_range is not enabled! \n" );
+            #endif
+
+        default:
+            return transform_reduce_range_serial( first, origin, extent, stride, transform_op, init, reduce_op );
+        }
+    };
+
+}// end of namespace detail
+}// end of namespace cl
+}// end of namespace bolt
+
+#endif // BOLT_CL_TRANSFORM_REDUCE_RANGE_INL
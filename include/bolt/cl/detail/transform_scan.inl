@@ -39,6 +39,11 @@
 #include "bolt/cl/transform.h"
 #include "bolt/cl/bolt.h"
 
+#ifdef ENABLE_TBB
+//TBB Includes
+#include "bolt/btbb/transform_scan.h"
+#endif
+
 namespace bolt
 {
 namespace cl
@@ -226,9 +231,10 @@ class TransformScan_KernelTemplateSpecializer : public KernelTemplateSpecializer
 public:
     TransformScan_KernelTemplateSpecializer() : KernelTemplateSpecializer()
     {
-        addKernelName("perBlockTransformScan");
+        addKernelName("perTileTransformReduce");
         addKernelName("intraBlockInclusiveScan");
-        addKernelName("perBlockAddition");
+        addKernelName("perTileTransformScan");
+        addKernelName("singlePassTransformScan");
     }
 
     const ::std::string operator() ( const ::std::vector<::std::string>& typeNames ) const
@@ -238,8 +244,6 @@ public:
             "template __attribute__((mangled_name(" + name(0) + "Instantiated)))\n"
             "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
             "__kernel void " + name(0) + "(\n"
-            "global " + typeNames[transformScan_oValueType] + "* output_ptr,\n"
-            ""        + typeNames[transformScan_oIterType] + " output_iter,\n"
             "global " + typeNames[transformScan_iValueType] + "* input_ptr,\n"
             ""        + typeNames[transformScan_iIterType] + " input_iter,\n"
             ""        + typeNames[transformScan_initType] + " identity,\n"
@@ -247,7 +251,7 @@ public:
             "local "  + typeNames[transformScan_oValueType] + "* lds,\n"
             "global " + typeNames[transformScan_UnaryFunction] + "* unaryOp,\n"
             "global " + typeNames[transformScan_BinaryFunction] + "* binaryOp,\n"
-            "global " + typeNames[transformScan_oValueType] + "* scanBuffer,\n"
+            "global " + typeNames[transformScan_oValueType] + "* tileSums,\n"
             "int exclusive\n"
             ");\n\n"
 
@@ -269,9 +273,33 @@ public:
             "__kernel void " + name(2) + "(\n"
             "global " + typeNames[transformScan_oValueType] + "* output_ptr,\n"
             ""        + typeNames[transformScan_oIterType] + " output_iter,\n"
+            "global " + typeNames[transformScan_iValueType] + "* input_ptr,\n"
+            ""        + typeNames[transformScan_iIterType] + " input_iter,\n"
+            ""        + typeNames[transformScan_initType] + " identity,\n"
+            "const uint vecSize,\n"
+            "local "  + typeNames[transformScan_oValueType] + "* lds,\n"
+            "global " + typeNames[transformScan_UnaryFunction] + "* unaryOp,\n"
+            "global " + typeNames[transformScan_BinaryFunction] + "* binaryOp,\n"
             "global " + typeNames[transformScan_oValueType] + "* postSumArray,\n"
+            "int exclusive\n"
+            ");\n\n"
+
+            "// Dynamic specialization of generic template definition, using user supplied types\n"
+            "template __attribute__((mangled_name(" + name(3) + "Instantiated)))\n"
+            "__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))\n"
+            "__kernel void " + name(3) + "(\n"
+            "global " + typeNames[transformScan_oValueType] + "* output_ptr,\n"
+            ""        + typeNames[transformScan_oIterType] + " output_iter,\n"
+            "global " + typeNames[transformScan_iValueType] + "* input_ptr,\n"
+            ""        + typeNames[transformScan_iIterType] + " input_iter,\n"
+            ""        + typeNames[transformScan_initType] + " identity,\n"
             "const uint vecSize,\n"
-            "global " + typeNames[transformScan_BinaryFunction] + "* binaryOp\n"
+            "local "  + typeNames[transformScan_oValueType] + "* lds,\n"
+            "global " + typeNames[transformScan_UnaryFunction] + "* unaryOp,\n"
+            "global " + typeNames[transformScan_BinaryFunction] + "* binaryOp,\n"
+            "global uint* tileStatus,\n"
+            "global uint* tileValues,\n"
+            "int exclusive\n"
             ");\n\n";
 
         return templateSpecializationString;
@@ -370,9 +398,10 @@ transform_scan_pick_iterator(
     else if( runMode == bolt::cl::control::MultiCoreCpu )
     {
         #ifdef ENABLE_TBB
-            std::transform(first, last, result, unary_op);
-            Serial_Scan<oType, BinaryFunction, T>(&(*result), &(*result), numElements, binary_op,inclusive,init);
-            return result + numElements;
+            if( inclusive )
+                return bolt::btbb::transform_inclusive_scan( first, last, result, unary_op, binary_op );
+            else
+                return bolt::btbb::transform_exclusive_scan( first, last, result, unary_op, init, binary_op );
         #else
                 throw std::exception("The MultiCoreCpu version of Transform_scan is not enabled to be built! \n");
         #endif
@@ -449,8 +478,13 @@ transform_scan_pick_iterator(
             bolt::cl::device_vector< iType >::pointer InputBuffer =  first.getContainer( ).data( );
             bolt::cl::device_vector< oType >::pointer ResultBuffer =  result.getContainer( ).data( );
 
-            std::transform(&InputBuffer[ first.m_Index ], &InputBuffer[first.m_Index] + numElements, stdext::make_checked_array_iterator(&ResultBuffer[ result.m_Index], numElements), unary_op);
-            Serial_Scan<oType, BinaryFunction, T>(&ResultBuffer[ result.m_Index  ], &ResultBuffer[ result.m_Index ], numElements, binary_op, inclusive, init);
+            if( inclusive )
+                bolt::btbb::transform_inclusive_scan( &InputBuffer[ first.m_Index ],
+                    &InputBuffer[ first.m_Index ] + numElements, &ResultBuffer[ result.m_Index ], unary_op, binary_op );
+            else
+                bolt::btbb::transform_exclusive_scan( &InputBuffer[ first.m_Index ],
+                    &InputBuffer[ first.m_Index ] + numElements, &ResultBuffer[ result.m_Index ], unary_op, init,
+                    binary_op );
             return result + numElements;
         #else
                 throw std::exception("The MultiCoreCpu version of Transform_scan is not enabled to be built!\n");
@@ -538,6 +572,8 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
     oss << " -DKERNEL0WORKGROUPSIZE=" << kernel0_WgSize;
     oss << " -DKERNEL1WORKGROUPSIZE=" << kernel1_WgSize;
     oss << " -DKERNEL2WORKGROUPSIZE=" << kernel2_WgSize;
+    const cl_uint itemsPerWorkItem = singlePassScanItemsPerWorkItem( ctl, sizeof( oType ), kernel0_WgSize );
+    oss << " -DSCAN_ITEMS_PER_WORKITEM=" << itemsPerWorkItem;
     compileOptions = oss.str();
 
     /**********************************************************************************
@@ -549,7 +585,7 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
         typeNames,
         &ts_kts,
         typeDefinitions,
-        transform_scan_kernels,
+        lookback_kernels + transform_scan_kernels,
         compileOptions);
     // kernels returned in same order as added in KernelTemplaceSpecializer constructor
 
@@ -561,28 +597,21 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
     int wgPerComputeUnit =  ctl.getWGPerComputeUnit( );
     int resultCnt = computeUnits * wgPerComputeUnit;
 
-    //  Ceiling function to bump the size of input to the next whole wavefront size
     cl_uint numElements = static_cast< cl_uint >( std::distance( first, last ) );
-    device_vector< iType >::size_type sizeInputBuff = numElements;
-    size_t modWgSize = (sizeInputBuff & (kernel0_WgSize-1));
-    if( modWgSize )
-    {
-        sizeInputBuff &= ~modWgSize;
-        sizeInputBuff += kernel0_WgSize;
-    }
-    cl_uint numWorkGroupsK0 = static_cast< cl_uint >( sizeInputBuff / kernel0_WgSize );
-
+    const size_t tileSize = kernel0_WgSize * itemsPerWorkItem;
+    cl_uint numTiles = static_cast< cl_uint >( ( numElements + tileSize - 1 ) / tileSize );
 
     //  Ceiling function to bump the size of the sum array to the next whole wavefront size
-    device_vector< oType >::size_type sizeScanBuff = numWorkGroupsK0;
-    modWgSize = (sizeScanBuff & (kernel0_WgSize-1));
+    device_vector< oType >::size_type sizeScanBuff = numTiles;
+    size_t modWgSize = (sizeScanBuff & (kernel1_WgSize-1));
     if( modWgSize )
     {
         sizeScanBuff &= ~modWgSize;
-        sizeScanBuff += kernel0_WgSize;
+        sizeScanBuff += kernel1_WgSize;
     }
 
     // Create buffer wrappers so we can access the host functors, for read or writing in the kernel
+    cl_uint tileLdsSize = static_cast< cl_uint >( tileSize * sizeof( oType ) );
     ALIGNED( 256 ) UnaryFunction aligned_unary_op( unary_op );
     control::buffPointer unaryBuffer = ctl.acquireBuffer( sizeof( aligned_unary_op ),
         CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_unary_op);
@@ -590,10 +619,60 @@ size_t k0_stepNum, k1_stepNum, k2_stepNum;
     control::buffPointer binaryBuffer = ctl.acquireBuffer( sizeof( aligned_binary_op ),
         CL_MEM_USE_HOST_PTR|CL_MEM_READ_ONLY, &aligned_binary_op );
 
+    if( supportsSinglePassScan( ctl ) )
+    {
+        /**********************************************************************************
+         *  Single-pass implementation: the tiles chain their prefixes through a decoupled
+         *  look-back, so the input is read once and the output written once
+         *********************************************************************************/
+        ::cl::Event fillEvent, singlePassEvent;
+        size_t tileWords = ( sizeof( oType ) + sizeof( cl_uint ) - 1 ) / sizeof( cl_uint );
+
+        control::buffPointer tileStatus = ctl.acquireBuffer( ( numTiles + 1 ) * sizeof( cl_uint ) );
+        control::buffPointer tileValues = ctl.acquireBuffer( 2 * numTiles * tileWords * sizeof( cl_uint ) );
+        l_Error = ctl.getCommandQueue( ).enqueueFillBuffer( *tileStatus, 0, 0, ( numTiles + 1 ) * sizeof( cl_uint ),
+            NULL, &fillEvent );
+        V_OPENCL( l_Error, "enqueueFillBuffer() failed for the transform_scan tile status" );
+
+        V_OPENCL( kernels[3].setArg( 0, result.getContainer().getBuffer() ), "Error setArg kernels[ 3 ]" ); // Output buffer
+        V_OPENCL( kernels[3].setArg( 1, result.gpuPayloadSize( ), &result.gpuPayload()),"Error setting a kernel argument");
+        V_OPENCL( kernels[3].setArg( 2, first.getContainer().getBuffer() ),  "Error setArg kernels[ 3 ]" ); // Input buffer
+        V_OPENCL( kernels[3].setArg( 3, first.gpuPayloadSize( ), &first.gpuPayload( ) ),"Error setting a kernel argument");
+        V_OPENCL( kernels[3].setArg( 4, init_T ),               "Error setArg kernels[ 3 ]" ); // Initial value exclusive
+        V_OPENCL( kernels[3].setArg( 5, numElements ),          "Error setArg kernels[ 3 ]" ); // Number of elements
+        V_OPENCL( kernels[3].setArg( 6, tileLdsSize, NULL ),    "Error setArg kernels[ 3 ]" ); // Scratch buffer
+        V_OPENCL( kernels[3].setArg( 7, *unaryBuffer ),         "Error setArg kernels[ 3 ]" ); // User provided functor
+        V_OPENCL( kernels[3].setArg( 8, *binaryBuffer ),        "Error setArg kernels[ 3 ]" ); // User provided functor
+        V_OPENCL( kernels[3].setArg( 9, *tileStatus ),          "Error setArg kernels[ 3 ]" ); // Tile counter and states
+        V_OPENCL( kernels[3].setArg( 10, *tileValues ),         "Error setArg kernels[ 3 ]" ); // Tile aggregates and prefixes
+        V_OPENCL( kernels[3].setArg( 11, doExclusiveScan ),     "Error setArg kernels[ 3 ]" ); // Exclusive scan?
+
+        std::vector< ::cl::Event > fillEvents( 1, fillEvent );
+        l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
+            kernels[3],
+            ::cl::NullRange,
+            ::cl::NDRange( numTiles * kernel0_WgSize ),
+            ::cl::NDRange( kernel0_WgSize ),
+            &fillEvents,
+            &singlePassEvent );
+        V_OPENCL( l_Error, "enqueueNDRangeKernel() failed for kernel[3]" );
+
+        l_Error = singlePassEvent.wait( );
+        V_OPENCL( l_Error, "post-kernel[3] failed wait" );
+#ifdef BOLT_ENABLE_PROFILING
+aProfiler.stopTrial();
+#endif
+        return;
+    }
+
 
+    /**********************************************************************************
+     *  Reduce-then-scan: kernel 0 reduces every tile, kernel 1 scans the tile sums and
+     *  kernel 2 transforms and scans every tile again on top of the sum of the tiles
+     *  before it.  The input is read twice and the output written once.
+     *********************************************************************************/
     control::buffPointer preSumArray  = ctl.acquireBuffer( sizeScanBuff*sizeof( oType ) );
     control::buffPointer postSumArray = ctl.acquireBuffer( sizeScanBuff*sizeof( oType ) );
-    cl_uint ldsSize;
 
 
     /**********************************************************************************
@@ -608,20 +687,15 @@ aProfiler.setStepName("Setup Kernel 0");
 aProfiler.set(AsyncProfiler::device, control::SerialCpu);
 #endif
 
-    ldsSize  = static_cast< cl_uint >( kernel0_WgSize * sizeof( oType ) );
-
-    V_OPENCL( kernels[0].setArg( 0, result.getContainer().getBuffer() ), "Error setArg kernels[ 0 ]" ); // Output buffer
-    V_OPENCL( kernels[0].setArg( 1, result.gpuPayloadSize( ), &result.gpuPayload()),"Error setting a kernel argument");
-    V_OPENCL( kernels[0].setArg( 2, first.getContainer().getBuffer() ),  "Error setArg kernels[ 0 ]" ); // Input buffer
-    V_OPENCL( kernels[0].setArg( 3, first.gpuPayloadSize( ), &first.gpuPayload( ) ),"Error setting a kernel argument");
-    V_OPENCL( kernels[0].setArg( 4, init_T ),               "Error setArg kernels[ 0 ]" ); // Initial value exclusive
-    V_OPENCL( kernels[0].setArg( 5, numElements ),          "Error setArg kernels[ 0 ]" ); // Size of scratch buffer
-    V_OPENCL( kernels[0].setArg( 6, ldsSize, NULL ),        "Error setArg kernels[ 0 ]" ); // Scratch buffer
-    V_OPENCL( kernels[0].setArg( 7, *unaryBuffer ),         "Error setArg kernels[ 0 ]" ); // User provided functor
-    V_OPENCL( kernels[0].setArg( 8, *binaryBuffer ),        "Error setArg kernels[ 0 ]" ); // User provided functor
-    V_OPENCL( kernels[0].setArg( 9, *preSumArray ),         "Error setArg kernels[ 0 ]" ); // Output per block sum
-
-    V_OPENCL( kernels[0].setArg( 10, doExclusiveScan ),     "Error setArg kernels[ 0 ]" ); // Exclusive scan?
+    V_OPENCL( kernels[0].setArg( 0, first.getContainer().getBuffer() ),  "Error setArg kernels[ 0 ]" ); // Input buffer
+    V_OPENCL( kernels[0].setArg( 1, first.gpuPayloadSize( ), &first.gpuPayload( ) ),"Error setting a kernel argument");
+    V_OPENCL( kernels[0].setArg( 2, init_T ),               "Error setArg kernels[ 0 ]" ); // Initial value exclusive
+    V_OPENCL( kernels[0].setArg( 3, numElements ),          "Error setArg kernels[ 0 ]" ); // Number of elements
+    V_OPENCL( kernels[0].setArg( 4, tileLdsSize, NULL ),    "Error setArg kernels[ 0 ]" ); // Scratch buffer
+    V_OPENCL( kernels[0].setArg( 5, *unaryBuffer ),         "Error setArg kernels[ 0 ]" ); // User provided functor
+    V_OPENCL( kernels[0].setArg( 6, *binaryBuffer ),        "Error setArg kernels[ 0 ]" ); // User provided functor
+    V_OPENCL( kernels[0].setArg( 7, *preSumArray ),         "Error setArg kernels[ 0 ]" ); // Output per tile sum
+    V_OPENCL( kernels[0].setArg( 8, doExclusiveScan ),      "Error setArg kernels[ 0 ]" ); // Exclusive scan?
 
 
 #ifdef BOLT_ENABLE_PROFILING
@@ -630,13 +704,13 @@ k0_stepNum = aProfiler.getStepNum();
 aProfiler.setStepName("Kernel 0");
 aProfiler.set(AsyncProfiler::device, ctl.getForceRunMode());
 aProfiler.set(AsyncProfiler::flops, 2*numElements);
-aProfiler.set(AsyncProfiler::memory, 2*numElements*sizeof(iType) + 1*sizeScanBuff*sizeof(oType));
+aProfiler.set(AsyncProfiler::memory, 1*numElements*sizeof(iType) + 1*numTiles*sizeof(oType));
 #endif
 
     l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
         kernels[0],
         ::cl::NullRange,
-        ::cl::NDRange( sizeInputBuff ),
+        ::cl::NDRange( numTiles * kernel0_WgSize ),
         ::cl::NDRange( kernel0_WgSize ),
         NULL,
         &kernel0Event);
@@ -663,8 +737,9 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
     cl_uint workPerThread = static_cast< cl_uint >( sizeScanBuff / kernel1_WgSize );
     V_OPENCL( kernels[1].setArg( 0, *postSumArray ),        "Error setArg kernels[ 1 ]" ); // Output buffer
     V_OPENCL( kernels[1].setArg( 1, *preSumArray ),         "Error setArg kernels[ 1 ]" ); // Input buffer
-    V_OPENCL( kernels[1].setArg( 2, numWorkGroupsK0 ),      "Error setArg kernels[ 1 ]" ); // Size of scratch buffer
-    V_OPENCL( kernels[1].setArg( 3, ldsSize, NULL ),        "Error setArg kernels[ 1 ]" ); // Scratch buffer
+    V_OPENCL( kernels[1].setArg( 2, numTiles ),             "Error setArg kernels[ 1 ]" ); // Size of scratch buffer
+    V_OPENCL( kernels[1].setArg( 3, static_cast< cl_uint >( kernel1_WgSize * sizeof( oType ) ), NULL ),
+        "Error setArg kernels[ 1 ]" ); // Scratch buffer
     V_OPENCL( kernels[1].setArg( 4, workPerThread ),        "Error setArg kernels[ 1 ]" ); // User provided functor
     V_OPENCL( kernels[1].setArg( 5, *binaryBuffer ),        "Error setArg kernels[ 1 ]" ); // User provided functor
 
@@ -700,24 +775,29 @@ aProfiler.set(AsyncProfiler::device, control::SerialCpu);
 
     V_OPENCL( kernels[2].setArg( 0, result.getContainer().getBuffer()),   "Error setArg kernels[ 2 ]" ); // Output buffer
     V_OPENCL( kernels[2].setArg( 1, result.gpuPayloadSize( ), &result.gpuPayload()),"Error setting a kernel argument");
-
-    V_OPENCL( kernels[2].setArg( 2, *postSumArray ),        "Error setArg kernels[ 2 ]" ); // Input buffer
-    V_OPENCL( kernels[2].setArg( 3, numElements ),          "Error setArg kernels[ 2 ]" ); // Size of scratch buffer
-    V_OPENCL( kernels[2].setArg( 4, *binaryBuffer ),        "Error setArg kernels[ 2 ]" ); // User provided functor
+    V_OPENCL( kernels[2].setArg( 2, first.getContainer().getBuffer() ),  "Error setArg kernels[ 2 ]" ); // Input buffer
+    V_OPENCL( kernels[2].setArg( 3, first.gpuPayloadSize( ), &first.gpuPayload( ) ),"Error setting a kernel argument");
+    V_OPENCL( kernels[2].setArg( 4, init_T ),               "Error setArg kernels[ 2 ]" ); // Initial value exclusive
+    V_OPENCL( kernels[2].setArg( 5, numElements ),          "Error setArg kernels[ 2 ]" ); // Number of elements
+    V_OPENCL( kernels[2].setArg( 6, tileLdsSize, NULL ),    "Error setArg kernels[ 2 ]" ); // Scratch buffer
+    V_OPENCL( kernels[2].setArg( 7, *unaryBuffer ),         "Error setArg kernels[ 2 ]" ); // User provided functor
+    V_OPENCL( kernels[2].setArg( 8, *binaryBuffer ),        "Error setArg kernels[ 2 ]" ); // User provided functor
+    V_OPENCL( kernels[2].setArg( 9, *postSumArray ),        "Error setArg kernels[ 2 ]" ); // Scanned tile sums
+    V_OPENCL( kernels[2].setArg( 10, doExclusiveScan ),     "Error setArg kernels[ 2 ]" ); // Exclusive scan?
 
 #ifdef BOLT_ENABLE_PROFILING
 aProfiler.nextStep();
 k2_stepNum = aProfiler.getStepNum();
 aProfiler.setStepName("Kernel 2");
 aProfiler.set(AsyncProfiler::device, ctl.getForceRunMode());
-aProfiler.set(AsyncProfiler::flops, numElements);
-aProfiler.set(AsyncProfiler::memory, 2*numElements*sizeof(oType) + 1*sizeScanBuff*sizeof(oType));
+aProfiler.set(AsyncProfiler::flops, 2*numElements);
+aProfiler.set(AsyncProfiler::memory, 1*numElements*sizeof(iType) + 1*numElements*sizeof(oType) + 1*numTiles*sizeof(oType));
 #endif
 
     l_Error = ctl.getCommandQueue( ).enqueueNDRangeKernel(
         kernels[2],
         ::cl::NullRange,
-        ::cl::NDRange( sizeInputBuff ),
+        ::cl::NDRange( numTiles * kernel2_WgSize ),
         ::cl::NDRange( kernel2_WgSize ),
         NULL,
         &kernel2Event );
@@ -0,0 +1,143 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_DEVICE_SCALAR_H )
+#define BOLT_CL_DEVICE_SCALAR_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/device_vector.h"
+
+/*! \file bolt/cl/device_scalar.h
+    \brief A single value that lives in device memory.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup Containers
+         */
+
+        /*! \addtogroup CL-Device
+        *   \ingroup Containers
+        */
+
+        /*! \brief A device_scalar holds the result of a reduction in device memory.
+        *   \ingroup Device
+        *   \details The reduction algorithms return their result by value, which means that the partial results have
+        *   to be read back and finished on the host, and the command queue has to drain before the caller can continue.
+        *   The overloads of \p reduce, \p transform_reduce, \p count_if and \p inner_product that take a
+        *   device_scalar finish the reduction on the device instead, and only enqueue work.  The value is read back
+        *   when get( ) is called.
+        *
+        *   Its iterators are device_vector iterators to a range of one element, so that the value can be consumed by
+        *   any other Bolt algorithm without a round-trip through the host.
+        *
+        *   \code
+        *   #include <bolt/cl/reduce.h>
+        *   #include <bolt/cl/device_scalar.h>
+        *
+        *   bolt::cl::device_vector< int > input( 1024 );
+        *   ...
+        *   bolt::cl::device_scalar< int > sum;
+        *   bolt::cl::reduce( input.begin( ), input.end( ), 0, bolt::cl::plus< int >( ), sum );
+        *   // sum.begin( ), sum.end( ) can feed the next algorithm; sum.get( ) waits for the result.
+        *   \endcode
+        */
+        template< typename T >
+        class device_scalar
+        {
+        public:
+            typedef T value_type;
+            typedef typename device_vector< T >::iterator iterator;
+            typedef typename device_vector< T >::const_iterator const_iterator;
+
+            /*! \brief Allocates the scalar on the device of \p ctl and initializes it to T( ).
+            */
+            device_scalar( const control& ctl = control::getDefault( ) ):
+                m_Storage( 1, T( ), CL_MEM_READ_WRITE, true, ctl ), m_commQueue( ctl.getCommandQueue( ) )
+            {
+            }
+
+            /*! \brief Allocates the scalar on the device of \p ctl and initializes it to \p value.
+            */
+            explicit device_scalar( const T& value, const control& ctl = control::getDefault( ) ):
+                m_Storage( 1, value, CL_MEM_READ_WRITE, true, ctl ), m_commQueue( ctl.getCommandQueue( ) )
+            {
+            }
+
+            /*! \brief Reads the value back to the host.  This blocks until all the work enqueued before it on the
+            *   command queue of the scalar is complete.
+            */
+            T get( ) const
+            {
+                T value;
+                V_OPENCL( m_commQueue.enqueueReadBuffer( m_Storage.getBuffer( ), CL_TRUE, 0, sizeof( T ), &value ),
+                    "device_scalar failed to read the value back to the host" );
+                return value;
+            }
+
+            /*! \brief Writes \p value to the device.  The write is complete when this returns.
+            */
+            void set( const T& value )
+            {
+                V_OPENCL( m_commQueue.enqueueWriteBuffer( m_Storage.getBuffer( ), CL_TRUE, 0, sizeof( T ), &value ),
+                    "device_scalar failed to write the value to the device" );
+            }
+
+            iterator begin( )
+            {
+                return m_Storage.begin( );
+            }
+
+            const_iterator begin( ) const
+            {
+                return m_Storage.begin( );
+            }
+
+            iterator end( )
+            {
+                return m_Storage.end( );
+            }
+
+            const_iterator end( ) const
+            {
+                return m_Storage.end( );
+            }
+
+            /*! \brief Returns the one element buffer that holds the value, so that library functions can set it as a
+            *   kernel argument.
+            */
+            const ::cl::Buffer& getBuffer( ) const
+            {
+                return m_Storage.getBuffer( );
+            }
+
+            ::cl::Buffer& getBuffer( )
+            {
+                return m_Storage.getBuffer( );
+            }
+
+        private:
+            device_vector< T > m_Storage;
+            ::cl::CommandQueue m_commQueue;
+        };
+
+    }
+}
+
+#endif
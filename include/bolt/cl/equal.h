@@ -0,0 +1,98 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_EQUAL_H )
+#define BOLT_CL_EQUAL_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/mismatch.h"
+
+#include <string>
+
+/*! \file bolt/cl/equal.h
+    \brief Tests whether two sequences are equal, stopping at the first difference.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup searching
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-equal
+        *   \ingroup searching
+        *   \{
+        *   \details equal runs the search of mismatch, but any difference settles it, so every work-group and every
+        *   TBB task stops as soon as one of them has found a difference.
+        */
+
+        /*! \brief \p equal returns true if every element of [first1, last1) matches the element at the same
+        * position of the sequence that starts at \p first2.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first1 The beginning of the first sequence.
+        * \param last1  The end of the first sequence.
+        * \param first2 The beginning of the second sequence; it holds at least last1 - first1 elements.
+        * \param predicate \b Optional The binary predicate that tells whether two elements match; equal_to by
+        * default.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return true if all the pairs of elements match, and for an empty range.
+        *
+        * \sa http://www.sgi.com/tech/stl/equal.html
+        */
+        template<typename InputIterator1, typename InputIterator2>
+        bool equal(control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2>
+        bool equal(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+        bool equal(control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            BinaryPredicate predicate,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+        bool equal(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            BinaryPredicate predicate,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/equal.inl>
+
+#endif
@@ -0,0 +1,138 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_FIND_H )
+#define BOLT_CL_FIND_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+
+#include <string>
+
+/*! \file bolt/cl/find.h
+    \brief Finds the first element that equals a value or satisfies a predicate, stopping early once it is known.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup searching
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-find
+        *   \ingroup searching
+        *   \{
+        *   \details Counting the matches with count_if always reads the whole input.  The searches read it in tiles
+        *   instead: on the OpenCL path the work-groups publish the tile of their first match and skip every tile
+        *   past a published one, and on the MultiCoreCpu path the TBB tasks skip the chunks past a known match.
+        *   When the match is close to the beginning, only a fraction of the input is read.
+        */
+
+        /*! \brief \p find returns the first position in [first, last) whose element equals \p value.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the input sequence.
+        * \param last  The end of the input sequence.
+        * \param value The value to search for.  It is converted to the value type of \p InputIterator, which must be
+        * comparable with operator== on the host and on the device.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return The first position whose element equals \p value, or \p last if there is none.
+        *
+        * \details The following code example finds the first 42.
+        * \code
+        * #include <bolt/cl/find.h>
+        *
+        * int a[ 8 ] = { 7, 42, 3, 42, 5, 6, 0, 1 };
+        *
+        * int* position = bolt::cl::find( a, a + 8, 42 );
+        * // position => a + 1
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/find.html
+        */
+        template<typename InputIterator, typename EqualityComparable>
+        InputIterator find(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            const EqualityComparable& value,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename EqualityComparable>
+        InputIterator find(InputIterator first,
+            InputIterator last,
+            const EqualityComparable& value,
+            const std::string& cl_code="");
+
+        /*! \brief \p find_if returns the first position in [first, last) for which \p predicate is true.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the input sequence.
+        * \param last  The end of the input sequence.
+        * \param predicate A unary predicate, registered with BOLT_FUNCTOR so that it can be called on the device.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return The first position for which \p predicate is true, or \p last if there is none.
+        *
+        * \sa http://www.sgi.com/tech/stl/find_if.html
+        */
+        template<typename InputIterator, typename Predicate>
+        InputIterator find_if(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename Predicate>
+        InputIterator find_if(InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        /*! \brief \p find_if_not returns the first position in [first, last) for which \p predicate is false.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the input sequence.
+        * \param last  The end of the input sequence.
+        * \param predicate A unary predicate, registered with BOLT_FUNCTOR so that it can be called on the device.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return The first position for which \p predicate is false, or \p last if there is none.
+        */
+        template<typename InputIterator, typename Predicate>
+        InputIterator find_if_not(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename Predicate>
+        InputIterator find_if_not(InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/find.inl>
+
+#endif
@@ -0,0 +1,186 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Searches for the first element that matches, tile by tile.  Every work-group walks its tiles in increasing order
+//  and stops at its first match; the tile of a match is also published in stopTile, and the work-groups check it
+//  before every tile, so nobody scans past a match that is already known.  stopTile is written without atomics: a
+//  stale or overwritten value only costs some extra tiles, because every value ever written is the tile of a match.
+//  The host takes the smallest of the per work-group results.  When any match will do, a work-group stops as soon as
+//  some tile has published one.
+
+//#pragma OPENCL EXTENSION cl_amd_printf : enable
+
+template< typename Matcher >
+void findFirstInTiles(
+    Matcher matcher,
+    const int anyMatch,
+    const uint length,
+    volatile global int* stopTile,
+    global int* groupResults,
+    local int* scratch
+)
+{
+    uint localId = get_local_id( 0 );
+    uint wgSize = get_local_size( 0 );
+    uint tileSize = wgSize * FIND_ITEMS_PER_WORKITEM;
+    uint numTiles = ( length + tileSize - 1 ) / tileSize;
+    int groupResult = length;
+
+    //  scratch holds one index per work-item, followed by the stop flag of the work-group
+    for( uint tile = get_group_id( 0 ); tile < numTiles; tile += get_num_groups( 0 ) )
+    {
+        if( localId == 0 )
+            scratch[ wgSize ] = anyMatch ? ( *stopTile < ( int )numTiles ) : ( ( int )tile > *stopTile );
+        barrier( CLK_LOCAL_MEM_FENCE );
+        if( scratch[ wgSize ] )
+            break;
+
+        //  A work-item visits its elements in increasing order, so its first match is its smallest one
+        int first = length;
+        uint index = tile * tileSize + localId;
+        for( uint k = 0; k < FIND_ITEMS_PER_WORKITEM; ++k, index += wgSize )
+        {
+            if( ( first == ( int )length ) && ( index < length ) && matcher.matches( index ) )
+                first = index;
+        }
+
+        scratch[ localId ] = first;
+        barrier( CLK_LOCAL_MEM_FENCE );
+        for( uint width = wgSize / 2; width > 0; width /= 2 )
+        {
+            if( localId < width )
+                scratch[ localId ] = min( scratch[ localId ], scratch[ localId + width ] );
+            barrier( CLK_LOCAL_MEM_FENCE );
+        }
+        int tileFirst = scratch[ 0 ];
+        barrier( CLK_LOCAL_MEM_FENCE );
+
+        if( tileFirst < ( int )length )
+        {
+            groupResult = tileFirst;
+            if( ( localId == 0 ) && ( ( int )tile < *stopTile ) )
+                *stopTile = tile;
+            break;
+        }
+    }
+
+    if( localId == 0 )
+        groupResults[ get_group_id( 0 ) ] = groupResult;
+}
+
+//  Matches the elements for which the predicate returns expected; expected is 0 for find_if_not and all_of
+template< typename iIterType, typename predicate >
+struct findPredicateMatcher
+{
+    iIterType input_iter;
+    global predicate* userFunctor;
+    int expected;
+
+    bool matches( uint index )
+    {
+        return ( ( *userFunctor )( input_iter[ index ] ) ? 1 : 0 ) == expected;
+    }
+};
+
+template< typename iType, typename iIterType >
+struct findValueMatcher
+{
+    iIterType input_iter;
+    iType value;
+
+    bool matches( uint index )
+    {
+        return input_iter[ index ] == value;
+    }
+};
+
+template< typename iIterType1, typename iIterType2, typename binary_predicate >
+struct mismatchMatcher
+{
+    iIterType1 input_iter1;
+    iIterType2 input_iter2;
+    global binary_predicate* userFunctor;
+
+    bool matches( uint index )
+    {
+        return !( *userFunctor )( input_iter1[ index ], input_iter2[ index ] );
+    }
+};
+
+template< typename iType, typename iIterType, typename predicate >
+kernel void findIfTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    global predicate* userFunctor,
+    const int expected,
+    const int anyMatch,
+    const uint length,
+    volatile global int* stopTile,
+    global int* groupResults,
+    local int* scratch
+)
+{
+    input_iter.init( input_ptr );
+
+    findPredicateMatcher< iIterType, predicate > matcher;
+    matcher.input_iter = input_iter;
+    matcher.userFunctor = userFunctor;
+    matcher.expected = expected;
+    findFirstInTiles( matcher, anyMatch, length, stopTile, groupResults, scratch );
+}
+
+template< typename iType, typename iIterType >
+kernel void findValueTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const iType value,
+    const uint length,
+    volatile global int* stopTile,
+    global int* groupResults,
+    local int* scratch
+)
+{
+    input_iter.init( input_ptr );
+
+    findValueMatcher< iType, iIterType > matcher;
+    matcher.input_iter = input_iter;
+    matcher.value = value;
+    findFirstInTiles( matcher, 0, length, stopTile, groupResults, scratch );
+}
+
+template< typename iType1, typename iIterType1, typename iType2, typename iIterType2, typename binary_predicate >
+kernel void mismatchTemplate(
+    global iType1* input_ptr1,
+    iIterType1 input_iter1,
+    global iType2* input_ptr2,
+    iIterType2 input_iter2,
+    global binary_predicate* userFunctor,
+    const uint length,
+    volatile global int* stopTile,
+    global int* groupResults,
+    local int* scratch
+)
+{
+    input_iter1.init( input_ptr1 );
+    input_iter2.init( input_ptr2 );
+
+    mismatchMatcher< iIterType1, iIterType2, binary_predicate > matcher;
+    matcher.input_iter1 = input_iter1;
+    matcher.input_iter2 = input_iter2;
+    matcher.userFunctor = userFunctor;
+    findFirstInTiles( matcher, 0, length, stopTile, groupResults, scratch );
+}
@@ -0,0 +1,149 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_HISTOGRAM_H )
+#define BOLT_CL_HISTOGRAM_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/device_vector.h"
+
+#include <string>
+
+/*! \file bolt/cl/histogram.h
+    \brief Counts the elements of a range that fall in each bin of a histogram.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-histogram
+        *   \ingroup reductions
+        *   \{
+        *   \details Every work-group counts into its own sub-histogram in local memory, and the sub-histograms are
+        *   merged once the input has been read, so the input pass never contends on global counters.  When the
+        *   bins do not fit in local memory, the input pass increments the global counts with atomics instead.  The
+        *   MultiCoreCpu path counts into one copy of the bins per thread.
+        */
+
+        /*! \brief \p histogram counts, for every bin b of [bins_first, bins_last), the elements of [first, last)
+        * that are equal to b.  Elements that are negative, or not smaller than the number of bins, are not
+        * counted.  The counts overwrite the output range.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The first position in the sequence of bin numbers.
+        * \param last  The last position in the sequence of bin numbers.
+        * \param bins_first The first position in the sequence of counts.
+        * \param bins_last  The last position in the sequence of counts.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, whose value type
+        * is an integer type.
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, whose value type
+        * is int or unsigned int.
+        *
+        * \details The following code example counts the digits of a sequence.
+        * \code
+        * #include <bolt/cl/histogram.h>
+        *
+        * int a[ 8 ] = { 3, 1, 4, 1, 5, 9, 2, 6 };
+        * unsigned int counts[ 10 ];
+        *
+        * bolt::cl::histogram( a, a + 8, counts, counts + 10 );
+        * // counts => { 0, 2, 1, 1, 1, 1, 1, 0, 0, 1 }
+        *  \endcode
+        */
+        template<typename InputIterator, typename OutputIterator>
+        void histogram(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OutputIterator bins_first,
+            OutputIterator bins_last,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OutputIterator>
+        void histogram(InputIterator first,
+            InputIterator last,
+            OutputIterator bins_first,
+            OutputIterator bins_last,
+            const std::string& cl_code="");
+
+        /*! \brief \p histogram_even splits [lower, upper) into as many bins of equal width as there are elements in
+        * [bins_first, bins_last), and counts the elements of [first, last) that fall in each of them.  Elements
+        * outside [lower, upper) are not counted.  The counts overwrite the output range.
+        *
+        * \details The bin of an element x is ( x - lower ) * scale rounded towards zero, where scale is the number
+        * of bins divided by ( upper - lower ).  The product is computed in double for double elements and in float
+        * otherwise, the same way on every path, so elements close to a bin edge land in the same bin on the device
+        * and on the CPU.  For integer elements, upper - lower must be representable in the element type.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The first position in the sequence.
+        * \param last  The last position in the sequence.
+        * \param lower The lower edge of the first bin.
+        * \param upper The upper edge of the last bin.
+        * \param bins_first The first position in the sequence of counts.
+        * \param bins_last  The last position in the sequence of counts.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, whose value type
+        * is int, unsigned int, float or double.
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, whose value type
+        * is int or unsigned int.
+        *
+        * \details The following code example counts samples in 4 bins covering [0, 1).
+        * \code
+        * #include <bolt/cl/histogram.h>
+        *
+        * bolt::cl::device_vector< float > samples( 1 << 20 );
+        * bolt::cl::device_vector< unsigned int > counts( 4 );
+        * ...
+        * bolt::cl::histogram_even( samples.begin( ), samples.end( ), 0.0f, 1.0f, counts.begin( ), counts.end( ) );
+        *  \endcode
+        */
+        template<typename InputIterator, typename OutputIterator>
+        void histogram_even(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            typename std::iterator_traits< InputIterator >::value_type lower,
+            typename std::iterator_traits< InputIterator >::value_type upper,
+            OutputIterator bins_first,
+            OutputIterator bins_last,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OutputIterator>
+        void histogram_even(InputIterator first,
+            InputIterator last,
+            typename std::iterator_traits< InputIterator >::value_type lower,
+            typename std::iterator_traits< InputIterator >::value_type upper,
+            OutputIterator bins_first,
+            OutputIterator bins_last,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/histogram.inl>
+
+#endif
@@ -0,0 +1,117 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Histograms count into a sub-histogram per work-group held in LDS, so the atomics of the input pass stay on chip;
+//  the sub-histograms are then either added to the global counts with one atomic per non-empty bin, or written out
+//  and summed per bin by a second kernel on devices without global atomics.  When the bins do not fit in LDS, the
+//  input pass increments the global counts directly.
+
+// #pragma OPENCL EXTENSION cl_amd_printf : enable
+
+//  Bin of an element: the element itself for histogram, or its position between lower and upper for histogram_even.
+//  Elements outside the bins map onto numBins.
+template< typename iType, typename scaleType >
+inline uint histogramBin( iType value, int even, iType lower, iType upper, scaleType scale, uint numBins )
+{
+    if( !even )
+        return ( uint )value;
+    if( !( lower <= value && value < upper ) )
+        return numBins;
+    uint bin = ( uint )( ( scaleType )( value - lower ) * scale );
+    return min( bin, numBins - 1 );
+}
+
+template< typename iType, typename iIterType, typename scaleType >
+kernel void histogramLocalTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const uint length,
+    const uint numBins,
+    const int even,
+    const iType lower,
+    const iType upper,
+    const scaleType scale,
+    const int useAtomics,
+    global uint* counts,
+    global uint* partials,
+    local uint* ldsBins )
+{
+    input_iter.init( input_ptr );
+    uint localId = get_local_id( 0 );
+    uint localSize = get_local_size( 0 );
+
+    for( uint bin = localId; bin < numBins; bin += localSize )
+        ldsBins[ bin ] = 0;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint index = get_global_id( 0 ); index < length; index += get_global_size( 0 ) )
+    {
+        uint bin = histogramBin( input_iter[ index ], even, lower, upper, scale, numBins );
+        if( bin < numBins )
+            atomic_inc( &ldsBins[ bin ] );
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    global uint* groupPartials = partials + get_group_id( 0 ) * numBins;
+    for( uint bin = localId; bin < numBins; bin += localSize )
+    {
+        uint count = ldsBins[ bin ];
+        if( !useAtomics )
+            groupPartials[ bin ] = count;
+        else if( count )
+            atomic_add( &counts[ bin ], count );
+    }
+}
+
+template< typename iType, typename iIterType, typename scaleType >
+kernel void histogramGlobalTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const uint length,
+    const uint numBins,
+    const int even,
+    const iType lower,
+    const iType upper,
+    const scaleType scale,
+    global uint* counts )
+{
+    input_iter.init( input_ptr );
+
+    for( uint index = get_global_id( 0 ); index < length; index += get_global_size( 0 ) )
+    {
+        uint bin = histogramBin( input_iter[ index ], even, lower, upper, scale, numBins );
+        if( bin < numBins )
+            atomic_inc( &counts[ bin ] );
+    }
+}
+
+//  Sums the sub-histograms of the work-groups, one bin per work-item
+template< typename countType >
+kernel void histogramMergeTemplate(
+    global countType* partials,
+    const uint numPartials,
+    const uint numBins,
+    global countType* counts )
+{
+    for( uint bin = get_global_id( 0 ); bin < numBins; bin += get_global_size( 0 ) )
+    {
+        countType count = 0;
+        for( uint p = 0; p < numPartials; ++p )
+            count += partials[ p * numBins + bin ];
+        counts[ bin ] = count;
+    }
+}
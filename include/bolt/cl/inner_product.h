@@ -21,6 +21,7 @@
 
 #include <bolt/cl/bolt.h>
 #include <bolt/cl/device_vector.h>
+#include <bolt/cl/device_scalar.h>
 
 #include <string>
 #include <iostream>
@@ -47,7 +48,8 @@ namespace bolt {
         */
 
         /*! \brief Inner Product returns the inner product of two iterators.
-        * This is similar to calculating binary transform and then reducing the result.
+        * This is similar to calculating binary transform and then reducing the result, except that the products
+        * are combined as they are computed and never stored.
         * The \p inner_product operation is similar the std::inner_product function.
         *  This function can take  optional \p control structure to control command-queue.
         *
@@ -132,6 +134,33 @@ namespace bolt {
         OutputType inner_product( InputIterator first1, InputIterator last1, InputIterator first2, OutputType init,
             BinaryFunction1 f1, BinaryFunction2 f2, const std::string& cl_code="");
 
+        /*! \brief This version of \p inner_product writes the result to a bolt::cl::device_scalar instead of
+        * returning it.  On the OpenCL path the last step of the reduction also runs on the device, and the call
+        * returns as soon as the kernels are enqueued.
+        *
+        * \param ctl    \b Optional Control structure to control command-queue, debug, tuning.
+        * \param first1 The first position in the input sequence.
+        * \param last1  The last position in the input sequence.
+        * \param first2 The beginning of second input sequence.
+        * \param init   The initial value for the accumulator.
+        * \param f1     Binary functor for reduction.
+        * \param f2     Binary functor for transformation.
+        * \param result The scalar that receives the result.  It must have been created on the command queue of
+        *               \p ctl.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \sa bolt::cl::device_scalar
+        */
+        template<typename InputIterator, typename OutputType, typename BinaryFunction1, typename BinaryFunction2>
+        void inner_product( bolt::cl::control &ctl,  InputIterator first1, InputIterator last1,
+            InputIterator first2, OutputType init,
+            BinaryFunction1 f1, BinaryFunction2 f2, device_scalar< OutputType >& result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OutputType, typename BinaryFunction1, typename BinaryFunction2>
+        void inner_product( InputIterator first1, InputIterator last1, InputIterator first2, OutputType init,
+            BinaryFunction1 f1, BinaryFunction2 f2, device_scalar< OutputType >& result,
+            const std::string& cl_code="");
+
         /*!   \}  */
     };
 };
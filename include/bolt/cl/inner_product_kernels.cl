@@ -0,0 +1,78 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  The products are combined as they are computed, so they never go to memory; every work-group leaves one
+//  partial, and the host or reduceFinalTemplate combines the partials with the initial value.
+
+//  The host prepends reduce_kernels.cl to this source for _REDUCE_STEP, which reduces scratch of type T with
+//  userFunctor
+
+template< typename iNakedType, typename iIterType, typename T, typename binary_function1,
+    typename binary_function2 >
+kernel void innerProductTemplate(
+    global iNakedType* input1_ptr,
+    iIterType input1_iter,
+    global iNakedType* input2_ptr,
+    iIterType input2_iter,
+    const int length,
+    global binary_function1* userFunctor,
+    global binary_function2* productFunctor,
+    global T* result,
+    local T* scratch
+)
+{
+    int gx = get_global_id( 0 );
+    input1_iter.init( input1_ptr );
+    input2_iter.init( input2_ptr );
+
+    //  The host launches at most one work-group per 64 elements, so only work-items of the last work-group can
+    //  start past the end; they still take part in the barriers below
+    T accumulator;
+    if( gx < length )
+    {
+        iNakedType a = input1_iter[ gx ];
+        iNakedType b = input2_iter[ gx ];
+        accumulator = (*productFunctor)( a, b );
+        gx += get_global_size( 0 );
+    }
+
+    while( gx < length )
+    {
+        iNakedType a = input1_iter[ gx ];
+        iNakedType b = input2_iter[ gx ];
+        T product = (*productFunctor)( a, b );
+        accumulator = (*userFunctor)( accumulator, product );
+        gx += get_global_size( 0 );
+    }
+
+    int local_index = get_local_id( 0 );
+    scratch[ local_index ] = accumulator;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Tail stops the last workgroup from reading past the end of the input vector
+    uint tail = length - ( get_group_id( 0 ) * get_local_size( 0 ) );
+
+    _REDUCE_STEP( tail, local_index, 32 );
+    _REDUCE_STEP( tail, local_index, 16 );
+    _REDUCE_STEP( tail, local_index,  8 );
+    _REDUCE_STEP( tail, local_index,  4 );
+    _REDUCE_STEP( tail, local_index,  2 );
+    _REDUCE_STEP( tail, local_index,  1 );
+
+    if( local_index == 0 )
+        result[ get_group_id( 0 ) ] = scratch[ 0 ];
+};
@@ -0,0 +1,139 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_LOGICAL_H )
+#define BOLT_CL_LOGICAL_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/find.h"
+
+#include <string>
+
+/*! \file bolt/cl/logical.h
+    \brief Tests a predicate over a range, stopping as soon as the answer is known.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup searching
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-logical
+        *   \ingroup searching
+        *   \{
+        *   \details These tests run the searches of bolt/cl/find.h, but any match settles them, so every
+        *   work-group and every TBB task stops as soon as one of them has found a match.  Replacing
+        *   count_if( ... ) != 0 with any_of avoids reading the whole input when matches are common.
+        */
+
+        /*! \brief \p any_of returns true if \p predicate is true for at least one element of [first, last).
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the input sequence.
+        * \param last  The end of the input sequence.
+        * \param predicate A unary predicate, registered with BOLT_FUNCTOR so that it can be called on the device.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return false for an empty range.
+        *
+        * \details The following code example tests for a negative element.
+        * \code
+        * #include <bolt/cl/logical.h>
+        *
+        * BOLT_FUNCTOR( IsNegative,
+        * struct IsNegative
+        * {
+        *     bool operator( )( const int x ) const { return x < 0; }
+        * };
+        * );
+        *
+        * int a[ 6 ] = { 4, 8, -1, 3, 0, 2 };
+        *
+        * bool negative = bolt::cl::any_of( a, a + 6, IsNegative( ) );
+        * // negative => true
+        *  \endcode
+        */
+        template<typename InputIterator, typename Predicate>
+        bool any_of(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename Predicate>
+        bool any_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        /*! \brief \p all_of returns true if \p predicate is true for every element of [first, last).
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the input sequence.
+        * \param last  The end of the input sequence.
+        * \param predicate A unary predicate, registered with BOLT_FUNCTOR so that it can be called on the device.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return true for an empty range.
+        */
+        template<typename InputIterator, typename Predicate>
+        bool all_of(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename Predicate>
+        bool all_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        /*! \brief \p none_of returns true if \p predicate is false for every element of [first, last).
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the input sequence.
+        * \param last  The end of the input sequence.
+        * \param predicate A unary predicate, registered with BOLT_FUNCTOR so that it can be called on the device.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return true for an empty range.
+        */
+        template<typename InputIterator, typename Predicate>
+        bool none_of(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename Predicate>
+        bool none_of(InputIterator first,
+            InputIterator last,
+            Predicate predicate,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/logical.inl>
+
+#endif
@@ -0,0 +1,114 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+/******************************************************************************
+ *  Decoupled look-back, shared by the single-pass scan kernels
+ *****************************************************************************/
+//  Every work-group takes the next tile from a global counter, so the tiles a work-group waits on belong to
+//  work-groups that are already running.  A tile publishes its aggregate as soon as its local scan is done and its
+//  inclusive prefix once its look-back is done; tileStatus[ 0 ] is the tile counter and tileStatus[ 1 + tile ] the
+//  state of the tile.  tileValues holds two values per tile, the aggregate and the inclusive prefix.
+//
+//  This source is prepended to the kernels that use it, so the memory ordering of the protocol lives in one place.
+#define LOOKBACK_TILE_INVALID   0
+#define LOOKBACK_TILE_AGGREGATE 1
+#define LOOKBACK_TILE_PREFIX    2
+
+//  Tile values are moved a 32-bit word at a time with atomics, so that they never come from a stale cache line,
+//  whatever the size of the user type
+template< typename T >
+union lookBackValue
+{
+    T value;
+    uint words[ ( sizeof( T ) + sizeof( uint ) - 1 ) / sizeof( uint ) ];
+};
+
+template< typename T >
+inline void lookBackStore( global uint* slot, T value )
+{
+    lookBackValue< T > tileValue;
+    tileValue.value = value;
+    for( uint i = 0; i < sizeof( tileValue.words ) / sizeof( uint ); ++i )
+        atomic_xchg( slot + i, tileValue.words[ i ] );
+}
+
+template< typename T >
+inline T lookBackLoad( global uint* slot )
+{
+    lookBackValue< T > tileValue;
+    for( uint i = 0; i < sizeof( tileValue.words ) / sizeof( uint ); ++i )
+        tileValue.words[ i ] = atomic_or( slot + i, 0 );
+    return tileValue.value;
+}
+
+//  Publishes a value of a tile; the value is visible before the state that announces it
+template< typename T >
+inline void lookBackPublish( global uint* tileStatus, global uint* tileValues, uint tile, uint state, T value )
+{
+    const uint words = ( sizeof( T ) + sizeof( uint ) - 1 ) / sizeof( uint );
+    lookBackStore( tileValues + ( 2 * tile + ( state == LOOKBACK_TILE_PREFIX ) ) * words, value );
+    mem_fence( CLK_GLOBAL_MEM_FENCE );
+    atomic_xchg( tileStatus + 1 + tile, state );
+}
+
+//  Combines the values of the preceding tiles, nearest first, until one of them has its inclusive prefix.
+//  combine( earlier, later ) must be associative; it need not be a user functor, so kernels whose carry is more than
+//  one value combine their own structure here.
+template< typename T, typename Combine >
+inline T lookBackCombine( global uint* tileStatus, global uint* tileValues, uint tile, Combine combine )
+{
+    const uint words = ( sizeof( T ) + sizeof( uint ) - 1 ) / sizeof( uint );
+    T prefix;
+    bool hasPrefix = false;
+    uint predecessor = tile - 1;
+    for( ;; )
+    {
+        uint state = atomic_or( tileStatus + 1 + predecessor, 0 );
+        if( state == LOOKBACK_TILE_INVALID )
+            continue;
+        mem_fence( CLK_GLOBAL_MEM_FENCE );
+
+        T value = lookBackLoad< T >( tileValues + ( 2 * predecessor + ( state == LOOKBACK_TILE_PREFIX ) ) * words );
+        prefix = hasPrefix ? combine( value, prefix ) : value;
+        hasPrefix = true;
+        if( state == LOOKBACK_TILE_PREFIX )
+            return prefix;
+        --predecessor;
+    }
+}
+
+//  Adapts a user binary functor, which lives in global memory, to lookBackCombine
+template< typename T, typename BinaryFunction >
+struct lookBackOperator
+{
+    global BinaryFunction* binaryOp;
+
+    T operator( )( T earlier, T later )
+    {
+        return (*binaryOp)( earlier, later );
+    }
+};
+
+//  Prefix of the tiles in front of tile, for kernels whose carry is a single value combined with the user functor
+template< typename T, typename BinaryFunction >
+inline T lookBackPrefix( global uint* tileStatus, global uint* tileValues, uint tile,
+    global BinaryFunction* binaryOp )
+{
+    lookBackOperator< T, BinaryFunction > combine;
+    combine.binaryOp = binaryOp;
+    return lookBackCombine< T >( tileStatus, tileValues, tile, combine );
+}
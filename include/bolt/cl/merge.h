@@ -0,0 +1,256 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_MERGE_H )
+#define BOLT_CL_MERGE_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/pair.h"
+
+#include <string>
+
+/*! \file bolt/cl/merge.h
+    \brief Merges two sorted ranges into one sorted range, optionally moving a value along with every key.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup sorting
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-merge
+        *   \ingroup sorting
+        *   \{
+        *   \details The OpenCL path uses merge path partitioning: the output is cut into tiles of equal size, a
+        *   binary search along the cross diagonal of every tile boundary finds where the tile starts in both inputs,
+        *   and each work-group merges one tile from local memory.  Every work-group does the same amount of work
+        *   however skewed the inputs are.  Both inputs have to share their value type.  The MultiCoreCpu path
+        *   partitions the output the same way into tasks of bolt::btbb.
+        */
+
+        /*! \brief \p merge combines the sorted ranges [first1, last1) and [first2, last2) into one sorted range
+        * beginning at \p result.  The merge is stable: of two equivalent elements, the one from the first range
+        * comes first.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first1 The beginning of the first input sequence.
+        * \param last1  The end of the first input sequence.
+        * \param first2 The beginning of the second input sequence.
+        * \param last2  The end of the second input sequence.
+        * \param result The beginning of the output sequence; it must not overlap either input.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam InputIterator1 Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam InputIterator2 Is a model of http://www.sgi.com/tech/stl/InputIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/OutputIterator.html
+        * \return The end of the output sequence.
+        *
+        * \details The following code example merges two sorted arrays.
+        * \code
+        * #include <bolt/cl/merge.h>
+        *
+        * int a[4] = {1, 3, 5, 7};
+        * int b[4] = {2, 3, 4, 8};
+        * int c[8];
+        *
+        * bolt::cl::merge( a, a+4, b, b+4, c );
+        * // c => {1, 2, 3, 3, 4, 5, 7, 8}
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/merge.html
+        */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator merge(control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+        OutputIterator merge(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        /*! \brief \p merge combines the ranges [first1, last1) and [first2, last2), both sorted by \p comp, into one
+        * range sorted by \p comp beginning at \p result.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first1 The beginning of the first input sequence.
+        * \param last1  The end of the first input sequence.
+        * \param first2 The beginning of the second input sequence.
+        * \param last2  The end of the second input sequence.
+        * \param result The beginning of the output sequence; it must not overlap either input.
+        * \param comp   The comparison operation both inputs are sorted by.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam StrictWeakOrdering Is a model of http://www.sgi.com/tech/stl/StrictWeakOrdering.html.
+        * \return The end of the output sequence.
+        *
+        * \code
+        * #include <bolt/cl/merge.h>
+        *
+        * int a[4] = {7, 5, 3, 1};
+        * int b[4] = {8, 4, 3, 2};
+        * int c[8];
+        *
+        * bolt::cl::merge( a, a+4, b, b+4, c, bolt::cl::greater< int >( ) );
+        * // c => {8, 7, 5, 4, 3, 3, 2, 1}
+        *  \endcode
+        */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator merge(control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator,
+                 typename StrictWeakOrdering>
+        OutputIterator merge(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            InputIterator2 last2,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief \p merge_by_key merges the sorted key ranges [keys_first1, keys_last1) and
+        * [keys_first2, keys_last2) like \p merge, and moves the value associated with every key along with it.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param keys_first1   The beginning of the first key sequence.
+        * \param keys_last1    The end of the first key sequence.
+        * \param keys_first2   The beginning of the second key sequence.
+        * \param keys_last2    The end of the second key sequence.
+        * \param values_first1 The beginning of the values of the first key sequence.
+        * \param values_first2 The beginning of the values of the second key sequence.
+        * \param keys_result   The beginning of the key output sequence.
+        * \param values_result The beginning of the value output sequence.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return A pair holding the ends of the key and value output sequences.
+        *
+        * \code
+        * #include <bolt/cl/merge.h>
+        *
+        * int  keysA[3] = {1, 3, 5};
+        * char valsA[3] = {'a', 'b', 'c'};
+        * int  keysB[3] = {2, 3, 6};
+        * char valsB[3] = {'x', 'y', 'z'};
+        * int  keys[6];
+        * char vals[6];
+        *
+        * bolt::cl::merge_by_key( keysA, keysA+3, keysB, keysB+3, valsA, valsB, keys, vals );
+        * // keys => {1, 2, 3, 3, 5, 6}
+        * // vals => {'a', 'x', 'b', 'y', 'c', 'z'}
+        *  \endcode
+        */
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2>
+        pair<OutputIterator1, OutputIterator2>
+        merge_by_key(control &ctl,
+            InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2>
+        pair<OutputIterator1, OutputIterator2>
+        merge_by_key(InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            const std::string& cl_code="");
+
+        /*! \brief \p merge_by_key merges two key ranges sorted by \p comp, and moves the value associated with every
+        * key along with it.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param keys_first1   The beginning of the first key sequence.
+        * \param keys_last1    The end of the first key sequence.
+        * \param keys_first2   The beginning of the second key sequence.
+        * \param keys_last2    The end of the second key sequence.
+        * \param values_first1 The beginning of the values of the first key sequence.
+        * \param values_first2 The beginning of the values of the second key sequence.
+        * \param keys_result   The beginning of the key output sequence.
+        * \param values_result The beginning of the value output sequence.
+        * \param comp          The comparison operation both key sequences are sorted by.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return A pair holding the ends of the key and value output sequences.
+        */
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2,
+                 typename StrictWeakOrdering>
+        pair<OutputIterator1, OutputIterator2>
+        merge_by_key(control &ctl,
+            InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename InputIterator3,
+                 typename InputIterator4, typename OutputIterator1, typename OutputIterator2,
+                 typename StrictWeakOrdering>
+        pair<OutputIterator1, OutputIterator2>
+        merge_by_key(InputIterator1 keys_first1,
+            InputIterator1 keys_last1,
+            InputIterator2 keys_first2,
+            InputIterator2 keys_last2,
+            InputIterator3 values_first1,
+            InputIterator4 values_first2,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/merge.inl>
+
+#endif
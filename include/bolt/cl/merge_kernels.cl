@@ -0,0 +1,229 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Merge path: the output of merging A and B is cut into tiles of equal size, and a binary search along the
+//  cross diagonal of each tile boundary finds how many elements of A precede it.  Every work-group then merges
+//  exactly one tile, however the values of A and B are distributed.
+
+// #pragma OPENCL EXTENSION cl_amd_printf : enable
+
+//  Number of elements of A among the first diagonal elements of the merged tile held in lds.  Ties go to A, which
+//  keeps the merge stable.
+template< typename kType, typename StrictWeakOrdering >
+uint mergePathSplitLocal(
+    local kType* a,
+    const uint aLength,
+    local kType* b,
+    const uint bLength,
+    const uint diagonal,
+    global StrictWeakOrdering* lessOp )
+{
+    uint low = ( diagonal > bLength ) ? diagonal - bLength : 0;
+    uint high = min( diagonal, aLength );
+    while( low < high )
+    {
+        uint mid = low + ( high - low ) / 2;
+        kType aKey = a[ mid ];
+        kType bKey = b[ diagonal - 1 - mid ];
+        if( !( *lessOp )( bKey, aKey ) )
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+//  One work-item per tile boundary; splits[ i ] is the number of elements of A merged in front of tile i
+template< typename kType, typename kIterType1, typename kIterType2, typename StrictWeakOrdering >
+kernel void mergePartitionTemplate(
+    global kType* A_ptr,
+    kIterType1 A_iter,
+    const uint aLength,
+    global kType* B_ptr,
+    kIterType2 B_iter,
+    const uint bLength,
+    const uint tileSize,
+    const uint numBoundaries,
+    global uint* splits,
+    global StrictWeakOrdering* lessOp )
+{
+    uint boundary = get_global_id( 0 );
+    if( boundary >= numBoundaries )
+        return;
+
+    A_iter.init( A_ptr );
+    B_iter.init( B_ptr );
+
+    uint diagonal = min( boundary * tileSize, aLength + bLength );
+    uint low = ( diagonal > bLength ) ? diagonal - bLength : 0;
+    uint high = min( diagonal, aLength );
+    while( low < high )
+    {
+        uint mid = low + ( high - low ) / 2;
+        kType aKey = A_iter[ mid ];
+        kType bKey = B_iter[ diagonal - 1 - mid ];
+        if( !( *lessOp )( bKey, aKey ) )
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    splits[ boundary ] = low;
+}
+
+//  Stages the part of A and B that feeds the tile of this work-group in lds, then every work-item finds its own
+//  MERGE_ITEMS_PER_WORKITEM outputs with a merge path search inside the tile and merges them serially.
+template< typename kType, typename kIterType1, typename kIterType2, typename koIterType,
+          typename StrictWeakOrdering >
+kernel void mergeTemplate(
+    global kType* A_ptr,
+    kIterType1 A_iter,
+    const uint aLength,
+    global kType* B_ptr,
+    kIterType2 B_iter,
+    const uint bLength,
+    global kType* Z_ptr,
+    koIterType Z_iter,
+    global uint* splits,
+    local kType* lds,
+    global StrictWeakOrdering* lessOp )
+{
+    A_iter.init( A_ptr );
+    B_iter.init( B_ptr );
+    Z_iter.init( Z_ptr );
+
+    uint groupId = get_group_id( 0 );
+    uint localId = get_local_id( 0 );
+    uint localSize = get_local_size( 0 );
+    uint tileSize = localSize * MERGE_ITEMS_PER_WORKITEM;
+
+    uint tileBegin = groupId * tileSize;
+    uint tileEnd = min( tileBegin + tileSize, aLength + bLength );
+    uint aBegin = splits[ groupId ];
+    uint aCount = splits[ groupId + 1 ] - aBegin;
+    uint bBegin = tileBegin - aBegin;
+    uint count = tileEnd - tileBegin;
+    uint bCount = count - aCount;
+
+    for( uint i = localId; i < count; i += localSize )
+        lds[ i ] = ( i < aCount ) ? A_iter[ aBegin + i ] : B_iter[ bBegin + i - aCount ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    uint outBegin = min( localId * MERGE_ITEMS_PER_WORKITEM, count );
+    uint outEnd = min( outBegin + MERGE_ITEMS_PER_WORKITEM, count );
+    uint aIndex = mergePathSplitLocal( lds, aCount, lds + aCount, bCount, outBegin, lessOp );
+    uint bIndex = outBegin - aIndex;
+
+    for( uint out = outBegin; out < outEnd; ++out )
+    {
+        bool takeB = ( bIndex < bCount );
+        if( takeB && aIndex < aCount )
+        {
+            kType aKey = lds[ aIndex ];
+            kType bKey = lds[ aCount + bIndex ];
+            takeB = ( *lessOp )( bKey, aKey );
+        }
+
+        if( takeB )
+        {
+            Z_iter[ tileBegin + out ] = lds[ aCount + bIndex ];
+            ++bIndex;
+        }
+        else
+        {
+            Z_iter[ tileBegin + out ] = lds[ aIndex ];
+            ++aIndex;
+        }
+    }
+}
+
+//  mergeTemplate with a value travelling along with every key; the values are read straight from global memory,
+//  since each of them is touched exactly once.
+template< typename kType, typename kIterType1, typename kIterType2, typename koIterType,
+          typename vType, typename vIterType1, typename vIterType2, typename voIterType,
+          typename StrictWeakOrdering >
+kernel void mergeByKeyTemplate(
+    global kType* A_ptr,
+    kIterType1 A_iter,
+    const uint aLength,
+    global kType* B_ptr,
+    kIterType2 B_iter,
+    const uint bLength,
+    global vType* AV_ptr,
+    vIterType1 AV_iter,
+    global vType* BV_ptr,
+    vIterType2 BV_iter,
+    global kType* Z_ptr,
+    koIterType Z_iter,
+    global vType* ZV_ptr,
+    voIterType ZV_iter,
+    global uint* splits,
+    local kType* lds,
+    global StrictWeakOrdering* lessOp )
+{
+    A_iter.init( A_ptr );
+    B_iter.init( B_ptr );
+    AV_iter.init( AV_ptr );
+    BV_iter.init( BV_ptr );
+    Z_iter.init( Z_ptr );
+    ZV_iter.init( ZV_ptr );
+
+    uint groupId = get_group_id( 0 );
+    uint localId = get_local_id( 0 );
+    uint localSize = get_local_size( 0 );
+    uint tileSize = localSize * MERGE_ITEMS_PER_WORKITEM;
+
+    uint tileBegin = groupId * tileSize;
+    uint tileEnd = min( tileBegin + tileSize, aLength + bLength );
+    uint aBegin = splits[ groupId ];
+    uint aCount = splits[ groupId + 1 ] - aBegin;
+    uint bBegin = tileBegin - aBegin;
+    uint count = tileEnd - tileBegin;
+    uint bCount = count - aCount;
+
+    for( uint i = localId; i < count; i += localSize )
+        lds[ i ] = ( i < aCount ) ? A_iter[ aBegin + i ] : B_iter[ bBegin + i - aCount ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    uint outBegin = min( localId * MERGE_ITEMS_PER_WORKITEM, count );
+    uint outEnd = min( outBegin + MERGE_ITEMS_PER_WORKITEM, count );
+    uint aIndex = mergePathSplitLocal( lds, aCount, lds + aCount, bCount, outBegin, lessOp );
+    uint bIndex = outBegin - aIndex;
+
+    for( uint out = outBegin; out < outEnd; ++out )
+    {
+        bool takeB = ( bIndex < bCount );
+        if( takeB && aIndex < aCount )
+        {
+            kType aKey = lds[ aIndex ];
+            kType bKey = lds[ aCount + bIndex ];
+            takeB = ( *lessOp )( bKey, aKey );
+        }
+
+        if( takeB )
+        {
+            Z_iter[ tileBegin + out ] = lds[ aCount + bIndex ];
+            ZV_iter[ tileBegin + out ] = BV_iter[ bBegin + bIndex ];
+            ++bIndex;
+        }
+        else
+        {
+            Z_iter[ tileBegin + out ] = lds[ aIndex ];
+            ZV_iter[ tileBegin + out ] = AV_iter[ aBegin + aIndex ];
+            ++aIndex;
+        }
+    }
+}
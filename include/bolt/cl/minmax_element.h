@@ -0,0 +1,124 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_MINMAX_ELEMENT_H )
+#define BOLT_CL_MINMAX_ELEMENT_H
+#pragma once
+
+#include <bolt/cl/bolt.h>
+#include <bolt/cl/functional.h>
+#include <bolt/cl/device_vector.h>
+
+#include <string>
+#include <utility>
+
+/*! \file bolt/cl/minmax_element.h
+    \brief minmax_element returns the locations of the smallest and of the largest element of a range, reading the
+    range once.
+*/
+
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-minmax_element
+        *   \ingroup reductions
+        *   \{
+        *   \details Calling \p min_element and \p max_element on the same range reads it twice.  \p minmax_element
+        *   tracks both candidates in the same kernel, and every work-group writes one pair of positions.
+        */
+
+        /*! \brief The minmax_element returns the location of the first smallest element and the location of the last
+        * largest element in the specified range, like std::minmax_element.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first A forward iterator addressing the position of the first element in the range to be searched
+        * \param last  A forward iterator addressing the position one past the final element in the range to be
+        *  searched
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler. The cl_code is inserted first in
+        * the generated code, before the cl_code trait.
+        * \tparam ForwardIterator An iterator that can be dereferenced for an object, and can be incremented to get to
+        * the next element in a sequence.
+        * \return The pair of positions, or ( last, last ) when the range is empty.
+        *
+        * \details The following code example finds the smallest and the largest of 10 numbers.
+        * \code
+        * #include <bolt/cl/minmax_element.h>
+        *
+        * int a[10] = {4, 8, 6, 1, 5, 3, 10, 2, 10, 7};
+        *
+        * std::pair< int*, int* > bounds = bolt::cl::minmax_element(a, a+10);
+        * // bounds.first = a+3, bounds.second = a+8
+        *  \endcode
+        * \sa http://en.cppreference.com/w/cpp/algorithm/minmax_element
+        */
+
+        template<typename ForwardIterator>
+        std::pair< ForwardIterator, ForwardIterator > minmax_element(bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator>
+        std::pair< ForwardIterator, ForwardIterator > minmax_element(ForwardIterator first,
+            ForwardIterator last,
+            const std::string& cl_code="");
+
+        /*! \brief This version of \p minmax_element orders the elements with \p binary_op.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first A forward iterator addressing the position of the first element in the range to be searched
+        * \param last  A forward iterator addressing the position one past the final element in the range to be
+        *  searched
+        * \param binary_op The strict weak ordering of the elements.  By default, the binary operation is less<>().
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler. The cl_code is inserted first in
+        * the generated code, before the cl_code trait.
+        * \tparam ForwardIterator An iterator that can be dereferenced for an object, and can be incremented to get to
+        * the next element in a sequence.
+        * \tparam BinaryPredicate A function object that returns true when its first argument is ordered before its
+        * second.
+        * \return The pair of positions, or ( last, last ) when the range is empty.
+        */
+
+        template<typename ForwardIterator, typename BinaryPredicate>
+        std::pair< ForwardIterator, ForwardIterator > minmax_element(bolt::cl::control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            BinaryPredicate binary_op,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename BinaryPredicate>
+        std::pair< ForwardIterator, ForwardIterator > minmax_element(ForwardIterator first,
+            ForwardIterator last,
+            BinaryPredicate binary_op,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    };
+};
+
+#include <bolt/cl/detail/minmax_element.inl>
+
+#endif
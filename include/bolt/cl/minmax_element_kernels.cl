@@ -0,0 +1,115 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Finds the first smallest and the last largest element in one pass.  Every work-group writes the positions and the
+//  values of its two candidates, and the host combines one pair per work-group.
+
+//#pragma OPENCL EXTENSION cl_amd_printf : enable
+
+//  Equal elements are ordered by their position, so the result does not depend on the shape of the launch
+#define _MINMAX_STEP(_LENGTH, _IDX, _W) \
+    if ((_IDX < _W) && ((_IDX + _W) < _LENGTH)) {\
+      iType mine = scratchMin[_IDX];\
+      iType other = scratchMin[_IDX + _W];\
+      int otherIndex = scratchMinIndex[_IDX + _W];\
+      if( (*userFunctor)(other, mine) || ( !(*userFunctor)(mine, other) && otherIndex < scratchMinIndex[_IDX] ) ) {\
+        scratchMin[_IDX] = other;\
+        scratchMinIndex[_IDX] = otherIndex;\
+      }\
+      mine = scratchMax[_IDX];\
+      other = scratchMax[_IDX + _W];\
+      otherIndex = scratchMaxIndex[_IDX + _W];\
+      if( (*userFunctor)(mine, other) || ( !(*userFunctor)(other, mine) && otherIndex > scratchMaxIndex[_IDX] ) ) {\
+        scratchMax[_IDX] = other;\
+        scratchMaxIndex[_IDX] = otherIndex;\
+      }\
+    }\
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+template< typename iType, typename iIterType, typename binary_function >
+kernel void minmax_elementTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const int length,
+    global binary_function* userFunctor,
+    global int* resultIndices,
+    global iType* resultValues,
+    local iType* scratchMin,
+    local int* scratchMinIndex,
+    local iType* scratchMax,
+    local int* scratchMaxIndex
+)
+{
+    int gx = get_global_id (0);
+    int minIndex = gx;
+    int maxIndex = gx;
+
+    input_iter.init( input_ptr );
+
+    //  A work-item visits its elements in increasing order, so it only replaces the minimum by a smaller element,
+    //  and the maximum by any element that is not smaller
+    iType minimum;
+    iType maximum;
+    if(gx < length)
+    {
+        minimum = input_iter[gx];
+        maximum = minimum;
+        gx += get_global_size(0);
+    }
+
+    while (gx < length)
+    {
+        iType element = input_iter[gx];
+        if( (*userFunctor)(element, minimum) )
+        {
+            minimum = element;
+            minIndex = gx;
+        }
+        if( !(*userFunctor)(element, maximum) )
+        {
+            maximum = element;
+            maxIndex = gx;
+        }
+        gx += get_global_size(0);
+    }
+
+    int local_index = get_local_id(0);
+    scratchMin[local_index] = minimum;
+    scratchMinIndex[local_index] = minIndex;
+    scratchMax[local_index] = maximum;
+    scratchMaxIndex[local_index] = maxIndex;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    //  Tail stops the last workgroup from reading past the end of the input vector
+    uint tail = length - (get_group_id(0) * get_local_size(0));
+
+    _MINMAX_STEP(tail, local_index, 32);
+    _MINMAX_STEP(tail, local_index, 16);
+    _MINMAX_STEP(tail, local_index,  8);
+    _MINMAX_STEP(tail, local_index,  4);
+    _MINMAX_STEP(tail, local_index,  2);
+    _MINMAX_STEP(tail, local_index,  1);
+
+    if (local_index == 0)
+    {
+        int group = get_group_id(0);
+        resultIndices[2 * group] = scratchMinIndex[0];
+        resultIndices[2 * group + 1] = scratchMaxIndex[0];
+        resultValues[2 * group] = scratchMin[0];
+        resultValues[2 * group + 1] = scratchMax[0];
+    }
+};
@@ -0,0 +1,111 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_MISMATCH_H )
+#define BOLT_CL_MISMATCH_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/find.h"
+
+#include <string>
+#include <utility>
+
+/*! \file bolt/cl/mismatch.h
+    \brief Finds the first position where two sequences differ, stopping early once it is known.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup searching
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-mismatch
+        *   \ingroup searching
+        *   \{
+        *   \details mismatch runs the tiled search of bolt/cl/find.h over pairs of elements.  Both sequences have
+        *   to live in the same kind of memory: both in host memory, or both in device_vectors.
+        */
+
+        /*! \brief \p mismatch returns the first positions i of [first1, last1) and of the sequence that starts at
+        * \p first2 where the two sequences differ.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first1 The beginning of the first sequence.
+        * \param last1  The end of the first sequence.
+        * \param first2 The beginning of the second sequence; it holds at least last1 - first1 elements.
+        * \param predicate \b Optional The binary predicate that tells whether two elements match; equal_to by
+        * default.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return The pair of positions of the first pair of elements that do not match, or last1 and
+        * first2 + ( last1 - first1 ) if all of them match.
+        *
+        * \details The following code example finds where two arrays start to differ.
+        * \code
+        * #include <bolt/cl/mismatch.h>
+        *
+        * int a[ 6 ] = { 0, 5, 3, 7, 2, 9 };
+        * int b[ 6 ] = { 0, 5, 3, 8, 2, 9 };
+        *
+        * std::pair< int*, int* > positions = bolt::cl::mismatch( a, a + 6, b );
+        * // positions => ( a + 3, b + 3 )
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/mismatch.html
+        */
+        template<typename InputIterator1, typename InputIterator2>
+        std::pair< InputIterator1, InputIterator2 > mismatch(control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2>
+        std::pair< InputIterator1, InputIterator2 > mismatch(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+        std::pair< InputIterator1, InputIterator2 > mismatch(control &ctl,
+            InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            BinaryPredicate predicate,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+        std::pair< InputIterator1, InputIterator2 > mismatch(InputIterator1 first1,
+            InputIterator1 last1,
+            InputIterator2 first2,
+            BinaryPredicate predicate,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/mismatch.inl>
+
+#endif
@@ -0,0 +1,356 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_PARTIAL_SORT_H )
+#define BOLT_CL_PARTIAL_SORT_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/pair.h"
+
+#include <string>
+
+/*! \file bolt/cl/partial_sort.h
+    \brief Selection algorithms: partial_sort, nth_element and top_k order only the part of a range that is asked
+    for, instead of sorting all of it.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup sorting
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-selection
+        *   \ingroup sorting
+        *   \{
+        *   \details On the OpenCL path, int, unsigned int and float ranges ordered with bolt::cl::less<> or
+        *   bolt::cl::greater<> use a radix select: one histogram pass per 8-bit digit finds the selected element,
+        *   and one partitioning pass moves the elements that order before it to the front, so only those have to be
+        *   sorted.  Other types and comparators sort the range on the device.  The MultiCoreCpu path uses a parallel
+        *   quickselect from bolt::btbb.
+        */
+
+        /*! \brief \p partial_sort rearranges [first, last) so that [first, middle) holds the smallest
+        * <tt>middle - first</tt> elements in ascending order.  The order of the elements in [middle, last) is
+        * unspecified.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first  The first position in the sequence.
+        * \param middle One past the last position of the sorted head.
+        * \param last   The last position in the sequence.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam RandomAccessIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, and is
+        * mutable.
+        *
+        * \details The following code example keeps the 3 smallest scores in order at the front of the array.
+        * \code
+        * #include <bolt/cl/partial_sort.h>
+        *
+        * int a[8] = {2, 9, 3, 7, 5, 6, 3, 8};
+        *
+        * bolt::cl::partial_sort( a, a+3, a+8 );
+        * // a => {2, 3, 3, ...}
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/partial_sort.html
+        */
+        template<typename RandomAccessIterator>
+        void partial_sort(control &ctl,
+            RandomAccessIterator first,
+            RandomAccessIterator middle,
+            RandomAccessIterator last,
+            const std::string& cl_code="");
+
+        template<typename RandomAccessIterator>
+        void partial_sort(RandomAccessIterator first,
+            RandomAccessIterator middle,
+            RandomAccessIterator last,
+            const std::string& cl_code="");
+
+        /*! \brief \p partial_sort rearranges [first, last) so that [first, middle) holds the first
+        * <tt>middle - first</tt> elements in the order defined by \p comp.  The order of the elements in
+        * [middle, last) is unspecified.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first  The first position in the sequence.
+        * \param middle One past the last position of the sorted head.
+        * \param last   The last position in the sequence.
+        * \param comp   The comparison operation used to order the elements.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam RandomAccessIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, and is
+        * mutable.
+        * \tparam StrictWeakOrdering Is a model of http://www.sgi.com/tech/stl/StrictWeakOrdering.html.
+        *
+        * \code
+        * #include <bolt/cl/partial_sort.h>
+        *
+        * int a[8] = {2, 9, 3, 7, 5, 6, 3, 8};
+        *
+        * bolt::cl::partial_sort( a, a+3, a+8, bolt::cl::greater< int >( ) );
+        * // a => {9, 8, 7, ...}
+        *  \endcode
+        */
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void partial_sort(control &ctl,
+            RandomAccessIterator first,
+            RandomAccessIterator middle,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void partial_sort(RandomAccessIterator first,
+            RandomAccessIterator middle,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief \p nth_element rearranges [first, last) so that the element at \p nth is the element that would be
+        * in that position if the range were sorted.  No element of [first, nth) orders after it, and no element of
+        * (nth, last) orders before it.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The first position in the sequence.
+        * \param nth   The position of the element to select.
+        * \param last  The last position in the sequence.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam RandomAccessIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, and is
+        * mutable.
+        *
+        * \details The following code example finds the median of 8 numbers.
+        * \code
+        * #include <bolt/cl/partial_sort.h>
+        *
+        * int a[8] = {2, 9, 3, 7, 5, 6, 3, 8};
+        *
+        * bolt::cl::nth_element( a, a+4, a+8 );
+        * // a[4] == 6
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/nth_element.html
+        */
+        template<typename RandomAccessIterator>
+        void nth_element(control &ctl,
+            RandomAccessIterator first,
+            RandomAccessIterator nth,
+            RandomAccessIterator last,
+            const std::string& cl_code="");
+
+        template<typename RandomAccessIterator>
+        void nth_element(RandomAccessIterator first,
+            RandomAccessIterator nth,
+            RandomAccessIterator last,
+            const std::string& cl_code="");
+
+        /*! \brief \p nth_element rearranges [first, last) so that the element at \p nth is the element that would be
+        * in that position if the range were sorted with \p comp.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The first position in the sequence.
+        * \param nth   The position of the element to select.
+        * \param last  The last position in the sequence.
+        * \param comp  The comparison operation used to order the elements.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam RandomAccessIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, and is
+        * mutable.
+        * \tparam StrictWeakOrdering Is a model of http://www.sgi.com/tech/stl/StrictWeakOrdering.html.
+        */
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void nth_element(control &ctl,
+            RandomAccessIterator first,
+            RandomAccessIterator nth,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename RandomAccessIterator, typename StrictWeakOrdering>
+        void nth_element(RandomAccessIterator first,
+            RandomAccessIterator nth,
+            RandomAccessIterator last,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief \p top_k copies the \p k largest elements of [first, last), largest first, into
+        * [result, result + k).  The input range is not modified.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first  The first position in the input sequence.
+        * \param last   The last position in the input sequence.
+        * \param k      The number of elements to select; clamped to the length of the input.
+        * \param result The beginning of the output sequence, which must have room for \p k elements of the input
+        * \c value_type.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html
+        * \tparam OutputIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html
+        * \return The end of the output sequence.
+        *
+        * \details The following code example keeps the 100 best scores out of a large array.
+        * \code
+        * #include <bolt/cl/partial_sort.h>
+        *
+        * std::vector< float > scores( 10000000 );
+        * std::vector< float > best( 100 );
+        *
+        * bolt::cl::top_k( scores.begin( ), scores.end( ), 100, best.begin( ) );
+        *  \endcode
+        */
+        template<typename InputIterator, typename OutputIterator>
+        OutputIterator top_k(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            size_t k,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OutputIterator>
+        OutputIterator top_k(InputIterator first,
+            InputIterator last,
+            size_t k,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        /*! \brief \p top_k copies the first \p k elements of [first, last), in the order defined by \p comp, into
+        * [result, result + k).  With bolt::cl::less<> this returns the \p k smallest elements.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first  The first position in the input sequence.
+        * \param last   The last position in the input sequence.
+        * \param k      The number of elements to select; clamped to the length of the input.
+        * \param result The beginning of the output sequence.
+        * \param comp   The comparison operation used to order the elements.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam StrictWeakOrdering Is a model of http://www.sgi.com/tech/stl/StrictWeakOrdering.html.
+        * \return The end of the output sequence.
+        */
+        template<typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+        OutputIterator top_k(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            size_t k,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OutputIterator, typename StrictWeakOrdering>
+        OutputIterator top_k(InputIterator first,
+            InputIterator last,
+            size_t k,
+            OutputIterator result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*! \brief \p top_k_by_key copies the \p k largest keys of [keys_first, keys_last), largest first, into
+        * \p keys_result, and the values that belong to them into \p values_result.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param keys_first    The first position in the key sequence.
+        * \param keys_last     The last position in the key sequence.
+        * \param values_first  The first position in the value sequence.
+        * \param k             The number of elements to select; clamped to the length of the input.
+        * \param keys_result   The beginning of the key output sequence.
+        * \param values_result The beginning of the value output sequence.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return A pair holding the ends of the key and value output sequences.
+        *
+        * \details The following code example returns the ids of the 3 best scores.
+        * \code
+        * #include <bolt/cl/partial_sort.h>
+        *
+        * float scores[8] = {0.2f, 0.9f, 0.3f, 0.7f, 0.5f, 0.6f, 0.3f, 0.8f};
+        * int   ids[8]    = {0, 1, 2, 3, 4, 5, 6, 7};
+        * float best[3];
+        * int   bestIds[3];
+        *
+        * bolt::cl::top_k_by_key( scores, scores+8, ids, 3, best, bestIds );
+        * // best => {0.9f, 0.8f, 0.7f}, bestIds => {1, 7, 3}
+        *  \endcode
+        */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2>
+        pair<OutputIterator1, OutputIterator2>
+        top_k_by_key(control &ctl,
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            size_t k,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2>
+        pair<OutputIterator1, OutputIterator2>
+        top_k_by_key(InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            size_t k,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            const std::string& cl_code="");
+
+        /*! \brief \p top_k_by_key copies the first \p k keys of [keys_first, keys_last), in the order defined by
+        * \p comp, into \p keys_result, and the values that belong to them into \p values_result.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param keys_first    The first position in the key sequence.
+        * \param keys_last     The last position in the key sequence.
+        * \param values_first  The first position in the value sequence.
+        * \param k             The number of elements to select; clamped to the length of the input.
+        * \param keys_result   The beginning of the key output sequence.
+        * \param values_result The beginning of the value output sequence.
+        * \param comp          The comparison operation applied to the keys.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return A pair holding the ends of the key and value output sequences.
+        */
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2, typename StrictWeakOrdering>
+        pair<OutputIterator1, OutputIterator2>
+        top_k_by_key(control &ctl,
+            InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            size_t k,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        template<typename InputIterator1, typename InputIterator2, typename OutputIterator1,
+                 typename OutputIterator2, typename StrictWeakOrdering>
+        pair<OutputIterator1, OutputIterator2>
+        top_k_by_key(InputIterator1 keys_first,
+            InputIterator1 keys_last,
+            InputIterator2 values_first,
+            size_t k,
+            OutputIterator1 keys_result,
+            OutputIterator2 values_result,
+            StrictWeakOrdering comp,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/partial_sort.inl>
+
+#endif
@@ -0,0 +1,200 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Radix select: the host walks the key from the most significant digit down, and each pass histograms only the
+//  elements whose already-decided digits match the prefix of the element being selected.  Once the prefix is
+//  known, a single partitioning pass moves the elements that order before it to the front.
+
+// #pragma OPENCL EXTENSION cl_amd_printf : enable
+
+#define RADIX_SELECT_BITS 8
+#define RADIX_SELECT_BINS ( 1 << RADIX_SELECT_BITS )
+
+//  Map a key onto an unsigned integer whose natural ordering matches the ordering of the key
+inline uint radixSelectOrderedBits( uint value )
+{
+    return value;
+}
+
+inline uint radixSelectOrderedBits( int value )
+{
+    return as_uint( value ) ^ 0x80000000;
+}
+
+inline uint radixSelectOrderedBits( float value )
+{
+    uint bits = as_uint( value );
+    return ( bits & 0x80000000 ) ? ~bits : ( bits | 0x80000000 );
+}
+
+//  Counts, per digit, the elements that still match the selected prefix.  The sub-histogram of a work-group lives in
+//  LDS, and only the non-empty bins are added to the global histogram.
+template< typename kType, typename kIterType >
+kernel void radixSelectHistogramTemplate(
+    global kType* keys_ptr,
+    kIterType keys_iter,
+    const uint length,
+    const uint prefix,
+    const uint prefixMask,
+    const uint shiftCount,
+    const uint flipBits,
+    global uint* histogram,
+    local uint* ldsHistogram )
+{
+    keys_iter.init( keys_ptr );
+    uint localId = get_local_id( 0 );
+    uint localSize = get_local_size( 0 );
+
+    for( uint bin = localId; bin < RADIX_SELECT_BINS; bin += localSize )
+        ldsHistogram[ bin ] = 0;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint index = get_global_id( 0 ); index < length; index += get_global_size( 0 ) )
+    {
+        uint bits = radixSelectOrderedBits( keys_iter[ index ] ) ^ flipBits;
+        if( ( bits & prefixMask ) == prefix )
+            atomic_inc( &ldsHistogram[ ( bits >> shiftCount ) & ( RADIX_SELECT_BINS - 1 ) ] );
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint bin = localId; bin < RADIX_SELECT_BINS; bin += localSize )
+    {
+        uint count = ldsHistogram[ bin ];
+        if( count )
+            atomic_add( &histogram[ bin ], count );
+    }
+}
+
+//  Three-way partition of the whole range around the selected prefix: [ before | matching | after ].
+//  Each tile reserves its slots with one global atomic per class, so the global counters see one update per
+//  work-group and tile rather than one per element.
+template< typename kType, typename kIterType >
+kernel void radixSelectPartitionTemplate(
+    global kType* keys_ptr,
+    kIterType keys_iter,
+    const uint length,
+    const uint prefix,
+    const uint prefixMask,
+    const uint flipBits,
+    const uint equalBase,
+    global kType* output,
+    global uint* counters,
+    local uint* ldsCounters )
+{
+    keys_iter.init( keys_ptr );
+    uint localId = get_local_id( 0 );
+    uint localSize = get_local_size( 0 );
+
+    //  The tile loop bound only depends on the group id, so every work-item of a group reaches the barriers
+    for( uint tileStart = get_group_id( 0 ) * localSize; tileStart < length; tileStart += get_global_size( 0 ) )
+    {
+        if( localId < 3 )
+            ldsCounters[ localId ] = 0;
+        barrier( CLK_LOCAL_MEM_FENCE );
+
+        uint index = tileStart + localId;
+        uint bucket = 3;
+        uint localOffset = 0;
+        kType key;
+        if( index < length )
+        {
+            key = keys_iter[ index ];
+            uint bits = ( radixSelectOrderedBits( key ) ^ flipBits ) & prefixMask;
+            bucket = ( bits < prefix ) ? 0 : ( ( bits == prefix ) ? 1 : 2 );
+            localOffset = atomic_inc( &ldsCounters[ bucket ] );
+        }
+        barrier( CLK_LOCAL_MEM_FENCE );
+
+        if( localId < 3 )
+            ldsCounters[ 3 + localId ] = atomic_add( &counters[ localId ], ldsCounters[ localId ] );
+        barrier( CLK_LOCAL_MEM_FENCE );
+
+        if( bucket == 0 )
+            output[ ldsCounters[ 3 ] + localOffset ] = key;
+        else if( bucket == 1 )
+            output[ equalBase + ldsCounters[ 4 ] + localOffset ] = key;
+        else if( bucket == 2 )
+            output[ length - 1 - ( ldsCounters[ 5 ] + localOffset ) ] = key;
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+}
+
+//  Compacts only the first k elements (and their values) into k-sized outputs; elements that order after the
+//  selected prefix are never written.  Elements matching the prefix fill the slots left after the ones ordering
+//  before it, and the surplus is dropped.
+template< typename kType, typename kIterType, typename vType, typename vIterType >
+kernel void radixSelectTopKTemplate(
+    global kType* keys_ptr,
+    kIterType keys_iter,
+    global vType* values_ptr,
+    vIterType values_iter,
+    const uint length,
+    const uint prefix,
+    const uint prefixMask,
+    const uint flipBits,
+    const uint equalBase,
+    const uint k,
+    global kType* keys_output,
+    global vType* values_output,
+    global uint* counters,
+    local uint* ldsCounters )
+{
+    keys_iter.init( keys_ptr );
+    values_iter.init( values_ptr );
+    uint localId = get_local_id( 0 );
+    uint localSize = get_local_size( 0 );
+
+    for( uint tileStart = get_group_id( 0 ) * localSize; tileStart < length; tileStart += get_global_size( 0 ) )
+    {
+        if( localId < 2 )
+            ldsCounters[ localId ] = 0;
+        barrier( CLK_LOCAL_MEM_FENCE );
+
+        uint index = tileStart + localId;
+        uint bucket = 2;
+        uint localOffset = 0;
+        kType key;
+        if( index < length )
+        {
+            key = keys_iter[ index ];
+            uint bits = ( radixSelectOrderedBits( key ) ^ flipBits ) & prefixMask;
+            if( bits <= prefix )
+            {
+                bucket = ( bits < prefix ) ? 0 : 1;
+                localOffset = atomic_inc( &ldsCounters[ bucket ] );
+            }
+        }
+        barrier( CLK_LOCAL_MEM_FENCE );
+
+        if( localId < 2 )
+            ldsCounters[ 2 + localId ] = atomic_add( &counters[ localId ], ldsCounters[ localId ] );
+        barrier( CLK_LOCAL_MEM_FENCE );
+
+        uint outIndex = k;
+        if( bucket == 0 )
+            outIndex = ldsCounters[ 2 ] + localOffset;
+        else if( bucket == 1 )
+            outIndex = equalBase + ldsCounters[ 3 ] + localOffset;
+
+        if( outIndex < k )
+        {
+            keys_output[ outIndex ] = key;
+            values_output[ outIndex ] = values_iter[ index ];
+        }
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+}
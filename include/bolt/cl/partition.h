@@ -0,0 +1,126 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_PARTITION_H )
+#define BOLT_CL_PARTITION_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+
+#include <string>
+
+/*! \file bolt/cl/partition.h
+    \brief Reorders a range so that the elements that satisfy a predicate come first.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reordering
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-partition
+        *   \ingroup reordering
+        *   \{
+        *   \details The OpenCL path runs the scan-and-scatter pass of copy_if once: the elements that satisfy the
+        *   predicate are written forwards from the front of a temporary buffer and the others backwards from its end,
+        *   and a second kernel moves both halves back into the range in their original order.
+        */
+
+        /*! \brief \p stable_partition reorders [first, last) so that the elements for which \p pred is true precede
+        * the others.  Both groups keep the relative order of their elements.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sequence.
+        * \param last  The end of the sequence.
+        * \param pred A unary predicate, registered with BOLT_FUNCTOR.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html, and is mutable.
+        * \tparam Predicate Is a model of http://www.sgi.com/tech/stl/Predicate.html
+        * \return The iterator to the first element for which \p pred is false.
+        *
+        * \details The following code example moves the even values to the front.
+        * \code
+        * #include <bolt/cl/partition.h>
+        *
+        * BOLT_FUNCTOR( IsEven,
+        * struct IsEven
+        * {
+        *     bool operator( )( const int x ) const { return ( x % 2 ) == 0; }
+        * };
+        * );
+        *
+        * int a[ 8 ] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        * int* middle = bolt::cl::stable_partition( a, a + 8, IsEven( ) );
+        * // a => { 2, 4, 6, 8, 1, 3, 5, 7 }, middle == a + 4
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/stable_partition.html
+        */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator stable_partition(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator stable_partition(ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        /*! \brief \p partition reorders [first, last) so that the elements for which \p pred is true precede the
+        * others.  The relative order within the groups is not guaranteed; the OpenCL and TBB paths share the code
+        * of stable_partition, since a stable scatter costs nothing more there.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The beginning of the sequence.
+        * \param last  The end of the sequence.
+        * \param pred A unary predicate, registered with BOLT_FUNCTOR.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam ForwardIterator Is a model of http://www.sgi.com/tech/stl/ForwardIterator.html, and is mutable.
+        * \tparam Predicate Is a model of http://www.sgi.com/tech/stl/Predicate.html
+        * \return The iterator to the first element for which \p pred is false.
+        * \sa http://www.sgi.com/tech/stl/partition.html
+        */
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator partition(control &ctl,
+            ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        template<typename ForwardIterator, typename Predicate>
+        ForwardIterator partition(ForwardIterator first,
+            ForwardIterator last,
+            Predicate pred,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/partition.inl>
+
+#endif
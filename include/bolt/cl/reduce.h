@@ -22,6 +22,7 @@
 #include <bolt/cl/bolt.h>
 #include <bolt/cl/functional.h>
 #include <bolt/cl/device_vector.h>
+#include <bolt/cl/device_scalar.h>
 
 #include <string>
 #include <iostream>
@@ -201,6 +202,54 @@ namespace bolt {
             BinaryFunction binary_op,
             const std::string& cl_code="")  ;
 
+        /*! \brief This version of \p reduce writes the result of the reduction to a bolt::cl::device_scalar instead of
+        * returning it.  On the OpenCL path the last step of the reduction also runs on the device, and the call
+        * returns as soon as the kernels are enqueued, so that the result can feed another Bolt algorithm without
+        * the command queue draining first.  The CPU paths compute the result on the host and write it to \p result.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.
+        * \param first The first position in the sequence to be reduced.
+        * \param last  The last position in the sequence to be reduced.
+        * \param init  The initial value for the accumulator.
+        * \param binary_op  The binary operation used to combine two values.
+        * \param result The scalar that receives the result of the reduction.  It must have been created on the
+        * command queue of \p ctl.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam InputIterator An iterator that can be dereferenced for an object, and can be incremented to get to
+        * the next element in a sequence.
+        * \tparam BinaryFunction A function object defining an operation that is applied to consecutive elements in the
+        * sequence.
+        *
+        * \details The following code example computes the mean of a device_vector without reading the sum back.
+        \code
+        #include <bolt/cl/reduce.h>
+        #include <bolt/cl/transform.h>
+
+        bolt::cl::device_vector< float > input( 1024 );
+        ...
+        bolt::cl::device_scalar< float > sum, count( 1024.0f ), mean;
+        bolt::cl::reduce( input.begin( ), input.end( ), 0.0f, bolt::cl::plus< float >( ), sum );
+        bolt::cl::transform( sum.begin( ), sum.end( ), count.begin( ), mean.begin( ), bolt::cl::divides< float >( ) );
+        \endcode
+        * \sa bolt::cl::device_scalar
+        */
+        template<typename InputIterator, typename T, typename BinaryFunction>
+        void reduce(bolt::cl::control &ctl,
+            InputIterator first,
+            InputIterator last,
+            T init,
+            BinaryFunction binary_op,
+            device_scalar< T >& result,
+            const std::string& cl_code="")  ;
+
+        template<typename InputIterator, typename T, typename BinaryFunction>
+        void reduce(InputIterator first,
+            InputIterator last,
+            T init,
+            BinaryFunction binary_op,
+            device_scalar< T >& result,
+            const std::string& cl_code="")  ;
+
         /*!   \}  */
 
     };
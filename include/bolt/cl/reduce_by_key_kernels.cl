@@ -13,308 +13,379 @@
 *   See the License for the specific language governing permissions and              
 *   limitations under the License.                                                   
 ***************************************************************************/
-#pragma OPENCL EXTENSION cl_amd_printf : enable
 
-/******************************************************************************
- *  Kernel 0
- *****************************************************************************/
-template<
-    typename kType,
-    typename kIterType,
-    typename vType,
-    typename vIterType,
-    typename oType,
-    typename voType,
-    typename BinaryPredicate,
-    typename BinaryFunction >
-__kernel void perBlockScanByKey(
-    global kType *ikeys, //input keys
+//  Reduction of the runs of equal keys.  A tile is REDUCE_BY_KEY_ITEMS_PER_WORKITEM consecutive elements per
+//  work-item.  Every tile marks the heads of the runs, reduces the run that is still open at the end of every
+//  work-item, and combines those partial results in a segmented scan in local memory; a run is written to the output
+//  by the work-item that holds its last element, at the position given by the number of heads in front of it.
+//
+//  The state carried from one part of the input to the next is a pair: the number of heads in the part, and the
+//  reduction of the elements behind its last head (of the whole part when it has no head).  Two pairs combine as
+//
+//      ( count, value ) = ( earlier.count + later.count,
+//                           later.count ? later.value : binaryOp( earlier.value, later.value ) )
+//
+//  On devices that can chain tiles the pair of the preceding tiles comes from a decoupled look-back, so the input is
+//  read once in a single launch; the other devices compute the pair of every tile first and scan the pairs in one
+//  work-group.
+
+//  The look-back helpers come from lookback_kernels.cl, which the host prepends to this source; the value a tile
+//  publishes there is its pair.
+template< typename T >
+struct reduceByKeyPair
+{
+    uint count;
+    T value;
+};
+
+template< typename T, typename BinaryFunction >
+struct reduceByKeyPairOperator
+{
+    global BinaryFunction* binaryOp;
+
+    reduceByKeyPair< T > operator( )( reduceByKeyPair< T > earlier, reduceByKeyPair< T > later )
+    {
+        reduceByKeyPair< T > pair;
+        pair.count = earlier.count + later.count;
+        pair.value = later.count ? later.value : (*binaryOp)( earlier.value, later.value );
+        return pair;
+    }
+};
+
+//  Loads a tile into local memory, marks the heads of the work-item's elements in headBits, and runs the segmented
+//  scan of the work-item pairs.  On return threadCount/threadValue hold the pair of everything in the tile in front
+//  of the work-item (hasThreadValue is false for the first work-item), and tileCount/tileValue the pair of the whole
+//  tile.
+template< typename kType, typename kIterType, typename vIterType, typename voType, typename BinaryPredicate,
+          typename BinaryFunction >
+inline void reduceByKeyTileScan(
     kIterType keys,
-    global vType *ivals, //input values
     vIterType vals,
-    global voType *output, // offsetValues
-    global int *output2, //offsetKeys
     const uint vecSize,
-    local kType *ldsKeys,
-    local oType *ldsVals,
-    global BinaryPredicate *binaryPred,
-    global BinaryFunction *binaryFunct,
-    global kType *keyBuffer,
-    global oType *valBuffer)
+    const uint tileStart,
+    const uint tileCount,
+    local kType* ldsKeys,
+    local voType* ldsVals,
+    local uint* ldsCounts,
+    local voType* ldsCarries,
+    global BinaryPredicate* binaryPred,
+    global BinaryFunction* binaryOp,
+    uint* headBits,
+    uint* threadCount,
+    voType* threadValue,
+    bool* hasThreadValue,
+    uint* tileCount_out,
+    voType* tileValue )
 {
-
-    keys.init( ikeys );
-    vals.init( ivals );
-
-    size_t gloId = get_global_id( 0 );
-    size_t groId = get_group_id( 0 );
     size_t locId = get_local_id( 0 );
     size_t wgSize = get_local_size( 0 );
-    //printf("gid=%i, lTid=%i, gTid=%i\n", groId, locId, gloId);
 
-    // if exclusive, load gloId=0 w/ init, and all others shifted-1
-    kType key;
-    oType val;
-    //vType inVal = vals[gloId];
-    //val = (oType) (*unaryOp)(inVal);
-    
-    if(gloId < vecSize){
-      key = keys[ gloId ];
-      val = vals[ gloId ];
-      ldsKeys[ locId ] = key;
-      ldsVals[ locId ] = val;
+    for( uint i = locId; i < tileCount; i += wgSize )
+    {
+        ldsKeys[ i ] = keys[ tileStart + i ];
+        ldsVals[ i ] = vals[ tileStart + i ];
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    uint first = locId * REDUCE_BY_KEY_ITEMS_PER_WORKITEM;
+    uint count = ( first < tileCount ) ? min( ( uint )REDUCE_BY_KEY_ITEMS_PER_WORKITEM, tileCount - first ) : 0;
+    uint lastThread = ( tileCount - 1 ) / REDUCE_BY_KEY_ITEMS_PER_WORKITEM;
+
+    uint bits = 0;
+    uint heads = 0;
+    voType value;
+    for( uint k = 0; k < count; ++k )
+    {
+        uint i = first + k;
+        bool head;
+        if( i > 0 )
+            head = !(*binaryPred)( ldsKeys[ i - 1 ], ldsKeys[ i ] );
+        else
+            head = ( tileStart == 0 ) || !(*binaryPred)( keys[ tileStart - 1 ], ldsKeys[ 0 ] );
+
+        voType item = ldsVals[ i ];
+        if( head )
+        {
+            bits |= ( 1u << k );
+            ++heads;
+            value = item;
+        }
+        else
+            value = ( k > 0 ) ? (*binaryOp)( value, item ) : item;
     }
-    
-    // Computes a scan within a workgroup
-    // updates vals in lds but not keys
-    oType sum = val;
+
+    //  Inclusive segmented scan of the work-item pairs; the work-items past the end of the tile hold nothing and
+    //  stay out of it, and they only ever follow the ones that do
+    ldsCounts[ locId ] = heads;
+    ldsCarries[ locId ] = value;
     for( size_t offset = 1; offset < wgSize; offset *= 2 )
     {
         barrier( CLK_LOCAL_MEM_FENCE );
-        kType key2 = ldsKeys[locId - offset];
-        kType prevKey = ldsKeys[locId - 1];
-        if (locId >= offset && (*binaryPred)(key, key2) && (*binaryPred)(key,prevKey))
-        {
-            oType y = ldsVals[ locId - offset ];
-            sum = (*binaryFunct)( sum, y );
-        }		
-        else //This has to be optimized
+        if( count && locId >= offset )
         {
-            if (offset == 1 && gloId < vecSize) //Only when you compare neighbours
-            {
-                    output2[ gloId ] = 1;
-            }
-                
+            uint earlierCount = ldsCounts[ locId - offset ];
+            voType earlierValue = ldsCarries[ locId - offset ];
+            if( heads == 0 )
+                value = (*binaryOp)( earlierValue, value );
+            heads += earlierCount;
         }
         barrier( CLK_LOCAL_MEM_FENCE );
-        ldsVals[ locId ] = sum;
+        ldsCounts[ locId ] = heads;
+        ldsCarries[ locId ] = value;
     }
-    barrier( CLK_LOCAL_MEM_FENCE ); // needed for large data types
-    //  Abort threads that are passed the end of the input vector
-    if (gloId >= vecSize) return;
+    barrier( CLK_LOCAL_MEM_FENCE );
 
-    // Each work item writes out its calculated scan result, relative to the beginning
-    // of each work group
-    output[ gloId ] = sum;
-    
-    if (locId == 0)
+    *headBits = bits;
+    *hasThreadValue = ( locId > 0 );
+    *threadCount = ( locId > 0 ) ? ldsCounts[ locId - 1 ] : 0;
+    if( locId > 0 )
+        *threadValue = ldsCarries[ locId - 1 ];
+    *tileCount_out = ldsCounts[ lastThread ];
+    *tileValue = ldsCarries[ lastThread ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+}
+
+/******************************************************************************
+ *  Kernel 0: pair of every tile, for the devices that do not chain tiles
+ *****************************************************************************/
+template< typename kType, typename kIterType, typename vType, typename vIterType, typename voType,
+          typename BinaryPredicate, typename BinaryFunction >
+kernel void reduceByKeyTileAggregateTemplate(
+    global kType* ikeys,
+    kIterType keys,
+    global vType* ivals,
+    vIterType vals,
+    const uint vecSize,
+    local kType* ldsKeys,
+    local voType* ldsVals,
+    local uint* ldsCounts,
+    local voType* ldsCarries,
+    global BinaryPredicate* binaryPred,
+    global BinaryFunction* binaryOp,
+    global uint* tileCounts,
+    global voType* tileSums )
+{
+    keys.init( ikeys );
+    vals.init( ivals );
+
+    uint tile = get_group_id( 0 );
+    uint tileSize = ( uint )get_local_size( 0 ) * REDUCE_BY_KEY_ITEMS_PER_WORKITEM;
+    uint tileStart = tile * tileSize;
+    uint tileCount = min( tileSize, vecSize - tileStart );
+
+    uint headBits, threadCount, aggregateCount;
+    voType threadValue, aggregateValue;
+    bool hasThreadValue;
+    reduceByKeyTileScan( keys, vals, vecSize, tileStart, tileCount, ldsKeys, ldsVals, ldsCounts, ldsCarries,
+        binaryPred, binaryOp, &headBits, &threadCount, &threadValue, &hasThreadValue, &aggregateCount,
+        &aggregateValue );
+
+    if( get_local_id( 0 ) == 0 )
     {
-        keyBuffer[ groId ] = ldsKeys[ wgSize-1 ];
-        valBuffer[ groId ] = ldsVals[ wgSize-1 ];
+        tileCounts[ tile ] = aggregateCount;
+        tileSums[ tile ] = aggregateValue;
     }
 }
 
-
 /******************************************************************************
- *  Kernel 1
+ *  Kernel 1: exclusive scan of the tile pairs, in place, by a single work-group
  *****************************************************************************/
-template<
-    typename kType,
-    typename oType,
-    typename BinaryPredicate,
-    typename BinaryFunction >
-__kernel void intraBlockInclusiveScanByKey(
-    global kType *keySumArray,
-    global oType *preSumArray,
-    global oType *postSumArray,
-    const uint vecSize,
-    local kType *ldsKeys,
-    local oType *ldsVals,
-    const uint workPerThread,
-    global BinaryPredicate *binaryPred,
-    global BinaryFunction  *binaryFunct )
+template< typename voType, typename BinaryFunction >
+kernel void reduceByKeyTileScanTemplate(
+    global uint* tileCounts,
+    global voType* tileSums,
+    const uint numTiles,
+    local uint* ldsCounts,
+    local voType* ldsCarries,
+    global BinaryFunction* binaryOp )
 {
-    size_t groId = get_group_id( 0 );
-    size_t gloId = get_global_id( 0 );
     size_t locId = get_local_id( 0 );
     size_t wgSize = get_local_size( 0 );
-    uint mapId  = gloId * workPerThread;
-    
-    // do offset of zero manually
-    uint offset;
-    kType key;
-    oType workSum;
 
-    if (mapId < vecSize)
-    {
-        kType prevKey;
-
-        // accumulate zeroth value manually
-        offset = 0;
-        key = keySumArray[ mapId+offset ];
-        workSum = preSumArray[ mapId+offset ];
-        postSumArray[ mapId+offset ] = workSum;
+    //  Every work-item takes a run of consecutive tiles
+    uint tilesPerThread = ( numTiles + ( uint )wgSize - 1 ) / ( uint )wgSize;
+    uint first = min( ( uint )locId * tilesPerThread, numTiles );
+    uint last = min( first + tilesPerThread, numTiles );
 
-        //  Serial accumulation
-        for( offset = offset+1; offset < workPerThread; offset += 1 )
-        {
-            prevKey = key;
-            key = keySumArray[ mapId+offset ];
-            if (mapId+offset<vecSize )
-            {
-                oType y = preSumArray[ mapId+offset ];
-                if ( (*binaryPred)(key, prevKey ) )
-                {
-                    workSum = (*binaryFunct)( workSum, y );
-                }
-                else
-                {
-                    workSum = y;
-                }
-                postSumArray[ mapId+offset ] = workSum;
-            }
-        }
+    uint heads = 0;
+    voType value;
+    for( uint t = first; t < last; ++t )
+    {
+        uint count = tileCounts[ t ];
+        voType sum = tileSums[ t ];
+        value = ( t == first || count ) ? sum : (*binaryOp)( value, sum );
+        heads += count;
     }
-    barrier( CLK_LOCAL_MEM_FENCE );
-   
-    oType scanSum = workSum;
-    offset = 1;
-    // load LDS with register sums
-    ldsVals[ locId ] = workSum;
-    ldsKeys[ locId ] = key;
-    // scan in lds
-    for( offset = offset*1; offset < wgSize; offset *= 2 )
+
+    ldsCounts[ locId ] = heads;
+    ldsCarries[ locId ] = value;
+    for( size_t offset = 1; offset < wgSize; offset *= 2 )
     {
         barrier( CLK_LOCAL_MEM_FENCE );
-        if (mapId < vecSize)
+        if( first < last && locId >= offset )
         {
-            if (locId >= offset  )
-            {
-                oType y = ldsVals[ locId - offset ];
-                kType key1 = ldsKeys[ locId ];
-                kType key2 = ldsKeys[ locId-offset ];
-                if ( (*binaryPred)( key1, key2 ) )
-                {
-                   scanSum = (*binaryFunct)( scanSum, y );
-                }
-                else
-                   scanSum = ldsVals[ locId ];
-             }
-      
+            uint earlierCount = ldsCounts[ locId - offset ];
+            voType earlierValue = ldsCarries[ locId - offset ];
+            if( heads == 0 )
+                value = (*binaryOp)( earlierValue, value );
+            heads += earlierCount;
         }
         barrier( CLK_LOCAL_MEM_FENCE );
-        ldsVals[ locId ] = scanSum;
-    } // for offset
+        ldsCounts[ locId ] = heads;
+        ldsCarries[ locId ] = value;
+    }
     barrier( CLK_LOCAL_MEM_FENCE );
-    
-    // write final scan from pre-scan and lds scan
-    for( offset = 0; offset < workPerThread; offset += 1 )
-    {
-        barrier( CLK_GLOBAL_MEM_FENCE );
 
-        if (mapId < vecSize && locId > 0)
-        {
-            oType y = postSumArray[ mapId+offset ];
-            kType key1 = keySumArray[ mapId+offset ]; // change me
-            kType key2 = ldsKeys[ locId-1 ];
-            if ( (*binaryPred)( key1, key2 ) )
-            {
-                oType y2 = ldsVals[locId-1];
-                y = (*binaryFunct)( y, y2 );
-            }
-            postSumArray[ mapId+offset ] = y;
-        } // thread in bounds
-    } // for 
-    
-} // end kernel
-
-
-/******************************************************************************
- *  Kernel 2
- *****************************************************************************/
-template<
-    typename kType,
-    typename kIterType,
-    typename oType,
-    typename BinaryPredicate,
-    typename BinaryFunction >
-__kernel void perBlockAdditionByKey(
-    global kType *keySumArray, //InputBuffer
-    global oType *postSumArray, //InputBuffer
-    global kType *ikeys, //Input keys
-    kIterType keys,
-    global int *output2, //offsetArray
-    global oType *output, //offsetValArray
-    const uint vecSize,
-    global BinaryPredicate *binaryPred,
-    global BinaryFunction *binaryFunct)
-{
-    keys.init( ikeys );
-    size_t gloId = get_global_id( 0 );
-    size_t groId = get_group_id( 0 );
-    size_t locId = get_local_id( 0 );
-
-    //  Abort threads that are passed the end of the input vector
-    if( gloId >= vecSize )
-        return;
-        
-    oType scanResult = output[ gloId ];
-
-    // accumulate prefix
-    kType key1 = keySumArray[ groId-1 ];
-    kType key2 = keys[ gloId ];
-    if (groId > 0 && (*binaryPred)( key1, key2 ) )
+    //  Tile 0 has no prefix; its slot is left as it is
+    heads = ( locId > 0 ) ? ldsCounts[ locId - 1 ] : 0;
+    if( locId > 0 )
+        value = ldsCarries[ locId - 1 ];
+    for( uint t = first; t < last; ++t )
     {
-        oType postBlockSum = postSumArray[ groId-1 ];
-        oType newResult = (*binaryFunct)( scanResult, postBlockSum );
-        output[ gloId ] = newResult;
-        output2[ gloId ] = 0;
+        uint count = tileCounts[ t ];
+        voType sum = tileSums[ t ];
+        if( t > 0 )
+        {
+            tileCounts[ t ] = heads;
+            tileSums[ t ] = value;
+        }
+        value = ( t == 0 || count ) ? sum : (*binaryOp)( value, sum );
+        heads += count;
     }
 }
 
 /******************************************************************************
- *  Kernel 3
+ *  Kernel 2: reduces and writes the runs of every tile
  *****************************************************************************/
- template<
-    typename kType,
-    typename kIterType,
-    typename koType,
-    typename koIterType,
-    typename voType,
-    typename voIterType >
-__kernel void keyValueMapping(
-    global kType *ikeys,
+//  The pair of the preceding tiles comes from the look-back when singlePass is set, and from the scanned tileCounts
+//  and tileSums otherwise.  The number of runs is left in outputCount.
+template< typename kType, typename kIterType, typename vType, typename vIterType, typename koType,
+          typename koIterType, typename voType, typename voIterType, typename BinaryPredicate,
+          typename BinaryFunction >
+kernel void reduceByKeyTemplate(
+    global kType* ikeys,
     kIterType keys,
-    global koType *ikeys_output,
+    global vType* ivals,
+    vIterType vals,
+    global koType* ikeys_output,
     koIterType keys_output,
-    global voType *ivals_output,
+    global voType* ivals_output,
     voIterType vals_output,
-    global int *offsetArray,
-    global koType *offsetValArray,
     const uint vecSize,
-    const int numSections)
+    local kType* ldsKeys,
+    local voType* ldsVals,
+    local uint* ldsCounts,
+    local voType* ldsCarries,
+    global BinaryPredicate* binaryPred,
+    global BinaryFunction* binaryOp,
+    global uint* tileStatus,
+    global uint* tileValues,
+    global uint* tileCounts,
+    global voType* tileSums,
+    int singlePass,
+    global uint* outputCount )
 {
+    local uint tileIndex;
+    local uint tilePrefixCount;
+    local voType tilePrefixValue;
+    size_t locId = get_local_id( 0 );
     keys.init( ikeys );
+    vals.init( ivals );
     keys_output.init( ikeys_output );
     vals_output.init( ivals_output );
 
+    //  Single-pass tiles are numbered in the order they start, so a tile only ever waits on tiles that are running
+    if( locId == 0 )
+        tileIndex = singlePass ? atomic_inc( tileStatus ) : get_group_id( 0 );
+    barrier( CLK_LOCAL_MEM_FENCE );
+    uint tile = tileIndex;
+    uint tileSize = ( uint )get_local_size( 0 ) * REDUCE_BY_KEY_ITEMS_PER_WORKITEM;
+    uint tileStart = tile * tileSize;
+    uint tileCount = min( tileSize, vecSize - tileStart );
 
-    size_t gloId = get_global_id( 0 );
-
-    //  Abort threads that are passed the end of the input vector
-    if( gloId >= vecSize )
-        return;
-    
+    uint headBits, threadCount, aggregateCount;
+    voType threadValue, aggregateValue;
+    bool hasThreadValue;
+    reduceByKeyTileScan( keys, vals, vecSize, tileStart, tileCount, ldsKeys, ldsVals, ldsCounts, ldsCarries,
+        binaryPred, binaryOp, &headBits, &threadCount, &threadValue, &hasThreadValue, &aggregateCount,
+        &aggregateValue );
 
-    if(offsetArray[ gloId ] != 0)
+    if( locId == 0 )
     {
-        //int x = offsetArray [ gloId ] -1;
-        //int xkeys = keys[ gloId-1 ];
-        //int xvals = offsetValArray [ gloId-1 ]; 
+        uint prefixCount = 0;
+        voType prefixValue;
+        if( singlePass )
+        {
+            reduceByKeyPair< voType > aggregate;
+            aggregate.count = aggregateCount;
+            aggregate.value = aggregateValue;
+            if( tile == 0 )
+                lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, aggregate );
+            else
+            {
+                lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_AGGREGATE, aggregate );
+                reduceByKeyPairOperator< voType, BinaryFunction > combine;
+                combine.binaryOp = binaryOp;
+                reduceByKeyPair< voType > prefix =
+                    lookBackCombine< reduceByKeyPair< voType > >( tileStatus, tileValues, tile, combine );
+                lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, combine( prefix, aggregate ) );
+                prefixCount = prefix.count;
+                prefixValue = prefix.value;
+            }
+        }
+        else if( tile > 0 )
+        {
+            prefixCount = tileCounts[ tile ];
+            prefixValue = tileSums[ tile ];
+        }
 
-        keys_output[ offsetArray [ gloId ] -1 ] = keys[ gloId-1 ];
-        vals_output[ offsetArray [ gloId ] -1 ] = offsetValArray [ gloId-1 ];
+        tilePrefixCount = prefixCount;
+        if( tile > 0 )
+            tilePrefixValue = prefixValue;
+        if( tileStart + tileCount == vecSize )
+            outputCount[ 0 ] = prefixCount + aggregateCount;
     }
+    barrier( CLK_LOCAL_MEM_FENCE );
 
-  if( gloId == (vecSize-1) )
-  {
-    //printf("ossfetarr=%d\n", offsetArray [ gloId ]);
-    //printf("keys=%d\n", keys[ gloId ]);
-    //printf("offsetval=%d\n",offsetValArray [ gloId ]);
-        keys_output[ numSections - 1 ] = keys[ gloId ]; //Copying the last key directly. Works either ways
-        vals_output[ numSections - 1 ] = offsetValArray [ gloId ];
-      
-  }
+    uint first = locId * REDUCE_BY_KEY_ITEMS_PER_WORKITEM;
+    uint count = ( first < tileCount ) ? min( ( uint )REDUCE_BY_KEY_ITEMS_PER_WORKITEM, tileCount - first ) : 0;
+    if( count == 0 )
+        return;
+
+    //  Pair of everything in front of the work-item; the very first element is a head, so the value is only read
+    //  where there is one
+    uint position = tilePrefixCount + threadCount;
+    voType running;
+    if( tile > 0 )
+        running = ( hasThreadValue && threadCount ) ? threadValue :
+                  ( hasThreadValue ? (*binaryOp)( tilePrefixValue, threadValue ) : tilePrefixValue );
+    else if( hasThreadValue )
+        running = threadValue;
+
+    for( uint k = 0; k < count; ++k )
+    {
+        uint i = first + k;
+        voType item = ldsVals[ i ];
+        if( headBits & ( 1u << k ) )
+        {
+            running = item;
+            ++position;
+        }
+        else
+            running = (*binaryOp)( running, item );
 
-    
-}
\ No newline at end of file
+        //  The run ends here if the next element starts a new one; it may belong to the next tile
+        uint next = tileStart + i + 1;
+        bool last = ( next == vecSize );
+        if( !last )
+        {
+            kType nextKey = ( i + 1 < tileCount ) ? ldsKeys[ i + 1 ] : keys[ next ];
+            last = !(*binaryPred)( ldsKeys[ i ], nextKey );
+        }
+        if( last )
+        {
+            keys_output[ position - 1 ] = ldsKeys[ i ];
+            vals_output[ position - 1 ] = running;
+        }
+    }
+}
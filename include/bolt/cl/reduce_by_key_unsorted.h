@@ -0,0 +1,266 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_REDUCE_BY_KEY_UNSORTED_H )
+#define BOLT_CL_REDUCE_BY_KEY_UNSORTED_H
+#pragma once
+
+#include <bolt/cl/bolt.h>
+#include <bolt/cl/functional.h>
+#include <bolt/cl/device_vector.h>
+#include <bolt/cl/pair.h>
+
+/*! \file bolt/cl/reduce_by_key_unsorted.h
+    \brief Reduces the values of every distinct key of a sequence whose equal keys need not be adjacent.
+*/
+namespace bolt
+{
+     namespace cl
+        {
+
+            /*! \addtogroup algorithms
+            */
+
+            /*! \addtogroup reductions
+            *   \ingroup algorithms
+            */
+
+            /*! \addtogroup CL-reduce_by_key_unsorted
+            *   \ingroup reductions
+            *   \{
+            *   \details reduce_by_key only reduces runs of equal keys, so grouping a sequence whose keys are scattered
+            *   needs a sort by key first.  reduce_by_key_unsorted groups the keys wherever they are.  When the keys
+            *   are int or unsigned int, the predicate is bolt::cl::equal_to and the reduction is bolt::cl::plus,
+            *   bolt::cl::minimum or bolt::cl::maximum over int, unsigned int or float values, the OpenCL path
+            *   aggregates the values into a device hash table with global atomics, in one pass over the input.  Any
+            *   other combination, and inputs with too many distinct keys for the table, are stable sorted by key and
+            *   reduced with reduce_by_key.  The SerialCpu path aggregates int and unsigned int keys in a hash map; the
+            *   MultiCoreCpu path and the remaining cases sort.
+            *
+            *   The order of the groups in the output is unspecified: it depends on the path taken, and on the device
+            *   it can change from one call to the next.  The hash table reduces the values of a key in no particular
+            *   order either, so a float sum can differ from a sequential one in its last bits.
+            */
+
+            /*! \brief \p reduce_by_key_unsorted reduces, for every distinct key in [keys_first, keys_last), the values
+            * that go with that key, whether or not the equal keys are adjacent; the BinaryFunction in this version is
+            * plus(), and the BinaryPredicate is equal_to().
+            *
+            * \param ctl           \b Optional Control structure to control command-queue, debug, tuning, etc.
+            *                      See bolt::cl::control.
+            * \param keys_first    The first element of the key sequence.
+            * \param keys_last     The last  element of the key sequence.
+            * \param values_first  The first element of the value sequence.
+            * \param keys_output   The first element of the key output sequence.
+            * \param values_output The first element of the value output sequence.
+            * \param user_code     A user-specified Optional string that is preppended to the generated OpenCL kernel.
+            *
+            * \tparam InputIterator1   is a model of Input Iterator, and its value type is LessThanComparable.
+            * \tparam InputIterator2   is a model of Input Iterator.
+            * \tparam OutputIterator   is a model of Output Iterator.
+            *
+            * \return A pair of iterators to the end of the key and value output sequences; there is one element per
+            * distinct key.
+            *
+            * \details Example:
+            * \code
+            * #include "bolt/cl/reduce_by_key_unsorted.h"
+            * ...
+            *
+            * int keys[11] = { 2, 0, -5, 2, 0, 6, -5, 0, 2, -5, -5 };
+            * int vals[11] = { 2, 2,  2, 2, 2, 2,  2, 2, 2,  2,  2 };
+            * int keys_out[11];
+            * int vals_out[11];
+            *
+            * bolt::cl::reduce_by_key_unsorted( keys, keys + 11, vals, keys_out, vals_out );
+            * // keys_out => { 0, 2, -5, 6 }, in some order
+            * // vals_out => { 6, 6, 8, 2 }, in the same order
+            *  \endcode
+            *
+            */
+            template<
+                typename InputIterator1,
+                typename InputIterator2,
+                typename OutputIterator1,
+                typename OutputIterator2>
+                pair<OutputIterator1, OutputIterator2>
+                reduce_by_key_unsorted(
+                control &ctl,
+                InputIterator1  keys_first,
+                InputIterator1  keys_last,
+                InputIterator2  values_first,
+                OutputIterator1  keys_output,
+                OutputIterator2  values_output,
+                const std::string& user_code="" );
+
+            template<
+                typename InputIterator1,
+                typename InputIterator2,
+                typename OutputIterator1,
+                typename OutputIterator2>
+                pair<OutputIterator1, OutputIterator2>
+                reduce_by_key_unsorted(
+                InputIterator1  keys_first,
+                InputIterator1  keys_last,
+                InputIterator2  values_first,
+                OutputIterator1  keys_output,
+                OutputIterator2  values_output,
+                const std::string& user_code="" );
+
+            /*! \brief \p reduce_by_key_unsorted reduces, for every distinct key in [keys_first, keys_last), the values
+            * that go with that key, whether or not the equal keys are adjacent; the BinaryPredicate is equal_to().
+            *
+            * \param ctl           \b Optional Control structure to control command-queue, debug, tuning, etc.
+            *                      See bolt::cl::control.
+            * \param keys_first    The first element of the key sequence.
+            * \param keys_last     The last  element of the key sequence.
+            * \param values_first  The first element of the value sequence.
+            * \param keys_output   The first element of the key output sequence.
+            * \param values_output The first element of the value output sequence.
+            * \param binary_op     Function used to combine the values of a key; it must be associative and
+            *                      commutative, because the values are not combined in input order.
+            * \param user_code     A user-specified Optional string that is preppended to the generated OpenCL kernel.
+            *
+            * \tparam InputIterator1   is a model of Input Iterator, and its value type is LessThanComparable.
+            * \tparam InputIterator2   is a model of Input Iterator.
+            * \tparam OutputIterator   is a model of Output Iterator.
+            * \tparam BinaryFunction   is a model of Binary Function whose return type is convertible to
+            *                          \c OutputIterator2's \c value_type.
+            *
+            * \return A pair of iterators to the end of the key and value output sequences.
+            *
+            * \details Example:
+            * \code
+            * #include "bolt/cl/reduce_by_key_unsorted.h"
+            * ...
+            *
+            * int keys[11] = { 2, 0, -5, 2, 0, 6, -5, 0, 2, -5, -5 };
+            * int vals[11] = { 1, 2,  3, 4, 5, 6,  7, 8, 9, 10, 11 };
+            * int keys_out[11];
+            * int vals_out[11];
+            *
+            * bolt::cl::reduce_by_key_unsorted( keys, keys + 11, vals, keys_out, vals_out,
+            *                                   bolt::cl::maximum< int >( ) );
+            * // keys_out => { 0, 2, -5, 6 }, in some order
+            * // vals_out => { 8, 9, 11, 6 }, in the same order
+            *  \endcode
+            *
+            */
+            template<
+                typename InputIterator1,
+                typename InputIterator2,
+                typename OutputIterator1,
+                typename OutputIterator2,
+                typename BinaryFunction>
+                pair<OutputIterator1, OutputIterator2>
+                reduce_by_key_unsorted(
+                control &ctl,
+                InputIterator1  keys_first,
+                InputIterator1  keys_last,
+                InputIterator2  values_first,
+                OutputIterator1  keys_output,
+                OutputIterator2  values_output,
+                BinaryFunction binary_op,
+                const std::string& user_code="" );
+
+            template<
+                typename InputIterator1,
+                typename InputIterator2,
+                typename OutputIterator1,
+                typename OutputIterator2,
+                typename BinaryFunction>
+                pair<OutputIterator1, OutputIterator2>
+                reduce_by_key_unsorted(
+                InputIterator1  keys_first,
+                InputIterator1  keys_last,
+                InputIterator2  values_first,
+                OutputIterator1  keys_output,
+                OutputIterator2  values_output,
+                BinaryFunction binary_op,
+                const std::string& user_code="" );
+
+            /*! \brief \p reduce_by_key_unsorted reduces, for every distinct key in [keys_first, keys_last), the values
+            * that go with that key, whether or not the equal keys are adjacent.
+            *
+            * \param ctl           \b Optional Control structure to control command-queue, debug, tuning, etc.
+            *                      See bolt::cl::control.
+            * \param keys_first    The first element of the key sequence.
+            * \param keys_last     The last  element of the key sequence.
+            * \param values_first  The first element of the value sequence.
+            * \param keys_output   The first element of the key output sequence.
+            * \param values_output The first element of the value output sequence.
+            * \param binary_pred   Binary predicate that decides whether two keys are equal.  It must agree with
+            *                      bolt::cl::less on the key type: two keys are equal exactly when neither is less
+            *                      than the other.
+            * \param binary_op     Function used to combine the values of a key; it must be associative and
+            *                      commutative.
+            * \param user_code     A user-specified Optional string that is preppended to the generated OpenCL kernel.
+            *
+            * \tparam InputIterator1   is a model of Input Iterator, and its value type is LessThanComparable.
+            * \tparam InputIterator2   is a model of Input Iterator.
+            * \tparam OutputIterator   is a model of Output Iterator.
+            * \tparam BinaryPredicate  is a model of Binary Predicate.
+            * \tparam BinaryFunction   is a model of Binary Function whose return type is convertible to
+            *                          \c OutputIterator2's \c value_type.
+            *
+            * \return A pair of iterators to the end of the key and value output sequences.
+            */
+            template<
+                typename InputIterator1,
+                typename InputIterator2,
+                typename OutputIterator1,
+                typename OutputIterator2,
+                typename BinaryPredicate,
+                typename BinaryFunction>
+                pair<OutputIterator1, OutputIterator2>
+                reduce_by_key_unsorted(
+                control &ctl,
+                InputIterator1  keys_first,
+                InputIterator1  keys_last,
+                InputIterator2  values_first,
+                OutputIterator1  keys_output,
+                OutputIterator2  values_output,
+                BinaryPredicate binary_pred,
+                BinaryFunction binary_op,
+                const std::string& user_code="" );
+
+            template<
+                typename InputIterator1,
+                typename InputIterator2,
+                typename OutputIterator1,
+                typename OutputIterator2,
+                typename BinaryPredicate,
+                typename BinaryFunction>
+                pair<OutputIterator1, OutputIterator2>
+                reduce_by_key_unsorted(
+                InputIterator1  keys_first,
+                InputIterator1  keys_last,
+                InputIterator2  values_first,
+                OutputIterator1  keys_output,
+                OutputIterator2  values_output,
+                BinaryPredicate binary_pred,
+                BinaryFunction binary_op,
+                const std::string& user_code="" );
+
+            /*!   \}  */
+
+        };// end of bolt::cl
+};// end of bolt namespace
+
+#include <bolt/cl/detail/reduce_by_key_unsorted.inl>
+
+#endif
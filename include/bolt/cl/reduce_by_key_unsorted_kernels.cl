@@ -0,0 +1,204 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Hash aggregation for reduce_by_key_unsorted: every key claims a slot of an open-addressing table with
+//  atomic_cmpxchg, and its values are folded into that slot with the global atomic that matches the reduction.
+//  The host picks the reduction with -DREDUCE_BY_KEY_UNSORTED_OP and falls back to sorting when the table overflows.
+
+// #pragma OPENCL EXTENSION cl_amd_printf : enable
+
+#define REDUCE_BY_KEY_UNSORTED_PLUS     0
+#define REDUCE_BY_KEY_UNSORTED_MINIMUM  1
+#define REDUCE_BY_KEY_UNSORTED_MAXIMUM  2
+
+//  Bits of an empty table slot.  A key with these bits cannot be told apart from an empty slot, so it is kept in the
+//  one extra slot past the end of the table.
+#define REDUCE_BY_KEY_UNSORTED_EMPTY    0xFFFFFFFF
+
+//  Layout of the counters buffer
+#define REDUCE_BY_KEY_UNSORTED_OVERFLOW 0
+#define REDUCE_BY_KEY_UNSORTED_UNIQUE   1
+#define REDUCE_BY_KEY_UNSORTED_EMPTYKEY 2
+#define REDUCE_BY_KEY_UNSORTED_OUTPUT   3
+
+//  Finalizer of MurmurHash3; spreads keys that differ only in their high bits over the whole table
+inline uint hashKeyBits( uint bits )
+{
+    bits ^= bits >> 16;
+    bits *= 0x85ebca6b;
+    bits ^= bits >> 13;
+    bits *= 0xc2b2ae35;
+    bits ^= bits >> 16;
+    return bits;
+}
+
+inline void hashCombine( global int* slot, int value )
+{
+#if REDUCE_BY_KEY_UNSORTED_OP == REDUCE_BY_KEY_UNSORTED_PLUS
+    atomic_add( slot, value );
+#elif REDUCE_BY_KEY_UNSORTED_OP == REDUCE_BY_KEY_UNSORTED_MINIMUM
+    atomic_min( slot, value );
+#else
+    atomic_max( slot, value );
+#endif
+}
+
+inline void hashCombine( global uint* slot, uint value )
+{
+#if REDUCE_BY_KEY_UNSORTED_OP == REDUCE_BY_KEY_UNSORTED_PLUS
+    atomic_add( slot, value );
+#elif REDUCE_BY_KEY_UNSORTED_OP == REDUCE_BY_KEY_UNSORTED_MINIMUM
+    atomic_min( slot, value );
+#else
+    atomic_max( slot, value );
+#endif
+}
+
+//  There are no float atomics in OpenCL 1.x; retry the update with a compare-and-swap on the bits of the slot
+inline void hashCombine( global float* slot, float value )
+{
+    global volatile uint* slotBits = ( global volatile uint* )slot;
+    uint expected = *slotBits;
+    for( ;; )
+    {
+        float current = as_float( expected );
+#if REDUCE_BY_KEY_UNSORTED_OP == REDUCE_BY_KEY_UNSORTED_PLUS
+        float combined = current + value;
+#elif REDUCE_BY_KEY_UNSORTED_OP == REDUCE_BY_KEY_UNSORTED_MINIMUM
+        float combined = ( value < current ) ? value : current;
+#else
+        float combined = ( value > current ) ? value : current;
+#endif
+        if( as_uint( combined ) == expected )
+            return;
+
+        uint observed = atomic_cmpxchg( slotBits, expected, as_uint( combined ) );
+        if( observed == expected )
+            return;
+        expected = observed;
+    }
+}
+
+//  Inserts every (key, value) pair into the table.  A work-item never waits on another one: a slot is either claimed
+//  by the compare-and-swap or already holds a key, and keys are never moved once written.  When more unique keys
+//  arrive than half the table, or a probe sequence runs through the whole table, the overflow counter is raised and
+//  the host discards the table.
+template< typename kType, typename kIterType, typename vType, typename vIterType >
+kernel void hashAggregateTemplate(
+    global kType* keys_ptr,
+    kIterType keys_iter,
+    global vType* values_ptr,
+    vIterType values_iter,
+    const uint length,
+    const uint tableMask,
+    global kType* tableKeys,
+    global vType* tableValues,
+    global uint* counters )
+{
+    keys_iter.init( keys_ptr );
+    values_iter.init( values_ptr );
+
+    const kType emptyKey = ( kType )REDUCE_BY_KEY_UNSORTED_EMPTY;
+    const uint capacity = tableMask + 1;
+    global volatile uint* overflow = ( global volatile uint* )&counters[ REDUCE_BY_KEY_UNSORTED_OVERFLOW ];
+
+    for( uint index = get_global_id( 0 ); index < length; index += get_global_size( 0 ) )
+    {
+        if( *overflow )
+            return;
+
+        kType key = keys_iter[ index ];
+        vType value = values_iter[ index ];
+
+        uint slot = capacity;
+        if( key == emptyKey )
+        {
+            counters[ REDUCE_BY_KEY_UNSORTED_EMPTYKEY ] = 1;
+        }
+        else
+        {
+            uint probe = hashKeyBits( as_uint( key ) ) & tableMask;
+            uint step = 0;
+            for( ; step < capacity; ++step )
+            {
+                //  A plain load is enough to find a key that is already in place; only an empty slot needs the atomic
+                kType owner = tableKeys[ probe ];
+                if( owner == emptyKey )
+                {
+                    owner = atomic_cmpxchg( &tableKeys[ probe ], emptyKey, key );
+                    if( owner == emptyKey )
+                    {
+                        if( atomic_inc( &counters[ REDUCE_BY_KEY_UNSORTED_UNIQUE ] ) >= ( capacity >> 1 ) )
+                            *overflow = 1;
+                        break;
+                    }
+                }
+                if( owner == key )
+                    break;
+                probe = ( probe + 1 ) & tableMask;
+            }
+
+            if( step == capacity )
+            {
+                *overflow = 1;
+                return;
+            }
+            slot = probe;
+        }
+
+        hashCombine( &tableValues[ slot ], value );
+    }
+}
+
+//  Writes every occupied slot, and the extra slot if the empty-slot key was seen, to the outputs.  Each group takes
+//  its output position from a global counter, so the order of the groups depends on the table layout and on timing.
+template< typename kType, typename vType, typename koType, typename koIterType, typename voType, typename voIterType >
+kernel void hashCompactTemplate(
+    global kType* tableKeys,
+    global vType* tableValues,
+    const uint tableMask,
+    global uint* counters,
+    global koType* keys_output_ptr,
+    koIterType keys_output_iter,
+    global voType* values_output_ptr,
+    voIterType values_output_iter )
+{
+    keys_output_iter.init( keys_output_ptr );
+    values_output_iter.init( values_output_ptr );
+
+    const kType emptyKey = ( kType )REDUCE_BY_KEY_UNSORTED_EMPTY;
+    const uint capacity = tableMask + 1;
+
+    for( uint slot = get_global_id( 0 ); slot <= capacity; slot += get_global_size( 0 ) )
+    {
+        kType key = emptyKey;
+        if( slot < capacity )
+        {
+            key = tableKeys[ slot ];
+            if( key == emptyKey )
+                continue;
+        }
+        else if( !counters[ REDUCE_BY_KEY_UNSORTED_EMPTYKEY ] )
+        {
+            continue;
+        }
+
+        uint position = atomic_inc( &counters[ REDUCE_BY_KEY_UNSORTED_OUTPUT ] );
+        keys_output_iter[ position ] = key;
+        values_output_iter[ position ] = tableValues[ slot ];
+    }
+}
@@ -82,3 +82,135 @@ kernel void reduceTemplate(
         result[get_group_id(0)] = scratch[0];
     }
 };
+
+//  Finishes a reduction on the device: a single work-group combines the per work-group partials of the first pass
+//  with the initial value, and writes the result to a one element buffer.
+template< typename T, typename binary_function >
+kernel void reduceFinalTemplate(
+    global T* partials,
+    const int count,
+    const T init,
+    global binary_function* userFunctor,
+    global T* result,
+    local T* scratch
+)
+{
+    int local_index = get_local_id( 0 );
+    int gx = local_index;
+
+    T accumulator;
+    if( gx < count )
+    {
+        accumulator = partials[ gx ];
+        gx += get_local_size( 0 );
+    }
+
+    while( gx < count )
+    {
+        accumulator = (*userFunctor)( accumulator, partials[ gx ] );
+        gx += get_local_size( 0 );
+    }
+
+    scratch[ local_index ] = accumulator;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    _REDUCE_STEP( count, local_index, 32 );
+    _REDUCE_STEP( count, local_index, 16 );
+    _REDUCE_STEP( count, local_index,  8 );
+    _REDUCE_STEP( count, local_index,  4 );
+    _REDUCE_STEP( count, local_index,  2 );
+    _REDUCE_STEP( count, local_index,  1 );
+
+    if( local_index == 0 )
+        result[ 0 ] = (*userFunctor)( init, scratch[ 0 ] );
+};
+
+//  Reduces in a single launch.  Every work-group reduces its share of the input like reduceTemplate, writes its
+//  partial, and draws a ticket; the work-group that draws the last ticket knows that all the other partials are in
+//  global memory, combines them with the initial value, and writes the result.  The ticket must be zero at launch,
+//  and the host launches at most one work-group per 64 elements, so that every work-group has a partial.
+template< typename iTypePtr, typename iTypeIter, typename binary_function, typename T >
+kernel void reduceTicketTemplate(
+    global iTypePtr*    input_ptr,
+    iTypeIter input_iter,
+    const int length,
+    const T init,
+    global binary_function* userFunctor,
+    global T*    partials,
+    global uint* ticket,
+    global T*    result,
+    local T*     scratch
+)
+{
+    local uint isLastGroup;
+
+    int gx = get_global_id( 0 );
+    input_iter.init( input_ptr );
+
+    T accumulator;
+    if( gx < length )
+    {
+       accumulator = (T) input_iter[ gx ];
+       gx += get_global_size( 0 );
+    }
+
+    while( gx < length )
+    {
+        iTypePtr element = input_iter[ gx ];
+        accumulator = (*userFunctor)( accumulator, element );
+        gx += get_global_size( 0 );
+    }
+
+    int local_index = get_local_id( 0 );
+    scratch[ local_index ] = accumulator;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    uint tail = length - ( get_group_id( 0 ) * get_local_size( 0 ) );
+
+    _REDUCE_STEP( tail, local_index, 32 );
+    _REDUCE_STEP( tail, local_index, 16 );
+    _REDUCE_STEP( tail, local_index,  8 );
+    _REDUCE_STEP( tail, local_index,  4 );
+    _REDUCE_STEP( tail, local_index,  2 );
+    _REDUCE_STEP( tail, local_index,  1 );
+
+    //  The fence orders the store of the partial before the ticket, so the last work-group cannot see the ticket
+    //  of a work-group whose partial is not visible yet
+    if( local_index == 0 )
+    {
+        partials[ get_group_id( 0 ) ] = scratch[ 0 ];
+        mem_fence( CLK_GLOBAL_MEM_FENCE );
+        isLastGroup = ( atomic_inc( ticket ) == get_num_groups( 0 ) - 1 );
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    if( !isLastGroup )
+        return;
+
+    int count = get_num_groups( 0 );
+    gx = local_index;
+    if( gx < count )
+    {
+        accumulator = partials[ gx ];
+        gx += get_local_size( 0 );
+    }
+
+    while( gx < count )
+    {
+        accumulator = (*userFunctor)( accumulator, partials[ gx ] );
+        gx += get_local_size( 0 );
+    }
+
+    scratch[ local_index ] = accumulator;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    _REDUCE_STEP( count, local_index, 32 );
+    _REDUCE_STEP( count, local_index, 16 );
+    _REDUCE_STEP( count, local_index,  8 );
+    _REDUCE_STEP( count, local_index,  4 );
+    _REDUCE_STEP( count, local_index,  2 );
+    _REDUCE_STEP( count, local_index,  1 );
+
+    if( local_index == 0 )
+        result[ 0 ] = (*userFunctor)( init, scratch[ 0 ] );
+};
@@ -245,6 +245,117 @@ OutputIterator
     const std::string& user_code="" );
 
 
+/*! \brief \p inclusive_scan_with_carry scans one batch of a longer stream.  The scan starts from the carry instead
+ *   of restarting, and the carry is replaced by the last value of the scan, so the next batch continues where this
+ *   one ended.  The carry lives in a device_vector of one element, so on the device path it is read and written by
+ *   the scan kernels without a round trip through the host.
+ *   inclusive_scan_with_carry requires associativity of the binary operation to parallelize it.
+ *
+ * \param ctl A \b Optional Bolt control object, to describe the environment under which the function runs.
+ * \param first The first iterator in the input range to be scanned.
+ * \param last  The last iterator in the input range to be scanned.
+ * \param result  The first iterator in the output range.
+ * \param carry A device_vector whose first element is the running value before the batch; on return it holds the
+ *   running value after the batch.  Seed it with the identity of \p binary_op before the first batch.
+ * \param binary_op A functor object specifying the operation between two elements in the input range.
+ * \param user_code A client-specified string that is appended to the generated OpenCL kernel.
+ * \tparam InputIterator An iterator signifying the range is used as input.
+ * \tparam OutputIterator An iterator signifying the range is used as output.
+ * \tparam T is std::iterator_traits< OutputIterator >::value_type.
+ * \tparam BinaryFunction implements a binary function; its result should be convertible to
+ *   std::iterator_traits< OutputIterator >::value_type.
+ * \return An iterator pointing at the end of the result range.
+ *
+ * \code
+ * #include "bolt/cl/scan.h"
+ *
+ * int a[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+ * bolt::cl::device_vector< int > carry( 1, 0 );
+ *
+ * // Scan the stream in two batches
+ * bolt::cl::inclusive_scan_with_carry( a, a+5, a, carry );
+ * // a => {1, 3, 6, 10, 15, 6, 7, 8, 9, 10}, carry[ 0 ] => 15
+ * bolt::cl::inclusive_scan_with_carry( a+5, a+10, a+5, carry );
+ * // a => {1, 3, 6, 10, 15, 21, 28, 36, 45, 55}, carry[ 0 ] => 55
+ *  \endcode
+ * \sa http://www.sgi.com/tech/stl/partial_sum.html
+ */
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator
+    inclusive_scan_with_carry( control &ctl, InputIterator first, InputIterator last, OutputIterator result,
+    device_vector< T >& carry, BinaryFunction binary_op, const std::string& user_code="" );
+
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator
+    inclusive_scan_with_carry( InputIterator first, InputIterator last, OutputIterator result,
+    device_vector< T >& carry, BinaryFunction binary_op, const std::string& user_code="" );
+
+template< typename InputIterator, typename OutputIterator, typename T >
+OutputIterator
+    inclusive_scan_with_carry( control &ctl, InputIterator first, InputIterator last, OutputIterator result,
+    device_vector< T >& carry, const std::string& user_code="" );
+
+template< typename InputIterator, typename OutputIterator, typename T >
+OutputIterator
+    inclusive_scan_with_carry( InputIterator first, InputIterator last, OutputIterator result,
+    device_vector< T >& carry, const std::string& user_code="" );
+
+/*! \brief \p exclusive_scan_with_carry scans one batch of a longer stream, exclusive of the current value.  The
+ *   first output of the batch is the carry, and the carry is replaced by the running value that includes the whole
+ *   batch, so the next batch continues where this one ended.  The carry lives in a device_vector of one element, so
+ *   on the device path it is read and written by the scan kernels without a round trip through the host.
+ *   exclusive_scan_with_carry requires associativity of the binary operation to parallelize it.
+ *
+ * \param ctl A \b Optional Bolt control object, to describe the environment under which the function runs.
+ * \param first The first iterator in the input range to be scanned.
+ * \param last  The last iterator in the input range to be scanned.
+ * \param result  The first iterator in the output range.
+ * \param carry A device_vector whose first element is the running value before the batch; on return it holds the
+ *   running value after the batch.  Before the first batch it plays the role of \p init in exclusive_scan.
+ * \param binary_op A functor object specifying the operation between two elements in the input range.
+ * \param user_code A client-specified string that is appended to the generated OpenCL kernel.
+ * \tparam InputIterator An iterator signifying the range is used as input.
+ * \tparam OutputIterator An iterator signifying the range is used as output.
+ * \tparam T is std::iterator_traits< OutputIterator >::value_type.
+ * \tparam BinaryFunction implements a binary function; its result should be convertible to
+ *   std::iterator_traits< OutputIterator >::value_type.
+ * \return An iterator pointing at the end of the result range.
+ *
+ * \code
+ * #include "bolt/cl/scan.h"
+ *
+ * int a[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+ * bolt::cl::device_vector< int > carry( 1, 0 );
+ *
+ * // Scan the stream in two batches
+ * bolt::cl::exclusive_scan_with_carry( a, a+5, a, carry );
+ * // a => {0, 1, 3, 6, 10, 6, 7, 8, 9, 10}, carry[ 0 ] => 15
+ * bolt::cl::exclusive_scan_with_carry( a+5, a+10, a+5, carry );
+ * // a => {0, 1, 3, 6, 10, 15, 21, 28, 36, 45}, carry[ 0 ] => 55
+ *  \endcode
+ * \sa http://www.sgi.com/tech/stl/partial_sum.html
+ */
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator
+    exclusive_scan_with_carry( control &ctl, InputIterator first, InputIterator last, OutputIterator result,
+    device_vector< T >& carry, BinaryFunction binary_op, const std::string& user_code="" );
+
+template< typename InputIterator, typename OutputIterator, typename T, typename BinaryFunction >
+OutputIterator
+    exclusive_scan_with_carry( InputIterator first, InputIterator last, OutputIterator result,
+    device_vector< T >& carry, BinaryFunction binary_op, const std::string& user_code="" );
+
+template< typename InputIterator, typename OutputIterator, typename T >
+OutputIterator
+    exclusive_scan_with_carry( control &ctl, InputIterator first, InputIterator last, OutputIterator result,
+    device_vector< T >& carry, const std::string& user_code="" );
+
+template< typename InputIterator, typename OutputIterator, typename T >
+OutputIterator
+    exclusive_scan_with_carry( InputIterator first, InputIterator last, OutputIterator result,
+    device_vector< T >& carry, const std::string& user_code="" );
+
+
 /*!   \}  */
 }// end of bolt::cl namespace
 }// end of bolt namespace
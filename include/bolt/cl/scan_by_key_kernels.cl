@@ -376,3 +376,164 @@ __kernel void perBlockAdditionByKey(
     output_iter[ gloId ] = newResult;
     
 }
+
+
+/******************************************************************************
+ *  Single-pass scan by key with decoupled look-back
+ *****************************************************************************/
+//  The look-back helpers come from lookback_kernels.cl, which the host prepends to this source.
+
+//  A tile is SCAN_ITEMS_PER_WORKITEM elements per work-item.  The tile moves between global and local memory in
+//  coalesced strides, and every work-item runs a segmented scan of SCAN_ITEMS_PER_WORKITEM consecutive elements in
+//  registers, so only one (head, value) pair per work-item goes through the local memory scan.
+template<
+    typename kType,
+    typename kIterType,
+    typename vType,
+    typename iIterType,
+    typename oType,
+    typename oIterType,
+    typename initType,
+    typename BinaryPredicate,
+    typename BinaryFunction >
+__kernel void singlePassScanByKey(
+    global kType *keys,
+    kIterType    keys_iter,
+    global vType *vals,
+    iIterType     vals_iter,
+    global oType *output,
+    oIterType     output_iter,
+    initType init,
+    const uint vecSize,
+    local uint   *ldsHeads,
+    local oType  *ldsVals,
+    global BinaryPredicate *binaryPred,
+    global BinaryFunction *binaryFunct,
+    global uint *tileStatus,
+    global uint *tileValues,
+    int exclusive )
+{
+    local uint tileIndex;
+    size_t locId = get_local_id( 0 );
+    size_t wgSize = get_local_size( 0 );
+    output_iter.init( output );
+    vals_iter.init( vals );
+    keys_iter.init( keys );
+
+    if( locId == 0 )
+        tileIndex = atomic_inc( tileStatus );
+    barrier( CLK_LOCAL_MEM_FENCE );
+    uint tile = tileIndex;
+    uint tileSize = ( uint )wgSize * SCAN_ITEMS_PER_WORKITEM;
+    uint tileStart = tile * tileSize;
+    uint tileCount = min( tileSize, vecSize - tileStart );
+
+    // an element is the head of a segment when its key differs from the key before it
+    for( uint i = locId; i < tileCount; i += wgSize )
+    {
+        uint index = tileStart + i;
+        uint head = 1;
+        if( index > 0 )
+        {
+            kType key = keys_iter[ index ];
+            kType prevKey = keys_iter[ index - 1 ];
+            head = (*binaryPred)( key, prevKey ) ? 0 : 1;
+        }
+        ldsHeads[ i ] = head;
+        // if exclusive, every segment starts with init and its values are shifted right by one
+        if( exclusive && head )
+            ldsVals[ i ] = init;
+        else
+            ldsVals[ i ] = vals_iter[ exclusive ? index - 1 : index ];
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    // Serial segmented scan of the elements of the work-item; itemHeads[ k ] tells whether a head lies between the
+    // first element of the work-item and element k, in which case element k needs no carry from before
+    oType items[ SCAN_ITEMS_PER_WORKITEM ];
+    uint itemHeads[ SCAN_ITEMS_PER_WORKITEM ];
+    uint first = locId * SCAN_ITEMS_PER_WORKITEM;
+    uint count = ( first < tileCount ) ? min( ( uint )SCAN_ITEMS_PER_WORKITEM, tileCount - first ) : 0;
+    for( uint k = 0; k < count; ++k )
+    {
+        uint head = ldsHeads[ first + k ];
+        oType y = ldsVals[ first + k ];
+        if( k == 0 || head )
+            items[ k ] = y;
+        else
+            items[ k ] = (*binaryFunct)( items[ k - 1 ], y );
+        itemHeads[ k ] = ( k == 0 ) ? head : ( itemHeads[ k - 1 ] | head );
+    }
+    uint segmentHead = itemHeads[ count ? count - 1 : 0 ];
+    oType sum = items[ count ? count - 1 : 0 ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    // Computes a segmented scan of the work-item totals within the tile
+    ldsHeads[ locId ] = segmentHead;
+    ldsVals[ locId ] = sum;
+    for( size_t offset = 1; offset < wgSize; offset *= 2 )
+    {
+        barrier( CLK_LOCAL_MEM_FENCE );
+        if( locId >= offset && count > 0 )
+        {
+            uint prevHead = ldsHeads[ locId - offset ];
+            oType y = ldsVals[ locId - offset ];
+            if( !segmentHead )
+                sum = (*binaryFunct)( y, sum );
+            segmentHead |= prevHead;
+        }
+        barrier( CLK_LOCAL_MEM_FENCE );
+        ldsHeads[ locId ] = segmentHead;
+        ldsVals[ locId ] = sum;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    uint threadPrefixHead = 1;
+    oType threadPrefix;
+    if( locId > 0 )
+    {
+        threadPrefixHead = ldsHeads[ locId - 1 ];
+        threadPrefix = ldsVals[ locId - 1 ];
+    }
+    uint closed = ldsHeads[ ( tileCount - 1 ) / SCAN_ITEMS_PER_WORKITEM ];
+    oType aggregate = ldsVals[ ( tileCount - 1 ) / SCAN_ITEMS_PER_WORKITEM ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  One work-item chains the tile to its predecessors and hands the exclusive prefix to the others through lds;
+    //  the prefix is only needed when the tile does not start a segment.  A tile that contains the start of a segment
+    //  publishes its inclusive prefix right away, so the look-back never crosses a segment.
+    if( locId == 0 )
+    {
+        if( tile == 0 || closed )
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, aggregate );
+        else
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_AGGREGATE, aggregate );
+
+        if( tile > 0 && !itemHeads[ 0 ] )
+        {
+            oType prefix = lookBackPrefix< oType >( tileStatus, tileValues, tile, binaryFunct );
+            if( !closed )
+                lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX,
+                    (*binaryFunct)( prefix, aggregate ) );
+            ldsVals[ 0 ] = prefix;
+        }
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    // The carry of a work-item is the scan of everything before it in its segment
+    uint hasCarry = ( locId > 0 ) || ( tile > 0 );
+    oType carry = threadPrefix;
+    if( tile > 0 && ( locId == 0 || !threadPrefixHead ) )
+    {
+        oType tilePrefix = ldsVals[ 0 ];
+        carry = ( locId > 0 ) ? (*binaryFunct)( tilePrefix, threadPrefix ) : tilePrefix;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint k = 0; k < count; ++k )
+        ldsVals[ first + k ] = ( hasCarry && !itemHeads[ k ] ) ? (*binaryFunct)( carry, items[ k ] ) : items[ k ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint i = locId; i < tileCount; i += wgSize )
+        output_iter[ tileStart + i ] = ldsVals[ i ];
+}
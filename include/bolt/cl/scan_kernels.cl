@@ -15,61 +15,6 @@
 
 ***************************************************************************/
 #pragma OPENCL EXTENSION cl_amd_printf : enable
-//#define USE_AMD_HSA 1
-
-#if USE_AMD_HSA
-
-/******************************************************************************
- *  HSA Kernel
- *****************************************************************************/
-template< typename iType, typename oType, typename initType, typename BinaryFunction >
-kernel void HSA_Scan(
-    global oType    *output,
-    global iType    *input,
-    initType        init,
-    const uint      numElements,
-    const uint      numIterations,
-    local oType     *lds,
-    global BinaryFunction* binaryOp,
-    global oType    *intermediateScanArray,
-    global int      *dev2host,
-    global int      *host2dev,
-    int             exclusive)
-{
-    size_t gloId = get_global_id( 0 );
-    size_t groId = get_group_id( 0 );
-    size_t locId = get_local_id( 0 );
-    size_t wgSize = get_local_size( 0 );
-
-    // report P1 completion
-    intermediateScanArray[ groId ] = input[ groId ];
-    dev2host[ groId ] = 1;
-
-
-
-    // wait for P2 completion
-    for (size_t i = 0; i < 10000; i++ )
-    {
-        mem_fence(CLK_GLOBAL_MEM_FENCE);
-        //printf("DEV: interScan[%i]=%i ( %i, %i )", groId, intermediateScanArray[groId], dev2host[groId], host2dev[groId]);
-        if ( host2dev[ groId] == 2 )
-        { // host reported P2 completion
-            // report P3 completion
-            dev2host[ groId ] = 3;
-            break;
-        }
-    }
-}
-
-
-
-
-
-
-/******************************************************************************
- *  Not Using HSA
- *****************************************************************************/
-#else
 
 #define NUM_ITER 16
 #define MIN(X,Y) X<Y?X:Y;
@@ -326,5 +271,164 @@ kernel void perBlockInclusiveScan(
   
 }
 
-// not using HSA
-#endif
+
+
+/******************************************************************************
+ *  Single-pass scan with decoupled look-back
+ *****************************************************************************/
+//  The look-back helpers come from lookback_kernels.cl, which the host prepends to this source.
+
+//  A tile is SCAN_ITEMS_PER_WORKITEM elements per work-item.  The tile moves between global and local memory in
+//  coalesced strides, and every work-item scans SCAN_ITEMS_PER_WORKITEM consecutive elements in registers, so only one
+//  value per work-item goes through the local memory scan.
+//  An exclusive scan is the inclusive scan with identity (or the carry) in front, shifted right by one when the tile is
+//  stored; a tile reads no input outside of itself, so the scan may run in place.
+template< typename iPtrType, typename iIterType, typename oPtrType, typename oIterType, typename initType,
+    typename BinaryFunction >
+kernel void singlePassScan(
+                global oPtrType* output_ptr,
+                oIterType    output_iter,
+                global iPtrType* input_ptr,
+                iIterType    input_iter,
+                initType identity,
+                const uint vecSize,
+                local iPtrType* lds,
+                global BinaryFunction* binaryOp,
+                global uint* tileStatus,
+                global uint* tileValues,
+                int exclusive,
+                global oPtrType* carry,
+                int useCarry )
+{
+    local uint tileIndex;
+    size_t locId = get_local_id( 0 );
+    size_t wgSize = get_local_size( 0 );
+    output_iter.init( output_ptr );
+    input_iter.init( input_ptr );
+
+    if( locId == 0 )
+        tileIndex = atomic_inc( tileStatus );
+    barrier( CLK_LOCAL_MEM_FENCE );
+    uint tile = tileIndex;
+    uint tileSize = ( uint )wgSize * SCAN_ITEMS_PER_WORKITEM;
+    uint tileStart = tile * tileSize;
+    uint tileCount = min( tileSize, vecSize - tileStart );
+
+    for( uint i = locId; i < tileCount; i += wgSize )
+        lds[ i ] = input_iter[ tileStart + i ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Serial scan of the elements of the work-item
+    iPtrType items[ SCAN_ITEMS_PER_WORKITEM ];
+    uint first = locId * SCAN_ITEMS_PER_WORKITEM;
+    uint count = ( first < tileCount ) ? min( ( uint )SCAN_ITEMS_PER_WORKITEM, tileCount - first ) : 0;
+    for( uint k = 0; k < count; ++k )
+    {
+        iPtrType y = lds[ first + k ];
+        items[ k ] = ( k == 0 ) ? y : (*binaryOp)( items[ k - 1 ], y );
+    }
+    iPtrType sum = items[ count ? count - 1 : 0 ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Computes a scan of the work-item totals within the tile
+    lds[ locId ] = sum;
+    for( size_t offset = 1; offset < wgSize; offset *= 2 )
+    {
+        barrier( CLK_LOCAL_MEM_FENCE );
+        if( locId >= offset && count > 0 )
+        {
+            iPtrType y = lds[ locId - offset ];
+            sum = (*binaryOp)( y, sum );
+        }
+        barrier( CLK_LOCAL_MEM_FENCE );
+        lds[ locId ] = sum;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    iPtrType threadPrefix;
+    if( locId > 0 )
+        threadPrefix = lds[ locId - 1 ];
+    iPtrType aggregate = lds[ ( tileCount - 1 ) / SCAN_ITEMS_PER_WORKITEM ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  One work-item chains the tile to its predecessors and hands the exclusive prefix to the others through lds.
+    //  The first tile starts from the carry when there is one, and from identity for an exclusive scan.  The last
+    //  tile writes the carry out; it only gets there after the look-back has seen the first tile, which read the carry
+    //  in before publishing anything.
+    uint hasTilePrefix = ( tile > 0 ) || useCarry || exclusive;
+    if( locId == 0 )
+    {
+        iPtrType prefix;
+        iPtrType inclusivePrefix = aggregate;
+        if( tile == 0 )
+        {
+            if( hasTilePrefix )
+            {
+                prefix = useCarry ? ( iPtrType )carry[ 0 ] : ( iPtrType )identity;
+                inclusivePrefix = (*binaryOp)( prefix, aggregate );
+            }
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, inclusivePrefix );
+        }
+        else
+        {
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_AGGREGATE, aggregate );
+            prefix = lookBackPrefix< iPtrType >( tileStatus, tileValues, tile, binaryOp );
+            inclusivePrefix = (*binaryOp)( prefix, aggregate );
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, inclusivePrefix );
+        }
+        if( hasTilePrefix )
+            lds[ 0 ] = prefix;
+        if( useCarry && tileStart + tileCount == vecSize )
+            carry[ 0 ] = inclusivePrefix;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    if( hasTilePrefix )
+    {
+        iPtrType tilePrefix = lds[ 0 ];
+        threadPrefix = ( locId > 0 ) ? (*binaryOp)( tilePrefix, threadPrefix ) : tilePrefix;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint k = 0; k < count; ++k )
+        lds[ first + k ] = ( hasTilePrefix || locId > 0 ) ? (*binaryOp)( threadPrefix, items[ k ] ) : items[ k ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  The first element of the tile is handled by work-item 0, whose threadPrefix is the prefix of the tile
+    for( uint i = locId; i < tileCount; i += wgSize )
+    {
+        if( !exclusive )
+            output_iter[ tileStart + i ] = lds[ i ];
+        else
+            output_iter[ tileStart + i ] = ( i > 0 ) ? lds[ i - 1 ] : threadPrefix;
+    }
+}
+
+//  Folds a carry into a scan that was computed without one, since the multi-pass kernels have no carry.  scanned
+//  holds the inclusive scan of the batch; an exclusive scan reads it one position to the left.  carryIn is a copy of
+//  the carry, so that the carry can be written out while other work-groups still read the old value.
+template< typename oPtrType, typename oIterType, typename BinaryFunction >
+kernel void scanApplyCarry(
+                global oPtrType* output_ptr,
+                oIterType    output_iter,
+                global oPtrType* scanned,
+                const uint vecSize,
+                global oPtrType* carryIn,
+                global oPtrType* carry,
+                global BinaryFunction* binaryOp,
+                int exclusive )
+{
+    output_iter.init( output_ptr );
+    oPtrType carryValue = carryIn[ 0 ];
+
+    if( get_global_id( 0 ) == 0 )
+        carry[ 0 ] = (*binaryOp)( carryValue, scanned[ vecSize - 1 ] );
+
+    for( uint i = get_global_id( 0 ); i < vecSize; i += get_global_size( 0 ) )
+    {
+        if( exclusive )
+            output_iter[ i ] = ( i > 0 ) ? (*binaryOp)( carryValue, scanned[ i - 1 ] ) : carryValue;
+        else
+            output_iter[ i ] = (*binaryOp)( carryValue, scanned[ i ] );
+    }
+}
@@ -0,0 +1,133 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SEGMENTED_REDUCE_H )
+#define BOLT_CL_SEGMENTED_REDUCE_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+
+#include <string>
+
+/*! \file bolt/cl/segmented_reduce.h
+    \brief Reduces every segment of a sequence, where the segments are given by a CSR style offset array.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-segmented_reduce
+        *   \ingroup reductions
+        *   \{
+        *   \details Reducing many short segments one reduce call at a time pays for a kernel lookup, a functor
+        *   buffer and a blocking map per segment.  segmented_reduce reduces all of them in a single launch.  The
+        *   segments are described the way a CSR matrix describes its rows: segment i is
+        *   [first + offsets[ i ], first + offsets[ i + 1 ]), so n + 1 offsets describe n segments.  The OpenCL path
+        *   picks the number of work-items that share a segment from the mean segment length: a handful for short
+        *   segments, up to a wavefront or a whole work-group per segment for long ones.  Segments far longer than
+        *   the mean are reduced in a second pass with a whole work-group each.  The input, the offsets and the
+        *   output have to live in the same kind of memory: all of them in host memory, or all of them in
+        *   device_vectors.
+        */
+
+        /*! \brief \p segmented_reduce writes the reduction of every segment of [first, last) to \p result, one value
+        * per segment.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first  The beginning of the input sequence.
+        * \param last   The end of the input sequence.
+        * \param offsets_first The beginning of the offset array.  The offsets are relative to \p first, are sorted
+        * in ascending order and lie in [0, last - first].
+        * \param offsets_last  The end of the offset array; it holds one offset more than there are segments.
+        * \param result The beginning of the output sequence.
+        * \param init   \b Optional The value every segment starts with; empty segments are reduced to it.  Zero by
+        * default.
+        * \param binary_op \b Optional The operation the segments are reduced with; plus by default.  It must be
+        * associative and commutative.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return The end of the output sequence.
+        *
+        * \details The following code example sums three segments.
+        * \code
+        * #include <bolt/cl/segmented_reduce.h>
+        *
+        * int vals[ 8 ]    = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        * int offsets[ 5 ] = { 0, 3, 5, 5, 8 };
+        * int out[ 4 ];
+        *
+        * bolt::cl::segmented_reduce( vals, vals + 8, offsets, offsets + 5, out );
+        * // out => { 6, 9, 0, 21 }
+        *  \endcode
+        * \sa reduce_by_key
+        */
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator>
+        OutputIterator segmented_reduce(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator>
+        OutputIterator segmented_reduce(InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_reduce(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_reduce(InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/segmented_reduce.inl>
+
+#endif
@@ -0,0 +1,156 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Reduces all the segments of a CSR style offset array.  A work-group is split into lane groups of lanesPerSegment
+//  work-items, and every lane group reduces one segment at a time, so a work-group covers many short segments at
+//  once.  A segment longer than longThreshold would leave its lane group looping long after the others are done; it
+//  is put on a list instead, and a second kernel reduces the listed segments with a whole work-group each.
+
+//#pragma OPENCL EXTENSION cl_amd_printf : enable
+
+//  Reduces [begin, end) with the lanesPerSegment work-items of a lane group, which is a power of two that divides the
+//  work-group size.  Every work-item of the work-group calls it; on return lane 0 of the lane group holds the
+//  reduction in scratch[ localId ], and the result is the number of lanes that held a value.
+template< typename iIterType, typename oType, typename binary_function >
+inline uint segmentedReduceLaneGroup(
+    iIterType input_iter,
+    int begin,
+    int end,
+    uint lanesPerSegment,
+    global binary_function* userFunctor,
+    local oType* scratch )
+{
+    uint localId = get_local_id( 0 );
+    uint lane = localId & ( lanesPerSegment - 1 );
+
+    //  The lanes stride through the segment, so neighbouring lanes read neighbouring elements
+    int index = begin + lane;
+    if( index < end )
+    {
+        oType accumulator = input_iter[ index ];
+        for( index += lanesPerSegment; index < end; index += lanesPerSegment )
+            accumulator = (*userFunctor)( accumulator, input_iter[ index ] );
+        scratch[ localId ] = accumulator;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Only the first min( length, lanesPerSegment ) lanes hold a value
+    uint active = ( end > begin ) ? min( ( uint )( end - begin ), lanesPerSegment ) : 0;
+    for( uint width = lanesPerSegment / 2; width > 0; width /= 2 )
+    {
+        if( ( lane < width ) && ( lane + width < active ) )
+            scratch[ localId ] = (*userFunctor)( scratch[ localId ], scratch[ localId + width ] );
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+    return active;
+}
+
+template< typename iType, typename iIterType, typename sType, typename sIterType, typename oType,
+          typename oIterType, typename binary_function >
+kernel void segmentedReduceTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    global sType* offsets_ptr,
+    sIterType offsets_iter,
+    global oType* output_ptr,
+    oIterType output_iter,
+    const uint numSegments,
+    const uint lanesPerSegment,
+    const uint longThreshold,
+    global uint* longSegments,
+    global uint* longCount,
+    const oType init,
+    global binary_function* userFunctor,
+    local oType* scratch
+)
+{
+    input_iter.init( input_ptr );
+    offsets_iter.init( offsets_ptr );
+    output_iter.init( output_ptr );
+
+    uint localId = get_local_id( 0 );
+    uint lane = localId & ( lanesPerSegment - 1 );
+    uint segmentsPerGroup = get_local_size( 0 ) / lanesPerSegment;
+    uint slot = localId / lanesPerSegment;
+
+    //  Every work-item runs the same number of iterations, so the barriers are reached by the whole work-group
+    for( uint base = get_group_id( 0 ) * segmentsPerGroup; base < numSegments;
+         base += get_num_groups( 0 ) * segmentsPerGroup )
+    {
+        uint segment = base + slot;
+        int begin = 0;
+        int end = 0;
+        bool isLong = false;
+        if( segment < numSegments )
+        {
+            begin = offsets_iter[ segment ];
+            end = offsets_iter[ segment + 1 ];
+            isLong = ( uint )( end - begin ) > longThreshold;
+        }
+
+        if( isLong )
+        {
+            if( lane == 0 )
+                longSegments[ atomic_inc( longCount ) ] = segment;
+            end = begin;
+        }
+
+        uint active = segmentedReduceLaneGroup( input_iter, begin, end, lanesPerSegment, userFunctor, scratch );
+
+        if( ( lane == 0 ) && ( segment < numSegments ) && !isLong )
+            output_iter[ segment ] = active ? (*userFunctor)( init, scratch[ localId ] ) : init;
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+};
+
+//  Reduces the segments segmentedReduceTemplate put on the list, one whole work-group per segment
+template< typename iType, typename iIterType, typename sType, typename sIterType, typename oType,
+          typename oIterType, typename binary_function >
+kernel void segmentedReduceLongTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    global sType* offsets_ptr,
+    sIterType offsets_iter,
+    global oType* output_ptr,
+    oIterType output_iter,
+    global uint* longSegments,
+    global uint* longCount,
+    const oType init,
+    global binary_function* userFunctor,
+    local oType* scratch
+)
+{
+    input_iter.init( input_ptr );
+    offsets_iter.init( offsets_ptr );
+    output_iter.init( output_ptr );
+
+    uint localId = get_local_id( 0 );
+    uint numLong = longCount[ 0 ];
+    for( uint entry = get_group_id( 0 ); entry < numLong; entry += get_num_groups( 0 ) )
+    {
+        uint segment = longSegments[ entry ];
+        int begin = offsets_iter[ segment ];
+        int end = offsets_iter[ segment + 1 ];
+
+        segmentedReduceLaneGroup( input_iter, begin, end, ( uint )get_local_size( 0 ), userFunctor, scratch );
+
+        //  A listed segment is never empty, so lane 0 always holds a value
+        if( localId == 0 )
+            output_iter[ segment ] = (*userFunctor)( init, scratch[ 0 ] );
+        barrier( CLK_LOCAL_MEM_FENCE );
+    }
+};
@@ -0,0 +1,296 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SEGMENTED_SCAN_H )
+#define BOLT_CL_SEGMENTED_SCAN_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+
+#include <string>
+
+/*! \file bolt/cl/segmented_scan.h
+    \brief Scans every segment of a sequence, where the segments are given by head flags or by their offsets.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup PrefixSums Prefix Sums
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-segmented_scan
+        *   \ingroup PrefixSums
+        *   \{
+        *   \details scan_by_key finds the segment boundaries by comparing every key with the key before it.  When
+        *   the boundaries are already known, these functions take them directly, either as a head flag per element
+        *   (non-zero for the first element of a segment) or as the offsets at which the segments start.  The first
+        *   element of the sequence always starts a segment.  The input, the flags or offsets and the output have to
+        *   live in the same kind of memory: all of them in host memory, or all of them in device_vectors.
+        */
+
+        /*! \brief \p segmented_inclusive_scan computes an inclusive scan of every segment of [first, last); the
+        * segments are marked by \p flags.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first  The beginning of the input sequence.
+        * \param last   The end of the input sequence.
+        * \param flags  The beginning of the head flag sequence; a non-zero flag starts a new segment.
+        * \param result The beginning of the output sequence; it may be equal to \p first.
+        * \param binary_op \b Optional The associative operation the segments are scanned with; plus by default.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return The end of the output sequence.
+        *
+        * \details The following code example scans three segments.
+        * \code
+        * #include <bolt/cl/segmented_scan.h>
+        *
+        * int vals[ 8 ]  = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        * int flags[ 8 ] = { 1, 0, 0, 1, 0, 1, 0, 0 };
+        * int out[ 8 ];
+        *
+        * bolt::cl::segmented_inclusive_scan( vals, vals + 8, flags, out );
+        * // out => { 1, 3, 6, 4, 9, 6, 13, 21 }
+        *  \endcode
+        * \sa inclusive_scan_by_key
+        */
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator>
+        OutputIterator segmented_inclusive_scan(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator>
+        OutputIterator segmented_inclusive_scan(InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename BinaryFunction>
+        OutputIterator segmented_inclusive_scan(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename BinaryFunction>
+        OutputIterator segmented_inclusive_scan(InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        /*! \brief \p segmented_exclusive_scan computes an exclusive scan of every segment of [first, last); the
+        * segments are marked by \p flags, and the first output of every segment is \p init.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first  The beginning of the input sequence.
+        * \param last   The end of the input sequence.
+        * \param flags  The beginning of the head flag sequence; a non-zero flag starts a new segment.
+        * \param result The beginning of the output sequence; it may be equal to \p first.
+        * \param init   The value every segment starts with.
+        * \param binary_op \b Optional The associative operation the segments are scanned with; plus by default.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return The end of the output sequence.
+        *
+        * \details
+        * \code
+        * int vals[ 8 ]  = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        * int flags[ 8 ] = { 1, 0, 0, 1, 0, 1, 0, 0 };
+        * int out[ 8 ];
+        *
+        * bolt::cl::segmented_exclusive_scan( vals, vals + 8, flags, out, 0 );
+        * // out => { 0, 1, 3, 0, 4, 0, 6, 13 }
+        *  \endcode
+        * \sa exclusive_scan_by_key
+        */
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T>
+        OutputIterator segmented_exclusive_scan(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            T init,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T>
+        OutputIterator segmented_exclusive_scan(InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            T init,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_exclusive_scan(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename FlagIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_exclusive_scan(InputIterator first,
+            InputIterator last,
+            FlagIterator flags,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        /*! \brief \p segmented_inclusive_scan_by_offsets computes an inclusive scan of every segment of
+        * [first, last); the segments start at the positions in [offsets_first, offsets_last).
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first  The beginning of the input sequence.
+        * \param last   The end of the input sequence.
+        * \param offsets_first The beginning of the segment offsets.  The offsets need not be sorted; offsets
+        * outside of [0, last - first) are ignored.
+        * \param offsets_last  The end of the segment offsets.
+        * \param result The beginning of the output sequence; it may be equal to \p first.
+        * \param binary_op \b Optional The associative operation the segments are scanned with; plus by default.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return The end of the output sequence.
+        *
+        * \details
+        * \code
+        * int vals[ 8 ]    = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        * int offsets[ 3 ] = { 0, 3, 5 };
+        * int out[ 8 ];
+        *
+        * bolt::cl::segmented_inclusive_scan_by_offsets( vals, vals + 8, offsets, offsets + 3, out );
+        * // out => { 1, 3, 6, 4, 9, 6, 13, 21 }
+        *  \endcode
+        */
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator>
+        OutputIterator segmented_inclusive_scan_by_offsets(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator>
+        OutputIterator segmented_inclusive_scan_by_offsets(InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction>
+        OutputIterator segmented_inclusive_scan_by_offsets(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename BinaryFunction>
+        OutputIterator segmented_inclusive_scan_by_offsets(InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        /*! \brief \p segmented_exclusive_scan_by_offsets computes an exclusive scan of every segment of
+        * [first, last); the segments start at the positions in [offsets_first, offsets_last), and the first output
+        * of every segment is \p init.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first  The beginning of the input sequence.
+        * \param last   The end of the input sequence.
+        * \param offsets_first The beginning of the segment offsets.  The offsets need not be sorted; offsets
+        * outside of [0, last - first) are ignored.
+        * \param offsets_last  The end of the segment offsets.
+        * \param result The beginning of the output sequence; it may be equal to \p first.
+        * \param init   The value every segment starts with.
+        * \param binary_op \b Optional The associative operation the segments are scanned with; plus by default.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \return The end of the output sequence.
+        */
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T>
+        OutputIterator segmented_exclusive_scan_by_offsets(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            T init,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T>
+        OutputIterator segmented_exclusive_scan_by_offsets(InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            T init,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_exclusive_scan_by_offsets(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        template<typename InputIterator, typename OffsetIterator, typename OutputIterator, typename T,
+                 typename BinaryFunction>
+        OutputIterator segmented_exclusive_scan_by_offsets(InputIterator first,
+            InputIterator last,
+            OffsetIterator offsets_first,
+            OffsetIterator offsets_last,
+            OutputIterator result,
+            T init,
+            BinaryFunction binary_op,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/segmented_scan.inl>
+
+#endif
@@ -0,0 +1,194 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Segmented scans over head flags.  The segments are already marked, so unlike scan_by_key no pair of adjacent keys
+//  is read and compared for every element.
+
+// #pragma OPENCL EXTENSION cl_amd_printf : enable
+
+//  Marks the first element of every segment given by its offset; offsets past the end of the input are ignored
+template< typename sType, typename sIterType >
+kernel void segmentedScanHeadsFromOffsetsTemplate(
+    global sType* offsets_ptr,
+    sIterType offsets_iter,
+    const uint numOffsets,
+    const uint vecSize,
+    global uint* flags )
+{
+    offsets_iter.init( offsets_ptr );
+
+    for( uint i = get_global_id( 0 ); i < numOffsets; i += get_global_size( 0 ) )
+    {
+        // a negative offset turns into a large uint and is skipped as well
+        uint offset = ( uint )offsets_iter[ i ];
+        if( offset < vecSize )
+            flags[ offset ] = 1;
+    }
+}
+
+/******************************************************************************
+ *  Single-pass segmented scan with decoupled look-back
+ *****************************************************************************/
+//  The look-back helpers come from lookback_kernels.cl, which the host prepends to this source.
+
+//  The same tiling as singlePassScanByKey, with the heads read from the flags instead of comparing adjacent keys.
+//  A tile is SCAN_ITEMS_PER_WORKITEM elements per work-item.  The tile moves between global and local memory in
+//  coalesced strides, and every work-item runs a segmented scan of SCAN_ITEMS_PER_WORKITEM consecutive elements in
+//  registers, so only one (head, value) pair per work-item goes through the local memory scan.
+template<
+    typename fType,
+    typename fIterType,
+    typename vType,
+    typename iIterType,
+    typename oType,
+    typename oIterType,
+    typename initType,
+    typename BinaryFunction >
+kernel void singlePassSegmentedScanTemplate(
+    global fType *flags,
+    fIterType    flags_iter,
+    global vType *vals,
+    iIterType     vals_iter,
+    global oType *output,
+    oIterType     output_iter,
+    initType init,
+    const uint vecSize,
+    local uint   *ldsHeads,
+    local oType  *ldsVals,
+    global BinaryFunction *binaryFunct,
+    global uint *tileStatus,
+    global uint *tileValues,
+    int exclusive )
+{
+    local uint tileIndex;
+    size_t locId = get_local_id( 0 );
+    size_t wgSize = get_local_size( 0 );
+    output_iter.init( output );
+    vals_iter.init( vals );
+    flags_iter.init( flags );
+
+    if( locId == 0 )
+        tileIndex = atomic_inc( tileStatus );
+    barrier( CLK_LOCAL_MEM_FENCE );
+    uint tile = tileIndex;
+    uint tileSize = ( uint )wgSize * SCAN_ITEMS_PER_WORKITEM;
+    uint tileStart = tile * tileSize;
+    uint tileCount = min( tileSize, vecSize - tileStart );
+
+    // the head flags are read as they are; the first element always starts a segment
+    for( uint i = locId; i < tileCount; i += wgSize )
+    {
+        uint index = tileStart + i;
+        uint head = ( index == 0 || flags_iter[ index ] != 0 ) ? 1 : 0;
+        ldsHeads[ i ] = head;
+        // if exclusive, every segment starts with init and its values are shifted right by one
+        if( exclusive && head )
+            ldsVals[ i ] = init;
+        else
+            ldsVals[ i ] = vals_iter[ exclusive ? index - 1 : index ];
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    // Serial segmented scan of the elements of the work-item; itemHeads[ k ] tells whether a head lies between the
+    // first element of the work-item and element k, in which case element k needs no carry from before
+    oType items[ SCAN_ITEMS_PER_WORKITEM ];
+    uint itemHeads[ SCAN_ITEMS_PER_WORKITEM ];
+    uint first = locId * SCAN_ITEMS_PER_WORKITEM;
+    uint count = ( first < tileCount ) ? min( ( uint )SCAN_ITEMS_PER_WORKITEM, tileCount - first ) : 0;
+    for( uint k = 0; k < count; ++k )
+    {
+        uint head = ldsHeads[ first + k ];
+        oType y = ldsVals[ first + k ];
+        if( k == 0 || head )
+            items[ k ] = y;
+        else
+            items[ k ] = (*binaryFunct)( items[ k - 1 ], y );
+        itemHeads[ k ] = ( k == 0 ) ? head : ( itemHeads[ k - 1 ] | head );
+    }
+    uint segmentHead = itemHeads[ count ? count - 1 : 0 ];
+    oType sum = items[ count ? count - 1 : 0 ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    // Computes a segmented scan of the work-item totals within the tile
+    ldsHeads[ locId ] = segmentHead;
+    ldsVals[ locId ] = sum;
+    for( size_t offset = 1; offset < wgSize; offset *= 2 )
+    {
+        barrier( CLK_LOCAL_MEM_FENCE );
+        if( locId >= offset && count > 0 )
+        {
+            uint prevHead = ldsHeads[ locId - offset ];
+            oType y = ldsVals[ locId - offset ];
+            if( !segmentHead )
+                sum = (*binaryFunct)( y, sum );
+            segmentHead |= prevHead;
+        }
+        barrier( CLK_LOCAL_MEM_FENCE );
+        ldsHeads[ locId ] = segmentHead;
+        ldsVals[ locId ] = sum;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    uint threadPrefixHead = 1;
+    oType threadPrefix;
+    if( locId > 0 )
+    {
+        threadPrefixHead = ldsHeads[ locId - 1 ];
+        threadPrefix = ldsVals[ locId - 1 ];
+    }
+    uint closed = ldsHeads[ ( tileCount - 1 ) / SCAN_ITEMS_PER_WORKITEM ];
+    oType aggregate = ldsVals[ ( tileCount - 1 ) / SCAN_ITEMS_PER_WORKITEM ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  One work-item chains the tile to its predecessors and hands the exclusive prefix to the others through lds;
+    //  the prefix is only needed when the tile does not start a segment.  A tile that contains the start of a segment
+    //  publishes its inclusive prefix right away, so the look-back never crosses a segment.
+    if( locId == 0 )
+    {
+        if( tile == 0 || closed )
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, aggregate );
+        else
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_AGGREGATE, aggregate );
+
+        if( tile > 0 && !itemHeads[ 0 ] )
+        {
+            oType prefix = lookBackPrefix< oType >( tileStatus, tileValues, tile, binaryFunct );
+            if( !closed )
+                lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX,
+                    (*binaryFunct)( prefix, aggregate ) );
+            ldsVals[ 0 ] = prefix;
+        }
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    // The carry of a work-item is the scan of everything before it in its segment
+    uint hasCarry = ( locId > 0 ) || ( tile > 0 );
+    oType carry = threadPrefix;
+    if( tile > 0 && ( locId == 0 || !threadPrefixHead ) )
+    {
+        oType tilePrefix = ldsVals[ 0 ];
+        carry = ( locId > 0 ) ? (*binaryFunct)( tilePrefix, threadPrefix ) : tilePrefix;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint k = 0; k < count; ++k )
+        ldsVals[ first + k ] = ( hasCarry && !itemHeads[ k ] ) ? (*binaryFunct)( carry, items[ k ] ) : items[ k ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint i = locId; i < tileCount; i += wgSize )
+        output_iter[ tileStart + i ] = ldsVals[ i ];
+}
@@ -0,0 +1,112 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SORT_BY_EXTRACTED_KEY_H )
+#define BOLT_CL_SORT_BY_EXTRACTED_KEY_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+
+#include <string>
+
+/*! \file bolt/cl/sort_by_extracted_key.h
+    \brief Sorts records by a numeric key that a functor extracts from each record.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup sorting
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-sort_by_extracted_key
+        *   \ingroup sorting
+        *   \{
+        *   \details Sorting records with a comparator has to go through a comparison sort, because the comparator is
+        *   opaque to Bolt.  When the order of a record is given by a single int, unsigned int or float member, a key
+        *   functor exposes that key instead, and the OpenCL path radix sorts it: the keys are extracted once, the
+        *   (key, index) pairs go through one pass per 4-bit digit, and each record is moved exactly once at the end.
+        *   The CPU paths run a stable sort that compares the extracted keys.
+        */
+
+        /*! \brief \p sort_by_extracted_key sorts the records in [first, last) in ascending order of the key that
+        * \p key_functor returns for each of them.  The sort is stable: records with equal keys keep their relative
+        * order.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The first position in the sequence to be sorted.
+        * \param last  The last position in the sequence to be sorted.
+        * \param key_functor A function object that maps a record onto an int, unsigned int or float key.  It must be
+        * registered with BOLT_FUNCTOR so that it can be called on the device.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam RandomAccessIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, and is
+        * mutable.
+        * \tparam KeyFunctor Is a unary function object taking the value type of \p RandomAccessIterator.
+        *
+        * \details The following code example sorts particles by their depth.
+        * \code
+        * #include <bolt/cl/sort_by_extracted_key.h>
+        *
+        * BOLT_FUNCTOR( Particle,
+        * struct Particle
+        * {
+        *     float x, y, z;
+        *     int id;
+        * };
+        * );
+        *
+        * BOLT_FUNCTOR( ParticleDepth,
+        * struct ParticleDepth
+        * {
+        *     float operator( )( const Particle& p ) const { return p.z; }
+        * };
+        * );
+        *
+        * std::vector< Particle > particles( 1024 );
+        * ...
+        * bolt::cl::sort_by_extracted_key( particles.begin( ), particles.end( ), ParticleDepth( ) );
+        * // particles are ordered by ascending z
+        *  \endcode
+        * \sa http://www.sgi.com/tech/stl/stable_sort.html
+        */
+        template<typename RandomAccessIterator, typename KeyFunctor>
+        void sort_by_extracted_key(control &ctl,
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            KeyFunctor key_functor,
+            const std::string& cl_code="");
+
+        template<typename RandomAccessIterator, typename KeyFunctor>
+        void sort_by_extracted_key(RandomAccessIterator first,
+            RandomAccessIterator last,
+            KeyFunctor key_functor,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+#include <bolt/cl/detail/sort_by_extracted_key.inl>
+
+#endif
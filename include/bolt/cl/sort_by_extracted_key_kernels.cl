@@ -0,0 +1,135 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Radix sort of records on an extracted key: the keys are pulled out of the records once and turned into ordered
+//  uints, then (key, index) pairs go through the usual LSD passes, and the records are moved a single time at the end.
+
+// #pragma OPENCL EXTENSION cl_amd_printf : enable
+
+//  Map a key onto an unsigned integer whose natural ordering matches the ordering of the key
+inline uint extractedKeyOrderedBits( uint value )
+{
+    return value;
+}
+
+inline uint extractedKeyOrderedBits( int value )
+{
+    return as_uint( value ) ^ 0x80000000;
+}
+
+inline uint extractedKeyOrderedBits( float value )
+{
+    uint bits = as_uint( value );
+    return ( bits & 0x80000000 ) ? ~bits : ( bits | 0x80000000 );
+}
+
+//  Writes the ordered key and the original position of every record.  The slots past the end of the input get the
+//  largest key, so the stable passes keep them behind every real record.
+template< typename iType, typename iIterType, typename keyFunctor >
+kernel void extractKeyTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const uint length,
+    const uint paddedLength,
+    global keyFunctor* userFunctor,
+    global uint* keys,
+    global uint* indices )
+{
+    input_iter.init( input_ptr );
+
+    for( uint index = get_global_id( 0 ); index < paddedLength; index += get_global_size( 0 ) )
+    {
+        uint key = 0xFFFFFFFF;
+        if( index < length )
+        {
+            iType record = input_iter[ index ];
+            key = extractedKeyOrderedBits( ( *userFunctor )( record ) );
+        }
+        keys[ index ] = key;
+        indices[ index ] = index;
+    }
+}
+
+//  Each work-item counts the digits of 2^N consecutive keys.  The counts are stored digit-major, so an exclusive
+//  scan of the buckets gives every work-item the first output slot of each digit.
+template< int N >
+kernel void extractedKeyHistogramTemplate(
+    global uint* keys,
+    global uint* buckets,
+    uint shiftCount )
+{
+    const int RADICES_T = ( 1 << N );
+    const uint MASK_T = ( 1 << N ) - 1;
+    uint localBuckets[ 16 ] = { 0, 0, 0, 0, 0, 0, 0, 0,
+                                0, 0, 0, 0, 0, 0, 0, 0 };
+    size_t globalId = get_global_id( 0 );
+    size_t globalSize = get_global_size( 0 );
+
+    for( int i = 0; i < RADICES_T; ++i )
+    {
+        uint digit = ( keys[ globalId * RADICES_T + i ] >> shiftCount ) & MASK_T;
+        localBuckets[ digit ]++;
+    }
+
+    for( int i = 0; i < RADICES_T; ++i )
+        buckets[ i * globalSize + globalId ] = localBuckets[ i ];
+}
+
+//  Scatters the keys of a work-item, and the record indices along with them, in their original order; this keeps
+//  every pass stable.
+template< int N >
+kernel void extractedKeyPermuteTemplate(
+    global uint* keys,
+    global uint* indices,
+    global uint* scannedBuckets,
+    uint shiftCount,
+    global uint* sortedKeys,
+    global uint* sortedIndices )
+{
+    const int RADICES_T = ( 1 << N );
+    const uint MASK_T = ( 1 << N ) - 1;
+    uint localIndex[ 16 ];
+    size_t globalId = get_global_id( 0 );
+    size_t globalSize = get_global_size( 0 );
+
+    for( int i = 0; i < RADICES_T; ++i )
+        localIndex[ i ] = scannedBuckets[ i * globalSize + globalId ];
+
+    for( int i = 0; i < RADICES_T; ++i )
+    {
+        uint key = keys[ globalId * RADICES_T + i ];
+        uint digit = ( key >> shiftCount ) & MASK_T;
+        uint destination = localIndex[ digit ]++;
+        sortedKeys[ destination ] = key;
+        sortedIndices[ destination ] = indices[ globalId * RADICES_T + i ];
+    }
+}
+
+//  Moves every record to its sorted position in a single pass
+template< typename iType, typename iIterType >
+kernel void extractedKeyGatherTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const uint length,
+    global uint* indices,
+    global iType* output )
+{
+    input_iter.init( input_ptr );
+
+    for( uint index = get_global_id( 0 ); index < length; index += get_global_size( 0 ) )
+        output[ index ] = input_iter[ indices[ index ] ];
+}
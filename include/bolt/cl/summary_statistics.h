@@ -0,0 +1,182 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_SUMMARY_STATISTICS_H )
+#define BOLT_CL_SUMMARY_STATISTICS_H
+#pragma once
+
+#include "bolt/cl/bolt.h"
+#include "bolt/cl/functional.h"
+#include "bolt/cl/device_vector.h"
+#include "bolt/cl/device_scalar.h"
+#include "bolt/cl/transform_reduce.h"
+
+#include <string>
+
+/*! \file bolt/cl/summary_statistics.h
+    \brief Computes the count, sum, sum of squares, minimum and maximum of a range in a single pass.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-summary_statistics
+        *   \ingroup reductions
+        *   \{
+        *   \details Computing several statistics of the same range with separate calls to \p reduce and
+        *   \p transform_reduce reads the range once per statistic.  \p reduce_statistics carries all of them in one
+        *   accumulator instead, so the range is read once.  The accumulator and its operators are ordinary Bolt
+        *   functors; other combinations of statistics can be fused the same way by passing a struct valued
+        *   accumulator, registered with BOLT_FUNCTOR, to \p transform_reduce.
+        */
+
+static const std::string summaryStatisticsCode = BOLT_HOST_DEVICE_DEFINITION(
+template< typename T >
+struct summary_statistics
+{
+    int count;
+    T sum;
+    T sum_of_squares;
+    T minimum;
+    T maximum;
+};
+
+template< typename T >
+struct summary_statistics_unary_op
+{
+    summary_statistics< T > operator( )( const T& x ) const
+    {
+        summary_statistics< T > result;
+        result.count = 1;
+        result.sum = x;
+        result.sum_of_squares = x * x;
+        result.minimum = x;
+        result.maximum = x;
+        return result;
+    }
+};
+
+template< typename T >
+struct summary_statistics_binary_op
+{
+    summary_statistics< T > operator( )( const summary_statistics< T >& lhs,
+                                         const summary_statistics< T >& rhs ) const
+    {
+        if( lhs.count == 0 )
+            return rhs;
+        if( rhs.count == 0 )
+            return lhs;
+
+        summary_statistics< T > result;
+        result.count = lhs.count + rhs.count;
+        result.sum = lhs.sum + rhs.sum;
+        result.sum_of_squares = lhs.sum_of_squares + rhs.sum_of_squares;
+        result.minimum = ( rhs.minimum < lhs.minimum ) ? rhs.minimum : lhs.minimum;
+        result.maximum = ( lhs.maximum < rhs.maximum ) ? rhs.maximum : lhs.maximum;
+        return result;
+    }
+};
+);
+
+        /*! \brief \p reduce_statistics returns the number of elements in [first, last), their sum, the sum of their
+        * squares, and the smallest and the largest of them, reading the range once.
+        *
+        * \details The fields of the returned summary_statistics are \p count, \p sum, \p sum_of_squares, \p minimum
+        * and \p maximum.  For an empty range \p count and the sums are 0, and \p minimum and \p maximum are T( ).
+        * Like \p reduce, the order in which the elements are combined is not deterministic, which can affect the
+        * rounding of the floating point sums.
+        *
+        * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc. See bolt::cl::control.
+        * \param first The first position in the sequence.
+        * \param last  The last position in the sequence.
+        * \param cl_code Optional OpenCL(TM) code to be passed to the OpenCL compiler.
+        * \tparam InputIterator Is a model of http://www.sgi.com/tech/stl/RandomAccessIterator.html, whose value type
+        * is int, unsigned int, float or double.
+        * \return The statistics of the range.
+        *
+        * \details The following code example computes the mean and the variance of a device_vector.
+        * \code
+        * #include <bolt/cl/summary_statistics.h>
+        *
+        * bolt::cl::device_vector< float > input( 1024 );
+        * ...
+        * bolt::cl::summary_statistics< float > s = bolt::cl::reduce_statistics( input.begin( ), input.end( ) );
+        * float mean = s.sum / s.count;
+        * float variance = s.sum_of_squares / s.count - mean * mean;
+        *  \endcode
+        */
+        template<typename InputIterator>
+        summary_statistics< typename std::iterator_traits< InputIterator >::value_type >
+            reduce_statistics(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            const std::string& cl_code="");
+
+        template<typename InputIterator>
+        summary_statistics< typename std::iterator_traits< InputIterator >::value_type >
+            reduce_statistics(InputIterator first,
+            InputIterator last,
+            const std::string& cl_code="");
+
+        /*! \brief This version of \p reduce_statistics writes the statistics to a bolt::cl::device_scalar, and on
+        * the OpenCL path returns without waiting for them.
+        */
+        template<typename InputIterator>
+        void reduce_statistics(control &ctl,
+            InputIterator first,
+            InputIterator last,
+            device_scalar< summary_statistics< typename std::iterator_traits< InputIterator >::value_type > >& result,
+            const std::string& cl_code="");
+
+        template<typename InputIterator>
+        void reduce_statistics(InputIterator first,
+            InputIterator last,
+            device_scalar< summary_statistics< typename std::iterator_traits< InputIterator >::value_type > >& result,
+            const std::string& cl_code="");
+
+        /*!   \}  */
+
+    }// end of bolt::cl namespace
+}// end of bolt namespace
+
+BOLT_CREATE_TYPENAME( bolt::cl::summary_statistics< cl_int > );
+BOLT_CREATE_CLCODE( bolt::cl::summary_statistics< cl_int >, bolt::cl::summaryStatisticsCode );
+BOLT_CREATE_TYPENAME( bolt::cl::summary_statistics_unary_op< cl_int > );
+BOLT_CREATE_CLCODE( bolt::cl::summary_statistics_unary_op< cl_int >, bolt::cl::summaryStatisticsCode );
+BOLT_CREATE_TYPENAME( bolt::cl::summary_statistics_binary_op< cl_int > );
+BOLT_CREATE_CLCODE( bolt::cl::summary_statistics_binary_op< cl_int >, bolt::cl::summaryStatisticsCode );
+
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::summary_statistics, cl_int, cl_uint );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::summary_statistics, cl_int, cl_float );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::summary_statistics, cl_int, cl_double );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::summary_statistics_unary_op, cl_int, cl_uint );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::summary_statistics_unary_op, cl_int, cl_float );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::summary_statistics_unary_op, cl_int, cl_double );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::summary_statistics_binary_op, cl_int, cl_uint );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::summary_statistics_binary_op, cl_int, cl_float );
+BOLT_TEMPLATE_REGISTER_NEW_TYPE( bolt::cl::summary_statistics_binary_op, cl_int, cl_double );
+
+#include <bolt/cl/detail/summary_statistics.inl>
+
+#endif
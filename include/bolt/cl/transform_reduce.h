@@ -21,6 +21,7 @@
 
 #include <bolt/cl/bolt.h>
 #include <bolt/cl/device_vector.h>
+#include <bolt/cl/device_scalar.h>
 
 #include <string>
 #include <iostream>
@@ -107,6 +108,43 @@ namespace bolt {
             BinaryFunction reduce_op,
             const std::string& user_code="" );
 
+        /*! \brief This version of \p transform_reduce writes the result to a bolt::cl::device_scalar instead of
+         *  returning it.  On the OpenCL path the last step of the reduction also runs on the device, and the call
+         *  returns as soon as the kernels are enqueued.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first The beginning of the input sequence.
+         * \param last The end of the input sequence.
+         * \param transform_op A unary tranformation operation.
+         * \param init  The initial value for the accumulator.
+         * \param reduce_op  The binary operation used to combine two values.
+         * \param result The scalar that receives the result.  It must have been created on the command queue of
+         *  \p ctl.
+         * \param user_code Optional OpenCL&tm; code to be passed to the OpenCL compiler.
+         *
+         *  \sa bolt::cl::device_scalar
+         */
+        template<typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction>
+        void transform_reduce(
+            control& ctl,
+            InputIterator first,
+            InputIterator last,
+            UnaryFunction transform_op,
+            T init,
+            BinaryFunction reduce_op,
+            device_scalar< T >& result,
+            const std::string& user_code="" );
+
+        template<typename InputIterator, typename UnaryFunction, typename T, typename BinaryFunction>
+        void transform_reduce(
+            InputIterator first,
+            InputIterator last,
+            UnaryFunction transform_op,
+            T init,
+            BinaryFunction reduce_op,
+            device_scalar< T >& result,
+            const std::string& user_code="" );
+
 
         /*!   \}  */
 
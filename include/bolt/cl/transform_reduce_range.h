@@ -0,0 +1,161 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#if !defined( BOLT_CL_TRANSFORM_REDUCE_RANGE_H )
+#define BOLT_CL_TRANSFORM_REDUCE_RANGE_H
+#pragma once
+
+#include <bolt/cl/bolt.h>
+#include <bolt/cl/device_vector.h>
+
+#include <string>
+
+/*! \file bolt/cl/transform_reduce_range.h
+    \brief  Fuses transform and reduce operations over a 2D or 3D window of a strided array.
+*/
+
+namespace bolt {
+    namespace cl {
+
+        /*! \addtogroup algorithms
+         */
+
+        /*! \addtogroup reductions
+        *   \ingroup algorithms
+        */
+
+        /*! \addtogroup CL-transform_reduce_range
+        *   \ingroup reductions
+        *   \{
+        *   \details Images, matrices and volumes are usually stored as a flat array with a pitch between rows and
+        *   slices, and a reduction often only covers part of them.  Flattening such a window with transform_reduce
+        *   forces every functor to recover its coordinates from a linear index.  transform_reduce_range instead
+        *   takes the window as an origin, an extent and a stride per dimension, and the OpenCL path tiles it with
+        *   16 x 4 work-groups, so the functors only ever see the elements of the window.
+        */
+
+        /*! \brief An array_region describes a window of a strided array.  Dimension 0 varies slowest.  The element
+         *  at the point ( i0, i1, ... ) of the window is at the offset
+         *  sum( ( origin[ d ] + i[ d ] ) * stride[ d ] ) from the beginning of the array.  Strides must not be
+         *  negative.
+         *
+         *  \tparam Rank The number of dimensions, 2 or 3.
+         */
+        template< int Rank >
+        struct array_region
+        {
+            int origin[ Rank ];
+            int extent[ Rank ];
+            int stride[ Rank ];
+        };
+
+        /*! \brief Creates the region of a height x width window of a row-major 2D array.
+         *
+         * \param originY The first row of the window.
+         * \param originX The first column of the window.
+         * \param height The number of rows of the window.
+         * \param width The number of columns of the window.
+         * \param rowPitch The number of elements between the starts of two consecutive rows of the array.
+         */
+        inline array_region< 2 > make_region( int originY, int originX, int height, int width, int rowPitch )
+        {
+            array_region< 2 > region = { { originY, originX }, { height, width }, { rowPitch, 1 } };
+            return region;
+        }
+
+        /*! \brief Creates the region of a depth x height x width window of a 3D array stored slice by slice.
+         *
+         * \param originZ The first slice of the window.
+         * \param originY The first row of the window.
+         * \param originX The first column of the window.
+         * \param depth The number of slices of the window.
+         * \param height The number of rows of the window.
+         * \param width The number of columns of the window.
+         * \param slicePitch The number of elements between the starts of two consecutive slices of the array.
+         * \param rowPitch The number of elements between the starts of two consecutive rows of the array.
+         */
+        inline array_region< 3 > make_region( int originZ, int originY, int originX, int depth, int height,
+            int width, int slicePitch, int rowPitch )
+        {
+            array_region< 3 > region = { { originZ, originY, originX }, { depth, height, width },
+                { slicePitch, rowPitch, 1 } };
+            return region;
+        }
+
+        /*! \brief \p transform_reduce_range applies \p transform_op to every element of a window of a strided array
+         *  and combines the results with \p reduce_op, in one pass over the window.
+         *  \details The elements outside of the window are never read.  The order in which the transformed elements
+         *  are combined is not specified, so \p reduce_op must be associative and commutative.
+         *
+         * \param ctl \b Optional Control structure to control command-queue, debug, tuning, etc.See bolt::cl::control.
+         * \param first The beginning of the strided array; offsets of the region are relative to it.
+         * \param region The window to reduce.  See bolt::cl::array_region.
+         * \param transform_op A unary tranformation operation.
+         * \param init  The initial value for the accumulator.
+         * \param reduce_op  The binary operation used to combine two transformed values.
+         * \param user_code Optional OpenCL&tm; code to be passed to the OpenCL compiler. The cl_code is inserted
+         *   first in the generated code, before the cl_code trait.
+         * \return The result of the combined transform and reduction, or \p init if the window is empty.
+         *
+         *  \tparam InputIterator is a model of a random access iterator.
+         *  \tparam Rank The number of dimensions of the region, 2 or 3.
+         *  \tparam UnaryFunction is a model of Unary Function, and its \c result_type is convertible to \c T.
+         *  \tparam T The type of the result.
+         *  \tparam BinaryFunction is a model of Binary Function on \c T.
+         *
+         *  \code
+         *  #include <bolt/cl/transform_reduce_range.h>
+         *  #include <bolt/cl/functional.h>
+         *
+         *  //  A 640 x 480 image stored with a pitch of 1024 pixels
+         *  std::vector< float > image( 1024 * 480 );
+         *  ...
+         *  //  Sum of squares of the 64 x 64 tile whose top left corner is at row 100, column 200
+         *  float energy = bolt::cl::transform_reduce_range( image.begin( ),
+         *      bolt::cl::make_region( 100, 200, 64, 64, 1024 ),
+         *      bolt::cl::square< float >( ), 0.0f, bolt::cl::plus< float >( ) );
+         *  \endcode
+         *
+         *  \sa bolt::cl::transform_reduce
+         */
+        template<typename InputIterator, int Rank, typename UnaryFunction, typename T, typename BinaryFunction>
+        T transform_reduce_range(
+            control& ctl,
+            InputIterator first,
+            const array_region< Rank >& region,
+            UnaryFunction transform_op,
+            T init,
+            BinaryFunction reduce_op,
+            const std::string& user_code="" );
+
+        template<typename InputIterator, int Rank, typename UnaryFunction, typename T, typename BinaryFunction>
+        T transform_reduce_range(
+            InputIterator first,
+            const array_region< Rank >& region,
+            UnaryFunction transform_op,
+            T init,
+            BinaryFunction reduce_op,
+            const std::string& user_code="" );
+
+        /*!   \}  */
+
+    };
+};
+
+#include <bolt/cl/detail/transform_reduce_range.inl>
+
+#endif
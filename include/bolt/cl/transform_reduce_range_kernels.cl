@@ -0,0 +1,90 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+//  Transform and reduction of a 2D or 3D window of a strided array.  The work-groups are 16 x 4 tiles of the window:
+//  dimension 0 of the NDRange walks the columns and dimension 1 the rows, and every work-item also loops over the
+//  slices, so a work-item reads along a row and computes no index arithmetic beyond the strides.
+
+//#pragma OPENCL EXTENSION cl_amd_printf : enable
+
+//  Work-items that saw no element of the window carry no value, so only valid partials are combined
+#define _REDUCE_RANGE_STEP(_IDX, _W) \
+    if( ( _IDX < _W ) && scratchValid[ _IDX + _W ] ) {\
+      oType other = scratch[ _IDX + _W ];\
+      scratch[ _IDX ] = scratchValid[ _IDX ] ? (*reduceFunctor)( scratch[ _IDX ], other ) : other;\
+      scratchValid[ _IDX ] = 1;\
+    }\
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+template< typename iType, typename iIterType, typename oType, typename unary_function, typename binary_function >
+kernel void transformReduceRangeTemplate(
+    global iType* input_ptr,
+    iIterType input_iter,
+    const int origin0,
+    const int origin1,
+    const int origin2,
+    const int extent0,
+    const int extent1,
+    const int extent2,
+    const int stride0,
+    const int stride1,
+    const int stride2,
+    global unary_function* transformFunctor,
+    global binary_function* reduceFunctor,
+    global oType* result,
+    local oType* scratch,
+    local int* scratchValid
+)
+{
+    input_iter.init( input_ptr );
+
+    oType accumulator;
+    int valid = 0;
+
+    for( int z = 0; z < extent0; ++z )
+    {
+        for( int y = get_global_id( 1 ); y < extent1; y += get_global_size( 1 ) )
+        {
+            int rowOffset = ( origin0 + z ) * stride0 + ( origin1 + y ) * stride1 + origin2 * stride2;
+            for( int x = get_global_id( 0 ); x < extent2; x += get_global_size( 0 ) )
+            {
+                iType element = input_iter[ rowOffset + x * stride2 ];
+                oType transformedElement = (*transformFunctor)( element );
+                accumulator = valid ? (*reduceFunctor)( accumulator, transformedElement ) : transformedElement;
+                valid = 1;
+            }
+        }
+    }
+
+    int local_index = get_local_id( 1 ) * get_local_size( 0 ) + get_local_id( 0 );
+    scratch[ local_index ] = accumulator;
+    scratchValid[ local_index ] = valid;
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    _REDUCE_RANGE_STEP( local_index, 32 );
+    _REDUCE_RANGE_STEP( local_index, 16 );
+    _REDUCE_RANGE_STEP( local_index,  8 );
+    _REDUCE_RANGE_STEP( local_index,  4 );
+    _REDUCE_RANGE_STEP( local_index,  2 );
+    _REDUCE_RANGE_STEP( local_index,  1 );
+
+    //  The host sizes the launch so that the first work-item of every work-group owns an element of the window
+    if( local_index == 0 )
+    {
+        result[ get_group_id( 1 ) * get_num_groups( 0 ) + get_group_id( 0 ) ] = scratch[ 0 ];
+    }
+};
@@ -14,17 +14,16 @@
 *   limitations under the License.                                                   
 ***************************************************************************/
 // #pragma OPENCL EXTENSION cl_amd_printf : enable
-
 /******************************************************************************
  *  Kernel 0
  *****************************************************************************/
+//  Reduce-then-scan: the first pass only reduces the transformed elements of every tile, so nothing but the tile sums
+//  is written back.  A tile is SCAN_ITEMS_PER_WORKITEM elements per work-item, as in the single-pass scan.
 
 //__attribute__((reqd_work_group_size(KERNEL0WORKGROUPSIZE,1,1)))
-template< typename iValueType, typename iIterType, typename oValueType, typename oIterType,  typename initType, 
+template< typename iValueType, typename iIterType, typename oValueType, typename initType,
         typename UnaryFunction, typename BinaryFunction >
-__kernel void perBlockTransformScan(
-                global oValueType* output_ptr,
-                oIterType output_iter,
+__kernel void perTileTransformReduce(
                 global iValueType* input_ptr,
                 iIterType input_iter,
                 initType identity,
@@ -32,69 +31,56 @@ __kernel void perBlockTransformScan(
                 local oValueType* lds,
                 global UnaryFunction* unaryOp,
                 global BinaryFunction* binaryOp,
-                global oValueType* scanBuffer,
+                global oValueType* tileSums,
                 int exclusive) // do exclusive scan ?
 {
-    size_t gloId = get_global_id( 0 );
-    size_t groId = get_group_id( 0 );
     size_t locId = get_local_id( 0 );
     size_t wgSize = get_local_size( 0 );
-    //printf("gid=%i, lTid=%i, gTid=%i\n", groId, locId, gloId);
-
-    output_iter.init( output_ptr );
     input_iter.init( input_ptr );
 
-    // if exclusive, load gloId=0 w/ identity, and all others shifted-1
-    oValueType val;
-    if (gloId < vecSize){
-       if (exclusive)
-       {
-          if (gloId > 0)
-          { // thread>0
-              iValueType inVal = input_iter[gloId-1];
-              val = (oValueType) (*unaryOp)(inVal);
-              lds[ locId ] = val;
-          }
-          else
-          { // thread=0
-              val = identity;
-              lds[ locId ] = val;
-          }
-       }
-       else
-       {
-          iValueType inVal = input_iter[gloId];
-          val = (oValueType) (*unaryOp)(inVal);
-          lds[ locId ] = val;
-       }
-    }
-    //  Computes a scan within a workgroup
-    oValueType sum = val;
-    for( size_t offset = 1; offset < wgSize; offset *= 2 )
+    uint tile = get_group_id( 0 );
+    uint tileSize = ( uint )wgSize * SCAN_ITEMS_PER_WORKITEM;
+    uint tileStart = tile * tileSize;
+    uint tileCount = min( tileSize, vecSize - tileStart );
+
+    // if exclusive, the scan runs over the transformed input shifted right by one, with identity in front
+    for( uint i = locId; i < tileCount; i += wgSize )
     {
-        barrier( CLK_LOCAL_MEM_FENCE );
-        if (locId >= offset && gloId < vecSize)
+        uint index = tileStart + i;
+        if( exclusive && index == 0 )
+            lds[ i ] = identity;
+        else
         {
-            oValueType y = lds[ locId - offset ];
-            sum = (*binaryOp)( sum, y );
+            iValueType inVal = input_iter[ exclusive ? index - 1 : index ];
+            lds[ i ] = (oValueType) (*unaryOp)( inVal );
         }
-        barrier( CLK_LOCAL_MEM_FENCE );
-        lds[ locId ] = sum;
     }
+    barrier( CLK_LOCAL_MEM_FENCE );
 
+    //  Serial reduction of the elements of the work-item
+    uint first = locId * SCAN_ITEMS_PER_WORKITEM;
+    uint count = ( first < tileCount ) ? min( ( uint )SCAN_ITEMS_PER_WORKITEM, tileCount - first ) : 0;
+    oValueType sum;
+    for( uint k = 0; k < count; ++k )
+    {
+        oValueType y = lds[ first + k ];
+        sum = ( k == 0 ) ? y : (*binaryOp)( sum, y );
+    }
     barrier( CLK_LOCAL_MEM_FENCE );
-  
-    //  Abort threads that are passed the end of the input vector
-    if (gloId >= vecSize) return; 
 
-    //  Each work item writes out its calculated scan result, relative to the beginning
-    //  of each work group
-    output_iter[ gloId ] = sum;
-    if (locId == 0)
+    //  Neighbours are combined pairwise, so the operands stay in order and binaryOp need not be commutative
+    uint active = ( tileCount + SCAN_ITEMS_PER_WORKITEM - 1 ) / SCAN_ITEMS_PER_WORKITEM;
+    if( count > 0 )
+        lds[ locId ] = sum;
+    for( uint stride = 1; stride < active; stride *= 2 )
     {
-        // last work-group can be wrong b/c ignored
-        scanBuffer[ groId ] = lds[ wgSize-1 ];
+        barrier( CLK_LOCAL_MEM_FENCE );
+        if( ( locId % ( 2 * stride ) ) == 0 && locId + stride < active )
+            lds[ locId ] = (*binaryOp)( lds[ locId ], lds[ locId + stride ] );
     }
+
+    if( locId == 0 )
+        tileSums[ tile ] = lds[ 0 ];
 }
 
 
@@ -180,33 +166,205 @@ __kernel void intraBlockInclusiveScan(
 /******************************************************************************
  *  Kernel 2
  *****************************************************************************/
+//  The second pass of reduce-then-scan reads and transforms the input again, scans the tile and seeds it with the
+//  scanned sum of the preceding tiles, so the output is written exactly once.
+
 //__attribute__((reqd_work_group_size(KERNEL2WORKGROUPSIZE,1,1)))
-template< typename oValueType, typename oIterType, typename BinaryFunction >
-__kernel void perBlockAddition( 
+template< typename iValueType, typename iIterType, typename oValueType, typename oIterType, typename initType,
+        typename UnaryFunction, typename BinaryFunction >
+__kernel void perTileTransformScan(
                 global oValueType* output_ptr,
                 oIterType output_iter,
-                global oValueType* postSumArray,
+                global iValueType* input_ptr,
+                iIterType input_iter,
+                initType identity,
                 const uint vecSize,
-                global BinaryFunction* binaryOp
-                )
+                local oValueType* lds,
+                global UnaryFunction* unaryOp,
+                global BinaryFunction* binaryOp,
+                global oValueType* postSumArray,
+                int exclusive) // do exclusive scan ?
 {
-    size_t gloId = get_global_id( 0 );
-    size_t groId = get_group_id( 0 );
     size_t locId = get_local_id( 0 );
+    size_t wgSize = get_local_size( 0 );
+    output_iter.init( output_ptr );
+    input_iter.init( input_ptr );
+
+    uint tile = get_group_id( 0 );
+    uint tileSize = ( uint )wgSize * SCAN_ITEMS_PER_WORKITEM;
+    uint tileStart = tile * tileSize;
+    uint tileCount = min( tileSize, vecSize - tileStart );
+
+    for( uint i = locId; i < tileCount; i += wgSize )
+    {
+        uint index = tileStart + i;
+        if( exclusive && index == 0 )
+            lds[ i ] = identity;
+        else
+        {
+            iValueType inVal = input_iter[ exclusive ? index - 1 : index ];
+            lds[ i ] = (oValueType) (*unaryOp)( inVal );
+        }
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Serial scan of the elements of the work-item
+    oValueType items[ SCAN_ITEMS_PER_WORKITEM ];
+    uint first = locId * SCAN_ITEMS_PER_WORKITEM;
+    uint count = ( first < tileCount ) ? min( ( uint )SCAN_ITEMS_PER_WORKITEM, tileCount - first ) : 0;
+    for( uint k = 0; k < count; ++k )
+    {
+        oValueType y = lds[ first + k ];
+        items[ k ] = ( k == 0 ) ? y : (*binaryOp)( items[ k - 1 ], y );
+    }
+    oValueType sum = items[ count ? count - 1 : 0 ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Computes a scan of the work-item totals within the tile
+    lds[ locId ] = sum;
+    for( size_t offset = 1; offset < wgSize; offset *= 2 )
+    {
+        barrier( CLK_LOCAL_MEM_FENCE );
+        if( locId >= offset && count > 0 )
+        {
+            oValueType y = lds[ locId - offset ];
+            sum = (*binaryOp)( y, sum );
+        }
+        barrier( CLK_LOCAL_MEM_FENCE );
+        lds[ locId ] = sum;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
 
-    //  Abort threads that are passed the end of the input_ptr vector
-    if( gloId >= vecSize )
-        return;
-        
+    oValueType threadPrefix;
+    if( locId > 0 )
+        threadPrefix = lds[ locId - 1 ];
+    if( tile > 0 )
+    {
+        oValueType tilePrefix = postSumArray[ tile - 1 ];
+        threadPrefix = ( locId > 0 ) ? (*binaryOp)( tilePrefix, threadPrefix ) : tilePrefix;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint k = 0; k < count; ++k )
+        lds[ first + k ] = ( tile > 0 || locId > 0 ) ? (*binaryOp)( threadPrefix, items[ k ] ) : items[ k ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint i = locId; i < tileCount; i += wgSize )
+        output_iter[ tileStart + i ] = lds[ i ];
+}
+
+
+/******************************************************************************
+ *  Single-pass transform scan with decoupled look-back
+ *****************************************************************************/
+//  The look-back helpers come from lookback_kernels.cl, which the host prepends to this source.
+
+//  A tile is SCAN_ITEMS_PER_WORKITEM elements per work-item.  The tile moves between global and local memory in
+//  coalesced strides, and every work-item scans SCAN_ITEMS_PER_WORKITEM consecutive elements in registers, so only one
+//  value per work-item goes through the local memory scan.
+template< typename iValueType, typename iIterType, typename oValueType, typename oIterType, typename initType,
+        typename UnaryFunction, typename BinaryFunction >
+__kernel void singlePassTransformScan(
+                global oValueType* output_ptr,
+                oIterType output_iter,
+                global iValueType* input_ptr,
+                iIterType input_iter,
+                initType identity,
+                const uint vecSize,
+                local oValueType* lds,
+                global UnaryFunction* unaryOp,
+                global BinaryFunction* binaryOp,
+                global uint* tileStatus,
+                global uint* tileValues,
+                int exclusive )
+{
+    local uint tileIndex;
+    size_t locId = get_local_id( 0 );
+    size_t wgSize = get_local_size( 0 );
     output_iter.init( output_ptr );
+    input_iter.init( input_ptr );
+
+    if( locId == 0 )
+        tileIndex = atomic_inc( tileStatus );
+    barrier( CLK_LOCAL_MEM_FENCE );
+    uint tile = tileIndex;
+    uint tileSize = ( uint )wgSize * SCAN_ITEMS_PER_WORKITEM;
+    uint tileStart = tile * tileSize;
+    uint tileCount = min( tileSize, vecSize - tileStart );
+
+    // if exclusive, the scan runs over the transformed input shifted right by one, with identity in front
+    for( uint i = locId; i < tileCount; i += wgSize )
+    {
+        uint index = tileStart + i;
+        if( exclusive && index == 0 )
+            lds[ i ] = identity;
+        else
+        {
+            iValueType inVal = input_iter[ exclusive ? index - 1 : index ];
+            lds[ i ] = (oValueType) (*unaryOp)( inVal );
+        }
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Serial scan of the elements of the work-item
+    oValueType items[ SCAN_ITEMS_PER_WORKITEM ];
+    uint first = locId * SCAN_ITEMS_PER_WORKITEM;
+    uint count = ( first < tileCount ) ? min( ( uint )SCAN_ITEMS_PER_WORKITEM, tileCount - first ) : 0;
+    for( uint k = 0; k < count; ++k )
+    {
+        oValueType y = lds[ first + k ];
+        items[ k ] = ( k == 0 ) ? y : (*binaryOp)( items[ k - 1 ], y );
+    }
+    oValueType sum = items[ count ? count - 1 : 0 ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    //  Computes a scan of the work-item totals within the tile
+    lds[ locId ] = sum;
+    for( size_t offset = 1; offset < wgSize; offset *= 2 )
+    {
+        barrier( CLK_LOCAL_MEM_FENCE );
+        if( locId >= offset && count > 0 )
+        {
+            oValueType y = lds[ locId - offset ];
+            sum = (*binaryOp)( y, sum );
+        }
+        barrier( CLK_LOCAL_MEM_FENCE );
+        lds[ locId ] = sum;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
 
-    oValueType scanResult = output_iter[ gloId ];
+    oValueType threadPrefix;
+    if( locId > 0 )
+        threadPrefix = lds[ locId - 1 ];
+    oValueType aggregate = lds[ ( tileCount - 1 ) / SCAN_ITEMS_PER_WORKITEM ];
+    barrier( CLK_LOCAL_MEM_FENCE );
 
-    // accumulate prefix
-    if (groId > 0)
+    //  One work-item chains the tile to its predecessors and hands the exclusive prefix to the others through lds
+    if( locId == 0 )
     {
-        oValueType postBlockSum = postSumArray[ groId-1 ];
-        oValueType newResult = (*binaryOp)( scanResult, postBlockSum );
-        output_iter[ gloId ] = newResult;
+        if( tile == 0 )
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, aggregate );
+        else
+        {
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_AGGREGATE, aggregate );
+            oValueType prefix = lookBackPrefix< oValueType >( tileStatus, tileValues, tile, binaryOp );
+            lookBackPublish( tileStatus, tileValues, tile, LOOKBACK_TILE_PREFIX, (*binaryOp)( prefix, aggregate ) );
+            lds[ 0 ] = prefix;
+        }
     }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    if( tile > 0 )
+    {
+        oValueType tilePrefix = lds[ 0 ];
+        threadPrefix = ( locId > 0 ) ? (*binaryOp)( tilePrefix, threadPrefix ) : tilePrefix;
+    }
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint k = 0; k < count; ++k )
+        lds[ first + k ] = ( tile > 0 || locId > 0 ) ? (*binaryOp)( threadPrefix, items[ k ] ) : items[ k ];
+    barrier( CLK_LOCAL_MEM_FENCE );
+
+    for( uint i = locId; i < tileCount; i += wgSize )
+        output_iter[ tileStart + i ] = lds[ i ];
 }
@@ -0,0 +1,284 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/binary_search.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+//  A sorted range with plenty of duplicates
+template< typename T >
+std::vector< T > makeSortedRange( size_t length )
+{
+    std::vector< T > range( length );
+    for( size_t i = 0; i < length; i++ )
+        range[ i ] = static_cast< T >( rand( ) % ( length / 2 + 1 ) );
+    std::sort( range.begin( ), range.end( ) );
+    return range;
+}
+
+//  Values below, inside and above the range
+template< typename T >
+std::vector< T > makeValues( size_t rangeLength, size_t numValues )
+{
+    std::vector< T > values( numValues );
+    for( size_t i = 0; i < numValues; i++ )
+        values[ i ] = static_cast< T >( static_cast< int >( rand( ) % ( rangeLength / 2 + 5 ) ) - 2 );
+    return values;
+}
+
+enum searchKind { lowerBound, upperBound, binarySearch };
+
+template< typename T, typename StrictWeakOrdering >
+std::vector< int > referenceSearch( const std::vector< T >& range, const std::vector< T >& values, searchKind kind,
+                                    StrictWeakOrdering comp )
+{
+    std::vector< int > result( values.size( ) );
+    for( size_t i = 0; i < values.size( ); i++ )
+    {
+        if( kind == lowerBound )
+            result[ i ] = static_cast< int >( std::lower_bound( range.begin( ), range.end( ), values[ i ], comp ) -
+                                              range.begin( ) );
+        else if( kind == upperBound )
+            result[ i ] = static_cast< int >( std::upper_bound( range.begin( ), range.end( ), values[ i ], comp ) -
+                                              range.begin( ) );
+        else
+            result[ i ] = std::binary_search( range.begin( ), range.end( ), values[ i ], comp ) ? 1 : 0;
+    }
+    return result;
+}
+
+//  The parameter is the length of the sorted range; there are always many more values than samples
+class SearchRangeLength: public ::testing::TestWithParam< int >
+{
+protected:
+    static const size_t numValues = ( 1 << 18 ) + 7;
+};
+
+TEST_P( SearchRangeLength, LowerBoundStdVector )
+{
+    std::vector< int > range = makeSortedRange< int >( GetParam( ) );
+    std::vector< int > values = makeValues< int >( GetParam( ), numValues );
+    std::vector< int > result( numValues );
+
+    std::vector< int >::iterator end = bolt::cl::lower_bound( range.begin( ), range.end( ), values.begin( ),
+                                                              values.end( ), result.begin( ) );
+    EXPECT_EQ( result.end( ), end );
+    cmpArrays( referenceSearch( range, values, lowerBound, std::less< int >( ) ), result );
+}
+
+TEST_P( SearchRangeLength, UpperBoundDeviceVector )
+{
+    std::vector< int > range = makeSortedRange< int >( GetParam( ) );
+    std::vector< int > values = makeValues< int >( GetParam( ), numValues );
+
+    bolt::cl::device_vector< int > dvRange( range.begin( ), range.end( ) );
+    bolt::cl::device_vector< int > dvValues( values.begin( ), values.end( ) );
+    bolt::cl::device_vector< int > dvResult( numValues );
+
+    bolt::cl::upper_bound( dvRange.begin( ), dvRange.end( ), dvValues.begin( ), dvValues.end( ), dvResult.begin( ) );
+    cmpArrays( referenceSearch( range, values, upperBound, std::less< int >( ) ), dvResult );
+}
+
+TEST_P( SearchRangeLength, BinarySearchStdVector )
+{
+    std::vector< int > range = makeSortedRange< int >( GetParam( ) );
+    std::vector< int > values = makeValues< int >( GetParam( ), numValues );
+    std::vector< int > result( numValues );
+
+    bolt::cl::binary_search( range.begin( ), range.end( ), values.begin( ), values.end( ), result.begin( ) );
+    cmpArrays( referenceSearch( range, values, binarySearch, std::less< int >( ) ), result );
+}
+
+TEST_P( SearchRangeLength, GreaterDeviceVector )
+{
+    std::vector< int > range = makeSortedRange< int >( GetParam( ) );
+    std::reverse( range.begin( ), range.end( ) );
+    std::vector< int > values = makeValues< int >( GetParam( ), numValues );
+
+    bolt::cl::device_vector< int > dvRange( range.begin( ), range.end( ) );
+    bolt::cl::device_vector< int > dvValues( values.begin( ), values.end( ) );
+    bolt::cl::device_vector< int > dvResult( numValues );
+
+    bolt::cl::lower_bound( dvRange.begin( ), dvRange.end( ), dvValues.begin( ), dvValues.end( ), dvResult.begin( ),
+                           bolt::cl::greater< int >( ) );
+    cmpArrays( referenceSearch( range, values, lowerBound, std::greater< int >( ) ), dvResult );
+}
+
+TEST_P( SearchRangeLength, SortedValues )
+{
+    std::vector< int > range = makeSortedRange< int >( GetParam( ) );
+    std::vector< int > values = makeValues< int >( GetParam( ), numValues );
+    std::sort( values.begin( ), values.end( ) );
+    std::vector< int > result( numValues );
+
+    bolt::cl::lower_bound_sorted( range.begin( ), range.end( ), values.begin( ), values.end( ), result.begin( ) );
+    cmpArrays( referenceSearch( range, values, lowerBound, std::less< int >( ) ), result );
+
+    bolt::cl::upper_bound_sorted( range.begin( ), range.end( ), values.begin( ), values.end( ), result.begin( ) );
+    cmpArrays( referenceSearch( range, values, upperBound, std::less< int >( ) ), result );
+
+    bolt::cl::binary_search_sorted( range.begin( ), range.end( ), values.begin( ), values.end( ), result.begin( ) );
+    cmpArrays( referenceSearch( range, values, binarySearch, std::less< int >( ) ), result );
+}
+
+TEST_P( SearchRangeLength, SortedValuesDeviceVector )
+{
+    std::vector< int > range = makeSortedRange< int >( GetParam( ) );
+    std::vector< int > values = makeValues< int >( GetParam( ), numValues );
+    std::sort( values.begin( ), values.end( ) );
+
+    bolt::cl::device_vector< int > dvRange( range.begin( ), range.end( ) );
+    bolt::cl::device_vector< int > dvValues( values.begin( ), values.end( ) );
+    bolt::cl::device_vector< int > dvResult( numValues );
+
+    bolt::cl::upper_bound_sorted( dvRange.begin( ), dvRange.end( ), dvValues.begin( ), dvValues.end( ),
+                                  dvResult.begin( ) );
+    cmpArrays( referenceSearch( range, values, upperBound, std::less< int >( ) ), dvResult );
+}
+
+TEST_P( SearchRangeLength, SerialCpu )
+{
+    std::vector< int > range = makeSortedRange< int >( GetParam( ) );
+    std::vector< int > values = makeValues< int >( GetParam( ), numValues );
+    std::vector< int > sortedValues( values );
+    std::sort( sortedValues.begin( ), sortedValues.end( ) );
+    std::vector< int > result( numValues );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    bolt::cl::upper_bound( ctl, range.begin( ), range.end( ), values.begin( ), values.end( ), result.begin( ) );
+    cmpArrays( referenceSearch( range, values, upperBound, std::less< int >( ) ), result );
+
+    bolt::cl::binary_search_sorted( ctl, range.begin( ), range.end( ), sortedValues.begin( ), sortedValues.end( ),
+                                    result.begin( ) );
+    cmpArrays( referenceSearch( range, sortedValues, binarySearch, std::less< int >( ) ), result );
+}
+
+TEST_P( SearchRangeLength, MultiCoreCpu )
+{
+    std::vector< int > range = makeSortedRange< int >( GetParam( ) );
+    std::vector< int > values = makeValues< int >( GetParam( ), numValues );
+    std::vector< int > sortedValues( values );
+    std::sort( sortedValues.begin( ), sortedValues.end( ) );
+
+    bolt::cl::device_vector< int > dvRange( range.begin( ), range.end( ) );
+    bolt::cl::device_vector< int > dvValues( values.begin( ), values.end( ) );
+    bolt::cl::device_vector< int > dvSortedValues( sortedValues.begin( ), sortedValues.end( ) );
+    bolt::cl::device_vector< int > dvResult( numValues );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    bolt::cl::binary_search( ctl, dvRange.begin( ), dvRange.end( ), dvValues.begin( ), dvValues.end( ),
+                             dvResult.begin( ) );
+    cmpArrays( referenceSearch( range, values, binarySearch, std::less< int >( ) ), dvResult );
+
+    bolt::cl::lower_bound_sorted( ctl, dvRange.begin( ), dvRange.end( ), dvSortedValues.begin( ),
+                                  dvSortedValues.end( ), dvResult.begin( ) );
+    cmpArrays( referenceSearch( range, sortedValues, lowerBound, std::less< int >( ) ), dvResult );
+}
+
+#if (TEST_DOUBLE == 1)
+TEST_P( SearchRangeLength, DoubleLowerBound )
+{
+    std::vector< double > range = makeSortedRange< double >( GetParam( ) );
+    std::vector< double > values = makeValues< double >( GetParam( ), numValues );
+    std::vector< int > result( numValues );
+
+    bolt::cl::lower_bound( range.begin( ), range.end( ), values.begin( ), values.end( ), result.begin( ) );
+    cmpArrays( referenceSearch( range, values, lowerBound, std::less< double >( ) ), result );
+
+    std::sort( values.begin( ), values.end( ) );
+    bolt::cl::lower_bound_sorted( range.begin( ), range.end( ), values.begin( ), values.end( ), result.begin( ) );
+    cmpArrays( referenceSearch( range, values, lowerBound, std::less< double >( ) ), result );
+}
+#endif
+
+INSTANTIATE_TEST_CASE_P( BinarySearch, SearchRangeLength, ::testing::Values( 1, 100, 257, 4096, 1 << 20 ) );
+
+TEST( BinarySearch, EmptyRange )
+{
+    std::vector< int > range;
+    std::vector< int > values( 64, 3 );
+    std::vector< int > result( 64, -1 );
+
+    bolt::cl::upper_bound( range.begin( ), range.end( ), values.begin( ), values.end( ), result.begin( ) );
+    cmpArrays( std::vector< int >( 64, 0 ), result );
+
+    bolt::cl::binary_search_sorted( range.begin( ), range.end( ), values.begin( ), values.end( ), result.begin( ) );
+    cmpArrays( std::vector< int >( 64, 0 ), result );
+}
+
+TEST( BinarySearch, NoValues )
+{
+    std::vector< int > range = makeSortedRange< int >( 100 );
+    std::vector< int > values( 1, 3 );
+    std::vector< int > result( 1, -1 );
+
+    std::vector< int >::iterator end = bolt::cl::lower_bound( range.begin( ), range.end( ), values.begin( ),
+                                                              values.begin( ), result.begin( ) );
+    EXPECT_EQ( result.begin( ), end );
+    EXPECT_EQ( -1, result[ 0 ] );
+}
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -0,0 +1,225 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/copy_if.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+BOLT_FUNCTOR( IsOdd,
+struct IsOdd
+{
+    bool operator( )( const int x ) const
+    {
+        return ( x & 1 ) != 0;
+    }
+};
+);
+
+BOLT_FUNCTOR( IsNegative,
+struct IsNegative
+{
+    bool operator( )( const float x ) const
+    {
+        return x < 0.0f;
+    }
+};
+);
+
+//  Sizes around the tile boundaries, plus one that spans many tiles
+class CopyIfTest : public ::testing::TestWithParam< int >
+{
+public:
+    CopyIfTest( ) : input( GetParam( ) )
+    {
+        for( size_t i = 0; i < input.size( ); i++ )
+            input[ i ] = rand( ) % 1000;
+    }
+
+protected:
+    std::vector< int > input;
+};
+
+TEST_P( CopyIfTest, CopyIf )
+{
+    std::vector< int > stdOutput( input.size( ) ), boltOutput( input.size( ) );
+    std::vector< int >::iterator stdEnd = std::copy_if( input.begin( ), input.end( ), stdOutput.begin( ), IsOdd( ) );
+    std::vector< int >::iterator boltEnd = bolt::cl::copy_if( input.begin( ), input.end( ), boltOutput.begin( ),
+                                                              IsOdd( ) );
+
+    EXPECT_EQ( stdEnd - stdOutput.begin( ), boltEnd - boltOutput.begin( ) );
+    cmpArrays( stdOutput, boltOutput );
+}
+
+TEST_P( CopyIfTest, RemoveCopyIfDeviceVector )
+{
+    std::vector< int > stdOutput( input.size( ) );
+    std::vector< int >::iterator stdEnd = std::remove_copy_if( input.begin( ), input.end( ), stdOutput.begin( ),
+                                                               IsOdd( ) );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int > dvOutput( input.size( ), 0 );
+    bolt::cl::device_vector< int >::iterator boltEnd = bolt::cl::remove_copy_if( dvInput.begin( ), dvInput.end( ),
+                                                                                 dvOutput.begin( ), IsOdd( ) );
+
+    EXPECT_EQ( stdEnd - stdOutput.begin( ), boltEnd - dvOutput.begin( ) );
+    cmpArrays( stdOutput, dvOutput );
+}
+
+TEST_P( CopyIfTest, RemoveIf )
+{
+    std::vector< int > stdInput( input );
+    std::vector< int >::iterator stdEnd = std::remove_if( stdInput.begin( ), stdInput.end( ), IsOdd( ) );
+    std::vector< int >::iterator boltEnd = bolt::cl::remove_if( input.begin( ), input.end( ), IsOdd( ) );
+
+    ASSERT_EQ( stdEnd - stdInput.begin( ), boltEnd - input.begin( ) );
+    for( size_t i = 0; i < static_cast< size_t >( stdEnd - stdInput.begin( ) ); i++ )
+        EXPECT_EQ( stdInput[ i ], input[ i ] );
+}
+
+TEST_P( CopyIfTest, RemoveIfDeviceVector )
+{
+    std::vector< int > stdInput( input );
+    std::vector< int >::iterator stdEnd = std::remove_if( stdInput.begin( ), stdInput.end( ), IsOdd( ) );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int >::iterator boltEnd = bolt::cl::remove_if( dvInput.begin( ), dvInput.end( ),
+                                                                            IsOdd( ) );
+
+    ASSERT_EQ( stdEnd - stdInput.begin( ), boltEnd - dvInput.begin( ) );
+    for( size_t i = 0; i < static_cast< size_t >( stdEnd - stdInput.begin( ) ); i++ )
+        EXPECT_EQ( stdInput[ i ], dvInput[ i ] );
+}
+
+TEST_P( CopyIfTest, SerialCopyIf )
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    std::vector< int > stdOutput( input.size( ) ), boltOutput( input.size( ) );
+    std::vector< int >::iterator stdEnd = std::copy_if( input.begin( ), input.end( ), stdOutput.begin( ), IsOdd( ) );
+    std::vector< int >::iterator boltEnd = bolt::cl::copy_if( ctl, input.begin( ), input.end( ), boltOutput.begin( ),
+                                                              IsOdd( ) );
+
+    EXPECT_EQ( stdEnd - stdOutput.begin( ), boltEnd - boltOutput.begin( ) );
+    cmpArrays( stdOutput, boltOutput );
+}
+
+TEST_P( CopyIfTest, MultiCoreCopyIf )
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::vector< int > stdOutput( input.size( ) ), boltOutput( input.size( ) );
+    std::vector< int >::iterator stdEnd = std::copy_if( input.begin( ), input.end( ), stdOutput.begin( ), IsOdd( ) );
+    std::vector< int >::iterator boltEnd = bolt::cl::copy_if( ctl, input.begin( ), input.end( ), boltOutput.begin( ),
+                                                              IsOdd( ) );
+
+    EXPECT_EQ( stdEnd - stdOutput.begin( ), boltEnd - boltOutput.begin( ) );
+    cmpArrays( stdOutput, boltOutput );
+}
+
+TEST_P( CopyIfTest, MultiCoreRemoveIfDeviceVector )
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::vector< int > stdInput( input );
+    std::vector< int >::iterator stdEnd = std::remove_if( stdInput.begin( ), stdInput.end( ), IsOdd( ) );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int >::iterator boltEnd = bolt::cl::remove_if( ctl, dvInput.begin( ), dvInput.end( ),
+                                                                            IsOdd( ) );
+
+    ASSERT_EQ( stdEnd - stdInput.begin( ), boltEnd - dvInput.begin( ) );
+    for( size_t i = 0; i < static_cast< size_t >( stdEnd - stdInput.begin( ) ); i++ )
+        EXPECT_EQ( stdInput[ i ], dvInput[ i ] );
+}
+
+INSTANTIATE_TEST_CASE_P( CopyIfSizes, CopyIfTest, ::testing::Values( 1, 31, 255, 256, 257, 1024, 2047, 2049,
+                                                                     65536, 1048579 ) );
+
+TEST( CopyIf, NothingSelected )
+{
+    std::vector< int > input( 4099, 2 );
+    std::vector< int > output( 1, -1 );
+    std::vector< int >::iterator boltEnd = bolt::cl::copy_if( input.begin( ), input.end( ), output.begin( ),
+                                                              IsOdd( ) );
+    EXPECT_EQ( output.begin( ), boltEnd );
+    EXPECT_EQ( -1, output[ 0 ] );
+}
+
+TEST( CopyIf, Float )
+{
+    std::vector< float > input( 100003 );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = static_cast< float >( rand( ) % 200 - 100 ) / 7.0f;
+
+    std::vector< float > stdOutput( input.size( ) ), boltOutput( input.size( ) );
+    std::vector< float >::iterator stdEnd = std::copy_if( input.begin( ), input.end( ), stdOutput.begin( ),
+                                                          IsNegative( ) );
+    std::vector< float >::iterator boltEnd = bolt::cl::copy_if( input.begin( ), input.end( ), boltOutput.begin( ),
+                                                                IsNegative( ) );
+
+    EXPECT_EQ( stdEnd - stdOutput.begin( ), boltEnd - boltOutput.begin( ) );
+    cmpArrays( stdOutput, boltOutput );
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -0,0 +1,287 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/find.h>
+#include <bolt/cl/logical.h>
+#include <bolt/cl/mismatch.h>
+#include <bolt/cl/equal.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+BOLT_FUNCTOR( IsNegative,
+struct IsNegative
+{
+    bool operator( )( const int x ) const
+    {
+        return x < 0;
+    }
+};
+);
+
+BOLT_FUNCTOR( IsNotNegative,
+struct IsNotNegative
+{
+    bool operator( )( const int x ) const
+    {
+        return x >= 0;
+    }
+};
+);
+
+BOLT_FUNCTOR( SameParity,
+struct SameParity
+{
+    bool operator( )( const int x, const int y ) const
+    {
+        return ( ( x ^ y ) & 1 ) == 0;
+    }
+};
+);
+
+//  Non negative values, with a single negative one planted at position hit; hit == length plants nothing
+std::vector< int > makeInput( size_t length, size_t hit )
+{
+    std::vector< int > input( length );
+    for( size_t i = 0; i < length; i++ )
+        input[ i ] = rand( ) % 100;
+    if( hit < length )
+        input[ hit ] = -1;
+    return input;
+}
+
+//  The parameter is the position of the match, as a fraction of the input length in percents; 100 means no match.
+//  Early matches let most work-groups skip their tiles, late matches run through almost all of them.
+class FindPosition: public ::testing::TestWithParam< int >
+{
+protected:
+    static const size_t length = ( 1 << 20 ) + 13;
+
+    size_t hit( ) const
+    {
+        return std::min( length, length / 100 * GetParam( ) + GetParam( ) );
+    }
+};
+
+TEST_P( FindPosition, FindIfStdVector )
+{
+    std::vector< int > input = makeInput( length, hit( ) );
+
+    std::vector< int >::iterator result = bolt::cl::find_if( input.begin( ), input.end( ), IsNegative( ) );
+    EXPECT_EQ( std::find_if( input.begin( ), input.end( ), IsNegative( ) ) - input.begin( ), result - input.begin( ) );
+}
+
+TEST_P( FindPosition, FindIfNotDeviceVector )
+{
+    std::vector< int > input = makeInput( length, hit( ) );
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+
+    bolt::cl::device_vector< int >::iterator result = bolt::cl::find_if_not( dvInput.begin( ), dvInput.end( ),
+                                                                             IsNotNegative( ) );
+    EXPECT_EQ( std::find_if( input.begin( ), input.end( ), IsNegative( ) ) - input.begin( ),
+               result - dvInput.begin( ) );
+}
+
+TEST_P( FindPosition, FindValueStdVector )
+{
+    std::vector< int > input = makeInput( length, hit( ) );
+
+    std::vector< int >::iterator result = bolt::cl::find( input.begin( ), input.end( ), -1 );
+    EXPECT_EQ( std::find( input.begin( ), input.end( ), -1 ) - input.begin( ), result - input.begin( ) );
+}
+
+TEST_P( FindPosition, FindIfSerialCpu )
+{
+    std::vector< int > input = makeInput( length, hit( ) );
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    bolt::cl::device_vector< int >::iterator result = bolt::cl::find_if( ctl, dvInput.begin( ), dvInput.end( ),
+                                                                         IsNegative( ) );
+    EXPECT_EQ( std::find_if( input.begin( ), input.end( ), IsNegative( ) ) - input.begin( ),
+               result - dvInput.begin( ) );
+}
+
+TEST_P( FindPosition, FindValueMultiCoreCpu )
+{
+    std::vector< int > input = makeInput( length, hit( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::vector< int >::iterator result = bolt::cl::find( ctl, input.begin( ), input.end( ), -1 );
+    EXPECT_EQ( std::find( input.begin( ), input.end( ), -1 ) - input.begin( ), result - input.begin( ) );
+}
+
+TEST_P( FindPosition, Logical )
+{
+    std::vector< int > input = makeInput( length, hit( ) );
+    bool expected = std::find_if( input.begin( ), input.end( ), IsNegative( ) ) != input.end( );
+
+    EXPECT_EQ( expected, bolt::cl::any_of( input.begin( ), input.end( ), IsNegative( ) ) );
+    EXPECT_EQ( !expected, bolt::cl::all_of( input.begin( ), input.end( ), IsNotNegative( ) ) );
+    EXPECT_EQ( !expected, bolt::cl::none_of( input.begin( ), input.end( ), IsNegative( ) ) );
+}
+
+TEST_P( FindPosition, LogicalMultiCoreCpu )
+{
+    std::vector< int > input = makeInput( length, hit( ) );
+    bool expected = std::find_if( input.begin( ), input.end( ), IsNegative( ) ) != input.end( );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    EXPECT_EQ( expected, bolt::cl::any_of( ctl, input.begin( ), input.end( ), IsNegative( ) ) );
+    EXPECT_EQ( !expected, bolt::cl::all_of( ctl, input.begin( ), input.end( ), IsNotNegative( ) ) );
+    EXPECT_EQ( !expected, bolt::cl::none_of( ctl, input.begin( ), input.end( ), IsNegative( ) ) );
+}
+
+TEST_P( FindPosition, MismatchStdVector )
+{
+    std::vector< int > input1 = makeInput( length, length );
+    std::vector< int > input2( input1 );
+    if( hit( ) < length )
+        input2[ hit( ) ] += 1;
+
+    std::pair< std::vector< int >::iterator, std::vector< int >::iterator > result =
+        bolt::cl::mismatch( input1.begin( ), input1.end( ), input2.begin( ) );
+    std::pair< std::vector< int >::iterator, std::vector< int >::iterator > reference =
+        std::mismatch( input1.begin( ), input1.end( ), input2.begin( ) );
+    EXPECT_EQ( reference.first - input1.begin( ), result.first - input1.begin( ) );
+    EXPECT_EQ( reference.second - input2.begin( ), result.second - input2.begin( ) );
+    EXPECT_EQ( hit( ) == length, bolt::cl::equal( input1.begin( ), input1.end( ), input2.begin( ) ) );
+}
+
+TEST_P( FindPosition, MismatchDeviceVectorPredicate )
+{
+    std::vector< int > input1 = makeInput( length, length );
+    std::vector< int > input2( input1 );
+    for( size_t i = 0; i < length; i++ )
+        input2[ i ] += 2;
+    if( hit( ) < length )
+        input2[ hit( ) ] += 1;
+    bolt::cl::device_vector< int > dvInput1( input1.begin( ), input1.end( ) );
+    bolt::cl::device_vector< int > dvInput2( input2.begin( ), input2.end( ) );
+
+    std::pair< bolt::cl::device_vector< int >::iterator, bolt::cl::device_vector< int >::iterator > result =
+        bolt::cl::mismatch( dvInput1.begin( ), dvInput1.end( ), dvInput2.begin( ), SameParity( ) );
+    EXPECT_EQ( hit( ), static_cast< size_t >( result.first - dvInput1.begin( ) ) );
+    EXPECT_EQ( hit( ), static_cast< size_t >( result.second - dvInput2.begin( ) ) );
+    EXPECT_EQ( hit( ) == length, bolt::cl::equal( dvInput1.begin( ), dvInput1.end( ), dvInput2.begin( ),
+                                                  SameParity( ) ) );
+}
+
+TEST_P( FindPosition, MismatchCpu )
+{
+    std::vector< int > input1 = makeInput( length, length );
+    std::vector< int > input2( input1 );
+    if( hit( ) < length )
+        input2[ hit( ) ] += 1;
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+    EXPECT_EQ( hit( ), static_cast< size_t >(
+        bolt::cl::mismatch( ctl, input1.begin( ), input1.end( ), input2.begin( ) ).first - input1.begin( ) ) );
+
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+    EXPECT_EQ( hit( ), static_cast< size_t >(
+        bolt::cl::mismatch( ctl, input1.begin( ), input1.end( ), input2.begin( ) ).first - input1.begin( ) ) );
+    EXPECT_EQ( hit( ) == length, bolt::cl::equal( ctl, input1.begin( ), input1.end( ), input2.begin( ) ) );
+}
+
+#if (TEST_DOUBLE == 1)
+TEST_P( FindPosition, FindValueDouble )
+{
+    std::vector< int > values = makeInput( length, hit( ) );
+    std::vector< double > input( values.begin( ), values.end( ) );
+
+    std::vector< double >::iterator result = bolt::cl::find( input.begin( ), input.end( ), -1.0 );
+    EXPECT_EQ( std::find( input.begin( ), input.end( ), -1.0 ) - input.begin( ), result - input.begin( ) );
+}
+#endif
+
+INSTANTIATE_TEST_CASE_P( Find, FindPosition, ::testing::Values( 0, 1, 37, 99, 100 ) );
+
+TEST( Find, SeveralMatchesReturnsFirst )
+{
+    std::vector< int > input = makeInput( 1 << 18, 1 << 18 );
+    for( size_t i = 5000; i < input.size( ); i += 777 )
+        input[ i ] = -1;
+
+    std::vector< int >::iterator result = bolt::cl::find_if( input.begin( ), input.end( ), IsNegative( ) );
+    EXPECT_EQ( 5000, result - input.begin( ) );
+}
+
+TEST( Find, EmptyRange )
+{
+    std::vector< int > input( 16, -1 );
+
+    EXPECT_EQ( input.begin( ), bolt::cl::find_if( input.begin( ), input.begin( ), IsNegative( ) ) );
+    EXPECT_EQ( input.begin( ), bolt::cl::find( input.begin( ), input.begin( ), -1 ) );
+    EXPECT_FALSE( bolt::cl::any_of( input.begin( ), input.begin( ), IsNegative( ) ) );
+    EXPECT_TRUE( bolt::cl::all_of( input.begin( ), input.begin( ), IsNotNegative( ) ) );
+    EXPECT_TRUE( bolt::cl::none_of( input.begin( ), input.begin( ), IsNegative( ) ) );
+    EXPECT_TRUE( bolt::cl::equal( input.begin( ), input.begin( ), input.begin( ) ) );
+}
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -0,0 +1,182 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/histogram.h>
+#include <bolt/cl/iterator/counting_iterator.h>
+#include <bolt/miniDump.h>
+
+#include <vector>
+#include <algorithm>
+
+//  Bin numbers from -3 up to numBins + 2, so some of them fall outside the bins
+std::vector< int > makeBinNumbers( size_t length, int numBins )
+{
+    std::vector< int > input( length );
+    for( size_t i = 0; i < length; ++i )
+        input[ i ] = static_cast< int >( ( i * 7919 ) % ( numBins + 6 ) ) - 3;
+    return input;
+}
+
+std::vector< unsigned int > goldHistogram( const std::vector< int >& input, int numBins )
+{
+    std::vector< unsigned int > counts( numBins, 0 );
+    for( size_t i = 0; i < input.size( ); ++i )
+    {
+        if( input[ i ] >= 0 && input[ i ] < numBins )
+            ++counts[ input[ i ] ];
+    }
+    return counts;
+}
+
+//  ( length, number of bins ); 100000 bins do not fit in local memory and take the global atomics path
+class HistogramSizes: public ::testing::TestWithParam< std::tr1::tuple< int, int > >
+{
+};
+
+TEST_P( HistogramSizes, IntAllPaths )
+{
+    int length = std::tr1::get< 0 >( GetParam( ) );
+    int numBins = std::tr1::get< 1 >( GetParam( ) );
+    std::vector< int > input = makeBinNumbers( length, numBins );
+    std::vector< unsigned int > gold = goldHistogram( input, numBins );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    bolt::cl::control::e_RunMode modes[ ] = { bolt::cl::control::OpenCL, bolt::cl::control::SerialCpu,
+                                              bolt::cl::control::MultiCoreCpu };
+    for( size_t m = 0; m < sizeof( modes ) / sizeof( modes[ 0 ] ); ++m )
+    {
+        ctl.setForceRunMode( modes[ m ] );
+
+        std::vector< unsigned int > counts( numBins, 7 );
+        bolt::cl::histogram( ctl, input.begin( ), input.end( ), counts.begin( ), counts.end( ) );
+        EXPECT_EQ( gold, counts ) << "mode " << m;
+
+        bolt::cl::device_vector< unsigned int > dvCounts( numBins, 7 );
+        bolt::cl::histogram( ctl, dvInput.begin( ), dvInput.end( ), dvCounts.begin( ), dvCounts.end( ) );
+        for( int b = 0; b < numBins; ++b )
+            EXPECT_EQ( gold[ b ], dvCounts[ b ] ) << "mode " << m << " bin " << b;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P( Histogram, HistogramSizes, ::testing::Combine(
+    ::testing::Values( 1, 255, 256, 257, 65537, 1<<20 ), ::testing::Values( 1, 17, 256, 4096, 100000 ) ) );
+
+TEST( HistogramEven, FloatAllPaths )
+{
+    //  Multiples of 1/64 between -1 and 2, binned in [0, 1): the bin edges are exact in float
+    std::vector< float > input( 1<<20 );
+    for( size_t i = 0; i < input.size( ); ++i )
+        input[ i ] = static_cast< float >( static_cast< int >( ( i * 7919 ) % 192 ) - 64 ) / 64.0f;
+
+    const int numBins = 16;
+    std::vector< unsigned int > gold( numBins, 0 );
+    for( size_t i = 0; i < input.size( ); ++i )
+    {
+        if( input[ i ] >= 0.0f && input[ i ] < 1.0f )
+            ++gold[ static_cast< int >( input[ i ] * numBins ) ];
+    }
+
+    bolt::cl::device_vector< float > dvInput( input.begin( ), input.end( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    bolt::cl::control::e_RunMode modes[ ] = { bolt::cl::control::OpenCL, bolt::cl::control::SerialCpu,
+                                              bolt::cl::control::MultiCoreCpu };
+    for( size_t m = 0; m < sizeof( modes ) / sizeof( modes[ 0 ] ); ++m )
+    {
+        ctl.setForceRunMode( modes[ m ] );
+
+        std::vector< unsigned int > counts( numBins );
+        bolt::cl::histogram_even( ctl, dvInput.begin( ), dvInput.end( ), 0.0f, 1.0f, counts.begin( ), counts.end( ) );
+        EXPECT_EQ( gold, counts ) << "mode " << m;
+    }
+}
+
+TEST( HistogramEven, IntRangeNotMultipleOfBins )
+{
+    //  100 values in 7 bins: every path has to agree with the float scaling documented for histogram_even
+    std::vector< int > input( 100000 );
+    for( size_t i = 0; i < input.size( ); ++i )
+        input[ i ] = static_cast< int >( ( i * 31 ) % 120 ) - 10;
+
+    const int numBins = 7;
+    const float scale = static_cast< float >( numBins ) / 100.0f;
+    std::vector< int > gold( numBins, 0 );
+    for( size_t i = 0; i < input.size( ); ++i )
+    {
+        if( input[ i ] >= 0 && input[ i ] < 100 )
+            ++gold[ std::min( static_cast< int >( static_cast< float >( input[ i ] ) * scale ), numBins - 1 ) ];
+    }
+
+    std::vector< int > counts( numBins );
+    bolt::cl::histogram_even( input.begin( ), input.end( ), 0, 100, counts.begin( ), counts.end( ) );
+    EXPECT_EQ( gold, counts );
+}
+
+TEST( Histogram, CountingIterator )
+{
+    bolt::cl::counting_iterator< int > first( -5 );
+    std::vector< unsigned int > counts( 10 );
+    bolt::cl::histogram( first, first + 20, counts.begin( ), counts.end( ) );
+    EXPECT_EQ( std::vector< unsigned int >( 10, 1 ), counts );
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -1205,6 +1205,44 @@ TEST( InnerProductUDD , MultiCore_UDDPlusOperatorInts )
 
 #endif
 
+TEST( InnerProductFused, SizesAroundWorkGroupsAllPaths )
+{
+    //  The second range starts 3 elements later than the first one, so the two inputs have different offsets
+    int lengths[] = { 1, 63, 64, 65, 4097, 1<<20 };
+    for( size_t l = 0; l < sizeof( lengths ) / sizeof( lengths[ 0 ] ); ++l )
+    {
+        int length = lengths[ l ];
+        std::vector< int > refInput( length );
+        std::vector< int > refInput2( length + 3 );
+        for( int i = 0; i < length; i++ )
+            refInput[i] = ( i % 11 ) - 5;
+        for( int i = 0; i < length + 3; i++ )
+            refInput2[i] = ( i % 7 ) - 3;
+        bolt::cl::device_vector< int > input( refInput.begin(), refInput.end() );
+        bolt::cl::device_vector< int > input2( refInput2.begin(), refInput2.end() );
+
+        int stdInnerProduct = std::inner_product( refInput.begin(), refInput.end(), refInput2.begin() + 3, 9,
+                                                  std::plus<int>(), std::multiplies<int>() );
+
+        bolt::cl::control ctl = bolt::cl::control::getDefault( );
+        EXPECT_EQ( stdInnerProduct, bolt::cl::inner_product( ctl, input.begin(), input.end(), input2.begin() + 3,
+            9, bolt::cl::plus<int>(), bolt::cl::multiplies<int>() ) ) << "length " << length;
+        EXPECT_EQ( stdInnerProduct, bolt::cl::inner_product( ctl, refInput.begin(), refInput.end(),
+            refInput2.begin() + 3, 9, bolt::cl::plus<int>(), bolt::cl::multiplies<int>() ) ) << "length " << length;
+
+        bolt::cl::device_scalar< int > boltResult( ctl );
+        bolt::cl::inner_product( ctl, input.begin(), input.end(), input2.begin() + 3, 9, bolt::cl::plus<int>(),
+            bolt::cl::multiplies<int>(), boltResult );
+        EXPECT_EQ( stdInnerProduct, boltResult.get( ) ) << "length " << length;
+
+        ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+        EXPECT_EQ( stdInnerProduct, bolt::cl::inner_product( ctl, input.begin(), input.end(), input2.begin() + 3,
+            9, bolt::cl::plus<int>(), bolt::cl::multiplies<int>() ) ) << "length " << length;
+        EXPECT_EQ( stdInnerProduct, bolt::cl::inner_product( ctl, refInput.begin(), refInput.end(),
+            refInput2.begin() + 3, 9, bolt::cl::plus<int>(), bolt::cl::multiplies<int>() ) ) << "length " << length;
+    }
+}
+
 INSTANTIATE_TYPED_TEST_CASE_P( Integer, InnerProductArrayTest, IntegerTests );
 INSTANTIATE_TYPED_TEST_CASE_P( Float, InnerProductArrayTest, FloatTests );
 
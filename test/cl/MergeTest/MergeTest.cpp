@@ -0,0 +1,303 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/merge.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+template< typename T >
+void makeSortedRange( std::vector< T >& v, int distinctValues )
+{
+    for( size_t i = 0; i < v.size( ); i++ )
+        v[ i ] = static_cast< T >( rand( ) % distinctValues );
+    std::sort( v.begin( ), v.end( ) );
+}
+
+/******************************************************************************
+ *  merge
+ *****************************************************************************/
+TEST(Merge, StdInt)
+{
+    std::vector< int > a( 100000 ), b( 77777 );
+    makeSortedRange( a, 1<<20 );
+    makeSortedRange( b, 1<<20 );
+    std::vector< int > std_result( a.size( ) + b.size( ) ), bolt_result( a.size( ) + b.size( ) );
+
+    std::merge( a.begin( ), a.end( ), b.begin( ), b.end( ), std_result.begin( ) );
+    std::vector< int >::iterator end = bolt::cl::merge( a.begin( ), a.end( ), b.begin( ), b.end( ),
+                                                        bolt_result.begin( ) );
+
+    EXPECT_TRUE( end == bolt_result.end( ) );
+    cmpArrays( std_result, bolt_result );
+}
+
+//  Every element of the first range orders before the second; tiles near the middle take from one range only
+TEST(Merge, StdSkewedInputs)
+{
+    std::vector< int > a( 1<<16 ), b( 1000 );
+    for( size_t i = 0; i < a.size( ); i++ )
+        a[ i ] = static_cast< int >( i );
+    for( size_t i = 0; i < b.size( ); i++ )
+        b[ i ] = static_cast< int >( a.size( ) + i );
+    std::vector< int > std_result( a.size( ) + b.size( ) ), bolt_result( a.size( ) + b.size( ) );
+
+    std::merge( b.begin( ), b.end( ), a.begin( ), a.end( ), std_result.begin( ) );
+    bolt::cl::merge( b.begin( ), b.end( ), a.begin( ), a.end( ), bolt_result.begin( ) );
+
+    cmpArrays( std_result, bolt_result );
+}
+
+TEST(Merge, StdFloatGreater)
+{
+    std::vector< float > a( 4097 ), b( 33 );
+    for( size_t i = 0; i < a.size( ); i++ )
+        a[ i ] = static_cast< float >( rand( ) - RAND_MAX/2 ) / 3.0f;
+    for( size_t i = 0; i < b.size( ); i++ )
+        b[ i ] = static_cast< float >( rand( ) - RAND_MAX/2 ) / 3.0f;
+    std::sort( a.begin( ), a.end( ), std::greater< float >( ) );
+    std::sort( b.begin( ), b.end( ), std::greater< float >( ) );
+    std::vector< float > std_result( a.size( ) + b.size( ) ), bolt_result( a.size( ) + b.size( ) );
+
+    std::merge( a.begin( ), a.end( ), b.begin( ), b.end( ), std_result.begin( ), std::greater< float >( ) );
+    bolt::cl::merge( a.begin( ), a.end( ), b.begin( ), b.end( ), bolt_result.begin( ),
+                     bolt::cl::greater< float >( ) );
+
+    cmpArrays( std_result, bolt_result );
+}
+
+TEST(Merge, DevUIntWithEmptyRange)
+{
+    std::vector< unsigned int > a( 5000 );
+    makeSortedRange( a, 100 );
+    bolt::cl::device_vector< unsigned int > dv_a( a.begin( ), a.end( ) );
+    bolt::cl::device_vector< unsigned int > dv_b( 1, 0 );
+    bolt::cl::device_vector< unsigned int > dv_result( a.size( ), 0 );
+
+    bolt::cl::merge( dv_a.begin( ), dv_a.end( ), dv_b.begin( ), dv_b.begin( ), dv_result.begin( ) );
+
+    cmpArrays( a, dv_result );
+}
+
+TEST(Merge, DevOffsets)
+{
+    std::vector< int > a( 3000 ), b( 2000 );
+    makeSortedRange( a, 500 );
+    makeSortedRange( b, 500 );
+    bolt::cl::device_vector< int > dv_a( a.begin( ), a.end( ) );
+    bolt::cl::device_vector< int > dv_b( b.begin( ), b.end( ) );
+    bolt::cl::device_vector< int > dv_result( 4600, -1 );
+
+    //  Merge the middle of both ranges into the middle of the output
+    std::vector< int > std_result( 4600, -1 );
+    std::merge( a.begin( ) + 100, a.end( ) - 100, b.begin( ) + 50, b.end( ) - 50, std_result.begin( ) + 10 );
+    bolt::cl::merge( dv_a.begin( ) + 100, dv_a.end( ) - 100, dv_b.begin( ) + 50, dv_b.end( ) - 50,
+                     dv_result.begin( ) + 10 );
+
+    cmpArrays( std_result, dv_result );
+}
+
+TEST(SerialCPU, MergeInt)
+{
+    std::vector< int > a( 10000 ), b( 20000 );
+    makeSortedRange( a, 1000 );
+    makeSortedRange( b, 1000 );
+    std::vector< int > std_result( a.size( ) + b.size( ) ), bolt_result( a.size( ) + b.size( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    std::merge( a.begin( ), a.end( ), b.begin( ), b.end( ), std_result.begin( ) );
+    bolt::cl::merge( ctl, a.begin( ), a.end( ), b.begin( ), b.end( ), bolt_result.begin( ) );
+
+    cmpArrays( std_result, bolt_result );
+}
+
+TEST(MultiCoreCPU, MergeInt)
+{
+    std::vector< int > a( 1<<20 ), b( 1<<18 );
+    makeSortedRange( a, 1<<16 );
+    makeSortedRange( b, 1<<16 );
+    std::vector< int > std_result( a.size( ) + b.size( ) ), bolt_result( a.size( ) + b.size( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::merge( a.begin( ), a.end( ), b.begin( ), b.end( ), std_result.begin( ) );
+    bolt::cl::merge( ctl, a.begin( ), a.end( ), b.begin( ), b.end( ), bolt_result.begin( ) );
+
+    cmpArrays( std_result, bolt_result );
+}
+
+/******************************************************************************
+ *  merge_by_key
+ *****************************************************************************/
+//  Reference for merge_by_key: values are the original positions, so stability shows in the value output
+void referenceMergeByKey( const std::vector< int >& keys1, const std::vector< int >& keys2,
+                          std::vector< int >& keys, std::vector< int >& values )
+{
+    size_t i = 0, j = 0, out = 0;
+    while( i < keys1.size( ) || j < keys2.size( ) )
+    {
+        if( j < keys2.size( ) && ( i == keys1.size( ) || keys2[ j ] < keys1[ i ] ) )
+        {
+            keys[ out ] = keys2[ j ];
+            values[ out++ ] = -1 - static_cast< int >( j++ );
+        }
+        else
+        {
+            keys[ out ] = keys1[ i ];
+            values[ out++ ] = static_cast< int >( i++ );
+        }
+    }
+}
+
+void makeMergeValues( std::vector< int >& values1, std::vector< int >& values2 )
+{
+    for( size_t i = 0; i < values1.size( ); i++ )
+        values1[ i ] = static_cast< int >( i );
+    for( size_t j = 0; j < values2.size( ); j++ )
+        values2[ j ] = -1 - static_cast< int >( j );
+}
+
+TEST(MergeByKey, StdIntManyDuplicates)
+{
+    std::vector< int > keys1( 50000 ), keys2( 60000 ), values1( 50000 ), values2( 60000 );
+    makeSortedRange( keys1, 7 );
+    makeSortedRange( keys2, 7 );
+    makeMergeValues( values1, values2 );
+    size_t length = keys1.size( ) + keys2.size( );
+    std::vector< int > std_keys( length ), std_values( length ), bolt_keys( length ), bolt_values( length );
+
+    referenceMergeByKey( keys1, keys2, std_keys, std_values );
+    bolt::cl::merge_by_key( keys1.begin( ), keys1.end( ), keys2.begin( ), keys2.end( ),
+                            values1.begin( ), values2.begin( ), bolt_keys.begin( ), bolt_values.begin( ) );
+
+    cmpArrays( std_keys, bolt_keys );
+    cmpArrays( std_values, bolt_values );
+}
+
+TEST(MergeByKey, DevInt)
+{
+    std::vector< int > keys1( 1<<16 ), keys2( 12345 ), values1( 1<<16 ), values2( 12345 );
+    makeSortedRange( keys1, 1000 );
+    makeSortedRange( keys2, 1000 );
+    makeMergeValues( values1, values2 );
+    size_t length = keys1.size( ) + keys2.size( );
+    std::vector< int > std_keys( length ), std_values( length );
+
+    bolt::cl::device_vector< int > dv_keys1( keys1.begin( ), keys1.end( ) );
+    bolt::cl::device_vector< int > dv_keys2( keys2.begin( ), keys2.end( ) );
+    bolt::cl::device_vector< int > dv_values1( values1.begin( ), values1.end( ) );
+    bolt::cl::device_vector< int > dv_values2( values2.begin( ), values2.end( ) );
+    bolt::cl::device_vector< int > dv_keys( length, 0 );
+    bolt::cl::device_vector< int > dv_values( length, 0 );
+
+    referenceMergeByKey( keys1, keys2, std_keys, std_values );
+    bolt::cl::merge_by_key( dv_keys1.begin( ), dv_keys1.end( ), dv_keys2.begin( ), dv_keys2.end( ),
+                            dv_values1.begin( ), dv_values2.begin( ), dv_keys.begin( ), dv_values.begin( ) );
+
+    cmpArrays( std_keys, dv_keys );
+    cmpArrays( std_values, dv_values );
+}
+
+TEST(SerialCPU, MergeByKeyInt)
+{
+    std::vector< int > keys1( 3000 ), keys2( 5000 ), values1( 3000 ), values2( 5000 );
+    makeSortedRange( keys1, 50 );
+    makeSortedRange( keys2, 50 );
+    makeMergeValues( values1, values2 );
+    size_t length = keys1.size( ) + keys2.size( );
+    std::vector< int > std_keys( length ), std_values( length ), bolt_keys( length ), bolt_values( length );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    referenceMergeByKey( keys1, keys2, std_keys, std_values );
+    bolt::cl::merge_by_key( ctl, keys1.begin( ), keys1.end( ), keys2.begin( ), keys2.end( ),
+                            values1.begin( ), values2.begin( ), bolt_keys.begin( ), bolt_values.begin( ) );
+
+    cmpArrays( std_keys, bolt_keys );
+    cmpArrays( std_values, bolt_values );
+}
+
+TEST(MultiCoreCPU, MergeByKeyInt)
+{
+    std::vector< int > keys1( 1<<19 ), keys2( 1<<17 ), values1( 1<<19 ), values2( 1<<17 );
+    makeSortedRange( keys1, 100 );
+    makeSortedRange( keys2, 100 );
+    makeMergeValues( values1, values2 );
+    size_t length = keys1.size( ) + keys2.size( );
+    std::vector< int > std_keys( length ), std_values( length ), bolt_keys( length ), bolt_values( length );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    referenceMergeByKey( keys1, keys2, std_keys, std_values );
+    bolt::cl::merge_by_key( ctl, keys1.begin( ), keys1.end( ), keys2.begin( ), keys2.end( ),
+                            values1.begin( ), values2.begin( ), bolt_keys.begin( ), bolt_values.begin( ) );
+
+    cmpArrays( std_keys, bolt_keys );
+    cmpArrays( std_values, bolt_values );
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
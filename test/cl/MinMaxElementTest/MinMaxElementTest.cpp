@@ -0,0 +1,230 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/minmax_element.h>
+#include <bolt/cl/argmin_by_key.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+//  Few distinct values, so every size has repeated minima and maxima in several work-groups
+template< typename T >
+std::vector< T > makeInput( size_t length )
+{
+    std::vector< T > input( length );
+    for( size_t i = 0; i < length; ++i )
+        input[ i ] = static_cast< T >( ( i * 7919 ) % 41 ) - static_cast< T >( 20 );
+    return input;
+}
+
+//  Runs of 1 to 9 keys
+std::vector< int > makeKeys( size_t length )
+{
+    std::vector< int > keys( length );
+    int key = 0;
+    size_t runLength = 0;
+    for( size_t i = 0; i < length; ++i )
+    {
+        if( runLength == 0 )
+        {
+            ++key;
+            runLength = 1 + ( i * 31 ) % 9;
+        }
+        keys[ i ] = key;
+        --runLength;
+    }
+    return keys;
+}
+
+template< typename T, typename StrictWeakOrdering >
+size_t goldArgminByKey( const std::vector< int >& keys, const std::vector< T >& values, std::vector< int >& keysOut,
+                        std::vector< int >& indicesOut, StrictWeakOrdering comp )
+{
+    size_t count = 0;
+    for( size_t begin = 0; begin < keys.size( ); ++count )
+    {
+        size_t end = begin;
+        while( end < keys.size( ) && keys[ end ] == keys[ begin ] )
+            ++end;
+        keysOut[ count ] = keys[ begin ];
+        indicesOut[ count ] = static_cast< int >( std::min_element( values.begin( ) + begin, values.begin( ) + end,
+                                                                    comp ) - values.begin( ) );
+        begin = end;
+    }
+    return count;
+}
+
+class MinMaxElementSizes: public ::testing::TestWithParam< int >
+{
+};
+
+TEST_P( MinMaxElementSizes, IntDeviceVector )
+{
+    std::vector< int > input = makeInput< int >( GetParam( ) );
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+
+    std::pair< std::vector< int >::iterator, std::vector< int >::iterator > gold =
+        std::minmax_element( input.begin( ), input.end( ) );
+    std::pair< bolt::cl::device_vector< int >::iterator, bolt::cl::device_vector< int >::iterator > bounds =
+        bolt::cl::minmax_element( dvInput.begin( ), dvInput.end( ) );
+
+    EXPECT_EQ( gold.first - input.begin( ), bounds.first - dvInput.begin( ) );
+    EXPECT_EQ( gold.second - input.begin( ), bounds.second - dvInput.begin( ) );
+}
+
+TEST_P( MinMaxElementSizes, FloatStdVectorGreater )
+{
+    std::vector< float > input = makeInput< float >( GetParam( ) );
+
+    std::pair< std::vector< float >::iterator, std::vector< float >::iterator > gold =
+        std::minmax_element( input.begin( ), input.end( ), std::greater< float >( ) );
+    std::pair< std::vector< float >::iterator, std::vector< float >::iterator > bounds =
+        bolt::cl::minmax_element( input.begin( ), input.end( ), bolt::cl::greater< float >( ) );
+
+    EXPECT_EQ( gold.first - input.begin( ), bounds.first - input.begin( ) );
+    EXPECT_EQ( gold.second - input.begin( ), bounds.second - input.begin( ) );
+}
+
+TEST_P( MinMaxElementSizes, IntCpuPaths )
+{
+    std::vector< int > input = makeInput< int >( GetParam( ) );
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+
+    std::pair< std::vector< int >::iterator, std::vector< int >::iterator > gold =
+        std::minmax_element( input.begin( ), input.end( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    bolt::cl::control::e_RunMode modes[ ] = { bolt::cl::control::SerialCpu, bolt::cl::control::MultiCoreCpu };
+    for( size_t m = 0; m < sizeof( modes ) / sizeof( modes[ 0 ] ); ++m )
+    {
+        ctl.setForceRunMode( modes[ m ] );
+
+        std::pair< std::vector< int >::iterator, std::vector< int >::iterator > bounds =
+            bolt::cl::minmax_element( ctl, input.begin( ), input.end( ) );
+        EXPECT_EQ( gold.first - input.begin( ), bounds.first - input.begin( ) );
+        EXPECT_EQ( gold.second - input.begin( ), bounds.second - input.begin( ) );
+
+        std::pair< bolt::cl::device_vector< int >::iterator, bolt::cl::device_vector< int >::iterator > dvBounds =
+            bolt::cl::minmax_element( ctl, dvInput.begin( ), dvInput.end( ) );
+        EXPECT_EQ( gold.first - input.begin( ), dvBounds.first - dvInput.begin( ) );
+        EXPECT_EQ( gold.second - input.begin( ), dvBounds.second - dvInput.begin( ) );
+
+        EXPECT_EQ( std::min_element( input.begin( ), input.end( ) ) - input.begin( ),
+                   bolt::cl::min_element( ctl, dvInput.begin( ), dvInput.end( ) ) - dvInput.begin( ) );
+    }
+}
+
+TEST_P( MinMaxElementSizes, ArgminArgmaxByKey )
+{
+    std::vector< int > keys = makeKeys( GetParam( ) );
+    std::vector< float > values = makeInput< float >( GetParam( ) );
+
+    std::vector< int > goldKeys( keys.size( ) ), goldIndices( keys.size( ) );
+    std::vector< int > keysOut( keys.size( ) ), indicesOut( keys.size( ) );
+
+    size_t numRuns = goldArgminByKey( keys, values, goldKeys, goldIndices, std::less< float >( ) );
+    bolt::cl::pair< std::vector< int >::iterator, std::vector< int >::iterator > ends =
+        bolt::cl::argmin_by_key( keys.begin( ), keys.end( ), values.begin( ), keysOut.begin( ), indicesOut.begin( ) );
+    ASSERT_EQ( numRuns, static_cast< size_t >( ends.first - keysOut.begin( ) ) );
+    for( size_t i = 0; i < numRuns; ++i )
+    {
+        EXPECT_EQ( goldKeys[ i ], keysOut[ i ] );
+        EXPECT_EQ( goldIndices[ i ], indicesOut[ i ] ) << "run " << i;
+    }
+
+    numRuns = goldArgminByKey( keys, values, goldKeys, goldIndices, std::greater< float >( ) );
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    bolt::cl::control::e_RunMode modes[ ] = { bolt::cl::control::OpenCL, bolt::cl::control::SerialCpu,
+                                              bolt::cl::control::MultiCoreCpu };
+    for( size_t m = 0; m < sizeof( modes ) / sizeof( modes[ 0 ] ); ++m )
+    {
+        ctl.setForceRunMode( modes[ m ] );
+
+        bolt::cl::device_vector< int > dvKeys( keys.begin( ), keys.end( ) );
+        bolt::cl::device_vector< float > dvValues( values.begin( ), values.end( ) );
+        bolt::cl::device_vector< int > dvKeysOut( keys.size( ) ), dvIndicesOut( keys.size( ) );
+
+        bolt::cl::pair< bolt::cl::device_vector< int >::iterator, bolt::cl::device_vector< int >::iterator > dvEnds =
+            bolt::cl::argmax_by_key( ctl, dvKeys.begin( ), dvKeys.end( ), dvValues.begin( ), dvKeysOut.begin( ),
+                                     dvIndicesOut.begin( ) );
+        ASSERT_EQ( numRuns, static_cast< size_t >( dvEnds.first - dvKeysOut.begin( ) ) );
+        for( size_t i = 0; i < numRuns; ++i )
+        {
+            EXPECT_EQ( goldKeys[ i ], dvKeysOut[ i ] );
+            EXPECT_EQ( goldIndices[ i ], dvIndicesOut[ i ] ) << "run " << i;
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P( MinMaxElement, MinMaxElementSizes, ::testing::Values( 1, 63, 64, 65, 1000, 65537, 1<<20 ) );
+
+TEST( MinMaxElement, EmptyRange )
+{
+    std::vector< int > input( 16, 3 );
+
+    std::pair< std::vector< int >::iterator, std::vector< int >::iterator > bounds =
+        bolt::cl::minmax_element( input.begin( ), input.begin( ) );
+    EXPECT_EQ( input.begin( ), bounds.first );
+    EXPECT_EQ( input.begin( ), bounds.second );
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -0,0 +1,474 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/partial_sort.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+/******************************************************************************
+ *  partial_sort
+ *****************************************************************************/
+TEST(PartialSort, StdInt)
+{
+    size_t length = 1<<16;
+    size_t middle = 100;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( ) - RAND_MAX/2;
+    std::vector< int > bolt_source( std_source );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::partial_sort( bolt_source.begin( ), bolt_source.begin( ) + middle, bolt_source.end( ) );
+
+    std_source.resize( middle );
+    cmpArrays( std_source, bolt_source );
+}
+
+TEST(PartialSort, StdFloatGreater)
+{
+    size_t length = 100000;
+    size_t middle = 1000;
+    std::vector< float > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = static_cast< float >( rand( ) - RAND_MAX/2 ) / 7.0f;
+    std::vector< float > bolt_source( std_source );
+
+    std::sort( std_source.begin( ), std_source.end( ), std::greater< float >( ) );
+    bolt::cl::partial_sort( bolt_source.begin( ), bolt_source.begin( ) + middle, bolt_source.end( ),
+                            bolt::cl::greater< float >( ) );
+
+    std_source.resize( middle );
+    cmpArrays( std_source, bolt_source );
+}
+
+TEST(PartialSort, DevUInt)
+{
+    size_t length = 1<<18;
+    size_t middle = 513;
+    std::vector< unsigned int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = static_cast< unsigned int >( rand( ) % 1000 );
+    bolt::cl::device_vector< unsigned int > dv_source( std_source.begin( ), std_source.end( ) );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::partial_sort( dv_source.begin( ), dv_source.begin( ) + middle, dv_source.end( ) );
+
+    std_source.resize( middle );
+    cmpArrays( std_source, dv_source );
+}
+
+TEST(PartialSort, Serial_StdInt)
+{
+    size_t length = 10000;
+    size_t middle = 64;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( );
+    std::vector< int > bolt_source( std_source );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::partial_sort( ctl, bolt_source.begin( ), bolt_source.begin( ) + middle, bolt_source.end( ) );
+
+    std_source.resize( middle );
+    cmpArrays( std_source, bolt_source );
+}
+
+TEST(PartialSort, MultiCore_StdInt)
+{
+    size_t length = 1<<20;
+    size_t middle = 5000;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( );
+    std::vector< int > bolt_source( std_source );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::partial_sort( ctl, bolt_source.begin( ), bolt_source.begin( ) + middle, bolt_source.end( ) );
+
+    std_source.resize( middle );
+    cmpArrays( std_source, bolt_source );
+}
+
+TEST(PartialSort, MultiCore_DevFloat)
+{
+    size_t length = 1<<18;
+    size_t middle = 300;
+    std::vector< float > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = static_cast< float >( rand( ) ) / 3.0f;
+    bolt::cl::device_vector< float > dv_source( std_source.begin( ), std_source.end( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::partial_sort( ctl, dv_source.begin( ), dv_source.begin( ) + middle, dv_source.end( ) );
+
+    std_source.resize( middle );
+    cmpArrays( std_source, dv_source );
+}
+
+#if (TEST_DOUBLE == 1)
+TEST(PartialSort, StdDouble)
+{
+    size_t length = 50000;
+    size_t middle = 777;
+    std::vector< double > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = static_cast< double >( rand( ) ) / 11.0;
+    std::vector< double > bolt_source( std_source );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::partial_sort( bolt_source.begin( ), bolt_source.begin( ) + middle, bolt_source.end( ) );
+
+    std_source.resize( middle );
+    cmpArrays( std_source, bolt_source );
+}
+#endif
+
+/******************************************************************************
+ *  nth_element
+ *****************************************************************************/
+TEST(NthElement, StdIntMedian)
+{
+    size_t length = 1<<17;
+    size_t nth = length / 2;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( ) - RAND_MAX/2;
+    std::vector< int > bolt_source( std_source );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::nth_element( bolt_source.begin( ), bolt_source.begin( ) + nth, bolt_source.end( ) );
+
+    EXPECT_EQ( std_source[ nth ], bolt_source[ nth ] );
+    for( size_t i = 0; i < nth; i++ )
+        EXPECT_LE( bolt_source[ i ], bolt_source[ nth ] ) << _T( "Where i = " ) << i;
+    for( size_t i = nth + 1; i < length; i++ )
+        EXPECT_GE( bolt_source[ i ], bolt_source[ nth ] ) << _T( "Where i = " ) << i;
+}
+
+TEST(NthElement, StdFloatDuplicates)
+{
+    size_t length = 100000;
+    size_t nth = 31337;
+    std::vector< float > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = static_cast< float >( rand( ) % 16 ) - 8.0f;
+    std::vector< float > bolt_source( std_source );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::nth_element( bolt_source.begin( ), bolt_source.begin( ) + nth, bolt_source.end( ) );
+
+    EXPECT_EQ( std_source[ nth ], bolt_source[ nth ] );
+}
+
+TEST(NthElement, Serial_StdInt)
+{
+    size_t length = 10000;
+    size_t nth = 4321;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( );
+    std::vector< int > bolt_source( std_source );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::nth_element( ctl, bolt_source.begin( ), bolt_source.begin( ) + nth, bolt_source.end( ) );
+
+    EXPECT_EQ( std_source[ nth ], bolt_source[ nth ] );
+}
+
+TEST(NthElement, MultiCore_StdInt)
+{
+    size_t length = 1<<20;
+    size_t nth = 12345;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( );
+    std::vector< int > bolt_source( std_source );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    bolt::cl::nth_element( ctl, bolt_source.begin( ), bolt_source.begin( ) + nth, bolt_source.end( ) );
+
+    EXPECT_EQ( std_source[ nth ], bolt_source[ nth ] );
+}
+
+TEST(NthElement, DevIntOffset)
+{
+    size_t length = 1<<16;
+    size_t offset = 1000;
+    size_t nth = 2000;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( );
+    bolt::cl::device_vector< int > dv_source( std_source.begin( ), std_source.end( ) );
+
+    std::sort( std_source.begin( ) + offset, std_source.end( ) );
+    bolt::cl::nth_element( dv_source.begin( ) + offset, dv_source.begin( ) + offset + nth, dv_source.end( ) );
+
+    EXPECT_EQ( std_source[ offset + nth ], dv_source[ offset + nth ] );
+}
+
+/******************************************************************************
+ *  top_k
+ *****************************************************************************/
+TEST(TopK, StdInt)
+{
+    size_t length = 1<<20;
+    size_t k = 100;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( ) - RAND_MAX/2;
+    std::vector< int > bolt_result( k );
+
+    std::vector< int >::iterator end = bolt::cl::top_k( std_source.begin( ), std_source.end( ), k,
+                                                        bolt_result.begin( ) );
+
+    std::sort( std_source.begin( ), std_source.end( ), std::greater< int >( ) );
+    std_source.resize( k );
+    EXPECT_EQ( bolt_result.end( ), end );
+    cmpArrays( std_source, bolt_result );
+}
+
+TEST(TopK, StdFloatLess)
+{
+    size_t length = 100000;
+    size_t k = 1024;
+    std::vector< float > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = static_cast< float >( rand( ) - RAND_MAX/2 ) / 5.0f;
+    std::vector< float > bolt_result( k );
+
+    bolt::cl::top_k( std_source.begin( ), std_source.end( ), k, bolt_result.begin( ), bolt::cl::less< float >( ) );
+
+    std::sort( std_source.begin( ), std_source.end( ) );
+    std_source.resize( k );
+    cmpArrays( std_source, bolt_result );
+}
+
+TEST(TopK, DevUInt)
+{
+    size_t length = 1<<18;
+    size_t k = 10;
+    std::vector< unsigned int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = static_cast< unsigned int >( rand( ) );
+    bolt::cl::device_vector< unsigned int > dv_source( std_source.begin( ), std_source.end( ) );
+    bolt::cl::device_vector< unsigned int > dv_result( k );
+
+    bolt::cl::top_k( dv_source.begin( ), dv_source.end( ), k, dv_result.begin( ) );
+
+    std::sort( std_source.begin( ), std_source.end( ), std::greater< unsigned int >( ) );
+    std_source.resize( k );
+    cmpArrays( std_source, dv_result );
+}
+
+TEST(TopK, Serial_StdInt)
+{
+    size_t length = 10000;
+    size_t k = 50;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( );
+    std::vector< int > bolt_result( k );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    bolt::cl::top_k( ctl, std_source.begin( ), std_source.end( ), k, bolt_result.begin( ) );
+
+    std::sort( std_source.begin( ), std_source.end( ), std::greater< int >( ) );
+    std_source.resize( k );
+    cmpArrays( std_source, bolt_result );
+}
+
+TEST(TopK, MultiCore_StdInt)
+{
+    size_t length = 1<<20;
+    size_t k = 1000;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( );
+    std::vector< int > bolt_result( k );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    bolt::cl::top_k( ctl, std_source.begin( ), std_source.end( ), k, bolt_result.begin( ) );
+
+    std::sort( std_source.begin( ), std_source.end( ), std::greater< int >( ) );
+    std_source.resize( k );
+    cmpArrays( std_source, bolt_result );
+}
+
+TEST(TopK, LargerThanInput)
+{
+    size_t length = 100;
+    std::vector< int > std_source( length );
+    for( size_t i = 0; i < length; i++ )
+        std_source[ i ] = rand( );
+    std::vector< int > bolt_result( 2 * length );
+
+    std::vector< int >::iterator end = bolt::cl::top_k( std_source.begin( ), std_source.end( ), 2 * length,
+                                                        bolt_result.begin( ) );
+
+    EXPECT_EQ( bolt_result.begin( ) + length, end );
+    std::sort( std_source.begin( ), std_source.end( ), std::greater< int >( ) );
+    cmpArrays( std_source, bolt_result );
+}
+
+/******************************************************************************
+ *  top_k_by_key
+ *****************************************************************************/
+TEST(TopKByKey, StdFloatInt)
+{
+    size_t length = 1<<18;
+    size_t k = 256;
+    std::vector< float > keys( length );
+    std::vector< int > values( length );
+    for( size_t i = 0; i < length; i++ )
+    {
+        //  Unique keys so the values are unambiguous
+        keys[ i ] = static_cast< float >( ( i * 7919 ) % length );
+        values[ i ] = static_cast< int >( i );
+    }
+    std::vector< float > bolt_keys( k );
+    std::vector< int > bolt_values( k );
+
+    bolt::cl::top_k_by_key( keys.begin( ), keys.end( ), values.begin( ), k, bolt_keys.begin( ),
+                            bolt_values.begin( ) );
+
+    for( size_t i = 0; i < k; i++ )
+    {
+        EXPECT_EQ( static_cast< float >( length - 1 - i ), bolt_keys[ i ] ) << _T( "Where i = " ) << i;
+        EXPECT_EQ( bolt_keys[ i ], keys[ bolt_values[ i ] ] ) << _T( "Where i = " ) << i;
+    }
+}
+
+TEST(TopKByKey, Serial_StdIntInt)
+{
+    size_t length = 10000;
+    size_t k = 10;
+    std::vector< int > keys( length );
+    std::vector< int > values( length );
+    for( size_t i = 0; i < length; i++ )
+    {
+        keys[ i ] = static_cast< int >( ( i * 7919 ) % length );
+        values[ i ] = static_cast< int >( i );
+    }
+    std::vector< int > bolt_keys( k );
+    std::vector< int > bolt_values( k );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    bolt::cl::top_k_by_key( ctl, keys.begin( ), keys.end( ), values.begin( ), k, bolt_keys.begin( ),
+                            bolt_values.begin( ), bolt::cl::less< int >( ) );
+
+    for( size_t i = 0; i < k; i++ )
+    {
+        EXPECT_EQ( static_cast< int >( i ), bolt_keys[ i ] ) << _T( "Where i = " ) << i;
+        EXPECT_EQ( bolt_keys[ i ], keys[ bolt_values[ i ] ] ) << _T( "Where i = " ) << i;
+    }
+}
+
+TEST(TopKByKey, MultiCore_StdIntInt)
+{
+    size_t length = 1<<20;
+    size_t k = 4096;
+    std::vector< int > keys( length );
+    std::vector< int > values( length );
+    for( size_t i = 0; i < length; i++ )
+    {
+        keys[ i ] = static_cast< int >( ( i * 7919 ) % length );
+        values[ i ] = static_cast< int >( i );
+    }
+    std::vector< int > bolt_keys( k );
+    std::vector< int > bolt_values( k );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    bolt::cl::top_k_by_key( ctl, keys.begin( ), keys.end( ), values.begin( ), k, bolt_keys.begin( ),
+                            bolt_values.begin( ) );
+
+    for( size_t i = 0; i < k; i++ )
+    {
+        EXPECT_EQ( static_cast< int >( length - 1 - i ), bolt_keys[ i ] ) << _T( "Where i = " ) << i;
+        EXPECT_EQ( bolt_keys[ i ], keys[ bolt_values[ i ] ] ) << _T( "Where i = " ) << i;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -0,0 +1,183 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/partition.h>
+#ifdef ENABLE_TBB
+#include <bolt/btbb/partition.h>
+#endif
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+BOLT_FUNCTOR( IsEven,
+struct IsEven
+{
+    bool operator( )( const int x ) const
+    {
+        return ( x % 2 ) == 0;
+    }
+};
+);
+
+//  Checks that [first, middle) satisfies the predicate and [middle, last) does not
+template< typename Iterator >
+void checkPartitioned( Iterator first, Iterator middle, Iterator last )
+{
+    for( Iterator i = first; i != middle; ++i )
+        EXPECT_TRUE( IsEven( )( *i ) );
+    for( Iterator i = middle; i != last; ++i )
+        EXPECT_FALSE( IsEven( )( *i ) );
+}
+
+class PartitionTest : public ::testing::TestWithParam< int >
+{
+public:
+    PartitionTest( ) : input( GetParam( ) )
+    {
+        for( size_t i = 0; i < input.size( ); i++ )
+            input[ i ] = rand( ) % 1000;
+    }
+
+protected:
+    std::vector< int > input;
+};
+
+TEST_P( PartitionTest, StablePartition )
+{
+    std::vector< int > stdInput( input );
+    std::vector< int >::iterator stdMiddle = std::stable_partition( stdInput.begin( ), stdInput.end( ), IsEven( ) );
+    std::vector< int >::iterator boltMiddle = bolt::cl::stable_partition( input.begin( ), input.end( ), IsEven( ) );
+
+    EXPECT_EQ( stdMiddle - stdInput.begin( ), boltMiddle - input.begin( ) );
+    cmpArrays( stdInput, input );
+}
+
+TEST_P( PartitionTest, StablePartitionDeviceVector )
+{
+    std::vector< int > stdInput( input );
+    std::vector< int >::iterator stdMiddle = std::stable_partition( stdInput.begin( ), stdInput.end( ), IsEven( ) );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int >::iterator boltMiddle = bolt::cl::stable_partition( dvInput.begin( ),
+                                                                                      dvInput.end( ), IsEven( ) );
+
+    EXPECT_EQ( stdMiddle - stdInput.begin( ), boltMiddle - dvInput.begin( ) );
+    cmpArrays( stdInput, dvInput );
+}
+
+TEST_P( PartitionTest, Partition )
+{
+    std::vector< int >::iterator boltMiddle = bolt::cl::partition( input.begin( ), input.end( ), IsEven( ) );
+    checkPartitioned( input.begin( ), boltMiddle, input.end( ) );
+}
+
+TEST_P( PartitionTest, SerialStablePartition )
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    std::vector< int > stdInput( input );
+    std::vector< int >::iterator stdMiddle = std::stable_partition( stdInput.begin( ), stdInput.end( ), IsEven( ) );
+    std::vector< int >::iterator boltMiddle = bolt::cl::stable_partition( ctl, input.begin( ), input.end( ),
+                                                                          IsEven( ) );
+
+    EXPECT_EQ( stdMiddle - stdInput.begin( ), boltMiddle - input.begin( ) );
+    cmpArrays( stdInput, input );
+}
+
+TEST_P( PartitionTest, MultiCoreStablePartitionDeviceVector )
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::vector< int > stdInput( input );
+    std::vector< int >::iterator stdMiddle = std::stable_partition( stdInput.begin( ), stdInput.end( ), IsEven( ) );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int >::iterator boltMiddle = bolt::cl::stable_partition( ctl, dvInput.begin( ),
+                                                                                      dvInput.end( ), IsEven( ) );
+
+    EXPECT_EQ( stdMiddle - stdInput.begin( ), boltMiddle - dvInput.begin( ) );
+    cmpArrays( stdInput, dvInput );
+}
+
+TEST_P( PartitionTest, MultiCorePartition )
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::vector< int >::iterator boltMiddle = bolt::cl::partition( ctl, input.begin( ), input.end( ), IsEven( ) );
+    checkPartitioned( input.begin( ), boltMiddle, input.end( ) );
+}
+
+#ifdef ENABLE_TBB
+//  Calls the TBB partition directly on std::vector iterators, where argument dependent lookup also finds the std
+//  algorithms
+TEST_P( PartitionTest, TbbPartitionStdVector )
+{
+    std::vector< int >::iterator boltMiddle = bolt::btbb::partition( input.begin( ), input.end( ), IsEven( ) );
+    checkPartitioned( input.begin( ), boltMiddle, input.end( ) );
+}
+#endif
+
+INSTANTIATE_TEST_CASE_P( PartitionSizes, PartitionTest, ::testing::Values( 1, 31, 256, 257, 2049, 65536,
+                                                                           1048579 ) );
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -1687,6 +1687,57 @@ TEST(ReduceByKeyPairUDDTest, MultiCore_UDDFloatIntTest)
 
 }
 
+//  Runs that are longer than a tile, single elements, and runs that straddle the tile boundaries, on an input that
+//  ends in a partial tile
+TEST(ReduceByKeyBasic, RunsAcrossTiles)
+{
+    int length = (1<<20) + 17;
+    std::vector< int > keys(length);
+    std::vector< int > refInput(length);
+
+    int key = 0;
+    for (int i = 0; i < length; )
+    {
+        int runLength = (key % 3 == 0) ? 5000 + key : ((key % 3 == 1) ? 1 : 37);
+        for (int j = 0; j < runLength && i < length; ++j, ++i)
+        {
+            keys[i] = key;
+            refInput[i] = (i % 7) - 3;
+        }
+        ++key;
+    }
+
+    bolt::cl::device_vector< int > device_keys(keys.begin(), keys.end());
+    bolt::cl::device_vector< int > input(refInput.begin(), refInput.end());
+    bolt::cl::device_vector< int > koutput(length);
+    bolt::cl::device_vector< int > voutput(length);
+    std::vector< int > krefOutput(length);
+    std::vector< int > vrefOutput(length);
+
+    auto p = bolt::cl::reduce_by_key( device_keys.begin(), device_keys.end(), input.begin(), koutput.begin(),
+                                      voutput.begin(), bolt::cl::equal_to<int>(), bolt::cl::plus<int>() );
+    auto refPair = gold_reduce_by_key( keys.begin(), keys.end(), refInput.begin(), krefOutput.begin(),
+                                       vrefOutput.begin(), std::plus<int>() );
+
+    EXPECT_EQ( refPair.first - krefOutput.begin(), p.first - koutput.begin() );
+    cmpArrays(krefOutput, koutput);
+    cmpArrays(vrefOutput, voutput);
+}
+
+TEST(ReduceByKeyBasic, EmptyInput)
+{
+    bolt::cl::device_vector< int > device_keys(1);
+    bolt::cl::device_vector< int > input(1);
+    bolt::cl::device_vector< int > koutput(1);
+    bolt::cl::device_vector< int > voutput(1);
+
+    auto p = bolt::cl::reduce_by_key( device_keys.begin(), device_keys.begin(), input.begin(), koutput.begin(),
+                                      voutput.begin(), bolt::cl::equal_to<int>(), bolt::cl::plus<int>() );
+
+    EXPECT_EQ( 0, p.first - koutput.begin() );
+    EXPECT_EQ( 0, p.second - voutput.begin() );
+}
+
 #endif
 
 int _tmain(int argc, _TCHAR* argv[])
@@ -0,0 +1,243 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/reduce_by_key_unsorted.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <map>
+#include <algorithm>
+
+//  Not one of the reductions with an atomic, so the OpenCL path has to sort
+BOLT_FUNCTOR( AbsMax,
+struct AbsMax
+{
+    int operator( )( const int lhs, const int rhs ) const
+    {
+        int l = lhs < 0 ? -lhs : lhs;
+        int r = rhs < 0 ? -rhs : rhs;
+        return ( l < r ) ? rhs : lhs;
+    }
+};
+);
+
+//  The groups come out in an unspecified order; compares them with the reference, one key at a time
+template< typename K, typename V, typename KeyIterator, typename ValueIterator >
+void checkGroups( const std::map< K, V >& reference, KeyIterator keys_first, KeyIterator keys_last,
+                  ValueIterator values_first )
+{
+    ASSERT_EQ( reference.size( ), static_cast< size_t >( keys_last - keys_first ) );
+
+    std::map< K, V > result;
+    for( ; keys_first != keys_last; ++keys_first, ++values_first )
+        result[ *keys_first ] = *values_first;
+
+    ASSERT_EQ( reference.size( ), result.size( ) );
+    typename std::map< K, V >::const_iterator ref = reference.begin( );
+    typename std::map< K, V >::const_iterator res = result.begin( );
+    for( ; ref != reference.end( ); ++ref, ++res )
+    {
+        EXPECT_EQ( ref->first, res->first );
+        EXPECT_EQ( ref->second, res->second );
+    }
+}
+
+//  The parameter is the number of elements; the keys are scattered over 1000 values, -1 among them because its bits
+//  mark an empty slot of the device table
+class ReduceByKeyUnsortedTest : public ::testing::TestWithParam< int >
+{
+public:
+    ReduceByKeyUnsortedTest( ) : keys( GetParam( ) ), values( GetParam( ) )
+    {
+        for( size_t i = 0; i < keys.size( ); i++ )
+        {
+            keys[ i ] = ( rand( ) % 1000 ) - 500;
+            values[ i ] = ( rand( ) % 100 ) - 50;
+        }
+    }
+
+protected:
+    std::vector< int > keys;
+    std::vector< int > values;
+};
+
+TEST_P( ReduceByKeyUnsortedTest, Plus )
+{
+    std::map< int, int > reference;
+    for( size_t i = 0; i < keys.size( ); i++ )
+        reference[ keys[ i ] ] += values[ i ];
+
+    std::vector< int > keysOut( keys.size( ) ), valuesOut( keys.size( ) );
+    bolt::cl::pair< std::vector< int >::iterator, std::vector< int >::iterator > ends =
+        bolt::cl::reduce_by_key_unsorted( keys.begin( ), keys.end( ), values.begin( ), keysOut.begin( ),
+                                          valuesOut.begin( ) );
+
+    EXPECT_EQ( ends.first - keysOut.begin( ), ends.second - valuesOut.begin( ) );
+    checkGroups( reference, keysOut.begin( ), ends.first, valuesOut.begin( ) );
+}
+
+TEST_P( ReduceByKeyUnsortedTest, MaximumFloatDeviceVector )
+{
+    std::vector< float > floatValues( values.begin( ), values.end( ) );
+    std::map< int, float > reference;
+    for( size_t i = 0; i < keys.size( ); i++ )
+    {
+        std::map< int, float >::iterator group = reference.find( keys[ i ] );
+        if( group == reference.end( ) )
+            reference[ keys[ i ] ] = floatValues[ i ];
+        else
+            group->second = std::max( group->second, floatValues[ i ] );
+    }
+
+    bolt::cl::device_vector< int > dvKeys( keys.begin( ), keys.end( ) );
+    bolt::cl::device_vector< float > dvValues( floatValues.begin( ), floatValues.end( ) );
+    bolt::cl::device_vector< int > dvKeysOut( keys.size( ) );
+    bolt::cl::device_vector< float > dvValuesOut( keys.size( ) );
+    bolt::cl::pair< bolt::cl::device_vector< int >::iterator, bolt::cl::device_vector< float >::iterator > ends =
+        bolt::cl::reduce_by_key_unsorted( dvKeys.begin( ), dvKeys.end( ), dvValues.begin( ), dvKeysOut.begin( ),
+                                          dvValuesOut.begin( ), bolt::cl::maximum< float >( ) );
+
+    checkGroups( reference, dvKeysOut.begin( ), ends.first, dvValuesOut.begin( ) );
+}
+
+TEST_P( ReduceByKeyUnsortedTest, DistinctKeys )
+{
+    std::vector< unsigned int > distinctKeys( keys.size( ) );
+    for( size_t i = 0; i < distinctKeys.size( ); i++ )
+        distinctKeys[ i ] = static_cast< unsigned int >( distinctKeys.size( ) - i ) * 2654435761u;
+
+    std::map< unsigned int, int > reference;
+    for( size_t i = 0; i < distinctKeys.size( ); i++ )
+        reference[ distinctKeys[ i ] ] = values[ i ];
+
+    std::vector< unsigned int > keysOut( keys.size( ) );
+    std::vector< int > valuesOut( keys.size( ) );
+    bolt::cl::pair< std::vector< unsigned int >::iterator, std::vector< int >::iterator > ends =
+        bolt::cl::reduce_by_key_unsorted( distinctKeys.begin( ), distinctKeys.end( ), values.begin( ),
+                                          keysOut.begin( ), valuesOut.begin( ), bolt::cl::minimum< int >( ) );
+
+    checkGroups( reference, keysOut.begin( ), ends.first, valuesOut.begin( ) );
+}
+
+TEST_P( ReduceByKeyUnsortedTest, UserFunctorSorts )
+{
+    std::map< int, int > reference;
+    for( size_t i = 0; i < keys.size( ); i++ )
+    {
+        std::map< int, int >::iterator group = reference.find( keys[ i ] );
+        if( group == reference.end( ) )
+            reference[ keys[ i ] ] = values[ i ];
+        else
+            group->second = AbsMax( )( group->second, values[ i ] );
+    }
+
+    std::vector< int > keysOut( keys.size( ) ), valuesOut( keys.size( ) );
+    bolt::cl::pair< std::vector< int >::iterator, std::vector< int >::iterator > ends =
+        bolt::cl::reduce_by_key_unsorted( keys.begin( ), keys.end( ), values.begin( ), keysOut.begin( ),
+                                          valuesOut.begin( ), bolt::cl::equal_to< int >( ), AbsMax( ) );
+
+    //  The sorting path hands the groups out in ascending key order
+    EXPECT_TRUE( std::is_sorted( keysOut.begin( ), ends.first ) );
+    checkGroups( reference, keysOut.begin( ), ends.first, valuesOut.begin( ) );
+}
+
+TEST_P( ReduceByKeyUnsortedTest, SerialPlus )
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    std::map< int, int > reference;
+    for( size_t i = 0; i < keys.size( ); i++ )
+        reference[ keys[ i ] ] += values[ i ];
+
+    std::vector< int > keysOut( keys.size( ) ), valuesOut( keys.size( ) );
+    bolt::cl::pair< std::vector< int >::iterator, std::vector< int >::iterator > ends =
+        bolt::cl::reduce_by_key_unsorted( ctl, keys.begin( ), keys.end( ), values.begin( ), keysOut.begin( ),
+                                          valuesOut.begin( ) );
+
+    //  The hash map keeps the groups in the order in which their keys first appear
+    EXPECT_EQ( keys[ 0 ], keysOut[ 0 ] );
+    checkGroups( reference, keysOut.begin( ), ends.first, valuesOut.begin( ) );
+}
+
+TEST_P( ReduceByKeyUnsortedTest, MultiCorePlusDeviceVector )
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    std::map< int, int > reference;
+    for( size_t i = 0; i < keys.size( ); i++ )
+        reference[ keys[ i ] ] += values[ i ];
+
+    bolt::cl::device_vector< int > dvKeys( keys.begin( ), keys.end( ) );
+    bolt::cl::device_vector< int > dvValues( values.begin( ), values.end( ) );
+    bolt::cl::device_vector< int > dvKeysOut( keys.size( ) );
+    bolt::cl::device_vector< int > dvValuesOut( keys.size( ) );
+    bolt::cl::pair< bolt::cl::device_vector< int >::iterator, bolt::cl::device_vector< int >::iterator > ends =
+        bolt::cl::reduce_by_key_unsorted( ctl, dvKeys.begin( ), dvKeys.end( ), dvValues.begin( ),
+                                          dvKeysOut.begin( ), dvValuesOut.begin( ) );
+
+    checkGroups( reference, dvKeysOut.begin( ), ends.first, dvValuesOut.begin( ) );
+}
+
+INSTANTIATE_TEST_CASE_P( ReduceByKeyUnsortedSizes, ReduceByKeyUnsortedTest, ::testing::Values( 1, 31, 256, 257,
+                                                                                               2049, 65536,
+                                                                                               1048579 ) );
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
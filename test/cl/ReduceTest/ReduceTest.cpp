@@ -24,6 +24,11 @@
 #include "stdafx.h"
 #include <bolt/cl/iterator/counting_iterator.h>
 #include <bolt/cl/reduce.h>
+#include <bolt/cl/transform_reduce.h>
+#include <bolt/cl/count.h>
+#include <bolt/cl/inner_product.h>
+#include <bolt/cl/transform.h>
+#include <bolt/cl/device_scalar.h>
 #include <bolt/cl/functional.h>
 #include <bolt/cl/control.h>
 
@@ -216,6 +221,126 @@ TEST( ReduceStdVectWithInit, OffsetTestSerialCpu)
     EXPECT_EQ( stlTransformReduce, boltTransformReduce );
 }
 
+TEST( ReduceDeviceScalar, DeviceVector )
+{
+    int length = 1<<20;
+    std::vector<int> stdInput( length );
+    for (int i = 0; i < length; ++i)
+        stdInput[i] = (i % 7) - 3;
+
+    bolt::cl::device_vector<int> dVectorA( stdInput.begin(), stdInput.end() );
+    bolt::cl::device_scalar<int> boltSum;
+
+    int init = 10;
+    int stlReduce = std::accumulate( stdInput.begin( ), stdInput.end( ), init, bolt::cl::plus<int>( ) );
+    bolt::cl::reduce( dVectorA.begin( ), dVectorA.end( ), init, bolt::cl::plus<int>( ), boltSum );
+
+    EXPECT_EQ( stlReduce, boltSum.get( ) );
+}
+
+TEST( ReduceDeviceScalar, StdVectorAndSerialCpu )
+{
+    int length = 4097;
+    std::vector<int> stdInput( length );
+    for (int i = 0; i < length; ++i)
+        stdInput[i] = i;
+
+    int init = 5;
+    int stlReduce = std::accumulate( stdInput.begin( ), stdInput.end( ), init, bolt::cl::maximum<int>( ) );
+
+    bolt::cl::device_scalar<int> boltMax;
+    bolt::cl::reduce( stdInput.begin( ), stdInput.end( ), init, bolt::cl::maximum<int>( ), boltMax );
+    EXPECT_EQ( stlReduce, boltMax.get( ) );
+
+    bolt::cl::control ctl;
+    ctl.setForceRunMode(bolt::cl::control::SerialCpu);
+    bolt::cl::device_scalar<int> boltSerialMax( 0, ctl );
+    bolt::cl::reduce( ctl, stdInput.begin( ), stdInput.end( ), init, bolt::cl::maximum<int>( ), boltSerialMax );
+    EXPECT_EQ( stlReduce, boltSerialMax.get( ) );
+
+    //  An empty range leaves the initial value
+    bolt::cl::reduce( stdInput.begin( ), stdInput.begin( ), init, bolt::cl::maximum<int>( ), boltMax );
+    EXPECT_EQ( init, boltMax.get( ) );
+}
+
+TEST( ReduceDeviceScalar, ChainedReductions )
+{
+    int length = 100000;
+    std::vector<float> stdInput( length );
+    std::vector<float> stdInput2( length );
+    for (int i = 0; i < length; ++i)
+    {
+        stdInput[i] = static_cast<float>( i % 16 );
+        stdInput2[i] = static_cast<float>( i % 3 );
+    }
+    bolt::cl::device_vector<float> dVectorA( stdInput.begin(), stdInput.end() );
+    bolt::cl::device_vector<float> dVectorB( stdInput2.begin(), stdInput2.end() );
+
+    bolt::cl::device_scalar<float> boltSum, boltSumOfSquares, boltDot, boltCombined;
+    bolt::cl::device_scalar<int> boltCount;
+
+    bolt::cl::reduce( dVectorA.begin( ), dVectorA.end( ), 0.0f, bolt::cl::plus<float>( ), boltSum );
+    bolt::cl::transform_reduce( dVectorA.begin( ), dVectorA.end( ), bolt::cl::square<float>( ), 0.0f,
+        bolt::cl::plus<float>( ), boltSumOfSquares );
+    bolt::cl::inner_product( dVectorA.begin( ), dVectorA.end( ), dVectorB.begin( ), 0.0f, bolt::cl::plus<float>( ),
+        bolt::cl::multiplies<float>( ), boltDot );
+    bolt::cl::count( dVectorA.begin( ), dVectorA.end( ), 15.0f, boltCount );
+
+    //  The scalars feed another algorithm without being read back first
+    bolt::cl::transform( boltSum.begin( ), boltSum.end( ), boltSumOfSquares.begin( ), boltCombined.begin( ),
+        bolt::cl::plus<float>( ) );
+
+    float stlSum = std::accumulate( stdInput.begin( ), stdInput.end( ), 0.0f );
+    float stlSumOfSquares = std::inner_product( stdInput.begin( ), stdInput.end( ), stdInput.begin( ), 0.0f );
+    float stlDot = std::inner_product( stdInput.begin( ), stdInput.end( ), stdInput2.begin( ), 0.0f );
+    int stlCount = static_cast<int>( std::count( stdInput.begin( ), stdInput.end( ), 15.0f ) );
+
+    EXPECT_FLOAT_EQ( stlSum, boltSum.get( ) );
+    EXPECT_FLOAT_EQ( stlSumOfSquares, boltSumOfSquares.get( ) );
+    EXPECT_FLOAT_EQ( stlDot, boltDot.get( ) );
+    EXPECT_EQ( stlCount, boltCount.get( ) );
+    EXPECT_FLOAT_EQ( stlSum + stlSumOfSquares, boltCombined.get( ) );
+}
+
+TEST( ReduceSingleLaunch, WGPerComputeUnitSweep )
+{
+    //  The lengths straddle the 64 element work-groups, and the work-group counts go from fewer than the chunks of
+    //  the input to more, so the launch is clamped in some of the cases
+    int lengths[] = { 1, 63, 64, 65, 4095, 4097, 100003, 1<<20 };
+    int wgPerComputeUnit[] = { 1, 2, 8, 40 };
+
+    for( size_t l = 0; l < sizeof( lengths ) / sizeof( lengths[ 0 ] ); ++l )
+    {
+        std::vector<int> stdInput( lengths[ l ] );
+        for (int i = 0; i < lengths[ l ]; ++i)
+            stdInput[i] = (i % 13) - 6;
+        bolt::cl::device_vector<int> dVectorA( stdInput.begin(), stdInput.end() );
+
+        int init = 3;
+        int stlReduce = std::accumulate( stdInput.begin( ), stdInput.end( ), init, bolt::cl::plus<int>( ) );
+
+        for( size_t w = 0; w < sizeof( wgPerComputeUnit ) / sizeof( wgPerComputeUnit[ 0 ] ); ++w )
+        {
+            bolt::cl::control ctl = bolt::cl::control::getDefault( );
+            ctl.setWGPerComputeUnit( wgPerComputeUnit[ w ] );
+
+            //  Back to back reductions reuse the pooled ticket, which has to start from zero every time
+            for( int repeat = 0; repeat < 2; ++repeat )
+            {
+                int boltReduce = bolt::cl::reduce( ctl, dVectorA.begin( ), dVectorA.end( ), init,
+                    bolt::cl::plus<int>( ) );
+                EXPECT_EQ( stlReduce, boltReduce ) << "length " << lengths[ l ] << ", wgPerComputeUnit "
+                    << wgPerComputeUnit[ w ];
+
+                bolt::cl::device_scalar<int> boltSum( ctl );
+                bolt::cl::reduce( ctl, dVectorA.begin( ), dVectorA.end( ), init, bolt::cl::plus<int>( ), boltSum );
+                EXPECT_EQ( stlReduce, boltSum.get( ) ) << "length " << lengths[ l ] << ", wgPerComputeUnit "
+                    << wgPerComputeUnit[ w ];
+            }
+        }
+    }
+}
+
 
 TYPED_TEST_CASE_P( ReduceArrayTest );
 
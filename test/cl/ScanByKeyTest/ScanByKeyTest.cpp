@@ -4475,9 +4475,74 @@ TEST(ExclusiveScanByKey, MulticoreCLscanbykeyExclUDD)
     cmpArrays(refOutput, output);
 }
 
+TEST(InclusiveScanByKey, AlternatingKeysAcrossTiles)
+{
+    //setup keys; segments of random length alternate between two keys, so equal keys are not always one segment
+    int length = (1<<18) + 131;
+    std::vector< int > keys( length);
+    srand( 42 );
+    int segmentRemaining = 0;
+    int key = 0;
+    for (int i = 0; i < length; i++)
+    {
+        if (segmentRemaining == 0)
+        {
+            segmentRemaining = 1 + rand( ) % 700;
+            key = 1 - key;
+        }
+        keys[i] = key;
+        segmentRemaining--;
+    }
+    // input and output vectors for device and reference
+    std::vector< int > input( length);
+    std::vector< int > output( length);
+    std::vector< int > refOutput( length);
+    for(int i=0; i<length; i++)
+        input[i] = rand( ) % 10;
+    // call scan
+    bolt::cl::equal_to<int> eq;
+    bolt::cl::plus<int> plusOp;
+
+    bolt::cl::inclusive_scan_by_key(keys.begin(), keys.end(), input.begin(), output.begin(), eq, plusOp);
+    gold_scan_by_key(keys.begin(), keys.end(), input.begin(), refOutput.begin(), plusOp);
+    cmpArrays(refOutput, output);
+
+    bolt::cl::exclusive_scan_by_key(keys.begin(), keys.end(), input.begin(), output.begin(), 3, eq, plusOp);
+    gold_scan_by_key_exclusive(keys.begin(), keys.end(), input.begin(), refOutput.begin(), plusOp, 3);
+    cmpArrays(refOutput, output);
+}
+
 // paste from above
 #endif
 
+//  Segments longer than a TBB scan block, so that most of them cross block boundaries
+TEST(ScanByKey, MultiCoreSegmentsAcrossBlocks)
+{
+    int length = (1<<20) + 5;
+    std::vector< int > keys( length );
+    std::vector< int > values( length );
+    for (int i = 0; i < length; i++)
+    {
+        keys[i] = i / 10007;
+        values[i] = (i % 7) - 3;
+    }
+    bolt::cl::equal_to<int> eq;
+    bolt::cl::plus<int> plusOp;
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode(bolt::cl::control::MultiCoreCpu);
+
+    std::vector< int > refOutput( length );
+    std::vector< int > output( length );
+    gold_scan_by_key(keys.begin(), keys.end(), values.begin(), refOutput.begin(), plusOp);
+    bolt::cl::inclusive_scan_by_key(ctl, keys.begin(), keys.end(), values.begin(), output.begin(), eq, plusOp);
+    cmpArrays(refOutput, output);
+
+    gold_scan_by_key_exclusive(keys.begin(), keys.end(), values.begin(), refOutput.begin(), plusOp, 5);
+    bolt::cl::exclusive_scan_by_key(ctl, keys.begin(), keys.end(), values.begin(), output.begin(), 5, eq, plusOp);
+    cmpArrays(refOutput, output);
+}
+
+
 int _tmain(int argc, _TCHAR* argv[])
 {
     //  Register our minidump generating logic
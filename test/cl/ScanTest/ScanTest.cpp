@@ -19,6 +19,7 @@
 #include "common/myocl.h"
 #include <vector>
 #include <array>
+#include <numeric>
 
 #include "bolt/cl/scan.h"
 #include "bolt/unicode.h"
@@ -2820,6 +2821,151 @@ typedef ::testing::Types<
 
 INSTANTIATE_TYPED_TEST_CASE_P( Integer, ScanArrayTest, IntegerTests );
 INSTANTIATE_TYPED_TEST_CASE_P( Float, ScanArrayTest, FloatTests );
+
+TEST(InclusiveScan, ManyTilesInt)
+{
+    //  Enough elements for a long chain of tiles, and a partial last tile
+    int length = (1<<20) + 37;
+    std::vector< int > input( length );
+    std::vector< int > boltOutput( length );
+    std::vector< int > stdOutput( length );
+    for( int i = 0; i < length; ++i )
+        input[ i ] = ( i * 7 ) % 11 - 5;
+
+    bolt::cl::inclusive_scan( input.begin( ), input.end( ), boltOutput.begin( ) );
+    std::partial_sum( input.begin( ), input.end( ), stdOutput.begin( ) );
+    cmpArrays( stdOutput, boltOutput );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int > dvOutput( length );
+    bolt::cl::exclusive_scan( dvInput.begin( ), dvInput.end( ), dvOutput.begin( ), 2 );
+    stdOutput[ 0 ] = 2;
+    std::partial_sum( input.begin( ), input.end( ) - 1, stdOutput.begin( ) + 1 );
+    for( int i = 1; i < length; ++i )
+        stdOutput[ i ] += 2;
+    cmpArrays( stdOutput, dvOutput );
+}
+
+TEST(ExclusiveScan, ManyTilesInPlaceInt)
+{
+    //  The scan runs in place over many tiles, so no tile may read input that another tile has overwritten
+    int length = (1<<20) + 37;
+    std::vector< int > input( length );
+    std::vector< int > stdOutput( length );
+    for( int i = 0; i < length; ++i )
+        input[ i ] = ( i * 5 ) % 13 - 6;
+
+    stdOutput[ 0 ] = 0;
+    std::partial_sum( input.begin( ), input.end( ) - 1, stdOutput.begin( ) + 1 );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::exclusive_scan( dvInput.begin( ), dvInput.end( ), dvInput.begin( ), 0 );
+    cmpArrays( stdOutput, dvInput );
+}
+
+//  Scans a stream in batches of uneven sizes, the carry running from one batch to the next
+static void scanStreamWithCarry( bolt::cl::control& ctl, bool inclusive, bool deviceVector )
+{
+    int length = (1<<18) + 1001;
+    int batches[ ] = { 1, 37, 4096, 65536, 1000, (1<<17) };
+    std::vector< int > input( length );
+    std::vector< int > stdOutput( length );
+    std::vector< int > boltOutput( length );
+    for( int i = 0; i < length; ++i )
+        input[ i ] = ( i * 7 ) % 11 - 5;
+
+    int carryIn = 3;
+    stdOutput[ 0 ] = carryIn + ( inclusive ? input[ 0 ] : 0 );
+    for( int i = 1; i < length; ++i )
+        stdOutput[ i ] = stdOutput[ i - 1 ] + ( inclusive ? input[ i ] : input[ i - 1 ] );
+
+    bolt::cl::device_vector< int > carry( 1, carryIn, CL_MEM_READ_WRITE, true, ctl );
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ), CL_MEM_READ_WRITE, ctl );
+    bolt::cl::device_vector< int > dvOutput( length, 0, CL_MEM_READ_WRITE, true, ctl );
+    int offset = 0;
+    for( int b = 0; offset < length; b = ( b + 1 ) % 6 )
+    {
+        int count = std::min( batches[ b ], length - offset );
+        if( deviceVector && inclusive )
+            bolt::cl::inclusive_scan_with_carry( ctl, dvInput.begin( ) + offset, dvInput.begin( ) + offset + count,
+                dvOutput.begin( ) + offset, carry );
+        else if( deviceVector )
+            bolt::cl::exclusive_scan_with_carry( ctl, dvInput.begin( ) + offset, dvInput.begin( ) + offset + count,
+                dvOutput.begin( ) + offset, carry );
+        else if( inclusive )
+            bolt::cl::inclusive_scan_with_carry( ctl, input.begin( ) + offset, input.begin( ) + offset + count,
+                boltOutput.begin( ) + offset, carry, bolt::cl::plus< int >( ) );
+        else
+            bolt::cl::exclusive_scan_with_carry( ctl, input.begin( ) + offset, input.begin( ) + offset + count,
+                boltOutput.begin( ) + offset, carry, bolt::cl::plus< int >( ) );
+        offset += count;
+    }
+
+    if( deviceVector )
+        cmpArrays( stdOutput, dvOutput );
+    else
+        cmpArrays( stdOutput, boltOutput );
+
+    int total = carryIn + std::accumulate( input.begin( ), input.end( ), 0 );
+    int carryOut = carry[ 0 ];
+    EXPECT_EQ( total, carryOut );
+}
+
+TEST(ScanWithCarry, InclusiveStream)
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    scanStreamWithCarry( ctl, true, false );
+    scanStreamWithCarry( ctl, true, true );
+}
+
+TEST(ScanWithCarry, ExclusiveStream)
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    scanStreamWithCarry( ctl, false, false );
+    scanStreamWithCarry( ctl, false, true );
+}
+
+TEST(ScanWithCarry, SerialStream)
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+    scanStreamWithCarry( ctl, true, false );
+    scanStreamWithCarry( ctl, false, true );
+}
+
+TEST(ScanWithCarry, MultiCoreStream)
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+    scanStreamWithCarry( ctl, true, true );
+    scanStreamWithCarry( ctl, false, false );
+}
+
+//  Large enough for the TBB scan to run many blocks through both of its passes
+TEST(ScanMultiCore, ManyBlocksInPlace)
+{
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    size_t length = ( 1 << 22 ) + 17;
+    std::vector< int > input( length );
+    for( size_t i = 0; i < length; ++i )
+        input[ i ] = static_cast< int >( i % 11 ) - 5;
+
+    std::vector< int > refOutput( length );
+    std::partial_sum( input.begin( ), input.end( ), refOutput.begin( ) );
+    std::vector< int > boltInput( input );
+    bolt::cl::inclusive_scan( ctl, boltInput.begin( ), boltInput.end( ), boltInput.begin( ) );
+    cmpArrays( refOutput, boltInput );
+
+    refOutput[ 0 ] = 3;
+    std::partial_sum( input.begin( ), input.end( ) - 1, refOutput.begin( ) + 1 );
+    for( size_t i = 1; i < length; ++i )
+        refOutput[ i ] += 3;
+    boltInput = input;
+    bolt::cl::exclusive_scan( ctl, boltInput.begin( ), boltInput.end( ), boltInput.begin( ), 3 );
+    cmpArrays( refOutput, boltInput );
+}
 //here
 
 /*
@@ -0,0 +1,227 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/segmented_reduce.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+//  CSR style offsets of numSegments random segments of about averageLength elements, some of them empty
+std::vector< int > makeOffsets( int numSegments, int averageLength )
+{
+    std::vector< int > offsets( 1, 0 );
+    for( int i = 0; i < numSegments; i++ )
+    {
+        int length = ( rand( ) % 8 == 0 ) ? 0 : rand( ) % ( 2 * averageLength ) + 1;
+        offsets.push_back( offsets.back( ) + length );
+    }
+    return offsets;
+}
+
+template< typename T, typename BinaryFunction >
+std::vector< T > referenceSegmentedReduce( const std::vector< T >& input, const std::vector< int >& offsets,
+                                           T init, BinaryFunction op )
+{
+    std::vector< T > output( offsets.size( ) - 1 );
+    for( size_t segment = 0; segment + 1 < offsets.size( ); segment++ )
+    {
+        T acc = init;
+        for( int i = offsets[ segment ]; i < offsets[ segment + 1 ]; i++ )
+            acc = op( acc, input[ i ] );
+        output[ segment ] = acc;
+    }
+    return output;
+}
+
+template< typename T >
+std::vector< T > makeInput( size_t length )
+{
+    std::vector< T > input( length );
+    for( size_t i = 0; i < length; i++ )
+        input[ i ] = static_cast< T >( rand( ) % 100 - 50 );
+    return input;
+}
+
+//  The parameter is the average segment length, which picks how many work-items share a segment
+class SegmentedReduceLengths: public ::testing::TestWithParam< int >
+{
+protected:
+    int numSegments( ) const
+    {
+        return std::max( 1, ( 1 << 20 ) / GetParam( ) );
+    }
+};
+
+TEST_P( SegmentedReduceLengths, IntStdVector )
+{
+    std::vector< int > offsets = makeOffsets( numSegments( ), GetParam( ) );
+    std::vector< int > input = makeInput< int >( offsets.back( ) );
+    std::vector< int > output( offsets.size( ) - 1 );
+
+    std::vector< int >::iterator end = bolt::cl::segmented_reduce( input.begin( ), input.end( ), offsets.begin( ),
+                                                                   offsets.end( ), output.begin( ) );
+    EXPECT_EQ( output.end( ), end );
+    cmpArrays( referenceSegmentedReduce( input, offsets, 0, bolt::cl::plus< int >( ) ), output );
+}
+
+TEST_P( SegmentedReduceLengths, IntDeviceVectorMaximum )
+{
+    std::vector< int > offsets = makeOffsets( numSegments( ), GetParam( ) );
+    std::vector< int > input = makeInput< int >( offsets.back( ) );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int > dvOffsets( offsets.begin( ), offsets.end( ) );
+    bolt::cl::device_vector< int > dvOutput( offsets.size( ) - 1 );
+
+    bolt::cl::segmented_reduce( dvInput.begin( ), dvInput.end( ), dvOffsets.begin( ), dvOffsets.end( ),
+                                dvOutput.begin( ), -1000, bolt::cl::maximum< int >( ) );
+    cmpArrays( referenceSegmentedReduce( input, offsets, -1000, bolt::cl::maximum< int >( ) ), dvOutput );
+}
+
+TEST_P( SegmentedReduceLengths, IntSerialCpu )
+{
+    std::vector< int > offsets = makeOffsets( numSegments( ), GetParam( ) );
+    std::vector< int > input = makeInput< int >( offsets.back( ) );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int > dvOffsets( offsets.begin( ), offsets.end( ) );
+    bolt::cl::device_vector< int > dvOutput( offsets.size( ) - 1 );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    bolt::cl::segmented_reduce( ctl, dvInput.begin( ), dvInput.end( ), dvOffsets.begin( ), dvOffsets.end( ),
+                                dvOutput.begin( ), 3, bolt::cl::plus< int >( ) );
+    cmpArrays( referenceSegmentedReduce( input, offsets, 3, bolt::cl::plus< int >( ) ), dvOutput );
+}
+
+TEST_P( SegmentedReduceLengths, IntMultiCoreCpu )
+{
+    std::vector< int > offsets = makeOffsets( numSegments( ), GetParam( ) );
+    std::vector< int > input = makeInput< int >( offsets.back( ) );
+    std::vector< int > output( offsets.size( ) - 1 );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    bolt::cl::segmented_reduce( ctl, input.begin( ), input.end( ), offsets.begin( ), offsets.end( ),
+                                output.begin( ) );
+    cmpArrays( referenceSegmentedReduce( input, offsets, 0, bolt::cl::plus< int >( ) ), output );
+}
+
+#if (TEST_DOUBLE == 1)
+TEST_P( SegmentedReduceLengths, DoubleStdVector )
+{
+    std::vector< int > offsets = makeOffsets( numSegments( ), GetParam( ) );
+    std::vector< double > input = makeInput< double >( offsets.back( ) );
+    std::vector< double > output( offsets.size( ) - 1 );
+
+    //  The elements are small integers, so the sums are exact in any order
+    bolt::cl::segmented_reduce( input.begin( ), input.end( ), offsets.begin( ), offsets.end( ), output.begin( ),
+                                0.5, bolt::cl::plus< double >( ) );
+    cmpArrays( referenceSegmentedReduce( input, offsets, 0.5, bolt::cl::plus< double >( ) ), output );
+}
+#endif
+
+INSTANTIATE_TEST_CASE_P( SegmentedReduce, SegmentedReduceLengths, ::testing::Values( 1, 3, 40, 300, 5000 ) );
+
+TEST( SegmentedReduce, FewLongAmongManyShort )
+{
+    //  Every ten thousandth segment is far longer than the mean, so it goes to the work-group per segment pass
+    std::vector< int > offsets( 1, 0 );
+    for( int i = 0; i < ( 1 << 16 ); i++ )
+        offsets.push_back( offsets.back( ) + ( ( i % 10000 == 9999 ) ? 20000 + i : i % 5 ) );
+    std::vector< int > input = makeInput< int >( offsets.back( ) );
+
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int > dvOffsets( offsets.begin( ), offsets.end( ) );
+    bolt::cl::device_vector< int > dvOutput( offsets.size( ) - 1 );
+
+    bolt::cl::segmented_reduce( dvInput.begin( ), dvInput.end( ), dvOffsets.begin( ), dvOffsets.end( ),
+                                dvOutput.begin( ), 3, bolt::cl::plus< int >( ) );
+    cmpArrays( referenceSegmentedReduce( input, offsets, 3, bolt::cl::plus< int >( ) ), dvOutput );
+}
+
+TEST( SegmentedReduce, AllSegmentsEmpty )
+{
+    std::vector< int > input( 16, 1 );
+    std::vector< int > offsets( 5, 0 );
+    std::vector< int > output( 4, -1 );
+
+    bolt::cl::segmented_reduce( input.begin( ), input.begin( ), offsets.begin( ), offsets.end( ), output.begin( ),
+                                7, bolt::cl::plus< int >( ) );
+    cmpArrays( std::vector< int >( 4, 7 ), output );
+}
+
+TEST( SegmentedReduce, NoSegments )
+{
+    std::vector< int > input( 16, 1 );
+    std::vector< int > offsets( 1, 0 );
+    std::vector< int > output( 1, -1 );
+
+    std::vector< int >::iterator end = bolt::cl::segmented_reduce( input.begin( ), input.end( ), offsets.begin( ),
+                                                                   offsets.end( ), output.begin( ) );
+    EXPECT_EQ( output.begin( ), end );
+    EXPECT_EQ( -1, output[ 0 ] );
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -0,0 +1,295 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/segmented_scan.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+//  Random head flags with segments of about averageLength elements; the first element is deliberately not flagged,
+//  since it starts a segment anyway
+void makeHeadFlags( std::vector< int >& flags, int averageLength )
+{
+    for( size_t i = 0; i < flags.size( ); i++ )
+        flags[ i ] = ( rand( ) % averageLength == 0 ) ? 1 : 0;
+    flags[ 0 ] = 0;
+}
+
+std::vector< int > headFlagsToOffsets( const std::vector< int >& flags )
+{
+    std::vector< int > offsets( 1, 0 );
+    for( size_t i = 1; i < flags.size( ); i++ )
+        if( flags[ i ] )
+            offsets.push_back( static_cast< int >( i ) );
+    return offsets;
+}
+
+template< typename T, typename BinaryFunction >
+void referenceSegmentedScan( const std::vector< T >& input, const std::vector< int >& flags,
+                             std::vector< T >& output, bool inclusive, T init, BinaryFunction op )
+{
+    T sum = init;
+    for( size_t i = 0; i < input.size( ); i++ )
+    {
+        bool head = ( i == 0 ) || flags[ i ];
+        if( inclusive )
+        {
+            sum = head ? input[ i ] : op( sum, input[ i ] );
+            output[ i ] = sum;
+        }
+        else
+        {
+            if( head )
+                sum = init;
+            output[ i ] = sum;
+            sum = op( sum, input[ i ] );
+        }
+    }
+}
+
+/******************************************************************************
+ *  Head flags
+ *****************************************************************************/
+TEST(SegmentedInclusiveScan, StdInt)
+{
+    std::vector< int > input( 1<<20 ), flags( input.size( ) );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = rand( ) % 10;
+    makeHeadFlags( flags, 300 );
+    std::vector< int > ref( input.size( ) ), bolt_result( input.size( ) );
+
+    referenceSegmentedScan( input, flags, ref, true, 0, std::plus< int >( ) );
+    std::vector< int >::iterator end = bolt::cl::segmented_inclusive_scan( input.begin( ), input.end( ),
+                                                                           flags.begin( ), bolt_result.begin( ) );
+
+    EXPECT_TRUE( end == bolt_result.end( ) );
+    cmpArrays( ref, bolt_result );
+}
+
+//  Segments much longer than a tile make the look-back walk across several tiles
+TEST(SegmentedInclusiveScan, StdIntLongSegments)
+{
+    std::vector< int > input( ( 1<<20 ) + 37, 1 ), flags( input.size( ), 0 );
+    flags[ 100000 ] = 1;
+    flags[ 100001 ] = 1;
+    flags[ 700000 ] = 1;
+    std::vector< int > ref( input.size( ) ), bolt_result( input.size( ) );
+
+    referenceSegmentedScan( input, flags, ref, true, 0, std::plus< int >( ) );
+    bolt::cl::segmented_inclusive_scan( input.begin( ), input.end( ), flags.begin( ), bolt_result.begin( ) );
+
+    cmpArrays( ref, bolt_result );
+}
+
+TEST(SegmentedInclusiveScan, DevFloatMaximum)
+{
+    std::vector< float > input( 100003 );
+    std::vector< int > flags( input.size( ) );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = static_cast< float >( rand( ) - RAND_MAX/2 ) / 7.0f;
+    makeHeadFlags( flags, 50 );
+    std::vector< float > ref( input.size( ) );
+    referenceSegmentedScan( input, flags, ref, true, 0.0f, bolt::cl::maximum< float >( ) );
+
+    bolt::cl::device_vector< float > dv_input( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int > dv_flags( flags.begin( ), flags.end( ) );
+    bolt::cl::segmented_inclusive_scan( dv_input.begin( ), dv_input.end( ), dv_flags.begin( ), dv_input.begin( ),
+                                        bolt::cl::maximum< float >( ) );
+
+    cmpArrays( ref, dv_input );
+}
+
+TEST(SegmentedExclusiveScan, StdIntInit)
+{
+    std::vector< int > input( 300000 ), flags( input.size( ) );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = rand( ) % 10;
+    makeHeadFlags( flags, 1000 );
+    std::vector< int > ref( input.size( ) ), bolt_result( input.size( ) );
+
+    referenceSegmentedScan( input, flags, ref, false, 5, std::plus< int >( ) );
+    bolt::cl::segmented_exclusive_scan( input.begin( ), input.end( ), flags.begin( ), bolt_result.begin( ), 5 );
+
+    cmpArrays( ref, bolt_result );
+}
+
+TEST(SegmentedExclusiveScan, DevIntMultiplies)
+{
+    std::vector< int > input( 65539 ), flags( input.size( ) );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = 1 + rand( ) % 2;
+    makeHeadFlags( flags, 8 );
+    std::vector< int > ref( input.size( ) );
+    referenceSegmentedScan( input, flags, ref, false, 1, bolt::cl::multiplies< int >( ) );
+
+    bolt::cl::device_vector< int > dv_input( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int > dv_flags( flags.begin( ), flags.end( ) );
+    bolt::cl::device_vector< int > dv_result( input.size( ), 0 );
+    bolt::cl::segmented_exclusive_scan( dv_input.begin( ), dv_input.end( ), dv_flags.begin( ), dv_result.begin( ),
+                                        1, bolt::cl::multiplies< int >( ) );
+
+    cmpArrays( ref, dv_result );
+}
+
+TEST(SerialCPU, SegmentedScanInt)
+{
+    std::vector< int > input( 10000 ), flags( input.size( ) );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = rand( ) % 10;
+    makeHeadFlags( flags, 30 );
+    std::vector< int > ref( input.size( ) ), bolt_result( input.size( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    referenceSegmentedScan( input, flags, ref, true, 0, std::plus< int >( ) );
+    bolt::cl::segmented_inclusive_scan( ctl, input.begin( ), input.end( ), flags.begin( ), bolt_result.begin( ) );
+    cmpArrays( ref, bolt_result );
+
+    referenceSegmentedScan( input, flags, ref, false, 3, std::plus< int >( ) );
+    bolt::cl::segmented_exclusive_scan( ctl, input.begin( ), input.end( ), flags.begin( ), bolt_result.begin( ), 3 );
+    cmpArrays( ref, bolt_result );
+}
+
+TEST(MultiCoreCPU, SegmentedScanInt)
+{
+    std::vector< int > input( 1<<20 ), flags( input.size( ) );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = rand( ) % 10;
+    makeHeadFlags( flags, 5000 );
+    std::vector< int > ref( input.size( ) ), bolt_result( input.size( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    referenceSegmentedScan( input, flags, ref, true, 0, std::plus< int >( ) );
+    bolt::cl::segmented_inclusive_scan( ctl, input.begin( ), input.end( ), flags.begin( ), bolt_result.begin( ) );
+    cmpArrays( ref, bolt_result );
+
+    referenceSegmentedScan( input, flags, ref, false, 3, std::plus< int >( ) );
+    bolt::cl::segmented_exclusive_scan( ctl, input.begin( ), input.end( ), flags.begin( ), bolt_result.begin( ), 3 );
+    cmpArrays( ref, bolt_result );
+}
+
+/******************************************************************************
+ *  Segment offsets
+ *****************************************************************************/
+TEST(SegmentedScanByOffsets, StdInt)
+{
+    std::vector< int > input( 500000 ), flags( input.size( ) );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = rand( ) % 10;
+    makeHeadFlags( flags, 200 );
+    std::vector< int > offsets = headFlagsToOffsets( flags );
+    std::vector< int > ref( input.size( ) ), bolt_result( input.size( ) );
+
+    referenceSegmentedScan( input, flags, ref, true, 0, std::plus< int >( ) );
+    bolt::cl::segmented_inclusive_scan_by_offsets( input.begin( ), input.end( ), offsets.begin( ), offsets.end( ),
+                                                   bolt_result.begin( ) );
+    cmpArrays( ref, bolt_result );
+
+    referenceSegmentedScan( input, flags, ref, false, 0, std::plus< int >( ) );
+    bolt::cl::segmented_exclusive_scan_by_offsets( input.begin( ), input.end( ), offsets.begin( ), offsets.end( ),
+                                                   bolt_result.begin( ), 0 );
+    cmpArrays( ref, bolt_result );
+}
+
+//  Unsorted offsets, and offsets past the end, which are ignored
+TEST(SegmentedScanByOffsets, DevIntUnsortedOffsets)
+{
+    std::vector< int > input( 40000 ), flags( input.size( ), 0 );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = rand( ) % 10;
+    int offsetArray[ ] = { 30000, 7, 12345, 40000, 99999, 8 };
+    std::vector< int > offsets( offsetArray, offsetArray + 6 );
+    flags[ 7 ] = flags[ 8 ] = flags[ 12345 ] = flags[ 30000 ] = 1;
+    std::vector< int > ref( input.size( ) );
+    referenceSegmentedScan( input, flags, ref, true, 0, std::plus< int >( ) );
+
+    bolt::cl::device_vector< int > dv_input( input.begin( ), input.end( ) );
+    bolt::cl::device_vector< int > dv_offsets( offsets.begin( ), offsets.end( ) );
+    bolt::cl::device_vector< int > dv_result( input.size( ), 0 );
+    bolt::cl::segmented_inclusive_scan_by_offsets( dv_input.begin( ), dv_input.end( ), dv_offsets.begin( ),
+                                                   dv_offsets.end( ), dv_result.begin( ) );
+
+    cmpArrays( ref, dv_result );
+}
+
+TEST(MultiCoreCPU, SegmentedScanByOffsetsInt)
+{
+    std::vector< int > input( 1<<18 ), flags( input.size( ) );
+    for( size_t i = 0; i < input.size( ); i++ )
+        input[ i ] = rand( ) % 10;
+    makeHeadFlags( flags, 100 );
+    std::vector< int > offsets = headFlagsToOffsets( flags );
+    std::vector< int > ref( input.size( ) ), bolt_result( input.size( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    referenceSegmentedScan( input, flags, ref, false, 2, std::plus< int >( ) );
+    bolt::cl::segmented_exclusive_scan_by_offsets( ctl, input.begin( ), input.end( ), offsets.begin( ),
+                                                   offsets.end( ), bolt_result.begin( ), 2 );
+    cmpArrays( ref, bolt_result );
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -0,0 +1,239 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/sort_by_extracted_key.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+
+BOLT_FUNCTOR(Particle,
+struct Particle
+{
+    float depth;
+    int charge;
+    unsigned int tag;
+    int id;
+
+    bool operator == (const Particle& other) const
+    {
+        return ( depth == other.depth ) && ( charge == other.charge ) && ( tag == other.tag ) && ( id == other.id );
+    }
+};
+);
+
+BOLT_FUNCTOR(ParticleDepth,
+struct ParticleDepth
+{
+    float operator() (const Particle& p) const
+    {
+        return p.depth;
+    }
+};
+);
+
+BOLT_FUNCTOR(ParticleCharge,
+struct ParticleCharge
+{
+    int operator() (const Particle& p) const
+    {
+        return p.charge;
+    }
+};
+);
+
+BOLT_FUNCTOR(ParticleTag,
+struct ParticleTag
+{
+    unsigned int operator() (const Particle& p) const
+    {
+        return p.tag;
+    }
+};
+);
+
+BOLT_CREATE_TYPENAME( bolt::cl::device_vector< Particle >::iterator );
+BOLT_CREATE_CLCODE( bolt::cl::device_vector< Particle >::iterator, bolt::cl::deviceVectorIteratorTemplate );
+
+std::vector< Particle > makeParticles( size_t length, int distinctValues )
+{
+    std::vector< Particle > particles( length );
+    for( size_t i = 0; i < length; i++ )
+    {
+        particles[ i ].depth  = static_cast< float >( rand( ) % distinctValues - distinctValues/2 ) / 3.0f;
+        particles[ i ].charge = rand( ) % distinctValues - distinctValues/2;
+        particles[ i ].tag    = static_cast< unsigned int >( rand( ) ) * 7919u;
+        particles[ i ].id     = static_cast< int >( i );
+    }
+    return particles;
+}
+
+//  The reference is a stable sort, since sort_by_extracted_key keeps records with equal keys in order
+template< typename KeyFunctor >
+void referenceSort( std::vector< Particle >& particles, KeyFunctor keyFunctor )
+{
+    bolt::cl::detail::extracted_key_less< KeyFunctor > comp( keyFunctor );
+    std::stable_sort( particles.begin( ), particles.end( ), comp );
+}
+
+TEST(SortByExtractedKey, StdFloatKey)
+{
+    std::vector< Particle > std_particles = makeParticles( 100000, 1<<20 );
+    std::vector< Particle > bolt_particles( std_particles );
+
+    referenceSort( std_particles, ParticleDepth( ) );
+    bolt::cl::sort_by_extracted_key( bolt_particles.begin( ), bolt_particles.end( ), ParticleDepth( ) );
+
+    cmpArrays( std_particles, bolt_particles );
+}
+
+TEST(SortByExtractedKey, StdIntKeyManyDuplicates)
+{
+    std::vector< Particle > std_particles = makeParticles( 1<<16, 17 );
+    std::vector< Particle > bolt_particles( std_particles );
+
+    referenceSort( std_particles, ParticleCharge( ) );
+    bolt::cl::sort_by_extracted_key( bolt_particles.begin( ), bolt_particles.end( ), ParticleCharge( ) );
+
+    cmpArrays( std_particles, bolt_particles );
+}
+
+TEST(SortByExtractedKey, DevUIntKey)
+{
+    std::vector< Particle > std_particles = makeParticles( 1<<18, 1<<10 );
+    bolt::cl::device_vector< Particle > dv_particles( std_particles.begin( ), std_particles.end( ) );
+
+    referenceSort( std_particles, ParticleTag( ) );
+    bolt::cl::sort_by_extracted_key( dv_particles.begin( ), dv_particles.end( ), ParticleTag( ) );
+
+    cmpArrays( std_particles, dv_particles );
+}
+
+TEST(SortByExtractedKey, DevOffsetRange)
+{
+    std::vector< Particle > std_particles = makeParticles( 5000, 100 );
+    bolt::cl::device_vector< Particle > dv_particles( std_particles.begin( ), std_particles.end( ) );
+
+    bolt::cl::detail::extracted_key_less< ParticleCharge > comp( ( ParticleCharge( ) ) );
+    std::stable_sort( std_particles.begin( ) + 37, std_particles.end( ) - 11, comp );
+    bolt::cl::sort_by_extracted_key( dv_particles.begin( ) + 37, dv_particles.end( ) - 11, ParticleCharge( ) );
+
+    cmpArrays( std_particles, dv_particles );
+}
+
+TEST(SortByExtractedKey, OddSizes)
+{
+    size_t sizes[ ] = { 1, 2, 15, 16, 17, 255, 4095, 4096, 4097, 65537 };
+    for( size_t s = 0; s < sizeof( sizes ) / sizeof( sizes[ 0 ] ); s++ )
+    {
+        std::vector< Particle > std_particles = makeParticles( sizes[ s ], 50 );
+        std::vector< Particle > bolt_particles( std_particles );
+
+        referenceSort( std_particles, ParticleDepth( ) );
+        bolt::cl::sort_by_extracted_key( bolt_particles.begin( ), bolt_particles.end( ), ParticleDepth( ) );
+
+        cmpArrays( std_particles, bolt_particles );
+    }
+}
+
+TEST(SerialCPU, SortByExtractedKeyFloat)
+{
+    std::vector< Particle > std_particles = makeParticles( 1<<14, 1000 );
+    std::vector< Particle > bolt_particles( std_particles );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    referenceSort( std_particles, ParticleDepth( ) );
+    bolt::cl::sort_by_extracted_key( ctl, bolt_particles.begin( ), bolt_particles.end( ), ParticleDepth( ) );
+
+    cmpArrays( std_particles, bolt_particles );
+}
+
+TEST(MultiCoreCPU, SortByExtractedKeyInt)
+{
+    std::vector< Particle > std_particles = makeParticles( 1<<18, 31 );
+    std::vector< Particle > bolt_particles( std_particles );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    referenceSort( std_particles, ParticleCharge( ) );
+    bolt::cl::sort_by_extracted_key( ctl, bolt_particles.begin( ), bolt_particles.end( ), ParticleCharge( ) );
+
+    cmpArrays( std_particles, bolt_particles );
+}
+
+TEST(MultiCoreCPU, SortByExtractedKeyDevUInt)
+{
+    std::vector< Particle > std_particles = makeParticles( 1<<16, 1<<10 );
+    bolt::cl::device_vector< Particle > dv_particles( std_particles.begin( ), std_particles.end( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    referenceSort( std_particles, ParticleTag( ) );
+    bolt::cl::sort_by_extracted_key( ctl, dv_particles.begin( ), dv_particles.end( ), ParticleTag( ) );
+
+    cmpArrays( std_particles, dv_particles );
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -1273,6 +1273,30 @@ TEST( DefaultGPU, Normal )
 
 }
 
+TEST( MultiCoreCPU, StabilityManyDuplicates )
+{
+    //  Few distinct keys over many merge passes; equal keys have to keep their original order
+    size_t length = (1<<20) + 77;
+    std::vector< int > keys( length );
+    std::vector< int > values( length );
+    for( size_t i = 0; i < length; i++ )
+    {
+        keys[ i ] = rand( ) % 13;
+        values[ i ] = static_cast< int >( i );
+    }
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode(bolt::cl::control::MultiCoreCpu);
+    bolt::BKND::STABLE_SORT_FUNC( ctl, keys.begin( ), keys.end( ), values.begin( ), bolt::cl::greater< int >( ) );
+
+    for( size_t i = 1; i < length; i++ )
+    {
+        EXPECT_GE( keys[ i - 1 ], keys[ i ] ) << _T( "Where i = " ) << i;
+        if( keys[ i - 1 ] == keys[ i ] )
+            EXPECT_LT( values[ i - 1 ], values[ i ] ) << _T( "Where i = " ) << i;
+    }
+}
+
 std::array<int, 16> TestValues = {2,4,8,16,32,64,128,256,512,1024,2048,4096,8192,16384,32768, 1<<22};
 
 //INSTANTIATE_TEST_CASE_P( StableSortByKeyValues, StableSortByKeyCountingIterator,
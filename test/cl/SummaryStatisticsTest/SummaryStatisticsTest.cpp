@@ -0,0 +1,175 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/summary_statistics.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+template< typename T >
+bolt::cl::summary_statistics< T > goldStatistics( const std::vector< T >& input )
+{
+    bolt::cl::summary_statistics< T > gold;
+    gold.count = static_cast< int >( input.size( ) );
+    gold.sum = std::accumulate( input.begin( ), input.end( ), T( 0 ) );
+    gold.sum_of_squares = std::inner_product( input.begin( ), input.end( ), input.begin( ), T( 0 ) );
+    gold.minimum = *std::min_element( input.begin( ), input.end( ) );
+    gold.maximum = *std::max_element( input.begin( ), input.end( ) );
+    return gold;
+}
+
+template< typename T >
+void expectEqualStatistics( const bolt::cl::summary_statistics< T >& gold,
+                            const bolt::cl::summary_statistics< T >& stats )
+{
+    //  The float sums are rounded differently depending on the order in which the elements are combined
+    double sumTolerance = 1e-5 * std::abs( static_cast< double >( gold.sum_of_squares ) );
+
+    EXPECT_EQ( gold.count, stats.count );
+    EXPECT_NEAR( static_cast< double >( gold.sum ), static_cast< double >( stats.sum ), sumTolerance );
+    EXPECT_NEAR( static_cast< double >( gold.sum_of_squares ), static_cast< double >( stats.sum_of_squares ),
+                 sumTolerance );
+    EXPECT_EQ( gold.minimum, stats.minimum );
+    EXPECT_EQ( gold.maximum, stats.maximum );
+}
+
+template< typename T >
+std::vector< T > makeInput( size_t length )
+{
+    std::vector< T > input( length );
+    for( size_t i = 0; i < length; ++i )
+        input[ i ] = static_cast< T >( ( i * 7919 ) % 41 ) - static_cast< T >( 20 );
+    return input;
+}
+
+class SummaryStatisticsSizes: public ::testing::TestWithParam< int >
+{
+};
+
+TEST_P( SummaryStatisticsSizes, IntDeviceVector )
+{
+    std::vector< int > input = makeInput< int >( GetParam( ) );
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+
+    bolt::cl::summary_statistics< int > stats = bolt::cl::reduce_statistics( dvInput.begin( ), dvInput.end( ) );
+    expectEqualStatistics( goldStatistics( input ), stats );
+}
+
+TEST_P( SummaryStatisticsSizes, FloatStdVector )
+{
+    std::vector< float > input = makeInput< float >( GetParam( ) );
+
+    bolt::cl::summary_statistics< float > stats = bolt::cl::reduce_statistics( input.begin( ), input.end( ) );
+    expectEqualStatistics( goldStatistics( input ), stats );
+}
+
+TEST_P( SummaryStatisticsSizes, FloatSerialCpu )
+{
+    std::vector< float > input = makeInput< float >( GetParam( ) );
+    bolt::cl::device_vector< float > dvInput( input.begin( ), input.end( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    bolt::cl::summary_statistics< float > stats = bolt::cl::reduce_statistics( ctl, dvInput.begin( ), dvInput.end( ) );
+    expectEqualStatistics( goldStatistics( input ), stats );
+}
+
+TEST_P( SummaryStatisticsSizes, FloatMultiCoreCpu )
+{
+    std::vector< float > input = makeInput< float >( GetParam( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    bolt::cl::summary_statistics< float > stats = bolt::cl::reduce_statistics( ctl, input.begin( ), input.end( ) );
+    expectEqualStatistics( goldStatistics( input ), stats );
+}
+
+#if (TEST_DOUBLE == 1)
+TEST_P( SummaryStatisticsSizes, DoubleDeviceScalar )
+{
+    std::vector< double > input = makeInput< double >( GetParam( ) );
+    bolt::cl::device_vector< double > dvInput( input.begin( ), input.end( ) );
+
+    bolt::cl::device_scalar< bolt::cl::summary_statistics< double > > result;
+    bolt::cl::reduce_statistics( dvInput.begin( ), dvInput.end( ), result );
+    expectEqualStatistics( goldStatistics( input ), result.get( ) );
+}
+#endif
+
+INSTANTIATE_TEST_CASE_P( ReduceStatistics, SummaryStatisticsSizes, ::testing::Values( 1, 63, 64, 65, 1000, 65537,
+                                                                                      1<<20 ) );
+
+TEST( SummaryStatistics, EmptyRange )
+{
+    std::vector< int > input( 16, 3 );
+
+    bolt::cl::summary_statistics< int > stats = bolt::cl::reduce_statistics( input.begin( ), input.begin( ) );
+    EXPECT_EQ( 0, stats.count );
+    EXPECT_EQ( 0, stats.sum );
+    EXPECT_EQ( 0, stats.sum_of_squares );
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
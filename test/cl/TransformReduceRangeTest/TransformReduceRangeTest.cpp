@@ -0,0 +1,213 @@
+/***************************************************************************
+*   Copyright 2012 - 2013 Advanced Micro Devices, Inc.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+
+***************************************************************************/
+
+#define TEST_DOUBLE 1
+
+#include <gtest/gtest.h>
+#include "common/stdafx.h"
+#include "common/myocl.h"
+#include "common/test_common.h"
+
+#include <bolt/cl/transform_reduce_range.h>
+#include <bolt/miniDump.h>
+#include <bolt/cl/functional.h>
+
+#include <vector>
+
+//  The array is larger than every window on all sides, so a wrong offset reads elements that change the result
+const int arrayHeight = 300;
+const int arrayPitch = 1100;
+
+template< typename T >
+std::vector< T > makeArray( size_t length )
+{
+    std::vector< T > input( length );
+    for( size_t i = 0; i < length; ++i )
+        input[ i ] = static_cast< T >( ( i * 7919 ) % 41 ) - static_cast< T >( 20 );
+    return input;
+}
+
+template< typename T, int Rank, typename UnaryFunction, typename BinaryFunction >
+T goldTransformReduceRange( const std::vector< T >& input, const bolt::cl::array_region< Rank >& region,
+                            UnaryFunction transform_op, T init, BinaryFunction reduce_op )
+{
+    int origin[ 3 ] = { 0, 0, 0 }, extent[ 3 ] = { 1, 1, 1 }, stride[ 3 ] = { 0, 0, 0 };
+    for( int d = 0; d < Rank; ++d )
+    {
+        origin[ 3 - Rank + d ] = region.origin[ d ];
+        extent[ 3 - Rank + d ] = region.extent[ d ];
+        stride[ 3 - Rank + d ] = region.stride[ d ];
+    }
+
+    T acc = init;
+    for( int z = 0; z < extent[ 0 ]; ++z )
+        for( int y = 0; y < extent[ 1 ]; ++y )
+            for( int x = 0; x < extent[ 2 ]; ++x )
+                acc = reduce_op( acc, transform_op( input[ ( origin[ 0 ] + z ) * stride[ 0 ] +
+                    ( origin[ 1 ] + y ) * stride[ 1 ] + ( origin[ 2 ] + x ) * stride[ 2 ] ] ) );
+    return acc;
+}
+
+//  Parameters are the height and the width of the window
+class TransformReduceRangeWindows: public ::testing::TestWithParam< std::tr1::tuple< int, int > >
+{
+protected:
+    bolt::cl::array_region< 2 > region( ) const
+    {
+        return bolt::cl::make_region( 7, 13, std::tr1::get< 0 >( GetParam( ) ), std::tr1::get< 1 >( GetParam( ) ),
+                                      arrayPitch );
+    }
+};
+
+TEST_P( TransformReduceRangeWindows, IntDeviceVector )
+{
+    std::vector< int > input = makeArray< int >( arrayHeight * arrayPitch );
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+
+    int result = bolt::cl::transform_reduce_range( dvInput.begin( ), region( ), bolt::cl::square< int >( ), 5,
+                                                   bolt::cl::plus< int >( ) );
+    EXPECT_EQ( goldTransformReduceRange( input, region( ), bolt::cl::square< int >( ), 5, bolt::cl::plus< int >( ) ),
+               result );
+}
+
+TEST_P( TransformReduceRangeWindows, IntStdVectorMaximum )
+{
+    std::vector< int > input = makeArray< int >( arrayHeight * arrayPitch );
+
+    int result = bolt::cl::transform_reduce_range( input.begin( ), region( ), bolt::cl::negate< int >( ), -1000,
+                                                   bolt::cl::maximum< int >( ) );
+    EXPECT_EQ( goldTransformReduceRange( input, region( ), bolt::cl::negate< int >( ), -1000,
+                                         bolt::cl::maximum< int >( ) ), result );
+}
+
+TEST_P( TransformReduceRangeWindows, IntSerialCpu )
+{
+    std::vector< int > input = makeArray< int >( arrayHeight * arrayPitch );
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::SerialCpu );
+
+    int result = bolt::cl::transform_reduce_range( ctl, dvInput.begin( ), region( ), bolt::cl::square< int >( ), 0,
+                                                   bolt::cl::plus< int >( ) );
+    EXPECT_EQ( goldTransformReduceRange( input, region( ), bolt::cl::square< int >( ), 0, bolt::cl::plus< int >( ) ),
+               result );
+}
+
+TEST_P( TransformReduceRangeWindows, IntMultiCoreCpu )
+{
+    std::vector< int > input = makeArray< int >( arrayHeight * arrayPitch );
+
+    bolt::cl::control ctl = bolt::cl::control::getDefault( );
+    ctl.setForceRunMode( bolt::cl::control::MultiCoreCpu );
+
+    int result = bolt::cl::transform_reduce_range( ctl, input.begin( ), region( ), bolt::cl::square< int >( ), 0,
+                                                   bolt::cl::plus< int >( ) );
+    EXPECT_EQ( goldTransformReduceRange( input, region( ), bolt::cl::square< int >( ), 0, bolt::cl::plus< int >( ) ),
+               result );
+}
+
+#if (TEST_DOUBLE == 1)
+TEST_P( TransformReduceRangeWindows, DoubleDeviceVector )
+{
+    std::vector< double > input = makeArray< double >( arrayHeight * arrayPitch );
+    bolt::cl::device_vector< double > dvInput( input.begin( ), input.end( ) );
+
+    //  The elements are small integers, so the sums are exact in any order
+    double result = bolt::cl::transform_reduce_range( dvInput.begin( ), region( ), bolt::cl::square< double >( ),
+                                                      0.0, bolt::cl::plus< double >( ) );
+    EXPECT_DOUBLE_EQ( goldTransformReduceRange( input, region( ), bolt::cl::square< double >( ), 0.0,
+                                                bolt::cl::plus< double >( ) ), result );
+}
+#endif
+
+INSTANTIATE_TEST_CASE_P( TransformReduceRange, TransformReduceRangeWindows,
+                         ::testing::Combine( ::testing::Values( 1, 3, 4, 17, 250 ),
+                                             ::testing::Values( 1, 15, 16, 33, 1000 ) ) );
+
+TEST( TransformReduceRange, Volume )
+{
+    const int depth = 6;
+    std::vector< int > input = makeArray< int >( depth * arrayHeight * arrayPitch );
+    bolt::cl::device_vector< int > dvInput( input.begin( ), input.end( ) );
+
+    bolt::cl::array_region< 3 > region = bolt::cl::make_region( 1, 20, 30, 4, 70, 90, arrayHeight * arrayPitch,
+                                                                arrayPitch );
+    int result = bolt::cl::transform_reduce_range( dvInput.begin( ), region, bolt::cl::square< int >( ), 0,
+                                                   bolt::cl::plus< int >( ) );
+    EXPECT_EQ( goldTransformReduceRange( input, region, bolt::cl::square< int >( ), 0, bolt::cl::plus< int >( ) ),
+               result );
+}
+
+TEST( TransformReduceRange, ColumnStride )
+{
+    //  Every other column of every third row, through explicit strides
+    std::vector< int > input = makeArray< int >( arrayHeight * arrayPitch );
+
+    bolt::cl::array_region< 2 > region = { { 2, 5 }, { 90, 500 }, { 3 * arrayPitch, 2 } };
+    int result = bolt::cl::transform_reduce_range( input.begin( ), region, bolt::cl::square< int >( ), 0,
+                                                   bolt::cl::plus< int >( ) );
+    EXPECT_EQ( goldTransformReduceRange( input, region, bolt::cl::square< int >( ), 0, bolt::cl::plus< int >( ) ),
+               result );
+}
+
+TEST( TransformReduceRange, EmptyWindow )
+{
+    std::vector< int > input( 64, 3 );
+
+    int result = bolt::cl::transform_reduce_range( input.begin( ), bolt::cl::make_region( 0, 0, 0, 8, 8 ),
+                                                   bolt::cl::square< int >( ), 42, bolt::cl::plus< int >( ) );
+    EXPECT_EQ( 42, result );
+}
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, &argv[ 0 ] );
+
+    //  Register our minidump generating logic
+    bolt::miniDumpSingleton::enableMiniDumps( );
+
+    int retVal = RUN_ALL_TESTS( );
+
+    //  Reflection code to inspect how many tests failed in gTest
+    ::testing::UnitTest& unitTest = *::testing::UnitTest::GetInstance( );
+
+    unsigned int failedTests = 0;
+    for( int i = 0; i < unitTest.total_test_case_count( ); ++i )
+    {
+        const ::testing::TestCase& testCase = *unitTest.GetTestCase( i );
+        for( int j = 0; j < testCase.total_test_count( ); ++j )
+        {
+            const ::testing::TestInfo& testInfo = *testCase.GetTestInfo( j );
+            if( testInfo.result( )->Failed( ) )
+                ++failedTests;
+        }
+    }
+
+    //  Print helpful message at termination if we detect errors, to help users figure out what to do next
+    if( failedTests )
+    {
+        bolt::tout << _T( "\nFailed tests detected in test pass; please run test again with:" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_filter=<XXX> to select a specific failing test of interest" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_catch_exceptions=0 to generate minidump of failing test, or" ) << std::endl;
+        bolt::tout << _T( "\t--gtest_break_on_failure to debug interactively with debugger" ) << std::endl;
+        bolt::tout << _T( "\t    (only on googletest assertion failures, not SEH exceptions)" ) << std::endl;
+    }
+    std::cout << "Test Completed. Press Enter to exit.\n .... ";
+    //getchar();
+    return retVal;
+}
@@ -1446,6 +1446,37 @@ TEST(MultiCoreCPU, NegPlusInt)
 }
 
 
+TEST(MultiCoreCPU, DeviceVectorExclNegPlusInt)
+{
+    bolt::cl::negate<int> unary_op;
+    bolt::cl::plus<int> binary_op;
+    int length = (1<<16) + 3;
+    int init = 7;
+
+    std::vector< int > refInput( length );
+    for( int i = 0; i < length; ++i )
+        refInput[ i ] = ( i % 13 ) - 6;
+    std::vector< int > refOutput( length );
+
+    // reference exclusive scan of the negated input, starting from init
+    int running = init;
+    for( int i = 0; i < length; ++i )
+    {
+        refOutput[ i ] = running;
+        running = binary_op( running, unary_op( refInput[ i ] ) );
+    }
+
+    bolt::cl::device_vector< int > input( refInput.begin( ), refInput.end( ) );
+    bolt::cl::device_vector< int > output( length, 0 );
+
+    bolt::cl::control ctrl = bolt::cl::control::getDefault( );
+    ctrl.setForceRunMode(bolt::cl::control::MultiCoreCpu);
+    bolt::cl::transform_exclusive_scan( ctrl, input.begin(), input.end(), output.begin(), unary_op, init, binary_op );
+
+    cmpArrays(refOutput, output);
+}
+
+
 int _tmain(int argc, _TCHAR* argv[])
 {
     //  Register our minidump generating logic